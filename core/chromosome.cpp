@@ -627,6 +627,56 @@ MutationIndex Chromosome::DrawNewMutation(IndividualSex p_sex, slim_objectid_t p
 	return new_mut_index;
 }
 
+// Draw all of the new mutations for a gamete at once.  The random draws for each mutation (subrange, mutation type, position, selection
+// coefficient) must stay interleaved exactly as in DrawNewMutation(), so that the RNG sequence is unchanged; what we save is the
+// per-call overhead and the per-mutation selection of the mutation map.
+void Chromosome::DrawNewMutations(IndividualSex p_sex, slim_objectid_t p_subpop_index, slim_generation_t p_generation, int p_count, MutationIndex *p_new_mutations) const
+{
+	gsl_ran_discrete_t *lookup;
+	const GESubrange *subranges;
+	
+	if (single_mutation_map_)
+	{
+		lookup = lookup_mutation_H_;
+		subranges = mutation_subranges_H_.data();
+	}
+	else
+	{
+		if (p_sex == IndividualSex::kMale)
+		{
+			lookup = lookup_mutation_M_;
+			subranges = mutation_subranges_M_.data();
+		}
+		else if (p_sex == IndividualSex::kFemale)
+		{
+			lookup = lookup_mutation_F_;
+			subranges = mutation_subranges_F_.data();
+		}
+		else
+		{
+			MutationMapConfigError();
+		}
+	}
+	
+	gsl_rng *rng = EIDOS_GSL_RNG;
+	
+	for (int mut_index = 0; mut_index < p_count; ++mut_index)
+	{
+		const GESubrange &subrange = subranges[gsl_ran_discrete(rng, lookup)];
+		const GenomicElementType &genomic_element_type = *subrange.genomic_element_ptr_->genomic_element_type_ptr_;
+		MutationType *mutation_type_ptr = genomic_element_type.DrawMutationType();
+		slim_position_t position = subrange.start_position_ + static_cast<slim_position_t>(Eidos_rng_uniform_int_MT64(subrange.end_position_ - subrange.start_position_ + 1));
+		double selection_coeff = mutation_type_ptr->DrawSelectionCoefficient();
+		
+		// as in DrawNewMutation(), the nucleotide is -1 and the stacking policy and registries are the caller's responsibility; the
+		// block is allocated from only after the draws, since a type 's' DFE could run script that creates mutations and moves the block
+		MutationIndex new_mut_index = SLiM_NewMutationFromBlock();
+		
+		new (gSLiM_Mutation_Block + new_mut_index) Mutation(mutation_type_ptr, position, selection_coeff, p_subpop_index, p_generation, -1);
+		p_new_mutations[mut_index] = new_mut_index;
+	}
+}
+
 // apply mutation() to a generated mutation; a return of T means accept, F means reject
 bool Chromosome::ApplyMutationCallbacks(Mutation *p_mut, Genome *p_genome, GenomicElement *p_genomic_element, int8_t p_original_nucleotide, std::vector<SLiMEidosBlock*> &p_mutation_callbacks) const
 {
@@ -945,7 +995,7 @@ MutationIndex Chromosome::DrawNewMutationExtended(IndividualSex p_sex, slim_obje
 }
 
 // draw a set of uniqued breakpoints according to the "crossover breakpoint" model and run them through recombination() callbacks, returning the final usable set
-void Chromosome::DrawCrossoverBreakpoints(IndividualSex p_parent_sex, const int p_num_breakpoints, std::vector<slim_position_t> &p_crossovers) const
+void Chromosome::DrawCrossoverBreakpoints(Eidos_RNG_State &p_rng, IndividualSex p_parent_sex, const int p_num_breakpoints, std::vector<slim_position_t> &p_crossovers) const
 {
 	// BEWARE! Chromosome::DrawDSBBreakpoints() below must be altered in parallel with this method!
 #if DEBUG
@@ -954,13 +1004,13 @@ void Chromosome::DrawCrossoverBreakpoints(IndividualSex p_parent_sex, const int
 #endif
 	
 	gsl_ran_discrete_t *lookup;
-	const std::vector<slim_position_t> *end_positions;
+	const slim_position_t *end_positions;
 	
 	if (single_recombination_map_)
 	{
 		// With a single map, we don't care what sex we are passed; same map for all, and sex may be enabled or disabled
 		lookup = lookup_recombination_H_;
-		end_positions = &recombination_end_positions_H_;
+		end_positions = recombination_end_positions_H_.data();
 	}
 	else
 	{
@@ -968,12 +1018,12 @@ void Chromosome::DrawCrossoverBreakpoints(IndividualSex p_parent_sex, const int
 		if (p_parent_sex == IndividualSex::kMale)
 		{
 			lookup = lookup_recombination_M_;
-			end_positions = &recombination_end_positions_M_;
+			end_positions = recombination_end_positions_M_.data();
 		}
 		else if (p_parent_sex == IndividualSex::kFemale)
 		{
 			lookup = lookup_recombination_F_;
-			end_positions = &recombination_end_positions_F_;
+			end_positions = recombination_end_positions_F_.data();
 		}
 		else
 		{
@@ -981,11 +1031,19 @@ void Chromosome::DrawCrossoverBreakpoints(IndividualSex p_parent_sex, const int
 		}
 	}
 	
+	// breakpoints are appended to p_crossovers, so that callers can draw directly into a larger buffer; only the appended segment is
+	// sorted and uniqued, so callers that want just this gamete's breakpoints pass an empty vector
+	size_t crossovers_start = p_crossovers.size();
+	
+	p_crossovers.resize(crossovers_start + (size_t)p_num_breakpoints);
+	
+	slim_position_t *gamete_start = p_crossovers.data() + crossovers_start;
+	slim_position_t *gamete_end = gamete_start;
+	
 	// draw recombination breakpoints
 	for (int i = 0; i < p_num_breakpoints; i++)
 	{
-		slim_position_t breakpoint = 0;
-		int recombination_interval = static_cast<int>(gsl_ran_discrete(EIDOS_GSL_RNG, lookup));
+		int recombination_interval = static_cast<int>(gsl_ran_discrete(p_rng.gsl_rng_, lookup));
 		
 		// choose a breakpoint anywhere in the chosen recombination interval with equal probability
 		
@@ -1019,18 +1077,16 @@ void Chromosome::DrawCrossoverBreakpoints(IndividualSex p_parent_sex, const int
 		// since we guarantee that recombination end positions are in strictly ascending order.  So we should never crash.  :->
 		
 		if (recombination_interval == 0)
-			breakpoint = static_cast<slim_position_t>(Eidos_rng_uniform_int_MT64((*end_positions)[recombination_interval]) + 1);
+			*(gamete_end++) = static_cast<slim_position_t>(Eidos_rng_uniform_int_MT64(p_rng, end_positions[recombination_interval]) + 1);
 		else
-			breakpoint = (*end_positions)[recombination_interval - 1] + 1 + static_cast<slim_position_t>(Eidos_rng_uniform_int_MT64((*end_positions)[recombination_interval] - (*end_positions)[recombination_interval - 1]));
-		
-		p_crossovers.emplace_back(breakpoint);
+			*(gamete_end++) = end_positions[recombination_interval - 1] + 1 + static_cast<slim_position_t>(Eidos_rng_uniform_int_MT64(p_rng, end_positions[recombination_interval] - end_positions[recombination_interval - 1]));
 	}
 	
-	// sort and unique
+	// sort and unique the breakpoints we drew
 	if (p_num_breakpoints > 2)
 	{
-		std::sort(p_crossovers.begin(), p_crossovers.end());
-		p_crossovers.erase(std::unique(p_crossovers.begin(), p_crossovers.end()), p_crossovers.end());
+		std::sort(gamete_start, gamete_end);
+		gamete_end = std::unique(gamete_start, gamete_end);
 	}
 	else if (p_num_breakpoints == 2)
 	{
@@ -1038,14 +1094,13 @@ void Chromosome::DrawCrossoverBreakpoints(IndividualSex p_parent_sex, const int
 		// I didn't actually test this to confirm that it's faster, but models that generate many
 		// breakpoints will generally hit the case above anyway, and models that generate few will
 		// suffer only the additional (num_breakpoints == 2) test before falling through...
-		slim_position_t bp1 = p_crossovers[0];
-		slim_position_t bp2 = p_crossovers[1];
-		
-		if (bp1 > bp2)
-			std::swap(p_crossovers[0], p_crossovers[1]);
-		else if (bp1 == bp2)
-			p_crossovers.resize(1);
+		if (gamete_start[0] > gamete_start[1])
+			std::swap(gamete_start[0], gamete_start[1]);
+		else if (gamete_start[0] == gamete_start[1])
+			gamete_end--;
 	}
+	
+	p_crossovers.resize(crossovers_start + (size_t)(gamete_end - gamete_start));
 }
 
 // draw a set of uniqued breakpoints according to the "double-stranded break" model and run them through recombination() callbacks, returning the final usable set
@@ -187,26 +187,36 @@ public:
 	inline bool UsingSingleMutationMap(void) const { return single_mutation_map_; }
 	inline size_t GenomicElementCount(void) const { return genomic_elements_.size(); }
 	
+	// The draw methods below that take an Eidos_RNG_State draw from that RNG (such as a per-thread stream; see eidos_rng.h);
+	// the variants without one draw from gEidos_RNG.  The results are otherwise identical.
+	
 	// draw the number of mutations that occur, based on the overall mutation rate
-	int DrawMutationCount(IndividualSex p_sex) const;
+	int DrawMutationCount(Eidos_RNG_State &p_rng, IndividualSex p_sex) const;
+	inline int DrawMutationCount(IndividualSex p_sex) const { return DrawMutationCount(gEidos_RNG, p_sex); }
 	
 	// draw a new mutation, based on the genomic element types present and their mutational proclivities
 	MutationIndex DrawNewMutation(IndividualSex p_sex, slim_objectid_t p_subpop_index, slim_generation_t p_generation) const;
 	
+	// draw p_count new mutations into p_new_mutations, for one gamete; the result is identical to p_count successive calls to DrawNewMutation()
+	void DrawNewMutations(IndividualSex p_sex, slim_objectid_t p_subpop_index, slim_generation_t p_generation, int p_count, MutationIndex *p_new_mutations) const;
+	
 	// draw a new mutation with reference to the genomic background upon which it is occurring, for nucleotide-based models and/or mutation() callbacks
 	bool ApplyMutationCallbacks(Mutation *p_mut, Genome *p_genome, GenomicElement *p_genomic_element, int8_t p_original_nucleotide, std::vector<SLiMEidosBlock*> &p_mutation_callbacks) const;
 	MutationIndex DrawNewMutationExtended(IndividualSex p_sex, slim_objectid_t p_subpop_index, slim_generation_t p_generation, Genome *parent_genome_1, Genome *parent_genome_2, std::vector<slim_position_t> *all_breakpoints, std::vector<SLiMEidosBlock*> *p_mutation_callbacks) const;
 	
 	// draw the number of breakpoints that occur, based on the overall recombination rate
-	int DrawBreakpointCount(IndividualSex p_sex) const;
+	int DrawBreakpointCount(Eidos_RNG_State &p_rng, IndividualSex p_sex) const;
+	inline int DrawBreakpointCount(IndividualSex p_sex) const { return DrawBreakpointCount(gEidos_RNG, p_sex); }
 	
 	// choose a set of recombination breakpoints, based on recomb. intervals, overall recomb. rate, and gene conversion parameters
-	void DrawCrossoverBreakpoints(IndividualSex p_parent_sex, const int p_num_breakpoints, std::vector<slim_position_t> &p_crossovers) const;
+	void DrawCrossoverBreakpoints(Eidos_RNG_State &p_rng, IndividualSex p_parent_sex, const int p_num_breakpoints, std::vector<slim_position_t> &p_crossovers) const;
+	inline void DrawCrossoverBreakpoints(IndividualSex p_parent_sex, const int p_num_breakpoints, std::vector<slim_position_t> &p_crossovers) const { DrawCrossoverBreakpoints(gEidos_RNG, p_parent_sex, p_num_breakpoints, p_crossovers); }
 	void DrawDSBBreakpoints(IndividualSex p_parent_sex, const int p_num_breakpoints, std::vector<slim_position_t> &p_crossovers, std::vector<slim_position_t> &p_heteroduplex) const;
 	
 #ifndef USE_GSL_POISSON
 	// draw both the mutation count and breakpoint count, using a single Poisson draw for speed
-	void DrawMutationAndBreakpointCounts(IndividualSex p_sex, int *p_mut_count, int *p_break_count) const;
+	void DrawMutationAndBreakpointCounts(Eidos_RNG_State &p_rng, IndividualSex p_sex, int *p_mut_count, int *p_break_count) const;
+	inline void DrawMutationAndBreakpointCounts(IndividualSex p_sex, int *p_mut_count, int *p_break_count) const { DrawMutationAndBreakpointCounts(gEidos_RNG, p_sex, p_mut_count, p_break_count); }
 	
 	// initialize the joint probabilities used by DrawMutationAndBreakpointCounts()
 	void _InitializeJointProbabilities(double p_overall_mutation_rate, double p_exp_neg_overall_mutation_rate,
@@ -243,24 +253,24 @@ public:
 };
 
 // draw the number of mutations that occur, based on the overall mutation rate
-inline __attribute__((always_inline)) int Chromosome::DrawMutationCount(IndividualSex p_sex) const
+inline __attribute__((always_inline)) int Chromosome::DrawMutationCount(Eidos_RNG_State &p_rng, IndividualSex p_sex) const
 {
 #ifdef USE_GSL_POISSON
 	if (single_mutation_map_)
 	{
 		// With a single map, we don't care what sex we are passed; same map for all, and sex may be enabled or disabled
-		return gsl_ran_poisson(EIDOS_GSL_RNG, overall_mutation_rate_H_);
+		return gsl_ran_poisson(p_rng.gsl_rng_, overall_mutation_rate_H_);
 	}
 	else
 	{
 		// With sex-specific maps, we treat males and females separately, and the individual we're given better be one of the two
 		if (p_sex == IndividualSex::kMale)
 		{
-			return gsl_ran_poisson(EIDOS_GSL_RNG, overall_mutation_rate_M_);
+			return gsl_ran_poisson(p_rng.gsl_rng_, overall_mutation_rate_M_);
 		}
 		else if (p_sex == IndividualSex::kFemale)
 		{
-			return gsl_ran_poisson(EIDOS_GSL_RNG, overall_mutation_rate_F_);
+			return gsl_ran_poisson(p_rng.gsl_rng_, overall_mutation_rate_F_);
 		}
 		else
 		{
@@ -271,18 +281,18 @@ inline __attribute__((always_inline)) int Chromosome::DrawMutationCount(Individu
 	if (single_mutation_map_)
 	{
 		// With a single map, we don't care what sex we are passed; same map for all, and sex may be enabled or disabled
-		return Eidos_FastRandomPoisson(overall_mutation_rate_H_, exp_neg_overall_mutation_rate_H_);
+		return Eidos_FastRandomPoisson(p_rng.gsl_rng_, overall_mutation_rate_H_, exp_neg_overall_mutation_rate_H_);
 	}
 	else
 	{
 		// With sex-specific maps, we treat males and females separately, and the individual we're given better be one of the two
 		if (p_sex == IndividualSex::kMale)
 		{
-			return Eidos_FastRandomPoisson(overall_mutation_rate_M_, exp_neg_overall_mutation_rate_M_);
+			return Eidos_FastRandomPoisson(p_rng.gsl_rng_, overall_mutation_rate_M_, exp_neg_overall_mutation_rate_M_);
 		}
 		else if (p_sex == IndividualSex::kFemale)
 		{
-			return Eidos_FastRandomPoisson(overall_mutation_rate_F_, exp_neg_overall_mutation_rate_F_);
+			return Eidos_FastRandomPoisson(p_rng.gsl_rng_, overall_mutation_rate_F_, exp_neg_overall_mutation_rate_F_);
 		}
 		else
 		{
@@ -293,24 +303,24 @@ inline __attribute__((always_inline)) int Chromosome::DrawMutationCount(Individu
 }
 
 // draw the number of breakpoints that occur, based on the overall recombination rate
-inline __attribute__((always_inline)) int Chromosome::DrawBreakpointCount(IndividualSex p_sex) const
+inline __attribute__((always_inline)) int Chromosome::DrawBreakpointCount(Eidos_RNG_State &p_rng, IndividualSex p_sex) const
 {
 #ifdef USE_GSL_POISSON
 	if (single_recombination_map_)
 	{
 		// With a single map, we don't care what sex we are passed; same map for all, and sex may be enabled or disabled
-		return gsl_ran_poisson(EIDOS_GSL_RNG, overall_recombination_rate_H_);
+		return gsl_ran_poisson(p_rng.gsl_rng_, overall_recombination_rate_H_);
 	}
 	else
 	{
 		// With sex-specific maps, we treat males and females separately, and the individual we're given better be one of the two
 		if (p_sex == IndividualSex::kMale)
 		{
-			return gsl_ran_poisson(EIDOS_GSL_RNG, overall_recombination_rate_M_);
+			return gsl_ran_poisson(p_rng.gsl_rng_, overall_recombination_rate_M_);
 		}
 		else if (p_sex == IndividualSex::kFemale)
 		{
-			return gsl_ran_poisson(EIDOS_GSL_RNG, overall_recombination_rate_F_);
+			return gsl_ran_poisson(p_rng.gsl_rng_, overall_recombination_rate_F_);
 		}
 		else
 		{
@@ -321,18 +331,18 @@ inline __attribute__((always_inline)) int Chromosome::DrawBreakpointCount(Indivi
 	if (single_recombination_map_)
 	{
 		// With a single map, we don't care what sex we are passed; same map for all, and sex may be enabled or disabled
-		return Eidos_FastRandomPoisson(overall_recombination_rate_H_, exp_neg_overall_recombination_rate_H_);
+		return Eidos_FastRandomPoisson(p_rng.gsl_rng_, overall_recombination_rate_H_, exp_neg_overall_recombination_rate_H_);
 	}
 	else
 	{
 		// With sex-specific maps, we treat males and females separately, and the individual we're given better be one of the two
 		if (p_sex == IndividualSex::kMale)
 		{
-			return Eidos_FastRandomPoisson(overall_recombination_rate_M_, exp_neg_overall_recombination_rate_M_);
+			return Eidos_FastRandomPoisson(p_rng.gsl_rng_, overall_recombination_rate_M_, exp_neg_overall_recombination_rate_M_);
 		}
 		else if (p_sex == IndividualSex::kFemale)
 		{
-			return Eidos_FastRandomPoisson(overall_recombination_rate_F_, exp_neg_overall_recombination_rate_F_);
+			return Eidos_FastRandomPoisson(p_rng.gsl_rng_, overall_recombination_rate_F_, exp_neg_overall_recombination_rate_F_);
 		}
 		else
 		{
@@ -345,9 +355,9 @@ inline __attribute__((always_inline)) int Chromosome::DrawBreakpointCount(Indivi
 #ifndef USE_GSL_POISSON
 // determine both the mutation count and the breakpoint count with (usually) a single RNG draw
 // this method relies on Eidos_FastRandomPoisson_NONZERO() and cannot be called when USE_GSL_POISSON is defined
-inline __attribute__((always_inline)) void Chromosome::DrawMutationAndBreakpointCounts(IndividualSex p_sex, int *p_mut_count, int *p_break_count) const
+inline __attribute__((always_inline)) void Chromosome::DrawMutationAndBreakpointCounts(Eidos_RNG_State &p_rng, IndividualSex p_sex, int *p_mut_count, int *p_break_count) const
 {
-	double u = Eidos_rng_uniform(EIDOS_GSL_RNG);
+	double u = Eidos_rng_uniform(p_rng.gsl_rng_);
 	
 	if (single_recombination_map_ && single_mutation_map_)
 	{
@@ -361,17 +371,17 @@ inline __attribute__((always_inline)) void Chromosome::DrawMutationAndBreakpoint
 		else if (u <= probability_both_0_OR_mut_0_break_non0_H_)
 		{
 			*p_mut_count = 0;
-			*p_break_count = Eidos_FastRandomPoisson_NONZERO(overall_recombination_rate_H_, exp_neg_overall_recombination_rate_H_);
+			*p_break_count = Eidos_FastRandomPoisson_NONZERO(p_rng.gsl_rng_, overall_recombination_rate_H_, exp_neg_overall_recombination_rate_H_);
 		}
 		else if (u <= probability_both_0_OR_mut_0_break_non0_OR_mut_non0_break_0_H_)
 		{
-			*p_mut_count = Eidos_FastRandomPoisson_NONZERO(overall_mutation_rate_H_, exp_neg_overall_mutation_rate_H_);
+			*p_mut_count = Eidos_FastRandomPoisson_NONZERO(p_rng.gsl_rng_, overall_mutation_rate_H_, exp_neg_overall_mutation_rate_H_);
 			*p_break_count = 0;
 		}
 		else
 		{
-			*p_mut_count = Eidos_FastRandomPoisson_NONZERO(overall_mutation_rate_H_, exp_neg_overall_mutation_rate_H_);
-			*p_break_count = Eidos_FastRandomPoisson_NONZERO(overall_recombination_rate_H_, exp_neg_overall_recombination_rate_H_);
+			*p_mut_count = Eidos_FastRandomPoisson_NONZERO(p_rng.gsl_rng_, overall_mutation_rate_H_, exp_neg_overall_mutation_rate_H_);
+			*p_break_count = Eidos_FastRandomPoisson_NONZERO(p_rng.gsl_rng_, overall_recombination_rate_H_, exp_neg_overall_recombination_rate_H_);
 		}
 	}
 	else
@@ -390,17 +400,17 @@ inline __attribute__((always_inline)) void Chromosome::DrawMutationAndBreakpoint
 			else if (u <= probability_both_0_OR_mut_0_break_non0_M_)
 			{
 				*p_mut_count = 0;
-				*p_break_count = Eidos_FastRandomPoisson_NONZERO(overall_recombination_rate_M_, exp_neg_overall_recombination_rate_M_);
+				*p_break_count = Eidos_FastRandomPoisson_NONZERO(p_rng.gsl_rng_, overall_recombination_rate_M_, exp_neg_overall_recombination_rate_M_);
 			}
 			else if (u <= probability_both_0_OR_mut_0_break_non0_OR_mut_non0_break_0_M_)
 			{
-				*p_mut_count = Eidos_FastRandomPoisson_NONZERO(overall_mutation_rate_M_, exp_neg_overall_mutation_rate_M_);
+				*p_mut_count = Eidos_FastRandomPoisson_NONZERO(p_rng.gsl_rng_, overall_mutation_rate_M_, exp_neg_overall_mutation_rate_M_);
 				*p_break_count = 0;
 			}
 			else
 			{
-				*p_mut_count = Eidos_FastRandomPoisson_NONZERO(overall_mutation_rate_M_, exp_neg_overall_mutation_rate_M_);
-				*p_break_count = Eidos_FastRandomPoisson_NONZERO(overall_recombination_rate_M_, exp_neg_overall_recombination_rate_M_);
+				*p_mut_count = Eidos_FastRandomPoisson_NONZERO(p_rng.gsl_rng_, overall_mutation_rate_M_, exp_neg_overall_mutation_rate_M_);
+				*p_break_count = Eidos_FastRandomPoisson_NONZERO(p_rng.gsl_rng_, overall_recombination_rate_M_, exp_neg_overall_recombination_rate_M_);
 			}
 		}
 		else if (p_sex == IndividualSex::kFemale)
@@ -413,17 +423,17 @@ inline __attribute__((always_inline)) void Chromosome::DrawMutationAndBreakpoint
 			else if (u <= probability_both_0_OR_mut_0_break_non0_F_)
 			{
 				*p_mut_count = 0;
-				*p_break_count = Eidos_FastRandomPoisson_NONZERO(overall_recombination_rate_F_, exp_neg_overall_recombination_rate_F_);
+				*p_break_count = Eidos_FastRandomPoisson_NONZERO(p_rng.gsl_rng_, overall_recombination_rate_F_, exp_neg_overall_recombination_rate_F_);
 			}
 			else if (u <= probability_both_0_OR_mut_0_break_non0_OR_mut_non0_break_0_F_)
 			{
-				*p_mut_count = Eidos_FastRandomPoisson_NONZERO(overall_mutation_rate_F_, exp_neg_overall_mutation_rate_F_);
+				*p_mut_count = Eidos_FastRandomPoisson_NONZERO(p_rng.gsl_rng_, overall_mutation_rate_F_, exp_neg_overall_mutation_rate_F_);
 				*p_break_count = 0;
 			}
 			else
 			{
-				*p_mut_count = Eidos_FastRandomPoisson_NONZERO(overall_mutation_rate_F_, exp_neg_overall_mutation_rate_F_);
-				*p_break_count = Eidos_FastRandomPoisson_NONZERO(overall_recombination_rate_F_, exp_neg_overall_recombination_rate_F_);
+				*p_mut_count = Eidos_FastRandomPoisson_NONZERO(p_rng.gsl_rng_, overall_mutation_rate_F_, exp_neg_overall_mutation_rate_F_);
+				*p_break_count = Eidos_FastRandomPoisson_NONZERO(p_rng.gsl_rng_, overall_recombination_rate_F_, exp_neg_overall_recombination_rate_F_);
 			}
 		}
 		else
@@ -189,19 +189,6 @@ void Genome::BulkOperationEnd(int64_t p_operation_id, slim_mutrun_index_t p_mutr
 	}
 }
 
-// Remove all mutations in p_genome that have a refcount of p_fixed_count, indicating that they have fixed
-// This must be called with mutation counts set up correctly as all-population counts, or it will malfunction!
-void Genome::RemoveFixedMutations(int64_t p_operation_id, slim_mutrun_index_t p_mutrun_index)
-{
-#ifdef DEBUG
-	if (mutrun_count_ == 0)
-		NullGenomeAccessError();
-#endif
-	// This used to call RemoveFixedMutations() on each mutation run; now it removes only within a given
-	// mutation run index, allowing all the parts of the genome that don't contain fixed mutations to be skipped
-	mutruns_[p_mutrun_index]->RemoveFixedMutations(p_operation_id);
-}
-
 void Genome::TallyGenomeReferences(slim_refcount_t *p_mutrun_ref_tally, slim_refcount_t *p_mutrun_tally, int64_t p_operation_id)
 {
 #ifdef DEBUG
@@ -3844,7 +3831,7 @@ EidosValue_SP Genome_Class::ExecuteMethod_removeMutations(EidosGlobalStringID p_
 				// See if WillModifyRunForBulkOperation() can short-circuit the operation for us
 				if (target_genome->WillModifyRunForBulkOperation(operation_id, mutrun_index))
 				{
-					// Remove the specified mutations; see RemoveFixedMutations for the origins of this code
+					// Remove the specified mutations; see MutationRun::_RemoveFixedMutations() for the origins of this code
 					MutationRun *mutrun = target_genome->mutruns_[mutrun_index].get();
 					MutationIndex *genome_iter = mutrun->begin_pointer();
 					MutationIndex *genome_backfill_iter = mutrun->begin_pointer();
@@ -38,6 +38,7 @@
 #include "eidos_test.h"
 #include "slim_test.h"
 #include "eidos_test_element.h"
+#include "eidos_bytecode.h"
 
 
 // To leak-check slim, a few steps are recommended (BCH 5/1/2019):
@@ -98,7 +99,9 @@ static void PrintUsageAndDie(bool p_print_header, bool p_print_full_usage)
 	
 	SLIM_OUTSTREAM << "usage: slim -v[ersion] | -u[sage] | -testEidos | -testSLiM |" << std::endl;
 	SLIM_OUTSTREAM << "   [-l[ong]] [-s[eed] <seed>] [-t[ime]] [-m[em]] [-M[emhist]] [-x]" << std::endl;
-	SLIM_OUTSTREAM << "   [-d[efine] <def>] [<script file>]" << std::endl;
+	SLIM_OUTSTREAM << "   [-threads <n>] [-parallelThreshold <n>] [-noCompile] [-fitnessLanes]" << std::endl;
+	SLIM_OUTSTREAM << "   [-d[efine] <def>]" << std::endl;
+	SLIM_OUTSTREAM << "   [<script file>]" << std::endl;
 	
 	if (p_print_full_usage)
 	{
@@ -114,6 +117,14 @@ static void PrintUsageAndDie(bool p_print_header, bool p_print_full_usage)
 		SLIM_OUTSTREAM << "   -m[em]           : print SLiM's peak memory usage" << std::endl;
 		SLIM_OUTSTREAM << "   -M[emhist]       : print a histogram of SLiM's memory usage" << std::endl;
 		SLIM_OUTSTREAM << "   -x               : disable SLiM's runtime safety/consistency checks" << std::endl;
+		SLIM_OUTSTREAM << "   -threads <n>     : use up to n threads for work that SLiM can parallelize" << std::endl;
+		SLIM_OUTSTREAM << "   -parallelThreshold <n>" << std::endl;
+		SLIM_OUTSTREAM << "                    : with -threads, parallelize Eidos functions such as sort()" << std::endl;
+		SLIM_OUTSTREAM << "                      only for vectors of at least n elements (default 100000)" << std::endl;
+		SLIM_OUTSTREAM << "   -noCompile       : interpret callbacks directly, without compiling them" << std::endl;
+		SLIM_OUTSTREAM << "   -fitnessLanes    : multiply fitness effects in four interleaved lanes (with AVX2" << std::endl;
+		SLIM_OUTSTREAM << "                      where available); faster, but rounds differently from the" << std::endl;
+		SLIM_OUTSTREAM << "                      default serial product, so results differ for a given seed" << std::endl;
 		SLIM_OUTSTREAM << "   -d[efine] <def>  : define an Eidos constant, such as \"mu=1e-7\"" << std::endl;
 		SLIM_OUTSTREAM << "   <script file>    : the input script file (stdin may be used instead)" << std::endl;
 	}
@@ -224,6 +235,58 @@ int main(int argc, char *argv[])
 			continue;
 		}
 		
+		// -threads <n>: allow up to n threads to be used for work that SLiM can parallelize
+		if (strcmp(arg, "-threads") == 0)
+		{
+			if (++arg_index == argc)
+				PrintUsageAndDie(false, true);
+			
+			long thread_count = strtol(argv[arg_index], NULL, 10);
+			
+			if ((thread_count < 1) || (thread_count > 1024))
+				EIDOS_TERMINATION << "ERROR (main): the -threads option requires a thread count between 1 and 1024." << EidosTerminate();
+#ifndef _OPENMP
+			if (thread_count > 1)
+				EIDOS_TERMINATION << "ERROR (main): this build of SLiM does not support multithreading; it must be built with OpenMP for -threads to be used." << EidosTerminate();
+#endif
+			
+			gEidosMaxThreads = (int)thread_count;
+			
+			continue;
+		}
+		
+		// -parallelThreshold <n>: parallelize vectorized Eidos functions only for vectors of at least n elements
+		if (strcmp(arg, "-parallelThreshold") == 0)
+		{
+			if (++arg_index == argc)
+				PrintUsageAndDie(false, true);
+			
+			long long threshold = strtoll(argv[arg_index], NULL, 10);
+			
+			if (threshold < 1)
+				EIDOS_TERMINATION << "ERROR (main): the -parallelThreshold option requires a positive element count." << EidosTerminate();
+			
+			gEidosParallelVectorThreshold = (int64_t)threshold;
+			
+			continue;
+		}
+		
+		// -noCompile: do not compile callbacks to bytecode; all script is run by the AST-walking interpreter
+		if (strcmp(arg, "-noCompile") == 0)
+		{
+			gEidosBytecodeCompilation = false;
+			
+			continue;
+		}
+		
+		// -fitnessLanes: accumulate fitness products in four interleaved lanes, trading exact reproducibility for speed
+		if (strcmp(arg, "-fitnessLanes") == 0)
+		{
+			SLiM_fitness_lanes = true;
+			
+			continue;
+		}
+		
 		// -version or -v: print version information
 		if (strcmp(arg, "-version") == 0 || strcmp(arg, "-v") == 0)
 		{
@@ -297,6 +360,8 @@ int main(int argc, char *argv[])
 		SLIM_ERRSTREAM << "// ********** The -l[ong] command-line option has enabled verbose output" << std::endl << std::endl;
 	if (skip_checks)
 		SLIM_ERRSTREAM << "// ********** The -x command-line option has disabled some runtime checks" << std::endl << std::endl;
+	if (gEidosMaxThreads > 1)
+		SLIM_ERRSTREAM << "// ********** The -threads command-line option has enabled up to " << gEidosMaxThreads << " threads" << std::endl << std::endl;
 	
 	// emit defined constants in verbose mode
 	if (defined_constants.size() && SLiM_verbose_output)
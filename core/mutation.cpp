@@ -36,6 +36,9 @@ MutationIndex gSLiM_Mutation_FreeIndex = -1;
 MutationIndex gSLiM_Mutation_Block_LastUsedIndex = -1;
 
 slim_refcount_t *gSLiM_Mutation_Refcounts = nullptr;
+slim_position_t *gSLiM_Mutation_Positions = nullptr;
+slim_selcoeff_t *gSLiM_Mutation_OnePlusSel = nullptr;
+slim_selcoeff_t *gSLiM_Mutation_OnePlusDomSel = nullptr;
 
 #define SLIM_MUTATION_BLOCK_INITIAL_SIZE	16384		// makes for about a 1 MB block; not unreasonable
 
@@ -47,6 +50,9 @@ void SLiM_CreateMutationBlock(void)
 	gSLiM_Mutation_Block_Capacity = SLIM_MUTATION_BLOCK_INITIAL_SIZE;
 	gSLiM_Mutation_Block = (Mutation *)malloc(gSLiM_Mutation_Block_Capacity * sizeof(Mutation));
 	gSLiM_Mutation_Refcounts = (slim_refcount_t *)malloc(gSLiM_Mutation_Block_Capacity * sizeof(slim_refcount_t));
+	gSLiM_Mutation_Positions = (slim_position_t *)malloc(gSLiM_Mutation_Block_Capacity * sizeof(slim_position_t));
+	gSLiM_Mutation_OnePlusSel = (slim_selcoeff_t *)malloc(gSLiM_Mutation_Block_Capacity * sizeof(slim_selcoeff_t));
+	gSLiM_Mutation_OnePlusDomSel = (slim_selcoeff_t *)malloc(gSLiM_Mutation_Block_Capacity * sizeof(slim_selcoeff_t));
 	
 	//std::cout << "Allocating initial mutation block, " << SLIM_MUTATION_BLOCK_INITIAL_SIZE * sizeof(Mutation) << " bytes (sizeof(Mutation) == " << sizeof(Mutation) << ")" << std::endl;
 	
@@ -84,6 +90,9 @@ void SLiM_IncreaseMutationBlockCapacity(void)
 	gSLiM_Mutation_Block_Capacity *= 2;
 	gSLiM_Mutation_Block = (Mutation *)realloc(gSLiM_Mutation_Block, gSLiM_Mutation_Block_Capacity * sizeof(Mutation));
 	gSLiM_Mutation_Refcounts = (slim_refcount_t *)realloc(gSLiM_Mutation_Refcounts, gSLiM_Mutation_Block_Capacity * sizeof(slim_refcount_t));
+	gSLiM_Mutation_Positions = (slim_position_t *)realloc(gSLiM_Mutation_Positions, gSLiM_Mutation_Block_Capacity * sizeof(slim_position_t));
+	gSLiM_Mutation_OnePlusSel = (slim_selcoeff_t *)realloc(gSLiM_Mutation_OnePlusSel, gSLiM_Mutation_Block_Capacity * sizeof(slim_selcoeff_t));
+	gSLiM_Mutation_OnePlusDomSel = (slim_selcoeff_t *)realloc(gSLiM_Mutation_OnePlusDomSel, gSLiM_Mutation_Block_Capacity * sizeof(slim_selcoeff_t));
 	
 	std::uintptr_t new_mutation_block = reinterpret_cast<std::uintptr_t>(gSLiM_Mutation_Block);
 	
@@ -162,7 +171,8 @@ void SLiM_ZeroRefcountBlock(__attribute__((unused)) MutationRun &p_mutation_regi
 
 size_t SLiM_MemoryUsageForMutationBlock(void)
 {
-	return gSLiM_Mutation_Block_Capacity * sizeof(Mutation);
+	// this includes the dense auxiliary buffers for positions and fitness effects, which are really part of the block
+	return gSLiM_Mutation_Block_Capacity * (sizeof(Mutation) + sizeof(slim_position_t) + 2 * sizeof(slim_selcoeff_t));
 }
 
 size_t SLiM_MemoryUsageForMutationRefcounts(void)
@@ -184,12 +194,14 @@ mutation_type_ptr_(p_mutation_type_ptr), position_(p_position), selection_coeff_
 	// initialize the tag to the "unset" value
 	tag_value_ = SLIM_TAG_UNSET_VALUE;
 	
-	// cache values used by the fitness calculation code for speed; see header
-	cached_one_plus_sel_ = (slim_selcoeff_t)std::max(0.0, 1.0 + selection_coeff_);
-	cached_one_plus_dom_sel_ = (slim_selcoeff_t)std::max(0.0, 1.0 + mutation_type_ptr_->dominance_coeff_ * selection_coeff_);
+	// cache values used by the fitness calculation code and the merge loops for speed, in dense buffers; see header
+	MutationIndex block_index = BlockIndex();
+	
+	gSLiM_Mutation_Positions[block_index] = position_;
+	CacheFitnessEffects();
 	
 	// zero out our refcount, which is now kept in a separate buffer
-	gSLiM_Mutation_Refcounts[BlockIndex()] = 0;
+	gSLiM_Mutation_Refcounts[block_index] = 0;
 	
 #if DEBUG_MUTATIONS
 	SLIM_OUTSTREAM << "Mutation constructed: " << this << std::endl;
@@ -210,8 +222,6 @@ mutation_type_ptr_(p_mutation_type_ptr), position_(p_position), selection_coeff_
 		// need to add nucleotide_based_ and nucleotide_
 		char *ptr_mutation_id_ = (char *)&(this->mutation_id_);
 		char *ptr_tag_value_ = (char *)&(this->tag_value_);
-		char *ptr_cached_one_plus_sel_ = (char *)&(this->cached_one_plus_sel_);
-		char *ptr_cached_one_plus_dom_sel_ = (char *)&(this->cached_one_plus_dom_sel_);
 		
 		std::cout << "Class Mutation memory layout:" << std::endl << std::endl;
 		std::cout << "   " << (ptr_mutation_type_ptr_ - ptr_base) << " (" << sizeof(MutationType *) << " bytes): MutationType *mutation_type_ptr_" << std::endl;
@@ -221,8 +231,6 @@ mutation_type_ptr_(p_mutation_type_ptr), position_(p_position), selection_coeff_
 		std::cout << "   " << (ptr_origin_generation_ - ptr_base) << " (" << sizeof(slim_generation_t) << " bytes): const slim_generation_t origin_generation_" << std::endl;
 		std::cout << "   " << (ptr_mutation_id_ - ptr_base) << " (" << sizeof(slim_mutationid_t) << " bytes): const slim_mutationid_t mutation_id_" << std::endl;
 		std::cout << "   " << (ptr_tag_value_ - ptr_base) << " (" << sizeof(slim_usertag_t) << " bytes): slim_usertag_t tag_value_" << std::endl;
-		std::cout << "   " << (ptr_cached_one_plus_sel_ - ptr_base) << " (" << sizeof(slim_selcoeff_t) << " bytes): slim_selcoeff_t cached_one_plus_sel_" << std::endl;
-		std::cout << "   " << (ptr_cached_one_plus_dom_sel_ - ptr_base) << " (" << sizeof(slim_selcoeff_t) << " bytes): slim_selcoeff_t cached_one_plus_dom_sel_" << std::endl;
 		std::cout << std::endl;
 		
 		been_here = true;
@@ -236,12 +244,14 @@ mutation_type_ptr_(p_mutation_type_ptr), position_(p_position), selection_coeff_
 	// initialize the tag to the "unset" value
 	tag_value_ = SLIM_TAG_UNSET_VALUE;
 	
-	// cache values used by the fitness calculation code for speed; see header
-	cached_one_plus_sel_ = (slim_selcoeff_t)std::max(0.0, 1.0 + selection_coeff_);
-	cached_one_plus_dom_sel_ = (slim_selcoeff_t)std::max(0.0, 1.0 + mutation_type_ptr_->dominance_coeff_ * selection_coeff_);
+	// cache values used by the fitness calculation code and the merge loops for speed, in dense buffers; see header
+	MutationIndex block_index = BlockIndex();
+	
+	gSLiM_Mutation_Positions[block_index] = position_;
+	CacheFitnessEffects();
 	
 	// zero out our refcount, which is now kept in a separate buffer
-	gSLiM_Mutation_Refcounts[BlockIndex()] = 0;
+	gSLiM_Mutation_Refcounts[block_index] = 0;
 	
 #if DEBUG_MUTATIONS
 	SLIM_OUTSTREAM << "Mutation constructed: " << this << std::endl;
@@ -252,6 +262,14 @@ mutation_type_ptr_(p_mutation_type_ptr), position_(p_position), selection_coeff_
 		gSLiM_next_mutation_id = mutation_id_ + 1;
 }
 
+void Mutation::CacheFitnessEffects(void)
+{
+	MutationIndex block_index = BlockIndex();
+	
+	gSLiM_Mutation_OnePlusSel[block_index] = (slim_selcoeff_t)std::max(0.0, 1.0 + selection_coeff_);
+	gSLiM_Mutation_OnePlusDomSel[block_index] = (slim_selcoeff_t)std::max(0.0, 1.0 + mutation_type_ptr_->dominance_coeff_ * selection_coeff_);
+}
+
 // This is unused except by debugging code and in the debugger itself
 std::ostream &operator<<(std::ostream &p_outstream, const Mutation &p_mutation)
 {
@@ -622,8 +640,7 @@ EidosValue_SP Mutation::ExecuteMethod_setSelectionCoeff(EidosGlobalStringID p_me
 	}
 	
 	// cache values used by the fitness calculation code for speed; see header
-	cached_one_plus_sel_ = (slim_selcoeff_t)std::max(0.0, 1.0 + selection_coeff_);
-	cached_one_plus_dom_sel_ = (slim_selcoeff_t)std::max(0.0, 1.0 + mutation_type_ptr_->dominance_coeff_ * selection_coeff_);
+	CacheFitnessEffects();
 	
 	return gStaticEidosValueVOID;
 }
@@ -649,8 +666,7 @@ EidosValue_SP Mutation::ExecuteMethod_setMutationType(EidosGlobalStringID p_meth
 		mutation_type_ptr_->all_pure_neutral_DFE_ = false;
 	
 	// cache values used by the fitness calculation code for speed; see header
-	cached_one_plus_sel_ = (slim_selcoeff_t)std::max(0.0, 1.0 + selection_coeff_);
-	cached_one_plus_dom_sel_ = (slim_selcoeff_t)std::max(0.0, 1.0 + mutation_type_ptr_->dominance_coeff_ * selection_coeff_);
+	CacheFitnessEffects();
 	
 	return gStaticEidosValueVOID;
 }
@@ -78,12 +78,9 @@ public:
 	mutable slim_refcount_t gui_scratch_reference_count_;	// an additional refcount used for temporary tallies by SLiMgui, valid only when explicitly updated
 #endif
 	
-	// We cache values used in the fitness calculation code, for speed.  These are the final fitness effects of this mutation
-	// when it is homozygous or heterozygous, respectively.  These values are clamped to a minimum of 0.0, so that multiplying
-	// by them cannot cause the fitness of the individual to go below 0.0, avoiding slow tests in the core fitness loop.  These
-	// values use slim_selcoeff_t for speed; roundoff should not be a concern, since such differences would be inconsequential.
-	slim_selcoeff_t cached_one_plus_sel_;				// a cached value for (1 + selection_coeff_), clamped to 0.0 minimum
-	slim_selcoeff_t cached_one_plus_dom_sel_;			// a cached value for (1 + dominance_coeff * selection_coeff_), clamped to 0.0 minimum
+	// The values used in the fitness calculation code, (1 + selection_coeff_) and (1 + dominance_coeff * selection_coeff_), are
+	// cached in gSLiM_Mutation_OnePlusSel and gSLiM_Mutation_OnePlusDomSel, and position_ is mirrored in gSLiM_Mutation_Positions;
+	// see the bottom of this header.  CacheFitnessEffects() must be called whenever selection_coeff_ or the dominance changes.
 	
 	Mutation(const Mutation&) = delete;					// no copying
 	Mutation& operator=(const Mutation&) = delete;		// no copying
@@ -104,6 +101,8 @@ public:
 	
 	inline __attribute__((always_inline)) MutationIndex BlockIndex(void) const			{ return (MutationIndex)(this - gSLiM_Mutation_Block); }
 	
+	void CacheFitnessEffects(void);						// recalculate our entries in gSLiM_Mutation_OnePlusSel and gSLiM_Mutation_OnePlusDomSel
+	
 	//
 	// Eidos support
 	//
@@ -145,6 +144,12 @@ inline __attribute__((always_inline)) bool CompareMutations(const Mutation *p_mu
 	return (p_mutation1->position_ < p_mutation2->position_);
 }
 
+// the same comparison for mutation indices, using gSLiM_Mutation_Positions (declared below) to avoid touching the mutation block
+inline __attribute__((always_inline)) bool CompareMutationIndices(const slim_position_t *p_positions, MutationIndex p_mutation1, MutationIndex p_mutation2)
+{
+	return (p_positions[p_mutation1] < p_positions[p_mutation2]);
+}
+
 // support stream output of Mutation, for debugging
 std::ostream &operator<<(std::ostream &p_outstream, const Mutation &p_mutation);
 
@@ -166,7 +171,18 @@ extern MutationIndex gSLiM_Mutation_FreeIndex;
 extern MutationIndex gSLiM_Mutation_Block_LastUsedIndex;
 
 extern slim_refcount_t *gSLiM_Mutation_Refcounts;	// an auxiliary buffer, parallel to gSLiM_Mutation_Block, to increase memory cache efficiency
-													// note that I tried keeping the fitness cache values and positions in separate buffers too, not a win
+
+// Further auxiliary buffers, parallel to gSLiM_Mutation_Block, holding the fields read by the hottest loops in dense arrays: the
+// mutation run merge loops need only positions, and the fitness loops need only the cached fitness effects.  A Mutation is a full
+// Eidos object with a vtable and dictionary state, so reading these fields from the block touches a cache line per mutation; from
+// these arrays, eight mutations' positions or sixteen mutations' fitness effects share a cache line, and the fitness effects can be read
+// with SIMD gathers.  The position is immutable and is written only by the constructors; the fitness effects are clamped to a
+// minimum of 0.0, so that multiplying by them cannot cause the fitness of the individual to go below 0.0, avoiding slow tests in
+// the core fitness loop, and they use slim_selcoeff_t for speed; roundoff should not be a concern.
+extern slim_position_t *gSLiM_Mutation_Positions;	// a copy of position_ for each mutation
+extern slim_selcoeff_t *gSLiM_Mutation_OnePlusSel;	// a cached value for (1 + selection_coeff_), clamped to 0.0 minimum
+extern slim_selcoeff_t *gSLiM_Mutation_OnePlusDomSel;	// a cached value for (1 + dominance_coeff * selection_coeff_), clamped to 0.0 minimum
+
 void SLiM_CreateMutationBlock(void);
 void SLiM_IncreaseMutationBlockCapacity(void);
 void SLiM_ZeroRefcountBlock(MutationRun &p_mutation_registry);
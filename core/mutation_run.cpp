@@ -614,15 +614,16 @@ void MutationRun::clear_set_and_merge(MutationRun &p_mutations_to_set, MutationR
 	
 	// then interleave mutations together, effectively setting p_mutations_to_set and then adding in p_mutations_to_add
 	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+	const slim_position_t *mut_positions = gSLiM_Mutation_Positions;
 	const MutationIndex *mutation_iter		= p_mutations_to_add.begin_pointer_const();
 	const MutationIndex *mutation_iter_max	= p_mutations_to_add.end_pointer_const();
 	MutationIndex mutation_iter_mutation_index = *mutation_iter;
-	slim_position_t mutation_iter_pos = (mut_block_ptr + mutation_iter_mutation_index)->position_;
+	slim_position_t mutation_iter_pos = mut_positions[mutation_iter_mutation_index];
 	
 	const MutationIndex *parent_iter		= p_mutations_to_set.begin_pointer_const();
 	const MutationIndex *parent_iter_max	= p_mutations_to_set.end_pointer_const();
 	MutationIndex parent_iter_mutation_index = *parent_iter;
-	slim_position_t parent_iter_pos = (mut_block_ptr + parent_iter_mutation_index)->position_;
+	slim_position_t parent_iter_pos = mut_positions[parent_iter_mutation_index];
 	
 	// this loop runs while we are still interleaving mutations from both sources
 	do
@@ -637,7 +638,7 @@ void MutationRun::clear_set_and_merge(MutationRun &p_mutations_to_set, MutationR
 				break;
 			
 			parent_iter_mutation_index = *parent_iter;
-			parent_iter_pos = (mut_block_ptr + parent_iter_mutation_index)->position_;
+			parent_iter_pos = mut_positions[parent_iter_mutation_index];
 		}
 		else
 		{
@@ -650,7 +651,7 @@ void MutationRun::clear_set_and_merge(MutationRun &p_mutations_to_set, MutationR
 				break;
 			
 			mutation_iter_mutation_index = *mutation_iter;
-			mutation_iter_pos = (mut_block_ptr + mutation_iter_mutation_index)->position_;
+			mutation_iter_pos = mut_positions[mutation_iter_mutation_index];
 		}
 	}
 	while (true);
@@ -665,7 +666,7 @@ void MutationRun::clear_set_and_merge(MutationRun &p_mutations_to_set, MutationR
 	while (mutation_iter != mutation_iter_max)
 	{
 		mutation_iter_mutation_index = *mutation_iter;
-		mutation_iter_pos = (mut_block_ptr + mutation_iter_mutation_index)->position_;
+		mutation_iter_pos = mut_positions[mutation_iter_mutation_index];
 		
 		if (enforce_stack_policy_for_addition(mutation_iter_pos, (mut_block_ptr + mutation_iter_mutation_index)->mutation_type_ptr_))
 			emplace_back(mutation_iter_mutation_index);
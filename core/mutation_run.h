@@ -382,13 +382,13 @@ public:
 		if (mutation_count_ == 1)
 			return;
 		
-		// then find the proper position for it
-		Mutation *mut_ptr_to_insert = gSLiM_Mutation_Block + p_mutation_index;
+		// then find the proper position for it, using the dense position buffer rather than the mutation block
+		const slim_position_t *mut_positions = gSLiM_Mutation_Positions;
 		MutationIndex *sort_position = begin_pointer();
 		const MutationIndex *end_position = end_pointer_const() - 1;		// the position of the newly added element
 		
 		for ( ; sort_position != end_position; ++sort_position)
-			if (CompareMutations(mut_ptr_to_insert, gSLiM_Mutation_Block + *sort_position))	// if (p_mutation->position_ < (*sort_position)->position_)
+			if (CompareMutationIndices(mut_positions, p_mutation_index, *sort_position))	// if (p_mutation->position_ < (*sort_position)->position_)
 				break;
 		
 		// if we got all the way to the end, then the mutation belongs at the end, so we're done
@@ -545,15 +545,6 @@ public:
 	}
 	
 	void _RemoveFixedMutations(void);
-	inline __attribute__((always_inline)) void RemoveFixedMutations(int64_t p_operation_id)
-	{
-		if (operation_id_ != p_operation_id)
-		{
-			operation_id_ = p_operation_id;
-			
-			_RemoveFixedMutations();
-		}
-	}
 	
 	// Hash and comparison functions used by UniqueMutationRuns() to unique mutation runs
 	inline __attribute__((always_inline)) int64_t Hash(void)
@@ -202,18 +202,22 @@ void MutationType::ParseDFEParameters(std::string &p_dfe_type_string, const Eido
 	}
 }
 
-double MutationType::DrawSelectionCoefficient(void) const
+double MutationType::DrawSelectionCoefficient(Eidos_RNG_State &p_rng) const
 {
 	switch (dfe_type_)
 	{
 		case DFEType::kFixed:			return dfe_parameters_[0];
-		case DFEType::kGamma:			return gsl_ran_gamma(EIDOS_GSL_RNG, dfe_parameters_[1], dfe_parameters_[0] / dfe_parameters_[1]);
-		case DFEType::kExponential:		return gsl_ran_exponential(EIDOS_GSL_RNG, dfe_parameters_[0]);
-		case DFEType::kNormal:			return gsl_ran_gaussian(EIDOS_GSL_RNG, dfe_parameters_[1]) + dfe_parameters_[0];
-		case DFEType::kWeibull:			return gsl_ran_weibull(EIDOS_GSL_RNG, dfe_parameters_[0], dfe_parameters_[1]);
+		case DFEType::kGamma:			return gsl_ran_gamma(p_rng.gsl_rng_, dfe_parameters_[1], dfe_parameters_[0] / dfe_parameters_[1]);
+		case DFEType::kExponential:		return gsl_ran_exponential(p_rng.gsl_rng_, dfe_parameters_[0]);
+		case DFEType::kNormal:			return gsl_ran_gaussian(p_rng.gsl_rng_, dfe_parameters_[1]) + dfe_parameters_[0];
+		case DFEType::kWeibull:			return gsl_ran_weibull(p_rng.gsl_rng_, dfe_parameters_[0], dfe_parameters_[1]);
 			
 		case DFEType::kScript:
 		{
+			// Script DFEs run Eidos code, which always draws from gEidos_RNG; they cannot use another stream
+			if (&p_rng != &gEidos_RNG)
+				EIDOS_TERMINATION << "ERROR (MutationType::DrawSelectionCoefficient): (internal error) type 's' DFEs can only draw from the main RNG stream." << EidosTerminate();
+			
 			// We have a script string that we need to execute, and it will return a float or integer to us.  This
 			// is basically a lambda call, so the code here is parallel to the executeLambda() code in many ways.
 			double sel_coeff;
@@ -329,6 +333,64 @@ double MutationType::DrawSelectionCoefficient(void) const
 	EIDOS_TERMINATION << "ERROR (MutationType::DrawSelectionCoefficient): (internal error) unexpected dfe_type_ value." << EidosTerminate();
 }
 
+// Draw many selection coefficients at once; the result is identical to p_count successive calls to DrawSelectionCoefficient(), but the
+// switch on the DFE type, and the fetching of the DFE parameters, is done once rather than per draw.  Script DFEs just loop.
+void MutationType::DrawSelectionCoefficients(Eidos_RNG_State &p_rng, size_t p_count, double *p_coefficients) const
+{
+	gsl_rng *rng = p_rng.gsl_rng_;
+	
+	switch (dfe_type_)
+	{
+		case DFEType::kFixed:
+		{
+			double fixed_coeff = dfe_parameters_[0];
+			
+			for (size_t draw_index = 0; draw_index < p_count; ++draw_index)
+				p_coefficients[draw_index] = fixed_coeff;
+			return;
+		}
+		case DFEType::kGamma:
+		{
+			double shape = dfe_parameters_[1], scale = dfe_parameters_[0] / dfe_parameters_[1];
+			
+			for (size_t draw_index = 0; draw_index < p_count; ++draw_index)
+				p_coefficients[draw_index] = gsl_ran_gamma(rng, shape, scale);
+			return;
+		}
+		case DFEType::kExponential:
+		{
+			double mean = dfe_parameters_[0];
+			
+			for (size_t draw_index = 0; draw_index < p_count; ++draw_index)
+				p_coefficients[draw_index] = gsl_ran_exponential(rng, mean);
+			return;
+		}
+		case DFEType::kNormal:
+		{
+			double mean = dfe_parameters_[0], sd = dfe_parameters_[1];
+			
+			for (size_t draw_index = 0; draw_index < p_count; ++draw_index)
+				p_coefficients[draw_index] = gsl_ran_gaussian(rng, sd) + mean;
+			return;
+		}
+		case DFEType::kWeibull:
+		{
+			double lambda = dfe_parameters_[0], k = dfe_parameters_[1];
+			
+			for (size_t draw_index = 0; draw_index < p_count; ++draw_index)
+				p_coefficients[draw_index] = gsl_ran_weibull(rng, lambda, k);
+			return;
+		}
+		case DFEType::kScript:
+		{
+			for (size_t draw_index = 0; draw_index < p_count; ++draw_index)
+				p_coefficients[draw_index] = DrawSelectionCoefficient(p_rng);
+			return;
+		}
+	}
+	EIDOS_TERMINATION << "ERROR (MutationType::DrawSelectionCoefficients): (internal error) unexpected dfe_type_ value." << EidosTerminate();
+}
+
 // This is unused except by debugging code and in the debugger itself
 std::ostream &operator<<(std::ostream &p_outstream, const MutationType &p_mutation_type)
 {
@@ -684,8 +746,7 @@ EidosValue_SP MutationType::ExecuteMethod_drawSelectionCoefficient(EidosGlobalSt
 		EidosValue_Float_vector *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector())->resize_no_initialize(num_draws);
 		result_SP = EidosValue_SP(float_result);
 		
-		for (int64_t draw_index = 0; draw_index < num_draws; ++draw_index)
-			float_result->set_float_no_check(DrawSelectionCoefficient(), draw_index);
+		DrawSelectionCoefficients(gEidos_RNG, (size_t)num_draws, float_result->data());
 	}
 	
 	return result_SP;
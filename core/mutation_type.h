@@ -39,6 +39,7 @@
 #include "eidos_value.h"
 #include "eidos_symbol_table.h"
 #include "slim_globals.h"
+#include "eidos_rng.h"
 #include "slim_eidos_dictionary.h"
 
 class SLiMSim;
@@ -168,7 +169,9 @@ public:
 	static void ParseDFEParameters(std::string &p_dfe_type_string, const EidosValue_SP *const p_arguments, int p_argument_count,
 								   DFEType *p_dfe_type, std::vector<double> *p_dfe_parameters, std::vector<std::string> *p_dfe_strings);
 	
-	double DrawSelectionCoefficient(void) const;					// draw a selection coefficient from this mutation type's DFE
+	double DrawSelectionCoefficient(Eidos_RNG_State &p_rng) const;	// draw a selection coefficient from this mutation type's DFE, using p_rng
+	inline double DrawSelectionCoefficient(void) const { return DrawSelectionCoefficient(gEidos_RNG); }
+	void DrawSelectionCoefficients(Eidos_RNG_State &p_rng, size_t p_count, double *p_coefficients) const;	// p_count draws, as by successive calls above
 	
 	//
 	// Eidos support
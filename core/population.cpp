@@ -223,9 +223,29 @@ Subpopulation *Population::AddSubpopulationSplit(slim_objectid_t p_subpop_id, Su
 		sim_.AboutToSplitSubpop();
 	}
 	
+	// draw all of the migrants from p_source_subpop up front, using the batched draw methods; this consumes the RNG in exactly the
+	// same order as drawing them one at a time in the loop below would (females first, then males), since nothing else in the
+	// loop uses the RNG
+	std::vector<slim_popsize_t> migrant_indices(subpop.parent_subpop_size_);
+	
+	if (subpop.parent_subpop_size_ > 0)
+	{
+		if (sim_.SexEnabled())
+		{
+			slim_popsize_t female_count = subpop.parent_first_male_index_;
+			
+			p_source_subpop.DrawFemaleParentsUsingFitness(gEidos_RNG, female_count, migrant_indices.data());
+			p_source_subpop.DrawMaleParentsUsingFitness(gEidos_RNG, subpop.parent_subpop_size_ - female_count, migrant_indices.data() + female_count);
+		}
+		else
+		{
+			p_source_subpop.DrawParentsUsingFitness(gEidos_RNG, subpop.parent_subpop_size_, migrant_indices.data());
+		}
+	}
+	
 	for (slim_popsize_t parent_index = 0; parent_index < subpop.parent_subpop_size_; parent_index++)
 	{
-		// draw individual from p_source_subpop and assign to be a parent in subpop
+		// assign each drawn individual from p_source_subpop to be a parent in subpop
 		// BCH 4/25/2018: we have to tree-seq record the new individuals and genomes here, with the correct parent information
 		// Peter observes that biologically, it might make sense for each new genome in the split subpop to actually be a
 		// clone of the original genome in the sense that it has the same parent as the original genomes, with the same
@@ -233,20 +253,7 @@ Subpopulation *Population::AddSubpopulationSplit(slim_objectid_t p_subpop_id, Su
 		// might have been simplified away already, and that script could have modified the original, and so forth.  Having
 		// the new genome just inherit exactly from the original seems reasonable enough; for practical purposes it shouldn't
 		// matter.
-		slim_popsize_t migrant_index;
-		
-		if (sim_.SexEnabled())
-		{
-			if (parent_index < subpop.parent_first_male_index_)
-				migrant_index = p_source_subpop.DrawFemaleParentUsingFitness();
-			else
-				migrant_index = p_source_subpop.DrawMaleParentUsingFitness();
-		}
-		else
-		{
-			migrant_index = p_source_subpop.DrawParentUsingFitness();
-		}
-		
+		slim_popsize_t migrant_index = migrant_indices[parent_index];
 		Genome *source_genome1 = p_source_subpop.parent_genomes_[2 * migrant_index];
 		Genome *source_genome2 = p_source_subpop.parent_genomes_[2 * migrant_index + 1];
 		
@@ -1707,6 +1714,28 @@ void Population::EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice
 		// some setup overhead, including the gsl_ran_shuffle() call.  All code that accesses individuals within a subpopulation needs to be aware of
 		// the fact that the individuals might be in a non-random order, because of this code path.  BEWARE!
 		
+		// If multithreading has been enabled, we make all of the random draws for each gamete here, in exactly the order that
+		// DoCrossoverMutation() / DoClonalMutation() would make them, and then assemble the planned gametes in parallel at the end;
+		// see AssembleGametePlans().  The result is identical to the single-threaded result.  Tree-sequence recording and complex
+		// gene conversion tracts (heteroduplex repair) are not supported by that scheme, so they force single-threaded execution.
+		bool plan_gametes = false;
+		
+#ifdef _OPENMP
+		if (gEidosMaxThreads > 1)
+		{
+			Chromosome &chromosome = sim_.TheChromosome();
+			
+			plan_gametes = (!recording_tree_sequence && !(chromosome.using_DSB_model_ && (chromosome.simple_conversion_fraction_ != 1.0)));
+		}
+#endif
+		
+		if (plan_gametes)
+		{
+			gamete_plans_.clear();
+			gamete_plan_breakpoints_.clear();
+			gamete_plan_mutations_.clear();
+		}
+		
 		// We loop to generate females first (sex_index == 0) and males second (sex_index == 1).
 		// In nonsexual simulations number_of_sexes == 1 and this loops just once.
 		slim_popsize_t child_count = 0;	// counter over all subpop_size_ children
@@ -1789,8 +1818,16 @@ void Population::EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice
 									sim_.SetCurrentNewIndividual(new_child);
 								
 								// recombination, gene-conversion, mutation
-								DoCrossoverMutation(&source_subpop, *p_subpop.child_genomes_[2 * child_count], parent1, child_sex, IndividualSex::kFemale, nullptr, nullptr);
-								DoCrossoverMutation(&source_subpop, *p_subpop.child_genomes_[2 * child_count + 1], parent2, child_sex, IndividualSex::kMale, nullptr, nullptr);
+								if (plan_gametes)
+								{
+									PlanCrossoverMutation(&source_subpop, *p_subpop.child_genomes_[2 * child_count], parent1, child_sex, IndividualSex::kFemale);
+									PlanCrossoverMutation(&source_subpop, *p_subpop.child_genomes_[2 * child_count + 1], parent2, child_sex, IndividualSex::kMale);
+								}
+								else
+								{
+									DoCrossoverMutation(&source_subpop, *p_subpop.child_genomes_[2 * child_count], parent1, child_sex, IndividualSex::kFemale, nullptr, nullptr);
+									DoCrossoverMutation(&source_subpop, *p_subpop.child_genomes_[2 * child_count + 1], parent2, child_sex, IndividualSex::kMale, nullptr, nullptr);
+								}
 								
 								migrant_count++;
 								child_count++;
@@ -1818,8 +1855,16 @@ void Population::EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice
 									sim_.SetCurrentNewIndividual(new_child);
 								
 								// recombination, gene-conversion, mutation
-								DoCrossoverMutation(&source_subpop, *p_subpop.child_genomes_[2 * child_count], parent1, child_sex, IndividualSex::kHermaphrodite, nullptr, nullptr);
-								DoCrossoverMutation(&source_subpop, *p_subpop.child_genomes_[2 * child_count + 1], parent2, child_sex, IndividualSex::kHermaphrodite, nullptr, nullptr);
+								if (plan_gametes)
+								{
+									PlanCrossoverMutation(&source_subpop, *p_subpop.child_genomes_[2 * child_count], parent1, child_sex, IndividualSex::kHermaphrodite);
+									PlanCrossoverMutation(&source_subpop, *p_subpop.child_genomes_[2 * child_count + 1], parent2, child_sex, IndividualSex::kHermaphrodite);
+								}
+								else
+								{
+									DoCrossoverMutation(&source_subpop, *p_subpop.child_genomes_[2 * child_count], parent1, child_sex, IndividualSex::kHermaphrodite, nullptr, nullptr);
+									DoCrossoverMutation(&source_subpop, *p_subpop.child_genomes_[2 * child_count + 1], parent2, child_sex, IndividualSex::kHermaphrodite, nullptr, nullptr);
+								}
 								
 								migrant_count++;
 								child_count++;
@@ -1864,8 +1909,16 @@ void Population::EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice
 									sim_.RecordNewGenome(nullptr, &child_genome_2, &parent_genome_2, nullptr);
 								}
 								
-								DoClonalMutation(&source_subpop, child_genome_1, parent_genome_1, child_sex, nullptr);
-								DoClonalMutation(&source_subpop, child_genome_2, parent_genome_2, child_sex, nullptr);
+								if (plan_gametes)
+								{
+									PlanClonalMutation(&source_subpop, child_genome_1, parent_genome_1, child_sex);
+									PlanClonalMutation(&source_subpop, child_genome_2, parent_genome_2, child_sex);
+								}
+								else
+								{
+									DoClonalMutation(&source_subpop, child_genome_1, parent_genome_1, child_sex, nullptr);
+									DoClonalMutation(&source_subpop, child_genome_2, parent_genome_2, child_sex, nullptr);
+								}
 							}
 							else
 							{
@@ -1916,8 +1969,16 @@ void Population::EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice
 									sim_.SetCurrentNewIndividual(new_child);
 								
 								// recombination, gene-conversion, mutation
-								DoCrossoverMutation(&source_subpop, *p_subpop.child_genomes_[2 * child_count], parent1, child_sex, parent1_sex, nullptr, nullptr);
-								DoCrossoverMutation(&source_subpop, *p_subpop.child_genomes_[2 * child_count + 1], parent2, child_sex, parent2_sex, nullptr, nullptr);
+								if (plan_gametes)
+								{
+									PlanCrossoverMutation(&source_subpop, *p_subpop.child_genomes_[2 * child_count], parent1, child_sex, parent1_sex);
+									PlanCrossoverMutation(&source_subpop, *p_subpop.child_genomes_[2 * child_count + 1], parent2, child_sex, parent2_sex);
+								}
+								else
+								{
+									DoCrossoverMutation(&source_subpop, *p_subpop.child_genomes_[2 * child_count], parent1, child_sex, parent1_sex, nullptr, nullptr);
+									DoCrossoverMutation(&source_subpop, *p_subpop.child_genomes_[2 * child_count + 1], parent2, child_sex, parent2_sex, nullptr, nullptr);
+								}
 							}
 							
 							// change counters
@@ -1928,7 +1989,458 @@ void Population::EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice
 				}
 			}
 		}
+		
+		// assemble the planned gametes, if we are generating offspring with multiple threads
+		if (plan_gametes)
+			AssembleGametePlans();
+	}
+}
+
+// Sort one gamete's new mutations by position, keeping mutations at the same position in the order they were drawn, as successive
+// insert_sorted_mutation() calls would; a simple insertion sort, since few mutations per gamete are expected
+static void _SortGametePlanMutations(MutationIndex *p_begin, MutationIndex *p_end)
+{
+	if (p_end - p_begin < 2)
+		return;
+	
+	const slim_position_t *mut_positions = gSLiM_Mutation_Positions;
+	
+	for (MutationIndex *insert_iter = p_begin + 1; insert_iter < p_end; ++insert_iter)
+	{
+		MutationIndex new_mutation = *insert_iter;
+		slim_position_t new_position = mut_positions[new_mutation];
+		MutationIndex *sort_iter = insert_iter;
+		
+		while ((sort_iter > p_begin) && (mut_positions[*(sort_iter - 1)] > new_position))
+		{
+			*sort_iter = *(sort_iter - 1);
+			--sort_iter;
+		}
+		
+		*sort_iter = new_mutation;
+	}
+}
+
+// Plan a gamete for AssembleGametePlans(), making all the random draws that DoCrossoverMutation() would make for it, in the same
+// order, but without building the child genome.  This handles only the case without callbacks, and it does not handle tree-sequence
+// recording or heteroduplex repair; EvolveSubpopulation() checks for those cases.  BEWARE: the logic here needs to be kept in sync
+// with DoCrossoverMutation(), since the whole point is that the outcome is identical.
+void Population::PlanCrossoverMutation(Subpopulation *p_source_subpop, Genome &p_child_genome, slim_popsize_t p_parent_index, IndividualSex p_child_sex, IndividualSex p_parent_sex)
+{
+	bool use_only_strand_1 = false;
+	bool do_swap = true;
+	
+	GenomeType child_genome_type = p_child_genome.Type();
+	Genome *parent_genome_1 = p_source_subpop->parent_genomes_[p_parent_index * 2];
+	GenomeType parent1_genome_type = parent_genome_1->Type();
+	Genome *parent_genome_2 = p_source_subpop->parent_genomes_[p_parent_index * 2 + 1];
+	GenomeType parent2_genome_type = parent_genome_2->Type();
+	
+	// figure out which strand(s) we are allowed to use; see DoCrossoverMutation() for comments on all of these cases
+	if (child_genome_type != GenomeType::kAutosome)
+	{
+		if (child_genome_type == GenomeType::kXChromosome)
+		{
+			if (p_child_sex == IndividualSex::kMale)
+			{
+				if (parent1_genome_type == GenomeType::kYChromosome || parent2_genome_type == GenomeType::kYChromosome)
+					EIDOS_TERMINATION << "ERROR (Population::PlanCrossoverMutation): Mismatch between parent and child genome types (case 3)." << EidosTerminate();
+			}
+			else if (p_child_sex == IndividualSex::kFemale)
+			{
+				if (parent1_genome_type == GenomeType::kYChromosome && parent2_genome_type == GenomeType::kXChromosome)
+				{
+					use_only_strand_1 = true; do_swap = true;	// use strand 2
+				}
+				else if (parent1_genome_type == GenomeType::kXChromosome && parent2_genome_type == GenomeType::kYChromosome)
+				{
+					use_only_strand_1 = true; do_swap = false;	// use strand 1
+				}
+			}
+		}
+		else
+		{
+			if (p_child_sex == IndividualSex::kFemale)
+				EIDOS_TERMINATION << "ERROR (Population::PlanCrossoverMutation): A female child is requested but the child genome is a Y chromosome." << EidosTerminate();
+			
+			if (parent1_genome_type == GenomeType::kYChromosome && parent2_genome_type == GenomeType::kXChromosome)
+			{
+				use_only_strand_1 = true; do_swap = false;	// use strand 1
+			}
+			else if (parent1_genome_type == GenomeType::kXChromosome && parent2_genome_type == GenomeType::kYChromosome)
+			{
+				use_only_strand_1 = true; do_swap = true;	// use strand 2
+			}
+			else
+			{
+				EIDOS_TERMINATION << "ERROR (Population::PlanCrossoverMutation): Mismatch between parent and child genome types (case 4)." << EidosTerminate();
+			}
+		}
+	}
+	
+	// swap strands in half of cases to assure random assortment (or in all cases, if use_only_strand_1 == true)
+	if (do_swap && (use_only_strand_1 || Eidos_RandomBool()))
+		std::swap(parent_genome_1, parent_genome_2);
+	
+	// a null strand cannot cross over and cannot mutate, so we are done
+	if (p_child_genome.IsNull())
+		return;
+	
+	// determine how many mutations and breakpoints we have, and draw the breakpoints; crossover breakpoints are drawn directly
+	// into our breakpoint arena, gamete_plan_breakpoints_, so that they are ready for AssembleGametePlans() without any copying
+	Chromosome &chromosome = sim_.TheChromosome();
+	int num_mutations, num_breakpoints;
+	static std::vector<slim_position_t> all_breakpoints;	// avoid buffer reallocs, etc.; used only as needed, see below
+	size_t breakpoints_start = gamete_plan_breakpoints_.size();
+	
+	all_breakpoints.clear();
+	
+	if (use_only_strand_1)
+	{
+		num_breakpoints = 0;
+		num_mutations = chromosome.DrawMutationCount(p_parent_sex);
+	}
+	else
+	{
+#ifdef USE_GSL_POISSON
+		num_mutations = chromosome.DrawMutationCount(p_parent_sex);
+		num_breakpoints = chromosome.DrawBreakpointCount(p_parent_sex);
+#else
+		chromosome.DrawMutationAndBreakpointCounts(p_parent_sex, &num_mutations, &num_breakpoints);
+#endif
+		
+		if (num_breakpoints)
+		{
+			if (chromosome.using_DSB_model_)
+			{
+				std::vector<slim_position_t> heteroduplex;		// always left empty, since complex gene conversion is not planned
+				
+				chromosome.DrawDSBBreakpoints(p_parent_sex, num_breakpoints, all_breakpoints, heteroduplex);
+				gamete_plan_breakpoints_.insert(gamete_plan_breakpoints_.end(), all_breakpoints.begin(), all_breakpoints.end());
+			}
+			else
+			{
+				chromosome.DrawCrossoverBreakpoints(p_parent_sex, num_breakpoints, gamete_plan_breakpoints_);
+			}
+			
+			gamete_plan_breakpoints_.emplace_back(chromosome.last_position_mutrun_ + 10);
+		}
+	}
+	
+	// with no mutations and no crossovers the child genome is just a copy of the parental genome; no need to make a plan
+	if ((num_mutations == 0) && (num_breakpoints == 0))
+	{
+		p_child_genome.copy_from_genome(*parent_genome_1);
+		return;
+	}
+	
+	// record the plan, with breakpoints and new mutations in our flat buffers
+	GametePlan plan;
+	
+	plan.child_genome_ = &p_child_genome;
+	plan.parent_genome_1_ = parent_genome_1;
+	plan.parent_genome_2_ = (num_breakpoints ? parent_genome_2 : nullptr);	// the second strand is not touched, and might be null
+	plan.breakpoints_start_ = (int64_t)breakpoints_start;
+	plan.breakpoints_count_ = (int32_t)(gamete_plan_breakpoints_.size() - breakpoints_start);
+	plan.mutations_start_ = (int64_t)gamete_plan_mutations_.size();
+	
+	bool use_extended_draw_mutation = sim_.IsNucleotideBased();
+	
+	// DrawNewMutationExtended() wants the breakpoints in a vector of their own, including the end sentinel
+	if (use_extended_draw_mutation && num_mutations)
+		all_breakpoints.assign(gamete_plan_breakpoints_.begin() + breakpoints_start, gamete_plan_breakpoints_.end());
+	
+	// draw the new mutations into our mutation arena, gamete_plan_mutations_, and then sort this gamete's slice of it
+	if (use_extended_draw_mutation)
+	{
+		for (int k = 0; k < num_mutations; k++)
+		{
+			MutationIndex new_mutation = chromosome.DrawNewMutationExtended(p_parent_sex, p_source_subpop->subpopulation_id_, sim_.Generation(), parent_genome_1, parent_genome_2, &all_breakpoints, nullptr);
+			
+			if (new_mutation != -1)
+				gamete_plan_mutations_.emplace_back(new_mutation);
+		}
+	}
+	else if (num_mutations)
+	{
+		gamete_plan_mutations_.resize(plan.mutations_start_ + num_mutations);
+		chromosome.DrawNewMutations(p_parent_sex, p_source_subpop->subpopulation_id_, sim_.Generation(), num_mutations, gamete_plan_mutations_.data() + plan.mutations_start_);
+	}
+	
+	_SortGametePlanMutations(gamete_plan_mutations_.data() + plan.mutations_start_, gamete_plan_mutations_.data() + gamete_plan_mutations_.size());
+	
+	plan.mutations_count_ = (int32_t)(gamete_plan_mutations_.size() - plan.mutations_start_);
+	
+	// if no new mutation could be drawn (possible in nucleotide-based models) and there are no crossovers, just copy
+	if ((plan.mutations_count_ == 0) && (plan.breakpoints_count_ == 0))
+	{
+		p_child_genome.copy_from_genome(*parent_genome_1);
+		return;
+	}
+	
+	gamete_plans_.emplace_back(plan);
+}
+
+// Plan a clonal gamete for AssembleGametePlans(), making the random draws that DoClonalMutation() would make for it.  As above,
+// this needs to be kept in sync with DoClonalMutation().
+void Population::PlanClonalMutation(Subpopulation *p_mutorigin_subpop, Genome &p_child_genome, Genome &p_parent_genome, IndividualSex p_child_sex)
+{
+	if (p_child_genome.Type() != p_parent_genome.Type())
+		EIDOS_TERMINATION << "ERROR (Population::PlanClonalMutation): Mismatch between parent and child genome types (type != type)." << EidosTerminate();
+	
+	bool child_genome_null = p_child_genome.IsNull();
+	
+	if (child_genome_null != p_parent_genome.IsNull())
+		EIDOS_TERMINATION << "ERROR (Population::PlanClonalMutation): Mismatch between parent and child genome types (null != null)." << EidosTerminate();
+	
+	// a null strand cannot mutate, so we are done
+	if (child_genome_null)
+		return;
+	
+	Chromosome &chromosome = sim_.TheChromosome();
+	int num_mutations = chromosome.DrawMutationCount(p_child_sex);	// the parent sex is the same as the child sex
+	
+	// with no mutations the child genome is just a copy of the parental genome; no need to make a plan
+	if (num_mutations == 0)
+	{
+		p_child_genome.copy_from_genome(p_parent_genome);
+		return;
+	}
+	
+	GametePlan plan;
+	
+	plan.child_genome_ = &p_child_genome;
+	plan.parent_genome_1_ = &p_parent_genome;
+	plan.parent_genome_2_ = nullptr;
+	plan.breakpoints_start_ = (int64_t)gamete_plan_breakpoints_.size();
+	plan.breakpoints_count_ = 0;
+	plan.mutations_start_ = (int64_t)gamete_plan_mutations_.size();
+	
+	bool use_extended_draw_mutation = sim_.IsNucleotideBased();
+	
+	// draw the new mutations into our mutation arena and sort this gamete's slice of it; see PlanCrossoverMutation()
+	if (use_extended_draw_mutation)
+	{
+		for (int k = 0; k < num_mutations; k++)
+		{
+			MutationIndex new_mutation = chromosome.DrawNewMutationExtended(p_child_sex, p_mutorigin_subpop->subpopulation_id_, sim_.Generation(), &p_parent_genome, nullptr, nullptr, nullptr);
+			
+			if (new_mutation != -1)
+				gamete_plan_mutations_.emplace_back(new_mutation);
+		}
+	}
+	else if (num_mutations)
+	{
+		gamete_plan_mutations_.resize(plan.mutations_start_ + num_mutations);
+		chromosome.DrawNewMutations(p_child_sex, p_mutorigin_subpop->subpopulation_id_, sim_.Generation(), num_mutations, gamete_plan_mutations_.data() + plan.mutations_start_);
+	}
+	
+	_SortGametePlanMutations(gamete_plan_mutations_.data() + plan.mutations_start_, gamete_plan_mutations_.data() + gamete_plan_mutations_.size());
+	
+	plan.mutations_count_ = (int32_t)(gamete_plan_mutations_.size() - plan.mutations_start_);
+	
+	if (plan.mutations_count_ == 0)
+	{
+		p_child_genome.copy_from_genome(p_parent_genome);
+		return;
+	}
+	
+	gamete_plans_.emplace_back(plan);
+}
+
+// Assemble all of the gametes planned by PlanCrossoverMutation() and PlanClonalMutation(), in parallel.  Each child genome is
+// built by walking its mutation runs: a run that contains no breakpoint and no new mutation is shared with the parental strand
+// that is active there, while other runs are built fresh by merging the parental strand(s) with the new mutations, exactly as
+// DoCrossoverMutation() does it.  The worker threads do not touch any shared state except the MutationRun free list (which is
+// accessed in a critical section, in batches) and gamete_plan_mutation_added_ (each element of which belongs to one gamete).
+// In particular, they do not touch MutationRun refcounts (shared runs are stored without retaining them), and they do not touch
+// the mutation registry; both are fixed up afterwards in a single-threaded pass, in plan order, so that the registry is built
+// in the same order as it would be without multithreading.
+void Population::AssembleGametePlans(void)
+{
+	int64_t plan_count = (int64_t)gamete_plans_.size();
+	
+	if (plan_count == 0)
+		return;
+	
+	gamete_plan_mutation_added_.resize(gamete_plan_mutations_.size());
+	
+	Mutation *mut_block_ptr = gSLiM_Mutation_Block;		// no new mutations are created below, so the block cannot move
+	const slim_position_t *mut_positions = gSLiM_Mutation_Positions;
+	GametePlan *plans = gamete_plans_.data();
+	const slim_position_t *all_breakpoints = gamete_plan_breakpoints_.data();
+	const MutationIndex *all_mutations = gamete_plan_mutations_.data();
+	uint8_t *all_mutations_added = gamete_plan_mutation_added_.data();
+	
+#pragma omp parallel num_threads(gEidosMaxThreads) default(none) shared(plan_count, mut_block_ptr, mut_positions, plans, all_breakpoints, all_mutations, all_mutations_added)
+	{
+		// each thread keeps a private stash of empty mutation runs, refilled from the shared free list in batches
+		std::vector<MutationRun *> run_stash;
+		
+#pragma omp for schedule(dynamic, 64)
+		for (int64_t plan_index = 0; plan_index < plan_count; ++plan_index)
+		{
+			GametePlan &plan = plans[plan_index];
+			Genome &child_genome = *plan.child_genome_;
+			Genome *parent_genome = plan.parent_genome_1_;			// the current copy strand
+			Genome *other_genome = plan.parent_genome_2_;			// the other strand; nullptr if there are no breakpoints
+			const slim_position_t *breakpoint_iter = all_breakpoints + plan.breakpoints_start_;
+			const slim_position_t *breakpoint_iter_max = breakpoint_iter + plan.breakpoints_count_;
+			const MutationIndex *mutation_iter = all_mutations + plan.mutations_start_;
+			const MutationIndex *mutation_iter_max = mutation_iter + plan.mutations_count_;
+			uint8_t *mutation_added_iter = all_mutations_added + plan.mutations_start_;
+			slim_position_t mutrun_length = child_genome.mutrun_length_;
+			int mutrun_count = child_genome.mutrun_count_;
+			
+			for (int run_index = 0; run_index < mutrun_count; ++run_index)
+			{
+				slim_position_t run_start = run_index * mutrun_length;
+				slim_position_t run_end = run_start + mutrun_length;
+				
+				// breakpoints at the start of a run just switch strands between runs
+				while ((breakpoint_iter != breakpoint_iter_max) && (*breakpoint_iter <= run_start))
+				{
+					std::swap(parent_genome, other_genome);
+					breakpoint_iter++;
+				}
+				
+				bool break_in_run = ((breakpoint_iter != breakpoint_iter_max) && (*breakpoint_iter < run_end));
+				bool mutation_in_run = ((mutation_iter != mutation_iter_max) && (mut_positions[*mutation_iter] < run_end));
+				
+				if (!break_in_run && !mutation_in_run)
+				{
+					// share the parental run; it is retained in the single-threaded pass below
+					child_genome.mutruns_[run_index].reset(parent_genome->mutruns_[run_index].get(), false);
+					continue;
+				}
+				
+				// get a new run from our stash, refilling the stash from the shared free list if needed
+				if (run_stash.size() == 0)
+				{
+#pragma omp critical (SLiM_MutationRunFreeList)
+					{
+						std::vector<MutationRun *> &free_list = MutationRun::s_freed_mutation_runs_;
+						size_t take_count = std::min(free_list.size(), (size_t)64);
+						
+						run_stash.insert(run_stash.end(), free_list.end() - take_count, free_list.end());
+						free_list.resize(free_list.size() - take_count);
+					}
+					
+					if (run_stash.size() == 0)
+						run_stash.emplace_back(new MutationRun());
+				}
+				
+				MutationRun *child_run = run_stash.back();
+				
+				run_stash.pop_back();
+				child_genome.mutruns_[run_index].reset(child_run, false);
+				
+				// merge the current strand with the new mutations, switching strands at each breakpoint within the run; parental
+				// mutations come before new mutations at the same position, as in DoCrossoverMutation()
+				const MutationIndex *parent_iter = parent_genome->mutruns_[run_index]->begin_pointer_const();
+				const MutationIndex *parent_iter_max = parent_genome->mutruns_[run_index]->end_pointer_const();
+				
+				while (true)
+				{
+					slim_position_t segment_end = ((breakpoint_iter != breakpoint_iter_max) && (*breakpoint_iter < run_end)) ? *breakpoint_iter : run_end;
+					
+					while (true)
+					{
+						slim_position_t parent_pos = (parent_iter != parent_iter_max) ? mut_positions[*parent_iter] : SLIM_INF_BASE_POSITION;
+						slim_position_t mutation_pos = (mutation_iter != mutation_iter_max) ? mut_positions[*mutation_iter] : SLIM_INF_BASE_POSITION;
+						
+						if ((parent_pos >= segment_end) && (mutation_pos >= segment_end))
+							break;
+						
+						if (parent_pos <= mutation_pos)
+						{
+							child_run->emplace_back(*(parent_iter++));
+						}
+						else
+						{
+							MutationIndex new_mutation = *(mutation_iter++);
+							
+							if (child_run->enforce_stack_policy_for_addition(mutation_pos, (mut_block_ptr + new_mutation)->mutation_type_ptr_))
+							{
+								child_run->emplace_back(new_mutation);
+								*(mutation_added_iter++) = 1;
+							}
+							else
+							{
+								*(mutation_added_iter++) = 0;
+							}
+						}
+					}
+					
+					if (segment_end == run_end)
+						break;
+					
+					// we have reached a breakpoint, so switch strands and skip over anything prior to the breakpoint in the new strand
+					slim_position_t breakpoint = *(breakpoint_iter++);
+					
+					std::swap(parent_genome, other_genome);
+					
+					parent_iter = parent_genome->mutruns_[run_index]->begin_pointer_const();
+					parent_iter_max = parent_genome->mutruns_[run_index]->end_pointer_const();
+					
+					while ((parent_iter != parent_iter_max) && (mut_positions[*parent_iter] < breakpoint))
+						parent_iter++;
+				}
+			}
+		}
+		
+		// return any unused runs to the shared free list; they are still in the clean state that FreeMutationRun() guarantees
+		if (run_stash.size())
+		{
+#pragma omp critical (SLiM_MutationRunFreeList)
+			{
+				std::vector<MutationRun *> &free_list = MutationRun::s_freed_mutation_runs_;
+				
+				free_list.insert(free_list.end(), run_stash.begin(), run_stash.end());
+			}
+		}
 	}
+	
+	// single-threaded pass: retain the child runs, and register (or dispose of) the new mutations, in plan order
+	for (int64_t plan_index = 0; plan_index < plan_count; ++plan_index)
+	{
+		GametePlan &plan = plans[plan_index];
+		Genome &child_genome = *plan.child_genome_;
+		int mutrun_count = child_genome.mutrun_count_;
+		
+		for (int run_index = 0; run_index < mutrun_count; ++run_index)
+			Eidos_intrusive_ptr_add_ref(child_genome.mutruns_[run_index].get());
+		
+		const MutationIndex *mutation_iter = all_mutations + plan.mutations_start_;
+		const MutationIndex *mutation_iter_max = mutation_iter + plan.mutations_count_;
+		const uint8_t *mutation_added_iter = all_mutations_added + plan.mutations_start_;
+		
+		for ( ; mutation_iter != mutation_iter_max; ++mutation_iter, ++mutation_added_iter)
+		{
+			MutationIndex new_mutation = *mutation_iter;
+			Mutation *new_mut = mut_block_ptr + new_mutation;
+			
+			if (*mutation_added_iter)
+			{
+				mutation_registry_.emplace_back(new_mutation);
+				
+#ifdef SLIM_KEEP_MUTTYPE_REGISTRIES
+				MutationType *new_mut_type = new_mut->mutation_type_ptr_;
+				
+				if (keeping_muttype_registries_ && new_mut_type->keeping_muttype_registry_)
+					new_mut_type->muttype_registry_.emplace_back(new_mutation);
+#endif
+			}
+			else
+			{
+				// The mutation was rejected by the stacking policy, so we have to dispose of it
+				new_mut->~Mutation();
+				SLiM_DisposeMutationToBlock(new_mutation);
+			}
+		}
+	}
+	
+	gamete_plans_.clear();
 }
 #endif	// SLIM_WF_ONLY
 
@@ -2355,7 +2867,7 @@ void Population::DoCrossoverMutation(Subpopulation *p_source_subpop, Genome &p_c
 			p_child_genome.check_cleared_to_nullptr();
 #endif
 			
-			Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+			const slim_position_t *mut_positions = gSLiM_Mutation_Positions;
 			Genome *parent_genome = parent_genome_1;
 			slim_position_t mutrun_length = p_child_genome.mutrun_length_;
 			int mutrun_count = p_child_genome.mutrun_count_;
@@ -2401,7 +2913,7 @@ void Population::DoCrossoverMutation(Subpopulation *p_source_subpop, Genome &p_c
 						{
 							MutationIndex current_mutation = *parent_iter;
 							
-							if ((mut_block_ptr + current_mutation)->position_ >= breakpoint)
+							if (mut_positions[current_mutation] >= breakpoint)
 								break;
 							
 							// add the old mutation; no need to check for a duplicate here since the parental genome is already duplicate-free
@@ -2416,7 +2928,7 @@ void Population::DoCrossoverMutation(Subpopulation *p_source_subpop, Genome &p_c
 						parent_iter = parent1_iter;		parent_iter_max = parent1_iter_max;		parent_genome = parent_genome_1;
 						
 						// skip over anything in the new parent that occurs prior to the breakpoint; it was not the active strand
-						while (parent_iter != parent_iter_max && (mut_block_ptr + *parent_iter)->position_ < breakpoint)
+						while (parent_iter != parent_iter_max && mut_positions[*parent_iter] < breakpoint)
 							parent_iter++;
 						
 						// we have now handled the current breakpoint, so move on to the next breakpoint; advance the enclosing for loop here
@@ -2500,11 +3012,14 @@ void Population::DoCrossoverMutation(Subpopulation *p_source_subpop, Genome &p_c
 			}
 			else
 			{
-				// In non-nucleotide-based models, chromosome.DrawNewMutation() will return new mutations to us with nucleotide_ == -1
-				for (int k = 0; k < num_mutations; k++)
+				// In non-nucleotide-based models, chromosome.DrawNewMutations() will return new mutations to us with nucleotide_ == -1
+				static std::vector<MutationIndex> new_mutations;	// avoid buffer reallocs, etc.
+				
+				new_mutations.resize(num_mutations);
+				chromosome.DrawNewMutations(p_parent_sex, p_source_subpop->subpopulation_id_, sim_.Generation(), num_mutations, new_mutations.data());
+				
+				for (MutationIndex new_mutation : new_mutations)
 				{
-					MutationIndex new_mutation = chromosome.DrawNewMutation(p_parent_sex, p_source_subpop->subpopulation_id_, sim_.Generation());
-					
 					mutations_to_add.insert_sorted_mutation(new_mutation);	// keeps it sorted; since few mutations are expected, this is fast
 					
 					// no need to worry about pure_neutral_ or all_pure_neutral_DFE_ here; the mutation is drawn from a registered genomic element type
@@ -2519,6 +3034,7 @@ void Population::DoCrossoverMutation(Subpopulation *p_source_subpop, Genome &p_c
 		}
 		
 		Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+		const slim_position_t *mut_positions = gSLiM_Mutation_Positions;
 		const MutationIndex *mutation_iter		= mutations_to_add.begin_pointer_const();
 		const MutationIndex *mutation_iter_max	= mutations_to_add.end_pointer_const();
 		
@@ -2527,7 +3043,7 @@ void Population::DoCrossoverMutation(Subpopulation *p_source_subpop, Genome &p_c
 		
 		if (mutation_iter != mutation_iter_max) {
 			mutation_iter_mutation_index = *mutation_iter;
-			mutation_iter_pos = (mut_block_ptr + mutation_iter_mutation_index)->position_;
+			mutation_iter_pos = mut_positions[mutation_iter_mutation_index];
 		} else {
 			mutation_iter_mutation_index = -1;
 			mutation_iter_pos = SLIM_INF_BASE_POSITION;
@@ -2572,7 +3088,7 @@ void Population::DoCrossoverMutation(Subpopulation *p_source_subpop, Genome &p_c
 					while (parent_iter != parent_iter_max)
 					{
 						MutationIndex current_mutation = *parent_iter;
-						slim_position_t current_mutation_pos = (mut_block_ptr + current_mutation)->position_;
+						slim_position_t current_mutation_pos = mut_positions[current_mutation];
 						
 						if (current_mutation_pos > mutation_iter_pos)
 							break;
@@ -2610,7 +3126,7 @@ void Population::DoCrossoverMutation(Subpopulation *p_source_subpop, Genome &p_c
 					
 					if (++mutation_iter != mutation_iter_max) {
 						mutation_iter_mutation_index = *mutation_iter;
-						mutation_iter_pos = (mut_block_ptr + mutation_iter_mutation_index)->position_;
+						mutation_iter_pos = mut_positions[mutation_iter_mutation_index];
 					} else {
 						mutation_iter_mutation_index = -1;
 						mutation_iter_pos = SLIM_INF_BASE_POSITION;
@@ -2721,7 +3237,7 @@ void Population::DoCrossoverMutation(Subpopulation *p_source_subpop, Genome &p_c
 							while (parent_iter != parent_iter_max)
 							{
 								MutationIndex current_mutation = *parent_iter;
-								slim_position_t current_mutation_pos = (mut_block_ptr + current_mutation)->position_;
+								slim_position_t current_mutation_pos = mut_positions[current_mutation];
 								
 								if (current_mutation_pos >= breakpoint)
 									break;
@@ -2757,7 +3273,7 @@ void Population::DoCrossoverMutation(Subpopulation *p_source_subpop, Genome &p_c
 									
 									if (++mutation_iter != mutation_iter_max) {
 										mutation_iter_mutation_index = *mutation_iter;
-										mutation_iter_pos = (mut_block_ptr + mutation_iter_mutation_index)->position_;
+										mutation_iter_pos = mut_positions[mutation_iter_mutation_index];
 									} else {
 										mutation_iter_mutation_index = -1;
 										mutation_iter_pos = SLIM_INF_BASE_POSITION;
@@ -2803,7 +3319,7 @@ void Population::DoCrossoverMutation(Subpopulation *p_source_subpop, Genome &p_c
 								
 								if (++mutation_iter != mutation_iter_max) {
 									mutation_iter_mutation_index = *mutation_iter;
-									mutation_iter_pos = (mut_block_ptr + mutation_iter_mutation_index)->position_;
+									mutation_iter_pos = mut_positions[mutation_iter_mutation_index];
 								} else {
 									mutation_iter_mutation_index = -1;
 									mutation_iter_pos = SLIM_INF_BASE_POSITION;
@@ -2823,7 +3339,7 @@ void Population::DoCrossoverMutation(Subpopulation *p_source_subpop, Genome &p_c
 							parent_iter = parent1_iter;		parent_iter_max = parent1_iter_max;		parent_genome = parent_genome_1;
 							
 							// skip over anything in the new parent that occurs prior to the breakpoint; it was not the active strand
-							while (parent_iter != parent_iter_max && (mut_block_ptr + *parent_iter)->position_ < breakpoint)
+							while (parent_iter != parent_iter_max && mut_positions[*parent_iter] < breakpoint)
 								parent_iter++;
 							
 							// we have now handled the current breakpoint, so move on; if we just handled the last breakpoint, then we are done
@@ -2855,7 +3371,7 @@ void Population::DoCrossoverMutation(Subpopulation *p_source_subpop, Genome &p_c
 							{
 								MutationIndex current_mutation = *parent_iter;
 								
-								if ((mut_block_ptr + current_mutation)->position_ >= breakpoint)
+								if (mut_positions[current_mutation] >= breakpoint)
 									break;
 								
 								// add the old mutation; no need to check for a duplicate here since the parental genome is already duplicate-free
@@ -2870,7 +3386,7 @@ void Population::DoCrossoverMutation(Subpopulation *p_source_subpop, Genome &p_c
 							parent_iter = parent1_iter;		parent_iter_max = parent1_iter_max;		parent_genome = parent_genome_1;
 							
 							// skip over anything in the new parent that occurs prior to the breakpoint; it was not the active strand
-							while (parent_iter != parent_iter_max && (mut_block_ptr + *parent_iter)->position_ < breakpoint)
+							while (parent_iter != parent_iter_max && mut_positions[*parent_iter] < breakpoint)
 								parent_iter++;
 							
 							// we have now handled the current breakpoint, so move on; if we just handled the last breakpoint, then we are done
@@ -2912,7 +3428,7 @@ void Population::DoCrossoverMutation(Subpopulation *p_source_subpop, Genome &p_c
 						while (parent_iter != parent_iter_max)
 						{
 							MutationIndex current_mutation = *parent_iter;
-							slim_position_t current_mutation_pos = (mut_block_ptr + current_mutation)->position_;
+							slim_position_t current_mutation_pos = mut_positions[current_mutation];
 							
 							if (current_mutation_pos > mutation_iter_pos)
 								break;
@@ -2950,7 +3466,7 @@ void Population::DoCrossoverMutation(Subpopulation *p_source_subpop, Genome &p_c
 						
 						if (++mutation_iter != mutation_iter_max) {
 							mutation_iter_mutation_index = *mutation_iter;
-							mutation_iter_pos = (mut_block_ptr + mutation_iter_mutation_index)->position_;
+							mutation_iter_pos = mut_positions[mutation_iter_mutation_index];
 						} else {
 							mutation_iter_mutation_index = -1;
 							mutation_iter_pos = SLIM_INF_BASE_POSITION;
@@ -3402,7 +3918,7 @@ void Population::DoRecombinantMutation(Subpopulation *p_mutorigin_subpop, Genome
 		p_child_genome.check_cleared_to_nullptr();
 #endif
 		
-		Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+		const slim_position_t *mut_positions = gSLiM_Mutation_Positions;
 		Genome *parent_genome = p_parent_genome_1;
 		slim_position_t mutrun_length = p_child_genome.mutrun_length_;
 		int mutrun_count = p_child_genome.mutrun_count_;
@@ -3448,7 +3964,7 @@ void Population::DoRecombinantMutation(Subpopulation *p_mutorigin_subpop, Genome
 					{
 						MutationIndex current_mutation = *parent_iter;
 						
-						if ((mut_block_ptr + current_mutation)->position_ >= breakpoint)
+						if (mut_positions[current_mutation] >= breakpoint)
 							break;
 						
 						// add the old mutation; no need to check for a duplicate here since the parental genome is already duplicate-free
@@ -3463,7 +3979,7 @@ void Population::DoRecombinantMutation(Subpopulation *p_mutorigin_subpop, Genome
 					parent_iter = parent1_iter;		parent_iter_max = parent1_iter_max;		parent_genome = p_parent_genome_1;
 					
 					// skip over anything in the new parent that occurs prior to the breakpoint; it was not the active strand
-					while (parent_iter != parent_iter_max && (mut_block_ptr + *parent_iter)->position_ < breakpoint)
+					while (parent_iter != parent_iter_max && mut_positions[*parent_iter] < breakpoint)
 						parent_iter++;
 					
 					// we have now handled the current breakpoint, so move on to the next breakpoint; advance the enclosing for loop here
@@ -3546,11 +4062,14 @@ void Population::DoRecombinantMutation(Subpopulation *p_mutorigin_subpop, Genome
 			}
 			else
 			{
-				// In non-nucleotide-based models, chromosome.DrawNewMutation() will return new mutations to us with nucleotide_ == -1
-				for (int k = 0; k < num_mutations; k++)
+				// In non-nucleotide-based models, chromosome.DrawNewMutations() will return new mutations to us with nucleotide_ == -1
+				static std::vector<MutationIndex> new_mutations;	// avoid buffer reallocs, etc.
+				
+				new_mutations.resize(num_mutations);
+				chromosome.DrawNewMutations(p_parent_sex, p_mutorigin_subpop->subpopulation_id_, sim_.Generation(), num_mutations, new_mutations.data());
+				
+				for (MutationIndex new_mutation : new_mutations)
 				{
-					MutationIndex new_mutation = chromosome.DrawNewMutation(p_parent_sex, p_mutorigin_subpop->subpopulation_id_, sim_.Generation());
-					
 					mutations_to_add.insert_sorted_mutation(new_mutation);	// keeps it sorted; since few mutations are expected, this is fast
 					
 					// no need to worry about pure_neutral_ or all_pure_neutral_DFE_ here; the mutation is drawn from a registered genomic element type
@@ -3565,6 +4084,7 @@ void Population::DoRecombinantMutation(Subpopulation *p_mutorigin_subpop, Genome
 		}
 		
 		Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+		const slim_position_t *mut_positions = gSLiM_Mutation_Positions;
 		const MutationIndex *mutation_iter		= mutations_to_add.begin_pointer_const();
 		const MutationIndex *mutation_iter_max	= mutations_to_add.end_pointer_const();
 		
@@ -3573,7 +4093,7 @@ void Population::DoRecombinantMutation(Subpopulation *p_mutorigin_subpop, Genome
 		
 		if (mutation_iter != mutation_iter_max) {
 			mutation_iter_mutation_index = *mutation_iter;
-			mutation_iter_pos = (mut_block_ptr + mutation_iter_mutation_index)->position_;
+			mutation_iter_pos = mut_positions[mutation_iter_mutation_index];
 		} else {
 			mutation_iter_mutation_index = -1;
 			mutation_iter_pos = SLIM_INF_BASE_POSITION;
@@ -3666,7 +4186,7 @@ void Population::DoRecombinantMutation(Subpopulation *p_mutorigin_subpop, Genome
 						while (parent_iter != parent_iter_max)
 						{
 							MutationIndex current_mutation = *parent_iter;
-							slim_position_t current_mutation_pos = (mut_block_ptr + current_mutation)->position_;
+							slim_position_t current_mutation_pos = mut_positions[current_mutation];
 							
 							if (current_mutation_pos >= breakpoint)
 								break;
@@ -3702,7 +4222,7 @@ void Population::DoRecombinantMutation(Subpopulation *p_mutorigin_subpop, Genome
 								
 								if (++mutation_iter != mutation_iter_max) {
 									mutation_iter_mutation_index = *mutation_iter;
-									mutation_iter_pos = (mut_block_ptr + mutation_iter_mutation_index)->position_;
+									mutation_iter_pos = mut_positions[mutation_iter_mutation_index];
 								} else {
 									mutation_iter_mutation_index = -1;
 									mutation_iter_pos = SLIM_INF_BASE_POSITION;
@@ -3748,7 +4268,7 @@ void Population::DoRecombinantMutation(Subpopulation *p_mutorigin_subpop, Genome
 							
 							if (++mutation_iter != mutation_iter_max) {
 								mutation_iter_mutation_index = *mutation_iter;
-								mutation_iter_pos = (mut_block_ptr + mutation_iter_mutation_index)->position_;
+								mutation_iter_pos = mut_positions[mutation_iter_mutation_index];
 							} else {
 								mutation_iter_mutation_index = -1;
 								mutation_iter_pos = SLIM_INF_BASE_POSITION;
@@ -3768,7 +4288,7 @@ void Population::DoRecombinantMutation(Subpopulation *p_mutorigin_subpop, Genome
 						parent_iter = parent1_iter;		parent_iter_max = parent1_iter_max;		parent_genome = p_parent_genome_1;
 						
 						// skip over anything in the new parent that occurs prior to the breakpoint; it was not the active strand
-						while (parent_iter != parent_iter_max && (mut_block_ptr + *parent_iter)->position_ < breakpoint)
+						while (parent_iter != parent_iter_max && mut_positions[*parent_iter] < breakpoint)
 							parent_iter++;
 						
 						// we have now handled the current breakpoint, so move on; if we just handled the last breakpoint, then we are done
@@ -3800,7 +4320,7 @@ void Population::DoRecombinantMutation(Subpopulation *p_mutorigin_subpop, Genome
 						{
 							MutationIndex current_mutation = *parent_iter;
 							
-							if ((mut_block_ptr + current_mutation)->position_ >= breakpoint)
+							if (mut_positions[current_mutation] >= breakpoint)
 								break;
 							
 							// add the old mutation; no need to check for a duplicate here since the parental genome is already duplicate-free
@@ -3815,7 +4335,7 @@ void Population::DoRecombinantMutation(Subpopulation *p_mutorigin_subpop, Genome
 						parent_iter = parent1_iter;		parent_iter_max = parent1_iter_max;		parent_genome = p_parent_genome_1;
 						
 						// skip over anything in the new parent that occurs prior to the breakpoint; it was not the active strand
-						while (parent_iter != parent_iter_max && (mut_block_ptr + *parent_iter)->position_ < breakpoint)
+						while (parent_iter != parent_iter_max && mut_positions[*parent_iter] < breakpoint)
 							parent_iter++;
 						
 						// we have now handled the current breakpoint, so move on; if we just handled the last breakpoint, then we are done
@@ -3857,7 +4377,7 @@ void Population::DoRecombinantMutation(Subpopulation *p_mutorigin_subpop, Genome
 					while (parent_iter != parent_iter_max)
 					{
 						MutationIndex current_mutation = *parent_iter;
-						slim_position_t current_mutation_pos = (mut_block_ptr + current_mutation)->position_;
+						slim_position_t current_mutation_pos = mut_positions[current_mutation];
 						
 						if (current_mutation_pos > mutation_iter_pos)
 							break;
@@ -3895,7 +4415,7 @@ void Population::DoRecombinantMutation(Subpopulation *p_mutorigin_subpop, Genome
 					
 					if (++mutation_iter != mutation_iter_max) {
 						mutation_iter_mutation_index = *mutation_iter;
-						mutation_iter_pos = (mut_block_ptr + mutation_iter_mutation_index)->position_;
+						mutation_iter_pos = mut_positions[mutation_iter_mutation_index];
 					} else {
 						mutation_iter_mutation_index = -1;
 						mutation_iter_pos = SLIM_INF_BASE_POSITION;
@@ -4009,11 +4529,14 @@ void Population::DoClonalMutation(Subpopulation *p_mutorigin_subpop, Genome &p_c
 			}
 			else
 			{
-				// In non-nucleotide-based models, chromosome.DrawNewMutation() will return new mutations to us with nucleotide_ == -1
-				for (int k = 0; k < num_mutations; k++)
+				// In non-nucleotide-based models, chromosome.DrawNewMutations() will return new mutations to us with nucleotide_ == -1
+				static std::vector<MutationIndex> new_mutations;	// avoid buffer reallocs, etc.
+				
+				new_mutations.resize(num_mutations);
+				chromosome.DrawNewMutations(p_child_sex, p_mutorigin_subpop->subpopulation_id_, sim_.Generation(), num_mutations, new_mutations.data());	// the parent sex is the same as the child sex
+				
+				for (MutationIndex new_mutation : new_mutations)
 				{
-					MutationIndex new_mutation = chromosome.DrawNewMutation(p_child_sex, p_mutorigin_subpop->subpopulation_id_, sim_.Generation());	// the parent sex is the same as the child sex
-					
 					mutations_to_add.insert_sorted_mutation(new_mutation);	// keeps it sorted; since few mutations are expected, this is fast
 					
 					// no need to worry about pure_neutral_ or all_pure_neutral_DFE_ here; the mutation is drawn from a registered genomic element type
@@ -4029,6 +4552,7 @@ void Population::DoClonalMutation(Subpopulation *p_mutorigin_subpop, Genome &p_c
 		
 		// loop over mutation runs and either (1) copy the mutrun pointer from the parent, or (2) make a new mutrun by modifying that of the parent
 		Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+		const slim_position_t *mut_positions = gSLiM_Mutation_Positions;
 		
 		int mutrun_count = p_child_genome.mutrun_count_;
 		slim_position_t mutrun_length = p_child_genome.mutrun_length_;
@@ -4036,7 +4560,7 @@ void Population::DoClonalMutation(Subpopulation *p_mutorigin_subpop, Genome &p_c
 		const MutationIndex *mutation_iter		= mutations_to_add.begin_pointer_const();
 		const MutationIndex *mutation_iter_max	= mutations_to_add.end_pointer_const();
 		MutationIndex mutation_iter_mutation_index = *mutation_iter;
-		slim_position_t mutation_iter_pos = (mut_block_ptr + mutation_iter_mutation_index)->position_;
+		slim_position_t mutation_iter_pos = mut_positions[mutation_iter_mutation_index];
 		slim_mutrun_index_t mutation_iter_mutrun_index = (slim_mutrun_index_t)(mutation_iter_pos / mutrun_length);
 		
 		for (int run_index = 0; run_index < mutrun_count; ++run_index)
@@ -4058,7 +4582,7 @@ void Population::DoClonalMutation(Subpopulation *p_mutorigin_subpop, Genome &p_c
 				do
 				{
 					// while an old mutation in the parent is before or at the next new mutation...
-					while ((parent_iter != parent_iter_max) && ((mut_block_ptr + *parent_iter)->position_ <= mutation_iter_pos))
+					while ((parent_iter != parent_iter_max) && (mut_positions[*parent_iter] <= mutation_iter_pos))
 					{
 						// we know the mutation is not already present, since mutations on the parent strand are already uniqued,
 						// and new mutations are, by definition, new and thus cannot match the existing mutations
@@ -4067,7 +4591,7 @@ void Population::DoClonalMutation(Subpopulation *p_mutorigin_subpop, Genome &p_c
 					}
 					
 					// while a new mutation in this run is before the next old mutation in the parent... (which we know is true when we first reach here)
-					slim_position_t parent_iter_pos = (parent_iter == parent_iter_max) ? (SLIM_INF_BASE_POSITION) : (mut_block_ptr + *parent_iter)->position_;
+					slim_position_t parent_iter_pos = (parent_iter == parent_iter_max) ? (SLIM_INF_BASE_POSITION) : mut_positions[*parent_iter];
 					
 					do
 					{
@@ -4110,7 +4634,7 @@ void Population::DoClonalMutation(Subpopulation *p_mutorigin_subpop, Genome &p_c
 						else
 						{
 							mutation_iter_mutation_index = *mutation_iter;
-							mutation_iter_pos = (mut_block_ptr + mutation_iter_mutation_index)->position_;
+							mutation_iter_pos = mut_positions[mutation_iter_mutation_index];
 						}
 						
 						mutation_iter_mutrun_index = (slim_mutrun_index_t)(mutation_iter_pos / mutrun_length);
@@ -4266,6 +4790,8 @@ void Population::AddTallyForMutationTypeAndBinNumber(int p_mutation_type_index,
 void Population::ValidateMutationFitnessCaches(void)
 {
 	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+	slim_selcoeff_t *one_plus_sel = gSLiM_Mutation_OnePlusSel;
+	slim_selcoeff_t *one_plus_dom_sel = gSLiM_Mutation_OnePlusDomSel;
 	const MutationIndex *registry_iter = mutation_registry_.begin_pointer_const();
 	const MutationIndex *registry_iter_end = mutation_registry_.end_pointer_const();
 	
@@ -4276,8 +4802,8 @@ void Population::ValidateMutationFitnessCaches(void)
 		slim_selcoeff_t sel_coeff = mut->selection_coeff_;
 		slim_selcoeff_t dom_coeff = mut->mutation_type_ptr_->dominance_coeff_;
 		
-		mut->cached_one_plus_sel_ = (slim_selcoeff_t)std::max(0.0, 1.0 + sel_coeff);
-		mut->cached_one_plus_dom_sel_ = (slim_selcoeff_t)std::max(0.0, 1.0 + dom_coeff * sel_coeff);
+		one_plus_sel[mut_index] = (slim_selcoeff_t)std::max(0.0, 1.0 + sel_coeff);
+		one_plus_dom_sel[mut_index] = (slim_selcoeff_t)std::max(0.0, 1.0 + dom_coeff * sel_coeff);
 	}
 }
 
@@ -5468,6 +5994,21 @@ slim_refcount_t Population::TallyMutationReferences(std::vector<Subpopulation*>
 
 slim_refcount_t Population::TallyMutationReferences_FAST(void)
 {
+#ifdef _OPENMP
+	// With multiple threads, tally the unique mutation runs concurrently; see TallyMutationReferences_Parallel().  For small
+	// populations the threading overhead is not worth it, so we use the serial code below, which gives the same result.
+	if (gEidosMaxThreads > 1)
+	{
+		slim_popsize_t genome_count = 0;
+		
+		for (const std::pair<const slim_objectid_t,Subpopulation*> &subpop_pair : subpops_)
+			genome_count += subpop_pair.second->CurrentGenomeCount();
+		
+		if (genome_count >= 1000)
+			return TallyMutationReferences_Parallel();
+	}
+#endif
+	
 	// first zero out the refcounts in all registered Mutation objects
 	SLiM_ZeroRefcountBlock(mutation_registry_);
 	
@@ -5512,6 +6053,78 @@ slim_refcount_t Population::TallyMutationReferences_FAST(void)
 	return total_genome_count;
 }
 
+#ifdef _OPENMP
+slim_refcount_t Population::TallyMutationReferences_Parallel(void)
+{
+	// This produces the same refcounts as TallyMutationReferences_FAST(), in two passes.  First, single-threaded, we walk the genomes
+	// to find each unique MutationRun (using the same operation_id_ marking as Genome::TallyGenomeMutationReferences()) and count the
+	// non-null genomes.  Second, the unique runs are divided among threads, and each run adds its use count to the refcount of each of
+	// its mutations.  Runs share mutations, so those adds are atomic; integer addition commutes, so the result does not depend upon
+	// the order in which the threads get there.  Per-thread refcount slabs would avoid the atomics, but each slab would need to cover
+	// the whole mutation block, and zeroing and reducing them would cost more than the contention does for realistic run counts.
+	static std::vector<MutationRun *> unique_mutruns;
+	
+	slim_refcount_t total_genome_count = 0;
+	int64_t operation_id = ++gSLiM_MutationRun_OperationID;
+	
+	unique_mutruns.clear();
+	
+	for (const std::pair<const slim_objectid_t,Subpopulation*> &subpop_pair : subpops_)
+	{
+		Subpopulation *subpop = subpop_pair.second;
+		slim_popsize_t subpop_genome_count = subpop->CurrentGenomeCount();
+		std::vector<Genome *> &subpop_genomes = subpop->CurrentGenomes();
+		
+		for (slim_popsize_t i = 0; i < subpop_genome_count; i++)
+		{
+			Genome &genome = *subpop_genomes[i];
+			
+			if (!genome.IsNull())
+			{
+				int mutrun_count = genome.mutrun_count_;
+				
+				for (int run_index = 0; run_index < mutrun_count; ++run_index)
+				{
+					MutationRun *mutrun = genome.mutruns_[run_index].get();
+					
+					if (mutrun->operation_id_ != operation_id)
+					{
+						mutrun->operation_id_ = operation_id;
+						unique_mutruns.push_back(mutrun);
+					}
+				}
+				
+				total_genome_count++;	// count only non-null genomes to determine fixation
+			}
+		}
+	}
+	
+	// zero out the refcounts in all registered Mutation objects, and then tally the unique runs across threads
+	SLiM_ZeroRefcountBlock(mutation_registry_);
+	
+	slim_refcount_t *refcount_block_ptr = gSLiM_Mutation_Refcounts;
+	MutationRun **mutruns = unique_mutruns.data();
+	int64_t mutrun_total = (int64_t)unique_mutruns.size();
+	
+#pragma omp parallel for num_threads(gEidosMaxThreads) schedule(dynamic, 16) default(none) shared(refcount_block_ptr, mutruns, mutrun_total)
+	for (int64_t mutrun_index = 0; mutrun_index < mutrun_total; ++mutrun_index)
+	{
+		const MutationRun *mutrun = mutruns[mutrun_index];
+		slim_refcount_t use_count = (slim_refcount_t)mutrun->UseCount();
+		const MutationIndex *genome_iter = mutrun->begin_pointer_const();
+		const MutationIndex *genome_end_iter = mutrun->end_pointer_const();
+		
+		for (; genome_iter != genome_end_iter; ++genome_iter)
+		{
+#pragma omp atomic update
+			refcount_block_ptr[*genome_iter] += use_count;
+		}
+	}
+	
+	return total_genome_count;
+}
+#endif
+
 // handle negative fixation (remove from the registry) and positive fixation (convert to Substitution), using reference counts from TallyMutationReferences()
 // TallyMutationReferences() must have cached tallies across the whole population before this is called, or it will malfunction!
 void Population::RemoveAllFixedMutations(void)
@@ -5534,6 +6147,7 @@ void Population::RemoveAllFixedMutations(void)
 	// remove Mutation objects that are no longer referenced, freeing them; avoid using an iterator since it would be invalidated
 	slim_refcount_t *refcount_block_ptr = gSLiM_Mutation_Refcounts;
 	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+	slim_position_t *mut_positions = gSLiM_Mutation_Positions;
 	
 	{
 		int registry_length = mutation_registry_.size();
@@ -5664,6 +6278,37 @@ void Population::RemoveAllFixedMutations(void)
 		// We remove fixed mutations from each MutationRun just once; this is the operation ID we use for that
 		int64_t operation_id = ++gSLiM_MutationRun_OperationID;
 		
+		// First, determine which mutation run indices contain a fixed mutation.  Only runs at those indices can change, so they are
+		// the candidates for removal; the whole rest of each genome can be skipped.  Several fixed mutations often fall in the same
+		// run, so deduplicating here saves re-checking the same run once per fixed mutation in every genome.
+		Chromosome &chromosome = sim_.TheChromosome();
+		slim_position_t mutrun_length = chromosome.mutrun_length_;
+		static std::vector<uint8_t> mutrun_index_affected;
+		static std::vector<slim_mutrun_index_t> affected_mutrun_indices;
+		
+		mutrun_index_affected.assign(chromosome.mutrun_count_, 0);
+		affected_mutrun_indices.clear();
+		
+		for (int mut_index = 0; mut_index < fixed_mutation_accumulator.size(); mut_index++)
+		{
+			MutationIndex mut_to_remove = fixed_mutation_accumulator[mut_index];
+			slim_mutrun_index_t mutrun_index = (slim_mutrun_index_t)(mut_positions[mut_to_remove] / mutrun_length);
+			
+			if (!mutrun_index_affected[mutrun_index])
+			{
+				mutrun_index_affected[mutrun_index] = 1;
+				affected_mutrun_indices.push_back(mutrun_index);
+			}
+		}
+		
+		// Then find the unique MutationRun objects at those indices, across all genomes; each is shared by every genome that uses it,
+		// so the operation ID ensures that each gets scanned only once.  Note that total_genome_count_ is not needed for the removal;
+		// refcounts were set to -1 above.
+		static std::vector<MutationRun *> affected_mutruns;
+		int affected_index_count = (int)affected_mutrun_indices.size();
+		
+		affected_mutruns.clear();
+		
 		for (std::pair<const slim_objectid_t,Subpopulation*> &subpop_pair : subpops_)		// subpopulations
 		{
 			std::vector<Genome *> &subpop_genomes = subpop_pair.second->CurrentGenomes();
@@ -5675,25 +6320,39 @@ void Population::RemoveAllFixedMutations(void)
 				
 				if (!genome->IsNull())
 				{
-					// Loop over the mutations to remove, and take advantage of our mutation runs by scanning
-					// for removal only within the runs that contain a mutation to be removed.  If there is
-					// more than one mutation to be removed within the same run, the second time around the
-					// runs will no-op the scan using operatiod_id.  The whole rest of the genomes can be skipped.
-					slim_position_t mutrun_length = genome->mutrun_length_;
-					
-					for (int mut_index = 0; mut_index < fixed_mutation_accumulator.size(); mut_index++)
+					for (int affected_index = 0; affected_index < affected_index_count; affected_index++)
 					{
-						MutationIndex mut_to_remove = fixed_mutation_accumulator[mut_index];
-						slim_position_t mut_position = (mut_block_ptr + mut_to_remove)->position_;
-						slim_mutrun_index_t mutrun_index = (slim_mutrun_index_t)(mut_position / mutrun_length);
+						MutationRun *mutrun = genome->mutruns_[affected_mutrun_indices[affected_index]].get();
 						
-						// Note that total_genome_count_ is not needed by RemoveAllFixedMutations(); refcounts were set to -1 above.
-						genome->RemoveFixedMutations(operation_id, mutrun_index);
+						if (mutrun->operation_id_ != operation_id)
+						{
+							mutrun->operation_id_ = operation_id;
+							affected_mutruns.push_back(mutrun);
+						}
 					}
 				}
 			}
 		}
 		
+		// Finally, remove the fixed mutations from those runs.  Each run is a separate object that is modified only by its own removal
+		// pass, reading refcounts that are no longer changing, so the runs can be handled by different threads without any locking.
+		MutationRun **mutruns = affected_mutruns.data();
+		int64_t affected_mutrun_count = (int64_t)affected_mutruns.size();
+		
+#ifdef _OPENMP
+		if ((gEidosMaxThreads > 1) && (affected_mutrun_count >= 64))
+		{
+#pragma omp parallel for num_threads(gEidosMaxThreads) schedule(dynamic, 16) default(none) shared(mutruns, affected_mutrun_count)
+			for (int64_t mutrun_index = 0; mutrun_index < affected_mutrun_count; ++mutrun_index)
+				mutruns[mutrun_index]->_RemoveFixedMutations();
+		}
+		else
+#endif
+		{
+			for (int64_t mutrun_index = 0; mutrun_index < affected_mutrun_count; ++mutrun_index)
+				mutruns[mutrun_index]->_RemoveFixedMutations();
+		}
+		
 		slim_generation_t generation = sim_.Generation();
 		
 		// TREE SEQUENCE RECORDING
@@ -46,6 +46,22 @@ class Individual;
 class Genome;
 
 
+#ifdef SLIM_WF_ONLY
+// This struct is used by EvolveSubpopulation() when generating offspring with multiple threads.  All random draws for a gamete
+// (strand choice, breakpoints, new mutations) are made up front, in the same order as DoCrossoverMutation() would make them, and
+// recorded here; the gametes are then assembled from their plans in parallel.  Breakpoints and new mutations are kept in flat
+// buffers owned by the Population, indexed by the start/count values here, to avoid per-gamete allocations.
+typedef struct {
+	Genome *child_genome_;					// the genome to be assembled; its mutation runs are nullptr until assembly
+	Genome *parent_genome_1_;				// the initial copy strand, after the strand swap (if any)
+	Genome *parent_genome_2_;				// the other strand; may be nullptr when no breakpoints are planned
+	int64_t breakpoints_start_;				// index of the first breakpoint in gamete_plan_breakpoints_
+	int64_t mutations_start_;				// index of the first new mutation in gamete_plan_mutations_ / gamete_plan_mutation_added_
+	int32_t breakpoints_count_;				// the number of breakpoints, including the end sentinel if there are any
+	int32_t mutations_count_;				// the number of new mutations, sorted by position with ties in order of drawing
+} GametePlan;
+#endif
+
 #ifdef SLIMGUI
 // This struct is used to hold fitness values observed during a run, for display by GraphView_FitnessOverTime
 // The Population keeps the fitness histories for all the subpopulations, because subpops can come and go, but
@@ -87,6 +103,12 @@ public:
 
 #ifdef SLIM_WF_ONLY
 	bool child_generation_valid_ = false;					// this keeps track of whether children have been generated by EvolveSubpopulation() yet, or whether the parents are still in charge
+	
+	// Buffers for multithreaded offspring generation; see GametePlan above.  These are reused from generation to generation.
+	std::vector<GametePlan> gamete_plans_;
+	std::vector<slim_position_t> gamete_plan_breakpoints_;
+	std::vector<MutationIndex> gamete_plan_mutations_;
+	std::vector<uint8_t> gamete_plan_mutation_added_;		// set during assembly: 1 if the new mutation passed the stacking policy
 #endif
 	
 	std::vector<Subpopulation*> removed_subpops_;			// OWNED POINTERS: Subpops which are set to size 0 (and thus removed) are kept here until the end of the generation
@@ -152,6 +174,9 @@ public:
 	// count the total number of times that each Mutation in the registry is referenced by a population, and set total_genome_count_ to the maximum possible number of references (i.e. fixation)
 	slim_refcount_t TallyMutationReferences(std::vector<Subpopulation*> *p_subpops_to_tally, bool p_force_recache);
 	slim_refcount_t TallyMutationReferences_FAST(void);
+#ifdef _OPENMP
+	slim_refcount_t TallyMutationReferences_Parallel(void);		// used by TallyMutationReferences_FAST() when multithreaded
+#endif
 	
 	// handle negative fixation (remove from the registry) and positive fixation (convert to Substitution), using reference counts from TallyMutationReferences()
 	void RemoveAllFixedMutations(void);
@@ -178,6 +203,11 @@ public:
 	// generate children for subpopulation p_subpop_id, drawing from all source populations, handling crossover and mutation
 	void EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice_callbacks_present, bool p_modify_child_callbacks_present, bool p_recombination_callbacks_present, bool p_mutation_callbacks_present);
 	
+	// multithreaded offspring generation: make all random draws for a gamete now, then assemble all planned gametes in parallel
+	void PlanCrossoverMutation(Subpopulation *p_source_subpop, Genome &p_child_genome, slim_popsize_t p_parent_index, IndividualSex p_child_sex, IndividualSex p_parent_sex);
+	void PlanClonalMutation(Subpopulation *p_mutorigin_subpop, Genome &p_child_genome, Genome &p_parent_genome, IndividualSex p_child_sex);
+	void AssembleGametePlans(void);
+	
 	// step forward a generation: make the children become the parents
 	void SwapGenerations(void);
 	
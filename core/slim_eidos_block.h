@@ -193,6 +193,9 @@ public:
 	void _ScanNodeForIdentifiersUsed(const EidosASTNode *p_scan_node);
 	void ScanTreeForIdentifiersUsed(void);
 	
+	// Add the types of the pseudo-parameters of this block (sim, self, and callback parameters like mut and relFitness) to a type table
+	void AddPseudoParameterTypesToTypeTable(EidosTypeTable *p_type_table) const;
+	
 	//
 	// Eidos support
 	//
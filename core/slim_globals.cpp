@@ -491,6 +491,9 @@ SLiMEidosBlock *SLiM_ExtractSLiMEidosBlockFromEidosValue_io(EidosValue *p_value,
 // Verbosity, from the command-line option -l[ong]
 bool SLiM_verbose_output = false;
 
+// Fitness products accumulated in four interleaved lanes, from the command-line option -fitnessLanes; see subpopulation.cpp
+bool SLiM_fitness_lanes = false;
+
 
 // stream output for enumerations
 std::string StringForGenomeType(GenomeType p_genome_type)
@@ -1142,6 +1145,11 @@ const std::string gStr_treeSeqCoalesced = "treeSeqCoalesced";
 const std::string gStr_treeSeqSimplify = "treeSeqSimplify";
 const std::string gStr_treeSeqRememberIndividuals = "treeSeqRememberIndividuals";
 const std::string gStr_treeSeqOutput = "treeSeqOutput";
+const std::string gStr_treeSeqDiversity = "treeSeqDiversity";
+const std::string gStr_treeSeqDivergence = "treeSeqDivergence";
+const std::string gStr_treeSeqFst = "treeSeqFst";
+const std::string gStr_treeSeqSFS = "treeSeqSFS";
+const std::string gStr_treeSeqR2 = "treeSeqR2";
 const std::string gStr_setMigrationRates = "setMigrationRates";
 const std::string gStr_pointInBounds = "pointInBounds";
 const std::string gStr_pointReflected = "pointReflected";
@@ -1482,6 +1490,11 @@ void SLiM_RegisterGlobalStringsAndIDs(void)
 		Eidos_RegisterStringForGlobalID(gStr_treeSeqSimplify, gID_treeSeqSimplify);
 		Eidos_RegisterStringForGlobalID(gStr_treeSeqRememberIndividuals, gID_treeSeqRememberIndividuals);
 		Eidos_RegisterStringForGlobalID(gStr_treeSeqOutput, gID_treeSeqOutput);
+		Eidos_RegisterStringForGlobalID(gStr_treeSeqDiversity, gID_treeSeqDiversity);
+		Eidos_RegisterStringForGlobalID(gStr_treeSeqDivergence, gID_treeSeqDivergence);
+		Eidos_RegisterStringForGlobalID(gStr_treeSeqFst, gID_treeSeqFst);
+		Eidos_RegisterStringForGlobalID(gStr_treeSeqSFS, gID_treeSeqSFS);
+		Eidos_RegisterStringForGlobalID(gStr_treeSeqR2, gID_treeSeqR2);
 		Eidos_RegisterStringForGlobalID(gStr_setMigrationRates, gID_setMigrationRates);
 		Eidos_RegisterStringForGlobalID(gStr_pointInBounds, gID_pointInBounds);
 		Eidos_RegisterStringForGlobalID(gStr_pointReflected, gID_pointReflected);
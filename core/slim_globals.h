@@ -293,6 +293,9 @@ SLiMEidosBlock *SLiM_ExtractSLiMEidosBlockFromEidosValue_io(EidosValue *p_value,
 // Verbosity, from the command-line option -l[ong]
 extern bool SLiM_verbose_output;
 
+// Fitness products accumulated in four interleaved lanes, from the command-line option -fitnessLanes; see subpopulation.cpp
+extern bool SLiM_fitness_lanes;
+
 
 // *******************************************************************************************************************
 //
@@ -627,6 +630,11 @@ extern const std::string gStr_treeSeqCoalesced;
 extern const std::string gStr_treeSeqSimplify;
 extern const std::string gStr_treeSeqRememberIndividuals;
 extern const std::string gStr_treeSeqOutput;
+extern const std::string gStr_treeSeqDiversity;
+extern const std::string gStr_treeSeqDivergence;
+extern const std::string gStr_treeSeqFst;
+extern const std::string gStr_treeSeqSFS;
+extern const std::string gStr_treeSeqR2;
 extern const std::string gStr_setMigrationRates;
 extern const std::string gStr_pointInBounds;
 extern const std::string gStr_pointReflected;
@@ -930,6 +938,11 @@ enum _SLiMGlobalStringID : int {
 	gID_treeSeqSimplify,
 	gID_treeSeqRememberIndividuals,
 	gID_treeSeqOutput,
+	gID_treeSeqDiversity,
+	gID_treeSeqDivergence,
+	gID_treeSeqFst,
+	gID_treeSeqSFS,
+	gID_treeSeqR2,
 	gID_setMigrationRates,
 	gID_pointInBounds,
 	gID_pointReflected,
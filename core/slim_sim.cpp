@@ -25,12 +25,14 @@
 #include "eidos_call_signature.h"
 #include "eidos_property_signature.h"
 #include "eidos_ast_node.h"
+#include "eidos_bytecode.h"
 #include "individual.h"
 #include "polymorphism.h"
 #include "subpopulation.h"
 
 #include <iostream>
 #include <iomanip>
+#include <sstream>
 #include <fstream>
 #include <stdexcept>
 #include <algorithm>
@@ -44,6 +46,7 @@
 #include <unordered_set>
 #include <unordered_map>
 #include <float.h>
+#include <limits>
 
 //TREE SEQUENCE
 #include <stdio.h>
@@ -395,6 +398,7 @@ slim_generation_t SLiMSim::InitializePopulationFromFile(const std::string &p_fil
 			
 			// reset our tree-seq auto-simplification interval so we don't simplify immediately
 			simplify_elapsed_ = 0;
+			memory_limit_last_bytes_ = TreeSeqBytesInUse();
 			
 			// reset our last coalescence state; we don't know whether we're coalesced now or not
 			last_coalescence_state_ = false;
@@ -1972,6 +1976,53 @@ void SLiMSim::OptimizeScriptBlock(SLiMEidosBlock *p_script_block)
 //				std::cout << "NOT OPTIMIZED:" << std::endl << "   " << base_node->token_->token_string_ << std::endl;
 		}
 	}
+	
+	// Blocks that were not short-circuited above get type-specialized evaluators for arithmetic and comparison operators whose
+	// operand types can be inferred; the inference uses the types of the block's pseudo-parameters and of the constants defined
+	// so far, and the specialized evaluators check those types at runtime, so an inference that turns out to be wrong is harmless.
+	// initialize() callbacks run only once, and user-defined functions have parameters of unknown type, so they are skipped.
+	if (!p_script_block->has_cached_optimization_ && p_script_block->compound_statement_node_ &&
+		(p_script_block->type_ != SLiMEidosBlockType::SLiMEidosInitializeCallback) && (p_script_block->type_ != SLiMEidosBlockType::SLiMEidosUserDefinedFunction))
+	{
+		SLiMTypeTable type_table;
+		EidosFunctionMap function_map(simulation_functions_);
+		EidosCallTypeTable call_types;
+		EidosNodeTypeTable node_types;
+		
+		simulation_constants_->AddSymbolsToTypeTable(&type_table);
+		p_script_block->AddPseudoParameterTypesToTypeTable(&type_table);
+		
+		SLiMTypeInterpreter typeInterpreter(p_script_block->compound_statement_node_, type_table, function_map, call_types);
+		
+		typeInterpreter.TypeEvaluateInterpreterBlock_RecordNodeTypes(&node_types);
+		p_script_block->compound_statement_node_->OptimizeTypeSpecializations(node_types);
+	}
+
+	// Callbacks that were not short-circuited above are compiled to bytecode, since they typically run very many times per
+	// generation; EvaluateInternalBlock() then uses the compiled form.  Events and user-defined functions are not compiled.
+	if (!p_script_block->has_cached_optimization_)
+	{
+		switch (p_script_block->type_)
+		{
+			case SLiMEidosBlockType::SLiMEidosFitnessCallback:
+			case SLiMEidosBlockType::SLiMEidosFitnessGlobalCallback:
+			case SLiMEidosBlockType::SLiMEidosInteractionCallback:
+			case SLiMEidosBlockType::SLiMEidosMateChoiceCallback:
+			case SLiMEidosBlockType::SLiMEidosModifyChildCallback:
+			case SLiMEidosBlockType::SLiMEidosRecombinationCallback:
+			case SLiMEidosBlockType::SLiMEidosMutationCallback:
+			case SLiMEidosBlockType::SLiMEidosReproductionCallback:
+			{
+				const EidosASTNode *base_node = p_script_block->compound_statement_node_;
+				
+				if (base_node && !base_node->cached_bytecode_)
+					base_node->cached_bytecode_ = EidosBytecode::CompileBlock(base_node);
+				break;
+			}
+			default:
+				break;
+		}
+	}
 }
 
 void SLiMSim::AddScriptBlock(SLiMEidosBlock *p_script_block, EidosInterpreter *p_interpreter, const EidosToken *p_error_token)
@@ -4433,7 +4484,18 @@ void SLiMSim::TabulateMemoryUsage(SLiM_MemoryUsage *p_usage, EidosSymbolTable *p
 		
 		p_usage->slimsimObjects = (sizeof(SLiMSim) - sizeof(Chromosome)) * p_usage->slimsimObjects_count;	// Chromosome is handled separately above
 		
+		if (recording_tree_)
+		{
+			FlushRecordingBuffers();
+			
+			if (async_simplify_pending_)
+				FinishAsyncSimplification();
+		}
+		
 		p_usage->slimsimTreeSeqTables = recording_tree_ ? MemoryUsageForTables(tables_) : 0;
+		
+		if (recording_tree_)
+			p_usage->slimsimTreeSeqTables += derived_state_dict_.capacity() * sizeof(DerivedStateEntry);
 	}
 	
 	// Subpopulation
@@ -4491,9 +4553,9 @@ void SLiMSim::TabulateMemoryUsage(SLiM_MemoryUsage *p_usage, EidosSymbolTable *p
 	/*
 	 Subpopulation:
 	 
-	gsl_ran_discrete_t *lookup_parent_ = nullptr;			// OWNED POINTER: lookup table for drawing a parent based upon fitness
-	gsl_ran_discrete_t *lookup_female_parent_ = nullptr;	// OWNED POINTER: lookup table for drawing a female parent based upon fitness, SEX ONLY
-	gsl_ran_discrete_t *lookup_male_parent_ = nullptr;		// OWNED POINTER: lookup table for drawing a male parent based upon fitness, SEX ONLY
+	EidosAliasTable lookup_parent_;							// lookup table for drawing a parent based upon fitness; not valid in pure neutral models
+	EidosAliasTable lookup_female_parent_;					// lookup table for drawing a female parent based upon fitness, SEX ONLY
+	EidosAliasTable lookup_male_parent_;					// lookup table for drawing a male parent based upon fitness, SEX ONLY
 
 	 */
 	
@@ -4718,6 +4780,171 @@ void SLiMSim::ReorderIndividualTable(tsk_table_collection_t *p_tables, std::vect
 	}
 }
 
+// Compares two edges in the order used by tsk_table_collection_sort(): parent time, then parent, then child, then left coordinate
+static inline int _CompareTreeSeqEdges(double p_time1, tsk_id_t p_parent1, tsk_id_t p_child1, double p_left1, double p_time2, tsk_id_t p_parent2, tsk_id_t p_child2, double p_left2)
+{
+	if (p_time1 != p_time2)
+		return (p_time1 > p_time2) ? 1 : -1;
+	if (p_parent1 != p_parent2)
+		return (p_parent1 > p_parent2) ? 1 : -1;
+	if (p_child1 != p_child2)
+		return (p_child1 > p_child2) ? 1 : -1;
+	if (p_left1 != p_left2)
+		return (p_left1 > p_left2) ? 1 : -1;
+	return 0;
+}
+
+// Brings the first p_prefix_count edges into the order used by tsk_table_collection_sort(), assuming they were left by simplify, and
+// returns the number of edges that are now known to be sorted (zero if the assumption did not hold).  Simplify emits the edges for
+// each parent as one contiguous block, ordered by child and then left coordinate, and emits the blocks in time order, but it does not
+// order the blocks of parents with the same time by parent id.  This reorders the blocks, which is much cheaper than a full sort since
+// there are far fewer blocks than edges; the edges themselves are checked, so tables that are not in that form are never mis-sorted.
+struct _TreeSeqEdgeBlock {
+	double time_;
+	tsk_id_t parent_;
+	tsk_size_t start_;
+	tsk_size_t length_;
+};
+
+static tsk_size_t _SortSimplifiedEdgePrefix(tsk_edge_table_t &p_edges, const double *p_node_time, tsk_size_t p_prefix_count)
+{
+	std::vector<_TreeSeqEdgeBlock> blocks;
+	bool blocks_in_order = true;
+	tsk_size_t block_start = 0;
+	
+	for (tsk_size_t edge_index = 0; edge_index < p_prefix_count; ++edge_index)
+	{
+		tsk_id_t parent = p_edges.parent[edge_index];
+		
+		if ((edge_index + 1 < p_prefix_count) && (p_edges.parent[edge_index + 1] == parent))
+		{
+			// within a block, edges must be ordered by child and then left
+			if ((p_edges.child[edge_index] > p_edges.child[edge_index + 1]) ||
+				((p_edges.child[edge_index] == p_edges.child[edge_index + 1]) && (p_edges.left[edge_index] >= p_edges.left[edge_index + 1])))
+				return 0;
+			
+			continue;
+		}
+		
+		_TreeSeqEdgeBlock block = {p_node_time[parent], parent, block_start, edge_index + 1 - block_start};
+		
+		if (blocks.size())
+		{
+			const _TreeSeqEdgeBlock &previous = blocks.back();
+			
+			if (block.time_ < previous.time_)
+				return 0;
+			if ((block.time_ == previous.time_) && (block.parent_ < previous.parent_))
+				blocks_in_order = false;
+		}
+		
+		blocks.emplace_back(block);
+		block_start = edge_index + 1;
+	}
+	
+	if (blocks_in_order)
+		return p_prefix_count;
+	
+	std::sort(blocks.begin(), blocks.end(), [](const _TreeSeqEdgeBlock &l, const _TreeSeqEdgeBlock &r) { return (l.time_ < r.time_) || ((l.time_ == r.time_) && (l.parent_ < r.parent_)); });
+	
+	// each parent must have had just one block, or its edges would need to be interleaved rather than moved as a block
+	for (size_t block_index = 1; block_index < blocks.size(); ++block_index)
+		if (blocks[block_index].parent_ == blocks[block_index - 1].parent_)
+			return 0;
+	
+	std::vector<double> old_left(p_edges.left, p_edges.left + p_prefix_count);
+	std::vector<double> old_right(p_edges.right, p_edges.right + p_prefix_count);
+	std::vector<tsk_id_t> old_parent(p_edges.parent, p_edges.parent + p_prefix_count);
+	std::vector<tsk_id_t> old_child(p_edges.child, p_edges.child + p_prefix_count);
+	tsk_size_t dest_index = 0;
+	
+	for (const _TreeSeqEdgeBlock &block : blocks)
+	{
+		std::copy(old_left.begin() + block.start_, old_left.begin() + block.start_ + block.length_, p_edges.left + dest_index);
+		std::copy(old_right.begin() + block.start_, old_right.begin() + block.start_ + block.length_, p_edges.right + dest_index);
+		std::copy(old_parent.begin() + block.start_, old_parent.begin() + block.start_ + block.length_, p_edges.parent + dest_index);
+		std::copy(old_child.begin() + block.start_, old_child.begin() + block.start_ + block.length_, p_edges.child + dest_index);
+		dest_index += block.length_;
+	}
+	
+	return p_prefix_count;
+}
+
+static int _SortTreeSequenceTables(tsk_table_collection_t *p_tables, tsk_size_t p_sorted_edge_count)
+{
+	// This is equivalent to tsk_table_collection_sort(p_tables, NULL, 0), but it takes advantage of the fact that the edges in
+	// [0, p_sorted_edge_count) were left by the last simplify, and are therefore sorted apart from the order of same-time parents,
+	// which _SortSimplifiedEdgePrefix() fixes cheaply.  Only the edges recorded since then get sorted (by tskit, which accepts a
+	// bookmark for that), and then the two sorted runs are merged.  The merge is linear, so the cost of a sort scales with the number
+	// of new edges rather than with the size of the whole table.  The sort key (time, parent, child, left) is unique for the edges
+	// SLiM records, so the result is identical to a full sort.
+	tsk_edge_table_t &edges = p_tables->edges;
+	const double *node_time = p_tables->nodes.time;
+	tsk_size_t edge_count = edges.num_rows;
+	
+	if (p_sorted_edge_count > edge_count)
+		p_sorted_edge_count = 0;
+	
+	p_sorted_edge_count = _SortSimplifiedEdgePrefix(edges, node_time, p_sorted_edge_count);
+	
+	// Sort the new edges, and the site and mutation tables, which tskit always sorts in full
+	tsk_bookmark_t start;
+	
+	memset(&start, 0, sizeof(start));
+	start.edges = p_sorted_edge_count;
+	
+	int ret = tsk_table_collection_sort(p_tables, &start, /* flags */ 0);
+	if (ret < 0)
+		return ret;
+	
+	if ((p_sorted_edge_count == 0) || (p_sorted_edge_count == edge_count))
+		return 0;
+	
+	// Merge the two sorted runs, from the back, so that only the new edges need temporary storage; in SLiM's tables the new edges
+	// belong to younger parents and thus mostly sort to the front, so in practice this slides the old edges down as a block
+	tsk_size_t new_edge_count = edge_count - p_sorted_edge_count;
+	std::vector<double> new_left(edges.left + p_sorted_edge_count, edges.left + edge_count);
+	std::vector<double> new_right(edges.right + p_sorted_edge_count, edges.right + edge_count);
+	std::vector<tsk_id_t> new_parent(edges.parent + p_sorted_edge_count, edges.parent + edge_count);
+	std::vector<tsk_id_t> new_child(edges.child + p_sorted_edge_count, edges.child + edge_count);
+	int64_t old_index = (int64_t)p_sorted_edge_count - 1;
+	int64_t new_index = (int64_t)new_edge_count - 1;
+	int64_t dest_index = (int64_t)edge_count - 1;
+	
+	while (new_index >= 0)
+	{
+		if ((old_index >= 0) &&
+			(_CompareTreeSeqEdges(node_time[edges.parent[old_index]], edges.parent[old_index], edges.child[old_index], edges.left[old_index],
+								  node_time[new_parent[new_index]], new_parent[new_index], new_child[new_index], new_left[new_index]) > 0))
+		{
+			edges.left[dest_index] = edges.left[old_index];
+			edges.right[dest_index] = edges.right[old_index];
+			edges.parent[dest_index] = edges.parent[old_index];
+			edges.child[dest_index] = edges.child[old_index];
+			old_index--;
+		}
+		else
+		{
+			edges.left[dest_index] = new_left[new_index];
+			edges.right[dest_index] = new_right[new_index];
+			edges.parent[dest_index] = new_parent[new_index];
+			edges.child[dest_index] = new_child[new_index];
+			new_index--;
+		}
+		
+		dest_index--;
+	}
+	
+	return 0;
+}
+
+void SLiMSim::SortTreeSequenceTables(tsk_table_collection_t *p_tables, tsk_size_t p_sorted_edge_count)
+{
+	// _SortTreeSequenceTables() returns errors rather than raising, so that it can be used on the async simplification thread
+	int ret = _SortTreeSequenceTables(p_tables, p_sorted_edge_count);
+	if (ret < 0) handle_error("tsk_table_collection_sort", ret);
+}
+
 void SLiMSim::SimplifyTreeSequence(void)
 {
 #if DEBUG
@@ -4725,6 +4952,12 @@ void SLiMSim::SimplifyTreeSequence(void)
 		EIDOS_TERMINATION << "ERROR (SLiMSim::SimplifyTreeSequence): (internal error) tree sequence recording method called with recording off." << EidosTerminate();
 #endif
 	
+	// buffered rows, and a simplification in progress on the async thread, have to be spliced in before the tables can be simplified again
+	FlushRecordingBuffers();
+	
+	if (async_simplify_pending_)
+		FinishAsyncSimplification();
+	
 	if (tables_.nodes.num_rows == 0)
 		return;
 	
@@ -4764,18 +4997,23 @@ void SLiMSim::SimplifyTreeSequence(void)
 	// the tables need to have a population table to be able to sort it
 	WritePopulationTable(&tables_);
 	
-	// sort the table collection
-	int ret = tsk_table_collection_sort(&tables_, /* edge_start */ 0, /* flags */ 0);
-	if (ret < 0) handle_error("tsk_table_collection_sort", ret);
+	// sort the table collection; only the edges recorded since the last simplify need to be sorted
+	SortTreeSequenceTables(&tables_, sorted_edge_count_);
 	
 	// remove redundant sites we added
-	ret = tsk_table_collection_deduplicate_sites(&tables_, 0);
+	int ret = tsk_table_collection_deduplicate_sites(&tables_, 0);
 	if (ret < 0) handle_error("tsk_table_collection_deduplicate_sites", ret);
 	
 	// simplify
 	ret = tsk_table_collection_simplify(&tables_, samples.data(), (tsk_size_t)samples.size(), TSK_FILTER_SITES | TSK_FILTER_INDIVIDUALS, NULL);
 	if (ret != 0) handle_error("tsk_table_collection_simplify", ret);
 	
+	// simplify leaves the edge table sorted, so the next sort only needs to handle edges recorded after this point
+	sorted_edge_count_ = tables_.edges.num_rows;
+	
+	// drop derived-state dictionary entries for mutation rows that simplify has removed, if enough have accumulated
+	CollectDerivedStateDictionary();
+	
 	// update map of remembered_genomes_, which are now the first n entries in the node table
 	for (tsk_id_t i = 0; i < (tsk_id_t)remembered_genomes_.size(); i++)
 		remembered_genomes_[i] = i;
@@ -4786,6 +5024,9 @@ void SLiMSim::SimplifyTreeSequence(void)
 	// and reset our elapsed time since last simplification, for auto-simplification
 	simplify_elapsed_ = 0;
 	
+	// growth projected by CheckMemoryLimitSimplification() is measured from the simplified tables, whatever prompted the simplification
+	memory_limit_last_bytes_ = TreeSeqBytesInUse();
+	
 	// as a side effect of simplification, update a "model has coalesced" flag that the user can consult, if requested
 	if (running_coalescence_checks_)
 		CheckCoalescenceAfterSimplification();
@@ -4897,287 +5138,1344 @@ void SLiMSim::CheckCoalescenceAfterSimplification(void)
 	last_coalescence_state_ = fully_coalesced;
 }
 
-void SLiMSim::RecordTablePosition(void)
+void SLiMSim::TreeSequenceStatisticsSamples(EidosValue *p_subpops_value, std::vector<tsk_id_t> &p_samples, const char *p_caller_name)
 {
-	// keep the current table position for rewinding if a proposed child is rejected
-	tsk_table_collection_record_num_rows(&tables_, &table_position_);
+	// Collect the tree-sequence node ids of the extant genomes in the given subpopulations (all subpopulations if p_subpops_value is NULL)
+	// into p_samples, in subpopulation order; null genomes carry no sequence and are skipped.  The caller's name is used in errors.
+	std::vector<Subpopulation *> subpops;
+	
+	if (p_subpops_value->Type() == EidosValueType::kValueNULL)
+	{
+		for (auto subpop_iter : population_.subpops_)
+			subpops.push_back(subpop_iter.second);
+	}
+	else
+	{
+		int requested_subpop_count = p_subpops_value->Count();
+		
+		for (int requested_subpop_index = 0; requested_subpop_index < requested_subpop_count; ++requested_subpop_index)
+		{
+			Subpopulation *subpop = (Subpopulation *)(p_subpops_value->ObjectElementAtIndex(requested_subpop_index, nullptr));
+			
+			if (std::find(subpops.begin(), subpops.end(), subpop) != subpops.end())
+				EIDOS_TERMINATION << "ERROR (SLiMSim::TreeSequenceStatisticsSamples): " << p_caller_name << "() requires that each subpopulation be given only once." << EidosTerminate();
+			
+			subpops.push_back(subpop);
+		}
+	}
+	
+	for (Subpopulation *subpop : subpops)
+	{
+		std::vector<Genome *> &genomes = subpop->parent_genomes_;
+		slim_popsize_t genome_count = subpop->parent_subpop_size_ * 2;
+		Genome **genome_ptr = genomes.data();
+		
+		for (slim_popsize_t genome_index = 0; genome_index < genome_count; ++genome_index)
+		{
+			Genome *genome = genome_ptr[genome_index];
+			
+			if (!genome->IsNull())
+				p_samples.push_back(genome->tsk_node_id_);
+		}
+	}
 }
 
-void SLiMSim::AllocateTreeSequenceTables(void)
+void SLiMSim::TreeSequenceForStatistics(std::vector<tsk_id_t> &p_samples, tsk_table_collection_t *p_tables, tsk_treeseq_t *p_ts)
 {
-#if DEBUG
-	if (!recording_tree_)
-		EIDOS_TERMINATION << "ERROR (SLiMSim::AllocateTreeSequenceTables): (internal error) tree sequence recording method called with recording off." << EidosTerminate();
-#endif
+	// Build, in p_tables and p_ts, a tree sequence simplified down to p_samples, for computing statistics without touching tables_.
+	// After simplification the samples are nodes 0..n-1 in the order given, so p_ts->samples lists them in that order.  This follows
+	// CrosscheckTreeSeqIntegrity(), except that derived states are expanded after simplification, when there are fewer rows to expand.
+	// The caller owns p_tables and p_ts afterwards, and must free them.
+	int ret;
 	
-	// Set up the table collection before loading a saved population or starting a simulation
+	// the tables must be complete, so buffered rows and any simplification in progress on the async thread have to be spliced in first
+	FlushRecordingBuffers();
 	
-	//INITIALIZE NODE AND EDGE TABLES.
-	int ret = tsk_table_collection_init(&tables_, 0);
-	if (ret != 0) handle_error("AllocateTreeSequenceTables()", ret);
+	if (async_simplify_pending_)
+		FinishAsyncSimplification();
 	
-	tables_.sequence_length = (double)chromosome_.last_position_ + 1;
+	ret = tsk_table_collection_copy(&tables_, p_tables, 0);
+	if (ret < 0) handle_error("TreeSequenceForStatistics tsk_table_collection_copy()", ret);
 	
-	RecordTablePosition();
-}
-
-void SLiMSim::SetCurrentNewIndividual(__attribute__((unused))Individual *p_individual)
-{
-#if DEBUG
-	if (!recording_tree_)
-		EIDOS_TERMINATION << "ERROR (SLiMSim::SetCurrentNewIndividual): (internal error) tree sequence recording method called with recording off." << EidosTerminate();
-#endif
+	// our tables copy needs to have a population table now, since this is required to build a tree sequence
+	WritePopulationTable(p_tables);
 	
-	// This is called by code where new individuals are created
+	// the copy has the same edge order as tables_, so the same sorted prefix applies
+	SortTreeSequenceTables(p_tables, sorted_edge_count_);
 	
-	// Remember the new individual being defined; we don't need this right now,
-	// but it seems to keep coming back, so I've kept the code for it...
-	//current_new_individual_ = p_individual;
+	ret = tsk_table_collection_deduplicate_sites(p_tables, 0);
+	if (ret < 0) handle_error("TreeSequenceForStatistics tsk_table_collection_deduplicate_sites()", ret);
 	
-	// Remember the current table position so we can return to it later in RetractNewIndividual()
-    RecordTablePosition();
-}
-
-void SLiMSim::RetractNewIndividual()
-{
-#if DEBUG
-	if (!recording_tree_)
-		EIDOS_TERMINATION << "ERROR (SLiMSim::RetractNewIndividual): (internal error) tree sequence recording method called with recording off." << EidosTerminate();
-#endif
+	ret = tsk_table_collection_simplify(p_tables, p_samples.data(), (tsk_size_t)p_samples.size(), TSK_FILTER_SITES | TSK_FILTER_INDIVIDUALS, NULL);
+	if (ret != 0) handle_error("TreeSequenceForStatistics tsk_table_collection_simplify()", ret);
 	
-	// This is called when a new child, introduced by SetCurrentNewIndividual(), gets rejected by a modifyChild()
-	// callback.  We will have logged recombination breakpoints and new mutations into our tables, and now want
-	// to back those changes out by re-setting the active row index for the tables.
+	// alleles are compared by their mutation ids, so the derived states need to be in their full form, not derived-state dictionary indices
+	ExpandDerivedStates(p_tables);
 	
-	// We presently don't use current_new_individual_ any more, but I've kept
-	// around the code since it seems to keep coming back...
-	//current_new_individual_ = nullptr;
+	// must build indexes before compute mutation parents
+	ret = tsk_table_collection_build_index(p_tables, 0);
+	if (ret < 0) handle_error("TreeSequenceForStatistics tsk_table_collection_build_index()", ret);
 	
-    tsk_table_collection_truncate(&tables_, &table_position_);
+	ret = tsk_table_collection_compute_mutation_parents(p_tables, 0);
+	if (ret < 0) handle_error("TreeSequenceForStatistics tsk_table_collection_compute_mutation_parents()", ret);
+	
+	ret = tsk_treeseq_init(p_ts, p_tables, TSK_BUILD_INDEXES);
+	if (ret != 0) handle_error("TreeSequenceForStatistics tsk_treeseq_init()", ret);
 }
 
-void SLiMSim::RecordNewGenome(std::vector<slim_position_t> *p_breakpoints, Genome *p_new_genome, 
-        const Genome *p_initial_parental_genome, const Genome *p_second_parental_genome)
+static void _AccumulateAlleleCounts(double p_weight, const std::vector<double> &p_counts_1, const std::vector<double> &p_counts_2, double p_n_1, double p_n_2, double *p_diversity_1, double *p_diversity_2, double *p_divergence, std::vector<double> *p_sfs_1)
 {
-#if DEBUG
-	if (!recording_tree_)
-		EIDOS_TERMINATION << "ERROR (SLiMSim::RecordNewGenome): (internal error) tree sequence recording method called with recording off." << EidosTerminate();
-#endif
-	
-    // This records information about an individual in both the Node and Edge tables.
-
-	// Note that the breakpoints vector provided may (or may not) contain a breakpoint, as the final breakpoint in the vector, that is beyond
-	// the end of the chromosome.  This is for bookkeeping in the crossover-mutation code and should be ignored, as the code below does.
-	// The breakpoints vector may be nullptr (indicating no recombination), but if it exists it will be sorted in ascending order.
-
-	// add genome node; we mark all nodes with TSK_NODE_IS_SAMPLE here because we have full genealogical information on all of them
-	// (until simplify, which clears TSK_NODE_IS_SAMPLE from nodes that are not kept in the sample).
-	double time = (double) -1 * (tree_seq_generation_ + tree_seq_generation_offset_);	// see Population::AddSubpopulationSplit() regarding tree_seq_generation_offset_
-	uint32_t flags = TSK_NODE_IS_SAMPLE;
-	GenomeMetadataRec metadata_rec;
+	// Add the contribution of one site (or one branch, with its derived and ancestral sides as two alleles) to each statistic requested.
+	// Element 0 of the counts is the ancestral allele; the counts in each sample set sum to that set's size.  The diversity terms are the
+	// probability that two genomes drawn without replacement from a set differ, and the divergence term the probability that two genomes
+	// drawn one from each set differ.
+	size_t allele_count = p_counts_1.size();
 	
-	MetadataForGenome(p_new_genome, &metadata_rec);
+	if (p_diversity_1 && (p_n_1 >= 2))
+	{
+		double identity = 0.0;
+		
+		for (size_t allele_index = 0; allele_index < allele_count; ++allele_index)
+			identity += p_counts_1[allele_index] * (p_counts_1[allele_index] - 1);
+		
+		*p_diversity_1 += p_weight * (1.0 - identity / (p_n_1 * (p_n_1 - 1)));
+	}
 	
-	const char *metadata = (char *)&metadata_rec;
-	size_t metadata_length = sizeof(GenomeMetadataRec)/sizeof(char);
-	tsk_id_t offspringTSKID = tsk_node_table_add_row(&tables_.nodes, flags, time, (tsk_id_t)p_new_genome->subpop_->subpopulation_id_,
-                                        TSK_NULL, metadata, (tsk_size_t)metadata_length);
+	if (p_diversity_2 && (p_n_2 >= 2))
+	{
+		double identity = 0.0;
+		
+		for (size_t allele_index = 0; allele_index < allele_count; ++allele_index)
+			identity += p_counts_2[allele_index] * (p_counts_2[allele_index] - 1);
+		
+		*p_diversity_2 += p_weight * (1.0 - identity / (p_n_2 * (p_n_2 - 1)));
+	}
 	
-	p_new_genome->tsk_node_id_ = offspringTSKID;
+	if (p_divergence && (p_n_1 >= 1) && (p_n_2 >= 1))
+	{
+		double identity = 0.0;
+		
+		for (size_t allele_index = 0; allele_index < allele_count; ++allele_index)
+			identity += p_counts_1[allele_index] * p_counts_2[allele_index];
+		
+		*p_divergence += p_weight * (1.0 - identity / (p_n_1 * p_n_2));
+	}
 	
-    // if there is no parent then no need to record edges
-	if (!p_initial_parental_genome && !p_second_parental_genome)
-		return;
+	if (p_sfs_1)
+	{
+		for (size_t allele_index = 1; allele_index < allele_count; ++allele_index)
+			(*p_sfs_1)[(size_t)p_counts_1[allele_index]] += p_weight;
+	}
+}
+
+static void _AccumulateBranchStatistics(tsk_treeseq_t *p_ts, tsk_size_t p_sample_count_1, double *p_diversity_1, double *p_diversity_2, double *p_divergence, std::vector<double> *p_sfs_1)
+{
+	// Add the branch-mode contribution of every branch in p_ts to each statistic requested, as in tskit's general branch statistics.
+	// Rather than visiting every node of every tree, we walk the edge insertions and removals between trees, keeping for each node its
+	// parent and the number of samples of each set below it.  A branch's contribution depends only upon those, so it is accumulated
+	// lazily: each node records the position at which its branch last changed, and when its parent or its counts are about to change,
+	// the branch is credited for the span since then.  Only the nodes whose branches actually change are touched, which for a tree
+	// sequence of many similar trees is a small fraction of the nodes in each tree.
+	const tsk_table_collection_t *tables = p_ts->tables;
+	tsk_size_t node_count = tables->nodes.num_rows;
+	tsk_size_t edge_count = tables->edges.num_rows;
+	const double *node_time = tables->nodes.time;
+	const double *edge_left = tables->edges.left;
+	const double *edge_right = tables->edges.right;
+	const tsk_id_t *edge_parent = tables->edges.parent;
+	const tsk_id_t *edge_child = tables->edges.child;
+	const tsk_id_t *insertion_order = tables->indexes.edge_insertion_order;
+	const tsk_id_t *removal_order = tables->indexes.edge_removal_order;
+	double sequence_length = tables->sequence_length;
+	double n_1 = (double)p_sample_count_1;
+	double n_2 = (double)(p_ts->num_samples - p_sample_count_1);
+	std::vector<tsk_id_t> parent(node_count, TSK_NULL);
+	std::vector<double> below_1(node_count, 0.0), below_2(node_count, 0.0);
+	std::vector<double> last_update(node_count, 0.0);
+	std::vector<double> counts_1, counts_2;
 	
-	// map the Parental Genome SLiM Id's to TSK IDs.
-	tsk_id_t genome1TSKID = p_initial_parental_genome->tsk_node_id_;
-	tsk_id_t genome2TSKID = (!p_second_parental_genome) ? genome1TSKID : p_second_parental_genome->tsk_node_id_;
+	for (tsk_size_t sample_index = 0; sample_index < p_ts->num_samples; ++sample_index)
+	{
+		if (sample_index < p_sample_count_1)
+			below_1[p_ts->samples[sample_index]] = 1.0;
+		else
+			below_2[p_ts->samples[sample_index]] = 1.0;
+	}
 	
-	// fix possible excess past-the-end breakpoint
-	size_t breakpoint_count = (p_breakpoints ? p_breakpoints->size() : 0);
+	// credit the branch above p_node for the span since it last changed, up to p_position
+	auto flush_branch = [&](tsk_id_t p_node, double p_position) {
+		tsk_id_t node_parent = parent[p_node];
+		
+		if ((node_parent != TSK_NULL) && (below_1[p_node] + below_2[p_node] != 0) && (p_position > last_update[p_node]))
+		{
+			counts_1.assign({n_1 - below_1[p_node], below_1[p_node]});
+			counts_2.assign({n_2 - below_2[p_node], below_2[p_node]});
+			
+			_AccumulateAlleleCounts((p_position - last_update[p_node]) * (node_time[node_parent] - node_time[p_node]), counts_1, counts_2, n_1, n_2, p_diversity_1, p_diversity_2, p_divergence, p_sfs_1);
+		}
+		
+		last_update[p_node] = p_position;
+	};
 	
-	if (breakpoint_count && (p_breakpoints->back() > chromosome_.last_position_))
-		breakpoint_count--;
+	// add p_delta_1 and p_delta_2 to the counts of p_node and all of its ancestors, flushing each branch before its counts change
+	auto update_counts = [&](tsk_id_t p_node, double p_delta_1, double p_delta_2, double p_position) {
+		for (tsk_id_t node = p_node; node != TSK_NULL; node = parent[node])
+		{
+			flush_branch(node, p_position);
+			below_1[node] += p_delta_1;
+			below_2[node] += p_delta_2;
+		}
+	};
 	
-	// add an edge for each interval between breakpoints
-	double left = 0.0;
-	double right;
-	bool polarity = true;
+	tsk_size_t insertion_index = 0, removal_index = 0;
+	double tree_left = 0.0;
 	
-	for (size_t i = 0; i < breakpoint_count; i++)
+	while ((insertion_index < edge_count) || (tree_left < sequence_length))
 	{
-		right = (*p_breakpoints)[i];
-
-		tsk_id_t parent = (tsk_id_t) (polarity ? genome1TSKID : genome2TSKID);
-		int ret = tsk_edge_table_add_row(&tables_.edges,left,right,parent,offspringTSKID);
-		if (ret < 0) handle_error("add_edge", ret);
+		while ((removal_index < edge_count) && (edge_right[removal_order[removal_index]] == tree_left))
+		{
+			tsk_id_t edge = removal_order[removal_index++];
+			tsk_id_t child = edge_child[edge];
+			
+			flush_branch(child, tree_left);
+			parent[child] = TSK_NULL;
+			update_counts(edge_parent[edge], -below_1[child], -below_2[child], tree_left);
+		}
 		
-		polarity = !polarity;
-		left = right;
+		while ((insertion_index < edge_count) && (edge_left[insertion_order[insertion_index]] == tree_left))
+		{
+			tsk_id_t edge = insertion_order[insertion_index++];
+			tsk_id_t child = edge_child[edge];
+			
+			flush_branch(child, tree_left);
+			parent[child] = edge_parent[edge];
+			update_counts(edge_parent[edge], below_1[child], below_2[child], tree_left);
+		}
+		
+		double tree_right = sequence_length;
+		
+		if (insertion_index < edge_count)
+			tree_right = std::min(tree_right, edge_left[insertion_order[insertion_index]]);
+		if (removal_index < edge_count)
+			tree_right = std::min(tree_right, edge_right[removal_order[removal_index]]);
+		
+		tree_left = tree_right;
 	}
 	
-	right = (double)chromosome_.last_position_+1;
-	tsk_id_t parent = (tsk_id_t) (polarity ? genome1TSKID : genome2TSKID);
-	int ret = tsk_edge_table_add_row(&tables_.edges,left,right,parent,offspringTSKID);
-	if (ret < 0) handle_error("add_edge", ret);
+	// credit every branch still present for the span remaining to the end of the sequence
+	for (tsk_id_t node = 0; node < (tsk_id_t)node_count; ++node)
+		flush_branch(node, sequence_length);
 }
 
-void SLiMSim::RecordNewDerivedState(const Genome *p_genome, slim_position_t p_position, const std::vector<Mutation *> &p_derived_mutations)
+void SLiMSim::TreeSequenceStatistics(tsk_treeseq_t *p_ts, tsk_size_t p_sample_count_1, bool p_branch_mode, double *p_diversity_1, double *p_diversity_2, double *p_divergence, std::vector<double> *p_sfs_1)
 {
-#if DEBUG
-	if (!recording_mutations_)
-		EIDOS_TERMINATION << "ERROR (SLiMSim::RecordNewDerivedState): (internal error) tree sequence mutation recording method called with recording off." << EidosTerminate();
-#endif
+	// Compute the requested statistics (those with non-NULL pointers) in one pass along p_ts, which should come from
+	// TreeSequenceForStatistics().  The first p_sample_count_1 samples of p_ts are sample set 1, the rest are sample set 2.  In site
+	// mode we track set 1, so below any node the set 1 count is num_tracked_samples and the set 2 count is the remainder of num_samples.
+	// In site mode the alleles at a site are its distinct derived states plus the (empty) ancestral state, and a mutation's derived
+	// state is carried by the samples below it that are not below a later mutation at the site; sites need not be biallelic, since
+	// SLiM stacks mutations and records more than one mutation per site.  In branch mode every branch, weighted by its length in
+	// generations times the span over which it exists, divides the samples into those below it and the rest; see
+	// _AccumulateBranchStatistics().  Diversity and divergence are given per unit of sequence length; the site frequency spectrum
+	// of set 1 is a total over the sequence, indexed by allele count.
+	double n_1 = (double)p_sample_count_1;
+	double n_2 = (double)(p_ts->num_samples - p_sample_count_1);
+	double diversity_1 = 0.0, diversity_2 = 0.0, divergence = 0.0;
+	std::vector<double> counts_1, counts_2;
+	std::vector<const tsk_mutation_t *> allele_mutations;	// for each derived allele, a mutation with that derived state
 	
-    // This records information in the Site and Mutation tables.
-    // This is called whenever a new mutation is added to a genome.  Because
-    // mutation stacking makes things complicated, this hook supplies not just
-    // the new mutation, but the entire new derived state – all of the
-    // mutations that exist at the given position in the given genome,
-    // post-addition.  This derived state may involve the removal of some
-    // ancestral mutations (or may not), in addition to the new mutation that
-    // was added.  The new state is not even guaranteed to be different from
-    // the ancestral state; because of the way new mutations are added in some
-    // paths (with bulk operations) we may not know.  This method will also be
-    // called when a mutation is removed from a given genome; if no mutations
-    // remain at the given position, p_derived_mutations will be empty.  The
-    // vector of mutations passed in here is reused internally, so this method
-    // must not keep a pointer to it; any information that needs to be kept
-    // from it must be copied out.  See treerec/implementation.md for more.
+	if (p_sfs_1)
+		p_sfs_1->assign(p_sample_count_1 + 1, 0.0);
 	
-	// BCH 4/29/2018: Null genomes should never contain any mutations at all,
-	// including fixed mutations; the simplest thing is to just disallow derived
-	// states for them altogether.
-	if (p_genome->IsNull())
+	if (p_branch_mode)
+	{
+		_AccumulateBranchStatistics(p_ts, p_sample_count_1, p_diversity_1 ? &diversity_1 : nullptr, p_diversity_2 ? &diversity_2 : nullptr, p_divergence ? &divergence : nullptr, p_sfs_1);
+	}
+	else
+	{
+		tsk_tree_t tree;
+		int ret;
+		
+		ret = tsk_tree_init(&tree, p_ts, TSK_SAMPLE_COUNTS);
+		if (ret < 0) handle_error("TreeSequenceStatistics tsk_tree_init()", ret);
+		
+		ret = tsk_tree_set_tracked_samples(&tree, p_sample_count_1, p_ts->samples);
+		if (ret < 0) handle_error("TreeSequenceStatistics tsk_tree_set_tracked_samples()", ret);
+		
+		for (ret = tsk_tree_first(&tree); ret == 1; ret = tsk_tree_next(&tree))
+		{
+			for (tsk_size_t site_index = 0; site_index < tree.sites_length; ++site_index)
+			{
+				tsk_site_t &site = tree.sites[site_index];
+				
+				counts_1.assign(1, n_1);
+				counts_2.assign(1, n_2);
+				allele_mutations.clear();
+				
+				for (tsk_size_t mut_index = 0; mut_index < site.mutations_length; ++mut_index)
+				{
+					const tsk_mutation_t &mutation = site.mutations[mut_index];
+					double carriers_1 = tree.num_tracked_samples[mutation.node];
+					double carriers_2 = tree.num_samples[mutation.node] - carriers_1;
+					
+					for (tsk_size_t child_index = 0; child_index < site.mutations_length; ++child_index)
+					{
+						const tsk_mutation_t &child = site.mutations[child_index];
+						
+						if (child.parent == mutation.id)
+						{
+							double child_below_1 = tree.num_tracked_samples[child.node];
+							
+							carriers_1 -= child_below_1;
+							carriers_2 -= tree.num_samples[child.node] - child_below_1;
+						}
+					}
+					
+					if (carriers_1 + carriers_2 == 0)
+						continue;
+					
+					// find the allele for this derived state; the empty derived state is the ancestral state, allele 0
+					size_t allele_index = 0;
+					
+					if (mutation.derived_state_length != 0)
+					{
+						for (allele_index = 1; allele_index <= allele_mutations.size(); ++allele_index)
+						{
+							const tsk_mutation_t *allele_mutation = allele_mutations[allele_index - 1];
+							
+							if ((allele_mutation->derived_state_length == mutation.derived_state_length) && (memcmp(allele_mutation->derived_state, mutation.derived_state, mutation.derived_state_length) == 0))
+								break;
+						}
+						
+						if (allele_index > allele_mutations.size())
+						{
+							allele_mutations.push_back(&mutation);
+							counts_1.push_back(0.0);
+							counts_2.push_back(0.0);
+						}
+					}
+					
+					counts_1[allele_index] += carriers_1;
+					counts_2[allele_index] += carriers_2;
+					counts_1[0] -= carriers_1;
+					counts_2[0] -= carriers_2;
+				}
+				
+				if (counts_1.size() > 1)
+					_AccumulateAlleleCounts(1.0, counts_1, counts_2, n_1, n_2, p_diversity_1 ? &diversity_1 : nullptr, p_diversity_2 ? &diversity_2 : nullptr, p_divergence ? &divergence : nullptr, p_sfs_1);
+			}
+		}
+		if (ret < 0) handle_error("TreeSequenceStatistics tsk_tree_next()", ret);
+		
+		ret = tsk_tree_free(&tree);
+		if (ret < 0) handle_error("TreeSequenceStatistics tsk_tree_free()", ret);
+	}
+	
+	double sequence_length = p_ts->tables->sequence_length;
+	
+	if (p_diversity_1)
+		*p_diversity_1 = ((n_1 >= 2) ? diversity_1 / sequence_length : std::numeric_limits<double>::quiet_NaN());
+	if (p_diversity_2)
+		*p_diversity_2 = ((n_2 >= 2) ? diversity_2 / sequence_length : std::numeric_limits<double>::quiet_NaN());
+	if (p_divergence)
+		*p_divergence = (((n_1 >= 1) && (n_2 >= 1)) ? divergence / sequence_length : std::numeric_limits<double>::quiet_NaN());
+}
+
+void SLiMSim::TreeSequenceR2(tsk_treeseq_t *p_ts, const std::vector<double> &p_positions, std::vector<double> &p_r2)
+{
+	// Compute r^2 between every pair of the given positions across the samples of p_ts, as a row-major matrix in p_r2.  Sites in SLiM
+	// are often multiallelic, so each site is reduced to whether or not a genome carries its most common allele; a position with no
+	// site, or whose site is monomorphic in the samples, gets NAN, since r^2 is undefined for it.
+	size_t position_count = p_positions.size();
+	tsk_size_t sample_count = p_ts->num_samples;
+	std::unordered_multimap<double, size_t> position_indices;
+	std::vector<std::vector<uint8_t>> carries_major(position_count);
+	std::vector<double> major_count(position_count, (double)sample_count);	// no site means all genomes are ancestral, which is monomorphic
+	std::vector<tsk_size_t> genotype_counts;
+	int ret;
+	
+	for (size_t position_index = 0; position_index < position_count; ++position_index)
+		position_indices.emplace(p_positions[position_index], position_index);
+	
+	tsk_vargen_t vargen;
+	
+	ret = tsk_vargen_init(&vargen, p_ts, p_ts->samples, sample_count, TSK_16_BIT_GENOTYPES);
+	if (ret != 0) handle_error("TreeSequenceR2 tsk_vargen_init()", ret);
+	
+	while (true)
+	{
+		tsk_variant_t *variant;
+		
+		ret = tsk_vargen_next(&vargen, &variant);
+		if (ret < 0) handle_error("TreeSequenceR2 tsk_vargen_next()", ret);
+		if (ret == 0)
+			break;
+		
+		auto position_range = position_indices.equal_range(variant->site->position);
+		
+		if (position_range.first == position_range.second)
+			continue;
+		
+		// find the most common allele at this site, and which samples carry it
+		genotype_counts.assign(variant->num_alleles, 0);
+		
+		for (tsk_size_t sample_index = 0; sample_index < sample_count; ++sample_index)
+			genotype_counts[variant->genotypes.u16[sample_index]]++;
+		
+		uint16_t major_allele = (uint16_t)(std::max_element(genotype_counts.begin(), genotype_counts.end()) - genotype_counts.begin());
+		std::vector<uint8_t> carriers(sample_count);
+		
+		for (tsk_size_t sample_index = 0; sample_index < sample_count; ++sample_index)
+			carriers[sample_index] = (variant->genotypes.u16[sample_index] == major_allele);
+		
+		for (auto position_iter = position_range.first; position_iter != position_range.second; ++position_iter)
+		{
+			carries_major[position_iter->second] = carriers;
+			major_count[position_iter->second] = (double)genotype_counts[major_allele];
+		}
+	}
+	
+	ret = tsk_vargen_free(&vargen);
+	if (ret != 0) handle_error("TreeSequenceR2 tsk_vargen_free()", ret);
+	
+	// r^2 is computed from counts rather than frequencies, which keeps it exact in more cases (such as r^2 == 1 on the diagonal)
+	double n = (double)sample_count;
+	
+	p_r2.resize(position_count * position_count);
+	
+	for (size_t position_index_1 = 0; position_index_1 < position_count; ++position_index_1)
+	{
+		for (size_t position_index_2 = position_index_1; position_index_2 < position_count; ++position_index_2)
+		{
+			double count_1 = major_count[position_index_1];
+			double count_2 = major_count[position_index_2];
+			double denominator = (count_1 * (n - count_1)) * (count_2 * (n - count_2));
+			double r2 = std::numeric_limits<double>::quiet_NaN();
+			
+			if (denominator > 0.0)
+			{
+				const std::vector<uint8_t> &carriers_1 = carries_major[position_index_1];
+				const std::vector<uint8_t> &carriers_2 = carries_major[position_index_2];
+				tsk_size_t joint_count = 0;
+				
+				for (tsk_size_t sample_index = 0; sample_index < sample_count; ++sample_index)
+					joint_count += (carriers_1[sample_index] & carriers_2[sample_index]);
+				
+				double D = n * joint_count - count_1 * count_2;		// n^2 times the usual D
+				
+				r2 = (D * D) / denominator;
+			}
+			
+			p_r2[position_index_1 * position_count + position_index_2] = r2;
+			p_r2[position_index_2 * position_count + position_index_1] = r2;
+		}
+	}
+}
+
+void SLiMSim::RecordTablePosition(void)
+{
+	// keep the current table position for rewinding if a proposed child is rejected
+	tsk_table_collection_record_num_rows(&tables_, &table_position_);
+	
+	// rows still sitting in the recording buffers count as part of the tables; see FlushRecordingBuffers()
+	table_position_.nodes += (tsk_size_t)rec_node_flags_.size();
+	table_position_.edges += (tsk_size_t)rec_edge_left_.size();
+	table_position_.sites += (tsk_size_t)rec_site_position_.size();
+	table_position_.mutations += (tsk_size_t)rec_mut_node_.size();
+}
+
+void SLiMSim::AllocateTreeSequenceTables(void)
+{
+#if DEBUG
+	if (!recording_tree_)
+		EIDOS_TERMINATION << "ERROR (SLiMSim::AllocateTreeSequenceTables): (internal error) tree sequence recording method called with recording off." << EidosTerminate();
+#endif
+	
+	// Set up the table collection before loading a saved population or starting a simulation
+	
+	//INITIALIZE NODE AND EDGE TABLES.
+	int ret = tsk_table_collection_init(&tables_, 0);
+	if (ret != 0) handle_error("AllocateTreeSequenceTables()", ret);
+	
+	tables_.sequence_length = (double)chromosome_.last_position_ + 1;
+	
+	RecordTablePosition();
+	
+	// the growth projected by CheckMemoryLimitSimplification() is measured from here until the first simplification
+	memory_limit_last_bytes_ = TreeSeqBytesInUse();
+}
+
+void SLiMSim::SetCurrentNewIndividual(__attribute__((unused))Individual *p_individual)
+{
+#if DEBUG
+	if (!recording_tree_)
+		EIDOS_TERMINATION << "ERROR (SLiMSim::SetCurrentNewIndividual): (internal error) tree sequence recording method called with recording off." << EidosTerminate();
+#endif
+	
+	// This is called by code where new individuals are created
+	
+	// Remember the new individual being defined; we don't need this right now,
+	// but it seems to keep coming back, so I've kept the code for it...
+	//current_new_individual_ = p_individual;
+	
+	// Remember the current table position so we can return to it later in RetractNewIndividual()
+    RecordTablePosition();
+}
+
+void SLiMSim::RetractNewIndividual()
+{
+#if DEBUG
+	if (!recording_tree_)
+		EIDOS_TERMINATION << "ERROR (SLiMSim::RetractNewIndividual): (internal error) tree sequence recording method called with recording off." << EidosTerminate();
+#endif
+	
+	// This is called when a new child, introduced by SetCurrentNewIndividual(), gets rejected by a modifyChild()
+	// callback.  We will have logged recombination breakpoints and new mutations into our tables, and now want
+	// to back those changes out by re-setting the active row index for the tables.
+	
+	// We presently don't use current_new_individual_ any more, but I've kept
+	// around the code since it seems to keep coming back...
+	//current_new_individual_ = nullptr;
+	
+	// table_position_ includes buffered rows, so the buffers need to be in the tables before we truncate
+	FlushRecordingBuffers();
+	
+    tsk_table_collection_truncate(&tables_, &table_position_);
+}
+
+void SLiMSim::FlushRecordingBuffers(void)
+{
+	// Append the rows accumulated by RecordNewGenome() and RecordNewDerivedState() to tables_.  This reserves capacity in each
+	// table once and copies whole columns, rather than growing the tables row by row with bounds checks in add_row.  The rows
+	// that result are identical to those that add_row would have produced.
+	size_t node_count = rec_node_flags_.size();
+	size_t edge_count = rec_edge_left_.size();
+	size_t mut_count = rec_mut_node_.size();
+	int ret;
+	
+	if (node_count)
+	{
+		static std::vector<tsk_size_t> metadata_offset;
+		
+		metadata_offset.resize(node_count + 1);
+		for (size_t node_index = 0; node_index <= node_count; ++node_index)
+			metadata_offset[node_index] = (tsk_size_t)(node_index * sizeof(GenomeMetadataRec));
+		
+		ret = tsk_node_table_append_columns(&tables_.nodes, (tsk_size_t)node_count, rec_node_flags_.data(), rec_node_time_.data(),
+											rec_node_population_.data(), NULL, (const char *)rec_node_metadata_.data(), metadata_offset.data());
+		if (ret < 0) handle_error("tsk_node_table_append_columns", ret);
+	}
+	
+	if (edge_count)
+	{
+		ret = tsk_edge_table_append_columns(&tables_.edges, (tsk_size_t)edge_count, rec_edge_left_.data(), rec_edge_right_.data(),
+											rec_edge_parent_.data(), rec_edge_child_.data());
+		if (ret < 0) handle_error("tsk_edge_table_append_columns", ret);
+	}
+	
+	if (mut_count)
+	{
+		// each buffered mutation refers to its own new site, with empty ancestral state and metadata
+		static std::vector<tsk_size_t> empty_offset;
+		static std::vector<tsk_id_t> site_ids;
+		tsk_id_t first_site_id = (tsk_id_t)tables_.sites.num_rows;
+		char empty_state = 0;	// tskit requires a non-NULL ancestral state pointer even when its length is zero
+		
+		empty_offset.assign(mut_count + 1, 0);
+		site_ids.resize(mut_count);
+		for (size_t mut_index = 0; mut_index < mut_count; ++mut_index)
+			site_ids[mut_index] = first_site_id + (tsk_id_t)mut_index;
+		
+		ret = tsk_site_table_append_columns(&tables_.sites, (tsk_size_t)mut_count, rec_site_position_.data(), &empty_state, empty_offset.data(), NULL, NULL);
+		if (ret < 0) handle_error("tsk_site_table_append_columns", ret);
+		
+		// the metadata column is unused in memory; see DerivedStateDictionaryIndex().  tskit requires a non-NULL derived state pointer,
+		// which an empty vector might not provide if every buffered derived state is empty.
+		const char *derived_state = (rec_mut_derived_state_.size() ? (const char *)rec_mut_derived_state_.data() : &empty_state);
+		
+		ret = tsk_mutation_table_append_columns(&tables_.mutations, (tsk_size_t)mut_count, site_ids.data(), rec_mut_node_.data(), NULL,
+												derived_state, rec_mut_derived_state_offset_.data(), NULL, NULL);
+		if (ret < 0) handle_error("tsk_mutation_table_append_columns", ret);
+	}
+	
+	ClearRecordingBuffers();
+}
+
+void SLiMSim::ClearRecordingBuffers(void)
+{
+	// the buffers keep their capacity, so after the first few generations recording does not allocate
+	rec_node_flags_.clear();
+	rec_node_time_.clear();
+	rec_node_population_.clear();
+	rec_node_metadata_.clear();
+	rec_edge_left_.clear();
+	rec_edge_right_.clear();
+	rec_edge_parent_.clear();
+	rec_edge_child_.clear();
+	rec_site_position_.clear();
+	rec_mut_node_.clear();
+	rec_mut_derived_state_.clear();
+	rec_mut_derived_state_offset_.resize(1);
+}
+
+void SLiMSim::RecordNewGenome(std::vector<slim_position_t> *p_breakpoints, Genome *p_new_genome, 
+        const Genome *p_initial_parental_genome, const Genome *p_second_parental_genome)
+{
+#if DEBUG
+	if (!recording_tree_)
+		EIDOS_TERMINATION << "ERROR (SLiMSim::RecordNewGenome): (internal error) tree sequence recording method called with recording off." << EidosTerminate();
+#endif
+	
+    // This records information about an individual in both the Node and Edge tables.
+
+	// Note that the breakpoints vector provided may (or may not) contain a breakpoint, as the final breakpoint in the vector, that is beyond
+	// the end of the chromosome.  This is for bookkeeping in the crossover-mutation code and should be ignored, as the code below does.
+	// The breakpoints vector may be nullptr (indicating no recombination), but if it exists it will be sorted in ascending order.
+
+	// add genome node; we mark all nodes with TSK_NODE_IS_SAMPLE here because we have full genealogical information on all of them
+	// (until simplify, which clears TSK_NODE_IS_SAMPLE from nodes that are not kept in the sample).
+	// The node goes into the recording buffers, not directly into tables_; see FlushRecordingBuffers().  Its id is the row it will occupy.
+	double time = (double) -1 * (tree_seq_generation_ + tree_seq_generation_offset_);	// see Population::AddSubpopulationSplit() regarding tree_seq_generation_offset_
+	GenomeMetadataRec metadata_rec;
+	
+	MetadataForGenome(p_new_genome, &metadata_rec);
+	
+	tsk_id_t offspringTSKID = (tsk_id_t)(tables_.nodes.num_rows + rec_node_flags_.size());
+	
+	rec_node_flags_.push_back(TSK_NODE_IS_SAMPLE);
+	rec_node_time_.push_back(time);
+	rec_node_population_.push_back((tsk_id_t)p_new_genome->subpop_->subpopulation_id_);
+	rec_node_metadata_.push_back(metadata_rec);
+	
+	// while an asynchronous simplification is pending, tables_ holds only the new rows; see StartAsyncSimplification()
+	offspringTSKID += async_node_base_;
+	
+	p_new_genome->tsk_node_id_ = offspringTSKID;
+	
+    // if there is no parent then no need to record edges
+	if (!p_initial_parental_genome && !p_second_parental_genome)
+		return;
+	
+	// map the Parental Genome SLiM Id's to TSK IDs.
+	tsk_id_t genome1TSKID = p_initial_parental_genome->tsk_node_id_;
+	tsk_id_t genome2TSKID = (!p_second_parental_genome) ? genome1TSKID : p_second_parental_genome->tsk_node_id_;
+	
+	// fix possible excess past-the-end breakpoint
+	size_t breakpoint_count = (p_breakpoints ? p_breakpoints->size() : 0);
+	
+	if (breakpoint_count && (p_breakpoints->back() > chromosome_.last_position_))
+		breakpoint_count--;
+	
+	// add an edge for each interval between breakpoints
+	double left = 0.0;
+	double right;
+	bool polarity = true;
+	
+	for (size_t i = 0; i < breakpoint_count; i++)
+	{
+		right = (*p_breakpoints)[i];
+
+		tsk_id_t parent = (tsk_id_t) (polarity ? genome1TSKID : genome2TSKID);
+		rec_edge_left_.push_back(left);
+		rec_edge_right_.push_back(right);
+		rec_edge_parent_.push_back(parent);
+		rec_edge_child_.push_back(offspringTSKID);
+		
+		polarity = !polarity;
+		left = right;
+	}
+	
+	right = (double)chromosome_.last_position_+1;
+	tsk_id_t parent = (tsk_id_t) (polarity ? genome1TSKID : genome2TSKID);
+	rec_edge_left_.push_back(left);
+	rec_edge_right_.push_back(right);
+	rec_edge_parent_.push_back(parent);
+	rec_edge_child_.push_back(offspringTSKID);
+}
+
+void SLiMSim::RecordNewDerivedState(const Genome *p_genome, slim_position_t p_position, const std::vector<Mutation *> &p_derived_mutations)
+{
+#if DEBUG
+	if (!recording_mutations_)
+		EIDOS_TERMINATION << "ERROR (SLiMSim::RecordNewDerivedState): (internal error) tree sequence mutation recording method called with recording off." << EidosTerminate();
+#endif
+	
+    // This records information in the Site and Mutation tables.
+    // This is called whenever a new mutation is added to a genome.  Because
+    // mutation stacking makes things complicated, this hook supplies not just
+    // the new mutation, but the entire new derived state – all of the
+    // mutations that exist at the given position in the given genome,
+    // post-addition.  This derived state may involve the removal of some
+    // ancestral mutations (or may not), in addition to the new mutation that
+    // was added.  The new state is not even guaranteed to be different from
+    // the ancestral state; because of the way new mutations are added in some
+    // paths (with bulk operations) we may not know.  This method will also be
+    // called when a mutation is removed from a given genome; if no mutations
+    // remain at the given position, p_derived_mutations will be empty.  The
+    // vector of mutations passed in here is reused internally, so this method
+    // must not keep a pointer to it; any information that needs to be kept
+    // from it must be copied out.  See treerec/implementation.md for more.
+	
+	// BCH 4/29/2018: Null genomes should never contain any mutations at all,
+	// including fixed mutations; the simplest thing is to just disallow derived
+	// states for them altogether.
+	if (p_genome->IsNull())
 		EIDOS_TERMINATION << "ERROR (SLiMSim::RecordNewDerivedState): new derived states cannot be recorded for null genomes." << EidosTerminate();
 	
     tsk_id_t genomeTSKID = p_genome->tsk_node_id_;
 
     // Identify any previous mutations at this site in this genome, and add a new site.
 	// This site may already exist, but we add it anyway, and deal with that in deduplicate_sites().
+	// The site and mutation go into the recording buffers, not directly into tables_; see FlushRecordingBuffers().
     double tsk_position = (double) p_position;
 
-    tsk_id_t site_id = tsk_site_table_add_row(&tables_.sites, tsk_position, NULL, 0, NULL, 0);
-	
-    // form derived state
-	static std::vector<slim_mutationid_t> derived_mutation_ids;
-	static std::vector<MutationMetadataRec> mutation_metadata;
-	MutationMetadataRec metadata_rec;
+    rec_site_position_.push_back(tsk_position);
+	
+    // form derived state; each mutation in it is recorded as an index into the derived-state dictionary, which holds the mutation id
+	// and metadata that are written out for it (see ExpandDerivedStates()), so the metadata column is not used in memory
+	MutationMetadataRec metadata_rec;
+	
+	for (Mutation *mutation : p_derived_mutations)
+	{
+		MetadataForMutation(mutation, &metadata_rec);
+		rec_mut_derived_state_.push_back(DerivedStateDictionaryIndex(mutation->mutation_id_, metadata_rec));
+    }
+	
+	// find and incorporate any fixed mutations at this position, which exist in all new derived states but are not included by SLiM
+	// BCH 5/14/2019: Note that this means that derived states will be recorded that look "stacked" even when those mutations would
+	// not have stacked, by the stacking policy, had they occurred in the same genome at the same time.  So this is a bit weird.
+	// For example, you can end up with a derived state that appears to show two nucleotides stacked at the same position; but one
+	// fixed before the other one occurred, so they aren't stacked really, the new one just occurred on the ancestral background of
+	// the old one.  Possibly we ought to do something different about this (and not record a stacked derived state), but that
+	// would be a big change since it has implications for crosscheck, etc.  FIXME
+	auto position_range_iter = population_.treeseq_substitutions_map_.equal_range(p_position);
+	
+	for (auto position_iter = position_range_iter.first; position_iter != position_range_iter.second; ++position_iter)
+	{
+		Substitution *substitution = position_iter->second;
+		
+		MetadataForSubstitution(substitution, &metadata_rec);
+		rec_mut_derived_state_.push_back(DerivedStateDictionaryIndex(substitution->mutation_id_, metadata_rec));
+	}
+	
+	// finish the mutation row with the final derived state; its site is the one buffered above
+	rec_mut_node_.push_back(genomeTSKID);
+	rec_mut_derived_state_offset_.push_back((tsk_size_t)(rec_mut_derived_state_.size() * sizeof(uint32_t)));
+}
+
+uint32_t SLiMSim::DerivedStateDictionaryIndex(slim_mutationid_t p_mutation_id, const MutationMetadataRec &p_metadata)
+{
+	// A mutation's metadata can change over its lifetime (its selection coefficient can be changed, for example), so we reuse the
+	// latest entry for the mutation only if its metadata still matches; otherwise we make a new entry, which becomes the latest.
+	auto lookup_iter = derived_state_dict_lookup_.find(p_mutation_id);
+	
+	if (lookup_iter != derived_state_dict_lookup_.end())
+	{
+		uint32_t entry_index = lookup_iter->second;
+		
+		if (memcmp(&derived_state_dict_[entry_index].metadata_, &p_metadata, sizeof(MutationMetadataRec)) == 0)
+			return entry_index;
+	}
+	
+	if (derived_state_dict_.size() >= UINT32_MAX)
+		EIDOS_TERMINATION << "ERROR (SLiMSim::DerivedStateDictionaryIndex): too many distinct mutation states for tree-sequence recording." << EidosTerminate();
+	
+	uint32_t entry_index = (uint32_t)derived_state_dict_.size();
+	DerivedStateEntry entry;
+	
+	entry.mutation_id_ = p_mutation_id;
+	entry.metadata_ = p_metadata;
+	derived_state_dict_.push_back(entry);
+	derived_state_dict_lookup_[p_mutation_id] = entry_index;
+	
+	return entry_index;
+}
+
+void SLiMSim::ExpandDerivedStates(tsk_table_collection_t *p_tables)
+{
+	// This converts the mutation table of p_tables, which must use the in-memory form with derived-state dictionary indices, into the
+	// form written to disk: each derived state is a list of slim_mutationid_t, with a matching list of MutationMetadataRec in the
+	// metadata column.  This is used on copies of tables_ that are about to be written out or handed to tskit for analysis.
+	// As in DerivedStatesToAscii(), we need a copy of the table as the source for tsk_mutation_table_set_columns().
+	tsk_mutation_table_t mutations_copy;
+	int ret = tsk_mutation_table_copy(&p_tables->mutations, &mutations_copy, 0);
+	if (ret < 0) handle_error("ExpandDerivedStates tsk_mutation_table_copy()", ret);
+	
+	tsk_size_t mut_count = mutations_copy.num_rows;
+	size_t entry_count = (size_t)(mutations_copy.derived_state_length / sizeof(uint32_t));
+	const uint32_t *entry_indices = (const uint32_t *)mutations_copy.derived_state;
+	std::vector<slim_mutationid_t> derived_state;
+	std::vector<MutationMetadataRec> metadata;
+	std::vector<tsk_size_t> derived_state_offset;
+	std::vector<tsk_size_t> metadata_offset;
+	
+	derived_state.reserve(entry_count + 1);		// +1 so that data() is non-NULL even when all derived states are empty
+	metadata.reserve(entry_count + 1);
+	derived_state_offset.reserve(mut_count + 1);
+	metadata_offset.reserve(mut_count + 1);
+	
+	for (tsk_size_t mut_index = 0; mut_index <= mut_count; ++mut_index)
+	{
+		tsk_size_t entry_offset = mutations_copy.derived_state_offset[mut_index] / sizeof(uint32_t);
+		
+		derived_state_offset.push_back((tsk_size_t)(entry_offset * sizeof(slim_mutationid_t)));
+		metadata_offset.push_back((tsk_size_t)(entry_offset * sizeof(MutationMetadataRec)));
+	}
+	
+	for (size_t entry_position = 0; entry_position < entry_count; ++entry_position)
+	{
+		const DerivedStateEntry &entry = derived_state_dict_[entry_indices[entry_position]];
+		
+		derived_state.push_back(entry.mutation_id_);
+		metadata.push_back(entry.metadata_);
+	}
+	
+	ret = tsk_mutation_table_set_columns(&p_tables->mutations, mut_count,
+										 mutations_copy.site, mutations_copy.node, mutations_copy.parent,
+										 (char *)derived_state.data(), derived_state_offset.data(),
+										 (char *)metadata.data(), metadata_offset.data());
+	if (ret < 0) handle_error("ExpandDerivedStates tsk_mutation_table_set_columns()", ret);
+	
+	tsk_mutation_table_free(&mutations_copy);
+}
+
+void SLiMSim::CompactDerivedStates(tsk_table_collection_t *p_tables, int p_file_version)
+{
+	// This is the inverse of ExpandDerivedStates(), used on tables_ after a tree sequence has been loaded.  Metadata from file
+	// versions before 3 lacks the nucleotide field, which we fill in with -1 as __TabulateMutationsFromTables() does.
+	std::size_t metadata_rec_size = ((p_file_version < 3) ? sizeof(MutationMetadataRec_PRENUC) : sizeof(MutationMetadataRec));
+	tsk_mutation_table_t mutations_copy;
+	int ret = tsk_mutation_table_copy(&p_tables->mutations, &mutations_copy, 0);
+	if (ret < 0) handle_error("CompactDerivedStates tsk_mutation_table_copy()", ret);
+	
+	tsk_size_t mut_count = mutations_copy.num_rows;
+	std::vector<uint32_t> derived_state;
+	std::vector<tsk_size_t> derived_state_offset;
+	
+	derived_state.reserve(mutations_copy.derived_state_length / sizeof(slim_mutationid_t) + 1);		// +1 so that data() is non-NULL
+	derived_state_offset.reserve(mut_count + 1);
+	derived_state_offset.push_back(0);
+	
+	for (tsk_size_t mut_index = 0; mut_index < mut_count; ++mut_index)
+	{
+		// the lengths have already been checked by __TabulateMutationsFromTables()
+		const slim_mutationid_t *mutation_ids = (const slim_mutationid_t *)(mutations_copy.derived_state + mutations_copy.derived_state_offset[mut_index]);
+		const char *metadata_bytes = mutations_copy.metadata + mutations_copy.metadata_offset[mut_index];
+		size_t stack_count = (mutations_copy.derived_state_offset[mut_index + 1] - mutations_copy.derived_state_offset[mut_index]) / sizeof(slim_mutationid_t);
+		
+		for (size_t stack_index = 0; stack_index < stack_count; ++stack_index)
+		{
+			MutationMetadataRec metadata_rec;
+			
+			if (p_file_version < 3)
+			{
+				const MutationMetadataRec_PRENUC *prenuc_metadata = (const MutationMetadataRec_PRENUC *)(metadata_bytes + stack_index * metadata_rec_size);
+				
+				metadata_rec.mutation_type_id_ = prenuc_metadata->mutation_type_id_;
+				metadata_rec.selection_coeff_ = prenuc_metadata->selection_coeff_;
+				metadata_rec.subpop_index_ = prenuc_metadata->subpop_index_;
+				metadata_rec.origin_generation_ = prenuc_metadata->origin_generation_;
+				metadata_rec.nucleotide_ = -1;
+			}
+			else
+			{
+				memcpy(&metadata_rec, metadata_bytes + stack_index * metadata_rec_size, sizeof(MutationMetadataRec));
+			}
+			
+			derived_state.push_back(DerivedStateDictionaryIndex(mutation_ids[stack_index], metadata_rec));
+		}
+		
+		derived_state_offset.push_back((tsk_size_t)(derived_state.size() * sizeof(uint32_t)));
+	}
+	
+	ret = tsk_mutation_table_set_columns(&p_tables->mutations, mut_count,
+										 mutations_copy.site, mutations_copy.node, mutations_copy.parent,
+										 (char *)derived_state.data(), derived_state_offset.data(),
+										 NULL, NULL);
+	if (ret < 0) handle_error("CompactDerivedStates tsk_mutation_table_set_columns()", ret);
+	
+	tsk_mutation_table_free(&mutations_copy);
+	
+	derived_state_dict_collect_size_ = 2 * derived_state_dict_.size();
+}
+
+void SLiMSim::CollectDerivedStateDictionary(void)
+{
+	// Dictionary entries are never removed as they are made, so entries used only by rows that simplification has since removed
+	// accumulate.  After a simplification, once the dictionary has doubled in size since the last collection, we drop the entries
+	// that no row of tables_ refers to and renumber the rest in place.  This must not be done while an asynchronous simplification
+	// is pending or rows are buffered, since those refer to the dictionary too.
+	if (derived_state_dict_.size() < std::max(derived_state_dict_collect_size_, (size_t)4096))
+		return;
+	
+	static std::vector<uint32_t> entry_remap;
+	const uint32_t unused_entry = UINT32_MAX;
+	uint32_t *entry_indices = (uint32_t *)tables_.mutations.derived_state;
+	size_t entry_count = (size_t)(tables_.mutations.derived_state_length / sizeof(uint32_t));
+	
+	entry_remap.assign(derived_state_dict_.size(), unused_entry);
+	
+	for (size_t entry_position = 0; entry_position < entry_count; ++entry_position)
+		entry_remap[entry_indices[entry_position]] = 0;
+	
+	// keep the used entries in their existing order, so later entries for a mutation id still follow earlier ones
+	uint32_t kept_count = 0;
+	
+	for (size_t entry_index = 0; entry_index < derived_state_dict_.size(); ++entry_index)
+	{
+		if (entry_remap[entry_index] != unused_entry)
+		{
+			derived_state_dict_[kept_count] = derived_state_dict_[entry_index];
+			entry_remap[entry_index] = kept_count++;
+		}
+	}
+	
+	derived_state_dict_.resize(kept_count);
+	
+	for (size_t entry_position = 0; entry_position < entry_count; ++entry_position)
+		entry_indices[entry_position] = entry_remap[entry_indices[entry_position]];
+	
+	derived_state_dict_lookup_.clear();
+	for (uint32_t entry_index = 0; entry_index < kept_count; ++entry_index)
+		derived_state_dict_lookup_[derived_state_dict_[entry_index].mutation_id_] = entry_index;
+	
+	derived_state_dict_collect_size_ = 2 * (size_t)kept_count;
+}
+
+static uint64_t _TreeSequenceTableSize(tsk_table_collection_t &p_tables)
+{
+	// We could, in principle, calculate actual memory used based on number of rows * sizeof(column), etc.,
+	// but that seems like overkill; adding together the number of rows in all the tables should be a
+	// reasonable proxy, and this whole thing is just a heuristic that needs to be tailored anyway.
+	uint64_t table_size = (uint64_t)p_tables.nodes.num_rows;
+	table_size += (uint64_t)p_tables.edges.num_rows;
+	table_size += (uint64_t)p_tables.sites.num_rows;
+	table_size += (uint64_t)p_tables.mutations.num_rows;
+	
+	return table_size;
+}
+
+size_t SLiMSim::TreeSeqBytesInUse(const tsk_table_collection_t &p_tables)
+{
+	// Unlike MemoryUsageForTables(), this counts the bytes in use rather than the bytes allocated.  The tables do not give back their
+	// allocations when simplified, but their capacity only grows as the rows in use grow, so bounding the bytes in use bounds both.
+	// The derived-state dictionary is counted too, since it holds the mutation metadata that the tables do not; see ExpandDerivedStates().
+	const tsk_table_collection_t &t = p_tables;
+	size_t usage = derived_state_dict_.size() * sizeof(DerivedStateEntry);
+	
+	usage += t.individuals.num_rows * (sizeof(uint32_t) + 2 * sizeof(tsk_size_t));
+	usage += t.individuals.location_length * sizeof(double) + t.individuals.metadata_length;
+	usage += t.nodes.num_rows * (sizeof(uint32_t) + sizeof(double) + 2 * sizeof(tsk_id_t) + sizeof(tsk_size_t));
+	usage += t.nodes.metadata_length;
+	usage += t.edges.num_rows * (2 * sizeof(double) + 2 * sizeof(tsk_id_t));
+	usage += t.migrations.num_rows * (3 * sizeof(tsk_id_t) + 3 * sizeof(double));
+	usage += t.sites.num_rows * (sizeof(double) + 2 * sizeof(tsk_size_t));
+	usage += t.sites.ancestral_state_length + t.sites.metadata_length;
+	usage += t.mutations.num_rows * (3 * sizeof(tsk_id_t) + 2 * sizeof(tsk_size_t));
+	usage += t.mutations.derived_state_length + t.mutations.metadata_length;
+	usage += t.populations.num_rows * sizeof(tsk_size_t) + t.populations.metadata_length;
+	usage += t.provenances.num_rows * 2 * sizeof(tsk_size_t);
+	usage += t.provenances.timestamp_length + t.provenances.record_length;
+	
+	return usage;
+}
+
+void SLiMSim::AdjustAutoSimplificationInterval(uint64_t p_old_table_size, uint64_t p_new_table_size)
+{
+	double ratio = p_old_table_size / (double)p_new_table_size;
+	
+	//std::cout << "auto-simplified in generation " << generation_ << "; old size " << p_old_table_size << ", new size " << p_new_table_size;
+	//std::cout << "; ratio " << ratio << ", target " << simplification_ratio_ << std::endl;
+	//std::cout << "old interval " << simplify_interval_ << ", new interval ";
+	
+	// Adjust our automatic simplification interval based upon the observed change in storage space used.
+	// Not sure if this is exactly what we want to do; this will hunt around a lot without settling on a value,
+	// but that seems harmless.  The scaling factor of 1.2 is chosen somewhat arbitrarily; we want it to be
+	// large enough that we will arrive at the optimum interval before too terribly long, but small enough
+	// that we have some granularity, so that once we reach the optimum we don't fluctuate too much.
+	if (ratio < simplification_ratio_)
+	{
+		// We simplified too soon; wait a little longer next time
+		simplify_interval_ *= 1.2;
+		
+		// Impose a maximum interval of 1000, so we don't get caught flat-footed if model demography changes
+		if (simplify_interval_ > 1000.0)
+			simplify_interval_ = 1000.0;
+	}
+	else if (ratio > simplification_ratio_)
+	{
+		// We simplified too late; wait a little less long next time
+		simplify_interval_ /= 1.2;
+		
+		// Impose a minimum interval of 1.0, just to head off weird underflow issues
+		if (simplify_interval_ < 1.0)
+			simplify_interval_ = 1.0;
+	}
+	
+	//std::cout << simplify_interval_ << std::endl;
+}
+
+void SLiMSim::CheckAutoSimplification(void)
+{
+#if DEBUG
+	if (!recording_tree_)
+		EIDOS_TERMINATION << "ERROR (SLiMSim::CheckAutoSimplification): (internal error) tree sequence recording method called with recording off." << EidosTerminate();
+#endif
+	
+	// This is called at the end of each generation, at an appropriate time to simplify.  This method decides
+	// whether to simplify or not, based upon how long it has been since the last time we simplified.  Each
+	// time we simplify, we ask whether we simplified too early, too late, or just the right time by comparing
+	// the pre:post ratio of the tree recording table sizes to the desired pre:post ratio, simplification_ratio_,
+	// as set up in initializeTreeSeq().  Note that a simplification_ratio_ value of INF means "never simplify
+	// automatically"; we check for that up front.
+	// When multithreaded, automatic simplification runs in the background; see StartAsyncSimplification().
+	// The tables that result are identical to those that a synchronous simplification would produce.
+	// This is also the end-of-generation point at which the rows buffered during the generation go into the tables.
+	FlushRecordingBuffers();
+	
+	++simplify_elapsed_;
+	
+	// A memory budget, if set with initializeTreeSeq(memoryLimit=...), takes precedence over the interval or ratio
+	if (memory_limit_ && CheckMemoryLimitSimplification())
+		return;
+	
+	bool simplify_async = CanSimplifyAsynchronously();
+	
+	if (simplification_interval_ != -1)
+	{
+		// BCH 4/5/2019: Adding support for a chosen simplification interval rather than a ratio.  A value of -1
+		// means the simplification ratio is being used, as implemented below; any other value is a target interval.
+		if ((simplify_elapsed_ >= 1) && (simplify_elapsed_ >= simplification_interval_))
+		{
+			if (simplify_async)
+				StartAsyncSimplification();
+			else
+				SimplifyTreeSequence();
+		}
+	}
+	else if (!std::isinf(simplification_ratio_))
+	{
+		// With the ratio heuristic, the outcome of each simplification adjusts the interval to the next one; a background
+		// simplification is therefore finished one generation after it starts, so that the adjustment is always in place
+		// before the next decision is made, exactly as it would be with synchronous simplification.
+		if (async_simplify_pending_)
+			FinishAsyncSimplification();
+		
+		if (simplify_elapsed_ >= simplify_interval_)
+		{
+			if (simplify_async)
+			{
+				StartAsyncSimplification();
+			}
+			else
+			{
+				uint64_t old_table_size = _TreeSequenceTableSize(tables_);
+				
+				SimplifyTreeSequence();
+				
+				AdjustAutoSimplificationInterval(old_table_size, _TreeSequenceTableSize(tables_));
+			}
+		}
+	}
+}
+
+bool SLiMSim::CheckMemoryLimitSimplification(void)
+{
+	// The tables are simplified when, growing as they did over the last generation, they would exceed memory_limit_ by the next check.
+	// The time spent simplifying per generation falls as the interval between simplifications lengthens, since each simplification
+	// costs roughly a fixed amount for the retained tables plus an amount proportional to the rows added since the last one; the
+	// cheapest policy within the budget is therefore to simplify as late as the budget allows, which is what this does when no ratio
+	// or interval is given.  When one is given, it still governs, and this just forces an earlier simplification if the budget needs it.
+	// Under that cost model the measured simplification time could not change the choice (later is always cheaper), so it is used only
+	// to warn, below, when the budget is too tight for the model to run efficiently; it never alters when or whether we simplify, which
+	// also keeps the course of a run independent of timing.
+	// The simplification is synchronous, since a background simplification would hold the old tables alongside the new ones.
+	// The budget is checked only here, at the end of each generation, so within a generation the tables can exceed it by the rows
+	// recorded in that generation; what is guaranteed is that they are within it after each end-of-generation check.
+	if (async_simplify_pending_)
+		FinishAsyncSimplification();
+	
+	size_t table_bytes = TreeSeqBytesInUse();
+	size_t growth = (table_bytes > memory_limit_last_bytes_) ? (table_bytes - memory_limit_last_bytes_) : 0;
+	
+	memory_limit_last_bytes_ = table_bytes;
+	
+	if (table_bytes + growth <= memory_limit_)
+		return false;
+	
+	// the time is wall-clock time, since simplification and the rest of the run may both be spread across threads
+	std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+	
+	SimplifyTreeSequence();
+	
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+	
+	table_bytes = memory_limit_last_bytes_;		// set by SimplifyTreeSequence()
+	
+	if (table_bytes > memory_limit_)
+		EIDOS_TERMINATION << "ERROR (SLiMSim::CheckMemoryLimitSimplification): the tree-sequence tables occupy " << table_bytes << " bytes after simplification, exceeding the memoryLimit of " << memory_limit_ << " bytes set by initializeTreeSeq()." << EidosTerminate();
+	
+	// If simplifying often enough to stay within the budget takes more than max_simplify_fraction_ of the run time since the previous
+	// such simplification, the budget is probably too tight for the model to run efficiently; warn once, since the run is still correct
+	double simplify_time = std::chrono::duration<double>(end - begin).count();
+	double cycle_time = std::chrono::duration<double>(end - memory_limit_cycle_time_).count();
+	
+	memory_limit_cycle_time_ = end;
+	
+	if (!memory_limit_warned_ && (cycle_time > 0.0) && (simplify_time > max_simplify_fraction_ * cycle_time))
+	{
+		SLIM_OUTSTREAM << "#WARNING (SLiMSim::CheckMemoryLimitSimplification): simplification to keep the tree-sequence tables within memoryLimit took " << (100.0 * simplify_time / cycle_time) << "% of the run time in generation " << generation_ << "; a larger memoryLimit would be faster." << std::endl;
+		memory_limit_warned_ = true;
+	}
+	
+	return true;
+}
+
+bool SLiMSim::CanSimplifyAsynchronously(void)
+{
+	// Simplification is done in the background only when multithreading is enabled.  Coalescence checking needs the genomes as they
+	// were at the moment of simplification, so it keeps simplification synchronous.  Anything else that needs the tables (output,
+	// crosschecks, remembering individuals, and so forth) just waits for the background simplification to finish first.
+	return ((gEidosMaxThreads > 1) && !running_coalescence_checks_);
+}
+
+static int _SimplifyTablesAsync(tsk_table_collection_t *p_tables, tsk_size_t p_sorted_edge_count, std::vector<tsk_id_t> *p_samples, tsk_id_t *p_node_map, const char **p_failed_operation)
+{
+	// The work of SimplifyTreeSequence() that can be done off the main thread: sort, deduplicate sites, and simplify.  This touches
+	// nothing but the tables passed in, and reports errors back rather than raising, since raises can only happen on the main thread.
+	int ret = _SortTreeSequenceTables(p_tables, p_sorted_edge_count);
+	if (ret < 0) { *p_failed_operation = "tsk_table_collection_sort"; return ret; }
+	
+	ret = tsk_table_collection_deduplicate_sites(p_tables, 0);
+	if (ret < 0) { *p_failed_operation = "tsk_table_collection_deduplicate_sites"; return ret; }
+	
+	ret = tsk_table_collection_simplify(p_tables, p_samples->data(), (tsk_size_t)p_samples->size(), TSK_FILTER_SITES | TSK_FILTER_INDIVIDUALS, p_node_map);
+	if (ret != 0) { *p_failed_operation = "tsk_table_collection_simplify"; return ret; }
+	
+	return 0;
+}
+
+void SLiMSim::StartAsyncSimplification(void)
+{
+#if DEBUG
+	if (!recording_tree_)
+		EIDOS_TERMINATION << "ERROR (SLiMSim::StartAsyncSimplification): (internal error) tree sequence recording method called with recording off." << EidosTerminate();
+#endif
+	
+	FlushRecordingBuffers();
+	
+	if (async_simplify_pending_)
+		FinishAsyncSimplification();
+	
+	if (tables_.nodes.num_rows == 0)
+		return;
+	
+	// This does what SimplifyTreeSequence() does, except that the sort and simplify happen on a background thread while the simulation
+	// continues.  The tables recorded so far are moved into async_simplify_tables_ for the background thread, and tables_ starts over
+	// empty to receive whatever gets recorded in the meantime.  New nodes are numbered as if they had been appended to the old tables
+	// (see async_node_base_), so edges and mutations can refer to old and new nodes alike; FinishAsyncSimplification() then appends
+	// the new rows to the simplified tables, remapping node ids through the map produced by simplify.  Since simplification leaves
+	// the sample nodes at the start of the node table, and everything recorded since is appended after them, the result is exactly
+	// what synchronous simplification followed by the same recording would have produced.
+	
+	// the samples are collected just as SimplifyTreeSequence() does, but tsk_node_id_ values are updated only when we finish
+	async_simplify_samples_.clear();
+	
+	for (tsk_id_t sid : remembered_genomes_)
+		async_simplify_samples_.push_back(sid);
+	
+	for (auto it = population_.subpops_.begin(); it != population_.subpops_.end(); it++)
+	{
+		std::vector<Genome *> &subpopulationGenomes = it->second->parent_genomes_;
+		
+		for (Genome *genome : subpopulationGenomes)
+		{
+			tsk_id_t M = genome->tsk_node_id_;
+			
+			if (std::find(remembered_genomes_.begin(), remembered_genomes_.end(), M) == remembered_genomes_.end())
+				async_simplify_samples_.push_back(M);
+		}
+	}
+	
+	// the tables need to have a population table to be able to sort it
+	WritePopulationTable(&tables_);
+	
+	// hand the tables to the background thread, and start fresh ones
+	async_simplify_tables_ = tables_;
+	async_simplify_old_table_size_ = _TreeSequenceTableSize(async_simplify_tables_);
+	async_node_base_ = (tsk_id_t)async_simplify_tables_.nodes.num_rows;
+	async_simplify_node_map_.resize(async_simplify_tables_.nodes.num_rows);
+	async_simplify_result_ = 0;
+	async_simplify_failed_operation_ = nullptr;
+	
+	int ret = tsk_table_collection_init(&tables_, 0);
+	if (ret != 0) handle_error("StartAsyncSimplification()", ret);
+	
+	tables_.sequence_length = async_simplify_tables_.sequence_length;
+	
+	async_simplify_pending_ = true;
+	async_simplify_thread_ = std::thread([this](tsk_size_t sorted_edge_count) {
+		async_simplify_result_ = _SimplifyTablesAsync(&async_simplify_tables_, sorted_edge_count, &async_simplify_samples_, async_simplify_node_map_.data(), &async_simplify_failed_operation_);
+	}, sorted_edge_count_);
+	
+	sorted_edge_count_ = 0;
+	
+	// reset current position, used to rewind individuals that are rejected by modifyChild()
+	RecordTablePosition();
+	
+	// and reset our elapsed time since last simplification, for auto-simplification
+	simplify_elapsed_ = 0;
+}
+
+void SLiMSim::FinishAsyncSimplification(void)
+{
+#if DEBUG
+	if (!async_simplify_pending_)
+		EIDOS_TERMINATION << "ERROR (SLiMSim::FinishAsyncSimplification): (internal error) no asynchronous simplification is pending." << EidosTerminate();
+#endif
 	
-	derived_mutation_ids.clear();
-    mutation_metadata.clear();
-	for (Mutation *mutation : p_derived_mutations)
-	{
-		derived_mutation_ids.push_back(mutation->mutation_id_);
-		MetadataForMutation(mutation, &metadata_rec);
-        mutation_metadata.push_back(metadata_rec);
-    }
+	// rows recorded since the simplification started have to be in tables_ before they are appended to its result
+	FlushRecordingBuffers();
 	
-	// find and incorporate any fixed mutations at this position, which exist in all new derived states but are not included by SLiM
-	// BCH 5/14/2019: Note that this means that derived states will be recorded that look "stacked" even when those mutations would
-	// not have stacked, by the stacking policy, had they occurred in the same genome at the same time.  So this is a bit weird.
-	// For example, you can end up with a derived state that appears to show two nucleotides stacked at the same position; but one
-	// fixed before the other one occurred, so they aren't stacked really, the new one just occurred on the ancestral background of
-	// the old one.  Possibly we ought to do something different about this (and not record a stacked derived state), but that
-	// would be a big change since it has implications for crosscheck, etc.  FIXME
-	auto position_range_iter = population_.treeseq_substitutions_map_.equal_range(p_position);
+	async_simplify_thread_.join();
+	async_simplify_pending_ = false;
 	
-	for (auto position_iter = position_range_iter.first; position_iter != position_range_iter.second; ++position_iter)
+	if (async_simplify_result_ != 0)
 	{
-		Substitution *substitution = position_iter->second;
-		
-		derived_mutation_ids.push_back(substitution->mutation_id_);
-		MetadataForSubstitution(substitution, &metadata_rec);
-		mutation_metadata.push_back(metadata_rec);
+		// clean up, leaving empty tables behind, so that nothing touches the failed tables after the raise
+		tsk_table_collection_free(&async_simplify_tables_);
+		async_node_base_ = 0;
+		handle_error(async_simplify_failed_operation_, async_simplify_result_);
 	}
 	
-	// add the mutation table row with the final derived state and metadata
-    char *derived_muts_bytes = (char *)(derived_mutation_ids.data());
-    size_t derived_state_length = derived_mutation_ids.size() * sizeof(slim_mutationid_t);
-    char *mutation_metadata_bytes = (char *)(mutation_metadata.data());
-    size_t mutation_metadata_length = mutation_metadata.size() * sizeof(MutationMetadataRec);
-
-    int ret = tsk_mutation_table_add_row(&tables_.mutations, site_id, genomeTSKID, TSK_NULL, 
-                    derived_muts_bytes, (tsk_size_t)derived_state_length,
-                    mutation_metadata_bytes, (tsk_size_t)mutation_metadata_length);
-	if (ret < 0) handle_error("add_mutation", ret);
-}
-
-void SLiMSim::CheckAutoSimplification(void)
-{
+	// Everything recorded since the simplification started has been going into tables_, with node ids offset by async_node_base_.
+	// Append it all to the simplified tables, translating old node ids through the simplify node map, new node ids by the difference
+	// in node table length, and site and mutation ids by the lengths of those tables in the simplified result.
+	tsk_table_collection_t &simplified = async_simplify_tables_;
+	tsk_bookmark_t simplified_position;
+	const tsk_id_t *node_map = async_simplify_node_map_.data();
+	tsk_id_t node_base = async_node_base_;
+	
+	tsk_table_collection_record_num_rows(&simplified, &simplified_position);
+	
+	// growth projected by CheckMemoryLimitSimplification() is measured from the simplified tables, before the rows recorded since are added
+	memory_limit_last_bytes_ = TreeSeqBytesInUse(simplified);
+	
+	tsk_id_t new_node_base = (tsk_id_t)simplified_position.nodes;
+	auto remap_node = [node_map, node_base, new_node_base](tsk_id_t p_node_id) -> tsk_id_t {
+		if (p_node_id < 0)
+			return p_node_id;
+		if (p_node_id < node_base)
+			return node_map[p_node_id];
+		return p_node_id - node_base + new_node_base;
+	};
+	
+	uint64_t new_table_size = _TreeSequenceTableSize(simplified);
+	int ret;
+	
 #if DEBUG
-	if (!recording_tree_)
-		EIDOS_TERMINATION << "ERROR (SLiMSim::CheckAutoSimplification): (internal error) tree sequence recording method called with recording off." << EidosTerminate();
+	if (tables_.individuals.num_rows || tables_.populations.num_rows || tables_.migrations.num_rows || tables_.provenances.num_rows)
+		EIDOS_TERMINATION << "ERROR (SLiMSim::FinishAsyncSimplification): (internal error) unexpected rows recorded during asynchronous simplification." << EidosTerminate();
 #endif
 	
-	// This is called at the end of each generation, at an appropriate time to simplify.  This method decides
-	// whether to simplify or not, based upon how long it has been since the last time we simplified.  Each
-	// time we simplify, we ask whether we simplified too early, too late, or just the right time by comparing
-	// the pre:post ratio of the tree recording table sizes to the desired pre:post ratio, simplification_ratio_,
-	// as set up in initializeTreeSeq().  Note that a simplification_ratio_ value of INF means "never simplify
-	// automatically"; we check for that up front.
-	++simplify_elapsed_;
+	if (tables_.nodes.num_rows)
+	{
+		tsk_node_table_t &nodes = tables_.nodes;
+		
+		ret = tsk_node_table_append_columns(&simplified.nodes, nodes.num_rows, nodes.flags, nodes.time, nodes.population, nodes.individual, nodes.metadata, nodes.metadata_offset);
+		if (ret < 0) handle_error("tsk_node_table_append_columns", ret);
+	}
 	
-	if (simplification_interval_ != -1)
+	if (tables_.edges.num_rows)
 	{
-		// BCH 4/5/2019: Adding support for a chosen simplification interval rather than a ratio.  A value of -1
-		// means the simplification ratio is being used, as implemented below; any other value is a target interval.
-		if ((simplify_elapsed_ >= 1) && (simplify_elapsed_ >= simplification_interval_))
+		tsk_edge_table_t &edges = tables_.edges;
+		std::vector<tsk_id_t> parents(edges.num_rows), children(edges.num_rows);
+		
+		for (tsk_size_t edge_index = 0; edge_index < edges.num_rows; ++edge_index)
 		{
-			SimplifyTreeSequence();
+			parents[edge_index] = remap_node(edges.parent[edge_index]);
+			children[edge_index] = remap_node(edges.child[edge_index]);
+			
+			if ((parents[edge_index] == TSK_NULL) || (children[edge_index] == TSK_NULL))
+				EIDOS_TERMINATION << "ERROR (SLiMSim::FinishAsyncSimplification): (internal error) edge references a node removed by simplification." << EidosTerminate();
 		}
+		
+		ret = tsk_edge_table_append_columns(&simplified.edges, edges.num_rows, edges.left, edges.right, parents.data(), children.data());
+		if (ret < 0) handle_error("tsk_edge_table_append_columns", ret);
 	}
-	else if (!std::isinf(simplification_ratio_))
+	
+	if (tables_.sites.num_rows)
 	{
-		if (simplify_elapsed_ >= simplify_interval_)
+		tsk_site_table_t &sites = tables_.sites;
+		
+		ret = tsk_site_table_append_columns(&simplified.sites, sites.num_rows, sites.position, sites.ancestral_state, sites.ancestral_state_offset, sites.metadata, sites.metadata_offset);
+		if (ret < 0) handle_error("tsk_site_table_append_columns", ret);
+	}
+	
+	if (tables_.mutations.num_rows)
+	{
+		tsk_mutation_table_t &mutations = tables_.mutations;
+		std::vector<tsk_id_t> mutation_sites(mutations.num_rows), mutation_nodes(mutations.num_rows), mutation_parents(mutations.num_rows);
+		
+		for (tsk_size_t mutation_index = 0; mutation_index < mutations.num_rows; ++mutation_index)
 		{
-			// We could, in principle, calculate actual memory used based on number of rows * sizeof(column), etc.,
-			// but that seems like overkill; adding together the number of rows in all the tables should be a
-			// reasonable proxy, and this whole thing is just a heuristic that needs to be tailored anyway.
-			uint64_t old_table_size = (uint64_t)tables_.nodes.num_rows;
-            old_table_size += (uint64_t)tables_.edges.num_rows;
-            old_table_size += (uint64_t)tables_.sites.num_rows;
-            old_table_size += (uint64_t)tables_.mutations.num_rows;
-			
-			SimplifyTreeSequence();
-			
-			uint64_t new_table_size = (uint64_t)tables_.nodes.num_rows;
-            new_table_size += (uint64_t)tables_.edges.num_rows;
-            new_table_size += (uint64_t)tables_.sites.num_rows;
-            new_table_size += (uint64_t)tables_.mutations.num_rows;
-			double ratio = old_table_size / (double)new_table_size;
-			
-			//std::cout << "auto-simplified in generation " << generation_ << "; old size " << old_table_size << ", new size " << new_table_size;
-			//std::cout << "; ratio " << ratio << ", target " << simplification_ratio_ << std::endl;
-			//std::cout << "old interval " << simplify_interval_ << ", new interval ";
-			
-			// Adjust our automatic simplification interval based upon the observed change in storage space used.
-			// Not sure if this is exactly what we want to do; this will hunt around a lot without settling on a value,
-			// but that seems harmless.  The scaling factor of 1.2 is chosen somewhat arbitrarily; we want it to be
-			// large enough that we will arrive at the optimum interval before too terribly long, but small enough
-			// that we have some granularity, so that once we reach the optimum we don't fluctuate too much.
-			if (ratio < simplification_ratio_)
-			{
-				// We simplified too soon; wait a little longer next time
-				simplify_interval_ *= 1.2;
-				
-				// Impose a maximum interval of 1000, so we don't get caught flat-footed if model demography changes
-				if (simplify_interval_ > 1000.0)
-					simplify_interval_ = 1000.0;
-			}
-			else if (ratio > simplification_ratio_)
-			{
-				// We simplified too late; wait a little less long next time
-				simplify_interval_ /= 1.2;
-				
-				// Impose a minimum interval of 1.0, just to head off weird underflow issues
-				if (simplify_interval_ < 1.0)
-					simplify_interval_ = 1.0;
-			}
+			tsk_id_t parent = mutations.parent[mutation_index];
+			
+			mutation_sites[mutation_index] = mutations.site[mutation_index] + (tsk_id_t)simplified_position.sites;
+			mutation_nodes[mutation_index] = remap_node(mutations.node[mutation_index]);
+			mutation_parents[mutation_index] = (parent == TSK_NULL) ? TSK_NULL : parent + (tsk_id_t)simplified_position.mutations;
 			
-			//std::cout << simplify_interval_ << std::endl;
+			if (mutation_nodes[mutation_index] == TSK_NULL)
+				EIDOS_TERMINATION << "ERROR (SLiMSim::FinishAsyncSimplification): (internal error) mutation references a node removed by simplification." << EidosTerminate();
 		}
+		
+		ret = tsk_mutation_table_append_columns(&simplified.mutations, mutations.num_rows, mutation_sites.data(), mutation_nodes.data(), mutation_parents.data(),
+												mutations.derived_state, mutations.derived_state_offset, mutations.metadata, mutations.metadata_offset);
+		if (ret < 0) handle_error("tsk_mutation_table_append_columns", ret);
+	}
+	
+	// the rewind position for modifyChild() rejection, if one is set, moves along with the rows it refers to
+	table_position_.individuals += simplified_position.individuals;
+	table_position_.nodes += simplified_position.nodes;
+	table_position_.edges += simplified_position.edges;
+	table_position_.migrations += simplified_position.migrations;
+	table_position_.sites += simplified_position.sites;
+	table_position_.mutations += simplified_position.mutations;
+	table_position_.populations += simplified_position.populations;
+	table_position_.provenances += simplified_position.provenances;
+	
+	tsk_table_collection_free(&tables_);
+	tables_ = simplified;
+	async_node_base_ = 0;
+	sorted_edge_count_ = simplified_position.edges;
+	
+	// update the node ids kept by SLiM; these may be old (if the genome was a sample) or new (if it was recorded since), and genomes
+	// outside the current generation may hold stale ids that will never be used, which translate harmlessly
+	for (tsk_id_t &remembered_id : remembered_genomes_)
+		remembered_id = remap_node(remembered_id);
+	
+	for (auto subpop_pair : population_.subpops_)
+	{
+		Subpopulation *subpop = subpop_pair.second;
+		
+		for (Genome *genome : subpop->parent_genomes_)
+			genome->tsk_node_id_ = remap_node(genome->tsk_node_id_);
+#ifdef SLIM_WF_ONLY
+		for (Genome *genome : subpop->child_genomes_)
+			genome->tsk_node_id_ = remap_node(genome->tsk_node_id_);
+#endif
+#ifdef SLIM_NONWF_ONLY
+		for (Genome *genome : subpop->nonWF_offspring_genomes_)
+			genome->tsk_node_id_ = remap_node(genome->tsk_node_id_);
+#endif
 	}
+	
+	// drop derived-state dictionary entries for mutation rows that simplify has removed, as SimplifyTreeSequence() does
+	CollectDerivedStateDictionary();
+	
+	// with the ratio heuristic, adjust the interval to the next simplification as CheckAutoSimplification() would have
+	if ((simplification_interval_ == -1) && !std::isinf(simplification_ratio_))
+		AdjustAutoSimplificationInterval(async_simplify_old_table_size_, new_table_size);
 }
 
 void SLiMSim::TreeSequenceDataFromAscii(std::string NodeFileName,
@@ -5491,9 +6789,18 @@ void SLiMSim::TreeSequenceDataToAscii(tsk_table_collection_t *p_tables)
 	// This modifies p_tables in place, replacing the metadata and derived_state columns of p_tables with ASCII versions.
 	// We make a copy of the table collection here, as a source for column data, because you can't pass existing
 	// columns in to tsk_mutation_table_set_columns() and tsk_node_table_set_columns(); there is no way to just patch up the
-	// columns in p_tables, we have to copy a new set of information into p_tables wholesale.
+	// columns in p_tables, we have to copy a new set of information into p_tables wholesale.  Only the mutation, node,
+	// individual, and population tables are rewritten, so we copy just those; the (often large) edge table is left out.
 	tsk_table_collection_t tables_copy;
-	int ret = tsk_table_collection_copy(p_tables, &tables_copy, 0);
+	int ret = tsk_table_collection_init(&tables_copy, 0);
+	if (ret < 0) handle_error("convert_to_ascii", ret);
+	ret = tsk_mutation_table_copy(&p_tables->mutations, &tables_copy.mutations, TSK_NO_INIT);
+	if (ret < 0) handle_error("convert_to_ascii", ret);
+	ret = tsk_node_table_copy(&p_tables->nodes, &tables_copy.nodes, TSK_NO_INIT);
+	if (ret < 0) handle_error("convert_to_ascii", ret);
+	ret = tsk_individual_table_copy(&p_tables->individuals, &tables_copy.individuals, TSK_NO_INIT);
+	if (ret < 0) handle_error("convert_to_ascii", ret);
+	ret = tsk_population_table_copy(&p_tables->populations, &tables_copy.populations, TSK_NO_INIT);
 	if (ret < 0) handle_error("convert_to_ascii", ret);
 	
     /********************************************************
@@ -5862,6 +7169,15 @@ void SLiMSim::AddIndividualsToTable(Individual * const *p_individual, size_t p_n
 	if (p_tables == nullptr)
 		p_tables = &tables_;
 	
+	// rows are looked up in the node table by id below, so when working on tables_ it must be complete
+	if (p_tables == &tables_)
+	{
+		FlushRecordingBuffers();
+		
+		if (async_simplify_pending_)
+			FinishAsyncSimplification();
+	}
+	
 	// construct the map of currently remembered individuals first; these are not really just those
 	// that are "remembered", but all individuals that are currently in the tables
     std::vector<slim_pedigreeid_t> remembered_individuals;
@@ -6391,6 +7707,53 @@ void SLiMSim::ReadProvenanceTable(tsk_table_collection_t *p_tables, slim_generat
 #endif
 }
 
+// The output path below rewrites the node, individual, mutation, population, and provenance tables of the collection
+// it writes (times rebased, individuals reordered, mutation parents computed, derived states converted to ASCII, etc.),
+// but only reads the edge, site, and migration tables.  The edge table is generally by far the largest table, so
+// rather than making a full copy with tsk_table_collection_copy() and doubling the peak memory footprint of output,
+// we deep-copy only the tables that get modified and let the output collection alias the rest of the source tables.
+// _FreeOutputTables() must be used to free such a collection, so that the aliased tables are not freed twice.
+static int _CopyTablesForOutput(tsk_table_collection_t *p_source, tsk_table_collection_t *p_dest)
+{
+	int ret = tsk_table_collection_init(p_dest, 0);
+	
+	p_dest->sequence_length = p_source->sequence_length;
+	
+	if (ret == 0) ret = tsk_node_table_copy(&p_source->nodes, &p_dest->nodes, TSK_NO_INIT);
+	if (ret == 0) ret = tsk_mutation_table_copy(&p_source->mutations, &p_dest->mutations, TSK_NO_INIT);
+	if (ret == 0) ret = tsk_individual_table_copy(&p_source->individuals, &p_dest->individuals, TSK_NO_INIT);
+	if (ret == 0) ret = tsk_population_table_copy(&p_source->populations, &p_dest->populations, TSK_NO_INIT);
+	if (ret == 0) ret = tsk_provenance_table_copy(&p_source->provenances, &p_dest->provenances, TSK_NO_INIT);
+	
+	if (ret != 0)
+	{
+		// nothing has been aliased yet, so the partial copy is owned entirely by p_dest and can be freed normally
+		tsk_table_collection_free(p_dest);
+		return ret;
+	}
+	
+	// swap in the source's edge, site, and migration tables for the empty ones made by tsk_table_collection_init()
+	tsk_edge_table_free(&p_dest->edges);
+	tsk_site_table_free(&p_dest->sites);
+	tsk_migration_table_free(&p_dest->migrations);
+	
+	p_dest->edges = p_source->edges;
+	p_dest->sites = p_source->sites;
+	p_dest->migrations = p_source->migrations;
+	
+	return 0;
+}
+
+static void _FreeOutputTables(tsk_table_collection_t *p_output)
+{
+	// forget the aliased tables, which still belong to the source collection; freeing a zeroed table is a no-op
+	memset(&p_output->edges, 0, sizeof(p_output->edges));
+	memset(&p_output->sites, 0, sizeof(p_output->sites));
+	memset(&p_output->migrations, 0, sizeof(p_output->migrations));
+	
+	tsk_table_collection_free(p_output);
+}
+
 void SLiMSim::WriteTreeSequence(std::string &p_recording_tree_path, bool p_binary, bool p_simplify)
 {
 #if DEBUG
@@ -6398,6 +7761,12 @@ void SLiMSim::WriteTreeSequence(std::string &p_recording_tree_path, bool p_binar
 		EIDOS_TERMINATION << "ERROR (SLiMSim::WriteTreeSequence): (internal error) tree sequence recording method called with recording off." << EidosTerminate();
 #endif
 	
+	// the tables must be complete, so buffered rows and any simplification in progress on the async thread have to be spliced in first
+	FlushRecordingBuffers();
+	
+	if (async_simplify_pending_)
+		FinishAsyncSimplification();
+	
     // If p_binary, then write out to that path;
     // otherwise, create p_recording_tree_path as a directory,
     // and write out to text files in that directory
@@ -6420,18 +7789,22 @@ void SLiMSim::WriteTreeSequence(std::string &p_recording_tree_path, bool p_binar
 	else
 	{
         // this is done by SimplifyTreeSequence() but we need to do in any case
-		ret = tsk_table_collection_sort(&tables_, /* edge_start */ 0, /* flags */ 0);
-        if (ret < 0) handle_error("tsk_table_collection_sort", ret);
+		SortTreeSequenceTables(&tables_, sorted_edge_count_);
+		sorted_edge_count_ = tables_.edges.num_rows;
 		
         // Remove redundant sites we added
         ret = tsk_table_collection_deduplicate_sites(&tables_, 0);
         if (ret < 0) handle_error("tsk_table_collection_deduplicate_sites", ret);
     }
 	
-	// Copy the table collection so that modifications we do for writing don't affect the original tables
+	// Copy the table collection so that modifications we do for writing don't affect the original tables; only the
+	// tables we modify are actually copied, and the edge, site, and migration tables are shared with tables_
 	tsk_table_collection_t output_tables;
-	ret = tsk_table_collection_copy(&tables_, &output_tables, 0);
-	if (ret < 0) handle_error("tsk_table_collection_copy", ret);
+	ret = _CopyTablesForOutput(&tables_, &output_tables);
+	if (ret < 0) handle_error("_CopyTablesForOutput", ret);
+	
+	// Put the mutation table's derived states and metadata back in the form that is written to disk
+	ExpandDerivedStates(&output_tables);
 	
 	// Add in the mutation.parent information; valid tree sequences need parents, but we don't keep them while running
 	ret = tsk_table_collection_build_index(&output_tables, 0);
@@ -6485,29 +7858,50 @@ void SLiMSim::WriteTreeSequence(std::string &p_recording_tree_path, bool p_binar
 		// derived state data must be in ASCII (or unicode) on disk, according to tskit policy
 		DerivedStatesToAscii(&output_tables);
 		
-		tsk_table_collection_dump(&output_tables, path.c_str(), 0);
+		// We write the tables and the reference sequence into a single kastore; it used to be that we dumped the tables
+		// and then re-opened the file in append mode, but that reads the whole file back into memory before rewriting it.
+		// The table columns are borrowed by the store, not copied, so output_tables must stay intact until it is closed.
+		// Closing the store flushes whatever it holds, so on an error we remove the file rather than leave a partial one.
+		kastore_t store;
+		
+		ret = kastore_open(&store, path.c_str(), "w", 0);
+		if (ret < 0) handle_error("kastore_open", tsk_set_kas_error(ret));
 		
-		// In nucleotide-based models, write out the ancestral sequence, re-opening the kastore to append
+		ret = tsk_table_collection_dump_store(&output_tables, &store, 0);
+		if (ret < 0)
+		{
+			kastore_close(&store);
+			unlink(path.c_str());
+			handle_error("tsk_table_collection_dump_store", ret);
+		}
+		
+		// In nucleotide-based models, write out the ancestral sequence
 		if (nucleotide_based_)
 		{
 			std::size_t buflen = chromosome_.AncestralSequence()->size();
 			char *buffer;	// kastore needs to provide us with a memory location to which to write the data
-			kastore_t store;
 			
 			buffer = (char *)malloc(buflen);
 			chromosome_.AncestralSequence()->WriteNucleotidesToBuffer(buffer);
 			
-			ret = kastore_open(&store, path.c_str(), "a", 0);
-			if (ret < 0) handle_error("kastore_open", ret);
-				
-			kastore_oputs_int8(&store, "reference_sequence/data", (int8_t *)buffer, buflen, 0);
-			if (ret < 0) handle_error("kastore_oputs_int8", ret);
-			
-			ret = kastore_close(&store);
-			if (ret < 0) handle_error("kastore_close", ret);
+			ret = kastore_oputs_int8(&store, "reference_sequence/data", (int8_t *)buffer, buflen, 0);
+			if (ret < 0)
+			{
+				free(buffer);
+				kastore_close(&store);
+				unlink(path.c_str());
+				handle_error("kastore_oputs_int8", tsk_set_kas_error(ret));
+			}
 			
 			// kastore owns buffer now, so we do not free it
 		}
+		
+		ret = kastore_close(&store);
+		if (ret < 0)
+		{
+			unlink(path.c_str());
+			handle_error("kastore_close", tsk_set_kas_error(ret));
+		}
     }
 	else
 	{
@@ -6572,7 +7966,7 @@ void SLiMSim::WriteTreeSequence(std::string &p_recording_tree_path, bool p_binar
     }
 	
 	// Done with our tables copy
-	tsk_table_collection_free(&output_tables);
+	_FreeOutputTables(&output_tables);
 }	
 
 
@@ -6584,8 +7978,23 @@ void SLiMSim::FreeTreeSequence(void)
 #endif
 	
 	// Free any tree-sequence recording stuff that has been allocated; called when SLiMSim is getting deallocated,
-	// and also when we're wiping the slate clean with something like readFromPopulationFile().
+	// and also when we're wiping the slate clean with something like readFromPopulationFile().  An asynchronous
+	// simplification in progress has to finish first, but there is no point in splicing its result in.
+	if (async_simplify_pending_)
+	{
+		async_simplify_thread_.join();
+		async_simplify_pending_ = false;
+		async_node_base_ = 0;
+		tsk_table_collection_free(&async_simplify_tables_);
+	}
+	
 	tsk_table_collection_free(&tables_);
+	sorted_edge_count_ = 0;
+	ClearRecordingBuffers();
+	
+	derived_state_dict_.clear();
+	derived_state_dict_lookup_.clear();
+	derived_state_dict_collect_size_ = 0;
 	
 	remembered_genomes_.clear();
 }
@@ -6695,6 +8104,12 @@ void SLiMSim::DumpMutationTable(void)
 		EIDOS_TERMINATION << "ERROR (SLiMSim::DumpMutationTable): (internal error) tree sequence recording method called with recording off." << EidosTerminate();
 #endif
 	
+	// the tables must be complete, so buffered rows and any simplification in progress on the async thread have to be spliced in first
+	FlushRecordingBuffers();
+	
+	if (async_simplify_pending_)
+		FinishAsyncSimplification();
+	
 	// Dump for debugging; should not be called in production code!
 	
 	tsk_mutation_table_t &mutations = tables_.mutations;
@@ -6713,8 +8128,8 @@ void SLiMSim::DumpMutationTable(void)
 		{
 			bool contains_id = false;
 			
-			for (size_t mutid_index = 0; mutid_index < derived_state_length / sizeof(slim_mutationid_t); ++mutid_index)
-				if (((slim_mutationid_t *)derived_state)[mutid_index] == 72)
+			for (size_t entry_position = 0; entry_position < derived_state_length / sizeof(uint32_t); ++entry_position)
+				if (derived_state_dict_[((uint32_t *)derived_state)[entry_position]].mutation_id_ == 72)
 					contains_id = true;
 			
 			if (!contains_id)
@@ -6724,13 +8139,215 @@ void SLiMSim::DumpMutationTable(void)
 		
 		std::cout << "Mutation index " << mutindex << " has node_id " << node_id << ", site_id " << site_id << ", position " << tables_.sites.position[site_id] << ", parent id " << parent_id << ", derived state length " << derived_state_length << ", metadata length " << metadata_length << std::endl;
 		
+		// derived states in tables_ are derived-state dictionary indices; see DerivedStateDictionaryIndex()
 		std::cout << "   derived state: ";
-		for (size_t mutid_index = 0; mutid_index < derived_state_length / sizeof(slim_mutationid_t); ++mutid_index)
-			std::cout << ((slim_mutationid_t *)derived_state)[mutid_index] << " ";
+		for (size_t entry_position = 0; entry_position < derived_state_length / sizeof(uint32_t); ++entry_position)
+			std::cout << derived_state_dict_[((uint32_t *)derived_state)[entry_position]].mutation_id_ << " ";
 		std::cout << std::endl;
 	}
 }
 
+// Steps a crosscheck walker over its mutations at sites that sampling left unchecked (p_skipped_positions, sorted ascending).
+// A mutation at any other position stops the walker, so a mutation missing from the trees is still caught downstream.
+static void _CrosscheckSkipPositions(GenomeWalker &p_walker, const std::vector<slim_position_t> &p_skipped_positions)
+{
+	size_t skipped_count = p_skipped_positions.size();
+	size_t skipped_index = 0;
+	
+	while (!p_walker.Finished() && (skipped_index < skipped_count))
+	{
+		slim_position_t position = p_walker.Position();
+		
+		while ((skipped_index < skipped_count) && (p_skipped_positions[skipped_index] < position))
+			skipped_index++;
+		
+		if ((skipped_index < skipped_count) && (p_skipped_positions[skipped_index] == position))
+			p_walker.NextMutation();
+		else
+			break;
+	}
+}
+
+// Checks one genome against the variant's allele for it, advancing the walker past the genome's mutations at the variant's
+// position.  This is called from inside a parallel region, so instead of raising it returns false with the error in p_error;
+// p_allele_mutids and p_genome_mutids are per-thread scratch buffers.
+static bool _CrosscheckGenomeAtVariant(GenomeWalker &p_walker, const tsk_variant_t *p_variant, size_t p_sample_index, slim_position_t p_variant_pos, const std::vector<slim_mutationid_t> &p_fixed_mutids, std::vector<slim_mutationid_t> &p_allele_mutids, std::vector<slim_mutationid_t> &p_genome_mutids, std::string &p_error)
+{
+	uint16_t genome_variant = p_variant->genotypes.u16[p_sample_index];
+	tsk_size_t genome_allele_length = p_variant->allele_lengths[genome_variant];
+	
+	if (genome_allele_length % sizeof(slim_mutationid_t) != 0)
+	{
+		std::ostringstream error;
+		error << "ERROR (SLiMSim::CrosscheckTreeSeqIntegrity): (internal error) variant allele had length that was not a multiple of sizeof(slim_mutationid_t).";
+		p_error = error.str();
+		return false;
+	}
+	genome_allele_length /= sizeof(slim_mutationid_t);
+	
+	// BCH 4/29/2018: null genomes shouldn't ever contain any mutations, including fixed mutations
+	if (p_walker.WalkerGenome()->IsNull())
+	{
+		if (genome_allele_length == 0)
+			return true;
+		
+		std::ostringstream error;
+		error << "ERROR (SLiMSim::CrosscheckTreeSeqIntegrity): (internal error) null genome has non-zero treeseq allele length " << genome_allele_length << ".";
+		p_error = error.str();
+		return false;
+	}
+	
+	// (1) if the variant's allele is zero-length, we do nothing (if it incorrectly claims that a genome contains no
+	// mutation, we'll catch that later)  (2) if the variant's allele is the length of one mutation id, we can simply
+	// check that the next mutation in the genome in question exists and has the right mutation id; (3) if the variant's
+	// allele has more than one mutation id, we have to check them all against all the mutations at the given position
+	// in the genome in question, which is a bit annoying since the lists may not be in the same order.  Note that if
+	// the variant is for a mutation that has fixed, it will not be present in the genome; we check for a substitution
+	// with the right ID.
+	const slim_mutationid_t *genome_allele = (const slim_mutationid_t *)p_variant->alleles[genome_variant];
+	
+	if (genome_allele_length == 0)
+	{
+		// If there are no fixed mutations at this site, we can continue; genomes that have a mutation at this site will
+		// raise later when they realize they have been skipped over, so we don't have to check for that now...
+		if (p_fixed_mutids.size() == 0)
+			return true;
+		
+		std::ostringstream error;
+		error << "ERROR (SLiMSim::CrosscheckTreeSeqIntegrity): (internal error) the treeseq has 0 mutations at position " << p_variant_pos << ", SLiM has " << p_fixed_mutids.size() << " fixed mutation(s).";
+		p_error = error.str();
+		return false;
+	}
+	else if (genome_allele_length == 1)
+	{
+		// The tree has just one mutation at this site; this is the common case, so we try to handle it quickly
+		slim_mutationid_t allele_mutid = *genome_allele;
+		Mutation *current_mut = p_walker.CurrentMutation();
+		
+		if (current_mut)
+		{
+			slim_position_t current_mut_pos = current_mut->position_;
+			
+			if (current_mut_pos < p_variant_pos)
+			{
+				std::ostringstream error;
+				error << "ERROR (SLiMSim::CrosscheckTreeSeqIntegrity): (internal error) genome mutation was not represented in trees (single case).";
+				p_error = error.str();
+				return false;
+			}
+			if (current_mut->position_ > p_variant_pos)
+				current_mut = nullptr;	// not a candidate for this position, we'll see it again later
+		}
+		
+		if (!current_mut && (p_fixed_mutids.size() == 1))
+		{
+			// We have one fixed mutation and no segregating mutation, versus one mutation in the tree; crosscheck
+			if (allele_mutid != p_fixed_mutids[0])
+			{
+				std::ostringstream error;
+				error << "ERROR (SLiMSim::CrosscheckTreeSeqIntegrity): (internal error) the treeseq has mutid " << allele_mutid << " at position " << p_variant_pos << ", SLiM has a fixed mutation of id " << p_fixed_mutids[0];
+				p_error = error.str();
+				return false;
+			}
+			
+			return true;	// the match was against a fixed mutation, so don't go to the next mutation
+		}
+		else if (current_mut && (p_fixed_mutids.size() == 0))
+		{
+			// We have one segregating mutation and no fixed mutation, versus one mutation in the tree; crosscheck
+			if (allele_mutid != current_mut->mutation_id_)
+			{
+				std::ostringstream error;
+				error << "ERROR (SLiMSim::CrosscheckTreeSeqIntegrity): (internal error) the treeseq has mutid " << allele_mutid << " at position " << p_variant_pos << ", SLiM has a segregating mutation of id " << current_mut->mutation_id_;
+				p_error = error.str();
+				return false;
+			}
+		}
+		else
+		{
+			// We have a count mismatch; there is one mutation in the tree, but we have !=1 in SLiM including substitutions
+			std::ostringstream error;
+			error << "ERROR (SLiMSim::CrosscheckTreeSeqIntegrity): (internal error) genome/allele size mismatch at position " << p_variant_pos << ": the treeseq has 1 mutation of mutid " << allele_mutid << ", SLiM has " << (current_mut ? 1 : 0) << " segregating and " << p_fixed_mutids.size() << " fixed mutation(s).";
+			p_error = error.str();
+			return false;
+		}
+		
+		p_walker.NextMutation();
+		
+		// Check the next mutation to see if it's at this position as well, and is missing from the tree;
+		// this would get caught downstream, but for debugging it is clearer to catch it here
+		Mutation *next_mut = p_walker.CurrentMutation();
+		
+		if (next_mut && next_mut->position_ == p_variant_pos)
+		{
+			std::ostringstream error;
+			error << "ERROR (SLiMSim::CrosscheckTreeSeqIntegrity): (internal error) the treeseq is missing a stacked mutation with mutid " << next_mut->mutation_id_ << " at position " << p_variant_pos << ".";
+			p_error = error.str();
+			return false;
+		}
+	}
+	else // (genome_allele_length > 1)
+	{
+		p_allele_mutids.clear();
+		p_genome_mutids.clear();
+		
+		// tabulate all tree mutations
+		for (tsk_size_t mutid_index = 0; mutid_index < genome_allele_length; ++mutid_index)
+			p_allele_mutids.push_back(genome_allele[mutid_index]);
+		
+		// tabulate segregating SLiM mutations
+		while (true)
+		{
+			Mutation *current_mut = p_walker.CurrentMutation();
+			
+			if (current_mut)
+			{
+				slim_position_t current_mut_pos = current_mut->position_;
+				
+				if (current_mut_pos < p_variant_pos)
+				{
+					std::ostringstream error;
+					error << "ERROR (SLiMSim::CrosscheckTreeSeqIntegrity): (internal error) genome mutation was not represented in trees (bulk case).";
+					p_error = error.str();
+					return false;
+				}
+				else if (current_mut_pos == p_variant_pos)
+				{
+					p_genome_mutids.push_back(current_mut->mutation_id_);
+					p_walker.NextMutation();
+				}
+				else break;
+			}
+			else break;
+		}
+		
+		// tabulate fixed SLiM mutations
+		p_genome_mutids.insert(p_genome_mutids.end(), p_fixed_mutids.begin(), p_fixed_mutids.end());
+		
+		// crosscheck, sorting so there is no order-dependency
+		if (p_allele_mutids.size() != p_genome_mutids.size())
+		{
+			std::ostringstream error;
+			error << "ERROR (SLiMSim::CrosscheckTreeSeqIntegrity): (internal error) genome/allele size mismatch at position " << p_variant_pos << ": the treeseq has " << p_allele_mutids.size() << " mutations, SLiM has " << (p_genome_mutids.size() - p_fixed_mutids.size()) << " segregating and " << p_fixed_mutids.size() << " fixed mutation(s).";
+			p_error = error.str();
+			return false;
+		}
+		
+		std::sort(p_allele_mutids.begin(), p_allele_mutids.end());
+		std::sort(p_genome_mutids.begin(), p_genome_mutids.end());
+		
+		if (p_allele_mutids != p_genome_mutids)
+		{
+			std::ostringstream error;
+			error << "ERROR (SLiMSim::CrosscheckTreeSeqIntegrity): (internal error) genome/allele bulk mutid mismatch.";
+			p_error = error.str();
+			return false;
+		}
+	}
+	
+	return true;
+}
+
 void SLiMSim::CrosscheckTreeSeqIntegrity(void)
 {
 #if DEBUG
@@ -6738,6 +8355,12 @@ void SLiMSim::CrosscheckTreeSeqIntegrity(void)
 		EIDOS_TERMINATION << "ERROR (SLiMSim::CrosscheckTreeSeqIntegrity): (internal error) tree sequence recording method called with recording off." << EidosTerminate();
 #endif
 	
+	// the tables must be complete, so buffered rows and any simplification in progress on the async thread have to be spliced in first
+	FlushRecordingBuffers();
+	
+	if (async_simplify_pending_)
+		FinishAsyncSimplification();
+	
 	// first crosscheck the substitutions multimap against SLiM's substitutions vector
 	{
 		std::vector<Substitution *> vector_subs = population_.substitutions_;
@@ -6777,13 +8400,32 @@ void SLiMSim::CrosscheckTreeSeqIntegrity(void)
 	// if we're recording mutations, we can check all of them
 	if (recording_mutations_)
 	{
-		// prepare to walk all the genomes by making GenomeWalker objects for them all
-		static std::vector<GenomeWalker> genome_walkers;
-		genome_walkers.clear();
-		genome_walkers.reserve(genome_count);
+		// choose the genomes to check; normally that is all of them, but initializeTreeSeq(crosscheckFraction=...) can ask for a random
+		// subset of genomes and sites per crosscheck.  The sample is drawn from a private generator seeded from the run seed and the
+		// generation, so sampling never perturbs the model's own random number stream, and a rerun checks the same sample.
+		bool sampling = (treeseq_crosschecks_fraction_ < 1.0);
+		gsl_rng *sample_rng = nullptr;
+		std::vector<size_t> check_genome_indices;
+		
+		for (size_t genome_index = 0; genome_index < genome_count; genome_index++)
+			check_genome_indices.push_back(genome_index);
+		
+		if (sampling)
+		{
+			sample_rng = gsl_rng_alloc(gsl_rng_taus2);
+			gsl_rng_set(sample_rng, (unsigned long int)(gEidos_RNG.rng_last_seed_ ^ ((uint64_t)generation_ * 0x9E3779B97F4A7C15ULL)));
+			
+			// a partial Fisher-Yates shuffle picks the genomes, which are then put back in their original order
+			size_t sample_count = std::max((size_t)1, (size_t)std::round(treeseq_crosschecks_fraction_ * genome_count));
+			
+			for (size_t pick_index = 0; pick_index < sample_count; pick_index++)
+				std::swap(check_genome_indices[pick_index], check_genome_indices[pick_index + gsl_rng_uniform_int(sample_rng, genome_count - pick_index)]);
+			
+			check_genome_indices.resize(sample_count);
+			std::sort(check_genome_indices.begin(), check_genome_indices.end());
+		}
 		
-		for (Genome *genome : genomes)
-			genome_walkers.emplace_back(genome);
+		size_t check_count = check_genome_indices.size();
 		
 		// make a copy of the full table collection, so that we can sort/clean/simplify without modifying anything
 		int ret;
@@ -6793,23 +8435,26 @@ void SLiMSim::CrosscheckTreeSeqIntegrity(void)
 		ret = tsk_table_collection_copy(&tables_, tables_copy, 0);
 		if (ret != 0) handle_error("CrosscheckTreeSeqIntegrity tsk_table_collection_copy()", ret);
 		
+		// the alleles checked below are full derived states, not derived-state dictionary indices
+		ExpandDerivedStates(tables_copy);
+		
 		// our tables copy needs to have a population table now, since this is required to build a tree sequence
 		WritePopulationTable(tables_copy);
 		
 		// simplify before making our tree_sequence object; the sort and deduplicate and compute parents are required for the crosscheck, whereas the simplify
 		// could perhaps be removed, which would cause the tsk_vargen_t to visit a bunch of stuff unrelated to the current individuals.
 		// this code is adapted from SLiMSim::SimplifyTreeSequence(), but we don't need to update the TSK map table or the table position,
-		// and we simplify down to just the extant individuals since we can't cross-check older individuals anyway...
+		// and we simplify down to just the genomes being checked since we can't cross-check older individuals anyway; the simplified
+		// samples are then in the same order as genome_walkers below...
 		if (tables_copy->nodes.num_rows != 0)
 		{
 			std::vector<tsk_id_t> samples;
 			
-			for (auto iter = population_.subpops_.begin(); iter != population_.subpops_.end(); iter++)
-				for (Genome *genome : iter->second->parent_genomes_)
-					samples.push_back(genome->tsk_node_id_);
+			for (size_t genome_index : check_genome_indices)
+				samples.push_back(genomes[genome_index]->tsk_node_id_);
 			
-			ret = tsk_table_collection_sort(tables_copy, /* edge_start */ 0, /* flags */ 0);
-			if (ret < 0) handle_error("tsk_table_collection_sort", ret);
+			// the copy has the same edge order as tables_, so the same sorted prefix applies
+			SortTreeSequenceTables(tables_copy, sorted_edge_count_);
 			
 			ret = tsk_table_collection_deduplicate_sites(tables_copy, 0);
 			if (ret < 0) handle_error("tsk_table_collection_deduplicate_sites", ret);
@@ -6833,6 +8478,13 @@ void SLiMSim::CrosscheckTreeSeqIntegrity(void)
 		ret = tsk_treeseq_init(ts, tables_copy, TSK_BUILD_INDEXES);
 		if (ret != 0) handle_error("CrosscheckTreeSeqIntegrity tsk_treeseq_init()", ret);
 		
+		// prepare to walk the checked genomes by making GenomeWalker objects for them all
+		std::vector<GenomeWalker> genome_walkers;
+		genome_walkers.reserve(check_count);
+		
+		for (size_t genome_index : check_genome_indices)
+			genome_walkers.emplace_back(genomes[genome_index]);
+		
 		// allocate and set up the vargen object we'll use to walk through variants
 		tsk_vargen_t *vg;
 		
@@ -6840,174 +8492,143 @@ void SLiMSim::CrosscheckTreeSeqIntegrity(void)
 		ret = tsk_vargen_init(vg, ts, ts->samples, ts->num_samples, TSK_16_BIT_GENOTYPES);
 		if (ret != 0) handle_error("CrosscheckTreeSeqIntegrity tsk_vargen_alloc()", ret);
 		
-		// crosscheck by looping through variants
-		do
-		{
-			tsk_variant_t *variant;
-			
-			ret = tsk_vargen_next(vg, &variant);
-			if (ret < 0) handle_error("CrosscheckTreeSeqIntegrity tsk_vargen_next()", ret);
-			
-			if (ret == 1)
+		// positions of sites left unchecked by sampling since the last checked site; the walkers step over mutations at these
+		std::vector<slim_position_t> skipped_positions;
+		std::vector<slim_mutationid_t> fixed_mutids;
+		
+		// crosscheck by looping through variants.  Each genome's check touches only its own walker, so genomes are checked in parallel;
+		// the team is started once, and each site's serial work (advancing the tsk_vargen_t, sampling, and looking up substitutions)
+		// is done by a single thread before the genomes are divided up.  Errors cannot be raised inside the parallel region, so the
+		// error for the lowest-indexed failing genome is kept and raised afterwards, which gives the same message as a serial check.
+		tsk_variant_t *variant = nullptr;
+		slim_position_t variant_pos_int = 0;
+		const uint16_t *genotypes = nullptr;
+		const tsk_size_t *allele_lengths = nullptr;
+		bool quick_screen = false;
+		bool more_sites = true;
+		size_t error_index = SIZE_MAX;
+		std::string error_message;
+		double crosscheck_fraction = treeseq_crosschecks_fraction_;
+		auto &substitutions_map = population_.treeseq_substitutions_map_;
+		
+#pragma omp parallel num_threads(gEidosMaxThreads) default(none) shared(ret, vg, sampling, sample_rng, crosscheck_fraction, substitutions_map, check_count, genome_walkers, variant, variant_pos_int, fixed_mutids, skipped_positions, error_index, error_message, genotypes, allele_lengths, quick_screen, more_sites) if(check_count >= 1000)
+		{
+			std::vector<slim_mutationid_t> allele_mutids;
+			std::vector<slim_mutationid_t> genome_mutids;
+			std::string error;
+			
+			while (true)
 			{
-				// We have a new variant; check it against SLiM.  A variant represents a site at which a tracked mutation exists.
-				// The tsk_variant_t will tell us all the allelic states involved at that site, what the alleles are, and which genomes
-				// in the sample are using them.  We will then check that all the genomes that the variant claims to involve have
-				// the allele the variant attributes to them, and that no genomes contain any alleles at the position that are not
-				// described by the variant.  The variants are returned in sorted order by position, so we can keep pointers into
-				// every extant genome's mutruns, advance those pointers a step at a time, and check that everything matches at every
-				// step.  Keep in mind that some mutations may have been fixed (substituted) or lost.
-				slim_position_t variant_pos_int = (slim_position_t)variant->site->position;		// should be no loss of precision, fingers crossed
-				
-				// Get all the substitutions involved at this site, which should be present in every sample
-				auto substitution_range_iter = population_.treeseq_substitutions_map_.equal_range(variant_pos_int);
-				static std::vector<slim_mutationid_t> fixed_mutids;
-				
-				fixed_mutids.clear();
-				for (auto substitution_iter = substitution_range_iter.first; substitution_iter != substitution_range_iter.second; ++substitution_iter)
-					fixed_mutids.push_back(substitution_iter->second->mutation_id_);
-				
-				// Check all the genomes against the tsk_vargen_t's belief about this site
-				for (size_t genome_index = 0; genome_index < genome_count; genome_index++)
+#pragma omp single
 				{
-					GenomeWalker &genome_walker = genome_walkers[genome_index];
-					uint16_t genome_variant = variant->genotypes.u16[genome_index];
-					tsk_size_t genome_allele_length = variant->allele_lengths[genome_variant];
-					
-					if (genome_allele_length % sizeof(slim_mutationid_t) != 0)
-						EIDOS_TERMINATION << "ERROR (SLiMSim::CrosscheckTreeSeqIntegrity): (internal error) variant allele had length that was not a multiple of sizeof(slim_mutationid_t)." << EidosTerminate();
-					genome_allele_length /= sizeof(slim_mutationid_t);
-					
-					//std::cout << "variant for genome: " << (int)genome_variant << " (allele length == " << genome_allele_length << ")" << std::endl;
-					
-					// BCH 4/29/2018: null genomes shouldn't ever contain any mutations, including fixed mutations
-					if (genome_walker.WalkerGenome()->IsNull())
-					{
-						if (genome_allele_length == 0)
-							continue;
-						
-						EIDOS_TERMINATION << "ERROR (SLiMSim::CrosscheckTreeSeqIntegrity): (internal error) null genome has non-zero treeseq allele length " << genome_allele_length << "." << EidosTerminate();
-					}
+					// the sites skipped before the last checked site were stepped over by its check
+					skipped_positions.clear();
 					
-					// (1) if the variant's allele is zero-length, we do nothing (if it incorrectly claims that a genome contains no
-					// mutation, we'll catch that later)  (2) if the variant's allele is the length of one mutation id, we can simply
-					// check that the next mutation in the genome in question exists and has the right mutation id; (3) if the variant's
-					// allele has more than one mutation id, we have to check them all against all the mutations at the given position
-					// in the genome in question, which is a bit annoying since the lists may not be in the same order.  Note that if
-					// the variant is for a mutation that has fixed, it will not be present in the genome; we check for a substitution
-					// with the right ID.
-					slim_mutationid_t *genome_allele = (slim_mutationid_t *)variant->alleles[genome_variant];
-					
-					if (genome_allele_length == 0)
-					{
-						// If there are no fixed mutations at this site, we can continue; genomes that have a mutation at this site will
-						// raise later when they realize they have been skipped over, so we don't have to check for that now...
-						if (fixed_mutids.size() == 0)
-							continue;
-						
-						EIDOS_TERMINATION << "ERROR (SLiMSim::CrosscheckTreeSeqIntegrity): (internal error) the treeseq has 0 mutations at position " << variant_pos_int << ", SLiM has " << fixed_mutids.size() << " fixed mutation(s)." << EidosTerminate();
-					}
-					else if (genome_allele_length == 1)
+					while (true)
 					{
-						// The tree has just one mutation at this site; this is the common case, so we try to handle it quickly
-						slim_mutationid_t allele_mutid = *genome_allele;
-						Mutation *current_mut = genome_walker.CurrentMutation();
+						ret = tsk_vargen_next(vg, &variant);
 						
-						if (current_mut)
+						if (ret != 1)
 						{
-							slim_position_t current_mut_pos = current_mut->position_;
-							
-							if (current_mut_pos < variant_pos_int)
-								EIDOS_TERMINATION << "ERROR (SLiMSim::CrosscheckTreeSeqIntegrity): (internal error) genome mutation was not represented in trees (single case)." << EidosTerminate();
-							if (current_mut->position_ > variant_pos_int)
-								current_mut = nullptr;	// not a candidate for this position, we'll see it again later
+							// no more variants, or an error that is handled after the parallel region
+							more_sites = false;
+							break;
 						}
 						
-						if (!current_mut && (fixed_mutids.size() == 1))
-						{
-							// We have one fixed mutation and no segregating mutation, versus one mutation in the tree; crosscheck
-							if (allele_mutid != fixed_mutids[0])
-								EIDOS_TERMINATION << "ERROR (SLiMSim::CrosscheckTreeSeqIntegrity): (internal error) the treeseq has mutid " << allele_mutid << " at position " << variant_pos_int << ", SLiM has a fixed mutation of id " << fixed_mutids[0] << EidosTerminate();
-							
-							continue;	// the match was against a fixed mutation, so don't go to the next mutation
-						}
-						else if (current_mut && (fixed_mutids.size() == 0))
-						{
-							// We have one segregating mutation and no fixed mutation, versus one mutation in the tree; crosscheck
-							if (allele_mutid != current_mut->mutation_id_)
-								EIDOS_TERMINATION << "ERROR (SLiMSim::CrosscheckTreeSeqIntegrity): (internal error) the treeseq has mutid " << allele_mutid << " at position " << variant_pos_int << ", SLiM has a segregating mutation of id " << current_mut->mutation_id_ << EidosTerminate();
-						}
-						else
+						// We have a new variant; check it against SLiM.  A variant represents a site at which a tracked mutation exists.
+						// The tsk_variant_t will tell us all the allelic states involved at that site, what the alleles are, and which genomes
+						// in the sample are using them.  We will then check that all the genomes that the variant claims to involve have
+						// the allele the variant attributes to them, and that no genomes contain any alleles at the position that are not
+						// described by the variant.  The variants are returned in sorted order by position, so we can keep pointers into
+						// every extant genome's mutruns, advance those pointers a step at a time, and check that everything matches at every
+						// step.  Keep in mind that some mutations may have been fixed (substituted) or lost.
+						variant_pos_int = (slim_position_t)variant->site->position;		// should be no loss of precision, fingers crossed
+						
+						if (sampling && (gsl_rng_uniform(sample_rng) >= crosscheck_fraction))
 						{
-							// We have a count mismatch; there is one mutation in the tree, but we have !=1 in SLiM including substitutions
-							EIDOS_TERMINATION << "ERROR (SLiMSim::CrosscheckTreeSeqIntegrity): (internal error) genome/allele size mismatch at position " << variant_pos_int << ": the treeseq has 1 mutation of mutid " << allele_mutid << ", SLiM has " << (current_mut ? 1 : 0) << " segregating and " << fixed_mutids.size() << " fixed mutation(s)." << EidosTerminate();
+							skipped_positions.push_back(variant_pos_int);
+							continue;
 						}
 						
-						genome_walker.NextMutation();
+						// Get all the substitutions involved at this site, which should be present in every sample
+						auto substitution_range_iter = substitutions_map.equal_range(variant_pos_int);
 						
-						// Check the next mutation to see if it's at this position as well, and is missing from the tree;
-						// this would get caught downstream, but for debugging it is clearer to catch it here
-						Mutation *next_mut = genome_walker.CurrentMutation();
+						fixed_mutids.clear();
+						for (auto substitution_iter = substitution_range_iter.first; substitution_iter != substitution_range_iter.second; ++substitution_iter)
+							fixed_mutids.push_back(substitution_iter->second->mutation_id_);
 						
-						if (next_mut && next_mut->position_ == variant_pos_int)
-							EIDOS_TERMINATION << "ERROR (SLiMSim::CrosscheckTreeSeqIntegrity): (internal error) the treeseq is missing a stacked mutation with mutid " << next_mut->mutation_id_ << " at position " << variant_pos_int << "." << EidosTerminate();
+						// Most genomes carry the ancestral state at most sites; with nothing fixed or skipped here they need no work at all,
+						// since a mutation they carry at this position is caught as unrepresented at the next site, so they are screened inline
+						genotypes = variant->genotypes.u16;
+						allele_lengths = variant->allele_lengths;
+						quick_screen = fixed_mutids.empty() && skipped_positions.empty();
+						break;
 					}
-					else // (genome_allele_length > 1)
+				}
+				
+				// the shared state read here is not written again until every thread has passed the barrier at the end of the loop below
+				if (!more_sites)
+					break;
+				
+				// Check all the genomes against the tsk_vargen_t's belief about this site
+#pragma omp for schedule(static)
+				for (size_t check_index = 0; check_index < check_count; check_index++)
+				{
+					if (quick_screen && (allele_lengths[genotypes[check_index]] == 0))
+						continue;
+					
+					GenomeWalker &genome_walker = genome_walkers[check_index];
+					
+					if (!skipped_positions.empty())
+						_CrosscheckSkipPositions(genome_walker, skipped_positions);
+					
+					if (!_CrosscheckGenomeAtVariant(genome_walker, variant, check_index, variant_pos_int, fixed_mutids, allele_mutids, genome_mutids, error))
 					{
-						static std::vector<slim_mutationid_t> allele_mutids;
-						static std::vector<slim_mutationid_t> genome_mutids;
-						allele_mutids.clear();
-						genome_mutids.clear();
-						
-						// tabulate all tree mutations
-						for (tsk_size_t mutid_index = 0; mutid_index < genome_allele_length; ++mutid_index)
-							allele_mutids.push_back(genome_allele[mutid_index]);
-						
-						// tabulate segregating SLiM mutations
-						while (true)
+#pragma omp critical (SLiM_CrosscheckError)
 						{
-							Mutation *current_mut = genome_walker.CurrentMutation();
-							
-							if (current_mut)
+							if (check_index < error_index)
 							{
-								slim_position_t current_mut_pos = current_mut->position_;
-								
-								if (current_mut_pos < variant_pos_int)
-									EIDOS_TERMINATION << "ERROR (SLiMSim::CrosscheckTreeSeqIntegrity): (internal error) genome mutation was not represented in trees (bulk case)." << EidosTerminate();
-								else if (current_mut_pos == variant_pos_int)
-								{
-									genome_mutids.push_back(current_mut->mutation_id_);
-									genome_walker.NextMutation();
-								}
-								else break;
+								error_index = check_index;
+								error_message = error;
 							}
-							else break;
 						}
-						
-						// tabulate fixed SLiM mutations
-						genome_mutids.insert(genome_mutids.end(), fixed_mutids.begin(), fixed_mutids.end());
-						
-						// crosscheck, sorting so there is no order-dependency
-						if (allele_mutids.size() != genome_mutids.size())
-							EIDOS_TERMINATION << "ERROR (SLiMSim::CrosscheckTreeSeqIntegrity): (internal error) genome/allele size mismatch at position " << variant_pos_int << ": the treeseq has " << allele_mutids.size() << " mutations, SLiM has " << (genome_mutids.size() - fixed_mutids.size()) << " segregating and " << fixed_mutids.size() << " fixed mutation(s)." << EidosTerminate();
-						
-						std::sort(allele_mutids.begin(), allele_mutids.end());
-						std::sort(genome_mutids.begin(), genome_mutids.end());
-						
-						for (tsk_size_t mutid_index = 0; mutid_index < genome_allele_length; ++mutid_index)
-							if (allele_mutids[mutid_index] != genome_mutids[mutid_index])
-								EIDOS_TERMINATION << "ERROR (SLiMSim::CrosscheckTreeSeqIntegrity): (internal error) genome/allele bulk mutid mismatch." << EidosTerminate();
 					}
 				}
+				
+				// error_index is only ever set at the first failing site, so every thread sees the same value here and stops together
+				if (error_index != SIZE_MAX)
+					break;
 			}
 		}
-		while (ret != 0);
+		
+		if (ret < 0)
+		{
+			if (sample_rng)
+				gsl_rng_free(sample_rng);
+			
+			handle_error("CrosscheckTreeSeqIntegrity tsk_vargen_next()", ret);
+		}
+		
+		if (error_index != SIZE_MAX)
+		{
+			if (sample_rng)
+				gsl_rng_free(sample_rng);
+			
+			EIDOS_TERMINATION << error_message << EidosTerminate();
+		}
+		
+		if (sample_rng)
+			gsl_rng_free(sample_rng);
 		
 		// we have finished all variants, so all the genomes we're tracking should be at their ends; any left-over mutations
 		// should have been in the trees but weren't, so this is an error
-		for (size_t genome_index = 0; genome_index < genome_count; genome_index++)
-			if (!genome_walkers[genome_index].Finished())
+		for (size_t check_index = 0; check_index < check_count; check_index++)
+		{
+			_CrosscheckSkipPositions(genome_walkers[check_index], skipped_positions);
+			
+			if (!genome_walkers[check_index].Finished())
 				EIDOS_TERMINATION << "ERROR (SLiMSim::CrosscheckTreeSeqIntegrity): (internal error) mutations left in genome beyond those in tree." << EidosTerminate();
+		}
 		
 		// free
 		ret = tsk_vargen_free(vg);
@@ -7203,7 +8824,7 @@ void SLiMSim::__TabulateSubpopulationsFromTreeSequence(std::unordered_map<slim_o
 	}
 }
 
-void SLiMSim::__CreateSubpopulationsFromTabulation(std::unordered_map<slim_objectid_t, ts_subpop_info> &p_subpopInfoMap, EidosInterpreter *p_interpreter, std::unordered_map<tsk_id_t, Genome *> &p_nodeToGenomeMap)
+void SLiMSim::__CreateSubpopulationsFromTabulation(std::unordered_map<slim_objectid_t, ts_subpop_info> &p_subpopInfoMap, EidosInterpreter *p_interpreter, std::vector<Genome *> &p_nodeToGenomeMap)
 {
 	gSLiM_next_pedigree_id = 0;
 	
@@ -7264,8 +8885,8 @@ void SLiMSim::__CreateSubpopulationsFromTabulation(std::unordered_map<slim_objec
 				individual->genome1_->tsk_node_id_ = node_id_0;
 				individual->genome2_->tsk_node_id_ = node_id_1;
 				
-				p_nodeToGenomeMap.insert(std::pair<tsk_id_t, Genome *>(node_id_0, individual->genome1_));
-				p_nodeToGenomeMap.insert(std::pair<tsk_id_t, Genome *>(node_id_1, individual->genome2_));
+				p_nodeToGenomeMap[node_id_0] = individual->genome1_;
+				p_nodeToGenomeMap[node_id_1] = individual->genome2_;
 				
 				slim_pedigreeid_t pedigree_id = subpop_info.pedigreeID_[tabulation_index];
 				individual->SetPedigreeID(pedigree_id);
@@ -7430,12 +9051,13 @@ void SLiMSim::__ConfigureSubpopulationsFromTables(EidosInterpreter *p_interprete
 }
 
 typedef struct ts_mut_info {
+	slim_mutationid_t mutation_id;
 	slim_position_t position;
-	MutationMetadataRec *metadata;
+	MutationMetadataRec metadata;
 	slim_refcount_t ref_count;
 } ts_mut_info;
 
-void SLiMSim::__TabulateMutationsFromTables(std::unordered_map<slim_mutationid_t, ts_mut_info> &p_mutMap, int p_file_version)
+void SLiMSim::__TabulateMutationsFromTables(std::vector<ts_mut_info> &p_mutInfo, std::vector<int32_t> &p_stackToMutInfo, int p_file_version)
 {
 	std::size_t metadata_rec_size = ((p_file_version < 3) ? sizeof(MutationMetadataRec_PRENUC) : sizeof(MutationMetadataRec));
 	tsk_mutation_table_t &mut_table = tables_.mutations;
@@ -7444,11 +9066,11 @@ void SLiMSim::__TabulateMutationsFromTables(std::unordered_map<slim_mutationid_t
 	if ((mut_count > 0) && !recording_mutations_)
 		EIDOS_TERMINATION << "ERROR (SLiMSim::__TabulateMutationsFromTables): cannot load mutations when mutation recording is disabled." << EidosTerminate();
 	
+	// check the lengths first; after this, the derived state column is a flat vector of mutation ids, with one entry per stacked
+	// mutation in the table, and the metadata column is a parallel vector of metadata records
 	for (tsk_size_t mut_index = 0; mut_index < mut_count; ++mut_index)
 	{
-		const char *derived_state_bytes = mut_table.derived_state + mut_table.derived_state_offset[mut_index];
 		tsk_size_t derived_state_length = mut_table.derived_state_offset[mut_index + 1] - mut_table.derived_state_offset[mut_index];
-		const char *metadata_bytes = mut_table.metadata + mut_table.metadata_offset[mut_index];
 		tsk_size_t metadata_length = mut_table.metadata_offset[mut_index + 1] - mut_table.metadata_offset[mut_index];
 		
 		if (derived_state_length % sizeof(slim_mutationid_t) != 0)
@@ -7457,10 +9079,40 @@ void SLiMSim::__TabulateMutationsFromTables(std::unordered_map<slim_mutationid_t
 			EIDOS_TERMINATION << "ERROR (SLiMSim::__TabulateMutationsFromTables): unexpected mutation metadata length; this file cannot be read." << EidosTerminate();
 		if (derived_state_length / sizeof(slim_mutationid_t) != metadata_length / metadata_rec_size)
 			EIDOS_TERMINATION << "ERROR (SLiMSim::__TabulateMutationsFromTables): (internal error) mutation metadata length does not match derived state length." << EidosTerminate();
-		
-		int stack_count = derived_state_length / sizeof(slim_mutationid_t);
-		slim_mutationid_t *derived_state_vec = (slim_mutationid_t *)derived_state_bytes;
-		const void *metadata_vec = metadata_bytes;	// either const MutationMetadataRec* or const MutationMetadataRec_PRENUC*
+	}
+	
+	// assign each distinct mutation id a dense index, in sorted order of mutation id; this replaces a hash table keyed by id
+	int64_t stack_total = (int64_t)(mut_table.derived_state_length / sizeof(slim_mutationid_t));
+	const slim_mutationid_t *stack_ids = (const slim_mutationid_t *)mut_table.derived_state;
+	std::vector<slim_mutationid_t> mut_ids(stack_ids, stack_ids + stack_total);
+	
+	std::sort(mut_ids.begin(), mut_ids.end());
+	mut_ids.erase(std::unique(mut_ids.begin(), mut_ids.end()), mut_ids.end());
+	
+	const slim_mutationid_t *mut_ids_begin = mut_ids.data();
+	const slim_mutationid_t *mut_ids_end = mut_ids_begin + mut_ids.size();
+	int32_t *stack_to_mut_info;
+	
+	p_stackToMutInfo.resize(stack_total);
+	stack_to_mut_info = p_stackToMutInfo.data();
+	
+#pragma omp parallel for num_threads(gEidosMaxThreads) schedule(static) default(none) shared(stack_total, stack_ids, mut_ids_begin, mut_ids_end, stack_to_mut_info) if(stack_total >= 10000)
+	for (int64_t stack_index = 0; stack_index < stack_total; ++stack_index)
+		stack_to_mut_info[stack_index] = (int32_t)(std::lower_bound(mut_ids_begin, mut_ids_end, stack_ids[stack_index]) - mut_ids_begin);
+	
+	p_mutInfo.resize(mut_ids.size());
+	
+	for (size_t info_index = 0; info_index < mut_ids.size(); ++info_index)
+	{
+		p_mutInfo[info_index].mutation_id = mut_ids[info_index];
+		p_mutInfo[info_index].ref_count = 0;
+	}
+	
+	for (tsk_size_t mut_index = 0; mut_index < mut_count; ++mut_index)
+	{
+		int64_t stack_start = (int64_t)(mut_table.derived_state_offset[mut_index] / sizeof(slim_mutationid_t));
+		int stack_count = (int)((mut_table.derived_state_offset[mut_index + 1] - mut_table.derived_state_offset[mut_index]) / sizeof(slim_mutationid_t));
+		const char *metadata_vec = mut_table.metadata + mut_table.metadata_offset[mut_index];	// either MutationMetadataRec or MutationMetadataRec_PRENUC records
 		tsk_id_t site_id = mut_table.site[mut_index];
 		double position_double = tables_.sites.position[site_id];
 		double position_double_round = round(position_double);
@@ -7473,120 +9125,149 @@ void SLiMSim::__TabulateMutationsFromTables(std::unordered_map<slim_mutationid_t
 		// tabulate the mutations referenced by this entry, overwriting previous tabulations (last state wins)
 		for (int stack_index = 0; stack_index < stack_count; ++stack_index)
 		{
-			slim_mutationid_t mut_id = derived_state_vec[stack_index];
-			auto mut_info_insert = p_mutMap.insert(std::pair<slim_mutationid_t, ts_mut_info>(mut_id, ts_mut_info()));
-			ts_mut_info &mut_info = (mut_info_insert.first)->second;
+			ts_mut_info &mut_info = p_mutInfo[stack_to_mut_info[stack_start + stack_index]];
 			
 			mut_info.position = position;
 			
 			// This method handles the fact that a file version of 2 or below will not contain a nucleotide field for its mutation metadata.
 			// We hide this fact from the rest of the initialization code; ts_mut_info uses MutationMetadataRec, and we fill in a value of
-			// -1 for the nucleotide_ field if we are using MutationMetadataRec_PRENUC due to the file version.
+			// -1 for the nucleotide_ field if we are using MutationMetadataRec_PRENUC due to the file version.  The records are copied
+			// with memcpy() because they are packed, and so may be misaligned; see __CreateMutationsFromTabulation() (BCH 4/25/2019)
 			if (p_file_version < 3)
 			{
-				MutationMetadataRec_PRENUC *prenuc_metadata = (MutationMetadataRec_PRENUC *)metadata_vec + stack_index;
+				MutationMetadataRec_PRENUC prenuc_metadata;
 				
-				mut_info.metadata->mutation_type_id_ = prenuc_metadata->mutation_type_id_;
-				mut_info.metadata->selection_coeff_ = prenuc_metadata->selection_coeff_;
-				mut_info.metadata->subpop_index_ = prenuc_metadata->subpop_index_;
-				mut_info.metadata->origin_generation_ = prenuc_metadata->origin_generation_;
-				mut_info.metadata->nucleotide_ = -1;
+				memcpy(&prenuc_metadata, metadata_vec + stack_index * sizeof(MutationMetadataRec_PRENUC), sizeof(MutationMetadataRec_PRENUC));
+				
+				mut_info.metadata.mutation_type_id_ = prenuc_metadata.mutation_type_id_;
+				mut_info.metadata.selection_coeff_ = prenuc_metadata.selection_coeff_;
+				mut_info.metadata.subpop_index_ = prenuc_metadata.subpop_index_;
+				mut_info.metadata.origin_generation_ = prenuc_metadata.origin_generation_;
+				mut_info.metadata.nucleotide_ = -1;
 			}
 			else
 			{
-				mut_info.metadata = (MutationMetadataRec *)metadata_vec + stack_index;
+				memcpy(&mut_info.metadata, metadata_vec + stack_index * sizeof(MutationMetadataRec), sizeof(MutationMetadataRec));
 			}
 		}
 	}
 }
 
-void SLiMSim::__TallyMutationReferencesWithTreeSequence(std::unordered_map<slim_mutationid_t, ts_mut_info> &p_mutMap, std::unordered_map<tsk_id_t, Genome *> p_nodeToGenomeMap, tsk_treeseq_t *p_ts)
+void SLiMSim::__TallyMutationReferencesWithTreeSequence(std::vector<ts_mut_info> &p_mutInfo, std::vector<int32_t> &p_stackToMutInfo, std::vector<Genome *> &p_sampleToGenomeMap, std::vector<tsk_size_t> &p_sampleRowOffsets, std::vector<tsk_id_t> &p_sampleRows, tsk_treeseq_t *p_ts)
 {
-	// allocate and set up the vargen object we'll use to walk through variants
-	tsk_vargen_t *vg;
+	// This walks the trees with sample lists, rather than walking variants with a tsk_vargen_t.  A mutation's derived state
+	// (the full stack of mutation ids at its site) applies to all of the samples below its node, and mutations at a site are
+	// in parent-before-child order, so the last mutation to reach a sample gives its state.  The work done is thus proportional
+	// to the number of carriers of each mutation, not to the number of samples times the number of sites.  As a side effect,
+	// we record which mutation table rows each extant genome carries, in order of position, for __AddMutationsFromTreeSequenceToGenomes().
+	size_t sample_count = p_ts->num_samples;
 	
-	vg = (tsk_vargen_t *)malloc(sizeof(tsk_vargen_t));
-	int ret = tsk_vargen_init(vg, p_ts, p_ts->samples, p_ts->num_samples, TSK_16_BIT_GENOTYPES);
-	if (ret != 0) handle_error("__TallyMutationReferencesWithTreeSequence tsk_vargen_init()", ret);
+	p_sampleRowOffsets.assign(sample_count + 1, 0);
+	p_sampleRows.clear();
 	
-	// set up a map from sample indices in the vargen to Genome objects; the sample
-	// may contain nodes that are ancestral and need to be excluded
-	std::vector<Genome *> indexToGenomeMap;
-	size_t sample_count = vg->num_samples;
+	if (!recording_mutations_)
+		return;
 	
-	for (size_t sample_index = 0; sample_index < sample_count; ++sample_index)
-	{
-		tsk_id_t sample_node_id = vg->samples[sample_index];
-		auto sample_nodeToGenome_iter = p_nodeToGenomeMap.find(sample_node_id);
-		
-		if (sample_nodeToGenome_iter != p_nodeToGenomeMap.end())
-			indexToGenomeMap.push_back(sample_nodeToGenome_iter->second);
-		else
-			indexToGenomeMap.push_back(nullptr);	// this sample is not extant; no corresponding genome
-	}
+	tsk_mutation_table_t &mut_table = tables_.mutations;
+	std::vector<tsk_id_t> sample_state(sample_count, TSK_NULL);	// for each sample index, the mutation row that determines its state
+	std::vector<tsk_id_t> sample_site(sample_count, TSK_NULL);		// for each sample index, the last site at which it was touched
+	std::vector<tsk_id_t> touched_samples;
+	std::vector<slim_refcount_t> row_ref_counts(mut_table.num_rows, 0);
+	std::vector<std::pair<tsk_id_t, tsk_id_t>> carried_rows;		// (sample index, mutation row) pairs, in order of position
+	tsk_tree_t tree;
+	int ret;
 	
-	// add mutations to genomes by looping through variants
-	do
+	ret = tsk_tree_init(&tree, p_ts, TSK_SAMPLE_LISTS);
+	if (ret < 0) handle_error("__TallyMutationReferencesWithTreeSequence tsk_tree_init()", ret);
+	
+	for (ret = tsk_tree_first(&tree); ret == 1; ret = tsk_tree_next(&tree))
 	{
-		tsk_variant_t *variant;
-		
-		ret = tsk_vargen_next(vg, &variant);
-		if (ret < 0) handle_error("__TallyMutationReferencesWithTreeSequence tsk_vargen_next()", ret);
-		
-		if (ret == 1)
+		for (tsk_size_t site_index = 0; site_index < tree.sites_length; ++site_index)
 		{
-			// We have a new variant; set it into SLiM.  A variant represents a site at which a tracked mutation exists.
-			// The tsk_variant_t will tell us all the allelic states involved at that site, what the alleles are, and which genomes
-			// in the sample are using them.  We want to find any mutations that are shared across all non-null genomes.
-			for (tsk_size_t allele_index = 0; allele_index < variant->num_alleles; ++allele_index)
+			tsk_site_t &site = tree.sites[site_index];
+			
+			touched_samples.clear();
+			
+			for (tsk_size_t mut_index = 0; mut_index < site.mutations_length; ++mut_index)
 			{
-				tsk_size_t allele_length = variant->allele_lengths[allele_index];
+				const tsk_mutation_t &mutation = site.mutations[mut_index];
+				tsk_id_t sample_index = tree.left_sample[mutation.node];
+				tsk_id_t last_sample_index = tree.right_sample[mutation.node];
 				
-				if (allele_length > 0)
+				while (sample_index != TSK_NULL)
 				{
-					// Calculate the number of extant genomes that reference this allele
-					int32_t allele_refs = 0;
-					
-					for (size_t sample_index = 0; sample_index < sample_count; sample_index++)
-						if ((variant->genotypes.u16[sample_index] == allele_index) && (indexToGenomeMap[sample_index] != nullptr))
-							allele_refs++;
-					
-					// If that count is greater than zero (might be zero if only non-extant nodes reference the allele), tally it
-					if (allele_refs)
+					if (sample_site[sample_index] != site.id)
 					{
-						if (allele_length % sizeof(slim_mutationid_t) != 0)
-							EIDOS_TERMINATION << "ERROR (SLiMSim::__TallyMutationReferencesWithTreeSequence): (internal error) variant allele had length that was not a multiple of sizeof(slim_mutationid_t)." << EidosTerminate();
-						allele_length /= sizeof(slim_mutationid_t);
-						
-						slim_mutationid_t *allele = (slim_mutationid_t *)variant->alleles[allele_index];
-						
-						for (tsk_size_t mutid_index = 0; mutid_index < allele_length; ++mutid_index)
-						{
-							slim_mutationid_t mut_id = allele[mutid_index];
-							auto mut_info_iter = p_mutMap.find(mut_id);
-							
-							if (mut_info_iter == p_mutMap.end())
-								EIDOS_TERMINATION << "ERROR (SLiMSim::__TallyMutationReferencesWithTreeSequence): mutation id " << mut_id << " was referenced but does not exist." << EidosTerminate();
-							
-							// Add allele_refs to the refcount for this mutation
-							ts_mut_info &mut_info = mut_info_iter->second;
-							
-							mut_info.ref_count += allele_refs;
-						}
+						sample_site[sample_index] = site.id;
+						touched_samples.emplace_back(sample_index);
 					}
+					
+					sample_state[sample_index] = mutation.id;
+					
+					if (sample_index == last_sample_index)
+						break;
+					
+					sample_index = tree.next_sample[sample_index];
 				}
 			}
+			
+			for (tsk_id_t sample_index : touched_samples)
+			{
+				Genome *genome = p_sampleToGenomeMap[sample_index];
+				
+				if (!genome)
+					continue;	// this sample is not extant
+				
+				tsk_id_t row = sample_state[sample_index];
+				tsk_size_t derived_state_length = mut_table.derived_state_offset[row + 1] - mut_table.derived_state_offset[row];
+				
+				if (derived_state_length == 0)
+					continue;
+				
+				if (genome->IsNull())
+					EIDOS_TERMINATION << "ERROR (SLiMSim::__TallyMutationReferencesWithTreeSequence): (internal error) null genome has non-zero treeseq allele length " << (derived_state_length / sizeof(slim_mutationid_t)) << "." << EidosTerminate();
+				
+				row_ref_counts[row]++;
+				carried_rows.emplace_back(sample_index, row);
+			}
 		}
 	}
-	while (ret != 0);
+	if (ret < 0) handle_error("__TallyMutationReferencesWithTreeSequence tsk_tree_next()", ret);
 	
-	// free
-	ret = tsk_vargen_free(vg);
-	if (ret != 0) handle_error("__TallyMutationReferencesWithTreeSequence tsk_vargen_free()", ret);
-	free(vg);
+	ret = tsk_tree_free(&tree);
+	if (ret < 0) handle_error("__TallyMutationReferencesWithTreeSequence tsk_tree_free()", ret);
+	
+	// add the references to each row to the refcounts of the mutations stacked in it
+	for (tsk_size_t row = 0; row < mut_table.num_rows; ++row)
+	{
+		slim_refcount_t row_ref_count = row_ref_counts[row];
+		
+		if (row_ref_count)
+		{
+			tsk_size_t stack_start = mut_table.derived_state_offset[row] / sizeof(slim_mutationid_t);
+			tsk_size_t stack_end = mut_table.derived_state_offset[row + 1] / sizeof(slim_mutationid_t);
+			
+			for (tsk_size_t stack_index = stack_start; stack_index < stack_end; ++stack_index)
+				p_mutInfo[p_stackToMutInfo[stack_index]].ref_count += row_ref_count;
+		}
+	}
+	
+	// bucket the carried rows by sample index, keeping them in order of position within each sample
+	for (auto &carried : carried_rows)
+		p_sampleRowOffsets[carried.first + 1]++;
+	
+	for (size_t sample_index = 0; sample_index < sample_count; ++sample_index)
+		p_sampleRowOffsets[sample_index + 1] += p_sampleRowOffsets[sample_index];
+	
+	std::vector<tsk_size_t> fill_offsets(p_sampleRowOffsets.begin(), p_sampleRowOffsets.end() - 1);
+	
+	p_sampleRows.resize(carried_rows.size());
+	
+	for (auto &carried : carried_rows)
+		p_sampleRows[fill_offsets[carried.first]++] = carried.second;
 }
 
-void SLiMSim::__CreateMutationsFromTabulation(std::unordered_map<slim_mutationid_t, ts_mut_info> &p_mutInfoMap, std::unordered_map<slim_mutationid_t, MutationIndex> &p_mutIndexMap)
+void SLiMSim::__CreateMutationsFromTabulation(std::vector<ts_mut_info> &p_mutInfo, std::vector<MutationIndex> &p_mutIndexes)
 {
 	// count the number of non-null genomes there are; this is the count that would represent fixation
 	slim_refcount_t fixation_count = 0;
@@ -7596,13 +9277,14 @@ void SLiMSim::__CreateMutationsFromTabulation(std::unordered_map<slim_mutationid
 			if (!genome->IsNull())
 				fixation_count++;
 	
-	// instantiate mutations
-	for (auto mut_info_iter : p_mutInfoMap)
+	// instantiate mutations; p_mutIndexes parallels p_mutInfo, with -1 for substitutions and for mutations not instantiated
+	p_mutIndexes.assign(p_mutInfo.size(), -1);
+	
+	for (size_t info_index = 0; info_index < p_mutInfo.size(); ++info_index)
 	{
-		slim_mutationid_t mutation_id = mut_info_iter.first;
-		ts_mut_info &mut_info = mut_info_iter.second;
-		MutationMetadataRec *metadata_ptr = mut_info.metadata;
-		MutationMetadataRec metadata;
+		ts_mut_info &mut_info = p_mutInfo[info_index];
+		slim_mutationid_t mutation_id = mut_info.mutation_id;
+		MutationMetadataRec &metadata = mut_info.metadata;
 		slim_position_t position = mut_info.position;
 		
 		// a mutation might not be refered by any extant genome; it might be present in an ancestral node,
@@ -7610,12 +9292,6 @@ void SLiMSim::__CreateMutationsFromTabulation(std::unordered_map<slim_mutationid
 		if (mut_info.ref_count == 0)
 			continue;
 		
-		// BCH 4/25/2019: copy the metadata with memcpy(), avoiding a misaligned pointer access; this is needed because
-		// sizeof(MutationMetadataRec) is odd, according to Xcode.  Actually I think this might be a bug in Xcode's runtime
-		// checking, because MutationMetadataRec is defined as packed so the compiler should not use aligned reads for it...?
-		// Anyway, it's a safe fix and will probably get optimized away by the compiler, so whatever...
-		memcpy(&metadata, metadata_ptr, sizeof(MutationMetadataRec));
-		
 		// look up the mutation type from its index
 		auto found_muttype_pair = mutation_types_.find(metadata.mutation_type_id_);
 		
@@ -7626,14 +9302,11 @@ void SLiMSim::__CreateMutationsFromTabulation(std::unordered_map<slim_mutationid
 		
 		if ((mut_info.ref_count == fixation_count) && (mutation_type_ptr->convert_to_substitution_))
 		{
-			// this mutation is fixed, and the muttype wants substitutions, so make a substitution
+			// this mutation is fixed, and the muttype wants substitutions, so make a substitution; its index stays -1
 			Substitution *sub = new Substitution(mutation_id, mutation_type_ptr, position, metadata.selection_coeff_, metadata.subpop_index_, metadata.origin_generation_, generation_, metadata.nucleotide_);
 			
 			population_.treeseq_substitutions_map_.insert(std::pair<slim_position_t, Substitution *>(position, sub));
 			population_.substitutions_.emplace_back(sub);
-			
-			// add -1 to our local map, so we know there's an entry but we also know it's a substitution
-			p_mutIndexMap[mutation_id] = -1;
 		}
 		else
 		{
@@ -7642,8 +9315,8 @@ void SLiMSim::__CreateMutationsFromTabulation(std::unordered_map<slim_mutationid
 			
 			new (gSLiM_Mutation_Block + new_mut_index) Mutation(mutation_id, mutation_type_ptr, position, metadata.selection_coeff_, metadata.subpop_index_, metadata.origin_generation_, metadata.nucleotide_);
 			
-			// add it to our local map, so we can find it when making genomes, and to the population's mutation registry
-			p_mutIndexMap[mutation_id] = new_mut_index;
+			// record its index, so we can find it when making genomes, and add it to the population's mutation registry
+			p_mutIndexes[info_index] = new_mut_index;
 			population_.mutation_registry_.emplace_back(new_mut_index);
 			
 #ifdef SLIM_KEEP_MUTTYPE_REGISTRIES
@@ -7661,109 +9334,131 @@ void SLiMSim::__CreateMutationsFromTabulation(std::unordered_map<slim_mutationid
 	}
 }
 
-void SLiMSim::__AddMutationsFromTreeSequenceToGenomes(std::unordered_map<slim_mutationid_t, MutationIndex> &p_mutIndexMap, std::unordered_map<tsk_id_t, Genome *> p_nodeToGenomeMap, tsk_treeseq_t *p_ts)
+void SLiMSim::__AddMutationsFromTreeSequenceToGenomes(std::vector<MutationIndex> &p_mutIndexes, std::vector<int32_t> &p_stackToMutInfo, std::vector<Genome *> &p_sampleToGenomeMap, std::vector<tsk_size_t> &p_sampleRowOffsets, std::vector<tsk_id_t> &p_sampleRows)
 {
-	// This code is based on SLiMSim::CrosscheckTreeSeqIntegrity(), but it can be much simpler.
-	// We also don't need to sort/deduplicate/simplify; the tables read in should be simplified already.
+	// The rows carried by each genome were found by __TallyMutationReferencesWithTreeSequence(), in order of position, so here
+	// we just fill in new mutation runs for each genome, in parallel across genomes when multithreaded.  Each thread takes
+	// runs from the shared free list in batches, as in Population::AssembleGametePlans(); the new runs are staged, and installed
+	// in the genomes afterwards on a single thread, since the empty runs they replace are shared and not safely released in parallel.
 	if (!recording_mutations_)
 		return;
 	
-	// allocate and set up the vargen object we'll use to walk through variants
-	tsk_vargen_t *vg;
+	int64_t sample_count = (int64_t)p_sampleToGenomeMap.size();
+	int32_t mutrun_count = chromosome_.mutrun_count_;
+	std::vector<MutationRun *> staged_runs(sample_count * mutrun_count, nullptr);
+	MutationRun **staged_runs_ptr = staged_runs.data();
+	Genome **sample_genomes = p_sampleToGenomeMap.data();
+	const tsk_size_t *row_offsets = p_sampleRowOffsets.data();
+	const tsk_id_t *rows = p_sampleRows.data();
+	const MutationIndex *mut_indexes = p_mutIndexes.data();
+	const int32_t *stack_to_mut_info = p_stackToMutInfo.data();
+	const tsk_size_t *derived_state_offset = tables_.mutations.derived_state_offset;
+	const tsk_id_t *mut_site = tables_.mutations.site;
+	const double *site_position = tables_.sites.position;
 	
-	vg = (tsk_vargen_t *)malloc(sizeof(tsk_vargen_t));
-	int ret = tsk_vargen_init(vg, p_ts, p_ts->samples, p_ts->num_samples, TSK_16_BIT_GENOTYPES);
-	if (ret != 0) handle_error("__AddMutationsFromTreeSequenceToGenomes tsk_vargen_init()", ret);
-	
-	// set up a map from sample indices in the vargen to Genome objects; the sample
-	// may contain nodes that are ancestral and need to be excluded
-	std::vector<Genome *> indexToGenomeMap;
-	size_t sample_count = vg->num_samples;
-	
-	for (size_t sample_index = 0; sample_index < sample_count; ++sample_index)
+	// a null genome must not carry any mutations; this is checked up front, since errors cannot be raised inside the parallel region
+	for (int64_t sample_index = 0; sample_index < sample_count; ++sample_index)
 	{
-		tsk_id_t sample_node_id = vg->samples[sample_index];
-		auto sample_nodeToGenome_iter = p_nodeToGenomeMap.find(sample_node_id);
+		Genome *genome = sample_genomes[sample_index];
 		
-		if (sample_nodeToGenome_iter != p_nodeToGenomeMap.end())
-		{
-			// we found a genome for this sample, so record it
-			indexToGenomeMap.push_back(sample_nodeToGenome_iter->second);
-		}
-		else
+		if (genome && genome->IsNull())
 		{
-			// this sample is not extant; no corresponding genome, so record nullptr
-			indexToGenomeMap.push_back(nullptr);
+			for (tsk_size_t row_index = row_offsets[sample_index]; row_index < row_offsets[sample_index + 1]; ++row_index)
+			{
+				tsk_id_t row = rows[row_index];
+				tsk_size_t genome_allele_length = (derived_state_offset[row + 1] - derived_state_offset[row]) / sizeof(slim_mutationid_t);
+				
+				if (genome_allele_length > 0)
+					EIDOS_TERMINATION << "ERROR (SLiMSim::__AddMutationsFromTreeSequenceToGenomes): (internal error) null genome has non-zero treeseq allele length " << genome_allele_length << "." << EidosTerminate();
+			}
 		}
 	}
 	
-	// add mutations to genomes by looping through variants
-	do
+#pragma omp parallel num_threads(gEidosMaxThreads) default(none) shared(sample_count, mutrun_count, staged_runs_ptr, sample_genomes, row_offsets, rows, mut_indexes, stack_to_mut_info, derived_state_offset, mut_site, site_position)
 	{
-		tsk_variant_t *variant;
+		// each thread keeps a private stash of empty mutation runs, refilled from the shared free list in batches
+		std::vector<MutationRun *> run_stash;
 		
-		ret = tsk_vargen_next(vg, &variant);
-		if (ret < 0) handle_error("__AddMutationsFromTreeSequenceToGenomes tsk_vargen_next()", ret);
-		
-		if (ret == 1)
+#pragma omp for schedule(dynamic, 16)
+		for (int64_t sample_index = 0; sample_index < sample_count; ++sample_index)
 		{
-			// We have a new variant; set it into SLiM.  A variant represents a site at which a tracked mutation exists.
-			// The tsk_variant_t will tell us all the allelic states involved at that site, what the alleles are, and which genomes
-			// in the sample are using them.  We will then set all the genomes that the variant claims to involve to have
-			// the allele the variant attributes to them.  The variants are returned in sorted order by position, so we can
-			// always add new mutations to the ends of genomes.
-			slim_position_t variant_pos_int = (slim_position_t)variant->site->position;
+			Genome *genome = sample_genomes[sample_index];
+			
+			if (!genome)
+				continue;
+			
+			MutationRun **genome_runs = staged_runs_ptr + sample_index * mutrun_count;
 			
-			for (size_t sample_index = 0; sample_index < sample_count; sample_index++)
+			for (tsk_size_t row_index = row_offsets[sample_index]; row_index < row_offsets[sample_index + 1]; ++row_index)
 			{
-				Genome *genome = indexToGenomeMap[sample_index];
+				tsk_id_t row = rows[row_index];
+				slim_mutrun_index_t run_index = (slim_mutrun_index_t)((slim_position_t)site_position[mut_site[row]] / genome->mutrun_length_);
+				tsk_size_t stack_start = derived_state_offset[row] / sizeof(slim_mutationid_t);
+				tsk_size_t stack_end = derived_state_offset[row + 1] / sizeof(slim_mutationid_t);
 				
-				if (genome)
+				for (tsk_size_t stack_index = stack_start; stack_index < stack_end; ++stack_index)
 				{
-					uint16_t genome_variant = variant->genotypes.u16[sample_index];
-					tsk_size_t genome_allele_length = variant->allele_lengths[genome_variant];
+					// Add the mutation to the genome unless it is fixed (mut_index == -1)
+					MutationIndex mut_index = mut_indexes[stack_to_mut_info[stack_index]];
+					
+					if (mut_index == -1)
+						continue;
 					
-					if (genome_allele_length % sizeof(slim_mutationid_t) != 0)
-						EIDOS_TERMINATION << "ERROR (SLiMSim::__AddMutationsFromTreeSequenceToGenomes): (internal error) variant allele had length that was not a multiple of sizeof(slim_mutationid_t)." << EidosTerminate();
-					genome_allele_length /= sizeof(slim_mutationid_t);
+					MutationRun *&mutrun = genome_runs[run_index];
 					
-					if (genome_allele_length > 0)
+					if (!mutrun)
 					{
-						if (genome->IsNull())
-							EIDOS_TERMINATION << "ERROR (SLiMSim::__AddMutationsFromTreeSequenceToGenomes): (internal error) null genome has non-zero treeseq allele length " << genome_allele_length << "." << EidosTerminate();
-						
-						slim_mutationid_t *genome_allele = (slim_mutationid_t *)variant->alleles[genome_variant];
-						slim_mutrun_index_t run_index = (slim_mutrun_index_t)(variant_pos_int / genome->mutrun_length_);
-						
-						genome->WillModifyRun(run_index);
-						
-						MutationRun *mutrun = genome->mutruns_[run_index].get();
-						
-						for (tsk_size_t mutid_index = 0; mutid_index < genome_allele_length; ++mutid_index)
+						// get a new run from our stash, refilling the stash from the shared free list if needed
+						if (run_stash.size() == 0)
 						{
-							slim_mutationid_t mut_id = genome_allele[mutid_index];
-							auto mut_index_iter = p_mutIndexMap.find(mut_id);
-							
-							if (mut_index_iter == p_mutIndexMap.end())
-								EIDOS_TERMINATION << "ERROR (SLiMSim::__AddMutationsFromTreeSequenceToGenomes): mutation id " << mut_id << " was referenced but does not exist." << EidosTerminate();
-							
-							// Add the mutation to the genome unless it is fixed (mut_index == -1)
-							MutationIndex mut_index = mut_index_iter->second;
+#pragma omp critical (SLiM_MutationRunFreeList)
+							{
+								std::vector<MutationRun *> &free_list = MutationRun::s_freed_mutation_runs_;
+								size_t take_count = std::min(free_list.size(), (size_t)64);
+								
+								run_stash.insert(run_stash.end(), free_list.end() - take_count, free_list.end());
+								free_list.resize(free_list.size() - take_count);
+							}
 							
-							if (mut_index != -1)
-								mutrun->emplace_back(mut_index);
+							if (run_stash.size() == 0)
+								run_stash.emplace_back(new MutationRun());
 						}
+						
+						mutrun = run_stash.back();
+						run_stash.pop_back();
 					}
+					
+					mutrun->emplace_back(mut_index);
 				}
 			}
 		}
+		
+		// return any unused runs to the shared free list; they are still in the clean state that FreeMutationRun() guarantees
+		if (run_stash.size())
+		{
+#pragma omp critical (SLiM_MutationRunFreeList)
+			{
+				std::vector<MutationRun *> &free_list = MutationRun::s_freed_mutation_runs_;
+				
+				free_list.insert(free_list.end(), run_stash.begin(), run_stash.end());
+			}
+		}
 	}
-	while (ret != 0);
 	
-	// free
-	ret = tsk_vargen_free(vg);
-	if (ret != 0) handle_error("__AddMutationsFromTreeSequenceToGenomes tsk_vargen_free()", ret);
-	free(vg);
+	// single-threaded pass: install the staged runs, releasing the empty runs they replace
+	for (int64_t sample_index = 0; sample_index < sample_count; ++sample_index)
+	{
+		Genome *genome = sample_genomes[sample_index];
+		
+		if (!genome)
+			continue;
+		
+		MutationRun **genome_runs = staged_runs_ptr + sample_index * mutrun_count;
+		
+		for (int32_t run_index = 0; run_index < mutrun_count; ++run_index)
+			if (genome_runs[run_index])
+				genome->mutruns_[run_index].reset(genome_runs[run_index]);
+	}
 }
 
 slim_generation_t SLiMSim::_InstantiateSLiMObjectsFromTables(EidosInterpreter *p_interpreter)
@@ -7800,7 +9495,7 @@ slim_generation_t SLiMSim::_InstantiateSLiMObjectsFromTables(EidosInterpreter *p
 	ret = tsk_treeseq_init(ts, &tables_, TSK_BUILD_INDEXES);
 	if (ret != 0) handle_error("_InstantiateSLiMObjectsFromTables tsk_treeseq_init()", ret);
 	
-	std::unordered_map<tsk_id_t, Genome *> nodeToGenomeMap;
+	std::vector<Genome *> nodeToGenomeMap(tables_.nodes.num_rows, nullptr);
 	
 	{
 		std::unordered_map<slim_objectid_t, ts_subpop_info> subpopInfoMap;
@@ -7810,22 +9505,37 @@ slim_generation_t SLiMSim::_InstantiateSLiMObjectsFromTables(EidosInterpreter *p
 		__ConfigureSubpopulationsFromTables(p_interpreter);
 	}
 	
-	std::unordered_map<slim_mutationid_t, MutationIndex> mutIndexMap;
+	// set up a map from sample indices in the tree sequence to Genome objects; the sample may contain nodes
+	// that are ancestral and need to be excluded, so those get nullptr
+	std::vector<Genome *> sampleToGenomeMap(ts->num_samples);
+	
+	for (tsk_size_t sample_index = 0; sample_index < ts->num_samples; ++sample_index)
+		sampleToGenomeMap[sample_index] = nodeToGenomeMap[ts->samples[sample_index]];
+	
+	// mutations are tabulated in dense vectors indexed by their rank among the distinct mutation ids in the table,
+	// with a parallel vector giving that index for each mutation id stacked in the derived state column
+	std::vector<int32_t> stackToMutInfo;
+	std::vector<MutationIndex> mutIndexes;
+	std::vector<tsk_size_t> sampleRowOffsets;
+	std::vector<tsk_id_t> sampleRows;
 	
 	{
-		std::unordered_map<slim_mutationid_t, ts_mut_info> mutInfoMap;
+		std::vector<ts_mut_info> mutInfo;
 		
-		__TabulateMutationsFromTables(mutInfoMap, file_version);
-		__TallyMutationReferencesWithTreeSequence(mutInfoMap, nodeToGenomeMap, ts);
-		__CreateMutationsFromTabulation(mutInfoMap, mutIndexMap);
+		__TabulateMutationsFromTables(mutInfo, stackToMutInfo, file_version);
+		__TallyMutationReferencesWithTreeSequence(mutInfo, stackToMutInfo, sampleToGenomeMap, sampleRowOffsets, sampleRows, ts);
+		__CreateMutationsFromTabulation(mutInfo, mutIndexes);
 	}
 	
-	__AddMutationsFromTreeSequenceToGenomes(mutIndexMap, nodeToGenomeMap, ts);
+	__AddMutationsFromTreeSequenceToGenomes(mutIndexes, stackToMutInfo, sampleToGenomeMap, sampleRowOffsets, sampleRows);
 	
 	ret = tsk_treeseq_free(ts);
 	if (ret != 0) handle_error("_InstantiateSLiMObjectsFromTables tsk_treeseq_free()", ret);
 	free(ts);
 	
+	// Convert the loaded mutation table to the in-memory form used while recording; see DerivedStateDictionaryIndex()
+	CompactDerivedStates(&tables_, file_version);
+	
 	// Figure out how many remembered genomes we have; each remembered individual has two remembered genomes
 	// First-generation individuals are also "remembered" in the present design, and so must be included
 	size_t remembered_genome_count = 0;
@@ -7892,6 +9602,7 @@ slim_generation_t SLiMSim::_InstantiateSLiMObjectsFromTables(EidosInterpreter *p
 	
 	// Simplification has just been done, in effect
 	simplify_elapsed_ = 0;
+	memory_limit_last_bytes_ = TreeSeqBytesInUse();
 	
 	// Reset our last coalescence state; we don't know whether we're coalesced now or not
 	last_coalescence_state_ = false;
@@ -7956,9 +9667,12 @@ slim_generation_t SLiMSim::_InitializePopulationFromTskitBinaryFile(const char *
 #else
 	// WORKAROUND
 	// read the file from disk into a private table collection that is immutable
+	// the file is memory-mapped rather than read, so its pages come from the OS file cache and are shared
+	// by every process loading the same file (such as replicates started from one burn-in); only the
+	// mutable copy made below is private to this process
 	tsk_table_collection_t immutable_tables;
 	
-	int ret = tsk_table_collection_load(&immutable_tables, p_file, 0);
+	int ret = tsk_table_collection_load(&immutable_tables, p_file, TSK_LOAD_MMAP);
 	if (ret != 0) handle_error("tsk_table_collection_load", ret);
 	
 	// BCH 4/25/2019: if indexes are present on immutable_tables we want to drop them; they are synced up
@@ -9337,7 +11051,7 @@ EidosValue_SP SLiMSim::ExecuteContextFunction_initializeSLiMOptions(const std::s
 }
 
 // TREE SEQUENCE RECORDING
-//	*********************	(void)initializeTreeSeq([logical$ recordMutations = T], [Nif$ simplificationRatio = NULL], [Ni$ simplificationInterval = NULL], [logical$ checkCoalescence = F], [logical$ runCrosschecks = F])
+//	*********************	(void)initializeTreeSeq([logical$ recordMutations = T], [Nif$ simplificationRatio = NULL], [Ni$ simplificationInterval = NULL], [logical$ checkCoalescence = F], [logical$ runCrosschecks = F], [Nif$ memoryLimit = NULL], [float$ maxSimplifyFraction = 0.5], [float$ crosscheckFraction = 1.0])
 //
 EidosValue_SP SLiMSim::ExecuteContextFunction_initializeTreeSeq(const std::string &p_function_name, const EidosValue_SP *const p_arguments, int p_argument_count, EidosInterpreter &p_interpreter)
 {
@@ -9347,6 +11061,9 @@ EidosValue_SP SLiMSim::ExecuteContextFunction_initializeTreeSeq(const std::strin
 	EidosValue *arg_simplificationInterval_value = p_arguments[2].get();
 	EidosValue *arg_checkCoalescence_value = p_arguments[3].get();
 	EidosValue *arg_runCrosschecks_value = p_arguments[4].get();
+	EidosValue *arg_memoryLimit_value = p_arguments[5].get();
+	EidosValue *arg_maxSimplifyFraction_value = p_arguments[6].get();
+	EidosValue *arg_crosscheckFraction_value = p_arguments[7].get();
 	std::ostream &output_stream = p_interpreter.ExecutionOutputStream();
 	
 	if (num_treeseq_declarations_ > 0)
@@ -9360,6 +11077,10 @@ EidosValue_SP SLiMSim::ExecuteContextFunction_initializeTreeSeq(const std::strin
 	running_coalescence_checks_ = arg_checkCoalescence_value->LogicalAtIndex(0, nullptr);
 	running_treeseq_crosschecks_ = arg_runCrosschecks_value->LogicalAtIndex(0, nullptr);
 	treeseq_crosschecks_interval_ = 1;		// this interval is presently not exposed in the Eidos API
+	treeseq_crosschecks_fraction_ = arg_crosscheckFraction_value->FloatAtIndex(0, nullptr);
+	
+	if (std::isnan(treeseq_crosschecks_fraction_) || (treeseq_crosschecks_fraction_ <= 0.0) || (treeseq_crosschecks_fraction_ > 1.0))
+		EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteContextFunction_initializeTreeSeq): initializeTreeSeq() requires crosscheckFraction to be in (0, 1]." << EidosTerminate();
 	
 	if ((arg_simplificationRatio_value->Type() == EidosValueType::kValueNULL) && (arg_simplificationInterval_value->Type() == EidosValueType::kValueNULL))
 	{
@@ -9405,6 +11126,28 @@ EidosValue_SP SLiMSim::ExecuteContextFunction_initializeTreeSeq(const std::strin
 			EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteContextFunction_initializeTreeSeq): initializeTreeSeq() requires simplificationInterval to be > 0." << EidosTerminate();
 	}
 	
+	if (arg_memoryLimit_value->Type() != EidosValueType::kValueNULL)
+	{
+		// A memory budget for the tables; see CheckMemoryLimitSimplification().  With no ratio or interval given, it replaces the
+		// default ratio heuristic, so that simplification is driven by the budget alone.
+		double memory_limit = arg_memoryLimit_value->FloatAtIndex(0, nullptr);
+		
+		if (std::isnan(memory_limit) || std::isinf(memory_limit) || (memory_limit < 1.0))
+			EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteContextFunction_initializeTreeSeq): initializeTreeSeq() requires memoryLimit to be a finite number of bytes >= 1." << EidosTerminate();
+		
+		memory_limit_ = (size_t)memory_limit;
+		
+		if ((arg_simplificationRatio_value->Type() == EidosValueType::kValueNULL) && (arg_simplificationInterval_value->Type() == EidosValueType::kValueNULL))
+			simplification_ratio_ = std::numeric_limits<double>::infinity();
+	}
+	
+	max_simplify_fraction_ = arg_maxSimplifyFraction_value->FloatAtIndex(0, nullptr);
+	
+	if (std::isnan(max_simplify_fraction_) || (max_simplify_fraction_ <= 0.0) || (max_simplify_fraction_ > 1.0))
+		EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteContextFunction_initializeTreeSeq): initializeTreeSeq() requires maxSimplifyFraction to be in (0, 1]." << EidosTerminate();
+	
+	memory_limit_cycle_time_ = std::chrono::steady_clock::now();
+	
 	// Pedigree recording is turned on as a side effect of tree sequence recording, since we need to
 	// have unique identifiers for every individual; pedigree recording does that for us
 	pedigrees_enabled_ = true;
@@ -9449,6 +11192,27 @@ EidosValue_SP SLiMSim::ExecuteContextFunction_initializeTreeSeq(const std::strin
 			if (previous_params) output_stream << ", ";
 			output_stream << "runCrosschecks = " << (running_treeseq_crosschecks_ ? "T" : "F");
 			previous_params = true;
+		}
+		
+		if (memory_limit_)
+		{
+			if (previous_params) output_stream << ", ";
+			output_stream << "memoryLimit = " << memory_limit_;
+			previous_params = true;
+		}
+		
+		if (max_simplify_fraction_ != 0.5)
+		{
+			if (previous_params) output_stream << ", ";
+			output_stream << "maxSimplifyFraction = " << max_simplify_fraction_;
+			previous_params = true;
+		}
+		
+		if (treeseq_crosschecks_fraction_ != 1.0)
+		{
+			if (previous_params) output_stream << ", ";
+			output_stream << "crosscheckFraction = " << treeseq_crosschecks_fraction_;
+			previous_params = true;
 			(void)previous_params;	// dead store above is deliberate
 		}
 		
@@ -9537,7 +11301,7 @@ const std::vector<EidosFunctionSignature_SP> *SLiMSim::ZeroGenerationFunctionSig
 		sim_0_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature(gStr_initializeSLiMOptions, nullptr, kEidosValueMaskVOID, "SLiM"))
 									   ->AddLogical_OS("keepPedigrees", gStaticEidosValue_LogicalF)->AddString_OS("dimensionality", gStaticEidosValue_StringEmpty)->AddString_OS("periodicity", gStaticEidosValue_StringEmpty)->AddInt_OS("mutationRuns", gStaticEidosValue_Integer0)->AddLogical_OS("preventIncidentalSelfing", gStaticEidosValue_LogicalF)->AddLogical_OS("nucleotideBased", gStaticEidosValue_LogicalF));
 		sim_0_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature(gStr_initializeTreeSeq, nullptr, kEidosValueMaskVOID, "SLiM"))
-									   ->AddLogical_OS("recordMutations", gStaticEidosValue_LogicalT)->AddNumeric_OSN("simplificationRatio", gStaticEidosValueNULL)->AddInt_OSN("simplificationInterval", gStaticEidosValueNULL)->AddLogical_OS("checkCoalescence", gStaticEidosValue_LogicalF)->AddLogical_OS("runCrosschecks", gStaticEidosValue_LogicalF));
+									   ->AddLogical_OS("recordMutations", gStaticEidosValue_LogicalT)->AddNumeric_OSN("simplificationRatio", gStaticEidosValueNULL)->AddInt_OSN("simplificationInterval", gStaticEidosValueNULL)->AddLogical_OS("checkCoalescence", gStaticEidosValue_LogicalF)->AddLogical_OS("runCrosschecks", gStaticEidosValue_LogicalF)->AddNumeric_OSN("memoryLimit", gStaticEidosValueNULL)->AddFloat_OS("maxSimplifyFraction", gStaticEidosValue_Float0Point5)->AddFloat_OS("crosscheckFraction", gStaticEidosValue_Float1));
 		sim_0_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature(gStr_initializeSLiMModelType, nullptr, kEidosValueMaskVOID, "SLiM"))
 									   ->AddString_S("modelType"));
 	}
@@ -10054,6 +11818,11 @@ EidosValue_SP SLiMSim::ExecuteInstanceMethod(EidosGlobalStringID p_method_id, co
 		case gID_treeSeqCoalesced:				return ExecuteMethod_treeSeqCoalesced(p_method_id, p_arguments, p_argument_count, p_interpreter);
 		case gID_treeSeqSimplify:				return ExecuteMethod_treeSeqSimplify(p_method_id, p_arguments, p_argument_count, p_interpreter);
 		case gID_treeSeqRememberIndividuals:	return ExecuteMethod_treeSeqRememberIndividuals(p_method_id, p_arguments, p_argument_count, p_interpreter);
+		case gID_treeSeqDiversity:
+		case gID_treeSeqSFS:					return ExecuteMethod_treeSeqDiversitySFS(p_method_id, p_arguments, p_argument_count, p_interpreter);
+		case gID_treeSeqDivergence:
+		case gID_treeSeqFst:					return ExecuteMethod_treeSeqDivergenceFst(p_method_id, p_arguments, p_argument_count, p_interpreter);
+		case gID_treeSeqR2:					return ExecuteMethod_treeSeqR2(p_method_id, p_arguments, p_argument_count, p_interpreter);
 		case gID_treeSeqOutput:					return ExecuteMethod_treeSeqOutput(p_method_id, p_arguments, p_argument_count, p_interpreter);
 		default:								return SLiMEidosDictionary::ExecuteInstanceMethod(p_method_id, p_arguments, p_argument_count, p_interpreter);
 	}
@@ -11518,6 +13287,11 @@ EidosValue_SP SLiMSim::ExecuteMethod_treeSeqRememberIndividuals(EidosGlobalStrin
 	if ((executing_block_type_ == SLiMEidosBlockType::SLiMEidosMateChoiceCallback) || (executing_block_type_ == SLiMEidosBlockType::SLiMEidosModifyChildCallback) || (executing_block_type_ == SLiMEidosBlockType::SLiMEidosRecombinationCallback))
 		EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteMethod_treeSeqRememberIndividuals): treeSeqRememberIndividuals() may not be called from inside a mateChoice(), modifyChild(), or recombination() callback." << EidosTerminate();
 	
+	FlushRecordingBuffers();
+	
+	if (async_simplify_pending_)
+		FinishAsyncSimplification();
+	
 	if (individuals_value->Count() == 1)
 	{
 		Individual *ind = (Individual *)individuals_value->ObjectElementAtIndex(0, nullptr);
@@ -11564,6 +13338,196 @@ EidosValue_SP SLiMSim::ExecuteMethod_treeSeqOutput(EidosGlobalStringID p_method_
 	return gStaticEidosValueVOID;
 }
 
+// TREE SEQUENCE RECORDING
+// This does the checks shared by the tree-sequence statistics methods below, and returns T for branch mode, F for site mode
+bool SLiMSim::CheckTreeSeqStatisticsCall(EidosGlobalStringID p_method_id, EidosValue *p_mode_value)
+{
+	const std::string &method_name = Eidos_StringForGlobalStringID(p_method_id);
+	
+	if (!recording_tree_)
+		EIDOS_TERMINATION << "ERROR (SLiMSim::CheckTreeSeqStatisticsCall): " << method_name << "() may only be called when tree recording is enabled." << EidosTerminate();
+	
+	SLiMGenerationStage gen_stage = GenerationStage();
+	
+	if ((gen_stage != SLiMGenerationStage::kWFStage1ExecuteEarlyScripts) && (gen_stage != SLiMGenerationStage::kWFStage5ExecuteLateScripts) &&
+		(gen_stage != SLiMGenerationStage::kNonWFStage2ExecuteEarlyScripts) && (gen_stage != SLiMGenerationStage::kNonWFStage6ExecuteLateScripts))
+		EIDOS_TERMINATION << "ERROR (SLiMSim::CheckTreeSeqStatisticsCall): " << method_name << "() may only be called from an early() or late() event." << EidosTerminate();
+	if ((executing_block_type_ != SLiMEidosBlockType::SLiMEidosEventEarly) && (executing_block_type_ != SLiMEidosBlockType::SLiMEidosEventLate))
+		EIDOS_TERMINATION << "ERROR (SLiMSim::CheckTreeSeqStatisticsCall): " << method_name << "() may not be called from inside a callback." << EidosTerminate();
+	
+	bool branch_mode = false;
+	
+	if (p_mode_value)
+	{
+		std::string mode = p_mode_value->StringAtIndex(0, nullptr);
+		
+		if (mode == "branch")
+			branch_mode = true;
+		else if (mode != "site")
+			EIDOS_TERMINATION << "ERROR (SLiMSim::CheckTreeSeqStatisticsCall): " << method_name << "() requires mode to be 'site' or 'branch'." << EidosTerminate();
+	}
+	
+	if (!branch_mode && !recording_mutations_)
+		EIDOS_TERMINATION << "ERROR (SLiMSim::CheckTreeSeqStatisticsCall): " << method_name << "() may only compute site statistics when mutations are recorded; pass recordMutations=T to initializeTreeSeq(), or use mode='branch'." << EidosTerminate();
+	
+	return branch_mode;
+}
+
+// TREE SEQUENCE RECORDING
+//	*********************	- (float$)treeSeqDiversity([No<Subpopulation> subpops = NULL], [string$ mode = "site"])
+//	*********************	- (float)treeSeqSFS([No<Subpopulation> subpops = NULL], [string$ mode = "site"])
+//
+EidosValue_SP SLiMSim::ExecuteMethod_treeSeqDiversitySFS(EidosGlobalStringID p_method_id, const EidosValue_SP *const p_arguments, int p_argument_count, EidosInterpreter &p_interpreter)
+{
+#pragma unused (p_method_id, p_argument_count, p_interpreter)
+	EidosValue *subpops_value = p_arguments[0].get();
+	EidosValue *mode_value = p_arguments[1].get();
+	
+	bool branch_mode = CheckTreeSeqStatisticsCall(p_method_id, mode_value);
+	std::vector<tsk_id_t> samples;
+	
+	TreeSequenceStatisticsSamples(subpops_value, samples, Eidos_StringForGlobalStringID(p_method_id).c_str());
+	
+	if ((p_method_id == gID_treeSeqDiversity) && (samples.size() < 2))
+		return gStaticEidosValue_FloatNAN;
+	
+	double diversity = 0.0;
+	std::vector<double> sfs(1, 0.0);
+	
+	if (samples.size())
+	{
+		tsk_table_collection_t tables;
+		tsk_treeseq_t ts;
+		
+		TreeSequenceForStatistics(samples, &tables, &ts);
+		
+		if (p_method_id == gID_treeSeqDiversity)
+			TreeSequenceStatistics(&ts, ts.num_samples, branch_mode, &diversity, nullptr, nullptr, nullptr);
+		else
+			TreeSequenceStatistics(&ts, ts.num_samples, branch_mode, nullptr, nullptr, nullptr, &sfs);
+		
+		tsk_treeseq_free(&ts);
+		tsk_table_collection_free(&tables);
+	}
+	
+	if (p_method_id == gID_treeSeqDiversity)
+		return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(diversity));
+	
+	EidosValue_Float_vector *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector())->resize_no_initialize(sfs.size());
+	
+	for (size_t count_index = 0; count_index < sfs.size(); ++count_index)
+		float_result->set_float_no_check(sfs[count_index], count_index);
+	
+	return EidosValue_SP(float_result);
+}
+
+// TREE SEQUENCE RECORDING
+//	*********************	- (float$)treeSeqDivergence(object<Subpopulation>$ subpop1, object<Subpopulation>$ subpop2, [string$ mode = "site"])
+//	*********************	- (float$)treeSeqFst(object<Subpopulation>$ subpop1, object<Subpopulation>$ subpop2, [string$ mode = "site"])
+//
+EidosValue_SP SLiMSim::ExecuteMethod_treeSeqDivergenceFst(EidosGlobalStringID p_method_id, const EidosValue_SP *const p_arguments, int p_argument_count, EidosInterpreter &p_interpreter)
+{
+#pragma unused (p_method_id, p_argument_count, p_interpreter)
+	EidosValue *subpop1_value = p_arguments[0].get();
+	EidosValue *subpop2_value = p_arguments[1].get();
+	EidosValue *mode_value = p_arguments[2].get();
+	
+	bool branch_mode = CheckTreeSeqStatisticsCall(p_method_id, mode_value);
+	const std::string &method_name = Eidos_StringForGlobalStringID(p_method_id);
+	
+	if (subpop1_value->ObjectElementAtIndex(0, nullptr) == subpop2_value->ObjectElementAtIndex(0, nullptr))
+		EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteMethod_treeSeqDivergenceFst): " << method_name << "() requires subpop1 and subpop2 to be different subpopulations." << EidosTerminate();
+	
+	std::vector<tsk_id_t> samples;
+	
+	TreeSequenceStatisticsSamples(subpop1_value, samples, method_name.c_str());
+	
+	tsk_size_t sample_count_1 = (tsk_size_t)samples.size();
+	
+	TreeSequenceStatisticsSamples(subpop2_value, samples, method_name.c_str());
+	
+	if ((sample_count_1 == 0) || (samples.size() == sample_count_1))
+		return gStaticEidosValue_FloatNAN;
+	
+	double diversity_1, diversity_2, divergence;
+	tsk_table_collection_t tables;
+	tsk_treeseq_t ts;
+	
+	TreeSequenceForStatistics(samples, &tables, &ts);
+	
+	if (p_method_id == gID_treeSeqDivergence)
+		TreeSequenceStatistics(&ts, sample_count_1, branch_mode, nullptr, nullptr, &divergence, nullptr);
+	else
+		TreeSequenceStatistics(&ts, sample_count_1, branch_mode, &diversity_1, &diversity_2, &divergence, nullptr);
+	
+	tsk_treeseq_free(&ts);
+	tsk_table_collection_free(&tables);
+	
+	if (p_method_id == gID_treeSeqDivergence)
+		return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(divergence));
+	
+	// Hudson's Fst, as in Hudson, Slatkin & Maddison (1992): 1 - (mean diversity within the subpopulations) / (divergence between them);
+	// this is NAN if either subpopulation has fewer than two genomes, or if there is no divergence between them
+	double fst = std::numeric_limits<double>::quiet_NaN();
+	
+	if (divergence > 0.0)
+		fst = 1.0 - ((diversity_1 + diversity_2) / 2.0) / divergence;
+	
+	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(fst));
+}
+
+// TREE SEQUENCE RECORDING
+//	*********************	- (float)treeSeqR2(integer positions, [No<Subpopulation> subpops = NULL])
+//
+EidosValue_SP SLiMSim::ExecuteMethod_treeSeqR2(EidosGlobalStringID p_method_id, const EidosValue_SP *const p_arguments, int p_argument_count, EidosInterpreter &p_interpreter)
+{
+#pragma unused (p_method_id, p_argument_count, p_interpreter)
+	EidosValue *positions_value = p_arguments[0].get();
+	EidosValue *subpops_value = p_arguments[1].get();
+	
+	CheckTreeSeqStatisticsCall(p_method_id, nullptr);
+	
+	int position_count = positions_value->Count();
+	std::vector<double> positions;
+	
+	for (int position_index = 0; position_index < position_count; ++position_index)
+	{
+		int64_t position = positions_value->IntAtIndex(position_index, nullptr);
+		
+		if ((position < 0) || (position > chromosome_.last_position_))
+			EIDOS_TERMINATION << "ERROR (SLiMSim::ExecuteMethod_treeSeqR2): treeSeqR2() requires positions to be within the chromosome." << EidosTerminate();
+		
+		positions.push_back((double)position);
+	}
+	
+	std::vector<tsk_id_t> samples;
+	std::vector<double> r2(positions.size() * positions.size(), std::numeric_limits<double>::quiet_NaN());
+	
+	TreeSequenceStatisticsSamples(subpops_value, samples, "treeSeqR2");
+	
+	if (samples.size() && positions.size())
+	{
+		tsk_table_collection_t tables;
+		tsk_treeseq_t ts;
+		
+		TreeSequenceForStatistics(samples, &tables, &ts);
+		TreeSequenceR2(&ts, positions, r2);
+		
+		tsk_treeseq_free(&ts);
+		tsk_table_collection_free(&tables);
+	}
+	
+	EidosValue_Float_vector *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector())->resize_no_initialize(r2.size());
+	
+	for (size_t r2_index = 0; r2_index < r2.size(); ++r2_index)
+		float_result->set_float_no_check(r2[r2_index], r2_index);
+	
+	const int64_t dims[2] = {(int64_t)positions.size(), (int64_t)positions.size()};
+	float_result->SetDimensions(2, dims);
+	
+	return EidosValue_SP(float_result);
+}
+
 
 //
 //	SLiMSim_Class
@@ -11662,6 +13626,11 @@ const std::vector<const EidosMethodSignature *> *SLiMSim_Class::Methods(void) co
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_treeSeqSimplify, kEidosValueMaskVOID)));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_treeSeqRememberIndividuals, kEidosValueMaskVOID))->AddObject("individuals", gSLiM_Individual_Class));
 		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_treeSeqOutput, kEidosValueMaskVOID))->AddString_S("path")->AddLogical_OS("simplify", gStaticEidosValue_LogicalT)->AddLogical_OS("_binary", gStaticEidosValue_LogicalT));
+		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_treeSeqDiversity, kEidosValueMaskFloat | kEidosValueMaskSingleton))->AddObject_ON("subpops", gSLiM_Subpopulation_Class, gStaticEidosValueNULL)->AddString_OS("mode", EidosValue_String_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String_singleton("site"))));
+		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_treeSeqDivergence, kEidosValueMaskFloat | kEidosValueMaskSingleton))->AddObject_S("subpop1", gSLiM_Subpopulation_Class)->AddObject_S("subpop2", gSLiM_Subpopulation_Class)->AddString_OS("mode", EidosValue_String_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String_singleton("site"))));
+		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_treeSeqFst, kEidosValueMaskFloat | kEidosValueMaskSingleton))->AddObject_S("subpop1", gSLiM_Subpopulation_Class)->AddObject_S("subpop2", gSLiM_Subpopulation_Class)->AddString_OS("mode", EidosValue_String_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String_singleton("site"))));
+		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_treeSeqSFS, kEidosValueMaskFloat))->AddObject_ON("subpops", gSLiM_Subpopulation_Class, gStaticEidosValueNULL)->AddString_OS("mode", EidosValue_String_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String_singleton("site"))));
+		methods->emplace_back((EidosInstanceMethodSignature *)(new EidosInstanceMethodSignature(gStr_treeSeqR2, kEidosValueMaskFloat))->AddInt("positions")->AddObject_ON("subpops", gSLiM_Subpopulation_Class, gStaticEidosValueNULL));
 							  
 		std::sort(methods->begin(), methods->end(), CompareEidosCallSignatures);
 	}
@@ -31,6 +31,8 @@
 #include <map>
 #include <vector>
 #include <iostream>
+#include <thread>
+#include <chrono>
 
 #include "slim_globals.h"
 #include "mutation.h"
@@ -167,12 +169,20 @@ typedef struct __attribute__((__packed__)) {
 	double migration_rate_;					// 8 bytes (double): the migration rate from source_subpop_id_, unused in nonWF models
 } SubpopulationMigrationMetadataRec;
 
+// This struct is not written to files; it is an entry in the derived-state dictionary that the in-memory mutation table refers to.
+// See SLiMSim::RecordNewDerivedState() and SLiMSim::ExpandDerivedStates() for how it is used.
+typedef struct __attribute__((__packed__)) {
+	slim_mutationid_t mutation_id_;			// 8 bytes (int64_t): the id of the mutation, as it appears in a derived state on disk
+	MutationMetadataRec metadata_;			// 17 bytes: the metadata for the mutation, as it appears alongside the derived state on disk
+} DerivedStateEntry;
+
 // We double-check the size of these records to make sure we understand what they contain and how they're packed
 static_assert(sizeof(MutationMetadataRec) == 17, "MutationMetadataRec is not 17 bytes!");
 static_assert(sizeof(GenomeMetadataRec) == 10, "GenomeMetadataRec is not 10 bytes!");
 static_assert(sizeof(IndividualMetadataRec) == 24, "IndividualMetadataRec is not 24 bytes!");
 static_assert(sizeof(SubpopulationMetadataRec) == 88, "SubpopulationMetadataRec is not 88 bytes!");
 static_assert(sizeof(SubpopulationMigrationMetadataRec) == 12, "SubpopulationMigrationMetadataRec is not 12 bytes!");
+static_assert(sizeof(DerivedStateEntry) == 25, "DerivedStateEntry is not 25 bytes!");
 
 // We check endianness on the platform we're building on; we assume little-endianness in our read/write code, I think.
 #if defined(__BYTE_ORDER__)
@@ -426,8 +436,45 @@ private:
 	bool recording_tree_ = false;				// true if we are doing tree sequence recording
 	bool recording_mutations_ = false;			// true if we are recording mutations in our tree sequence tables
 	
-	tsk_table_collection_t tables_;
+	tsk_table_collection_t tables_ = {};		// zeroed, so that it can be freed safely if initializeTreeSeq() raises before it is allocated
 	tsk_bookmark_t table_position_;
+	tsk_size_t sorted_edge_count_ = 0;			// edges [0, sorted_edge_count_) of tables_ were left sorted by the last sort or simplify
+	
+	// recording buffers; RecordNewGenome() and RecordNewDerivedState() accumulate new rows here, in flat arrays, rather than adding
+	// them to tables_ one at a time, and FlushRecordingBuffers() appends them to tables_ in bulk at the end of each generation, or
+	// sooner whenever tables_ needs to be complete.  Each buffered mutation has its own buffered site, as with add_row previously.
+	std::vector<tsk_flags_t> rec_node_flags_;
+	std::vector<double> rec_node_time_;
+	std::vector<tsk_id_t> rec_node_population_;
+	std::vector<GenomeMetadataRec> rec_node_metadata_;
+	std::vector<double> rec_edge_left_;
+	std::vector<double> rec_edge_right_;
+	std::vector<tsk_id_t> rec_edge_parent_;
+	std::vector<tsk_id_t> rec_edge_child_;
+	std::vector<double> rec_site_position_;
+	std::vector<tsk_id_t> rec_mut_node_;
+	std::vector<uint32_t> rec_mut_derived_state_;				// derived-state dictionary indices, as stored in tables_; see below
+	std::vector<tsk_size_t> rec_mut_derived_state_offset_{0};	// byte offsets, always one longer than rec_mut_node_, as tskit expects
+	
+	// the derived-state dictionary; the derived_state column of tables_.mutations holds, for each mutation in a derived state, a
+	// uint32_t index into derived_state_dict_ rather than the mutation id itself, and the metadata column is left empty.  This cuts
+	// the 25 bytes per stacked mutation written to disk down to 4 in memory, which shrinks the tables and speeds up simplification.
+	// ExpandDerivedStates() converts a table collection back to the on-disk form; CompactDerivedStates() goes the other way.
+	std::vector<DerivedStateEntry> derived_state_dict_;
+	std::unordered_map<slim_mutationid_t, uint32_t> derived_state_dict_lookup_;	// the latest dictionary entry for each mutation id
+	size_t derived_state_dict_collect_size_ = 0;		// the dictionary size at which CollectDerivedStateDictionary() next does work
+	
+	// asynchronous simplification, used when multithreaded; see StartAsyncSimplification().  While a simplification is pending, the
+	// background thread owns async_simplify_tables_ and the vectors it reads and writes, and tables_ holds only the rows recorded since.
+	bool async_simplify_pending_ = false;
+	std::thread async_simplify_thread_;
+	tsk_table_collection_t async_simplify_tables_;
+	std::vector<tsk_id_t> async_simplify_samples_;
+	std::vector<tsk_id_t> async_simplify_node_map_;
+	tsk_id_t async_node_base_ = 0;					// node ids in tables_ are offset by this while a simplification is pending
+	uint64_t async_simplify_old_table_size_ = 0;	// the table size before simplification, for AdjustAutoSimplificationInterval()
+	int async_simplify_result_ = 0;
+	const char *async_simplify_failed_operation_ = nullptr;
 	
     std::vector<tsk_id_t> remembered_genomes_;
 	//Individual *current_new_individual_;
@@ -437,11 +484,17 @@ private:
 	
 	bool running_treeseq_crosschecks_ = false;	// true if crosschecks between our tree sequence tables and SLiM's data are enabled
 	int treeseq_crosschecks_interval_ = 1;		// crosschecks, if enabled, will be done every treeseq_crosschecks_interval_ generations
+	double treeseq_crosschecks_fraction_ = 1.0;	// the fraction of genomes, and of sites, that each crosscheck examines
 	
 	double simplification_ratio_;				// the pre:post table size ratio we target with our automatic simplification heuristic
 	int64_t simplification_interval_;			// the generation interval between simplifications; -1 if not used (in which case the ratio is used)
 	int64_t simplify_elapsed_ = 0;				// the number of generations elapsed since a simplification was done (automatic or otherwise)
 	double simplify_interval_;					// the current number of generations between automatic simplifications when using simplification_ratio_
+	size_t memory_limit_ = 0;					// a byte budget for the tree-seq tables, enforced by simplifying at the end of each generation; 0 if not used
+	double max_simplify_fraction_ = 0.5;		// the fraction of run time spent simplifying to meet memory_limit_ beyond which we warn
+	size_t memory_limit_last_bytes_ = 0;		// the table bytes in use at the previous check or simplification, for projecting the growth to the next check
+	std::chrono::steady_clock::time_point memory_limit_cycle_time_;	// the wall-clock time at the end of the previous simplification forced by memory_limit_
+	bool memory_limit_warned_ = false;			// true once the max_simplify_fraction_ warning has been emitted
 	
 	slim_generation_t tree_seq_generation_ = 0;	// the generation for the tree sequence code, incremented after offspring generation
 												// this is needed since addSubpop() in an early() event makes one gen, and then the offspring
@@ -603,6 +656,12 @@ public:
 	void RecordNewGenome(std::vector<slim_position_t> *p_breakpoints, Genome *p_new_genome, const Genome *p_initial_parental_genome, const Genome *p_second_parental_genome);
 	void RecordNewDerivedState(const Genome *p_genome, slim_position_t p_position, const std::vector<Mutation *> &p_derived_mutations);
 	void RetractNewIndividual(void);
+	void FlushRecordingBuffers(void);
+	void ClearRecordingBuffers(void);
+	uint32_t DerivedStateDictionaryIndex(slim_mutationid_t p_mutation_id, const MutationMetadataRec &p_metadata);
+	void ExpandDerivedStates(tsk_table_collection_t *p_tables);
+	void CompactDerivedStates(tsk_table_collection_t *p_tables, int p_file_version);
+	void CollectDerivedStateDictionary(void);
     void AddIndividualsToTable(Individual * const *p_individual, size_t p_num_individuals, tsk_table_collection_t *p_tables, uint32_t p_flags);
 	void AddCurrentGenerationToIndividuals(tsk_table_collection_t *p_tables);
 	void UnmarkFirstGenerationSamples(tsk_table_collection_t *p_tables);
@@ -613,9 +672,19 @@ public:
 	void ReadProvenanceTable(tsk_table_collection_t *p_tables, slim_generation_t *p_generation, SLiMModelType *p_model_type, int *p_file_version);
 	void WriteTreeSequence(std::string &p_recording_tree_path, bool p_binary, bool p_simplify);
     void ReorderIndividualTable(tsk_table_collection_t *p_tables, std::vector<int> p_individual_map, bool p_keep_unmapped);
+	void SortTreeSequenceTables(tsk_table_collection_t *p_tables, tsk_size_t p_sorted_edge_count);
 	void SimplifyTreeSequence(void);
 	void CheckCoalescenceAfterSimplification(void);
+	void TreeSequenceStatisticsSamples(EidosValue *p_subpops_value, std::vector<tsk_id_t> &p_samples, const char *p_caller_name);
+	void TreeSequenceForStatistics(std::vector<tsk_id_t> &p_samples, tsk_table_collection_t *p_tables, tsk_treeseq_t *p_ts);
+	void TreeSequenceStatistics(tsk_treeseq_t *p_ts, tsk_size_t p_sample_count_1, bool p_branch_mode, double *p_diversity_1, double *p_diversity_2, double *p_divergence, std::vector<double> *p_sfs_1);
+	void TreeSequenceR2(tsk_treeseq_t *p_ts, const std::vector<double> &p_positions, std::vector<double> &p_r2);
 	void CheckAutoSimplification(void);
+	bool CheckMemoryLimitSimplification(void);
+	void AdjustAutoSimplificationInterval(uint64_t p_old_table_size, uint64_t p_new_table_size);
+	bool CanSimplifyAsynchronously(void);
+	void StartAsyncSimplification(void);
+	void FinishAsyncSimplification(void);
     void TreeSequenceDataFromAscii(std::string NodeFileName, 
             std::string EdgeFileName, std::string SiteFileName, std::string MutationFileName, 
             std::string IndividualsFileName, std::string PopulationFileName, std::string ProvenanceFileName);
@@ -626,16 +695,18 @@ public:
 	void TSXC_Enable(void);
 	
 	void __TabulateSubpopulationsFromTreeSequence(std::unordered_map<slim_objectid_t, ts_subpop_info> &p_subpopInfoMap, tsk_treeseq_t *p_ts, SLiMModelType p_file_model_type);
-	void __CreateSubpopulationsFromTabulation(std::unordered_map<slim_objectid_t, ts_subpop_info> &p_subpopInfoMap, EidosInterpreter *p_interpreter, std::unordered_map<tsk_id_t, Genome *> &p_nodeToGenomeMap);
+	void __CreateSubpopulationsFromTabulation(std::unordered_map<slim_objectid_t, ts_subpop_info> &p_subpopInfoMap, EidosInterpreter *p_interpreter, std::vector<Genome *> &p_nodeToGenomeMap);
 	void __ConfigureSubpopulationsFromTables(EidosInterpreter *p_interpreter);
-	void __TabulateMutationsFromTables(std::unordered_map<slim_mutationid_t, ts_mut_info> &p_mutMap, int p_file_version);
-	void __TallyMutationReferencesWithTreeSequence(std::unordered_map<slim_mutationid_t, ts_mut_info> &p_mutMap, std::unordered_map<tsk_id_t, Genome *> p_nodeToGenomeMap, tsk_treeseq_t *p_ts);
-	void __CreateMutationsFromTabulation(std::unordered_map<slim_mutationid_t, ts_mut_info> &p_mutInfoMap, std::unordered_map<slim_mutationid_t, MutationIndex> &p_mutIndexMap);
-	void __AddMutationsFromTreeSequenceToGenomes(std::unordered_map<slim_mutationid_t, MutationIndex> &p_mutIndexMap, std::unordered_map<tsk_id_t, Genome *> p_nodeToGenomeMap, tsk_treeseq_t *p_ts);
+	void __TabulateMutationsFromTables(std::vector<ts_mut_info> &p_mutInfo, std::vector<int32_t> &p_stackToMutInfo, int p_file_version);
+	void __TallyMutationReferencesWithTreeSequence(std::vector<ts_mut_info> &p_mutInfo, std::vector<int32_t> &p_stackToMutInfo, std::vector<Genome *> &p_sampleToGenomeMap, std::vector<tsk_size_t> &p_sampleRowOffsets, std::vector<tsk_id_t> &p_sampleRows, tsk_treeseq_t *p_ts);
+	void __CreateMutationsFromTabulation(std::vector<ts_mut_info> &p_mutInfo, std::vector<MutationIndex> &p_mutIndexes);
+	void __AddMutationsFromTreeSequenceToGenomes(std::vector<MutationIndex> &p_mutIndexes, std::vector<int32_t> &p_stackToMutInfo, std::vector<Genome *> &p_sampleToGenomeMap, std::vector<tsk_size_t> &p_sampleRowOffsets, std::vector<tsk_id_t> &p_sampleRows);
 	slim_generation_t _InstantiateSLiMObjectsFromTables(EidosInterpreter *p_interpreter);								// given tree-seq tables, makes individuals, genomes, and mutations
 	slim_generation_t _InitializePopulationFromTskitTextFile(const char *p_file, EidosInterpreter *p_interpreter);	// initialize the population from an tskit text file
 	slim_generation_t _InitializePopulationFromTskitBinaryFile(const char *p_file, EidosInterpreter *p_interpreter);	// initialize the population from an tskit binary file
 	size_t MemoryUsageForTables(tsk_table_collection_t &p_tables);
+	size_t TreeSeqBytesInUse(const tsk_table_collection_t &p_tables);
+	inline size_t TreeSeqBytesInUse(void) { return TreeSeqBytesInUse(tables_); }
 	
 	//
 	// Eidos support
@@ -706,6 +777,10 @@ public:
 	EidosValue_SP ExecuteMethod_treeSeqSimplify(EidosGlobalStringID p_method_id, const EidosValue_SP *const p_arguments, int p_argument_count, EidosInterpreter &p_interpreter);
 	EidosValue_SP ExecuteMethod_treeSeqRememberIndividuals(EidosGlobalStringID p_method_id, const EidosValue_SP *const p_arguments, int p_argument_count, EidosInterpreter &p_interpreter);
 	EidosValue_SP ExecuteMethod_treeSeqOutput(EidosGlobalStringID p_method_id, const EidosValue_SP *const p_arguments, int p_argument_count, EidosInterpreter &p_interpreter);
+	bool CheckTreeSeqStatisticsCall(EidosGlobalStringID p_method_id, EidosValue *p_mode_value);
+	EidosValue_SP ExecuteMethod_treeSeqDiversitySFS(EidosGlobalStringID p_method_id, const EidosValue_SP *const p_arguments, int p_argument_count, EidosInterpreter &p_interpreter);
+	EidosValue_SP ExecuteMethod_treeSeqDivergenceFst(EidosGlobalStringID p_method_id, const EidosValue_SP *const p_arguments, int p_argument_count, EidosInterpreter &p_interpreter);
+	EidosValue_SP ExecuteMethod_treeSeqR2(EidosGlobalStringID p_method_id, const EidosValue_SP *const p_arguments, int p_argument_count, EidosInterpreter &p_interpreter);
 };
 
 
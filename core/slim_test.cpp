@@ -9,6 +9,8 @@
 
 #include "slim_test.h"
 #include "slim_sim.h"
+#include "individual.h"
+#include "subpopulation.h"
 #include "eidos_test.h"
 
 #include <iostream>
@@ -273,6 +275,8 @@ static void _RunTreeSeqTests(void);
 static void _RunNucleotideFunctionTests(void);
 static void _RunNucleotideMethodTests(void);
 static void _RunSLiMTimingTests(void);
+static void _RunMultithreadingTests(void);
+static void _RunSIMDDispatchTests(void);
 
 
 // Test function shared strings
@@ -328,6 +332,8 @@ int RunSLiMTests(void)
 	_RunNucleotideFunctionTests();
 	_RunNucleotideMethodTests();
 	_RunSLiMTimingTests();
+	_RunMultithreadingTests();
+	_RunSIMDDispatchTests();
 	
 	_RunInteractionTypeTests();		// many tests, time-consuming, so do this last
 	
@@ -1097,6 +1103,9 @@ void _RunMutationTypeTests(void)
 	SLiMAssertScriptStop(gen1_setup + "1 { m1.setDistribution('w', 3.1, 7.5); if (abs(mean(m1.drawSelectionCoefficient(2000)) - 2.910106) < 0.1) stop(); }", __LINE__);
 	SLiMAssertScriptSuccess(gen1_setup + "1 { m1.setDistribution('s', 'rbinom(1, 4, 0.5);'); m1.drawSelectionCoefficient(); }", __LINE__);
 	SLiMAssertScriptStop(gen1_setup + "1 { m1.setDistribution('s', 'rbinom(1, 4, 0.5);'); if (abs(mean(m1.drawSelectionCoefficient(5000)) - 2.0) < 0.1) stop(); }", __LINE__);
+	
+	// drawing n coefficients at once must give exactly the same values as n separate draws
+	SLiMAssertScriptSuccess(gen1_setup + "1 { for (dfe in c('g', 'e', 'n', 'w', 's')) { if (dfe == 'e') m1.setDistribution(dfe, -3.0); else if (dfe == 's') m1.setDistribution(dfe, 'rnorm(1);'); else m1.setDistribution(dfe, 3.1, 7.5); setSeed(11); a = m1.drawSelectionCoefficient(20); setSeed(11); b = sapply(1:20, 'm1.drawSelectionCoefficient();'); if (!identical(a, b)) stop('mismatch for ' + dfe); } }", __LINE__);
 }
 
 #pragma mark GenomicElementType tests
@@ -1573,6 +1582,15 @@ void _RunChromosomeTests(void)
 	SLiMAssertScriptStop(gen1_setup + "1 { sim.chromosome.setGeneConversion(0.2, 1234.5, 0.75); if (sim.chromosome.geneConversionMeanLength == 1234.5) stop(); }", __LINE__);
 	SLiMAssertScriptStop(gen1_setup + "1 { sim.chromosome.setGeneConversion(0.2, 1234.5, 0.75); if (sim.chromosome.geneConversionSimpleConversionFraction == 0.75) stop(); }", __LINE__);
 	SLiMAssertScriptStop(gen1_setup + "1 { sim.chromosome.setGeneConversion(0.2, 1234.5, 0.75); if (sim.chromosome.geneConversionGCBias == 0.0) stop(); }", __LINE__);
+	
+	// Each gamete's crossover breakpoints are drawn straight into the buffer shared by all the gamete plans of a generation, and sorted
+	// and uniqued within their own segment of it; a short chromosome with high recombination gives many gametes with many breakpoints
+	// and frequent duplicates.  A recombination() callback must see sorted, unique breakpoints, and genomes assembled from the planned
+	// breakpoints (without callbacks) must stay in position order.
+	std::string breakpoints_setup("initialize() { initializeMutationRate(1e-2); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99); initializeRecombinationRate(c(0.0, 0.1, 0.5), c(9, 49, 99)); } 1 { sim.addSubpop('p1', 50); } ");
+	
+	SLiMAssertScriptSuccess(breakpoints_setup + "recombination() { if (!identical(breakpoints, unique(sort(breakpoints)))) stop('breakpoints not sorted and unique: ' + paste(breakpoints)); return F; } 20 late() { }", __LINE__);
+	SLiMAssertScriptSuccess(breakpoints_setup + "late() { for (genome in p1.genomes) { positions = genome.mutations.position; if (!identical(positions, sort(positions))) stop('genome not in position order: ' + paste(positions)); } } 20 late() { }", __LINE__);
 }
 
 #pragma mark Mutation tests
@@ -3962,6 +3980,63 @@ void _RunTreeSeqTests(void)
 	SLiMAssertScriptStop("initialize() { initializeTreeSeq(recordMutations=T, simplificationRatio=INF, checkCoalescence=T, runCrosschecks=T); } " + gen1_setup_p1 + "100 { stop(); }", __LINE__);
 	SLiMAssertScriptStop("initialize() { initializeTreeSeq(recordMutations=F, simplificationRatio=0.0, checkCoalescence=T, runCrosschecks=T); } " + gen1_setup_p1 + "100 { stop(); }", __LINE__);
 	SLiMAssertScriptStop("initialize() { initializeTreeSeq(recordMutations=T, simplificationRatio=0.0, checkCoalescence=T, runCrosschecks=T); } " + gen1_setup_p1 + "100 { stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeTreeSeq(memoryLimit=1e5); } " + gen1_setup_p1 + "100 { stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeTreeSeq(simplificationRatio=10.0, checkCoalescence=T, runCrosschecks=T, memoryLimit=1e5, maxSimplifyFraction=1.0); } " + gen1_setup_p1 + "100 { stop(); }", __LINE__);
+	SLiMAssertScriptRaise("initialize() { initializeTreeSeq(memoryLimit=0); } " + gen1_setup_p1 + "100 { stop(); }", 1, 15, "requires memoryLimit", __LINE__);
+	SLiMAssertScriptRaise("initialize() { initializeTreeSeq(maxSimplifyFraction=0.0); } " + gen1_setup_p1 + "100 { stop(); }", 1, 15, "requires maxSimplifyFraction", __LINE__);
+	SLiMAssertScriptRaise("initialize() { initializeTreeSeq(memoryLimit=100); } " + gen1_setup_p1 + "100 { stop(); }", -1, -1, "exceeding the memoryLimit", __LINE__);
+	
+	// with memoryLimit, the tables should be within the budget after every end-of-generation check, and the budget should have forced
+	// several simplifications along the way (seen as drops in table size), so that the check is not passing trivially
+	{
+		std::string memory_limit_script("initialize() { initializeTreeSeq(memoryLimit=5e5); initializeMutationRate(1e-7); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-7); } 1 { sim.addSubpop('p1', 200); } 200 late() { }");
+		std::istringstream infile(memory_limit_script);
+		SLiMSim *sim = nullptr;
+		bool within_limit = true;
+		int simplification_count = 0;
+		
+		try {
+			sim = new SLiMSim(infile);
+			sim->InitializeRNGFromSeed(nullptr);
+			
+			size_t previous_bytes = 0;
+			
+			while (sim->_RunOneGeneration())
+			{
+				size_t table_bytes = sim->TreeSeqBytesInUse();
+				
+				if (table_bytes > 500000)
+					within_limit = false;
+				if (table_bytes < previous_bytes)
+					simplification_count++;
+				
+				previous_bytes = table_bytes;
+			}
+		}
+		catch (...)
+		{
+			within_limit = false;
+			std::cerr << memory_limit_script << " : raise during execution: " << Eidos_GetTrimmedRaiseMessage() << std::endl;
+		}
+		
+		delete sim;
+		MutationRun::DeleteMutationRunFreeList();
+		gEidosCurrentScript = nullptr;
+		gEidosExecutingRuntimeScript = false;
+		
+		if (within_limit && (simplification_count >= 3))
+		{
+			gSLiMTestSuccessCount++;
+		}
+		else
+		{
+			gSLiMTestFailureCount++;
+			
+			std::cerr << "[" << __LINE__ << "] " << memory_limit_script << " : " << EIDOS_OUTPUT_FAILURE_TAG << " : tree-sequence tables exceeded memoryLimit, or were never simplified to meet it (" << simplification_count << " simplifications)" << std::endl;
+		}
+	}
+	SLiMAssertScriptStop("initialize() { initializeTreeSeq(simplificationRatio=10.0, runCrosschecks=T, crosscheckFraction=0.25); } " + gen1_setup_p1 + "100 { stop(); }", __LINE__);
+	SLiMAssertScriptRaise("initialize() { initializeTreeSeq(runCrosschecks=T, crosscheckFraction=0.0); } " + gen1_setup_p1 + "100 { stop(); }", 1, 15, "requires crosscheckFraction", __LINE__);
 	
 	// treeSeqCoalesced()
 	SLiMAssertScriptRaise("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "1: { sim.treeSeqCoalesced(); } 100 { stop(); }", 1, 290, "coalescence checking is enabled", __LINE__);
@@ -3970,11 +4045,29 @@ void _RunTreeSeqTests(void)
 	// treeSeqSimplify()
 	SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "50 { sim.treeSeqSimplify(); } 100 { stop(); }", __LINE__);
 	SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "1: { sim.treeSeqSimplify(); } 100 { stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeSLiMModelType('nonWF'); initializeTreeSeq(runCrosschecks=T); initializeMutationRate(1e-5); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-6); } reproduction() { subpop.addCrossed(individual, subpop.sampleIndividuals(1)); } 1 early() { sim.addSubpop('p1', 50); } early() { p1.fitnessScaling = 50 / p1.individualCount; } 3: late() { if (sim.generation % 3 == 0) sim.treeSeqSimplify(); } 30 late() { stop(); }", __LINE__);
+	
+	SLiMAssertScriptStop("initialize() { initializeTreeSeq(runCrosschecks=T); initializeMutationRate(1e-5); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-6); } 1 { sim.addSubpop('p1', 50); } modifyChild() { return runif(1) < 0.5; } 10 late() { sim.treeSeqRememberIndividuals(p1.individuals); } 20 late() { stop(); }", __LINE__);
 	
 	// treeSeqRememberIndividuals()
 	SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "50 { sim.treeSeqRememberIndividuals(p1.individuals); } 100 { sim.treeSeqSimplify(); stop(); }", __LINE__);
 	SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "1: { sim.treeSeqRememberIndividuals(p1.individuals); } 100 { sim.treeSeqSimplify(); stop(); }", __LINE__);
 	
+	// treeSeqDiversity(), treeSeqDivergence(), treeSeqFst(), treeSeqSFS(), treeSeqR2()
+	SLiMAssertScriptStop("initialize() { initializeTreeSeq(); initializeMutationRate(1e-7); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-7); } 1 { sim.addSubpop('p1', 50); sim.addSubpop('p2', 40); p1.setMigrationRates(p2, 0.01); } 200 late() { f = sim.mutationFrequencies(p1); n = 2 * p1.individualCount; if (abs(sim.treeSeqDiversity(p1) - sum(2 * f * (1 - f) * n / (n - 1)) / 100000) < 1e-12) stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeTreeSeq(); initializeMutationRate(1e-7); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-7); } 1 { sim.addSubpop('p1', 50); sim.addSubpop('p2', 40); p1.setMigrationRates(p2, 0.01); } 200 late() { f1 = sim.mutationFrequencies(p1); f2 = sim.mutationFrequencies(p2); if (abs(sim.treeSeqDivergence(p1, p2) - sum(f1 * (1 - f2) + f2 * (1 - f1)) / 100000) < 1e-12) stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeTreeSeq(); initializeMutationRate(1e-7); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-7); } 1 { sim.addSubpop('p1', 50); sim.addSubpop('p2', 40); p1.setMigrationRates(p2, 0.01); } 200 late() { c = sim.mutationCounts(p2); sfs = sim.treeSeqSFS(p2); if ((size(sfs) == 81) & all(sfs[1:79] == sapply(1:79, 'sum(c == applyValue);'))) stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeTreeSeq(); initializeMutationRate(1e-7); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-7); } 1 { sim.addSubpop('p1', 50); sim.addSubpop('p2', 40); p1.setMigrationRates(p2, 0.01); } 200 late() { fst = sim.treeSeqFst(p1, p2, mode='branch'); if ((fst > 0) & (fst < 1) & (sim.treeSeqDiversity(mode='branch') > 0)) stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeTreeSeq(); initializeMutationRate(1e-7); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-7); } 1 { sim.addSubpop('p1', 50); sim.addSubpop('p2', 40); p1.setMigrationRates(p2, 0.01); } 200 late() { m = sim.mutations[sim.mutationFrequencies(NULL) < 0.9]; r2 = sim.treeSeqR2(m[0:2].position); if (identical(dim(r2), c(3, 3)) & all(r2[c(0, 4, 8)] == 1.0) & identical(r2, t(r2))) stop(); }", __LINE__);
+	SLiMAssertScriptRaise("initialize() { initializeTreeSeq(); initializeMutationRate(1e-7); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-7); } 1 { sim.addSubpop('p1', 50); sim.addSubpop('p2', 40); p1.setMigrationRates(p2, 0.01); } 200 late() { sim.treeSeqDiversity(mode='foo'); }", 1, 338, "mode to be 'site' or 'branch'", __LINE__);
+	SLiMAssertScriptRaise("initialize() { initializeTreeSeq(); initializeMutationRate(1e-7); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-7); } 1 { sim.addSubpop('p1', 50); sim.addSubpop('p2', 40); p1.setMigrationRates(p2, 0.01); } 200 late() { sim.treeSeqFst(p1, p1); }", 1, 338, "different subpopulations", __LINE__);
+	SLiMAssertScriptRaise("initialize() { initializeTreeSeq(recordMutations=F); } " + gen1_setup_p1 + "10 late() { sim.treeSeqDiversity(); }", 1, 314, "when mutations are recorded", __LINE__);
+	
+	// branch-mode statistics are accumulated from the edge insertions and removals between trees; over a long, recombining chromosome
+	// with many trees they must match the values given by visiting every branch of every tree (the SFS, in generations times bases,
+	// is a sum of integers and so must match exactly)
+	SLiMAssertScriptSuccess("initialize() { setSeed(5); initializeTreeSeq(); initializeMutationRate(1e-7); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 999999); initializeRecombinationRate(1e-7); } 1 { sim.addSubpop('p1', 200); sim.addSubpop('p2', 150); p1.setMigrationRates(p2, 0.01); p2.setMigrationRates(p1, 0.02); } 1000 late() { stats = c(sim.treeSeqDiversity(p1, mode='branch'), sim.treeSeqDiversity(NULL, mode='branch'), sim.treeSeqDivergence(p1, p2, mode='branch'), sim.treeSeqFst(p1, p2, mode='branch')); expected = c(778.36142718318547, 786.73381313077891, 816.0354256831273, 0.080834633845262682); if (any(abs(stats - expected) > 1e-9 * expected)) stop('branch statistics ' + paste(stats) + ' differ from expected'); sfs = sim.treeSeqSFS(p2, mode='branch'); if (!identical(c(sum(sfs), sum(sfs * (0:(size(sfs) - 1))), sfs[1], sfs[150]), c(5320725534.0, 167107093575.0, 1058441457.0, 5645379.0))) stop('branch SFS differs from expected'); }", __LINE__);
+	
 	// treeSeqOutput()
 	if (Eidos_SlashTmpExists())
 	{
@@ -3982,6 +4075,12 @@ void _RunTreeSeqTests(void)
 		SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "100 { sim.treeSeqOutput('/tmp/SLiM_treeSeq_2.trees', simplify=T, _binary=F); stop(); }", __LINE__);
 		SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "100 { sim.treeSeqOutput('/tmp/SLiM_treeSeq_3.trees', simplify=F, _binary=T); stop(); }", __LINE__);
 		SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "100 { sim.treeSeqOutput('/tmp/SLiM_treeSeq_4.trees', simplify=T, _binary=T); stop(); }", __LINE__);
+		SLiMAssertScriptStop("initialize() { initializeSLiMOptions(nucleotideBased=T); initializeTreeSeq(); initializeAncestralNucleotides(randomNucleotides(1000)); initializeMutationTypeNuc('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0, mmJukesCantor(1e-4)); initializeGenomicElement(g1, 0, 999); initializeRecombinationRate(1e-3); } 1 { sim.addSubpop('p1', 10); } 20 late() { seq = sim.chromosome.ancestralNucleotides(); sim.treeSeqOutput('/tmp/SLiM_treeSeq_5.trees'); sim.readFromPopulationFile('/tmp/SLiM_treeSeq_5.trees'); if (sim.chromosome.ancestralNucleotides() == seq) stop(); }", __LINE__);
+		
+		// mutation metadata is kept in the derived-state dictionary while recording; a stacked mutation whose selection coefficient has changed
+		// gets a new dictionary entry, and its latest state is what gets read back, both directly and after the dictionary has been collected
+		SLiMAssertScriptStop("initialize() { initializeTreeSeq(); initializeMutationRate(0); initializeMutationType('m1', 0.5, 'f', 0.0); m1.convertToSubstitution = F; initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-8); } 1 { sim.addSubpop('p1', 10); } 2 late() { p1.genomes.addNewMutation(m1, 0.5, 500); } 3 late() { sim.mutations.setSelectionCoeff(0.25); p1.genomes[0:9].addNewMutation(m1, 0.125, 500); } 4 late() { sim.treeSeqOutput('/tmp/SLiM_treeSeq_6.trees'); ids = sort(sim.mutations.id); sim.readFromPopulationFile('/tmp/SLiM_treeSeq_6.trees'); m = sim.mutations; if (identical(sort(m.id), ids) & identical(m[order(m.id)].selectionCoeff, c(0.25, 0.125))) stop(); }", __LINE__);
+		SLiMAssertScriptStop("initialize() { initializeTreeSeq(simplificationInterval=5); initializeMutationRate(1e-5); initializeMutationType('m1', 0.5, 'n', 0.0, 0.01); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-7); } 1 { sim.addSubpop('p1', 100); } 10:100 late() { if (sim.generation % 10 == 0) { mut = sample(sim.mutations, 1); mut.setSelectionCoeff(0.5); p1.genomes[p1.genomes.containsMutations(mut)].addNewMutation(m1, 0.0, mut.position); } } 100 late() { sim.treeSeqOutput('/tmp/SLiM_treeSeq_7.trees'); m = sim.mutations; ids = sort(m.id); s = m[order(m.id)].selectionCoeff; c = sum(p1.genomes.countOfMutationsOfType(m1)); sim.readFromPopulationFile('/tmp/SLiM_treeSeq_7.trees'); m = sim.mutations; if (identical(sort(m.id), ids) & identical(m[order(m.id)].selectionCoeff, s) & (sum(p1.genomes.countOfMutationsOfType(m1)) == c)) stop(); }", __LINE__);
 	}
 }
 
@@ -4810,6 +4909,280 @@ void _RunSLiMTimingTests(void)
 }
 
 
+#pragma mark multithreading tests
+#if (defined(_OPENMP) || EIDOS_HAS_AVX2_DISPATCH)
+// Runs a script to completion with a given maximum thread count and a fixed seed, then passes the finished SLiMSim to p_inspect;
+// the mutation and pedigree id counters are reset so that runs are comparable, and all global state is restored afterwards
+template <typename F>
+static void _SLiMRunScriptWithThreads(const std::string &p_script_string, int p_thread_count, F p_inspect)
+{
+	int saved_max_threads = gEidosMaxThreads;
+	slim_mutationid_t saved_next_mutation_id = gSLiM_next_mutation_id;
+	slim_pedigreeid_t saved_next_pedigree_id = gSLiM_next_pedigree_id;
+	SLiMSim *sim = nullptr;
+	
+	gEidosMaxThreads = p_thread_count;
+	gSLiM_next_mutation_id = 0;		// so that both runs produce the same mutation ids
+	gSLiM_next_pedigree_id = 0;		// and the same pedigree ids, which appear in the tree-sequence tables
+	gSLiMOut.clear();
+	gSLiMOut.str("");
+	
+	try {
+		std::istringstream infile(p_script_string);
+		
+		unsigned long int seed = 17;
+		
+		sim = new SLiMSim(infile);
+		sim->InitializeRNGFromSeed(&seed);
+		
+		while (sim->_RunOneGeneration());
+		
+		p_inspect(*sim);
+	}
+	catch (...)
+	{
+		std::cerr << p_script_string << " : raise during execution with " << p_thread_count << " threads: " << Eidos_GetTrimmedRaiseMessage() << std::endl;
+	}
+	
+	delete sim;
+	MutationRun::DeleteMutationRunFreeList();
+	
+	gEidosMaxThreads = saved_max_threads;
+	gSLiM_next_mutation_id = saved_next_mutation_id;
+	gSLiM_next_pedigree_id = saved_next_pedigree_id;
+	gSLiMOut.clear();
+	gSLiMOut.str("");
+	gEidosCurrentScript = nullptr;
+	gEidosExecutingRuntimeScript = false;
+}
+
+// Runs a script with a given maximum thread count, and returns the output it produced, or an empty string if it raised
+static std::string _SLiMOutputForScriptWithThreads(const std::string &p_script_string, int p_thread_count)
+{
+	std::string output;
+	
+	_SLiMRunScriptWithThreads(p_script_string, p_thread_count, [&output](SLiMSim &p_sim) { (void)p_sim; output = gSLiMOut.str(); });
+	
+	return output;
+}
+#endif
+
+#ifdef _OPENMP
+// Checks that a script produces the same (non-empty) output with one thread and with several threads
+static void SLiMAssertScriptMultithreadingMatches(const std::string &p_script_string, int p_lineNumber)
+{
+	std::string serial_output = _SLiMOutputForScriptWithThreads(p_script_string, 1);
+	std::string parallel_output = _SLiMOutputForScriptWithThreads(p_script_string, 4);
+	
+	if (serial_output.length() && (serial_output == parallel_output))
+	{
+		gSLiMTestSuccessCount++;
+	}
+	else
+	{
+		gSLiMTestFailureCount++;
+		
+		std::cerr << "[" << p_lineNumber << "] " << p_script_string << " : " << EIDOS_OUTPUT_FAILURE_TAG << " : multithreaded output does not match single-threaded output" << std::endl;
+	}
+}
+
+// Runs a script with a given maximum thread count, then empties every other genome behind the back of tree-sequence recording, and
+// returns the error raised by the crosscheck that follows, or an empty string if it did not raise
+static std::string _SLiMCrosscheckErrorForCorruptedScriptWithThreads(const std::string &p_script_string, int p_thread_count)
+{
+	std::string error;
+	
+	_SLiMRunScriptWithThreads(p_script_string, p_thread_count, [&error](SLiMSim &p_sim) {
+		for (auto subpop_pair : p_sim.ThePopulation().subpops_)
+		{
+			std::vector<Genome *> &genomes = subpop_pair.second->parent_genomes_;
+			
+			for (size_t genome_index = 0; genome_index < genomes.size(); genome_index += 2)
+				genomes[genome_index]->clear_to_empty();
+		}
+		
+		try {
+			p_sim.CrosscheckTreeSeqIntegrity();
+		}
+		catch (...)
+		{
+			error = Eidos_GetTrimmedRaiseMessage();
+		}
+	});
+	
+	return error;
+}
+
+// Checks that a sampled crosscheck catches corrupted genomes, and reports the same first error with one thread and with several threads
+static void SLiMAssertCrosscheckCatchesCorruption(const std::string &p_script_string, int p_lineNumber)
+{
+	std::string serial_error = _SLiMCrosscheckErrorForCorruptedScriptWithThreads(p_script_string, 1);
+	std::string parallel_error = _SLiMCrosscheckErrorForCorruptedScriptWithThreads(p_script_string, 4);
+	
+	if ((serial_error.find("CrosscheckTreeSeqIntegrity") != std::string::npos) && (serial_error == parallel_error))
+	{
+		gSLiMTestSuccessCount++;
+	}
+	else
+	{
+		gSLiMTestFailureCount++;
+		
+		std::cerr << "[" << p_lineNumber << "] " << p_script_string << " : " << EIDOS_OUTPUT_FAILURE_TAG << " : crosscheck did not catch corrupted genomes identically with 1 and 4 threads (\"" << serial_error << "\" vs. \"" << parallel_error << "\")" << std::endl;
+	}
+}
+#endif
+
+void _RunMultithreadingTests(void)
+{
+#ifdef _OPENMP
+	// Offspring generation with multiple threads should produce exactly the same result as with a single thread; we test a
+	// variety of configurations, with enough mutation and recombination to exercise the assembly of new mutation runs
+	std::string mt_setup("initialize() { initializeMutationRate(1e-5); initializeMutationType('m1', 0.5, 'f', 0.0); initializeMutationType('m2', 0.5, 'e', 0.02); initializeGenomicElementType('g1', c(m1, m2), c(1.0, 0.2)); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-5); ");
+	std::string mt_end(" 30 late() { sim.outputFull(); } ");
+	
+	SLiMAssertScriptMultithreadingMatches(mt_setup + "} 1 { sim.addSubpop('p1', 200); }" + mt_end, __LINE__);
+	SLiMAssertScriptMultithreadingMatches(mt_setup + "} 1 { sim.addSubpop('p1', 200); p1.setSelfingRate(0.3); p1.setCloningRate(0.2); }" + mt_end, __LINE__);
+	SLiMAssertScriptMultithreadingMatches(mt_setup + "} 1 { sim.addSubpop('p1', 100); sim.addSubpop('p2', 100); p1.setMigrationRates(p2, 0.1); p2.setMigrationRates(p1, 0.2); }" + mt_end, __LINE__);
+	SLiMAssertScriptMultithreadingMatches(mt_setup + "initializeSex('X'); } 1 { sim.addSubpop('p1', 200); p1.setCloningRate(0.1); }" + mt_end, __LINE__);
+	SLiMAssertScriptMultithreadingMatches(mt_setup + "initializeSex('Y'); } 1 { sim.addSubpop('p1', 200); }" + mt_end, __LINE__);
+	SLiMAssertScriptMultithreadingMatches(mt_setup + "initializeGeneConversion(0.5, 500, 1.0); } 1 { sim.addSubpop('p1', 200); }" + mt_end, __LINE__);
+	SLiMAssertScriptMultithreadingMatches(mt_setup + "m1.mutationStackPolicy = 'l'; m2.mutationStackPolicy = 'f'; } 1 { sim.addSubpop('p1', 200); }" + mt_end, __LINE__);
+	SLiMAssertScriptMultithreadingMatches("initialize() { initializeSex('A'); initializeMutationRate(1e-6); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 9999); initializeRecombinationRate(c(1e-3, 1e-4), c(4999, 9999), sex='M'); initializeRecombinationRate(5e-4, sex='F'); } 1 { sim.addSubpop('p1', 200); }" + mt_end, __LINE__);
+	SLiMAssertScriptMultithreadingMatches("initialize() { initializeSLiMOptions(nucleotideBased=T); initializeAncestralNucleotides(randomNucleotides(10000)); initializeMutationTypeNuc('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0, mmJukesCantor(1e-4)); initializeGenomicElement(g1, 0, 9999); initializeRecombinationRate(1e-4); } 1 { sim.addSubpop('p1', 100); }" + mt_end, __LINE__);
+	
+	// Fitness evaluation with multiple threads should likewise match; these exercise fitnessScaling, recaching after a dominance
+	// change, and a subpopulation large enough that fitness from fitnessScaling alone is also calculated in parallel
+	SLiMAssertScriptMultithreadingMatches(mt_setup + "} 1 { sim.addSubpop('p1', 300); } late() { p1.individuals.fitnessScaling = 0.5 + (p1.individuals.index % 7) / 6.0; }" + mt_end, __LINE__);
+	SLiMAssertScriptMultithreadingMatches(mt_setup + "initializeSex('X'); } 1 { sim.addSubpop('p1', 300); } 15 early() { m2.dominanceCoeff = 0.1; }" + mt_end, __LINE__);
+	SLiMAssertScriptMultithreadingMatches("initialize() { initializeMutationRate(1e-7); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 999); initializeRecombinationRate(1e-4); } 1 { sim.addSubpop('p1', 10000); } late() { p1.individuals.fitnessScaling = 0.5 + (p1.individuals.index % 5) / 4.0; } 5 late() { p1.outputSample(100); }", __LINE__);
+	
+	// Mutation reference tallies with multiple threads should match too; these populations are large enough to be tallied in parallel,
+	// with null genomes present in the second case, and frequencies are checked each generation to catch any tally left stale
+	SLiMAssertScriptMultithreadingMatches(mt_setup + "} 1 { sim.addSubpop('p1', 600); } late() { catn(sum(sim.mutationFrequencies(NULL)) + ' ' + sum(sim.mutationCounts(p1))); }" + mt_end, __LINE__);
+	SLiMAssertScriptMultithreadingMatches(mt_setup + "initializeSex('X'); } 1 { sim.addSubpop('p1', 300); sim.addSubpop('p2', 300); p1.setMigrationRates(p2, 0.1); } late() { catn(sum(sim.mutationFrequencies(NULL)) + ' ' + sum(sim.mutationCounts(p2)) + ' ' + size(sim.substitutions)); }" + mt_end, __LINE__);
+	SLiMAssertScriptMultithreadingMatches(mt_setup + "} 1 { sim.addSubpop('p1', 500); } 20 late() { p1.genomes.addNewDrawnMutation(m1, seq(0, 99999, by=997)); } late() { catn(size(sim.mutations) + ' ' + size(sim.substitutions)); }" + mt_end, __LINE__);
+	
+	// Tree-sequence simplification runs in the background with multiple threads; crosschecks compare the spliced tables against SLiM's
+	// own state, and these exercise remembered individuals, modifyChild() rejections that rewind the tables, and the ratio heuristic
+	std::string ts_setup("initialize() { initializeMutationRate(1e-5); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-5); ");
+	
+	SLiMAssertScriptMultithreadingMatches(ts_setup + "initializeTreeSeq(simplificationInterval=3, runCrosschecks=T); } 1 { sim.addSubpop('p1', 100); } 10 late() { sim.treeSeqRememberIndividuals(p1.individuals[0:2]); } modifyChild() { return (runif(1) < 0.8); }" + mt_end, __LINE__);
+	SLiMAssertScriptMultithreadingMatches(ts_setup + "initializeTreeSeq(simplificationRatio=2.0, runCrosschecks=T); initializeSex('X'); } 1 { sim.addSubpop('p1', 100); } 12 { sim.addSubpopSplit('p2', 50, p1); }" + mt_end, __LINE__);
+	SLiMAssertScriptMultithreadingMatches("initialize() { initializeSLiMModelType('nonWF'); initializeTreeSeq(simplificationInterval=2, runCrosschecks=T); initializeMutationRate(1e-5); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-5); } reproduction() { subpop.addCrossed(individual, subpop.sampleIndividuals(1)); } 1 early() { sim.addSubpop('p1', 100); } early() { p1.fitnessScaling = 100 / p1.individualCount; }" + mt_end, __LINE__);
+	
+	// Without crosschecks, nothing waits for a background simplification until the next one is started or the tables are used, so
+	// pending splices and id remaps are exercised fully; we compare the unsimplified tables themselves (all but the provenance table,
+	// which contains a timestamp), at several simplification intervals, with remembered individuals and modifyChild() rejections.
+	// The location column of the individual table is left out, since individuals in non-spatial models have no defined position.
+	if (Eidos_SlashTmpExists())
+	{
+		std::string ts_tables_end(" 30 late() { sim.treeSeqOutput('/tmp/SLiM_mt_treeSeq', simplify=F, _binary=F); for (table in c('Node', 'Edge', 'Site', 'Mutation', 'Population')) catn(readFile('/tmp/SLiM_mt_treeSeq/' + table + 'Table.txt')); catn(sapply(readFile('/tmp/SLiM_mt_treeSeq/IndividualTable.txt'), 'paste(strsplit(applyValue, \"\\t\")[c(0, 1, 3)], sep=\"\\t\");')); } ");
+		
+		for (std::string interval : {"1", "2", "3", "7"})
+			SLiMAssertScriptMultithreadingMatches(ts_setup + "initializeTreeSeq(simplificationInterval=" + interval + ", runCrosschecks=F); } 1 { sim.addSubpop('p1', 100); } 10 late() { sim.treeSeqRememberIndividuals(p1.individuals[0:2]); } modifyChild() { return (runif(1) < 0.8); }" + ts_tables_end, __LINE__);
+		
+		SLiMAssertScriptMultithreadingMatches(ts_setup + "initializeTreeSeq(simplificationRatio=2.0, runCrosschecks=F); initializeSex('X'); } 1 { sim.addSubpop('p1', 100); } 12 { sim.addSubpopSplit('p2', 50, p1); }" + ts_tables_end, __LINE__);
+		SLiMAssertScriptMultithreadingMatches("initialize() { initializeSLiMModelType('nonWF'); initializeTreeSeq(simplificationInterval=3, runCrosschecks=F); initializeMutationRate(1e-5); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-5); } reproduction() { subpop.addCrossed(individual, subpop.sampleIndividuals(1)); } 1 early() { sim.addSubpop('p1', 100); } early() { p1.fitnessScaling = 100 / p1.individualCount; }" + ts_tables_end, __LINE__);
+		
+		// Reading a .trees file back in fills in the mutation runs of the genomes in parallel; the state read should not depend on the
+		// thread count, with stacked mutations in the first case and null genomes (which must be left empty) in the second
+		std::string ts_read_end(" 30 late() { sim.treeSeqOutput('/tmp/SLiM_mt_treeSeq.trees'); sim.readFromPopulationFile('/tmp/SLiM_mt_treeSeq.trees'); sim.outputFull(); } ");
+		
+		SLiMAssertScriptMultithreadingMatches(ts_setup + "initializeTreeSeq(); } 1 { sim.addSubpop('p1', 300); } 20 late() { p1.genomes[0:99].addNewDrawnMutation(m1, seq(0, 99999, by=4999)); }" + ts_read_end, __LINE__);
+		SLiMAssertScriptMultithreadingMatches(ts_setup + "initializeTreeSeq(); initializeSex('Y'); } 1 { sim.addSubpop('p1', 300); sim.addSubpop('p2', 100); p1.setMigrationRates(p2, 0.1); }" + ts_read_end, __LINE__);
+	}
+	
+	// A crosscheck that samples genomes and sites must still catch corrupted genomes; half the genomes are emptied here, and the
+	// first error found should not depend on the thread count (with 1000 genomes sampled, the genomes are checked in parallel)
+	SLiMAssertCrosscheckCatchesCorruption("initialize() { initializeTreeSeq(crosscheckFraction=0.5); initializeMutationRate(1e-7); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-7); } 1 { sim.addSubpop('p1', 1000); } 20 late() { }", __LINE__);
+#endif
+}
+
+#pragma mark SIMD dispatch tests
+#if EIDOS_HAS_AVX2_DISPATCH
+// Checks that a script produces the same (non-empty) output with the portable kernels and with the AVX2 kernels
+static void SLiMAssertScriptAVX2Matches(const std::string &p_script_string, int p_lineNumber)
+{
+	bool saved_use_AVX2 = gEidosUseAVX2;
+	
+	gEidosUseAVX2 = false;
+	std::string scalar_output = _SLiMOutputForScriptWithThreads(p_script_string, 1);
+	gEidosUseAVX2 = true;
+	std::string avx2_output = _SLiMOutputForScriptWithThreads(p_script_string, 1);
+	gEidosUseAVX2 = saved_use_AVX2;
+	
+	if (scalar_output.length() && (scalar_output == avx2_output))
+	{
+		gSLiMTestSuccessCount++;
+	}
+	else
+	{
+		gSLiMTestFailureCount++;
+		
+		std::cerr << "[" << p_lineNumber << "] " << p_script_string << " : " << EIDOS_OUTPUT_FAILURE_TAG << " : AVX2 output does not match portable output" << std::endl;
+	}
+}
+#endif
+
+void _RunSIMDDispatchTests(void)
+{
+	// By default, the fitness product is a serial product, rounded exactly as in earlier versions of SLiM; these values come from a
+	// build that predates the interleaved lanes, and must not change for a given seed (nor with the kernel in use)
+	std::string baseline_setup("initialize() { setSeed(17); initializeMutationRate(1e-5); initializeMutationType('m1', 0.3, 'g', -0.01, 0.5); initializeMutationType('m2', 0.7, 'e', 0.005); initializeGenomicElementType('g1', c(m1, m2), c(1.0, 0.5)); initializeGenomicElement(g1, 0, 199999); initializeRecombinationRate(1e-6); ");
+	std::string baseline_diploid(baseline_setup + "} 1 { sim.addSubpop('p1', 100); } 40 early() { w = format('%.17g', c(sum(p1.cachedFitness(NULL)), p1.cachedFitness(c(0, 99)))); if (!identical(w, c('93.003225521105449', '0.91648668290998891', '0.91361355916280496'))) stop('fitness ' + paste(w) + ' differs from baseline'); } ");
+	std::string baseline_Y(baseline_setup + "initializeSex('Y'); } 1 { sim.addSubpop('p1', 100); } 40 early() { w = format('%.17g', c(sum(p1.cachedFitness(NULL)), p1.cachedFitness(c(0, 99)))); if (!identical(w, c('87.957914705108735', '1', '0.81399306980939479'))) stop('fitness ' + paste(w) + ' differs from baseline'); } ");
+	
+	SLiMAssertScriptSuccess(baseline_diploid, __LINE__);
+	SLiMAssertScriptSuccess(baseline_Y, __LINE__);
+#if EIDOS_HAS_AVX2_DISPATCH
+	if (gEidosUseAVX2)
+	{
+		gEidosUseAVX2 = false;
+		SLiMAssertScriptSuccess(baseline_diploid, __LINE__);
+		SLiMAssertScriptSuccess(baseline_Y, __LINE__);
+		gEidosUseAVX2 = true;
+	}
+#endif
+	
+	// The remaining tests are of the interleaved lanes of -fitnessLanes, which are the only fitness products that use AVX2
+	bool saved_fitness_lanes = SLiM_fitness_lanes;
+	
+	SLiM_fitness_lanes = true;
+	
+#if EIDOS_HAS_AVX2_DISPATCH
+	// The AVX2 kernels are only used on CPUs that support AVX2; they must produce exactly the same results as the portable kernels
+	if (gEidosUseAVX2)
+	{
+		// fitness products over nonneutral caches, with many nonneutral mutations per genome, in diploids and with an unpaired Y
+		std::string simd_setup("initialize() { initializeMutationRate(1e-5); initializeMutationType('m1', 0.3, 'g', -0.01, 0.5); initializeMutationType('m2', 0.7, 'e', 0.005); initializeGenomicElementType('g1', c(m1, m2), c(1.0, 0.5)); initializeGenomicElement(g1, 0, 199999); initializeRecombinationRate(1e-6); ");
+		std::string simd_end(" 40 late() { sim.outputFull(); } ");
+		
+		SLiMAssertScriptAVX2Matches(simd_setup + "} 1 { sim.addSubpop('p1', 100); }" + simd_end, __LINE__);
+		SLiMAssertScriptAVX2Matches(simd_setup + "initializeSex('Y'); } 1 { sim.addSubpop('p1', 100); }" + simd_end, __LINE__);
+	}
+#endif
+	
+	// The lanes do not round exactly as a serial product of the same factors would; check them against a serial product computed
+	// in script.  The tolerance is loose because SLiM caches each factor (1+s or 1+hs) in single precision while the script computes
+	// it in double precision, which differs by up to ~6e-8 per factor; the reordering itself changes the product by only a few ulps.
+	// This catches factors that are missing, duplicated, or given the wrong dominance, on whichever kernel is in use.
+	std::string serial_product_setup("initialize() { initializeMutationRate(1e-5); initializeMutationType('m1', 0.3, 'g', -0.01, 0.5); initializeMutationType('m2', 0.7, 'e', 0.005); initializeGenomicElementType('g1', c(m1, m2), c(1.0, 0.5)); initializeGenomicElement(g1, 0, 199999); initializeRecombinationRate(1e-6); } 1 { sim.addSubpop('p1', 100); } ");
+	std::string serial_product_check("40 early() { for (ind in p1.individuals) { genome1 = ind.genome1; genome2 = ind.genome2; muts = unique(c(genome1.mutations, genome2.mutations)); w = 1.0; if (size(muts)) { s = muts.selectionCoeff; h = muts.mutationType.dominanceCoeff; hom = genome1.containsMutations(muts) & genome2.containsMutations(muts); w = product(ifelse(hom, 1.0 + s, 1.0 + h * s)); } cached = p1.cachedFitness(ind.index); if (abs(cached - w) > 1e-4 * w) stop('fitness ' + cached + ' differs from serial product ' + w); } } ");
+	
+	SLiMAssertScriptSuccess(serial_product_setup + serial_product_check, __LINE__);
+#if EIDOS_HAS_AVX2_DISPATCH
+	if (gEidosUseAVX2)
+	{
+		gEidosUseAVX2 = false;
+		SLiMAssertScriptSuccess(serial_product_setup + serial_product_check, __LINE__);
+		gEidosUseAVX2 = true;
+	}
+#endif
+	
+	SLiM_fitness_lanes = saved_fitness_lanes;
+}
+
+
 
 
 
@@ -35,6 +35,10 @@
 #include <map>
 #include <utility>
 
+#if EIDOS_HAS_AVX2_DISPATCH
+#include <immintrin.h>
+#endif
+
 extern std::vector<EidosValue_Object *> gEidosValue_Object_Genome_Registry;		// this is in Eidos; see Subpopulation::ExecuteMethod_takeMigrants()
 extern std::vector<EidosValue_Object *> gEidosValue_Object_Individual_Registry;	// this is in Eidos; see Subpopulation::ExecuteMethod_takeMigrants()
 
@@ -1052,7 +1056,7 @@ Subpopulation::Subpopulation(Population &p_population, slim_objectid_t p_subpopu
 		for (slim_popsize_t i = 0; i < parent_subpop_size_; i++)
 			*(fitness_buffer_ptr++) = 1.0;
 		
-		lookup_parent_ = gsl_ran_discrete_preproc(parent_subpop_size_, cached_parental_fitness_);
+		lookup_parent_.Rebuild(parent_subpop_size_, cached_parental_fitness_);
 	}
 #endif	// SLIM_WF_ONLY
 }
@@ -1116,8 +1120,8 @@ Subpopulation::Subpopulation(Population &p_population, slim_objectid_t p_subpopu
 			*(male_buffer_ptr++) = 1.0;
 		}
 		
-		lookup_female_parent_ = gsl_ran_discrete_preproc(parent_first_male_index_, cached_parental_fitness_);
-		lookup_male_parent_ = gsl_ran_discrete_preproc(num_males, cached_parental_fitness_ + parent_first_male_index_);
+		lookup_female_parent_.Rebuild(parent_first_male_index_, cached_parental_fitness_);
+		lookup_male_parent_.Rebuild(num_males, cached_parental_fitness_ + parent_first_male_index_);
 	}
 #endif	// SLIM_WF_ONLY
 }
@@ -1128,15 +1132,6 @@ Subpopulation::~Subpopulation(void)
 	//std::cout << "Subpopulation::~Subpopulation" << std::endl;
 	
 #ifdef SLIM_WF_ONLY
-	if (lookup_parent_)
-		gsl_ran_discrete_free(lookup_parent_);
-	
-	if (lookup_female_parent_)
-		gsl_ran_discrete_free(lookup_female_parent_);
-	
-	if (lookup_male_parent_)
-		gsl_ran_discrete_free(lookup_male_parent_);
-	
 	if (cached_parental_fitness_)
 		free(cached_parental_fitness_);
 	
@@ -1401,6 +1396,20 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_fitness_callba
 	bool pure_neutral = (!fitness_callbacks_exist && !global_fitness_callbacks_exist && population_.sim_.pure_neutral_);
 	double subpop_fitness_scaling = fitness_scaling_;
 	
+#ifdef _OPENMP
+	// When no callbacks are active, the fitness of each individual is independent of every other individual's, so the loops below
+	// can be split across threads; see UpdateFitness_Parallel().  Callbacks run Eidos code, which is not thread-safe, so any active
+	// callback keeps us on the serial path.  Calculating fitness from fitnessScaling values alone is so cheap that it takes a much
+	// larger subpopulation for the threading overhead to pay off than calculating fitness from mutations does.
+	bool parallel_chromosomal_fitness = false, parallel_scaling_fitness = false;
+	
+	if ((gEidosMaxThreads > 1) && !fitness_callbacks_exist && !global_fitness_callbacks_exist)
+	{
+		parallel_chromosomal_fitness = (parent_subpop_size_ >= 100);
+		parallel_scaling_fitness = (parent_subpop_size_ >= 10000);
+	}
+#endif
+	
 #if (!defined(SLIMGUI) && defined(SLIM_WF_ONLY))
 	// Reset our override of individual cached fitness values; we make this decision afresh with each UpdateFitness() call.  See
 	// the header for further comments on this mechanism.
@@ -1418,12 +1427,21 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_fitness_callba
 		{
 			if (Individual::s_any_individual_fitness_scaling_set_)
 			{
-				for (slim_popsize_t female_index = 0; female_index < parent_first_male_index_; female_index++)
+#ifdef _OPENMP
+				if (parallel_scaling_fitness)
 				{
-					double fitness = subpop_fitness_scaling * parent_individuals_[female_index]->fitness_scaling_;
-					
-					parent_individuals_[female_index]->cached_fitness_UNSAFE_ = fitness;
-					totalFemaleFitness += fitness;
+					totalFemaleFitness = UpdateFitness_Parallel(0, parent_first_male_index_, false, subpop_fitness_scaling);
+				}
+				else
+#endif
+				{
+					for (slim_popsize_t female_index = 0; female_index < parent_first_male_index_; female_index++)
+					{
+						double fitness = subpop_fitness_scaling * parent_individuals_[female_index]->fitness_scaling_;
+						
+						parent_individuals_[female_index]->cached_fitness_UNSAFE_ = fitness;
+						totalFemaleFitness += fitness;
+					}
 				}
 			}
 			else
@@ -1450,40 +1468,58 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_fitness_callba
 		}
 		else if (skip_chromosomal_fitness)
 		{
-			for (slim_popsize_t female_index = 0; female_index < parent_first_male_index_; female_index++)
+#ifdef _OPENMP
+			if (parallel_scaling_fitness)
 			{
-				double fitness = subpop_fitness_scaling * parent_individuals_[female_index]->fitness_scaling_;
-				
-				if (global_fitness_callbacks_exist && (fitness > 0.0))
-					fitness *= ApplyGlobalFitnessCallbacks(p_global_fitness_callbacks, female_index);
-				
-				parent_individuals_[female_index]->cached_fitness_UNSAFE_ = fitness;
-				totalFemaleFitness += fitness;
+				totalFemaleFitness = UpdateFitness_Parallel(0, parent_first_male_index_, false, subpop_fitness_scaling);
+			}
+			else
+#endif
+			{
+				for (slim_popsize_t female_index = 0; female_index < parent_first_male_index_; female_index++)
+				{
+					double fitness = subpop_fitness_scaling * parent_individuals_[female_index]->fitness_scaling_;
+					
+					if (global_fitness_callbacks_exist && (fitness > 0.0))
+						fitness *= ApplyGlobalFitnessCallbacks(p_global_fitness_callbacks, female_index);
+					
+					parent_individuals_[female_index]->cached_fitness_UNSAFE_ = fitness;
+					totalFemaleFitness += fitness;
+				}
 			}
 		}
 		else
 		{
 			// general case for females
-			for (slim_popsize_t female_index = 0; female_index < parent_first_male_index_; female_index++)
+#ifdef _OPENMP
+			if (parallel_chromosomal_fitness)
 			{
-				double fitness = subpop_fitness_scaling * parent_individuals_[female_index]->fitness_scaling_;
-				
-				if (fitness > 0.0)
+				totalFemaleFitness = UpdateFitness_Parallel(0, parent_first_male_index_, true, subpop_fitness_scaling);
+			}
+			else
+#endif
+			{
+				for (slim_popsize_t female_index = 0; female_index < parent_first_male_index_; female_index++)
 				{
-					if (!fitness_callbacks_exist)
-						fitness *= FitnessOfParentWithGenomeIndices_NoCallbacks(female_index);
-					else if (single_fitness_callback)
-						fitness *= FitnessOfParentWithGenomeIndices_SingleCallback(female_index, p_fitness_callbacks, single_callback_mut_type);
-					else
-						fitness *= FitnessOfParentWithGenomeIndices_Callbacks(female_index, p_fitness_callbacks);
+					double fitness = subpop_fitness_scaling * parent_individuals_[female_index]->fitness_scaling_;
 					
-					// multiply in the effects of any global fitness callbacks (muttype==NULL)
-					if (global_fitness_callbacks_exist && (fitness > 0.0))
-						fitness *= ApplyGlobalFitnessCallbacks(p_global_fitness_callbacks, female_index);
+					if (fitness > 0.0)
+					{
+						if (!fitness_callbacks_exist)
+							fitness *= FitnessOfParentWithGenomeIndices_NoCallbacks(female_index);
+						else if (single_fitness_callback)
+							fitness *= FitnessOfParentWithGenomeIndices_SingleCallback(female_index, p_fitness_callbacks, single_callback_mut_type);
+						else
+							fitness *= FitnessOfParentWithGenomeIndices_Callbacks(female_index, p_fitness_callbacks);
+						
+						// multiply in the effects of any global fitness callbacks (muttype==NULL)
+						if (global_fitness_callbacks_exist && (fitness > 0.0))
+							fitness *= ApplyGlobalFitnessCallbacks(p_global_fitness_callbacks, female_index);
+					}
+					
+					parent_individuals_[female_index]->cached_fitness_UNSAFE_ = fitness;
+					totalFemaleFitness += fitness;
 				}
-				
-				parent_individuals_[female_index]->cached_fitness_UNSAFE_ = fitness;
-				totalFemaleFitness += fitness;
 			}
 		}
 		
@@ -1496,12 +1532,21 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_fitness_callba
 		{
 			if (Individual::s_any_individual_fitness_scaling_set_)
 			{
-				for (slim_popsize_t male_index = parent_first_male_index_; male_index < parent_subpop_size_; male_index++)
+#ifdef _OPENMP
+				if (parallel_scaling_fitness)
 				{
-					double fitness = subpop_fitness_scaling * parent_individuals_[male_index]->fitness_scaling_;
-					
-					parent_individuals_[male_index]->cached_fitness_UNSAFE_ = fitness;
-					totalMaleFitness += fitness;
+					totalMaleFitness = UpdateFitness_Parallel(parent_first_male_index_, parent_subpop_size_, false, subpop_fitness_scaling);
+				}
+				else
+#endif
+				{
+					for (slim_popsize_t male_index = parent_first_male_index_; male_index < parent_subpop_size_; male_index++)
+					{
+						double fitness = subpop_fitness_scaling * parent_individuals_[male_index]->fitness_scaling_;
+						
+						parent_individuals_[male_index]->cached_fitness_UNSAFE_ = fitness;
+						totalMaleFitness += fitness;
+					}
 				}
 			}
 			else
@@ -1529,40 +1574,58 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_fitness_callba
 		}
 		else if (skip_chromosomal_fitness)
 		{
-			for (slim_popsize_t male_index = parent_first_male_index_; male_index < parent_subpop_size_; male_index++)
+#ifdef _OPENMP
+			if (parallel_scaling_fitness)
 			{
-				double fitness = subpop_fitness_scaling * parent_individuals_[male_index]->fitness_scaling_;
-				
-				if (global_fitness_callbacks_exist && (fitness > 0.0))
-					fitness *= ApplyGlobalFitnessCallbacks(p_global_fitness_callbacks, male_index);
-				
-				parent_individuals_[male_index]->cached_fitness_UNSAFE_ = fitness;
-				totalMaleFitness += fitness;
+				totalMaleFitness = UpdateFitness_Parallel(parent_first_male_index_, parent_subpop_size_, false, subpop_fitness_scaling);
+			}
+			else
+#endif
+			{
+				for (slim_popsize_t male_index = parent_first_male_index_; male_index < parent_subpop_size_; male_index++)
+				{
+					double fitness = subpop_fitness_scaling * parent_individuals_[male_index]->fitness_scaling_;
+					
+					if (global_fitness_callbacks_exist && (fitness > 0.0))
+						fitness *= ApplyGlobalFitnessCallbacks(p_global_fitness_callbacks, male_index);
+					
+					parent_individuals_[male_index]->cached_fitness_UNSAFE_ = fitness;
+					totalMaleFitness += fitness;
+				}
 			}
 		}
 		else
 		{
 			// general case for males
-			for (slim_popsize_t male_index = parent_first_male_index_; male_index < parent_subpop_size_; male_index++)
+#ifdef _OPENMP
+			if (parallel_chromosomal_fitness)
 			{
-				double fitness = subpop_fitness_scaling * parent_individuals_[male_index]->fitness_scaling_;
-				
-				if (fitness > 0.0)
+				totalMaleFitness = UpdateFitness_Parallel(parent_first_male_index_, parent_subpop_size_, true, subpop_fitness_scaling);
+			}
+			else
+#endif
+			{
+				for (slim_popsize_t male_index = parent_first_male_index_; male_index < parent_subpop_size_; male_index++)
 				{
-					if (!fitness_callbacks_exist)
-						fitness *= FitnessOfParentWithGenomeIndices_NoCallbacks(male_index);
-					else if (single_fitness_callback)
-						fitness *= FitnessOfParentWithGenomeIndices_SingleCallback(male_index, p_fitness_callbacks, single_callback_mut_type);
-					else
-						fitness *= FitnessOfParentWithGenomeIndices_Callbacks(male_index, p_fitness_callbacks);
+					double fitness = subpop_fitness_scaling * parent_individuals_[male_index]->fitness_scaling_;
 					
-					// multiply in the effects of any global fitness callbacks (muttype==NULL)
-					if (global_fitness_callbacks_exist && (fitness > 0.0))
-						fitness *= ApplyGlobalFitnessCallbacks(p_global_fitness_callbacks, male_index);
+					if (fitness > 0.0)
+					{
+						if (!fitness_callbacks_exist)
+							fitness *= FitnessOfParentWithGenomeIndices_NoCallbacks(male_index);
+						else if (single_fitness_callback)
+							fitness *= FitnessOfParentWithGenomeIndices_SingleCallback(male_index, p_fitness_callbacks, single_callback_mut_type);
+						else
+							fitness *= FitnessOfParentWithGenomeIndices_Callbacks(male_index, p_fitness_callbacks);
+						
+						// multiply in the effects of any global fitness callbacks (muttype==NULL)
+						if (global_fitness_callbacks_exist && (fitness > 0.0))
+							fitness *= ApplyGlobalFitnessCallbacks(p_global_fitness_callbacks, male_index);
+					}
+					
+					parent_individuals_[male_index]->cached_fitness_UNSAFE_ = fitness;
+					totalMaleFitness += fitness;
 				}
-				
-				parent_individuals_[male_index]->cached_fitness_UNSAFE_ = fitness;
-				totalMaleFitness += fitness;
 			}
 		}
 		
@@ -1582,12 +1645,21 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_fitness_callba
 		{
 			if (Individual::s_any_individual_fitness_scaling_set_)
 			{
-				for (slim_popsize_t individual_index = 0; individual_index < parent_subpop_size_; individual_index++)
+#ifdef _OPENMP
+				if (parallel_scaling_fitness)
 				{
-					double fitness = subpop_fitness_scaling * parent_individuals_[individual_index]->fitness_scaling_;
-					
-					parent_individuals_[individual_index]->cached_fitness_UNSAFE_ = fitness;
-					totalFitness += fitness;
+					totalFitness = UpdateFitness_Parallel(0, parent_subpop_size_, false, subpop_fitness_scaling);
+				}
+				else
+#endif
+				{
+					for (slim_popsize_t individual_index = 0; individual_index < parent_subpop_size_; individual_index++)
+					{
+						double fitness = subpop_fitness_scaling * parent_individuals_[individual_index]->fitness_scaling_;
+						
+						parent_individuals_[individual_index]->cached_fitness_UNSAFE_ = fitness;
+						totalFitness += fitness;
+					}
 				}
 			}
 			else
@@ -1614,41 +1686,59 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_fitness_callba
 		}
 		else if (skip_chromosomal_fitness)
 		{
-			for (slim_popsize_t individual_index = 0; individual_index < parent_subpop_size_; individual_index++)
+#ifdef _OPENMP
+			if (parallel_scaling_fitness)
 			{
-				double fitness = subpop_fitness_scaling * parent_individuals_[individual_index]->fitness_scaling_;
-				
-				// multiply in the effects of any global fitness callbacks (muttype==NULL)
-				if (global_fitness_callbacks_exist && (fitness > 0.0))
-					fitness *= ApplyGlobalFitnessCallbacks(p_global_fitness_callbacks, individual_index);
-				
-				parent_individuals_[individual_index]->cached_fitness_UNSAFE_ = fitness;
-				totalFitness += fitness;
+				totalFitness = UpdateFitness_Parallel(0, parent_subpop_size_, false, subpop_fitness_scaling);
+			}
+			else
+#endif
+			{
+				for (slim_popsize_t individual_index = 0; individual_index < parent_subpop_size_; individual_index++)
+				{
+					double fitness = subpop_fitness_scaling * parent_individuals_[individual_index]->fitness_scaling_;
+					
+					// multiply in the effects of any global fitness callbacks (muttype==NULL)
+					if (global_fitness_callbacks_exist && (fitness > 0.0))
+						fitness *= ApplyGlobalFitnessCallbacks(p_global_fitness_callbacks, individual_index);
+					
+					parent_individuals_[individual_index]->cached_fitness_UNSAFE_ = fitness;
+					totalFitness += fitness;
+				}
 			}
 		}
 		else
 		{
 			// general case for hermaphrodites
-			for (slim_popsize_t individual_index = 0; individual_index < parent_subpop_size_; individual_index++)
+#ifdef _OPENMP
+			if (parallel_chromosomal_fitness)
 			{
-				double fitness = subpop_fitness_scaling * parent_individuals_[individual_index]->fitness_scaling_;
-				
-				if (fitness > 0)
+				totalFitness = UpdateFitness_Parallel(0, parent_subpop_size_, true, subpop_fitness_scaling);
+			}
+			else
+#endif
+			{
+				for (slim_popsize_t individual_index = 0; individual_index < parent_subpop_size_; individual_index++)
 				{
-					if (!fitness_callbacks_exist)
-						fitness *= FitnessOfParentWithGenomeIndices_NoCallbacks(individual_index);
-					else if (single_fitness_callback)
-						fitness *= FitnessOfParentWithGenomeIndices_SingleCallback(individual_index, p_fitness_callbacks, single_callback_mut_type);
-					else
-						fitness *= FitnessOfParentWithGenomeIndices_Callbacks(individual_index, p_fitness_callbacks);
+					double fitness = subpop_fitness_scaling * parent_individuals_[individual_index]->fitness_scaling_;
 					
-					// multiply in the effects of any global fitness callbacks (muttype==NULL)
-					if (global_fitness_callbacks_exist && (fitness > 0.0))
-						fitness *= ApplyGlobalFitnessCallbacks(p_global_fitness_callbacks, individual_index);
+					if (fitness > 0)
+					{
+						if (!fitness_callbacks_exist)
+							fitness *= FitnessOfParentWithGenomeIndices_NoCallbacks(individual_index);
+						else if (single_fitness_callback)
+							fitness *= FitnessOfParentWithGenomeIndices_SingleCallback(individual_index, p_fitness_callbacks, single_callback_mut_type);
+						else
+							fitness *= FitnessOfParentWithGenomeIndices_Callbacks(individual_index, p_fitness_callbacks);
+						
+						// multiply in the effects of any global fitness callbacks (muttype==NULL)
+						if (global_fitness_callbacks_exist && (fitness > 0.0))
+							fitness *= ApplyGlobalFitnessCallbacks(p_global_fitness_callbacks, individual_index);
+					}
+					
+					parent_individuals_[individual_index]->cached_fitness_UNSAFE_ = fitness;
+					totalFitness += fitness;
 				}
-				
-				parent_individuals_[individual_index]->cached_fitness_UNSAFE_ = fitness;
-				totalFitness += fitness;
 			}
 		}
 		
@@ -1667,6 +1757,71 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_fitness_callba
 #endif	// SLIM_WF_ONLY
 }
 
+#ifdef _OPENMP
+double Subpopulation::UpdateFitness_Parallel(slim_popsize_t p_first_index, slim_popsize_t p_last_index, bool p_chromosomal_fitness, double p_subpop_fitness_scaling)
+{
+	// This does the work of the loops in UpdateFitness() for individuals in [p_first_index, p_last_index), across threads, for the case
+	// in which no fitness() callbacks (global or otherwise) are active.  If p_chromosomal_fitness is false, fitness comes from fitnessScaling
+	// values alone; otherwise FitnessOfParentWithGenomeIndices_NoCallbacks() is used as well.  Each thread writes only the cached fitness of
+	// the individuals it handles; the total is then summed serially, in index order, so that it matches the serial loops exactly.
+	Individual **individuals = parent_individuals_.data();
+	
+#if SLIM_USE_NONNEUTRAL_CACHES
+	// The nonneutral caches are rebuilt lazily by whichever genome reads a mutation run first; mutation runs are shared between genomes,
+	// so we need to do that rebuilding up front, single-threaded, to make FitnessOfParentWithGenomeIndices_NoCallbacks() read-only.
+	if (p_chromosomal_fitness)
+		ValidateNonneutralCaches();
+#endif
+	
+#pragma omp parallel for num_threads(gEidosMaxThreads) schedule(dynamic, 16) default(none) shared(p_first_index, p_last_index, p_chromosomal_fitness, p_subpop_fitness_scaling, individuals)
+	for (slim_popsize_t individual_index = p_first_index; individual_index < p_last_index; individual_index++)
+	{
+		double fitness = p_subpop_fitness_scaling * individuals[individual_index]->fitness_scaling_;
+		
+		if (p_chromosomal_fitness && (fitness > 0.0))
+			fitness *= FitnessOfParentWithGenomeIndices_NoCallbacks(individual_index);
+		
+		individuals[individual_index]->cached_fitness_UNSAFE_ = fitness;
+	}
+	
+	double total_fitness = 0.0;
+	
+	for (slim_popsize_t individual_index = p_first_index; individual_index < p_last_index; individual_index++)
+		total_fitness += individuals[individual_index]->cached_fitness_UNSAFE_;
+	
+	return total_fitness;
+}
+
+void Subpopulation::ValidateNonneutralCaches(void)
+{
+#if SLIM_USE_NONNEUTRAL_CACHES
+	// Bring the nonneutral cache of every mutation run in the parental generation up to date, exactly as the fitness calculation
+	// methods would do on demand.  Runs that are already valid cost only the check inside beginend_nonneutral_pointers().
+	SLiMSim &sim = population_.sim_;
+	int32_t nonneutral_change_counter = sim.nonneutral_change_counter_;
+	int32_t nonneutral_regime = sim.last_nonneutral_regime_;
+	size_t genome_count = parent_genomes_.size();
+	
+	for (size_t genome_index = 0; genome_index < genome_count; ++genome_index)
+	{
+		Genome *genome = parent_genomes_[genome_index];
+		
+		if (genome->IsNull())
+			continue;
+		
+		const int32_t mutrun_count = genome->mutrun_count_;
+		
+		for (int run_index = 0; run_index < mutrun_count; ++run_index)
+		{
+			const MutationIndex *genome_iter, *genome_max;
+			
+			genome->mutruns_[run_index]->beginend_nonneutral_pointers(&genome_iter, &genome_max, nonneutral_change_counter, nonneutral_regime);
+		}
+	}
+#endif
+}
+#endif	// _OPENMP
+
 #ifdef SLIM_WF_ONLY
 void Subpopulation::UpdateWFFitnessBuffers(bool p_pure_neutral)
 {
@@ -1743,42 +1898,74 @@ void Subpopulation::UpdateWFFitnessBuffers(bool p_pure_neutral)
 	// Remake our mate-choice lookup tables
 	if (sex_enabled_)
 	{
-		// throw out the old tables
-		if (lookup_female_parent_)
+		// in pure neutral models we don't set up the lookup tables; otherwise they are rebuilt in place, reusing their buffers
+		if (p_pure_neutral)
 		{
-			gsl_ran_discrete_free(lookup_female_parent_);
-			lookup_female_parent_ = nullptr;
+			lookup_female_parent_.Invalidate();
+			lookup_male_parent_.Invalidate();
 		}
-		
-		if (lookup_male_parent_)
-		{
-			gsl_ran_discrete_free(lookup_male_parent_);
-			lookup_male_parent_ = nullptr;
-		}
-		
-		// in pure neutral models we don't set up the discrete preproc
-		if (!p_pure_neutral)
+		else
 		{
-			lookup_female_parent_ = gsl_ran_discrete_preproc(parent_first_male_index_, cached_parental_fitness_);
-			lookup_male_parent_ = gsl_ran_discrete_preproc(parent_subpop_size_ - parent_first_male_index_, cached_parental_fitness_ + parent_first_male_index_);
+			lookup_female_parent_.Rebuild(parent_first_male_index_, cached_parental_fitness_);
+			lookup_male_parent_.Rebuild(parent_subpop_size_ - parent_first_male_index_, cached_parental_fitness_ + parent_first_male_index_);
 		}
 	}
 	else
 	{
-		// throw out the old tables
-		if (lookup_parent_)
-		{
-			gsl_ran_discrete_free(lookup_parent_);
-			lookup_parent_ = nullptr;
-		}
-		
-		// in pure neutral models we don't set up the discrete preproc
-		if (!p_pure_neutral)
-		{
-			lookup_parent_ = gsl_ran_discrete_preproc(parent_subpop_size_, cached_parental_fitness_);
-		}
+		// in pure neutral models we don't set up the lookup table; otherwise it is rebuilt in place, reusing its buffers
+		if (p_pure_neutral)
+			lookup_parent_.Invalidate();
+		else
+			lookup_parent_.Rebuild(parent_subpop_size_, cached_parental_fitness_);
 	}
 }
+
+// These batched variants draw p_count parents into p_parents, producing exactly the same indices, in the same order, as p_count
+// successive calls to the corresponding single-draw method; they simply avoid the per-draw overhead of the single-draw path.
+// Callers should use them only where the draws would otherwise be consecutive, with no other use of the RNG in between.
+void Subpopulation::DrawParentsUsingFitness(Eidos_RNG_State &p_rng, slim_popsize_t p_count, slim_popsize_t *p_parents) const
+{
+#if DEBUG
+	if (sex_enabled_)
+		EIDOS_TERMINATION << "ERROR (Subpopulation::DrawParentsUsingFitness): (internal error) called on a population for which sex is enabled." << EidosTerminate();
+#endif
+	
+	if (lookup_parent_.IsValid())
+		lookup_parent_.DrawMultiple(p_rng.gsl_rng_, p_count, p_parents, (slim_popsize_t)0);
+	else
+		for (slim_popsize_t draw_index = 0; draw_index < p_count; ++draw_index)
+			p_parents[draw_index] = static_cast<slim_popsize_t>(Eidos_rng_uniform_int(p_rng.gsl_rng_, parent_subpop_size_));
+}
+
+// SEX ONLY
+void Subpopulation::DrawFemaleParentsUsingFitness(Eidos_RNG_State &p_rng, slim_popsize_t p_count, slim_popsize_t *p_parents) const
+{
+#if DEBUG
+	if (!sex_enabled_)
+		EIDOS_TERMINATION << "ERROR (Subpopulation::DrawFemaleParentsUsingFitness): (internal error) called on a population for which sex is not enabled." << EidosTerminate();
+#endif
+	
+	if (lookup_female_parent_.IsValid())
+		lookup_female_parent_.DrawMultiple(p_rng.gsl_rng_, p_count, p_parents, (slim_popsize_t)0);
+	else
+		for (slim_popsize_t draw_index = 0; draw_index < p_count; ++draw_index)
+			p_parents[draw_index] = static_cast<slim_popsize_t>(Eidos_rng_uniform_int(p_rng.gsl_rng_, parent_first_male_index_));
+}
+
+// SEX ONLY
+void Subpopulation::DrawMaleParentsUsingFitness(Eidos_RNG_State &p_rng, slim_popsize_t p_count, slim_popsize_t *p_parents) const
+{
+#if DEBUG
+	if (!sex_enabled_)
+		EIDOS_TERMINATION << "ERROR (Subpopulation::DrawMaleParentsUsingFitness): (internal error) called on a population for which sex is not enabled." << EidosTerminate();
+#endif
+	
+	if (lookup_male_parent_.IsValid())
+		lookup_male_parent_.DrawMultiple(p_rng.gsl_rng_, p_count, p_parents, parent_first_male_index_);
+	else
+		for (slim_popsize_t draw_index = 0; draw_index < p_count; ++draw_index)
+			p_parents[draw_index] = static_cast<slim_popsize_t>(Eidos_rng_uniform_int(p_rng.gsl_rng_, parent_subpop_size_ - parent_first_male_index_) + parent_first_male_index_);
+}
 #endif	// SLIM_WF_ONLY
 
 double Subpopulation::ApplyFitnessCallbacks(MutationIndex p_mutation, int p_homozygous, double p_computed_fitness, std::vector<SLiMEidosBlock*> &p_fitness_callbacks, Individual *p_individual, Genome *p_genome1, Genome *p_genome2)
@@ -2062,6 +2249,91 @@ double Subpopulation::ApplyGlobalFitnessCallbacks(std::vector<SLiMEidosBlock*> &
 // high mutation rate, with an introduced beneficial mutation with a selection coefficient extremely close to 0, for example, would hit this case hard and
 // see a speedup of as much as 25%, so the additional complexity seems worth it (since that's quite a realistic and common case).
 
+// FitnessOfParentWithGenomeIndices_NoCallbacks() accumulates its product of fitness factors in SLiMFitnessLanes.  By default every
+// factor multiplies into lane 0, in order, and the other lanes stay 1.0, so the result is exactly the serial product that earlier
+// versions of SLiM computed.  With -fitnessLanes (SLiM_fitness_lanes), the k-th factor instead multiplies into lane k % 4, and the
+// lanes are combined at the end.  This breaks the serial dependency between multiplications, and allows runs of factors to be
+// gathered and multiplied four at a time with AVX2.  Which lane each factor goes into depends only upon its position in the sequence
+// of factors, not upon the kernel used, so the scalar and AVX2 kernels give bit-identical results; but the lanes round differently
+// from a serial product, so fitness values (and thus the course of a model with a given seed) differ in the last bits.
+typedef struct {
+	double lane_[4];
+	uint32_t count_;
+	uint32_t lane_mask_;		// 3 for four lanes, 0 for the serial product
+} SLiMFitnessLanes;
+
+static inline __attribute__((always_inline)) void _FitnessLanesInitialize(SLiMFitnessLanes &p_lanes)
+{
+	p_lanes.lane_[0] = 1.0;
+	p_lanes.lane_[1] = 1.0;
+	p_lanes.lane_[2] = 1.0;
+	p_lanes.lane_[3] = 1.0;
+	p_lanes.count_ = 0;
+	p_lanes.lane_mask_ = (SLiM_fitness_lanes ? 3 : 0);
+}
+
+static inline __attribute__((always_inline)) void _FitnessLanesMultiply(SLiMFitnessLanes &p_lanes, double p_factor)
+{
+	p_lanes.lane_[p_lanes.count_++ & p_lanes.lane_mask_] *= p_factor;
+}
+
+static inline __attribute__((always_inline)) double _FitnessLanesProduct(const SLiMFitnessLanes &p_lanes)
+{
+	return (p_lanes.lane_[0] * p_lanes.lane_[1]) * (p_lanes.lane_[2] * p_lanes.lane_[3]);
+}
+
+// Multiply in the cached fitness factor of each mutation in [p_iter, p_max).  p_factors is the dense buffer of factors to use,
+// gSLiM_Mutation_OnePlusSel or gSLiM_Mutation_OnePlusDomSel, indexed by MutationIndex.
+static void _FitnessLanesMultiplyRun_Scalar(SLiMFitnessLanes &p_lanes, const slim_selcoeff_t *p_factors, const MutationIndex *p_iter, const MutationIndex *p_max)
+{
+	while (p_iter != p_max)
+		_FitnessLanesMultiply(p_lanes, p_factors[*p_iter++]);
+}
+
+#if EIDOS_HAS_AVX2_DISPATCH
+__attribute__((target("avx2"))) static void _FitnessLanesMultiplyRun_AVX2(SLiMFitnessLanes &p_lanes, const slim_selcoeff_t *p_factors, const MutationIndex *p_iter, const MutationIndex *p_max)
+{
+	// Get to a factor that goes into lane 0, so that each group of four factors lines up with the four lanes
+	while ((p_iter != p_max) && (p_lanes.count_ & 3))
+		_FitnessLanesMultiply(p_lanes, p_factors[*p_iter++]);
+	
+	if (p_max - p_iter >= 4)
+	{
+		__m256d product = _mm256_loadu_pd(p_lanes.lane_);
+		
+		do
+		{
+			// Gather the four float factors directly by their 32-bit mutation indices, then widen them to double
+			__m128i indices = _mm_loadu_si128((const __m128i *)p_iter);
+			__m128 factors = _mm_i32gather_ps(p_factors, indices, sizeof(slim_selcoeff_t));
+			
+			product = _mm256_mul_pd(product, _mm256_cvtps_pd(factors));
+			p_iter += 4;
+			p_lanes.count_ += 4;
+		}
+		while (p_max - p_iter >= 4);
+		
+		_mm256_storeu_pd(p_lanes.lane_, product);
+	}
+	
+	while (p_iter != p_max)
+		_FitnessLanesMultiply(p_lanes, p_factors[*p_iter++]);
+}
+#endif
+
+static inline __attribute__((always_inline)) void _FitnessLanesMultiplyRun(SLiMFitnessLanes &p_lanes, const slim_selcoeff_t *p_factors, const MutationIndex *p_iter, const MutationIndex *p_max)
+{
+#if EIDOS_HAS_AVX2_DISPATCH
+	if (gEidosUseAVX2 && (p_lanes.lane_mask_ == 3) && (p_max - p_iter >= 8))
+	{
+		_FitnessLanesMultiplyRun_AVX2(p_lanes, p_factors, p_iter, p_max);
+		return;
+	}
+#endif
+	
+	_FitnessLanesMultiplyRun_Scalar(p_lanes, p_factors, p_iter, p_max);
+}
+
 // This version of FitnessOfParentWithGenomeIndices assumes no callbacks exist.  It tests for neutral mutations and skips processing them.
 //
 double Subpopulation::FitnessOfParentWithGenomeIndices_NoCallbacks(slim_popsize_t p_individual_index)
@@ -2076,6 +2348,9 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_NoCallbacks(slim_popsize_
 #endif
 	
 	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+	const slim_position_t *mut_positions = gSLiM_Mutation_Positions;
+	const slim_selcoeff_t *one_plus_sel = gSLiM_Mutation_OnePlusSel;
+	const slim_selcoeff_t *one_plus_dom_sel = gSLiM_Mutation_OnePlusDomSel;
 	Genome *genome1 = parent_genomes_[p_individual_index * 2];
 	Genome *genome2 = parent_genomes_[p_individual_index * 2 + 1];
 	bool genome1_null = genome1->IsNull();
@@ -2091,6 +2366,9 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_NoCallbacks(slim_popsize_
 		// SEX ONLY: one genome is null, so we just need to scan through the modeled genome and account for its mutations, including the x-dominance coefficient
 		const Genome *genome = genome1_null ? genome2 : genome1;
 		const int32_t mutrun_count = genome->mutrun_count_;
+		SLiMFitnessLanes lanes;
+		
+		_FitnessLanesInitialize(lanes);
 		
 		for (int run_index = 0; run_index < mutrun_count; ++run_index)
 		{
@@ -2129,17 +2407,19 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_NoCallbacks(slim_popsize_
 			else
 			{
 				// with other types of unpaired chromosomes (like the Y chromosome of a male when we are modeling the Y) there is no dominance coefficient
-				while (genome_iter != genome_max)
-					w *= (mut_block_ptr + *genome_iter++)->cached_one_plus_sel_;
+				_FitnessLanesMultiplyRun(lanes, one_plus_sel, genome_iter, genome_max);
 			}
 		}
 		
-		return w;
+		return w * _FitnessLanesProduct(lanes);
 	}
 	else
 	{
 		// both genomes are being modeled, so we need to scan through and figure out which mutations are heterozygous and which are homozygous
 		const int32_t mutrun_count = genome1->mutrun_count_;
+		SLiMFitnessLanes lanes;
+		
+		_FitnessLanesInitialize(lanes);
 		
 		for (int run_index = 0; run_index < mutrun_count; ++run_index)
 		{
@@ -2161,36 +2441,43 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_NoCallbacks(slim_popsize_
 			const MutationIndex *genome2_max = mutrun2->end_pointer_const();
 #endif
 			
+			// if both genomes share the same mutation run, as is common, every mutation in it is homozygous and no merge is needed
+			if (mutrun1 == mutrun2)
+			{
+				_FitnessLanesMultiplyRun(lanes, one_plus_sel, genome1_iter, genome1_max);
+				continue;
+			}
+			
 			// first, handle the situation before either genome iterator has reached the end of its genome, for simplicity/speed
 			if (genome1_iter != genome1_max && genome2_iter != genome2_max)
 			{
 				MutationIndex genome1_mutation = *genome1_iter, genome2_mutation = *genome2_iter;
-				slim_position_t genome1_iter_position = (mut_block_ptr + genome1_mutation)->position_, genome2_iter_position = (mut_block_ptr + genome2_mutation)->position_;
+				slim_position_t genome1_iter_position = mut_positions[genome1_mutation], genome2_iter_position = mut_positions[genome2_mutation];
 				
 				do
 				{
 					if (genome1_iter_position < genome2_iter_position)
 					{
 						// Process a mutation in genome1 since it is leading
-						w *= (mut_block_ptr + genome1_mutation)->cached_one_plus_dom_sel_;
+						_FitnessLanesMultiply(lanes, one_plus_dom_sel[genome1_mutation]);
 						
 						if (++genome1_iter == genome1_max)
 							break;
 						else {
 							genome1_mutation = *genome1_iter;
-							genome1_iter_position = (mut_block_ptr + genome1_mutation)->position_;
+							genome1_iter_position = mut_positions[genome1_mutation];
 						}
 					}
 					else if (genome1_iter_position > genome2_iter_position)
 					{
 						// Process a mutation in genome2 since it is leading
-						w *= (mut_block_ptr + genome2_mutation)->cached_one_plus_dom_sel_;
+						_FitnessLanesMultiply(lanes, one_plus_dom_sel[genome2_mutation]);
 						
 						if (++genome2_iter == genome2_max)
 							break;
 						else {
 							genome2_mutation = *genome2_iter;
-							genome2_iter_position = (mut_block_ptr + genome2_mutation)->position_;
+							genome2_iter_position = mut_positions[genome2_mutation];
 						}
 					}
 					else
@@ -2205,12 +2492,12 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_NoCallbacks(slim_popsize_
 							const MutationIndex *genome2_matchscan = genome2_iter; 
 							
 							// advance through genome2 with genome2_matchscan, looking for a match for the current mutation in genome1, to determine whether we are homozygous or not
-							while (genome2_matchscan != genome2_max && (mut_block_ptr + *genome2_matchscan)->position_ == position)
+							while (genome2_matchscan != genome2_max && mut_positions[*genome2_matchscan] == position)
 							{
 								if (genome1_mutation == *genome2_matchscan) 		// note pointer equality test
 								{
 									// a match was found, so we multiply our fitness by the full selection coefficient
-									w *= (mut_block_ptr + genome1_mutation)->cached_one_plus_sel_;
+									_FitnessLanesMultiply(lanes, one_plus_sel[genome1_mutation]);
 									goto homozygousExit1;
 								}
 								
@@ -2218,7 +2505,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_NoCallbacks(slim_popsize_
 							}
 							
 							// no match was found, so we are heterozygous; we multiply our fitness by the selection coefficient and the dominance coefficient
-							w *= (mut_block_ptr + genome1_mutation)->cached_one_plus_dom_sel_;
+							_FitnessLanesMultiply(lanes, one_plus_dom_sel[genome1_mutation]);
 							
 						homozygousExit1:
 							
@@ -2226,7 +2513,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_NoCallbacks(slim_popsize_
 								break;
 							else {
 								genome1_mutation = *genome1_iter;
-								genome1_iter_position = (mut_block_ptr + genome1_mutation)->position_;
+								genome1_iter_position = mut_positions[genome1_mutation];
 							}
 						} while (genome1_iter_position == position);
 						
@@ -2236,7 +2523,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_NoCallbacks(slim_popsize_
 							const MutationIndex *genome1_matchscan = genome1_start; 
 							
 							// advance through genome1 with genome1_matchscan, looking for a match for the current mutation in genome2, to determine whether we are homozygous or not
-							while (genome1_matchscan != genome1_max && (mut_block_ptr + *genome1_matchscan)->position_ == position)
+							while (genome1_matchscan != genome1_max && mut_positions[*genome1_matchscan] == position)
 							{
 								if (genome2_mutation == *genome1_matchscan)		// note pointer equality test
 								{
@@ -2248,7 +2535,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_NoCallbacks(slim_popsize_
 							}
 							
 							// no match was found, so we are heterozygous; we multiply our fitness by the selection coefficient and the dominance coefficient
-							w *= (mut_block_ptr + genome2_mutation)->cached_one_plus_dom_sel_;
+							_FitnessLanesMultiply(lanes, one_plus_dom_sel[genome2_mutation]);
 							
 						homozygousExit2:
 							
@@ -2256,7 +2543,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_NoCallbacks(slim_popsize_
 								break;
 							else {
 								genome2_mutation = *genome2_iter;
-								genome2_iter_position = (mut_block_ptr + genome2_mutation)->position_;
+								genome2_iter_position = mut_positions[genome2_mutation];
 							}
 						} while (genome2_iter_position == position);
 						
@@ -2273,15 +2560,13 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_NoCallbacks(slim_popsize_
 #endif
 			
 			// if genome1 is unfinished, finish it
-			while (genome1_iter != genome1_max)
-				w *= (mut_block_ptr + *genome1_iter++)->cached_one_plus_dom_sel_;
+			_FitnessLanesMultiplyRun(lanes, one_plus_dom_sel, genome1_iter, genome1_max);
 			
 			// if genome2 is unfinished, finish it
-			while (genome2_iter != genome2_max)
-				w *= (mut_block_ptr + *genome2_iter++)->cached_one_plus_dom_sel_;
+			_FitnessLanesMultiplyRun(lanes, one_plus_dom_sel, genome2_iter, genome2_max);
 		}
 		
-		return w;
+		return w * _FitnessLanesProduct(lanes);
 	}
 }
 
@@ -2299,6 +2584,9 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_Callbacks(slim_popsize_t
 #endif
 	
 	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+	const slim_position_t *mut_positions = gSLiM_Mutation_Positions;
+	const slim_selcoeff_t *one_plus_sel = gSLiM_Mutation_OnePlusSel;
+	const slim_selcoeff_t *one_plus_dom_sel = gSLiM_Mutation_OnePlusDomSel;
 	Individual *individual = parent_individuals_[p_individual_index];
 	Genome *genome1 = parent_genomes_[p_individual_index * 2];
 	Genome *genome2 = parent_genomes_[p_individual_index * 2 + 1];
@@ -2355,7 +2643,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_Callbacks(slim_popsize_t
 				{
 					MutationIndex genome_mutation = *genome_iter;
 					
-					w *= ApplyFitnessCallbacks(genome_mutation, -1, (mut_block_ptr + genome_mutation)->cached_one_plus_sel_, p_fitness_callbacks, individual, genome1, genome2);
+					w *= ApplyFitnessCallbacks(genome_mutation, -1, one_plus_sel[genome_mutation], p_fitness_callbacks, individual, genome1, genome2);
 					
 					if (w <= 0.0)
 						return 0.0;
@@ -2396,14 +2684,14 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_Callbacks(slim_popsize_t
 			if (genome1_iter != genome1_max && genome2_iter != genome2_max)
 			{
 				MutationIndex genome1_mutation = *genome1_iter, genome2_mutation = *genome2_iter;
-				slim_position_t genome1_iter_position = (mut_block_ptr + genome1_mutation)->position_, genome2_iter_position = (mut_block_ptr + genome2_mutation)->position_;
+				slim_position_t genome1_iter_position = mut_positions[genome1_mutation], genome2_iter_position = mut_positions[genome2_mutation];
 				
 				do
 				{
 					if (genome1_iter_position < genome2_iter_position)
 					{
 						// Process a mutation in genome1 since it is leading
-						w *= ApplyFitnessCallbacks(genome1_mutation, false, (mut_block_ptr + genome1_mutation)->cached_one_plus_dom_sel_, p_fitness_callbacks, individual, genome1, genome2);
+						w *= ApplyFitnessCallbacks(genome1_mutation, false, one_plus_dom_sel[genome1_mutation], p_fitness_callbacks, individual, genome1, genome2);
 						
 						if (w <= 0.0)
 							return 0.0;
@@ -2412,13 +2700,13 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_Callbacks(slim_popsize_t
 							break;
 						else {
 							genome1_mutation = *genome1_iter;
-							genome1_iter_position = (mut_block_ptr + genome1_mutation)->position_;
+							genome1_iter_position = mut_positions[genome1_mutation];
 						}
 					}
 					else if (genome1_iter_position > genome2_iter_position)
 					{
 						// Process a mutation in genome2 since it is leading
-						w *= ApplyFitnessCallbacks(genome2_mutation, false, (mut_block_ptr + genome2_mutation)->cached_one_plus_dom_sel_, p_fitness_callbacks, individual, genome1, genome2);
+						w *= ApplyFitnessCallbacks(genome2_mutation, false, one_plus_dom_sel[genome2_mutation], p_fitness_callbacks, individual, genome1, genome2);
 						
 						if (w <= 0.0)
 							return 0.0;
@@ -2427,7 +2715,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_Callbacks(slim_popsize_t
 							break;
 						else {
 							genome2_mutation = *genome2_iter;
-							genome2_iter_position = (mut_block_ptr + genome2_mutation)->position_;
+							genome2_iter_position = mut_positions[genome2_mutation];
 						}
 					}
 					else
@@ -2442,12 +2730,12 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_Callbacks(slim_popsize_t
 							const MutationIndex *genome2_matchscan = genome2_iter; 
 							
 							// advance through genome2 with genome2_matchscan, looking for a match for the current mutation in genome1, to determine whether we are homozygous or not
-							while (genome2_matchscan != genome2_max && (mut_block_ptr + *genome2_matchscan)->position_ == position)
+							while (genome2_matchscan != genome2_max && mut_positions[*genome2_matchscan] == position)
 							{
 								if (genome1_mutation == *genome2_matchscan)		// note pointer equality test
 								{
 									// a match was found, so we multiply our fitness by the full selection coefficient
-									w *= ApplyFitnessCallbacks(genome1_mutation, true, (mut_block_ptr + genome1_mutation)->cached_one_plus_sel_, p_fitness_callbacks, individual, genome1, genome2);
+									w *= ApplyFitnessCallbacks(genome1_mutation, true, one_plus_sel[genome1_mutation], p_fitness_callbacks, individual, genome1, genome2);
 									
 									goto homozygousExit3;
 								}
@@ -2456,7 +2744,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_Callbacks(slim_popsize_t
 							}
 							
 							// no match was found, so we are heterozygous; we multiply our fitness by the selection coefficient and the dominance coefficient
-							w *= ApplyFitnessCallbacks(genome1_mutation, false, (mut_block_ptr + genome1_mutation)->cached_one_plus_dom_sel_, p_fitness_callbacks, individual, genome1, genome2);
+							w *= ApplyFitnessCallbacks(genome1_mutation, false, one_plus_dom_sel[genome1_mutation], p_fitness_callbacks, individual, genome1, genome2);
 							
 						homozygousExit3:
 							
@@ -2467,7 +2755,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_Callbacks(slim_popsize_t
 								break;
 							else {
 								genome1_mutation = *genome1_iter;
-								genome1_iter_position = (mut_block_ptr + genome1_mutation)->position_;
+								genome1_iter_position = mut_positions[genome1_mutation];
 							}
 						} while (genome1_iter_position == position);
 						
@@ -2477,7 +2765,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_Callbacks(slim_popsize_t
 							const MutationIndex *genome1_matchscan = genome1_start; 
 							
 							// advance through genome1 with genome1_matchscan, looking for a match for the current mutation in genome2, to determine whether we are homozygous or not
-							while (genome1_matchscan != genome1_max && (mut_block_ptr + *genome1_matchscan)->position_ == position)
+							while (genome1_matchscan != genome1_max && mut_positions[*genome1_matchscan] == position)
 							{
 								if (genome2_mutation == *genome1_matchscan)		// note pointer equality test
 								{
@@ -2489,7 +2777,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_Callbacks(slim_popsize_t
 							}
 							
 							// no match was found, so we are heterozygous; we multiply our fitness by the selection coefficient and the dominance coefficient
-							w *= ApplyFitnessCallbacks(genome2_mutation, false, (mut_block_ptr + genome2_mutation)->cached_one_plus_dom_sel_, p_fitness_callbacks, individual, genome1, genome2);
+							w *= ApplyFitnessCallbacks(genome2_mutation, false, one_plus_dom_sel[genome2_mutation], p_fitness_callbacks, individual, genome1, genome2);
 							
 							if (w <= 0.0)
 								return 0.0;
@@ -2500,7 +2788,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_Callbacks(slim_popsize_t
 								break;
 							else {
 								genome2_mutation = *genome2_iter;
-								genome2_iter_position = (mut_block_ptr + genome2_mutation)->position_;
+								genome2_iter_position = mut_positions[genome2_mutation];
 							}
 						} while (genome2_iter_position == position);
 						
@@ -2519,7 +2807,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_Callbacks(slim_popsize_t
 			{
 				MutationIndex genome1_mutation = *genome1_iter;
 				
-				w *= ApplyFitnessCallbacks(genome1_mutation, false, (mut_block_ptr + genome1_mutation)->cached_one_plus_dom_sel_, p_fitness_callbacks, individual, genome1, genome2);
+				w *= ApplyFitnessCallbacks(genome1_mutation, false, one_plus_dom_sel[genome1_mutation], p_fitness_callbacks, individual, genome1, genome2);
 				
 				if (w <= 0.0)
 					return 0.0;
@@ -2532,7 +2820,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_Callbacks(slim_popsize_t
 			{
 				MutationIndex genome2_mutation = *genome2_iter;
 				
-				w *= ApplyFitnessCallbacks(genome2_mutation, false, (mut_block_ptr + genome2_mutation)->cached_one_plus_dom_sel_, p_fitness_callbacks, individual, genome1, genome2);
+				w *= ApplyFitnessCallbacks(genome2_mutation, false, one_plus_dom_sel[genome2_mutation], p_fitness_callbacks, individual, genome1, genome2);
 				
 				if (w <= 0.0)
 					return 0.0;
@@ -2559,6 +2847,9 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 #endif
 	
 	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+	const slim_position_t *mut_positions = gSLiM_Mutation_Positions;
+	const slim_selcoeff_t *one_plus_sel = gSLiM_Mutation_OnePlusSel;
+	const slim_selcoeff_t *one_plus_dom_sel = gSLiM_Mutation_OnePlusDomSel;
 	Individual *individual = parent_individuals_[p_individual_index];
 	Genome *genome1 = parent_genomes_[p_individual_index * 2];
 	Genome *genome2 = parent_genomes_[p_individual_index * 2 + 1];
@@ -2630,14 +2921,14 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 					
 					if ((mut_block_ptr + genome_mutation)->mutation_type_ptr_ == p_single_callback_mut_type)
 					{
-						w *= ApplyFitnessCallbacks(genome_mutation, -1, (mut_block_ptr + genome_mutation)->cached_one_plus_sel_, p_fitness_callbacks, individual, genome1, genome2);
+						w *= ApplyFitnessCallbacks(genome_mutation, -1, one_plus_sel[genome_mutation], p_fitness_callbacks, individual, genome1, genome2);
 						
 						if (w <= 0.0)
 							return 0.0;
 					}
 					else
 					{
-						w *= (mut_block_ptr + genome_mutation)->cached_one_plus_sel_;
+						w *= one_plus_sel[genome_mutation];
 					}
 					
 					genome_iter++;
@@ -2676,7 +2967,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 			if (genome1_iter != genome1_max && genome2_iter != genome2_max)
 			{
 				MutationIndex genome1_mutation = *genome1_iter, genome2_mutation = *genome2_iter;
-				slim_position_t genome1_iter_position = (mut_block_ptr + genome1_mutation)->position_, genome2_iter_position = (mut_block_ptr + genome2_mutation)->position_;
+				slim_position_t genome1_iter_position = mut_positions[genome1_mutation], genome2_iter_position = mut_positions[genome2_mutation];
 				
 				do
 				{
@@ -2687,21 +2978,21 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 						
 						if (genome1_muttype == p_single_callback_mut_type)
 						{
-							w *= ApplyFitnessCallbacks(genome1_mutation, false, (mut_block_ptr + genome1_mutation)->cached_one_plus_dom_sel_, p_fitness_callbacks, individual, genome1, genome2);
+							w *= ApplyFitnessCallbacks(genome1_mutation, false, one_plus_dom_sel[genome1_mutation], p_fitness_callbacks, individual, genome1, genome2);
 							
 							if (w <= 0.0)
 								return 0.0;
 						}
 						else
 						{
-							w *= (mut_block_ptr + genome1_mutation)->cached_one_plus_dom_sel_;
+							w *= one_plus_dom_sel[genome1_mutation];
 						}
 						
 						if (++genome1_iter == genome1_max)
 							break;
 						else {
 							genome1_mutation = *genome1_iter;
-							genome1_iter_position = (mut_block_ptr + genome1_mutation)->position_;
+							genome1_iter_position = mut_positions[genome1_mutation];
 						}
 					}
 					else if (genome1_iter_position > genome2_iter_position)
@@ -2711,21 +3002,21 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 						
 						if (genome2_muttype == p_single_callback_mut_type)
 						{
-							w *= ApplyFitnessCallbacks(genome2_mutation, false, (mut_block_ptr + genome2_mutation)->cached_one_plus_dom_sel_, p_fitness_callbacks, individual, genome1, genome2);
+							w *= ApplyFitnessCallbacks(genome2_mutation, false, one_plus_dom_sel[genome2_mutation], p_fitness_callbacks, individual, genome1, genome2);
 							
 							if (w <= 0.0)
 								return 0.0;
 						}
 						else
 						{
-							w *= (mut_block_ptr + genome2_mutation)->cached_one_plus_dom_sel_;
+							w *= one_plus_dom_sel[genome2_mutation];
 						}
 						
 						if (++genome2_iter == genome2_max)
 							break;
 						else {
 							genome2_mutation = *genome2_iter;
-							genome2_iter_position = (mut_block_ptr + genome2_mutation)->position_;
+							genome2_iter_position = mut_positions[genome2_mutation];
 						}
 					}
 					else
@@ -2744,12 +3035,12 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 								const MutationIndex *genome2_matchscan = genome2_iter; 
 								
 								// advance through genome2 with genome2_matchscan, looking for a match for the current mutation in genome1, to determine whether we are homozygous or not
-								while (genome2_matchscan != genome2_max && (mut_block_ptr + *genome2_matchscan)->position_ == position)
+								while (genome2_matchscan != genome2_max && mut_positions[*genome2_matchscan] == position)
 								{
 									if (genome1_mutation == *genome2_matchscan)		// note pointer equality test
 									{
 										// a match was found, so we multiply our fitness by the full selection coefficient
-										w *= ApplyFitnessCallbacks(genome1_mutation, true, (mut_block_ptr + genome1_mutation)->cached_one_plus_sel_, p_fitness_callbacks, individual, genome1, genome2);
+										w *= ApplyFitnessCallbacks(genome1_mutation, true, one_plus_sel[genome1_mutation], p_fitness_callbacks, individual, genome1, genome2);
 										
 										goto homozygousExit5;
 									}
@@ -2758,7 +3049,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 								}
 								
 								// no match was found, so we are heterozygous; we multiply our fitness by the selection coefficient and the dominance coefficient
-								w *= ApplyFitnessCallbacks(genome1_mutation, false, (mut_block_ptr + genome1_mutation)->cached_one_plus_dom_sel_, p_fitness_callbacks, individual, genome1, genome2);
+								w *= ApplyFitnessCallbacks(genome1_mutation, false, one_plus_dom_sel[genome1_mutation], p_fitness_callbacks, individual, genome1, genome2);
 								
 							homozygousExit5:
 								
@@ -2770,12 +3061,12 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 								const MutationIndex *genome2_matchscan = genome2_iter; 
 								
 								// advance through genome2 with genome2_matchscan, looking for a match for the current mutation in genome1, to determine whether we are homozygous or not
-								while (genome2_matchscan != genome2_max && (mut_block_ptr + *genome2_matchscan)->position_ == position)
+								while (genome2_matchscan != genome2_max && mut_positions[*genome2_matchscan] == position)
 								{
 									if (genome1_mutation == *genome2_matchscan) 		// note pointer equality test
 									{
 										// a match was found, so we multiply our fitness by the full selection coefficient
-										w *= (mut_block_ptr + genome1_mutation)->cached_one_plus_sel_;
+										w *= one_plus_sel[genome1_mutation];
 										goto homozygousExit6;
 									}
 									
@@ -2783,7 +3074,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 								}
 								
 								// no match was found, so we are heterozygous; we multiply our fitness by the selection coefficient and the dominance coefficient
-								w *= (mut_block_ptr + genome1_mutation)->cached_one_plus_dom_sel_;
+								w *= one_plus_dom_sel[genome1_mutation];
 								
 							homozygousExit6:
 								;
@@ -2793,7 +3084,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 								break;
 							else {
 								genome1_mutation = *genome1_iter;
-								genome1_iter_position = (mut_block_ptr + genome1_mutation)->position_;
+								genome1_iter_position = mut_positions[genome1_mutation];
 							}
 						} while (genome1_iter_position == position);
 						
@@ -2807,7 +3098,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 								const MutationIndex *genome1_matchscan = genome1_start; 
 								
 								// advance through genome1 with genome1_matchscan, looking for a match for the current mutation in genome2, to determine whether we are homozygous or not
-								while (genome1_matchscan != genome1_max && (mut_block_ptr + *genome1_matchscan)->position_ == position)
+								while (genome1_matchscan != genome1_max && mut_positions[*genome1_matchscan] == position)
 								{
 									if (genome2_mutation == *genome1_matchscan)		// note pointer equality test
 									{
@@ -2819,7 +3110,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 								}
 								
 								// no match was found, so we are heterozygous; we multiply our fitness by the selection coefficient and the dominance coefficient
-								w *= ApplyFitnessCallbacks(genome2_mutation, false, (mut_block_ptr + genome2_mutation)->cached_one_plus_dom_sel_, p_fitness_callbacks, individual, genome1, genome2);
+								w *= ApplyFitnessCallbacks(genome2_mutation, false, one_plus_dom_sel[genome2_mutation], p_fitness_callbacks, individual, genome1, genome2);
 								
 								if (w <= 0.0)
 									return 0.0;
@@ -2832,7 +3123,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 								const MutationIndex *genome1_matchscan = genome1_start; 
 								
 								// advance through genome1 with genome1_matchscan, looking for a match for the current mutation in genome2, to determine whether we are homozygous or not
-								while (genome1_matchscan != genome1_max && (mut_block_ptr + *genome1_matchscan)->position_ == position)
+								while (genome1_matchscan != genome1_max && mut_positions[*genome1_matchscan] == position)
 								{
 									if (genome2_mutation == *genome1_matchscan)		// note pointer equality test
 									{
@@ -2844,7 +3135,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 								}
 								
 								// no match was found, so we are heterozygous; we multiply our fitness by the selection coefficient and the dominance coefficient
-								w *= (mut_block_ptr + genome2_mutation)->cached_one_plus_dom_sel_;
+								w *= one_plus_dom_sel[genome2_mutation];
 								
 							homozygousExit8:
 								;
@@ -2854,7 +3145,7 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 								break;
 							else {
 								genome2_mutation = *genome2_iter;
-								genome2_iter_position = (mut_block_ptr + genome2_mutation)->position_;
+								genome2_iter_position = mut_positions[genome2_mutation];
 							}
 						} while (genome2_iter_position == position);
 						
@@ -2876,14 +3167,14 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 				
 				if (genome1_muttype == p_single_callback_mut_type)
 				{
-					w *= ApplyFitnessCallbacks(genome1_mutation, false, (mut_block_ptr + genome1_mutation)->cached_one_plus_dom_sel_, p_fitness_callbacks, individual, genome1, genome2);
+					w *= ApplyFitnessCallbacks(genome1_mutation, false, one_plus_dom_sel[genome1_mutation], p_fitness_callbacks, individual, genome1, genome2);
 					
 					if (w <= 0.0)
 						return 0.0;
 				}
 				else
 				{
-					w *= (mut_block_ptr + genome1_mutation)->cached_one_plus_dom_sel_;
+					w *= one_plus_dom_sel[genome1_mutation];
 				}
 				
 				genome1_iter++;
@@ -2897,14 +3188,14 @@ double Subpopulation::FitnessOfParentWithGenomeIndices_SingleCallback(slim_popsi
 				
 				if (genome2_muttype == p_single_callback_mut_type)
 				{
-					w *= ApplyFitnessCallbacks(genome2_mutation, false, (mut_block_ptr + genome2_mutation)->cached_one_plus_dom_sel_, p_fitness_callbacks, individual, genome1, genome2);
+					w *= ApplyFitnessCallbacks(genome2_mutation, false, one_plus_dom_sel[genome2_mutation], p_fitness_callbacks, individual, genome1, genome2);
 					
 					if (w <= 0.0)
 						return 0.0;
 				}
 				else
 				{
-					w *= (mut_block_ptr + genome2_mutation)->cached_one_plus_dom_sel_;
+					w *= one_plus_dom_sel[genome2_mutation];
 				}
 				
 				genome2_iter++;
@@ -3241,14 +3532,9 @@ size_t Subpopulation::MemoryUsageForParentTables(void)
 {
 	size_t usage = 0;
 	
-	if (lookup_parent_)
-		usage += lookup_parent_->K * (sizeof(size_t) + sizeof(double));
-	
-	if (lookup_female_parent_)
-		usage += lookup_female_parent_->K * (sizeof(size_t) + sizeof(double));
-	
-	if (lookup_male_parent_)
-		usage += lookup_male_parent_->K * (sizeof(size_t) + sizeof(double));
+	usage += lookup_parent_.MemoryUsage();
+	usage += lookup_female_parent_.MemoryUsage();
+	usage += lookup_male_parent_.MemoryUsage();
 	
 	return usage;
 }
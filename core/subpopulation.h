@@ -121,9 +121,9 @@ class Subpopulation : public SLiMEidosDictionary
 private:
 	
 #ifdef SLIM_WF_ONLY
-	gsl_ran_discrete_t *lookup_parent_ = nullptr;			// OWNED POINTER: lookup table for drawing a parent based upon fitness
-	gsl_ran_discrete_t *lookup_female_parent_ = nullptr;	// OWNED POINTER: lookup table for drawing a female parent based upon fitness, SEX ONLY
-	gsl_ran_discrete_t *lookup_male_parent_ = nullptr;		// OWNED POINTER: lookup table for drawing a male parent based upon fitness, SEX ONLY
+	EidosAliasTable lookup_parent_;							// lookup table for drawing a parent based upon fitness; not valid in pure neutral models
+	EidosAliasTable lookup_female_parent_;					// lookup table for drawing a female parent based upon fitness, SEX ONLY
+	EidosAliasTable lookup_male_parent_;					// lookup table for drawing a male parent based upon fitness, SEX ONLY
 #endif	// SLIM_WF_ONLY
 	
 	EidosSymbolTableEntry self_symbol_;						// for fast setup of the symbol table
@@ -272,9 +272,15 @@ public:
 	~Subpopulation(void);																			// destructor
 	
 #ifdef SLIM_WF_ONLY
-	slim_popsize_t DrawParentUsingFitness(void) const;										// draw an individual from the subpopulation based upon fitness
-	slim_popsize_t DrawFemaleParentUsingFitness(void) const;								// draw a female from the subpopulation based upon fitness; SEX ONLY
-	slim_popsize_t DrawMaleParentUsingFitness(void) const;									// draw a male from the subpopulation based upon fitness; SEX ONLY
+	slim_popsize_t DrawParentUsingFitness(Eidos_RNG_State &p_rng) const;					// draw an individual from the subpopulation based upon fitness
+	slim_popsize_t DrawFemaleParentUsingFitness(Eidos_RNG_State &p_rng) const;				// draw a female from the subpopulation based upon fitness; SEX ONLY
+	slim_popsize_t DrawMaleParentUsingFitness(Eidos_RNG_State &p_rng) const;				// draw a male from the subpopulation based upon fitness; SEX ONLY
+	inline slim_popsize_t DrawParentUsingFitness(void) const { return DrawParentUsingFitness(gEidos_RNG); }				// as above, drawing from gEidos_RNG
+	inline slim_popsize_t DrawFemaleParentUsingFitness(void) const { return DrawFemaleParentUsingFitness(gEidos_RNG); }
+	inline slim_popsize_t DrawMaleParentUsingFitness(void) const { return DrawMaleParentUsingFitness(gEidos_RNG); }
+	void DrawParentsUsingFitness(Eidos_RNG_State &p_rng, slim_popsize_t p_count, slim_popsize_t *p_parents) const;			// draw p_count individuals, as if by p_count calls
+	void DrawFemaleParentsUsingFitness(Eidos_RNG_State &p_rng, slim_popsize_t p_count, slim_popsize_t *p_parents) const;	// draw p_count females; SEX ONLY
+	void DrawMaleParentsUsingFitness(Eidos_RNG_State &p_rng, slim_popsize_t p_count, slim_popsize_t *p_parents) const;		// draw p_count males; SEX ONLY
 #endif	// SLIM_WF_ONLY
 	slim_popsize_t DrawParentEqualProbability(void) const;									// draw an individual from the subpopulation with equal probabilities
 	slim_popsize_t DrawFemaleParentEqualProbability(void) const;							// draw a female from the subpopulation  with equal probabilities; SEX ONLY
@@ -355,6 +361,10 @@ public:
 #ifdef SLIM_WF_ONLY
 	void UpdateWFFitnessBuffers(bool p_pure_neutral);																					// update the WF model fitness buffers after UpdateFitness()
 #endif	// SLIM_WF_ONLY
+#ifdef _OPENMP
+	double UpdateFitness_Parallel(slim_popsize_t p_first_index, slim_popsize_t p_last_index, bool p_chromosomal_fitness, double p_subpop_fitness_scaling);	// UpdateFitness() without callbacks, across threads
+	void ValidateNonneutralCaches(void);																								// validate the nonneutral caches of all parental mutation runs
+#endif
 	
 	// calculate the fitness of a given individual; the x dominance coeff is used only if the X is modeled
 	double FitnessOfParentWithGenomeIndices_NoCallbacks(slim_popsize_t p_individual_index);
@@ -519,17 +529,17 @@ public:
 
 
 #ifdef SLIM_WF_ONLY
-inline __attribute__((always_inline)) slim_popsize_t Subpopulation::DrawParentUsingFitness(void) const
+inline __attribute__((always_inline)) slim_popsize_t Subpopulation::DrawParentUsingFitness(Eidos_RNG_State &p_rng) const
 {
 #if DEBUG
 	if (sex_enabled_)
 		EIDOS_TERMINATION << "ERROR (Subpopulation::DrawParentUsingFitness): (internal error) called on a population for which sex is enabled." << EidosTerminate();
 #endif
 	
-	if (lookup_parent_)
-		return static_cast<slim_popsize_t>(gsl_ran_discrete(EIDOS_GSL_RNG, lookup_parent_));
+	if (lookup_parent_.IsValid())
+		return static_cast<slim_popsize_t>(lookup_parent_.Draw(p_rng.gsl_rng_));
 	else
-		return static_cast<slim_popsize_t>(Eidos_rng_uniform_int(EIDOS_GSL_RNG, parent_subpop_size_));
+		return static_cast<slim_popsize_t>(Eidos_rng_uniform_int(p_rng.gsl_rng_, parent_subpop_size_));
 }
 #endif	// SLIM_WF_ONLY
 
@@ -545,17 +555,17 @@ inline __attribute__((always_inline)) slim_popsize_t Subpopulation::DrawParentEq
 
 #ifdef SLIM_WF_ONLY
 // SEX ONLY
-inline __attribute__((always_inline)) slim_popsize_t Subpopulation::DrawFemaleParentUsingFitness(void) const
+inline __attribute__((always_inline)) slim_popsize_t Subpopulation::DrawFemaleParentUsingFitness(Eidos_RNG_State &p_rng) const
 {
 #if DEBUG
 	if (!sex_enabled_)
 		EIDOS_TERMINATION << "ERROR (Subpopulation::DrawFemaleParentUsingFitness): (internal error) called on a population for which sex is not enabled." << EidosTerminate();
 #endif
 	
-	if (lookup_female_parent_)
-		return static_cast<slim_popsize_t>(gsl_ran_discrete(EIDOS_GSL_RNG, lookup_female_parent_));
+	if (lookup_female_parent_.IsValid())
+		return static_cast<slim_popsize_t>(lookup_female_parent_.Draw(p_rng.gsl_rng_));
 	else
-		return static_cast<slim_popsize_t>(Eidos_rng_uniform_int(EIDOS_GSL_RNG, parent_first_male_index_));
+		return static_cast<slim_popsize_t>(Eidos_rng_uniform_int(p_rng.gsl_rng_, parent_first_male_index_));
 }
 #endif	// SLIM_WF_ONLY
 
@@ -572,17 +582,17 @@ inline __attribute__((always_inline)) slim_popsize_t Subpopulation::DrawFemalePa
 
 #ifdef SLIM_WF_ONLY
 // SEX ONLY
-inline __attribute__((always_inline)) slim_popsize_t Subpopulation::DrawMaleParentUsingFitness(void) const
+inline __attribute__((always_inline)) slim_popsize_t Subpopulation::DrawMaleParentUsingFitness(Eidos_RNG_State &p_rng) const
 {
 #if DEBUG
 	if (!sex_enabled_)
 		EIDOS_TERMINATION << "ERROR (Subpopulation::DrawMaleParentUsingFitness): (internal error) called on a population for which sex is not enabled." << EidosTerminate();
 #endif
 	
-	if (lookup_male_parent_)
-		return static_cast<slim_popsize_t>(gsl_ran_discrete(EIDOS_GSL_RNG, lookup_male_parent_)) + parent_first_male_index_;
+	if (lookup_male_parent_.IsValid())
+		return static_cast<slim_popsize_t>(lookup_male_parent_.Draw(p_rng.gsl_rng_)) + parent_first_male_index_;
 	else
-		return static_cast<slim_popsize_t>(Eidos_rng_uniform_int(EIDOS_GSL_RNG, parent_subpop_size_ - parent_first_male_index_) + parent_first_male_index_);
+		return static_cast<slim_popsize_t>(Eidos_rng_uniform_int(p_rng.gsl_rng_, parent_subpop_size_ - parent_first_male_index_) + parent_first_male_index_);
 }
 #endif	// SLIM_WF_ONLY
 
@@ -20,6 +20,8 @@
 
 #include "eidos_ast_node.h"
 #include "eidos_interpreter.h"
+#include "eidos_bytecode.h"
+#include "eidos_fused_expression.h"
 
 #include "errno.h"
 #include <string>
@@ -32,6 +34,18 @@ EidosObjectPool *gEidosASTNodePool = nullptr;
 
 EidosASTNode::~EidosASTNode(void)
 {
+	if (cached_bytecode_)
+	{
+		delete cached_bytecode_;
+		cached_bytecode_ = nullptr;
+	}
+	
+	if (cached_fused_expression_)
+	{
+		delete cached_fused_expression_;
+		cached_fused_expression_ = nullptr;
+	}
+	
 	for (auto child : children_)
 	{
 		// destroy children and return them to the pool; all children must be allocated out of gEidosASTNodePool!
@@ -73,6 +87,7 @@ void EidosASTNode::OptimizeTree(void) const
 	_OptimizeEvaluators();		// cache evaluator functions in cached_evaluator_ for fast node evaluation
 	_OptimizeFor();				// cache information about for loops that allows them to be accelerated at runtime
 	_OptimizeAssignments();		// cache information about assignments that allows simple increment/decrement assignments to be accelerated
+	_OptimizeFusedExpressions();	// fuse elementwise arithmetic expressions, replacing the evaluators cached by _OptimizeEvaluators()
 }
 
 void EidosASTNode::_OptimizeConstants(void) const
@@ -366,6 +381,98 @@ void EidosASTNode::_OptimizeAssignments(void) const
 	}
 }
 
+void EidosASTNode::_OptimizeFusedExpressions(void) const
+{
+	// fuse the largest expressions we can, so we try ourselves before our children; the operators inside a fused expression are
+	// left unfused, since they are evaluated only if the fused expression falls back on the AST evaluators
+	cached_fused_expression_ = EidosFusedExpression::FuseExpression(this);
+	
+	if (cached_fused_expression_)
+	{
+		cached_evaluator_ = &EidosInterpreter::Evaluate_FusedExpression;
+		return;
+	}
+	
+	for (const EidosASTNode *child : children_)
+		child->_OptimizeFusedExpressions();
+	
+	// sum() and mean() of a fused arithmetic expression accumulate its result directly
+	EidosFusedReduction reduction = EidosFusedExpression::ReductionForCall(this);
+	
+	if (reduction != EidosFusedReduction::kNone)
+	{
+		EidosFusedExpression *argument_fused = children_[1]->cached_fused_expression_;
+		
+		if (argument_fused && !argument_fused->logical_result_)
+		{
+			argument_fused->reduction_ = reduction;
+			cached_evaluator_ = &EidosInterpreter::Evaluate_FusedReduction;
+		}
+	}
+}
+
+void EidosASTNode::OptimizeTypeSpecializations(const EidosNodeTypeTable &p_node_types) const
+{
+	// This is not part of OptimizeTree(), since it depends upon type information that only the Context can supply; the Context
+	// runs EidosTypeInterpreter::TypeEvaluateInterpreterBlock_RecordNodeTypes() over a block and then calls this on the block
+	for (const EidosASTNode *child : children_)
+		child->OptimizeTypeSpecializations(p_node_types);
+	
+	// Specialized evaluators hand the operands they have already evaluated to the generic evaluator when the inferred types do not
+	// hold at runtime, so the operands are evaluated only once and may have side effects
+	if (children_.size() == 2)
+	{
+		auto first_type_iter = p_node_types.find(children_[0]);
+		auto second_type_iter = p_node_types.find(children_[1]);
+		
+		if ((first_type_iter != p_node_types.end()) && (second_type_iter != p_node_types.end()))
+		{
+			EidosEvaluationMethod specialized_evaluator = EidosInterpreter::TypeSpecializedEvaluator(token_->token_type_, first_type_iter->second, second_type_iter->second);
+			
+			// a fused expression keeps its evaluator, and uses the specialized evaluator as its fallback instead
+			if (specialized_evaluator && cached_fused_expression_)
+				cached_fused_expression_->fallback_evaluator_ = specialized_evaluator;
+			else if (specialized_evaluator)
+				cached_evaluator_ = specialized_evaluator;
+		}
+	}
+}
+
+bool EidosASTNode::_HasNoSideEffects(void) const
+{
+	// Evaluating such an expression a second time gives the same result, or raises the same error, as the first time
+	switch (token_->token_type_)
+	{
+		case EidosTokenType::kTokenNumber:
+		case EidosTokenType::kTokenString:
+		case EidosTokenType::kTokenIdentifier:
+			return (children_.size() == 0);
+		case EidosTokenType::kTokenDot:
+			return ((children_.size() == 2) && children_[0]->_HasNoSideEffects() && (children_[1]->token_->token_type_ == EidosTokenType::kTokenIdentifier));
+		case EidosTokenType::kTokenPlus:
+		case EidosTokenType::kTokenMinus:
+		case EidosTokenType::kTokenMod:
+		case EidosTokenType::kTokenMult:
+		case EidosTokenType::kTokenExp:
+		case EidosTokenType::kTokenAnd:
+		case EidosTokenType::kTokenOr:
+		case EidosTokenType::kTokenDiv:
+		case EidosTokenType::kTokenEq:
+		case EidosTokenType::kTokenLt:
+		case EidosTokenType::kTokenLtEq:
+		case EidosTokenType::kTokenGt:
+		case EidosTokenType::kTokenGtEq:
+		case EidosTokenType::kTokenNot:
+		case EidosTokenType::kTokenNotEq:
+			for (const EidosASTNode *child : children_)
+				if (!child->_HasNoSideEffects())
+					return false;
+			return true;
+		default:
+			return false;
+	}
+}
+
 bool EidosASTNode::HasCachedNumericValue(void) const
 {
 	if ((token_->token_type_ == EidosTokenType::kTokenNumber) && cached_literal_value_ && (cached_literal_value_->Count() == 1))
@@ -23,6 +23,7 @@
 
 #include <stdio.h>
 #include <vector>
+#include <unordered_map>
 
 #include "eidos_token.h"
 #include "eidos_value.h"
@@ -31,6 +32,8 @@
 
 class EidosASTNode;
 class EidosInterpreter;
+class EidosBytecode;
+class EidosFusedExpression;
 
 
 // EidosASTNodes must be allocated out of the global pool, for speed.  See eidos_object_pool.h.  When Eidos disposes of a node,
@@ -41,6 +44,9 @@ extern EidosObjectPool *gEidosASTNodePool;
 // A typedef for a pointer to an EidosInterpreter evaluation method, cached for speed
 typedef EidosValue_SP (EidosInterpreter::*EidosEvaluationMethod)(const EidosASTNode *p_node);
 
+// The type masks inferred for nodes by EidosTypeInterpreter::TypeEvaluateInterpreterBlock_RecordNodeTypes()
+typedef std::unordered_map<const EidosASTNode *, EidosValueMask> EidosNodeTypeTable;
+
 
 // A class representing a node in a parse tree for a script
 class EidosASTNode
@@ -58,6 +64,8 @@ public:
 	mutable EidosFunctionSignature_SP cached_signature_ = nullptr;		// a cached pointer to the function signature corresponding to the token
 	mutable EidosEvaluationMethod cached_evaluator_ = nullptr;			// a pre-cached pointer to method to evaluate this node; shorthand for EvaluateNode()
 	mutable EidosGlobalStringID cached_stringID_ = gEidosID_none;		// a pre-cached identifier for the token string, for fast property/method lookup
+	mutable EidosBytecode *cached_bytecode_ = nullptr;					// OWNED POINTER: optional compiled form of a compound statement; see EidosBytecode::CompileBlock()
+	mutable EidosFusedExpression *cached_fused_expression_ = nullptr;	// OWNED POINTER: optional fused form of an elementwise expression; see EidosFusedExpression::FuseExpression()
 	
 	uint8_t token_is_owned_ = false;									// if T, we own token_ because it is a virtual token that replaced a real token
 	mutable uint8_t cached_for_references_index_ = true;				// pre-cached as true if the index variable is referenced at all in the loop
@@ -96,6 +104,10 @@ public:
 	void _OptimizeFor(void) const;										// determine whether/how for-loop index variables need to be set up
 	void _OptimizeForScan(const std::string &p_for_index_identifier, uint8_t *p_references, uint8_t *p_assigns) const;	// internal method
 	void _OptimizeAssignments(void) const;								// detect and mark simple increment/decrement assignments on a variable
+	void _OptimizeFusedExpressions(void) const;							// fuse elementwise arithmetic expressions, and sum() and mean() of them
+	
+	void OptimizeTypeSpecializations(const EidosNodeTypeTable &p_node_types) const;	// install type-specialized evaluators (optional; see EidosInterpreter::Evaluate_TypeSpecialized())
+	bool _HasNoSideEffects(void) const;									// true for expressions of literals, identifiers, property references, and operators
 	
 	bool HasCachedNumericValue(void) const;
 	double CachedNumericValue(void) const;
@@ -0,0 +1,791 @@
+//
+//  eidos_bytecode.cpp
+//  Eidos
+//
+//  Copyright (c) 2019 Philipp Messer.  All rights reserved.
+//	A product of the Messer Lab, http://messerlab.org/slim/
+//
+
+//	This file is part of Eidos.
+//
+//	Eidos is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+//
+//	Eidos is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with Eidos.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "eidos_bytecode.h"
+#include "eidos_ast_node.h"
+#include "eidos_interpreter.h"
+#include "eidos_script.h"
+#include "eidos_symbol_table.h"
+
+#include <cmath>
+
+
+bool gEidosBytecodeCompilation = true;
+
+
+std::ostream &operator<<(std::ostream &p_outstream, const EidosBytecodeOp p_op)
+{
+	switch (p_op)
+	{
+		case EidosBytecodeOp::kConstant:			p_outstream << "CONSTANT"; break;
+		case EidosBytecodeOp::kLoadSymbol:			p_outstream << "LOAD_SYMBOL"; break;
+		case EidosBytecodeOp::kLoadProperty:		p_outstream << "LOAD_PROPERTY"; break;
+		case EidosBytecodeOp::kUnaryPlus:			p_outstream << "UNARY_PLUS"; break;
+		case EidosBytecodeOp::kNegate:				p_outstream << "NEGATE"; break;
+		case EidosBytecodeOp::kAdd:					p_outstream << "ADD"; break;
+		case EidosBytecodeOp::kSubtract:			p_outstream << "SUBTRACT"; break;
+		case EidosBytecodeOp::kMultiply:			p_outstream << "MULTIPLY"; break;
+		case EidosBytecodeOp::kDivide:				p_outstream << "DIVIDE"; break;
+		case EidosBytecodeOp::kModulo:				p_outstream << "MODULO"; break;
+		case EidosBytecodeOp::kPower:				p_outstream << "POWER"; break;
+		case EidosBytecodeOp::kLt:					p_outstream << "LT"; break;
+		case EidosBytecodeOp::kLtEq:				p_outstream << "LT_EQ"; break;
+		case EidosBytecodeOp::kGt:					p_outstream << "GT"; break;
+		case EidosBytecodeOp::kGtEq:				p_outstream << "GT_EQ"; break;
+		case EidosBytecodeOp::kEq:					p_outstream << "EQ"; break;
+		case EidosBytecodeOp::kNotEq:				p_outstream << "NOT_EQ"; break;
+		case EidosBytecodeOp::kNot:					p_outstream << "NOT"; break;
+		case EidosBytecodeOp::kAnd:					p_outstream << "AND"; break;
+		case EidosBytecodeOp::kOr:					p_outstream << "OR"; break;
+		case EidosBytecodeOp::kBox:					p_outstream << "BOX"; break;
+		case EidosBytecodeOp::kEvaluate:			p_outstream << "EVALUATE"; break;
+		case EidosBytecodeOp::kEvaluateExpression:	p_outstream << "EVALUATE_EXPRESSION"; break;
+		case EidosBytecodeOp::kEvaluateStatement:	p_outstream << "EVALUATE_STATEMENT"; break;
+		case EidosBytecodeOp::kAssign:				p_outstream << "ASSIGN"; break;
+		case EidosBytecodeOp::kJump:				p_outstream << "JUMP"; break;
+		case EidosBytecodeOp::kJumpIfFalse:			p_outstream << "JUMP_IF_FALSE"; break;
+		case EidosBytecodeOp::kReturnBegin:			p_outstream << "RETURN_BEGIN"; break;
+		case EidosBytecodeOp::kReturn:				p_outstream << "RETURN"; break;
+		case EidosBytecodeOp::kReturnVoid:			p_outstream << "RETURN_VOID"; break;
+	}
+	
+	return p_outstream;
+}
+
+
+#pragma mark -
+#pragma mark Compilation
+#pragma mark -
+
+EidosBytecode *EidosBytecode::CompileBlock(const EidosASTNode *p_block_node)
+{
+	if (!gEidosBytecodeCompilation)
+		return nullptr;
+	
+#if defined(SLIMGUI) && (SLIMPROFILING == 1)
+	// Profiling tallies execution time per AST node, so profiled runs always use the AST-walking interpreter
+	return nullptr;
+#endif
+	
+	if (!p_block_node || (p_block_node->token_->token_type_ != EidosTokenType::kTokenLBrace))
+		return nullptr;
+	
+	EidosBytecode *bytecode = new EidosBytecode();
+	bool compiled_any = bytecode->_CompileStatement(p_block_node);
+	
+	if (!compiled_any)
+	{
+		// every statement would just be handed to FastEvaluateNode(), so the bytecode would only add overhead
+		delete bytecode;
+		return nullptr;
+	}
+	
+	bytecode->_Emit(EidosBytecodeOp::kReturnVoid, 0, 0, 0, 0, -1);
+	
+	return bytecode;
+}
+
+int32_t EidosBytecode::_AddNode(const EidosASTNode *p_node)
+{
+	nodes_.emplace_back(p_node);
+	
+	return (int32_t)(nodes_.size() - 1);
+}
+
+int32_t EidosBytecode::_Emit(EidosBytecodeOp p_op, int p_a, int p_b, int p_c, int32_t p_operand, int32_t p_operand2)
+{
+	EidosBytecodeInstruction instruction;
+	
+	instruction.op_ = p_op;
+	instruction.a_ = (uint8_t)p_a;
+	instruction.b_ = (uint8_t)p_b;
+	instruction.c_ = (uint8_t)p_c;
+	instruction.operand_ = p_operand;
+	instruction.operand2_ = p_operand2;
+	
+	instructions_.emplace_back(instruction);
+	
+	return (int32_t)(instructions_.size() - 1);
+}
+
+bool EidosBytecode::_IsPropertyReference(const EidosASTNode *p_node) const
+{
+	// Property references, like x.y or x.y.z, are evaluated with FastEvaluateNode() and then unboxed; property access has no side
+	// effects, unlike method calls, so they can be re-evaluated if a scalar instruction bails out
+	if ((p_node->token_->token_type_ != EidosTokenType::kTokenDot) || (p_node->children_.size() != 2))
+		return false;
+	
+	const EidosASTNode *object_node = p_node->children_[0];
+	const EidosASTNode *property_node = p_node->children_[1];
+	
+	if ((property_node->token_->token_type_ != EidosTokenType::kTokenIdentifier) || (property_node->children_.size() != 0))
+		return false;
+	
+	if ((object_node->token_->token_type_ == EidosTokenType::kTokenIdentifier) && (object_node->children_.size() == 0) && !object_node->cached_literal_value_)
+		return true;
+	
+	return _IsPropertyReference(object_node);
+}
+
+bool EidosBytecode::_IsScalarExpression(const EidosASTNode *p_node, int p_register, int *p_max_register) const
+{
+	// Determine whether p_node can be compiled to scalar instructions with its result in register p_register; the
+	// children of an operator use the registers above their parent's, and *p_max_register tracks the highest used
+	if (p_register >= EIDOS_BYTECODE_MAX_REGISTERS)
+		return false;
+	
+	if (p_register > *p_max_register)
+		*p_max_register = p_register;
+	
+	const std::vector<EidosASTNode *> &children = p_node->children_;
+	size_t child_count = children.size();
+	
+	switch (p_node->token_->token_type_)
+	{
+		case EidosTokenType::kTokenNumber:
+		case EidosTokenType::kTokenIdentifier:
+		{
+			if (child_count != 0)
+				return false;
+			
+			// an identifier without a cached value is a variable, loaded with kLoadSymbol; constants must be scalars
+			if (!p_node->cached_literal_value_)
+				return (p_node->token_->token_type_ == EidosTokenType::kTokenIdentifier);
+			
+			EidosValue *literal = p_node->cached_literal_value_.get();
+			EidosValueType literal_type = literal->Type();
+			
+			return (((literal_type == EidosValueType::kValueLogical) || (literal_type == EidosValueType::kValueInt) || (literal_type == EidosValueType::kValueFloat)) && (literal->Count() == 1) && (literal->DimensionCount() == 1));
+		}
+		case EidosTokenType::kTokenDot:
+			return _IsPropertyReference(p_node);
+		case EidosTokenType::kTokenPlus:
+		case EidosTokenType::kTokenMinus:
+			if ((child_count != 1) && (child_count != 2))
+				return false;
+			break;
+		case EidosTokenType::kTokenMult:
+		case EidosTokenType::kTokenDiv:
+		case EidosTokenType::kTokenMod:
+		case EidosTokenType::kTokenExp:
+		case EidosTokenType::kTokenLt:
+		case EidosTokenType::kTokenLtEq:
+		case EidosTokenType::kTokenGt:
+		case EidosTokenType::kTokenGtEq:
+		case EidosTokenType::kTokenEq:
+		case EidosTokenType::kTokenNotEq:
+			if (child_count != 2)
+				return false;
+			break;
+		case EidosTokenType::kTokenNot:
+			if (child_count != 1)
+				return false;
+			break;
+		case EidosTokenType::kTokenAnd:
+		case EidosTokenType::kTokenOr:
+			if (child_count < 2)
+				return false;
+			break;
+		default:
+			return false;
+	}
+	
+	// operands go in p_register and p_register + 1; & and | fold each further operand in through p_register + 1
+	for (size_t child_index = 0; child_index < child_count; ++child_index)
+		if (!_IsScalarExpression(children[child_index], p_register + (child_index == 0 ? 0 : 1), p_max_register))
+			return false;
+	
+	return true;
+}
+
+void EidosBytecode::_CompileScalarExpression(const EidosASTNode *p_node, int p_register, int32_t p_expression)
+{
+	const std::vector<EidosASTNode *> &children = p_node->children_;
+	size_t child_count = children.size();
+	EidosTokenType token_type = p_node->token_->token_type_;
+	
+	if ((token_type == EidosTokenType::kTokenNumber) || (token_type == EidosTokenType::kTokenIdentifier))
+	{
+		if (p_node->cached_literal_value_)
+		{
+			EidosValue *literal = p_node->cached_literal_value_.get();
+			EidosBytecodeScalar constant;
+			
+			constant.type_ = literal->Type();
+			
+			if (constant.type_ == EidosValueType::kValueLogical)
+				constant.logical_ = literal->LogicalAtIndex(0, nullptr);
+			else if (constant.type_ == EidosValueType::kValueInt)
+				constant.int_ = literal->IntAtIndex(0, nullptr);
+			else
+				constant.float_ = literal->FloatAtIndex(0, nullptr);
+			
+			constants_.emplace_back(constant);
+			_Emit(EidosBytecodeOp::kConstant, p_register, 0, 0, (int32_t)(constants_.size() - 1), p_expression);
+		}
+		else
+		{
+			_Emit(EidosBytecodeOp::kLoadSymbol, p_register, 0, 0, _AddNode(p_node), p_expression);
+		}
+		return;
+	}
+	
+	if (token_type == EidosTokenType::kTokenDot)
+	{
+		_Emit(EidosBytecodeOp::kLoadProperty, p_register, 0, 0, _AddNode(p_node), p_expression);
+		return;
+	}
+	
+	if (child_count == 1)
+	{
+		EidosBytecodeOp op;
+		
+		if (token_type == EidosTokenType::kTokenPlus)		op = EidosBytecodeOp::kUnaryPlus;
+		else if (token_type == EidosTokenType::kTokenMinus)	op = EidosBytecodeOp::kNegate;
+		else												op = EidosBytecodeOp::kNot;
+		
+		_CompileScalarExpression(children[0], p_register, p_expression);
+		_Emit(op, p_register, p_register, 0, 0, p_expression);
+		return;
+	}
+	
+	EidosBytecodeOp op;
+	
+	switch (token_type)
+	{
+		case EidosTokenType::kTokenPlus:	op = EidosBytecodeOp::kAdd; break;
+		case EidosTokenType::kTokenMinus:	op = EidosBytecodeOp::kSubtract; break;
+		case EidosTokenType::kTokenMult:	op = EidosBytecodeOp::kMultiply; break;
+		case EidosTokenType::kTokenDiv:		op = EidosBytecodeOp::kDivide; break;
+		case EidosTokenType::kTokenMod:		op = EidosBytecodeOp::kModulo; break;
+		case EidosTokenType::kTokenExp:		op = EidosBytecodeOp::kPower; break;
+		case EidosTokenType::kTokenLt:		op = EidosBytecodeOp::kLt; break;
+		case EidosTokenType::kTokenLtEq:	op = EidosBytecodeOp::kLtEq; break;
+		case EidosTokenType::kTokenGt:		op = EidosBytecodeOp::kGt; break;
+		case EidosTokenType::kTokenGtEq:	op = EidosBytecodeOp::kGtEq; break;
+		case EidosTokenType::kTokenEq:		op = EidosBytecodeOp::kEq; break;
+		case EidosTokenType::kTokenNotEq:	op = EidosBytecodeOp::kNotEq; break;
+		case EidosTokenType::kTokenAnd:		op = EidosBytecodeOp::kAnd; break;
+		default:							op = EidosBytecodeOp::kOr; break;
+	}
+	
+	// & and | are n-ary in the AST; they evaluate all of their operands, so folding left to right is equivalent
+	_CompileScalarExpression(children[0], p_register, p_expression);
+	
+	for (size_t child_index = 1; child_index < child_count; ++child_index)
+	{
+		_CompileScalarExpression(children[child_index], p_register + 1, p_expression);
+		_Emit(op, p_register, p_register, p_register + 1, 0, p_expression);
+	}
+}
+
+bool EidosBytecode::_CompileExpression(const EidosASTNode *p_node)
+{
+	// Compile an expression whose value is left in the interpreter's value register; returns true if it was compiled to
+	// scalar instructions.  Bare literals and identifiers gain nothing from compilation, so only operators are compiled.
+	int max_register = 0;
+	
+	if ((p_node->children_.size() > 0) && _IsScalarExpression(p_node, 0, &max_register))
+	{
+		int32_t expression_index = (int32_t)expressions_.size();
+		
+		expressions_.emplace_back(EidosBytecodeExpression{_AddNode(p_node), (int32_t)instructions_.size(), -1});
+		
+		_CompileScalarExpression(p_node, 0, expression_index);
+		_Emit(EidosBytecodeOp::kBox, 0, 0, 0, 0, expression_index);
+		
+		expressions_[expression_index].resume_ = (int32_t)instructions_.size();
+		register_count_ = std::max(register_count_, max_register + 1);
+		return true;
+	}
+	
+	_Emit(EidosBytecodeOp::kEvaluate, 0, 0, 0, _AddNode(p_node), -1);
+	return false;
+}
+
+bool EidosBytecode::_CompileStatement(const EidosASTNode *p_node)
+{
+	// Compile a statement; returns true if any expression within it was compiled to scalar instructions
+	const std::vector<EidosASTNode *> &children = p_node->children_;
+	
+	switch (p_node->token_->token_type_)
+	{
+		case EidosTokenType::kTokenLBrace:
+		{
+			bool compiled_any = false;
+			
+			for (const EidosASTNode *child : children)
+				compiled_any = _CompileStatement(child) || compiled_any;
+			
+			return compiled_any;
+		}
+		case EidosTokenType::kTokenSemicolon:
+			return false;
+		case EidosTokenType::kTokenIf:
+		{
+			bool compiled_any = _CompileExpression(children[0]);
+			int32_t jump_if_false = _Emit(EidosBytecodeOp::kJumpIfFalse, 0, 0, 0, -1, _AddNode(p_node));
+			
+			compiled_any = _CompileStatement(children[1]) || compiled_any;
+			
+			if (children.size() == 3)
+			{
+				int32_t jump_past_else = _Emit(EidosBytecodeOp::kJump, 0, 0, 0, -1, -1);
+				
+				instructions_[jump_if_false].operand_ = (int32_t)instructions_.size();
+				compiled_any = _CompileStatement(children[2]) || compiled_any;
+				instructions_[jump_past_else].operand_ = (int32_t)instructions_.size();
+			}
+			else
+			{
+				instructions_[jump_if_false].operand_ = (int32_t)instructions_.size();
+			}
+			
+			return compiled_any;
+		}
+		case EidosTokenType::kTokenReturn:
+		{
+			if (children.size() == 0)
+			{
+				_Emit(EidosBytecodeOp::kReturnBegin, 0, 0, 0, _AddNode(p_node), -1);
+				_Emit(EidosBytecodeOp::kReturnVoid, 0, 0, 0, 0, -1);
+				return false;
+			}
+			
+			_Emit(EidosBytecodeOp::kReturnBegin, 0, 0, 0, _AddNode(p_node), -1);
+			bool compiled_any = _CompileExpression(children[0]);
+			_Emit(EidosBytecodeOp::kReturn, 0, 0, 0, 0, -1);
+			
+			return compiled_any;
+		}
+		case EidosTokenType::kTokenAssign:
+		{
+			// only plain assignment to an identifier, with a compilable right-hand side, is compiled; x=x+1 and x=x-1 have
+			// their own fast path in Evaluate_Assign(), and subset and member assignments are left to _AssignRValueToLValue()
+			const EidosASTNode *lvalue_node = children[0];
+			const EidosASTNode *rvalue_node = children[1];
+			int max_register = 0;
+			
+			if ((lvalue_node->token_->token_type_ == EidosTokenType::kTokenIdentifier) && !p_node->cached_compound_assignment_ &&
+				(rvalue_node->children_.size() > 0) && _IsScalarExpression(rvalue_node, 0, &max_register))
+			{
+				_CompileExpression(rvalue_node);
+				_Emit(EidosBytecodeOp::kAssign, 0, 0, 0, _AddNode(p_node), -1);
+				return true;
+			}
+			break;
+		}
+		default:
+			break;
+	}
+	
+	_Emit(EidosBytecodeOp::kEvaluateStatement, 0, 0, 0, _AddNode(p_node), -1);
+	return false;
+}
+
+void EidosBytecode::Print(std::ostream &p_outstream) const
+{
+	for (size_t constant_index = 0; constant_index < constants_.size(); ++constant_index)
+	{
+		const EidosBytecodeScalar &constant = constants_[constant_index];
+		
+		p_outstream << "k" << constant_index << " = ";
+		
+		if (constant.type_ == EidosValueType::kValueLogical)	p_outstream << (constant.logical_ ? gEidosStr_T : gEidosStr_F);
+		else if (constant.type_ == EidosValueType::kValueInt)	p_outstream << constant.int_;
+		else													p_outstream << constant.float_;
+		
+		p_outstream << std::endl;
+	}
+	
+	for (size_t instruction_index = 0; instruction_index < instructions_.size(); ++instruction_index)
+	{
+		const EidosBytecodeInstruction &instruction = instructions_[instruction_index];
+		
+		p_outstream << instruction_index << ": " << instruction.op_;
+		
+		switch (instruction.op_)
+		{
+			case EidosBytecodeOp::kConstant:
+				p_outstream << " r" << (int)instruction.a_ << ", k" << instruction.operand_;
+				break;
+			case EidosBytecodeOp::kLoadSymbol:
+				p_outstream << " r" << (int)instruction.a_ << ", " << nodes_[instruction.operand_]->token_->token_string_;
+				break;
+			case EidosBytecodeOp::kLoadProperty:
+				p_outstream << " r" << (int)instruction.a_ << ", ." << nodes_[instruction.operand_]->children_[1]->token_->token_string_;
+				break;
+			case EidosBytecodeOp::kUnaryPlus:
+			case EidosBytecodeOp::kNegate:
+			case EidosBytecodeOp::kNot:
+				p_outstream << " r" << (int)instruction.a_ << ", r" << (int)instruction.b_;
+				break;
+			case EidosBytecodeOp::kBox:
+				p_outstream << " r" << (int)instruction.a_;
+				break;
+			case EidosBytecodeOp::kEvaluate:
+			case EidosBytecodeOp::kEvaluateStatement:
+			case EidosBytecodeOp::kAssign:
+			case EidosBytecodeOp::kReturnBegin:
+				p_outstream << " " << nodes_[instruction.operand_]->token_->token_string_;
+				break;
+			case EidosBytecodeOp::kEvaluateExpression:
+				p_outstream << " " << nodes_[expressions_[instruction.operand2_].node_]->token_->token_string_ << ", " << expressions_[instruction.operand2_].resume_;
+				break;
+			case EidosBytecodeOp::kJump:
+			case EidosBytecodeOp::kJumpIfFalse:
+				p_outstream << " " << instruction.operand_;
+				break;
+			case EidosBytecodeOp::kReturn:
+			case EidosBytecodeOp::kReturnVoid:
+				break;
+			default:
+				p_outstream << " r" << (int)instruction.a_ << ", r" << (int)instruction.b_ << ", r" << (int)instruction.c_;
+				break;
+		}
+		
+		p_outstream << std::endl;
+	}
+}
+
+
+#pragma mark -
+#pragma mark Execution
+#pragma mark -
+
+// Compare two scalars in the manner of the Compare*() functions used by the comparison operators: as floats if either is a
+// float, otherwise as integers (with T and F as 1 and 0); the result is -1, 0, or 1
+static inline __attribute__((always_inline)) int _EidosBytecodeCompare(const EidosBytecodeScalar &p_x, const EidosBytecodeScalar &p_y)
+{
+	if ((p_x.type_ == EidosValueType::kValueFloat) || (p_y.type_ == EidosValueType::kValueFloat))
+	{
+		double x = (p_x.type_ == EidosValueType::kValueFloat) ? p_x.float_ : ((p_x.type_ == EidosValueType::kValueInt) ? (double)p_x.int_ : (double)p_x.logical_);
+		double y = (p_y.type_ == EidosValueType::kValueFloat) ? p_y.float_ : ((p_y.type_ == EidosValueType::kValueInt) ? (double)p_y.int_ : (double)p_y.logical_);
+		
+		return (x < y) ? -1 : ((x > y) ? 1 : 0);
+	}
+	else
+	{
+		int64_t x = (p_x.type_ == EidosValueType::kValueInt) ? p_x.int_ : (int64_t)p_x.logical_;
+		int64_t y = (p_y.type_ == EidosValueType::kValueInt) ? p_y.int_ : (int64_t)p_y.logical_;
+		
+		return (x < y) ? -1 : ((x > y) ? 1 : 0);
+	}
+}
+
+EidosValue_SP EidosInterpreter::ExecuteBytecode(EidosBytecode &p_bytecode)
+{
+	// Execute a block compiled by EidosBytecode::CompileBlock(), producing the same result as FastEvaluateNode() on the block
+	// node would; see eidos_bytecode.h.  Scalar instructions bail out to the AST evaluators whenever their operands do not fit.
+	// The bytecode is not const because an expression that bails is rewritten so that it does not repeat its scalar work.
+	EidosBytecodeScalar registers[EIDOS_BYTECODE_MAX_REGISTERS];
+	EidosBytecodeInstruction *instructions = p_bytecode.instructions_.data();
+	const EidosBytecodeScalar *constants = p_bytecode.constants_.data();
+	const EidosASTNode * const *nodes = p_bytecode.nodes_.data();
+	int32_t pc = 0;
+	EidosValue_SP value;
+	
+	while (true)
+	{
+		const EidosBytecodeInstruction &instruction = instructions[pc++];
+		
+		switch (instruction.op_)
+		{
+			case EidosBytecodeOp::kConstant:
+				registers[instruction.a_] = constants[instruction.operand_];
+				continue;
+			
+			case EidosBytecodeOp::kLoadSymbol:
+			case EidosBytecodeOp::kLoadProperty:
+			{
+				// this raises for an undefined identifier just as Evaluate_Identifier() does
+				EidosValue_SP symbol_value_SP = ((instruction.op_ == EidosBytecodeOp::kLoadSymbol) ? global_symbols_->GetValueOrRaiseForASTNode(nodes[instruction.operand_]) : FastEvaluateNode(nodes[instruction.operand_]));
+				EidosValue *symbol_value = symbol_value_SP.get();
+				EidosBytecodeScalar &r = registers[instruction.a_];
+				
+				if ((symbol_value->Count() != 1) || (symbol_value->DimensionCount() != 1))
+					goto bail;
+				
+				switch (symbol_value->Type())
+				{
+					case EidosValueType::kValueLogical:	r.type_ = EidosValueType::kValueLogical; r.logical_ = symbol_value->LogicalAtIndex(0, nullptr); break;
+					case EidosValueType::kValueInt:		r.type_ = EidosValueType::kValueInt; r.int_ = symbol_value->IntAtIndex(0, nullptr); break;
+					case EidosValueType::kValueFloat:	r.type_ = EidosValueType::kValueFloat; r.float_ = symbol_value->FloatAtIndex(0, nullptr); break;
+					default: goto bail;
+				}
+				continue;
+			}
+			
+			case EidosBytecodeOp::kUnaryPlus:
+			{
+				EidosBytecodeScalar &x = registers[instruction.b_];
+				
+				if (x.type_ == EidosValueType::kValueLogical)
+					goto bail;
+				
+				registers[instruction.a_] = x;
+				continue;
+			}
+			
+			case EidosBytecodeOp::kNegate:
+			{
+				EidosBytecodeScalar &x = registers[instruction.b_];
+				EidosBytecodeScalar &r = registers[instruction.a_];
+				
+				if (x.type_ == EidosValueType::kValueInt)
+				{
+					int64_t result;
+					
+					if (Eidos_sub_overflow((int64_t)0, x.int_, &result))
+						goto bail;
+					
+					r.type_ = EidosValueType::kValueInt;
+					r.int_ = result;
+				}
+				else if (x.type_ == EidosValueType::kValueFloat)
+				{
+					r.type_ = EidosValueType::kValueFloat;
+					r.float_ = -x.float_;
+				}
+				else
+					goto bail;
+				continue;
+			}
+			
+			case EidosBytecodeOp::kAdd:
+			case EidosBytecodeOp::kSubtract:
+			case EidosBytecodeOp::kMultiply:
+			{
+				EidosBytecodeScalar &x = registers[instruction.b_];
+				EidosBytecodeScalar &y = registers[instruction.c_];
+				EidosBytecodeScalar &r = registers[instruction.a_];
+				
+				if ((x.type_ == EidosValueType::kValueLogical) || (y.type_ == EidosValueType::kValueLogical))
+					goto bail;
+				
+				if ((x.type_ == EidosValueType::kValueInt) && (y.type_ == EidosValueType::kValueInt))
+				{
+					int64_t result;
+					bool overflow;
+					
+					if (instruction.op_ == EidosBytecodeOp::kAdd)			overflow = Eidos_add_overflow(x.int_, y.int_, &result);
+					else if (instruction.op_ == EidosBytecodeOp::kSubtract)	overflow = Eidos_sub_overflow(x.int_, y.int_, &result);
+					else													overflow = Eidos_mul_overflow(x.int_, y.int_, &result);
+					
+					if (overflow)
+						goto bail;
+					
+					r.type_ = EidosValueType::kValueInt;
+					r.int_ = result;
+				}
+				else
+				{
+					double xf = (x.type_ == EidosValueType::kValueFloat) ? x.float_ : (double)x.int_;
+					double yf = (y.type_ == EidosValueType::kValueFloat) ? y.float_ : (double)y.int_;
+					
+					r.type_ = EidosValueType::kValueFloat;
+					
+					if (instruction.op_ == EidosBytecodeOp::kAdd)			r.float_ = xf + yf;
+					else if (instruction.op_ == EidosBytecodeOp::kSubtract)	r.float_ = xf - yf;
+					else													r.float_ = xf * yf;
+				}
+				continue;
+			}
+			
+			case EidosBytecodeOp::kDivide:
+			case EidosBytecodeOp::kModulo:
+			case EidosBytecodeOp::kPower:
+			{
+				// these always produce float, as in Evaluate_Div(), Evaluate_Mod(), and Evaluate_Exp()
+				EidosBytecodeScalar &x = registers[instruction.b_];
+				EidosBytecodeScalar &y = registers[instruction.c_];
+				EidosBytecodeScalar &r = registers[instruction.a_];
+				
+				if ((x.type_ == EidosValueType::kValueLogical) || (y.type_ == EidosValueType::kValueLogical))
+					goto bail;
+				
+				double xf = (x.type_ == EidosValueType::kValueFloat) ? x.float_ : (double)x.int_;
+				double yf = (y.type_ == EidosValueType::kValueFloat) ? y.float_ : (double)y.int_;
+				
+				r.type_ = EidosValueType::kValueFloat;
+				
+				if (instruction.op_ == EidosBytecodeOp::kDivide)		r.float_ = xf / yf;
+				else if (instruction.op_ == EidosBytecodeOp::kModulo)	r.float_ = fmod(xf, yf);
+				else													r.float_ = pow(xf, yf);
+				continue;
+			}
+			
+			case EidosBytecodeOp::kLt:
+			case EidosBytecodeOp::kLtEq:
+			case EidosBytecodeOp::kGt:
+			case EidosBytecodeOp::kGtEq:
+			case EidosBytecodeOp::kEq:
+			case EidosBytecodeOp::kNotEq:
+			{
+				int compare_result = _EidosBytecodeCompare(registers[instruction.b_], registers[instruction.c_]);
+				EidosBytecodeScalar &r = registers[instruction.a_];
+				
+				r.type_ = EidosValueType::kValueLogical;
+				
+				switch (instruction.op_)
+				{
+					case EidosBytecodeOp::kLt:		r.logical_ = (compare_result == -1); break;
+					case EidosBytecodeOp::kLtEq:	r.logical_ = (compare_result != 1); break;
+					case EidosBytecodeOp::kGt:		r.logical_ = (compare_result == 1); break;
+					case EidosBytecodeOp::kGtEq:	r.logical_ = (compare_result != -1); break;
+					case EidosBytecodeOp::kEq:		r.logical_ = (compare_result == 0); break;
+					default:						r.logical_ = (compare_result != 0); break;
+				}
+				continue;
+			}
+			
+			case EidosBytecodeOp::kNot:
+			{
+				// float operands are left to Evaluate_Not(), which handles NAN
+				EidosBytecodeScalar &x = registers[instruction.b_];
+				EidosBytecodeScalar &r = registers[instruction.a_];
+				
+				if (x.type_ == EidosValueType::kValueLogical)
+					r.logical_ = !x.logical_;
+				else if (x.type_ == EidosValueType::kValueInt)
+					r.logical_ = (x.int_ == 0);
+				else
+					goto bail;
+				
+				r.type_ = EidosValueType::kValueLogical;
+				continue;
+			}
+			
+			case EidosBytecodeOp::kAnd:
+			case EidosBytecodeOp::kOr:
+			{
+				EidosBytecodeScalar &x = registers[instruction.b_];
+				EidosBytecodeScalar &y = registers[instruction.c_];
+				EidosBytecodeScalar &r = registers[instruction.a_];
+				
+				if ((x.type_ != EidosValueType::kValueLogical) || (y.type_ != EidosValueType::kValueLogical))
+					goto bail;
+				
+				r.type_ = EidosValueType::kValueLogical;
+				r.logical_ = (instruction.op_ == EidosBytecodeOp::kAnd) ? (x.logical_ && y.logical_) : (x.logical_ || y.logical_);
+				continue;
+			}
+			
+			case EidosBytecodeOp::kBox:
+			{
+				EidosBytecodeScalar &x = registers[instruction.a_];
+				
+				if (x.type_ == EidosValueType::kValueLogical)
+					value = (x.logical_ ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
+				else if (x.type_ == EidosValueType::kValueInt)
+					value = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int_singleton(x.int_));
+				else
+					value = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(x.float_));
+				continue;
+			}
+			
+			case EidosBytecodeOp::kEvaluate:
+				value = FastEvaluateNode(nodes[instruction.operand_]);
+				continue;
+			
+			case EidosBytecodeOp::kEvaluateExpression:
+			{
+				const EidosBytecodeExpression &expression = p_bytecode.expressions_[instruction.operand2_];
+				
+				value = FastEvaluateNode(nodes[expression.node_]);
+				pc = expression.resume_;
+				continue;
+			}
+			
+			case EidosBytecodeOp::kEvaluateStatement:
+				// as in Evaluate_CompoundStatement(), leave the block after next, break, or return
+				value = FastEvaluateNode(nodes[instruction.operand_]);
+				
+				if (return_statement_hit_)
+					return value;
+				if (next_statement_hit_ || break_statement_hit_)
+					return gStaticEidosValueVOID;
+				continue;
+			
+			case EidosBytecodeOp::kAssign:
+			{
+				// as in Evaluate_Assign(), the assignment is blamed on the assignment operator if it raises
+				const EidosASTNode *assign_node = nodes[instruction.operand_];
+				EidosErrorPosition error_pos_save = EidosScript::PushErrorPositionFromToken(assign_node->token_);
+				
+				global_symbols_->SetValueForSymbol(assign_node->children_[0]->cached_stringID_, std::move(value));
+				
+				EidosScript::RestoreErrorPosition(error_pos_save);
+				continue;
+			}
+			
+			case EidosBytecodeOp::kJump:
+				pc = instruction.operand_;
+				continue;
+			
+			case EidosBytecodeOp::kJumpIfFalse:
+			{
+				// this follows Evaluate_If() exactly
+				const EidosASTNode *if_node = nodes[instruction.operand2_];
+				EidosValue *condition_result = value.get();
+				
+				if (condition_result == gStaticEidosValue_LogicalT.get())
+					continue;
+				if (condition_result == gStaticEidosValue_LogicalF.get())
+				{
+					pc = instruction.operand_;
+					continue;
+				}
+				if (condition_result->Count() != 1)
+					EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_If): condition for if statement has size() != 1." << EidosTerminate(if_node->token_);
+				
+				if (!condition_result->LogicalAtIndex(0, if_node->token_))
+					pc = instruction.operand_;
+				continue;
+			}
+			
+			case EidosBytecodeOp::kReturnBegin:
+				// as in Evaluate_Return(), the return is flagged, and blamed for errors, before its value is computed
+				return_statement_hit_ = true;
+				EidosScript::PushErrorPositionFromToken(nodes[instruction.operand_]->token_);
+				continue;
+			
+			case EidosBytecodeOp::kReturn:
+				return value;
+			
+			case EidosBytecodeOp::kReturnVoid:
+				return gStaticEidosValueVOID;
+		}
+	
+	bail:
+		{
+			// A scalar instruction could not handle its operands, so re-evaluate its whole expression with the AST evaluators,
+			// which will produce the correct result (or raise); the expression has no side effects, so this is safe.  The
+			// expression's first instruction is replaced so that later executions skip straight to the AST evaluators.
+			const EidosBytecodeExpression &expression = p_bytecode.expressions_[instruction.operand2_];
+			EidosBytecodeInstruction &start_instruction = instructions[expression.start_];
+			
+			start_instruction.op_ = EidosBytecodeOp::kEvaluateExpression;
+			start_instruction.operand2_ = instruction.operand2_;
+			
+			value = FastEvaluateNode(nodes[expression.node_]);
+			pc = expression.resume_;
+		}
+	}
+}
@@ -0,0 +1,166 @@
+//
+//  eidos_bytecode.h
+//  Eidos
+//
+//  Copyright (c) 2019 Philipp Messer.  All rights reserved.
+//	A product of the Messer Lab, http://messerlab.org/slim/
+//
+
+//	This file is part of Eidos.
+//
+//	Eidos is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+//
+//	Eidos is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with Eidos.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+
+ EidosBytecode is an optional compiled form of a script block, executed by EidosInterpreter::ExecuteBytecode().  It is meant
+ for blocks that run very many times, such as SLiM's callbacks; the AST-walking evaluators in eidos_interpreter.cpp remain the
+ reference implementation, and anything the compiler does not handle is simply handed back to them.
+
+ The compiler lowers the control flow of the block (compound statements, if/else, return, and assignment to a simple identifier)
+ into a flat instruction stream, and lowers arithmetic, comparison, and logical expressions over literals and variables into
+ instructions on a register file of unboxed scalars (logical, integer, or float), with literals drawn from a constant pool; property
+ references such as mut.selectionCoeff are evaluated by the AST evaluators and unboxed into a register.  No
+ EidosValue is allocated for intermediate results; an expression's result is boxed only when it leaves the register file.
+
+ Those scalar instructions are speculative: they handle only singleton, non-array operands of the types they expect.  When an
+ operand does not fit (a vector, a matrix, a string, an integer overflow, etc.), the instruction bails out and the whole expression
+ is re-evaluated by the AST evaluators, which produce the correct result or raise the correct error.  Since the compiled expressions
+ contain only variable lookups, property references, and operators, they have no side effects, so evaluating them a second time is safe.
+ An expression that has bailed once is likely to bail again (a variable that held a vector usually will again), so on its first bail
+ its first instruction is replaced by kEvaluateExpression, and from then on it goes straight to the AST evaluators.  All other
+ statements and expressions (calls, subsets, loops, etc.) are evaluated with EidosInterpreter::FastEvaluateNode(), so variable lookup
+ and assignment always go through the interpreter's EidosSymbolTable, and the semantics of the block are unchanged.
+
+ */
+
+#ifndef __Eidos__eidos_bytecode__
+#define __Eidos__eidos_bytecode__
+
+#include <vector>
+#include <iostream>
+
+#include "eidos_value.h"
+
+
+class EidosASTNode;
+
+
+// Set to false to keep clients from compiling blocks to bytecode, so that all execution uses the AST-walking interpreter; this
+// is useful for debugging, and for checking that the two produce the same results.  SLiM's -noCompile option clears this flag.
+extern bool gEidosBytecodeCompilation;
+
+// The maximum number of registers a compiled expression may use; expressions that are nested more deeply than this are left
+// uncompiled.  The register file lives on the stack during execution, so this should be kept modest.
+#define EIDOS_BYTECODE_MAX_REGISTERS	32
+
+
+// The instruction set; a, b, and c are register indices, and operand is an index into the constant pool, the node table, or the
+// instruction stream, depending upon the instruction.  Scalar instructions also keep, in operand2, the index in expressions_ of
+// the compiled expression that contains them, so that they know what to re-evaluate if they bail out.
+enum class EidosBytecodeOp : uint8_t {
+	// scalar instructions; these can bail out to the AST evaluator, as described above
+	kConstant = 0,			// r[a] = constants_[operand]
+	kLoadSymbol,			// r[a] = the value of the identifier nodes_[operand], which must be a singleton logical, integer, or float
+	kLoadProperty,			// r[a] = the value of the property reference nodes_[operand], which must be a singleton logical, integer, or float
+	kUnaryPlus,				// r[a] = +r[b]
+	kNegate,				// r[a] = -r[b]
+	kAdd,					// r[a] = r[b] + r[c]
+	kSubtract,				// r[a] = r[b] - r[c]
+	kMultiply,				// r[a] = r[b] * r[c]
+	kDivide,				// r[a] = r[b] / r[c]
+	kModulo,				// r[a] = r[b] % r[c]
+	kPower,					// r[a] = r[b] ^ r[c]
+	kLt,					// r[a] = r[b] < r[c]
+	kLtEq,					// r[a] = r[b] <= r[c]
+	kGt,					// r[a] = r[b] > r[c]
+	kGtEq,					// r[a] = r[b] >= r[c]
+	kEq,					// r[a] = r[b] == r[c]
+	kNotEq,					// r[a] = r[b] != r[c]
+	kNot,					// r[a] = !r[b]
+	kAnd,					// r[a] = r[b] & r[c]
+	kOr,					// r[a] = r[b] | r[c]
+	kBox,					// value = an EidosValue for r[a]; this ends a compiled expression
+	
+	// instructions on boxed values and control flow
+	kEvaluate,				// value = FastEvaluateNode(nodes_[operand])
+	kEvaluateExpression,	// value = FastEvaluateNode() of the compiled expression expressions_[operand2], which has bailed out before
+	kEvaluateStatement,		// value = FastEvaluateNode(nodes_[operand]), then leave the block if next, break, or return was hit
+	kAssign,				// assign value to the identifier that is the lvalue of the assignment nodes_[operand]
+	kJump,					// continue at instruction operand
+	kJumpIfFalse,			// test value as the condition of the if statement nodes_[operand2]; if it is false, continue at instruction operand
+	kReturnBegin,			// enter the return statement nodes_[operand]; its value is computed next
+	kReturn,				// leave the block, returning value
+	kReturnVoid,			// leave the block, returning void
+};
+
+std::ostream &operator<<(std::ostream &p_outstream, const EidosBytecodeOp p_op);
+
+
+// A register value, or a constant in the constant pool; type_ is kValueLogical, kValueInt, or kValueFloat
+typedef struct {
+	EidosValueType type_;
+	union {
+		eidos_logical_t logical_;
+		int64_t int_;
+		double float_;
+	};
+} EidosBytecodeScalar;
+
+typedef struct {
+	EidosBytecodeOp op_;
+	uint8_t a_, b_, c_;
+	int32_t operand_;
+	int32_t operand2_;
+} EidosBytecodeInstruction;
+
+// A compiled expression: the node to re-evaluate with the AST evaluator if the compiled code bails out, the index of its first
+// instruction (replaced by kEvaluateExpression when it bails), and the instruction index (just past the expression's kBox) at
+// which execution resumes after that re-evaluation
+typedef struct {
+	int32_t node_;
+	int32_t start_;
+	int32_t resume_;
+} EidosBytecodeExpression;
+
+
+class EidosBytecode
+{
+	//	This class has its copy constructor and assignment operator disabled, to prevent accidental copying.
+
+public:
+	std::vector<EidosBytecodeInstruction> instructions_;
+	std::vector<EidosBytecodeScalar> constants_;				// the constant pool
+	std::vector<const EidosASTNode *> nodes_;					// AST nodes referenced by instructions; not owned
+	std::vector<EidosBytecodeExpression> expressions_;
+	int register_count_ = 0;
+	
+	EidosBytecode(const EidosBytecode&) = delete;					// no copying
+	EidosBytecode& operator=(const EidosBytecode&) = delete;		// no copying
+	EidosBytecode(void) = default;
+	
+	// Compiles the compound statement p_block_node, which must already have been optimized with EidosASTNode::OptimizeTree().
+	// Returns nullptr if compilation would not help (no expression in the block could be compiled), or if compilation has been
+	// disabled with gEidosBytecodeCompilation.  The returned bytecode refers to the nodes of the tree, so it must not outlive it.
+	static EidosBytecode *CompileBlock(const EidosASTNode *p_block_node);
+	
+	void Print(std::ostream &p_outstream) const;		// a disassembly, for debugging
+
+private:
+	int32_t _AddNode(const EidosASTNode *p_node);
+	int32_t _Emit(EidosBytecodeOp p_op, int p_a, int p_b, int p_c, int32_t p_operand, int32_t p_operand2);
+	
+	bool _IsPropertyReference(const EidosASTNode *p_node) const;
+	bool _IsScalarExpression(const EidosASTNode *p_node, int p_register, int *p_max_register) const;
+	void _CompileScalarExpression(const EidosASTNode *p_node, int p_register, int32_t p_expression);
+	bool _CompileExpression(const EidosASTNode *p_node);
+	bool _CompileStatement(const EidosASTNode *p_node);
+};
+
+
+#endif /* defined(__Eidos__eidos_bytecode__) */
@@ -24,6 +24,8 @@
 #include "eidos_interpreter.h"
 #include "eidos_rng.h"
 #include "eidos_beep.h"
+#include "eidos_vector_kernels.h"
+#include "eidos_parallel.h"
 
 #include <ctime>
 #include <stdio.h>
@@ -644,6 +646,10 @@ EidosValue_SP ConcatenateEidosValues(const EidosValue_SP *const p_arguments, int
 	return EidosValue_SP(nullptr);
 }
 
+// Preserving the order of first occurrence, unique() scans back over the elements before each element for vectors of at most this
+// many elements; longer vectors are uniqued with a hash table (and in parallel, for very long vectors; see eidos_parallel.h)
+#define EIDOS_UNIQUE_SCAN_MAX_COUNT		32
+
 EidosValue_SP UniqueEidosValue(const EidosValue *p_x_value, bool p_force_new_vector, bool p_preserve_order)
 {
 	EidosValue_SP result_SP(nullptr);
@@ -716,7 +722,14 @@ EidosValue_SP UniqueEidosValue(const EidosValue *p_x_value, bool p_force_new_vec
 		EidosValue_Int_vector *int_result = new (gEidosValuePool->AllocateChunk()) EidosValue_Int_vector();
 		result_SP = EidosValue_SP(int_result);
 		
-		if (p_preserve_order)
+		if (p_preserve_order && (x_count > EIDOS_UNIQUE_SCAN_MAX_COUNT))
+		{
+			std::vector<int64_t> first_indexes = Eidos_FirstOccurrenceIndexes(int_data, x_count);
+			
+			for (int64_t value_index : first_indexes)
+				int_result->push_int(int_data[value_index]);
+		}
+		else if (p_preserve_order)
 		{
 			for (int value_index = 0; value_index < x_count; ++value_index)
 			{
@@ -756,7 +769,14 @@ EidosValue_SP UniqueEidosValue(const EidosValue *p_x_value, bool p_force_new_vec
 		EidosValue_Float_vector *float_result = new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector();
 		result_SP = EidosValue_SP(float_result);
 		
-		if (p_preserve_order)
+		if (p_preserve_order && (x_count > EIDOS_UNIQUE_SCAN_MAX_COUNT))
+		{
+			std::vector<int64_t> first_indexes = Eidos_FirstOccurrenceIndexes(float_data, x_count);
+			
+			for (int64_t value_index : first_indexes)
+				float_result->push_float(float_data[value_index]);
+		}
+		else if (p_preserve_order)
 		{
 			for (int value_index = 0; value_index < x_count; ++value_index)
 			{
@@ -796,7 +816,14 @@ EidosValue_SP UniqueEidosValue(const EidosValue *p_x_value, bool p_force_new_vec
 		EidosValue_String_vector *string_result = new (gEidosValuePool->AllocateChunk()) EidosValue_String_vector();
 		result_SP = EidosValue_SP(string_result);
 		
-		if (p_preserve_order)
+		if (p_preserve_order && (x_count > EIDOS_UNIQUE_SCAN_MAX_COUNT))
+		{
+			std::vector<int64_t> first_indexes = Eidos_FirstOccurrenceIndexes(string_vec.data(), x_count);
+			
+			for (int64_t value_index : first_indexes)
+				string_result->PushString(string_vec[value_index]);
+		}
+		else if (p_preserve_order)
 		{
 			for (int value_index = 0; value_index < x_count; ++value_index)
 			{
@@ -832,7 +859,14 @@ EidosValue_SP UniqueEidosValue(const EidosValue *p_x_value, bool p_force_new_vec
 		EidosValue_Object_vector *object_result = new (gEidosValuePool->AllocateChunk()) EidosValue_Object_vector(((EidosValue_Object *)x_value)->Class());
 		result_SP = EidosValue_SP(object_result);
 		
-		if (p_preserve_order)
+		if (p_preserve_order && (x_count > EIDOS_UNIQUE_SCAN_MAX_COUNT))
+		{
+			std::vector<int64_t> first_indexes = Eidos_FirstOccurrenceIndexes(object_data, x_count);
+			
+			for (int64_t value_index : first_indexes)
+				object_result->push_object_element(object_data[value_index]);
+		}
+		else if (p_preserve_order)
 		{
 			for (int value_index = 0; value_index < x_count; ++value_index)
 			{
@@ -1234,15 +1268,10 @@ EidosValue_SP Eidos_ExecuteFunction_cumSum(const EidosValue_SP *const p_argument
 		{
 			// We have x_count != 1, so the type of x_value must be EidosValue_Float_vector; we can use the fast API
 			const double *float_data = x_value->FloatVector()->data();
-			double sum = 0.0;
 			EidosValue_Float_vector *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector())->resize_no_initialize(x_count);
 			result_SP = EidosValue_SP(float_result);
 			
-			for (int value_index = 0; value_index < x_count; ++value_index)
-			{
-				sum += float_data[value_index];
-				float_result->set_float_no_check(sum, value_index);
-			}
+			Eidos_CumSum_Float(float_data, float_result->data(), x_count);
 		}
 	}
 	
@@ -1268,8 +1297,15 @@ EidosValue_SP Eidos_ExecuteFunction_exp(const EidosValue_SP *const p_arguments,
 		EidosValue_Float_vector *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector())->resize_no_initialize(x_count);
 		result_SP = EidosValue_SP(float_result);
 		
-		for (int value_index = 0; value_index < x_count; ++value_index)
-			float_result->set_float_no_check(exp(x_value->FloatAtIndex(value_index, nullptr)), value_index);
+		if (x_value->Type() == EidosValueType::kValueFloat)
+		{
+			Eidos_Exp_Float(x_value->FloatVector()->data(), float_result->data(), x_count);
+		}
+		else
+		{
+			for (int value_index = 0; value_index < x_count; ++value_index)
+				float_result->set_float_no_check(exp(x_value->FloatAtIndex(value_index, nullptr)), value_index);
+		}
 	}
 	
 	result_SP->CopyDimensionsFromValue(x_value);
@@ -1620,8 +1656,15 @@ EidosValue_SP Eidos_ExecuteFunction_log(const EidosValue_SP *const p_arguments,
 		EidosValue_Float_vector *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector())->resize_no_initialize(x_count);
 		result_SP = EidosValue_SP(float_result);
 		
-		for (int value_index = 0; value_index < x_count; ++value_index)
-			float_result->set_float_no_check(log(x_value->FloatAtIndex(value_index, nullptr)), value_index);
+		if (x_value->Type() == EidosValueType::kValueFloat)
+		{
+			Eidos_Log_Float(x_value->FloatVector()->data(), float_result->data(), x_count);
+		}
+		else
+		{
+			for (int value_index = 0; value_index < x_count; ++value_index)
+				float_result->set_float_no_check(log(x_value->FloatAtIndex(value_index, nullptr)), value_index);
+		}
 	}
 	
 	result_SP->CopyDimensionsFromValue(x_value);
@@ -3259,8 +3302,15 @@ EidosValue_SP Eidos_ExecuteFunction_sqrt(const EidosValue_SP *const p_arguments,
 		EidosValue_Float_vector *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector())->resize_no_initialize(x_count);
 		result_SP = EidosValue_SP(float_result);
 		
-		for (int value_index = 0; value_index < x_count; ++value_index)
-			float_result->set_float_no_check(sqrt(x_value->FloatAtIndex(value_index, nullptr)), value_index);
+		if (x_value->Type() == EidosValueType::kValueFloat)
+		{
+			Eidos_Sqrt_Float(x_value->FloatVector()->data(), float_result->data(), x_count);
+		}
+		else
+		{
+			for (int value_index = 0; value_index < x_count; ++value_index)
+				float_result->set_float_no_check(sqrt(x_value->FloatAtIndex(value_index, nullptr)), value_index);
+		}
 	}
 	
 	result_SP->CopyDimensionsFromValue(x_value);
@@ -3327,12 +3377,9 @@ EidosValue_SP Eidos_ExecuteFunction_sum(const EidosValue_SP *const p_arguments,
 		}
 		else
 		{
-			// We have x_count != 1, so the type of x_value must be EidosValue_Float_vector; we can use the fast API
+			// We have x_count != 1, so the type of x_value must be EidosValue_Float_vector; we can use the fast API, and sum pairwise
 			const double *float_data = x_value->FloatVector()->data();
-			double sum = 0;
-			
-			for (int value_index = 0; value_index < x_count; ++value_index)
-				sum += float_data[value_index];
+			double sum = Eidos_PairwiseSum_Float(float_data, x_count);
 			
 			result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(sum));
 		}
@@ -3440,6 +3487,23 @@ EidosValue_SP Eidos_ExecuteFunction_trunc(const EidosValue_SP *const p_arguments
 #pragma mark -
 
 
+// Returns the values of a numeric, non-singleton EidosValue as a buffer of float; float values are used in place, while integer values
+// are converted into p_converted_data, so that the float kernels in eidos_vector_kernels.h can be used for both
+static const double *_Eidos_FloatDataForValue(const EidosValue *p_value, std::vector<double> &p_converted_data)
+{
+	if (p_value->Type() == EidosValueType::kValueFloat)
+		return p_value->FloatVector()->data();
+	
+	int count = p_value->Count();
+	
+	p_converted_data.reserve(count);
+	
+	for (int value_index = 0; value_index < count; ++value_index)
+		p_converted_data.push_back(p_value->FloatAtIndex(value_index, nullptr));
+	
+	return p_converted_data.data();
+}
+
 //	(float$)cor(numeric x, numeric y)
 EidosValue_SP Eidos_ExecuteFunction_cor(const EidosValue_SP *const p_arguments, __attribute__((unused)) int p_argument_count, __attribute__((unused)) EidosInterpreter &p_interpreter)
 {
@@ -3762,11 +3826,10 @@ EidosValue_SP Eidos_ExecuteFunction_mean(const EidosValue_SP *const p_arguments,
 #endif
 		else if (x_type == EidosValueType::kValueFloat)
 		{
-			// Accelerated float case
+			// Accelerated float case, summed pairwise as in sum()
 			const double *float_data = x_value->FloatVector()->data();
 			
-			for (int value_index = 0; value_index < x_count; ++value_index)
-				sum += float_data[value_index];
+			sum = Eidos_PairwiseSum_Float(float_data, x_count);
 		}
 		else if (x_type == EidosValueType::kValueLogical)
 		{
@@ -4030,8 +4093,7 @@ EidosValue_SP Eidos_ExecuteFunction_pmax(const EidosValue_SP *const p_arguments,
 			EidosValue_Float_vector *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector())->resize_no_initialize(x_count);
 			result_SP = EidosValue_SP(float_result);
 			
-			for (int value_index = 0; value_index < x_count; ++value_index)
-				float_result->set_float_no_check(std::max(float0_data[value_index], y_singleton_value), value_index);
+			Eidos_PMax_Float_Singleton(float0_data, y_singleton_value, float_result->data(), x_count);
 		}
 		else if (x_type == EidosValueType::kValueString)
 		{
@@ -4074,8 +4136,7 @@ EidosValue_SP Eidos_ExecuteFunction_pmax(const EidosValue_SP *const p_arguments,
 			EidosValue_Float_vector *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector())->resize_no_initialize(x_count);
 			result_SP = EidosValue_SP(float_result);
 			
-			for (int value_index = 0; value_index < x_count; ++value_index)
-				float_result->set_float_no_check(std::max(float0_data[value_index], float1_data[value_index]), value_index);
+			Eidos_PMax_Float(float0_data, float1_data, float_result->data(), x_count);
 		}
 		else if (x_type == EidosValueType::kValueString)
 		{
@@ -4178,8 +4239,7 @@ EidosValue_SP Eidos_ExecuteFunction_pmin(const EidosValue_SP *const p_arguments,
 			EidosValue_Float_vector *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector())->resize_no_initialize(x_count);
 			result_SP = EidosValue_SP(float_result);
 			
-			for (int value_index = 0; value_index < x_count; ++value_index)
-				float_result->set_float_no_check(std::min(float0_data[value_index], y_singleton_value), value_index);
+			Eidos_PMin_Float_Singleton(float0_data, y_singleton_value, float_result->data(), x_count);
 		}
 		else if (x_type == EidosValueType::kValueString)
 		{
@@ -4222,8 +4282,7 @@ EidosValue_SP Eidos_ExecuteFunction_pmin(const EidosValue_SP *const p_arguments,
 			EidosValue_Float_vector *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector())->resize_no_initialize(x_count);
 			result_SP = EidosValue_SP(float_result);
 			
-			for (int value_index = 0; value_index < x_count; ++value_index)
-				float_result->set_float_no_check(std::min(float0_data[value_index], float1_data[value_index]), value_index);
+			Eidos_PMin_Float(float0_data, float1_data, float_result->data(), x_count);
 		}
 		else if (x_type == EidosValueType::kValueString)
 		{
@@ -4375,21 +4434,12 @@ EidosValue_SP Eidos_ExecuteFunction_sd(const EidosValue_SP *const p_arguments, _
 	
 	if (x_count > 1)
 	{
-		double mean = 0;
-		double sd = 0;
-		
-		for (int value_index = 0; value_index < x_count; ++value_index)
-			mean += x_value->FloatAtIndex(value_index, nullptr);
-		
-		mean /= x_count;
-		
-		for (int value_index = 0; value_index < x_count; ++value_index)
-		{
-			double temp = (x_value->FloatAtIndex(value_index, nullptr) - mean);
-			sd += temp * temp;
-		}
+		// Both sums are pairwise; integer values are converted to float first, so that they are summed in the same way
+		std::vector<double> converted_data;
+		const double *float_data = _Eidos_FloatDataForValue(x_value, converted_data);
+		double mean = Eidos_PairwiseSum_Float(float_data, x_count) / x_count;
+		double sd = sqrt(Eidos_PairwiseSumOfSquaredDeviations_Float(float_data, x_count, mean) / (x_count - 1));
 		
-		sd = sqrt(sd / (x_count - 1));
 		result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(sd));
 	}
 	else
@@ -4463,24 +4513,12 @@ EidosValue_SP Eidos_ExecuteFunction_var(const EidosValue_SP *const p_arguments,
 	
 	if (x_count > 1)
 	{
-		// calculate mean
-		double mean = 0;
-		
-		for (int value_index = 0; value_index < x_count; ++value_index)
-			mean += x_value->FloatAtIndex(value_index, nullptr);
-		
-		mean /= x_count;
-		
-		// calculate variance
-		double var = 0;
-		
-		for (int value_index = 0; value_index < x_count; ++value_index)
-		{
-			double temp = (x_value->FloatAtIndex(value_index, nullptr) - mean);
-			var += temp * temp;
-		}
+		// Both sums are pairwise, as in sd()
+		std::vector<double> converted_data;
+		const double *float_data = _Eidos_FloatDataForValue(x_value, converted_data);
+		double mean = Eidos_PairwiseSum_Float(float_data, x_count) / x_count;
+		double var = Eidos_PairwiseSumOfSquaredDeviations_Float(float_data, x_count, mean) / (x_count - 1);
 		
-		var = var / (x_count - 1);
 		result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(var));
 	}
 	else
@@ -4666,8 +4704,7 @@ EidosValue_SP Eidos_ExecuteFunction_dnorm(const EidosValue_SP *const p_arguments
 			EidosValue_Float_vector *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector())->resize_no_initialize(num_quantiles);
 			result_SP = EidosValue_SP(float_result);
 			
-			for (int64_t value_index = 0; value_index < num_quantiles; ++value_index)
-				float_result->set_float_no_check(gsl_ran_gaussian_pdf(float_data[value_index] - mu0, sigma0), value_index);
+			Eidos_DNorm_Float(float_data, mu0, sigma0, float_result->data(), num_quantiles);
 		}
 	}
 	else
@@ -7151,6 +7188,9 @@ EidosValue_SP Eidos_ExecuteFunction_ifelse(const EidosValue_SP *const p_argument
 	return result_SP;
 }
 
+// match() scans table for each element of x unless both x and table have at least this many elements, in which case it uses a hash table
+#define EIDOS_MATCH_HASH_MIN_COUNT		64
+
 //	(integer)match(* x, * table)
 EidosValue_SP Eidos_ExecuteFunction_match(const EidosValue_SP *const p_arguments, __attribute__((unused)) int p_argument_count, EidosInterpreter __attribute__((unused)) &p_interpreter)
 {
@@ -7310,7 +7350,22 @@ EidosValue_SP Eidos_ExecuteFunction_match(const EidosValue_SP *const p_arguments
 		
 		int table_index;
 		
-		if (x_type == EidosValueType::kValueLogical)
+		if ((x_count >= EIDOS_MATCH_HASH_MIN_COUNT) && (table_count >= EIDOS_MATCH_HASH_MIN_COUNT) && (x_type != EidosValueType::kValueLogical))
+		{
+			// For long vectors, look up each element of x in a hash table of table, rather than scanning table for each element;
+			// the lookups are done in parallel for very long vectors (see eidos_parallel.h)
+			int64_t *result_data = int_result->data();
+			
+			if (x_type == EidosValueType::kValueInt)
+				Eidos_MatchIndexes(x_value->IntVector()->data(), x_count, table_value->IntVector()->data(), table_count, result_data);
+			else if (x_type == EidosValueType::kValueFloat)
+				Eidos_MatchIndexes(x_value->FloatVector()->data(), x_count, table_value->FloatVector()->data(), table_count, result_data);
+			else if (x_type == EidosValueType::kValueString)
+				Eidos_MatchIndexes(x_value->StringVector()->data(), x_count, table_value->StringVector()->data(), table_count, result_data);
+			else if (x_type == EidosValueType::kValueObject)
+				Eidos_MatchIndexes(x_value->ObjectElementVector()->data(), x_count, table_value->ObjectElementVector()->data(), table_count, result_data);
+		}
+		else if (x_type == EidosValueType::kValueLogical)
 		{
 			const eidos_logical_t *logical_data0 = x_value->LogicalVector()->data();
 			const eidos_logical_t *logical_data1 = table_value->LogicalVector()->data();
@@ -7440,14 +7495,16 @@ EidosValue_SP Eidos_ExecuteFunction_order(const EidosValue_SP *const p_arguments
 		bool ascending = p_arguments[1]->LogicalAtIndex(0, nullptr);
 		std::vector<int64_t> order;
 		
+		// this is a stable sort that puts NAN last, as sort() does, so tied elements stay in their original order; that keeps the result
+		// independent of threading
 		if (x_type == EidosValueType::kValueLogical)
-			order = EidosSortIndexes(x_value->LogicalVector()->data(), x_count, ascending);
+			order = Eidos_ParallelSortIndexes(x_value->LogicalVector()->data(), x_count, ascending);
 		else if (x_type == EidosValueType::kValueInt)
-			order = EidosSortIndexes(x_value->IntVector()->data(), x_count, ascending);
+			order = Eidos_ParallelSortIndexes(x_value->IntVector()->data(), x_count, ascending);
 		else if (x_type == EidosValueType::kValueFloat)
-			order = EidosSortIndexes(x_value->FloatVector()->data(), x_count, ascending);
+			order = Eidos_ParallelSortIndexes(x_value->FloatVector()->data(), x_count, ascending);
 		else if (x_type == EidosValueType::kValueString)
-			order = EidosSortIndexes(*x_value->StringVector(), ascending);
+			order = Eidos_ParallelSortIndexes(x_value->StringVector()->data(), x_count, ascending);
 		
 		EidosValue_Int_vector *int_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Int_vector(order));
 		result_SP = EidosValue_SP(int_result);
@@ -7456,6 +7513,42 @@ EidosValue_SP Eidos_ExecuteFunction_order(const EidosValue_SP *const p_arguments
 	return result_SP;
 }
 
+// Pastes together the elements of a long non-object vector in parallel, each thread pasting one piece; see paste() and paste0()
+static std::string _Eidos_ParallelPaste(const EidosValue *p_x_value, int p_x_count, const std::string &p_separator, int p_piece_count)
+{
+	std::vector<std::string> piece_strings(p_piece_count);
+	
+#pragma omp parallel for num_threads(p_piece_count) schedule(static, 1) default(none) shared(p_x_value, p_x_count, p_separator, p_piece_count, piece_strings)
+	for (int piece_index = 0; piece_index < p_piece_count; ++piece_index)
+	{
+		int first = (int)(((int64_t)p_x_count * piece_index) / p_piece_count);
+		int last = (int)(((int64_t)p_x_count * (piece_index + 1)) / p_piece_count);
+		std::string &piece_string = piece_strings[piece_index];
+		
+		for (int value_index = first; value_index < last; ++value_index)
+		{
+			if (value_index > 0)
+				piece_string.append(p_separator);
+			
+			piece_string.append(p_x_value->StringAtIndex(value_index, nullptr));
+		}
+	}
+	
+	size_t result_length = 0;
+	
+	for (std::string &piece_string : piece_strings)
+		result_length += piece_string.length();
+	
+	std::string result_string;
+	
+	result_string.reserve(result_length);
+	
+	for (std::string &piece_string : piece_strings)
+		result_string.append(piece_string);
+	
+	return result_string;
+}
+
 //	(string$)paste(* x, [string$ sep = " "])
 EidosValue_SP Eidos_ExecuteFunction_paste(const EidosValue_SP *const p_arguments, __attribute__((unused)) int p_argument_count, __attribute__((unused)) EidosInterpreter &p_interpreter)
 {
@@ -7469,6 +7562,13 @@ EidosValue_SP Eidos_ExecuteFunction_paste(const EidosValue_SP *const p_arguments
 	EidosValueType x_type = x_value->Type();
 	std::string separator = p_arguments[1]->StringAtIndex(0, nullptr);
 	std::string result_string;
+	int piece_count = Eidos_ParallelPieceCount(x_count);
+	
+	if ((piece_count > 1) && (x_type != EidosValueType::kValueObject))
+	{
+		result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String_singleton(_Eidos_ParallelPaste(x_value, x_count, separator, piece_count)));
+		return result_SP;
+	}
 	
 	for (int value_index = 0; value_index < x_count; ++value_index)
 	{
@@ -7504,6 +7604,13 @@ EidosValue_SP Eidos_ExecuteFunction_paste0(const EidosValue_SP *const p_argument
 	int x_count = x_value->Count();
 	EidosValueType x_type = x_value->Type();
 	std::string result_string;
+	int piece_count = Eidos_ParallelPieceCount(x_count);
+	
+	if ((piece_count > 1) && (x_type != EidosValueType::kValueObject))
+	{
+		result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String_singleton(_Eidos_ParallelPaste(x_value, x_count, gEidosStr_empty_string, piece_count)));
+		return result_SP;
+	}
 	
 	for (int value_index = 0; value_index < x_count; ++value_index)
 	{
@@ -7576,15 +7683,27 @@ EidosValue_SP Eidos_ExecuteFunction_sort(const EidosValue_SP *const p_arguments,
 	EidosValue_SP result_SP(nullptr);
 	
 	EidosValue *x_value = p_arguments[0].get();
+	EidosValueType x_type = x_value->Type();
 	int x_count = x_value->Count();
+	bool ascending = p_arguments[1]->LogicalAtIndex(0, nullptr);
+	
+	// Sort() is a stable sort that puts NAN last, split across threads for long vectors; since -0.0 and 0.0 are tied, they stay in
+	// their original order, so the result does not depend on the number of threads
+	if ((x_count > 1) && (x_type == EidosValueType::kValueInt))
+		result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int_vector(x_value->IntVector()->data(), x_count));
+	else if ((x_count > 1) && (x_type == EidosValueType::kValueFloat))
+		result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector(x_value->FloatVector()->data(), x_count));
+	else if ((x_count > 1) && (x_type == EidosValueType::kValueString))
+		result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String_vector(*x_value->StringVector()));
+	else
+	{
+		result_SP = x_value->NewMatchingType();
+		
+		for (int value_index = 0; value_index < x_count; ++value_index)
+			result_SP->PushValueFromIndexOfEidosValue(value_index, *x_value, nullptr);
+	}
 	
-	result_SP = x_value->NewMatchingType();
-	EidosValue *result = result_SP.get();
-	
-	for (int value_index = 0; value_index < x_count; ++value_index)
-		result->PushValueFromIndexOfEidosValue(value_index, *x_value, nullptr);
-	
-	result->Sort(p_arguments[1]->LogicalAtIndex(0, nullptr));
+	result_SP->Sort(ascending);
 	
 	return result_SP;
 }
@@ -7858,6 +7977,48 @@ EidosValue_SP Eidos_ExecuteFunction_which(const EidosValue_SP *const p_arguments
 	EidosValue_Int_vector *int_result = new (gEidosValuePool->AllocateChunk()) EidosValue_Int_vector();
 	result_SP = EidosValue_SP(int_result);
 	
+	int piece_count = Eidos_ParallelPieceCount(x_count);
+	
+	if (piece_count > 1)
+	{
+		// Count the T values in each piece, which gives each piece the position of its first result, then fill in parallel
+		std::vector<int64_t> piece_offsets(piece_count + 1, 0);
+		
+#pragma omp parallel for num_threads(piece_count) schedule(static, 1) default(none) shared(piece_count, piece_offsets, logical_data, x_count)
+		for (int piece_index = 0; piece_index < piece_count; ++piece_index)
+		{
+			int first = (int)(((int64_t)x_count * piece_index) / piece_count);
+			int last = (int)(((int64_t)x_count * (piece_index + 1)) / piece_count);
+			int64_t true_count = 0;
+			
+			for (int value_index = first; value_index < last; ++value_index)
+				if (logical_data[value_index])
+					true_count++;
+			
+			piece_offsets[piece_index + 1] = true_count;
+		}
+		
+		for (int piece_index = 0; piece_index < piece_count; ++piece_index)
+			piece_offsets[piece_index + 1] += piece_offsets[piece_index];
+		
+		int_result->resize_no_initialize(piece_offsets[piece_count]);
+		int64_t *result_data = int_result->data();
+		
+#pragma omp parallel for num_threads(piece_count) schedule(static, 1) default(none) shared(piece_count, piece_offsets, logical_data, x_count, result_data)
+		for (int piece_index = 0; piece_index < piece_count; ++piece_index)
+		{
+			int first = (int)(((int64_t)x_count * piece_index) / piece_count);
+			int last = (int)(((int64_t)x_count * (piece_index + 1)) / piece_count);
+			int64_t *result_ptr = result_data + piece_offsets[piece_index];
+			
+			for (int value_index = first; value_index < last; ++value_index)
+				if (logical_data[value_index])
+					*(result_ptr++) = value_index;
+		}
+		
+		return result_SP;
+	}
+	
 	for (int value_index = 0; value_index < x_count; ++value_index)
 		if (logical_data[value_index])
 			int_result->push_int(value_index);
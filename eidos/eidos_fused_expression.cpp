@@ -0,0 +1,399 @@
+//
+//  eidos_fused_expression.cpp
+//  Eidos
+//
+//  Copyright (c) 2019 Philipp Messer.  All rights reserved.
+//	A product of the Messer Lab, http://messerlab.org/slim/
+//
+
+//	This file is part of Eidos.
+//
+//	Eidos is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+//
+//	Eidos is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with Eidos.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "eidos_fused_expression.h"
+#include "eidos_interpreter.h"
+#include "eidos_functions.h"
+
+#include <cmath>
+#include <algorithm>
+
+
+// A fused sum() or mean() adds each chunk to its EidosPairwiseSum as one block, so it matches the unfused sum only if chunks are blocks
+static_assert(EIDOS_FUSION_CHUNK_SIZE == EIDOS_PAIRWISE_SUM_BLOCK, "EIDOS_FUSION_CHUNK_SIZE must equal EIDOS_PAIRWISE_SUM_BLOCK");
+
+
+#pragma mark -
+#pragma mark Fusion
+#pragma mark -
+
+EidosFusedOp EidosFusedExpression::_FusedOpForNode(const EidosASTNode *p_node)
+{
+	// Returns the operation for a node that can be fused, or kLeaf for any other node.  Note that == and != are not fused; the AST
+	// evaluators compare float vectors with the C++ operators, but other operands with CompareEidosValues_Float(), which differ for NAN.
+	size_t child_count = p_node->children_.size();
+	
+	switch (p_node->token_->token_type_)
+	{
+		case EidosTokenType::kTokenMinus:
+			if (child_count == 1)
+				return EidosFusedOp::kNegate;
+			return ((child_count == 2) ? EidosFusedOp::kSubtract : EidosFusedOp::kLeaf);
+		case EidosTokenType::kTokenPlus:	return ((child_count == 2) ? EidosFusedOp::kAdd : EidosFusedOp::kLeaf);
+		case EidosTokenType::kTokenMult:	return ((child_count == 2) ? EidosFusedOp::kMultiply : EidosFusedOp::kLeaf);
+		case EidosTokenType::kTokenDiv:		return ((child_count == 2) ? EidosFusedOp::kDivide : EidosFusedOp::kLeaf);
+		case EidosTokenType::kTokenMod:		return ((child_count == 2) ? EidosFusedOp::kModulo : EidosFusedOp::kLeaf);
+		case EidosTokenType::kTokenExp:		return ((child_count == 2) ? EidosFusedOp::kPower : EidosFusedOp::kLeaf);
+		case EidosTokenType::kTokenLt:		return ((child_count == 2) ? EidosFusedOp::kLt : EidosFusedOp::kLeaf);
+		case EidosTokenType::kTokenLtEq:	return ((child_count == 2) ? EidosFusedOp::kLtEq : EidosFusedOp::kLeaf);
+		case EidosTokenType::kTokenGt:		return ((child_count == 2) ? EidosFusedOp::kGt : EidosFusedOp::kLeaf);
+		case EidosTokenType::kTokenGtEq:	return ((child_count == 2) ? EidosFusedOp::kGtEq : EidosFusedOp::kLeaf);
+		default:							return EidosFusedOp::kLeaf;
+	}
+}
+
+bool EidosFusedExpression::_AddSteps(const EidosASTNode *p_node, bool p_is_root)
+{
+	EidosFusedOp op = _FusedOpForNode(p_node);
+	
+	if (op == EidosFusedOp::kLeaf)
+	{
+		// Leaves are numbers, identifiers, and property references; anything else (a call, a subset, a logical operator, etc.)
+		// keeps the expression from being fused.  Leaves must have no side effects, since a fallback evaluates them again.
+		EidosTokenType token_type = p_node->token_->token_type_;
+		
+		if ((token_type != EidosTokenType::kTokenNumber) && (token_type != EidosTokenType::kTokenIdentifier) && (token_type != EidosTokenType::kTokenDot))
+			return false;
+		if (!p_node->_HasNoSideEffects())
+			return false;
+		if (steps_.size() >= EIDOS_FUSION_MAX_STEPS)
+			return false;
+		
+		steps_.emplace_back(EidosFusedStep{EidosFusedOp::kLeaf, (uint8_t)leaves_.size(), 0});
+		leaves_.emplace_back(p_node);
+		return true;
+	}
+	
+	// comparisons produce logical values, which the fused operators do not take as operands, so they may only be at the root
+	if ((op >= EidosFusedOp::kLt) && !p_is_root)
+		return false;
+	
+	if (!_AddSteps(p_node->children_[0], false))
+		return false;
+	
+	uint8_t first_operand = (uint8_t)(steps_.size() - 1);
+	uint8_t second_operand = 0;
+	
+	if (op != EidosFusedOp::kNegate)
+	{
+		if (!_AddSteps(p_node->children_[1], false))
+			return false;
+		
+		second_operand = (uint8_t)(steps_.size() - 1);
+	}
+	
+	if (steps_.size() >= EIDOS_FUSION_MAX_STEPS)
+		return false;
+	
+	steps_.emplace_back(EidosFusedStep{op, first_operand, second_operand});
+	return true;
+}
+
+EidosFusedExpression *EidosFusedExpression::FuseExpression(const EidosASTNode *p_node)
+{
+#if defined(SLIMGUI) && (SLIMPROFILING == 1)
+	// Profiling tallies execution time per AST node, so profiled runs always use the AST-walking interpreter
+	return nullptr;
+#endif
+
+	EidosFusedOp root_op = _FusedOpForNode(p_node);
+	
+	if (root_op == EidosFusedOp::kLeaf)
+		return nullptr;
+	
+	EidosFusedExpression *fused = new EidosFusedExpression();
+	
+	// a single operator already makes just one pass over its operands, so fusion needs at least two to help
+	if (!fused->_AddSteps(p_node, true) || (fused->steps_.size() - fused->leaves_.size() < 2))
+	{
+		delete fused;
+		return nullptr;
+	}
+	
+	fused->logical_result_ = (root_op >= EidosFusedOp::kLt);
+	fused->fallback_evaluator_ = p_node->cached_evaluator_;
+	
+	return fused;
+}
+
+EidosFusedReduction EidosFusedExpression::ReductionForCall(const EidosASTNode *p_node)
+{
+	if ((p_node->token_->token_type_ != EidosTokenType::kTokenLParen) || (p_node->children_.size() != 2))
+		return EidosFusedReduction::kNone;
+	
+	// the signature is cached only for built-in functions, which cannot be redefined, so this is sure to be Eidos's sum() or mean()
+	const EidosFunctionSignature *signature = p_node->children_[0]->cached_signature_.get();
+	
+	if ((p_node->children_[0]->token_->token_type_ != EidosTokenType::kTokenIdentifier) || !signature)
+		return EidosFusedReduction::kNone;
+	
+	if (signature->internal_function_ == &Eidos_ExecuteFunction_sum)
+		return EidosFusedReduction::kSum;
+	if (signature->internal_function_ == &Eidos_ExecuteFunction_mean)
+		return EidosFusedReduction::kMean;
+	
+	return EidosFusedReduction::kNone;
+}
+
+
+#pragma mark -
+#pragma mark Execution
+#pragma mark -
+
+// Evaluates p_fused, setting p_result to its result, or, if p_reduce is true, setting p_sum and p_count to the sum and count of its
+// result; returns false, without setting anything, if the operands do not qualify, in which case the caller must fall back
+bool EidosInterpreter::_EvaluateFusedExpression(const EidosFusedExpression &p_fused, bool p_reduce, EidosValue_SP *p_result, double *p_sum, int *p_count)
+{
+	const EidosFusedStep *steps = p_fused.steps_.data();
+	int step_count = (int)p_fused.steps_.size();
+	EidosValue_SP leaf_values[EIDOS_FUSION_MAX_STEPS];
+	int step_counts[EIDOS_FUSION_MAX_STEPS];
+	bool step_is_float[EIDOS_FUSION_MAX_STEPS];
+	
+	// First evaluate the leaves and check the operands of each step, in the order the AST evaluators would.  We give up at the first
+	// step that the AST evaluators would handle differently, before evaluating any later leaves, so that the fallback raises the same
+	// error that the AST evaluators would have raised in the same place.
+	for (int step_index = 0; step_index < step_count; ++step_index)
+	{
+		const EidosFusedStep &step = steps[step_index];
+		
+		if (step.op_ == EidosFusedOp::kLeaf)
+		{
+			EidosValue_SP leaf_value = FastEvaluateNode(p_fused.leaves_[step.a_]);
+			EidosValueType leaf_type = leaf_value->Type();
+			int leaf_count = leaf_value->Count();
+			
+			if (((leaf_type != EidosValueType::kValueInt) && (leaf_type != EidosValueType::kValueFloat)) || (leaf_count == 0) || (leaf_value->DimensionCount() != 1))
+				return false;
+			
+			step_counts[step_index] = leaf_count;
+			step_is_float[step_index] = (leaf_type == EidosValueType::kValueFloat);
+			leaf_values[step.a_] = std::move(leaf_value);
+		}
+		else if (step.op_ == EidosFusedOp::kNegate)
+		{
+			// integer negation checks for overflow
+			if (!step_is_float[step.a_])
+				return false;
+			
+			step_counts[step_index] = step_counts[step.a_];
+			step_is_float[step_index] = true;
+		}
+		else
+		{
+			int first_count = step_counts[step.a_];
+			int second_count = step_counts[step.b_];
+			
+			if ((first_count != second_count) && (first_count != 1) && (second_count != 1))
+				return false;
+			
+			// integer +, -, and * check for overflow, and integer comparisons are done in integer; /, %, and ^ are always done in float
+			if (!step_is_float[step.a_] && !step_is_float[step.b_] && (step.op_ != EidosFusedOp::kDivide) && (step.op_ != EidosFusedOp::kModulo) && (step.op_ != EidosFusedOp::kPower))
+				return false;
+			
+			step_counts[step_index] = std::max(first_count, second_count);
+			step_is_float[step_index] = true;
+		}
+	}
+	
+	// Set up the destination of the last step: a new EidosValue, or the chunk buffer if we are reducing or the result is a singleton
+	int result_count = step_counts[step_count - 1];
+	double *float_result_data = nullptr;
+	eidos_logical_t *logical_result_data = nullptr;
+	
+	if (!p_reduce && (result_count > 1))
+	{
+		if (p_fused.logical_result_)
+		{
+			EidosValue_Logical_SP logical_result_SP = EidosValue_Logical_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Logical());
+			
+			logical_result_data = logical_result_SP->resize_no_initialize(result_count)->data();
+			*p_result = std::move(logical_result_SP);
+		}
+		else
+		{
+			EidosValue_Float_vector_SP float_result_SP = EidosValue_Float_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector());
+			
+			float_result_data = float_result_SP->resize_no_initialize(result_count)->data();
+			*p_result = std::move(float_result_SP);
+		}
+	}
+	
+	// Then run the steps over chunks of the operands.  Singleton leaves are broadcast into their chunk buffers once, float vector
+	// leaves are used in place, and integer vector leaves are converted to float a chunk at a time.
+	double chunk_buffers[EIDOS_FUSION_MAX_STEPS][EIDOS_FUSION_CHUNK_SIZE];
+	eidos_logical_t logical_buffer[EIDOS_FUSION_CHUNK_SIZE];
+	const double *step_data[EIDOS_FUSION_MAX_STEPS];
+	EidosPairwiseSum sum;
+	
+	for (int step_index = 0; step_index < step_count; ++step_index)
+	{
+		const EidosFusedStep &step = steps[step_index];
+		
+		if ((step.op_ == EidosFusedOp::kLeaf) && (step_counts[step_index] == 1))
+		{
+			double leaf_float = leaf_values[step.a_]->FloatAtIndex(0, nullptr);
+			
+			std::fill(chunk_buffers[step_index], chunk_buffers[step_index] + EIDOS_FUSION_CHUNK_SIZE, leaf_float);
+		}
+	}
+	
+	for (int chunk_start = 0; chunk_start < result_count; chunk_start += EIDOS_FUSION_CHUNK_SIZE)
+	{
+		int chunk_count = std::min(EIDOS_FUSION_CHUNK_SIZE, result_count - chunk_start);
+		
+		for (int step_index = 0; step_index < step_count; ++step_index)
+		{
+			const EidosFusedStep &step = steps[step_index];
+			
+			if (step.op_ == EidosFusedOp::kLeaf)
+			{
+				const EidosValue *leaf_value = leaf_values[step.a_].get();
+				
+				if (step_counts[step_index] == 1)
+				{
+					step_data[step_index] = chunk_buffers[step_index];
+				}
+				else if (step_is_float[step_index])
+				{
+					step_data[step_index] = leaf_value->FloatVector()->data() + chunk_start;
+				}
+				else
+				{
+					const int64_t *int_data = leaf_value->IntVector()->data() + chunk_start;
+					double *leaf_data = chunk_buffers[step_index];
+					
+					for (int index = 0; index < chunk_count; ++index)
+						leaf_data[index] = int_data[index];
+					
+					step_data[step_index] = leaf_data;
+				}
+				continue;
+			}
+			
+			const double * __restrict__ first_data = step_data[step.a_];
+			const double * __restrict__ second_data = step_data[step.b_];
+			
+			if (step.op_ >= EidosFusedOp::kLt)
+			{
+				// comparisons follow CompareEidosValues_Float(), which treats unordered operands (NAN) as equal
+				eidos_logical_t * __restrict__ logical_data = (logical_result_data ? logical_result_data + chunk_start : logical_buffer);
+				
+				switch (step.op_)
+				{
+					case EidosFusedOp::kLt:		for (int index = 0; index < chunk_count; ++index) logical_data[index] = (first_data[index] < second_data[index]); break;
+					case EidosFusedOp::kLtEq:	for (int index = 0; index < chunk_count; ++index) logical_data[index] = !(first_data[index] > second_data[index]); break;
+					case EidosFusedOp::kGt:		for (int index = 0; index < chunk_count; ++index) logical_data[index] = (first_data[index] > second_data[index]); break;
+					case EidosFusedOp::kGtEq:	for (int index = 0; index < chunk_count; ++index) logical_data[index] = !(first_data[index] < second_data[index]); break;
+					default: break;
+				}
+				continue;
+			}
+			
+			// the last step writes directly into the result, if there is one
+			double * __restrict__ result_data = ((float_result_data && (step_index == step_count - 1)) ? float_result_data + chunk_start : chunk_buffers[step_index]);
+			
+			switch (step.op_)
+			{
+				case EidosFusedOp::kNegate:		for (int index = 0; index < chunk_count; ++index) result_data[index] = -first_data[index]; break;
+				case EidosFusedOp::kAdd:		for (int index = 0; index < chunk_count; ++index) result_data[index] = first_data[index] + second_data[index]; break;
+				case EidosFusedOp::kSubtract:	for (int index = 0; index < chunk_count; ++index) result_data[index] = first_data[index] - second_data[index]; break;
+				case EidosFusedOp::kMultiply:	for (int index = 0; index < chunk_count; ++index) result_data[index] = first_data[index] * second_data[index]; break;
+				case EidosFusedOp::kDivide:		for (int index = 0; index < chunk_count; ++index) result_data[index] = first_data[index] / second_data[index]; break;
+				case EidosFusedOp::kModulo:		for (int index = 0; index < chunk_count; ++index) result_data[index] = fmod(first_data[index], second_data[index]); break;
+				case EidosFusedOp::kPower:		for (int index = 0; index < chunk_count; ++index) result_data[index] = pow(first_data[index], second_data[index]); break;
+				default: break;
+			}
+			
+			step_data[step_index] = result_data;
+		}
+		
+		// each chunk is one block of the pairwise sum that Eidos_ExecuteFunction_sum() would compute
+		if (p_reduce)
+			sum.AddBlockSum(Eidos_BlockSum_Float(step_data[step_count - 1], chunk_count));
+	}
+	
+	if (p_reduce)
+	{
+		// for a single value, sum() and mean() return the value itself, which differs from 0 + value for -0.0
+		*p_sum = ((result_count == 1) ? step_data[step_count - 1][0] : sum.Total());
+		*p_count = result_count;
+	}
+	else if (result_count == 1)
+	{
+		// singleton results are returned as the AST evaluators return them
+		if (p_fused.logical_result_)
+			*p_result = (logical_buffer[0] ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
+		else
+			*p_result = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(step_data[step_count - 1][0]));
+	}
+	
+	return true;
+}
+
+EidosValue_SP EidosInterpreter::_FallBackFromFusedExpression(const EidosASTNode *p_node, EidosFusedExpression &p_fused, EidosEvaluationMethod p_fallback_evaluator)
+{
+	// An expression that keeps falling back is probably not operating on vectors of float; stop trying to fuse it
+	if (++p_fused.fallback_count_ >= EIDOS_FUSION_MAX_FALLBACKS)
+		p_node->cached_evaluator_ = p_fallback_evaluator;
+	
+	return (this->*p_fallback_evaluator)(p_node);
+}
+
+EidosValue_SP EidosInterpreter::Evaluate_FusedExpression(const EidosASTNode *p_node)
+{
+	EidosFusedExpression *fused = p_node->cached_fused_expression_;
+	
+#if defined(DEBUG) || defined(EIDOS_GUI)
+	// When logging execution, use the AST evaluators so everything gets logged correctly
+	if (logging_execution_)
+		return (this->*(fused->fallback_evaluator_))(p_node);
+#endif
+
+	EidosValue_SP result_SP;
+	
+	if (_EvaluateFusedExpression(*fused, false, &result_SP, nullptr, nullptr))
+		return result_SP;
+	
+	return _FallBackFromFusedExpression(p_node, *fused, fused->fallback_evaluator_);
+}
+
+EidosValue_SP EidosInterpreter::Evaluate_FusedReduction(const EidosASTNode *p_node)
+{
+	EidosFusedExpression *fused = p_node->children_[1]->cached_fused_expression_;
+	
+#if defined(DEBUG) || defined(EIDOS_GUI)
+	// When logging execution, use the AST evaluators so everything gets logged correctly
+	if (logging_execution_)
+		return Evaluate_Call(p_node);
+#endif
+
+	double sum;
+	int count;
+	
+	if (_EvaluateFusedExpression(*fused, true, nullptr, &sum, &count))
+	{
+		if (fused->reduction_ == EidosFusedReduction::kMean)
+			return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(sum / count));
+		
+		return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(sum));
+	}
+	
+	return _FallBackFromFusedExpression(p_node, *fused, &EidosInterpreter::Evaluate_Call);
+}
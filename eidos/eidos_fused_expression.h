@@ -0,0 +1,119 @@
+//
+//  eidos_fused_expression.h
+//  Eidos
+//
+//  Copyright (c) 2019 Philipp Messer.  All rights reserved.
+//	A product of the Messer Lab, http://messerlab.org/slim/
+//
+
+//	This file is part of Eidos.
+//
+//	Eidos is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+//
+//	Eidos is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with Eidos.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+
+ EidosFusedExpression is an optional fused form of an elementwise arithmetic expression, such as x * y + z, that is evaluated by
+ EidosInterpreter::Evaluate_FusedExpression().  The AST evaluators allocate a full-length EidosValue for every operator in such an
+ expression; the fused form instead evaluates the operands of the expression (its "leaves") and then runs all of its operators
+ over the vectors in chunks of EIDOS_FUSION_CHUNK_SIZE elements, in stack buffers, writing only the final result to an EidosValue.
+ When the expression is the argument to sum() or mean(), EidosInterpreter::Evaluate_FusedReduction() accumulates the result
+ directly, without allocating it at all.
+
+ Fusion is done by EidosASTNode::OptimizeTree() for binary +, -, *, /, %, and ^ and unary -, optionally with <, <=, >, or >= at
+ the root; it requires at least two operators, since a single operator already makes just one pass over its operands.  The leaves
+ must be free of side effects (see EidosASTNode::_HasNoSideEffects()).  At runtime, the fused evaluator handles only numeric operands
+ without dimensions, of conformable sizes, for which every operator produces a float result (or a logical result, for a comparison);
+ integer arithmetic is excluded, since it has overflow checks.  In any other case the expression is handed to the AST evaluator that
+ was replaced, which evaluates the leaves again (harmless, since they have no side effects) and produces the correct result or raises
+ the correct error.  The fused loops perform exactly the operations that the AST evaluators perform, element by element, so the
+ results are identical; sum() and mean() accumulate the same pairwise sum as Eidos_ExecuteFunction_sum() and _mean().
+
+ */
+
+#ifndef __Eidos__eidos_fused_expression__
+#define __Eidos__eidos_fused_expression__
+
+#include <vector>
+
+#include "eidos_ast_node.h"
+#include "eidos_vector_kernels.h"
+
+
+// The number of elements processed by each pass of the fused loops; the operands and intermediate results for one chunk live in
+// stack buffers, so this and EIDOS_FUSION_MAX_STEPS should be kept modest.  A fused sum() or mean() accumulates each chunk as one
+// block of a pairwise sum, so this must be the block size of the pairwise sums done by sum() and mean().
+#define EIDOS_FUSION_CHUNK_SIZE		EIDOS_PAIRWISE_SUM_BLOCK
+
+// The maximum number of steps (leaves plus operators) in a fused expression; larger expressions are left unfused
+#define EIDOS_FUSION_MAX_STEPS		24
+
+// The number of times a fused expression may fall back to the AST evaluators before its node reverts to them permanently
+#define EIDOS_FUSION_MAX_FALLBACKS	16
+
+
+enum class EidosFusedOp : uint8_t {
+	kLeaf = 0,		// the value of leaves_[a_]
+	kNegate,		// -[a_]
+	kAdd,			// [a_] + [b_]
+	kSubtract,		// [a_] - [b_]
+	kMultiply,		// [a_] * [b_]
+	kDivide,		// [a_] / [b_]
+	kModulo,		// [a_] % [b_]
+	kPower,			// [a_] ^ [b_]
+	kLt,			// [a_] < [b_]; comparisons may only be the last step
+	kLtEq,			// [a_] <= [b_]
+	kGt,			// [a_] > [b_]
+	kGtEq,			// [a_] >= [b_]
+};
+
+// A step in a fused expression; operands refer to the results of earlier steps, except for kLeaf, which refers to a leaf
+typedef struct {
+	EidosFusedOp op_;
+	uint8_t a_, b_;
+} EidosFusedStep;
+
+// The reductions that can be fused with an expression; see EidosInterpreter::Evaluate_FusedReduction()
+enum class EidosFusedReduction : uint8_t {
+	kNone = 0,
+	kSum,
+	kMean,
+};
+
+
+class EidosFusedExpression
+{
+	//	This class has its copy constructor and assignment operator disabled, to prevent accidental copying.
+	
+public:
+	std::vector<const EidosASTNode *> leaves_;				// the nodes for the operands of the expression, in evaluation order; not owned
+	std::vector<EidosFusedStep> steps_;						// the steps of the expression, in evaluation (postorder) order
+	EidosFusedReduction reduction_ = EidosFusedReduction::kNone;	// set if the expression is the argument of sum() or mean()
+	bool logical_result_ = false;							// true if the last step is a comparison
+	
+	EidosEvaluationMethod fallback_evaluator_ = nullptr;		// the evaluator replaced by the fused evaluator, used as a fallback
+	int fallback_count_ = 0;								// the number of times the fused evaluator has fallen back
+	
+	EidosFusedExpression(const EidosFusedExpression&) = delete;					// no copying
+	EidosFusedExpression& operator=(const EidosFusedExpression&) = delete;		// no copying
+	EidosFusedExpression(void) = default;
+	
+	// Returns a fused form of the expression rooted at p_node, or nullptr if the expression does not qualify for fusion
+	static EidosFusedExpression *FuseExpression(const EidosASTNode *p_node);
+	
+	// Returns the reduction performed by the call node p_node if it is a call to the built-in sum() or mean() with a single
+	// positional argument, or kNone otherwise
+	static EidosFusedReduction ReductionForCall(const EidosASTNode *p_node);
+	
+private:
+	static EidosFusedOp _FusedOpForNode(const EidosASTNode *p_node);
+	bool _AddSteps(const EidosASTNode *p_node, bool p_is_root);
+};
+
+
+#endif /* defined(__Eidos__eidos_fused_expression__) */
@@ -59,6 +59,11 @@
 
 bool eidos_do_memory_checks = true;
 
+int gEidosMaxThreads = 1;
+int64_t gEidosParallelVectorThreshold = 100000;
+
+bool gEidosUseAVX2 = false;
+
 EidosSymbolTable *gEidosConstantsSymbolTable = nullptr;
 
 
@@ -167,6 +172,12 @@ void Eidos_WarmUp(void)
 	{
 		been_here = true;
 		
+#if EIDOS_HAS_AVX2_DISPATCH
+		// Check whether AVX2 variants of hot loops can be used on this CPU
+		__builtin_cpu_init();
+		gEidosUseAVX2 = __builtin_cpu_supports("avx2");
+#endif
+		
 		// Set up the vector of Eidos constant names
 		gEidosConstantNames.push_back(gEidosStr_T);
 		gEidosConstantNames.push_back(gEidosStr_F);
@@ -139,6 +139,48 @@ size_t Eidos_GetMaxRSS(void);
 void Eidos_CheckRSSAgainstMax(std::string p_message1, std::string p_message2);
 
 
+// *******************************************************************************************************************
+//
+//	Multithreading
+//
+#pragma mark -
+#pragma mark Multithreading
+#pragma mark -
+
+// When built with OpenMP (in which case the compiler defines _OPENMP), some expensive operations can be spread across
+// multiple threads.  This is opt-in: gEidosMaxThreads is 1 unless the Context raises it (SLiM does so with its -threads
+// command-line option), and with one thread everything takes exactly the same code paths as a build without OpenMP.
+// Code that goes parallel should use at most gEidosMaxThreads threads, and should produce results that do not depend
+// upon how the work happens to be scheduled across those threads.
+extern int gEidosMaxThreads;
+
+// Vectorized built-in functions, such as sort(), match(), and which(), split their work across threads only for vectors of at
+// least this many elements (and only when gEidosMaxThreads > 1), since below that the cost of starting threads outweighs the
+// gain.  SLiM sets this with its -parallelThreshold command-line option.  See eidos_parallel.h.
+extern int64_t gEidosParallelVectorThreshold;
+
+
+// *******************************************************************************************************************
+//
+//	SIMD dispatch
+//
+#pragma mark -
+#pragma mark SIMD dispatch
+#pragma mark -
+
+// Some hot loops have an AVX2 variant alongside their portable variant.  EIDOS_HAS_AVX2_DISPATCH is 1 when the compiler can
+// build such variants without AVX2 being enabled for the whole build (GCC or Clang, targeting x86-64); the AVX2 variant is
+// then used only if Eidos_WarmUp() finds that the CPU supports AVX2.  Setting gEidosUseAVX2 to false forces the portable
+// variants.  The two variants of a loop must produce bit-identical results, so that output never depends upon the CPU.
+#if (defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)))
+#define EIDOS_HAS_AVX2_DISPATCH		1
+#else
+#define EIDOS_HAS_AVX2_DISPATCH		0
+#endif
+
+extern bool gEidosUseAVX2;
+
+
 // *******************************************************************************************************************
 //
 //	Profiling support
@@ -209,7 +209,8 @@ EidosValue_SP EidosInterpreter::EvaluateInternalBlock(EidosScript *p_script_for_
 		saved_error_tracking = true;
 	}
 	
-	EidosValue_SP result_SP = FastEvaluateNode(root_node_);
+	// use the block's compiled form if the client compiled it with EidosBytecode::CompileBlock(); it gives the same result
+	EidosValue_SP result_SP = (root_node_->cached_bytecode_ ? ExecuteBytecode(*root_node_->cached_bytecode_) : FastEvaluateNode(root_node_));
 	
 	// if a next or break statement was hit and was not handled by a loop, throw an error
 	if (next_statement_hit_ || break_statement_hit_)
@@ -2181,175 +2182,138 @@ EidosValue_SP EidosInterpreter::Evaluate_Plus(const EidosASTNode *p_node)
 	}
 	else
 	{
-		// binary plus is legal either between two numeric types, or between a string and any other non-NULL operand
 		EidosValue_SP first_child_value = FastEvaluateNode(p_node->children_[0]);
-		EidosValueType first_child_type = first_child_value->Type();
-		
 		EidosValue_SP second_child_value = FastEvaluateNode(p_node->children_[1]);
-		EidosValueType second_child_type = second_child_value->Type();
 		
-		int first_child_count = first_child_value->Count();
-		int second_child_count = second_child_value->Count();
-		
-		// matrices/arrays must be conformable, and we need to decide here which operand's dimensionality will be used for the result
-		int first_child_dimcount = first_child_value->DimensionCount();
-		int second_child_dimcount = second_child_value->DimensionCount();
-		EidosValue_SP result_dim_source(EidosValue::BinaryOperationDimensionSource(first_child_value.get(), second_child_value.get()));
-		
-		if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(first_child_value.get(), second_child_value.get()))
-				EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Plus): non-conformable array operands to binary '+' operator." << EidosTerminate(operator_token);
-		
-		if ((first_child_type == EidosValueType::kValueVOID) || (second_child_type == EidosValueType::kValueVOID))
-			EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Plus): operand type void is not supported by the '+' operator." << EidosTerminate(operator_token);
+		result_SP = _Evaluate_Plus_Internal(p_node, std::move(first_child_value), std::move(second_child_value));
+	}
+	
+	EIDOS_EXIT_EXECUTION_LOG("Evaluate_Plus()");
+	return result_SP;
+}
+
+EidosValue_SP EidosInterpreter::_Evaluate_Plus_Internal(const EidosASTNode *p_node, EidosValue_SP p_first_child_value, EidosValue_SP p_second_child_value)
+{
+	// binary plus is legal either between two numeric types, or between a string and any other non-NULL operand
+	EidosToken *operator_token = p_node->token_;
+	EidosValue_SP result_SP;
+	
+	EidosValueType first_child_type = p_first_child_value->Type();
+	EidosValueType second_child_type = p_second_child_value->Type();
+	
+	int first_child_count = p_first_child_value->Count();
+	int second_child_count = p_second_child_value->Count();
+	
+	// matrices/arrays must be conformable, and we need to decide here which operand's dimensionality will be used for the result
+	int first_child_dimcount = p_first_child_value->DimensionCount();
+	int second_child_dimcount = p_second_child_value->DimensionCount();
+	EidosValue_SP result_dim_source(EidosValue::BinaryOperationDimensionSource(p_first_child_value.get(), p_second_child_value.get()));
+	
+	if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(p_first_child_value.get(), p_second_child_value.get()))
+			EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Plus): non-conformable array operands to binary '+' operator." << EidosTerminate(operator_token);
+	
+	if ((first_child_type == EidosValueType::kValueVOID) || (second_child_type == EidosValueType::kValueVOID))
+		EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Plus): operand type void is not supported by the '+' operator." << EidosTerminate(operator_token);
+	
+	if ((first_child_type == EidosValueType::kValueString) || (second_child_type == EidosValueType::kValueString))
+	{
+		// If either operand is a string, then we are doing string concatenation, with promotion to strings if needed
+		// BCH 10/12/2018: Starting in Eidos 2.2, we allow string concatenation of NULL, which acts just as if the NULL were
+		// a singleton string vector containing "NULL".  It is handled by pretending that NULL is length 1 and special-casing.
+		if (first_child_type == EidosValueType::kValueNULL)
+		{
+			first_child_count = 1;
+			result_dim_source = p_second_child_value;
+		}
+		if (second_child_type == EidosValueType::kValueNULL)
+		{
+			second_child_count = 1;
+			result_dim_source = p_first_child_value;
+		}
 		
-		if ((first_child_type == EidosValueType::kValueString) || (second_child_type == EidosValueType::kValueString))
+		if ((first_child_count == 1) && (second_child_count == 1))
+		{
+			const std::string &&first_string = (first_child_type == EidosValueType::kValueNULL) ? gEidosStr_NULL : p_first_child_value->StringAtIndex(0, operator_token);
+			const std::string &&second_string = (second_child_type == EidosValueType::kValueNULL) ? gEidosStr_NULL : p_second_child_value->StringAtIndex(0, operator_token);
+			
+			result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String_singleton(first_string + second_string));
+		}
+		else
 		{
-			// If either operand is a string, then we are doing string concatenation, with promotion to strings if needed
-			// BCH 10/12/2018: Starting in Eidos 2.2, we allow string concatenation of NULL, which acts just as if the NULL were
-			// a singleton string vector containing "NULL".  It is handled by pretending that NULL is length 1 and special-casing.
-			if (first_child_type == EidosValueType::kValueNULL)
+			if (first_child_count == second_child_count)
 			{
-				first_child_count = 1;
-				result_dim_source = second_child_value;
+				EidosValue_String_vector_SP string_result_SP = EidosValue_String_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String_vector());
+				EidosValue_String_vector *string_result = string_result_SP->Reserve(first_child_count);
+				
+				for (int value_index = 0; value_index < first_child_count; ++value_index)
+					string_result->PushString(p_first_child_value->StringAtIndex(value_index, operator_token) + p_second_child_value->StringAtIndex(value_index, operator_token));
+				
+				result_SP = std::move(string_result_SP);
 			}
-			if (second_child_type == EidosValueType::kValueNULL)
+			else if (first_child_count == 1)
 			{
-				second_child_count = 1;
-				result_dim_source = first_child_value;
+				std::string singleton_string = (first_child_type == EidosValueType::kValueNULL) ? gEidosStr_NULL : p_first_child_value->StringAtIndex(0, operator_token);
+				EidosValue_String_vector_SP string_result_SP = EidosValue_String_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String_vector());
+				EidosValue_String_vector *string_result = string_result_SP->Reserve(second_child_count);
+				
+				for (int value_index = 0; value_index < second_child_count; ++value_index)
+					string_result->PushString(singleton_string + p_second_child_value->StringAtIndex(value_index, operator_token));
+				
+				result_SP = std::move(string_result_SP);
 			}
-			
-			if ((first_child_count == 1) && (second_child_count == 1))
+			else if (second_child_count == 1)
 			{
-				const std::string &&first_string = (first_child_type == EidosValueType::kValueNULL) ? gEidosStr_NULL : first_child_value->StringAtIndex(0, operator_token);
-				const std::string &&second_string = (second_child_type == EidosValueType::kValueNULL) ? gEidosStr_NULL : second_child_value->StringAtIndex(0, operator_token);
+				std::string singleton_string = (second_child_type == EidosValueType::kValueNULL) ? gEidosStr_NULL : p_second_child_value->StringAtIndex(0, operator_token);
+				EidosValue_String_vector_SP string_result_SP = EidosValue_String_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String_vector());
+				EidosValue_String_vector *string_result = string_result_SP->Reserve(first_child_count);
 				
-				result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String_singleton(first_string + second_string));
+				for (int value_index = 0; value_index < first_child_count; ++value_index)
+					string_result->PushString(p_first_child_value->StringAtIndex(value_index, operator_token) + singleton_string);
+				
+				result_SP = std::move(string_result_SP);
 			}
-			else
+			else	// if ((first_child_count != second_child_count) && (first_child_count != 1) && (second_child_count != 1))
 			{
-				if (first_child_count == second_child_count)
-				{
-					EidosValue_String_vector_SP string_result_SP = EidosValue_String_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String_vector());
-					EidosValue_String_vector *string_result = string_result_SP->Reserve(first_child_count);
-					
-					for (int value_index = 0; value_index < first_child_count; ++value_index)
-						string_result->PushString(first_child_value->StringAtIndex(value_index, operator_token) + second_child_value->StringAtIndex(value_index, operator_token));
-					
-					result_SP = std::move(string_result_SP);
-				}
-				else if (first_child_count == 1)
-				{
-					std::string singleton_string = (first_child_type == EidosValueType::kValueNULL) ? gEidosStr_NULL : first_child_value->StringAtIndex(0, operator_token);
-					EidosValue_String_vector_SP string_result_SP = EidosValue_String_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String_vector());
-					EidosValue_String_vector *string_result = string_result_SP->Reserve(second_child_count);
-					
-					for (int value_index = 0; value_index < second_child_count; ++value_index)
-						string_result->PushString(singleton_string + second_child_value->StringAtIndex(value_index, operator_token));
-					
-					result_SP = std::move(string_result_SP);
-				}
-				else if (second_child_count == 1)
-				{
-					std::string singleton_string = (second_child_type == EidosValueType::kValueNULL) ? gEidosStr_NULL : second_child_value->StringAtIndex(0, operator_token);
-					EidosValue_String_vector_SP string_result_SP = EidosValue_String_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String_vector());
-					EidosValue_String_vector *string_result = string_result_SP->Reserve(first_child_count);
-					
-					for (int value_index = 0; value_index < first_child_count; ++value_index)
-						string_result->PushString(first_child_value->StringAtIndex(value_index, operator_token) + singleton_string);
-					
-					result_SP = std::move(string_result_SP);
-				}
-				else	// if ((first_child_count != second_child_count) && (first_child_count != 1) && (second_child_count != 1))
-				{
-					EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Plus): the string concatenation '+' operator requires that either (1) both operands have the same size(), or (2) one operand has size() == 1, or (3) one operand is NULL." << EidosTerminate(operator_token);
-				}
+				EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Plus): the string concatenation '+' operator requires that either (1) both operands have the same size(), or (2) one operand has size() == 1, or (3) one operand is NULL." << EidosTerminate(operator_token);
 			}
 		}
-		else if ((first_child_type == EidosValueType::kValueInt) && (second_child_type == EidosValueType::kValueInt))
+	}
+	else if ((first_child_type == EidosValueType::kValueInt) && (second_child_type == EidosValueType::kValueInt))
+	{
+		// both operands are integer, so we are computing an integer result, which entails overflow testing
+		if (first_child_count == second_child_count)
 		{
-			// both operands are integer, so we are computing an integer result, which entails overflow testing
-			if (first_child_count == second_child_count)
-			{
-				if (first_child_count == 1)
-				{
-					// This is an overflow-safe version of:
-					//result = new (gEidosValuePool->AllocateChunk()) EidosValue_Int_singleton(first_child_value->IntAtIndex(0, operator_token) + second_child_value->IntAtIndex(0, operator_token));
-					
-					int64_t first_operand = first_child_value->IntAtIndex(0, operator_token);
-					int64_t second_operand = second_child_value->IntAtIndex(0, operator_token);
-					int64_t add_result;
-					bool overflow = Eidos_add_overflow(first_operand, second_operand, &add_result);
-					
-					if (overflow)
-						EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Plus): integer addition overflow with the binary '+' operator." << EidosTerminate(operator_token);
-					
-					result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int_singleton(add_result));
-				}
-				else
-				{
-					const int64_t *first_child_data = first_child_value->IntVector()->data();
-					const int64_t *second_child_data = second_child_value->IntVector()->data();
-					EidosValue_Int_vector_SP int_result_SP = EidosValue_Int_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int_vector());
-					EidosValue_Int_vector *int_result = int_result_SP->resize_no_initialize(first_child_count);
-					
-					for (int value_index = 0; value_index < first_child_count; ++value_index)
-					{
-						// This is an overflow-safe version of:
-						//int_result->set_int_no_check(first_child_value->IntAtIndex(value_index, operator_token) + second_child_value->IntAtIndex(value_index, operator_token));
-						
-						int64_t first_operand = first_child_data[value_index];
-						int64_t second_operand = second_child_data[value_index];
-						int64_t add_result;
-						bool overflow = Eidos_add_overflow(first_operand, second_operand, &add_result);
-						
-						if (overflow)
-							EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Plus): integer addition overflow with the binary '+' operator." << EidosTerminate(operator_token);
-						
-						int_result->set_int_no_check(add_result, value_index);
-					}
-					
-					result_SP = std::move(int_result_SP);
-				}
-			}
-			else if (first_child_count == 1)
+			if (first_child_count == 1)
 			{
-				int64_t singleton_int = first_child_value->IntAtIndex(0, operator_token);
-				const int64_t *second_child_data = second_child_value->IntVector()->data();
-				EidosValue_Int_vector_SP int_result_SP = EidosValue_Int_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int_vector());
-				EidosValue_Int_vector *int_result = int_result_SP->resize_no_initialize(second_child_count);
+				// This is an overflow-safe version of:
+				//result = new (gEidosValuePool->AllocateChunk()) EidosValue_Int_singleton(p_first_child_value->IntAtIndex(0, operator_token) + p_second_child_value->IntAtIndex(0, operator_token));
 				
-				for (int value_index = 0; value_index < second_child_count; ++value_index)
-				{
-					// This is an overflow-safe version of:
-					//int_result->PushInt(singleton_int + second_child_value->IntAtIndex(value_index, operator_token));
-					
-					int64_t second_operand = second_child_data[value_index];
-					int64_t add_result;
-					bool overflow = Eidos_add_overflow(singleton_int, second_operand, &add_result);
-					
-					if (overflow)
-						EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Plus): integer addition overflow with the binary '+' operator." << EidosTerminate(operator_token);
-					
-					int_result->set_int_no_check(add_result, value_index);
-				}
+				int64_t first_operand = p_first_child_value->IntAtIndex(0, operator_token);
+				int64_t second_operand = p_second_child_value->IntAtIndex(0, operator_token);
+				int64_t add_result;
+				bool overflow = Eidos_add_overflow(first_operand, second_operand, &add_result);
 				
-				result_SP = std::move(int_result_SP);
+				if (overflow)
+					EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Plus): integer addition overflow with the binary '+' operator." << EidosTerminate(operator_token);
+				
+				result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int_singleton(add_result));
 			}
-			else if (second_child_count == 1)
+			else
 			{
-				const int64_t *first_child_data = first_child_value->IntVector()->data();
-				int64_t singleton_int = second_child_value->IntAtIndex(0, operator_token);
+				const int64_t *first_child_data = p_first_child_value->IntVector()->data();
+				const int64_t *second_child_data = p_second_child_value->IntVector()->data();
 				EidosValue_Int_vector_SP int_result_SP = EidosValue_Int_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int_vector());
 				EidosValue_Int_vector *int_result = int_result_SP->resize_no_initialize(first_child_count);
 				
 				for (int value_index = 0; value_index < first_child_count; ++value_index)
 				{
 					// This is an overflow-safe version of:
-					//int_result->PushInt(first_child_value->IntAtIndex(value_index, operator_token) + singleton_int);
+					//int_result->set_int_no_check(p_first_child_value->IntAtIndex(value_index, operator_token) + p_second_child_value->IntAtIndex(value_index, operator_token));
 					
 					int64_t first_operand = first_child_data[value_index];
+					int64_t second_operand = second_child_data[value_index];
 					int64_t add_result;
-					bool overflow = Eidos_add_overflow(first_operand, singleton_int, &add_result);
+					bool overflow = Eidos_add_overflow(first_operand, second_operand, &add_result);
 					
 					if (overflow)
 						EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Plus): integer addition overflow with the binary '+' operator." << EidosTerminate(operator_token);
@@ -2359,113 +2323,160 @@ EidosValue_SP EidosInterpreter::Evaluate_Plus(const EidosASTNode *p_node)
 				
 				result_SP = std::move(int_result_SP);
 			}
-			else	// if ((first_child_count != second_child_count) && (first_child_count != 1) && (second_child_count != 1))
-			{
-				EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Plus): the '+' operator requires that either (1) both operands have the same size(), or (2) one operand has size() == 1." << EidosTerminate(operator_token);
-			}
 		}
-		else
+		else if (first_child_count == 1)
 		{
-			if (((first_child_type != EidosValueType::kValueInt) && (first_child_type != EidosValueType::kValueFloat)) || ((second_child_type != EidosValueType::kValueInt) && (second_child_type != EidosValueType::kValueFloat)))
-				EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Plus): the combination of operand types " << first_child_type << " and " << second_child_type << " is not supported by the binary '+' operator." << EidosTerminate(operator_token);
+			int64_t singleton_int = p_first_child_value->IntAtIndex(0, operator_token);
+			const int64_t *second_child_data = p_second_child_value->IntVector()->data();
+			EidosValue_Int_vector_SP int_result_SP = EidosValue_Int_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int_vector());
+			EidosValue_Int_vector *int_result = int_result_SP->resize_no_initialize(second_child_count);
 			
-			// We have at least one float operand, so we are computing a float result
-			if (first_child_count == second_child_count)
+			for (int value_index = 0; value_index < second_child_count; ++value_index)
 			{
-				if (first_child_count == 1)
-				{
-					result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(first_child_value->FloatAtIndex(0, operator_token) + second_child_value->FloatAtIndex(0, operator_token)));
-				}
-				else
-				{
-					EidosValue_Float_vector_SP float_result_SP = EidosValue_Float_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector());
-					EidosValue_Float_vector *float_result = float_result_SP->resize_no_initialize(first_child_count);
-					
-					if ((first_child_type == EidosValueType::kValueFloat) && (second_child_type == EidosValueType::kValueFloat))
-					{
-						const double *first_child_data = first_child_value->FloatVector()->data();
-						const double *second_child_data = second_child_value->FloatVector()->data();
-						
-						for (int value_index = 0; value_index < first_child_count; ++value_index)
-							float_result->set_float_no_check(first_child_data[value_index] + second_child_data[value_index], value_index);
-					}
-					else if ((first_child_type == EidosValueType::kValueFloat) && (second_child_type == EidosValueType::kValueInt))
-					{
-						const double *first_child_data = first_child_value->FloatVector()->data();
-						const int64_t *second_child_data = second_child_value->IntVector()->data();
-						
-						for (int value_index = 0; value_index < first_child_count; ++value_index)
-							float_result->set_float_no_check(first_child_data[value_index] + second_child_data[value_index], value_index);
-					}
-					else // ((first_child_type == EidosValueType::kValueInt) && (second_child_type == EidosValueType::kValueFloat))
-					{
-						const int64_t *first_child_data = first_child_value->IntVector()->data();
-						const double *second_child_data = second_child_value->FloatVector()->data();
-						
-						for (int value_index = 0; value_index < first_child_count; ++value_index)
-							float_result->set_float_no_check(first_child_data[value_index] + second_child_data[value_index], value_index);
-					}
-					
-					result_SP = std::move(float_result_SP);
-				}
+				// This is an overflow-safe version of:
+				//int_result->PushInt(singleton_int + p_second_child_value->IntAtIndex(value_index, operator_token));
+				
+				int64_t second_operand = second_child_data[value_index];
+				int64_t add_result;
+				bool overflow = Eidos_add_overflow(singleton_int, second_operand, &add_result);
+				
+				if (overflow)
+					EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Plus): integer addition overflow with the binary '+' operator." << EidosTerminate(operator_token);
+				
+				int_result->set_int_no_check(add_result, value_index);
 			}
-			else if (first_child_count == 1)
+			
+			result_SP = std::move(int_result_SP);
+		}
+		else if (second_child_count == 1)
+		{
+			const int64_t *first_child_data = p_first_child_value->IntVector()->data();
+			int64_t singleton_int = p_second_child_value->IntAtIndex(0, operator_token);
+			EidosValue_Int_vector_SP int_result_SP = EidosValue_Int_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int_vector());
+			EidosValue_Int_vector *int_result = int_result_SP->resize_no_initialize(first_child_count);
+			
+			for (int value_index = 0; value_index < first_child_count; ++value_index)
 			{
-				double singleton_float = first_child_value->FloatAtIndex(0, operator_token);
-				EidosValue_Float_vector_SP float_result_SP = EidosValue_Float_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector());
-				EidosValue_Float_vector *float_result = float_result_SP->resize_no_initialize(second_child_count);
+				// This is an overflow-safe version of:
+				//int_result->PushInt(p_first_child_value->IntAtIndex(value_index, operator_token) + singleton_int);
 				
-				if (second_child_type == EidosValueType::kValueInt)
-				{
-					const int64_t *second_child_data = second_child_value->IntVector()->data();
-					
-					for (int value_index = 0; value_index < second_child_count; ++value_index)
-						float_result->set_float_no_check(singleton_float + second_child_data[value_index], value_index);
-				}
-				else	// (second_child_type == EidosValueType::kValueFloat)
-				{
-					const double *second_child_data = second_child_value->FloatVector()->data();
-					
-					for (int value_index = 0; value_index < second_child_count; ++value_index)
-						float_result->set_float_no_check(singleton_float + second_child_data[value_index], value_index);
-				}
+				int64_t first_operand = first_child_data[value_index];
+				int64_t add_result;
+				bool overflow = Eidos_add_overflow(first_operand, singleton_int, &add_result);
 				
-				result_SP = std::move(float_result_SP);
+				if (overflow)
+					EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Plus): integer addition overflow with the binary '+' operator." << EidosTerminate(operator_token);
+				
+				int_result->set_int_no_check(add_result, value_index);
 			}
-			else if (second_child_count == 1)
+			
+			result_SP = std::move(int_result_SP);
+		}
+		else	// if ((first_child_count != second_child_count) && (first_child_count != 1) && (second_child_count != 1))
+		{
+			EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Plus): the '+' operator requires that either (1) both operands have the same size(), or (2) one operand has size() == 1." << EidosTerminate(operator_token);
+		}
+	}
+	else
+	{
+		if (((first_child_type != EidosValueType::kValueInt) && (first_child_type != EidosValueType::kValueFloat)) || ((second_child_type != EidosValueType::kValueInt) && (second_child_type != EidosValueType::kValueFloat)))
+			EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Plus): the combination of operand types " << first_child_type << " and " << second_child_type << " is not supported by the binary '+' operator." << EidosTerminate(operator_token);
+		
+		// We have at least one float operand, so we are computing a float result
+		if (first_child_count == second_child_count)
+		{
+			if (first_child_count == 1)
+			{
+				result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(p_first_child_value->FloatAtIndex(0, operator_token) + p_second_child_value->FloatAtIndex(0, operator_token)));
+			}
+			else
 			{
-				double singleton_float = second_child_value->FloatAtIndex(0, operator_token);
 				EidosValue_Float_vector_SP float_result_SP = EidosValue_Float_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector());
 				EidosValue_Float_vector *float_result = float_result_SP->resize_no_initialize(first_child_count);
 				
-				if (first_child_type == EidosValueType::kValueInt)
+				if ((first_child_type == EidosValueType::kValueFloat) && (second_child_type == EidosValueType::kValueFloat))
 				{
-					const int64_t *first_child_data = first_child_value->IntVector()->data();
+					const double *first_child_data = p_first_child_value->FloatVector()->data();
+					const double *second_child_data = p_second_child_value->FloatVector()->data();
 					
 					for (int value_index = 0; value_index < first_child_count; ++value_index)
-						float_result->set_float_no_check(first_child_data[value_index] + singleton_float, value_index);
+						float_result->set_float_no_check(first_child_data[value_index] + second_child_data[value_index], value_index);
 				}
-				else	// (first_child_type == EidosValueType::kValueFloat)
+				else if ((first_child_type == EidosValueType::kValueFloat) && (second_child_type == EidosValueType::kValueInt))
 				{
-					const double *first_child_data = first_child_value->FloatVector()->data();
+					const double *first_child_data = p_first_child_value->FloatVector()->data();
+					const int64_t *second_child_data = p_second_child_value->IntVector()->data();
 					
 					for (int value_index = 0; value_index < first_child_count; ++value_index)
-						float_result->set_float_no_check(first_child_data[value_index] + singleton_float, value_index);
+						float_result->set_float_no_check(first_child_data[value_index] + second_child_data[value_index], value_index);
+				}
+				else // ((first_child_type == EidosValueType::kValueInt) && (second_child_type == EidosValueType::kValueFloat))
+				{
+					const int64_t *first_child_data = p_first_child_value->IntVector()->data();
+					const double *second_child_data = p_second_child_value->FloatVector()->data();
+					
+					for (int value_index = 0; value_index < first_child_count; ++value_index)
+						float_result->set_float_no_check(first_child_data[value_index] + second_child_data[value_index], value_index);
 				}
 				
 				result_SP = std::move(float_result_SP);
 			}
-			else	// if ((first_child_count != second_child_count) && (first_child_count != 1) && (second_child_count != 1))
+		}
+		else if (first_child_count == 1)
+		{
+			double singleton_float = p_first_child_value->FloatAtIndex(0, operator_token);
+			EidosValue_Float_vector_SP float_result_SP = EidosValue_Float_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector());
+			EidosValue_Float_vector *float_result = float_result_SP->resize_no_initialize(second_child_count);
+			
+			if (second_child_type == EidosValueType::kValueInt)
 			{
-				EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Plus): the '+' operator requires that either (1) both operands have the same size(), or (2) one operand has size() == 1." << EidosTerminate(operator_token);
+				const int64_t *second_child_data = p_second_child_value->IntVector()->data();
+				
+				for (int value_index = 0; value_index < second_child_count; ++value_index)
+					float_result->set_float_no_check(singleton_float + second_child_data[value_index], value_index);
+			}
+			else	// (second_child_type == EidosValueType::kValueFloat)
+			{
+				const double *second_child_data = p_second_child_value->FloatVector()->data();
+				
+				for (int value_index = 0; value_index < second_child_count; ++value_index)
+					float_result->set_float_no_check(singleton_float + second_child_data[value_index], value_index);
 			}
+			
+			result_SP = std::move(float_result_SP);
+		}
+		else if (second_child_count == 1)
+		{
+			double singleton_float = p_second_child_value->FloatAtIndex(0, operator_token);
+			EidosValue_Float_vector_SP float_result_SP = EidosValue_Float_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector());
+			EidosValue_Float_vector *float_result = float_result_SP->resize_no_initialize(first_child_count);
+			
+			if (first_child_type == EidosValueType::kValueInt)
+			{
+				const int64_t *first_child_data = p_first_child_value->IntVector()->data();
+				
+				for (int value_index = 0; value_index < first_child_count; ++value_index)
+					float_result->set_float_no_check(first_child_data[value_index] + singleton_float, value_index);
+			}
+			else	// (first_child_type == EidosValueType::kValueFloat)
+			{
+				const double *first_child_data = p_first_child_value->FloatVector()->data();
+				
+				for (int value_index = 0; value_index < first_child_count; ++value_index)
+					float_result->set_float_no_check(first_child_data[value_index] + singleton_float, value_index);
+			}
+			
+			result_SP = std::move(float_result_SP);
+		}
+		else	// if ((first_child_count != second_child_count) && (first_child_count != 1) && (second_child_count != 1))
+		{
+			EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Plus): the '+' operator requires that either (1) both operands have the same size(), or (2) one operand has size() == 1." << EidosTerminate(operator_token);
 		}
-		
-		// Copy dimensions from whichever operand we chose at the beginning
-		result_SP->CopyDimensionsFromValue(result_dim_source.get());
 	}
 	
-	EIDOS_EXIT_EXECUTION_LOG("Evaluate_Plus()");
+	// Copy dimensions from whichever operand we chose at the beginning
+	result_SP->CopyDimensionsFromValue(result_dim_source.get());
+	
 	return result_SP;
 }
 
@@ -2553,106 +2564,77 @@ EidosValue_SP EidosInterpreter::Evaluate_Minus(const EidosASTNode *p_node)
 	{
 		// binary minus
 		EidosValue_SP second_child_value = FastEvaluateNode(p_node->children_[1]);
-		EidosValueType second_child_type = second_child_value->Type();
-		
-		if ((second_child_type != EidosValueType::kValueInt) && (second_child_type != EidosValueType::kValueFloat))
-			EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Minus): operand type " << second_child_type << " is not supported by the '-' operator." << EidosTerminate(operator_token);
-		
-		int second_child_count = second_child_value->Count();
 		
-		// matrices/arrays must be conformable, and we need to decide here which operand's dimensionality will be used for the result
-		int first_child_dimcount = first_child_value->DimensionCount();
-		int second_child_dimcount = second_child_value->DimensionCount();
-		EidosValue_SP result_dim_source(EidosValue::BinaryOperationDimensionSource(first_child_value.get(), second_child_value.get()));
-		
-		if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(first_child_value.get(), second_child_value.get()))
-			EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Minus): non-conformable array operands to binary '-' operator." << EidosTerminate(operator_token);
-		
-		if ((first_child_type == EidosValueType::kValueInt) && (second_child_type == EidosValueType::kValueInt))
+		result_SP = _Evaluate_Minus_Internal(p_node, std::move(first_child_value), std::move(second_child_value));
+	}
+	
+	EIDOS_EXIT_EXECUTION_LOG("Evaluate_Minus()");
+	return result_SP;
+}
+
+EidosValue_SP EidosInterpreter::_Evaluate_Minus_Internal(const EidosASTNode *p_node, EidosValue_SP p_first_child_value, EidosValue_SP p_second_child_value)
+{
+	EidosToken *operator_token = p_node->token_;
+	EidosValue_SP result_SP;
+	
+	EidosValueType first_child_type = p_first_child_value->Type();
+	
+	if ((first_child_type != EidosValueType::kValueInt) && (first_child_type != EidosValueType::kValueFloat))
+		EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Minus): operand type " << first_child_type << " is not supported by the '-' operator." << EidosTerminate(operator_token);
+	
+	int first_child_count = p_first_child_value->Count();
+	
+	EidosValueType second_child_type = p_second_child_value->Type();
+	
+	if ((second_child_type != EidosValueType::kValueInt) && (second_child_type != EidosValueType::kValueFloat))
+		EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Minus): operand type " << second_child_type << " is not supported by the '-' operator." << EidosTerminate(operator_token);
+	
+	int second_child_count = p_second_child_value->Count();
+	
+	// matrices/arrays must be conformable, and we need to decide here which operand's dimensionality will be used for the result
+	int first_child_dimcount = p_first_child_value->DimensionCount();
+	int second_child_dimcount = p_second_child_value->DimensionCount();
+	EidosValue_SP result_dim_source(EidosValue::BinaryOperationDimensionSource(p_first_child_value.get(), p_second_child_value.get()));
+	
+	if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(p_first_child_value.get(), p_second_child_value.get()))
+		EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Minus): non-conformable array operands to binary '-' operator." << EidosTerminate(operator_token);
+	
+	if ((first_child_type == EidosValueType::kValueInt) && (second_child_type == EidosValueType::kValueInt))
+	{
+		// both operands are integer, so we are computing an integer result, which entails overflow testing
+		if (first_child_count == second_child_count)
 		{
-			// both operands are integer, so we are computing an integer result, which entails overflow testing
-			if (first_child_count == second_child_count)
-			{
-				if (first_child_count == 1)
-				{
-					// This is an overflow-safe version of:
-					//result = new (gEidosValuePool->AllocateChunk()) EidosValue_Int_singleton(first_child_value->IntAtIndex(0, operator_token) - second_child_value->IntAtIndex(0, operator_token));
-					
-					int64_t first_operand = first_child_value->IntAtIndex(0, operator_token);
-					int64_t second_operand = second_child_value->IntAtIndex(0, operator_token);
-					int64_t subtract_result;
-					bool overflow = Eidos_sub_overflow(first_operand, second_operand, &subtract_result);
-					
-					if (overflow)
-						EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Minus): integer subtraction overflow with the binary '-' operator." << EidosTerminate(operator_token);
-					
-					result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int_singleton(subtract_result));
-				}
-				else
-				{
-					const int64_t *first_child_data = first_child_value->IntVector()->data();
-					const int64_t *second_child_data = second_child_value->IntVector()->data();
-					EidosValue_Int_vector_SP int_result_SP = EidosValue_Int_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int_vector());
-					EidosValue_Int_vector *int_result = int_result_SP->resize_no_initialize(first_child_count);
-					
-					for (int value_index = 0; value_index < first_child_count; ++value_index)
-					{
-						// This is an overflow-safe version of:
-						//int_result->set_int_no_check(first_child_value->IntAtIndex(value_index, operator_token) - second_child_value->IntAtIndex(value_index, operator_token));
-						
-						int64_t first_operand = first_child_data[value_index];
-						int64_t second_operand = second_child_data[value_index];
-						int64_t subtract_result;
-						bool overflow = Eidos_sub_overflow(first_operand, second_operand, &subtract_result);
-						
-						if (overflow)
-							EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Minus): integer subtraction overflow with the binary '-' operator." << EidosTerminate(operator_token);
-						
-						int_result->set_int_no_check(subtract_result, value_index);
-					}
-					
-					result_SP = std::move(int_result_SP);
-				}
-			}
-			else if (first_child_count == 1)
+			if (first_child_count == 1)
 			{
-				int64_t singleton_int = first_child_value->IntAtIndex(0, operator_token);
-				const int64_t *second_child_data = second_child_value->IntVector()->data();
-				EidosValue_Int_vector_SP int_result_SP = EidosValue_Int_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int_vector());
-				EidosValue_Int_vector *int_result = int_result_SP->resize_no_initialize(second_child_count);
+				// This is an overflow-safe version of:
+				//result = new (gEidosValuePool->AllocateChunk()) EidosValue_Int_singleton(p_first_child_value->IntAtIndex(0, operator_token) - p_second_child_value->IntAtIndex(0, operator_token));
 				
-				for (int value_index = 0; value_index < second_child_count; ++value_index)
-				{
-					// This is an overflow-safe version of:
-					//int_result->set_int_no_check(singleton_int - second_child_value->IntAtIndex(value_index, operator_token));
-					
-					int64_t second_operand = second_child_data[value_index];
-					int64_t subtract_result;
-					bool overflow = Eidos_sub_overflow(singleton_int, second_operand, &subtract_result);
-					
-					if (overflow)
-						EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Minus): integer subtraction overflow with the binary '-' operator." << EidosTerminate(operator_token);
-					
-					int_result->set_int_no_check(subtract_result, value_index);
-				}
+				int64_t first_operand = p_first_child_value->IntAtIndex(0, operator_token);
+				int64_t second_operand = p_second_child_value->IntAtIndex(0, operator_token);
+				int64_t subtract_result;
+				bool overflow = Eidos_sub_overflow(first_operand, second_operand, &subtract_result);
 				
-				result_SP = std::move(int_result_SP);
+				if (overflow)
+					EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Minus): integer subtraction overflow with the binary '-' operator." << EidosTerminate(operator_token);
+				
+				result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int_singleton(subtract_result));
 			}
-			else if (second_child_count == 1)
+			else
 			{
-				const int64_t *first_child_data = first_child_value->IntVector()->data();
-				int64_t singleton_int = second_child_value->IntAtIndex(0, operator_token);
+				const int64_t *first_child_data = p_first_child_value->IntVector()->data();
+				const int64_t *second_child_data = p_second_child_value->IntVector()->data();
 				EidosValue_Int_vector_SP int_result_SP = EidosValue_Int_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int_vector());
 				EidosValue_Int_vector *int_result = int_result_SP->resize_no_initialize(first_child_count);
 				
 				for (int value_index = 0; value_index < first_child_count; ++value_index)
 				{
 					// This is an overflow-safe version of:
-					//int_result->set_int_no_check(first_child_value->IntAtIndex(value_index, operator_token) - singleton_int);
+					//int_result->set_int_no_check(p_first_child_value->IntAtIndex(value_index, operator_token) - p_second_child_value->IntAtIndex(value_index, operator_token));
 					
 					int64_t first_operand = first_child_data[value_index];
+					int64_t second_operand = second_child_data[value_index];
 					int64_t subtract_result;
-					bool overflow = Eidos_sub_overflow(first_operand, singleton_int, &subtract_result);
+					bool overflow = Eidos_sub_overflow(first_operand, second_operand, &subtract_result);
 					
 					if (overflow)
 						EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Minus): integer subtraction overflow with the binary '-' operator." << EidosTerminate(operator_token);
@@ -2662,110 +2644,157 @@ EidosValue_SP EidosInterpreter::Evaluate_Minus(const EidosASTNode *p_node)
 				
 				result_SP = std::move(int_result_SP);
 			}
-			else	// if ((first_child_count != second_child_count) && (first_child_count != 1) && (second_child_count != 1))
-			{
-				EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Minus): the '-' operator requires that either (1) both operands have the same size(), or (2) one operand has size() == 1." << EidosTerminate(operator_token);
-			}
 		}
-		else
+		else if (first_child_count == 1)
 		{
-			// We have at least one float operand, so we are computing a float result
-			if (first_child_count == second_child_count)
+			int64_t singleton_int = p_first_child_value->IntAtIndex(0, operator_token);
+			const int64_t *second_child_data = p_second_child_value->IntVector()->data();
+			EidosValue_Int_vector_SP int_result_SP = EidosValue_Int_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int_vector());
+			EidosValue_Int_vector *int_result = int_result_SP->resize_no_initialize(second_child_count);
+			
+			for (int value_index = 0; value_index < second_child_count; ++value_index)
 			{
-				if (first_child_count == 1)
-				{
-					result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(first_child_value->FloatAtIndex(0, operator_token) - second_child_value->FloatAtIndex(0, operator_token)));
-				}
-				else
-				{
-					EidosValue_Float_vector_SP float_result_SP = EidosValue_Float_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector());
-					EidosValue_Float_vector *float_result = float_result_SP->resize_no_initialize(first_child_count);
-					
-					if ((first_child_type == EidosValueType::kValueFloat) && (second_child_type == EidosValueType::kValueFloat))
-					{
-						const double *first_child_data = first_child_value->FloatVector()->data();
-						const double *second_child_data = second_child_value->FloatVector()->data();
-						
-						for (int value_index = 0; value_index < first_child_count; ++value_index)
-							float_result->set_float_no_check(first_child_data[value_index] - second_child_data[value_index], value_index);
-					}
-					else if ((first_child_type == EidosValueType::kValueFloat) && (second_child_type == EidosValueType::kValueInt))
-					{
-						const double *first_child_data = first_child_value->FloatVector()->data();
-						const int64_t *second_child_data = second_child_value->IntVector()->data();
-						
-						for (int value_index = 0; value_index < first_child_count; ++value_index)
-							float_result->set_float_no_check(first_child_data[value_index] - second_child_data[value_index], value_index);
-					}
-					else // ((first_child_type == EidosValueType::kValueInt) && (second_child_type == EidosValueType::kValueFloat))
-					{
-						const int64_t *first_child_data = first_child_value->IntVector()->data();
-						const double *second_child_data = second_child_value->FloatVector()->data();
-						
-						for (int value_index = 0; value_index < first_child_count; ++value_index)
-							float_result->set_float_no_check(first_child_data[value_index] - second_child_data[value_index], value_index);
-					}
-					
-					result_SP = std::move(float_result_SP);
-				}
+				// This is an overflow-safe version of:
+				//int_result->set_int_no_check(singleton_int - p_second_child_value->IntAtIndex(value_index, operator_token));
+				
+				int64_t second_operand = second_child_data[value_index];
+				int64_t subtract_result;
+				bool overflow = Eidos_sub_overflow(singleton_int, second_operand, &subtract_result);
+				
+				if (overflow)
+					EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Minus): integer subtraction overflow with the binary '-' operator." << EidosTerminate(operator_token);
+				
+				int_result->set_int_no_check(subtract_result, value_index);
 			}
-			else if (first_child_count == 1)
+			
+			result_SP = std::move(int_result_SP);
+		}
+		else if (second_child_count == 1)
+		{
+			const int64_t *first_child_data = p_first_child_value->IntVector()->data();
+			int64_t singleton_int = p_second_child_value->IntAtIndex(0, operator_token);
+			EidosValue_Int_vector_SP int_result_SP = EidosValue_Int_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int_vector());
+			EidosValue_Int_vector *int_result = int_result_SP->resize_no_initialize(first_child_count);
+			
+			for (int value_index = 0; value_index < first_child_count; ++value_index)
 			{
-				double singleton_float = first_child_value->FloatAtIndex(0, operator_token);
-				EidosValue_Float_vector_SP float_result_SP = EidosValue_Float_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector());
-				EidosValue_Float_vector *float_result = float_result_SP->resize_no_initialize(second_child_count);
+				// This is an overflow-safe version of:
+				//int_result->set_int_no_check(p_first_child_value->IntAtIndex(value_index, operator_token) - singleton_int);
 				
-				if (second_child_type == EidosValueType::kValueInt)
-				{
-					const int64_t *second_child_data = second_child_value->IntVector()->data();
-					
-					for (int value_index = 0; value_index < second_child_count; ++value_index)
-						float_result->set_float_no_check(singleton_float - second_child_data[value_index], value_index);
-				}
-				else	// (second_child_type == EidosValueType::kValueFloat)
-				{
-					const double *second_child_data = second_child_value->FloatVector()->data();
-					
-					for (int value_index = 0; value_index < second_child_count; ++value_index)
-						float_result->set_float_no_check(singleton_float - second_child_data[value_index], value_index);
-				}
+				int64_t first_operand = first_child_data[value_index];
+				int64_t subtract_result;
+				bool overflow = Eidos_sub_overflow(first_operand, singleton_int, &subtract_result);
 				
-				result_SP = std::move(float_result_SP);
+				if (overflow)
+					EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Minus): integer subtraction overflow with the binary '-' operator." << EidosTerminate(operator_token);
+				
+				int_result->set_int_no_check(subtract_result, value_index);
+			}
+			
+			result_SP = std::move(int_result_SP);
+		}
+		else	// if ((first_child_count != second_child_count) && (first_child_count != 1) && (second_child_count != 1))
+		{
+			EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Minus): the '-' operator requires that either (1) both operands have the same size(), or (2) one operand has size() == 1." << EidosTerminate(operator_token);
+		}
+	}
+	else
+	{
+		// We have at least one float operand, so we are computing a float result
+		if (first_child_count == second_child_count)
+		{
+			if (first_child_count == 1)
+			{
+				result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(p_first_child_value->FloatAtIndex(0, operator_token) - p_second_child_value->FloatAtIndex(0, operator_token)));
 			}
-			else if (second_child_count == 1)
+			else
 			{
-				double singleton_float = second_child_value->FloatAtIndex(0, operator_token);
 				EidosValue_Float_vector_SP float_result_SP = EidosValue_Float_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector());
 				EidosValue_Float_vector *float_result = float_result_SP->resize_no_initialize(first_child_count);
 				
-				if (first_child_type == EidosValueType::kValueInt)
+				if ((first_child_type == EidosValueType::kValueFloat) && (second_child_type == EidosValueType::kValueFloat))
 				{
-					const int64_t *first_child_data = first_child_value->IntVector()->data();
+					const double *first_child_data = p_first_child_value->FloatVector()->data();
+					const double *second_child_data = p_second_child_value->FloatVector()->data();
 					
 					for (int value_index = 0; value_index < first_child_count; ++value_index)
-						float_result->set_float_no_check(first_child_data[value_index] - singleton_float, value_index);
+						float_result->set_float_no_check(first_child_data[value_index] - second_child_data[value_index], value_index);
 				}
-				else	// (first_child_type == EidosValueType::kValueFloat)
+				else if ((first_child_type == EidosValueType::kValueFloat) && (second_child_type == EidosValueType::kValueInt))
 				{
-					const double *first_child_data = first_child_value->FloatVector()->data();
+					const double *first_child_data = p_first_child_value->FloatVector()->data();
+					const int64_t *second_child_data = p_second_child_value->IntVector()->data();
+					
+					for (int value_index = 0; value_index < first_child_count; ++value_index)
+						float_result->set_float_no_check(first_child_data[value_index] - second_child_data[value_index], value_index);
+				}
+				else // ((first_child_type == EidosValueType::kValueInt) && (second_child_type == EidosValueType::kValueFloat))
+				{
+					const int64_t *first_child_data = p_first_child_value->IntVector()->data();
+					const double *second_child_data = p_second_child_value->FloatVector()->data();
 					
 					for (int value_index = 0; value_index < first_child_count; ++value_index)
-						float_result->set_float_no_check(first_child_data[value_index] - singleton_float, value_index);
+						float_result->set_float_no_check(first_child_data[value_index] - second_child_data[value_index], value_index);
 				}
 				
 				result_SP = std::move(float_result_SP);
 			}
-			else	// if ((first_child_count != second_child_count) && (first_child_count != 1) && (second_child_count != 1))
+		}
+		else if (first_child_count == 1)
+		{
+			double singleton_float = p_first_child_value->FloatAtIndex(0, operator_token);
+			EidosValue_Float_vector_SP float_result_SP = EidosValue_Float_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector());
+			EidosValue_Float_vector *float_result = float_result_SP->resize_no_initialize(second_child_count);
+			
+			if (second_child_type == EidosValueType::kValueInt)
+			{
+				const int64_t *second_child_data = p_second_child_value->IntVector()->data();
+				
+				for (int value_index = 0; value_index < second_child_count; ++value_index)
+					float_result->set_float_no_check(singleton_float - second_child_data[value_index], value_index);
+			}
+			else	// (second_child_type == EidosValueType::kValueFloat)
 			{
-				EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Minus): the '-' operator requires that either (1) both operands have the same size(), or (2) one operand has size() == 1." << EidosTerminate(operator_token);
+				const double *second_child_data = p_second_child_value->FloatVector()->data();
+				
+				for (int value_index = 0; value_index < second_child_count; ++value_index)
+					float_result->set_float_no_check(singleton_float - second_child_data[value_index], value_index);
 			}
+			
+			result_SP = std::move(float_result_SP);
+		}
+		else if (second_child_count == 1)
+		{
+			double singleton_float = p_second_child_value->FloatAtIndex(0, operator_token);
+			EidosValue_Float_vector_SP float_result_SP = EidosValue_Float_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector());
+			EidosValue_Float_vector *float_result = float_result_SP->resize_no_initialize(first_child_count);
+			
+			if (first_child_type == EidosValueType::kValueInt)
+			{
+				const int64_t *first_child_data = p_first_child_value->IntVector()->data();
+				
+				for (int value_index = 0; value_index < first_child_count; ++value_index)
+					float_result->set_float_no_check(first_child_data[value_index] - singleton_float, value_index);
+			}
+			else	// (first_child_type == EidosValueType::kValueFloat)
+			{
+				const double *first_child_data = p_first_child_value->FloatVector()->data();
+				
+				for (int value_index = 0; value_index < first_child_count; ++value_index)
+					float_result->set_float_no_check(first_child_data[value_index] - singleton_float, value_index);
+			}
+			
+			result_SP = std::move(float_result_SP);
+		}
+		else	// if ((first_child_count != second_child_count) && (first_child_count != 1) && (second_child_count != 1))
+		{
+			EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Minus): the '-' operator requires that either (1) both operands have the same size(), or (2) one operand has size() == 1." << EidosTerminate(operator_token);
 		}
-		
-		// Copy dimensions from whichever operand we chose at the beginning
-		result_SP->CopyDimensionsFromValue(result_dim_source.get());
 	}
 	
-	EIDOS_EXIT_EXECUTION_LOG("Evaluate_Minus()");
+	// Copy dimensions from whichever operand we chose at the beginning
+	result_SP->CopyDimensionsFromValue(result_dim_source.get());
+	
 	return result_SP;
 }
 
@@ -2773,13 +2802,21 @@ EidosValue_SP EidosInterpreter::Evaluate_Mod(const EidosASTNode *p_node)
 {
 	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_Mod()");
 	EIDOS_ASSERT_CHILD_COUNT("EidosInterpreter::Evaluate_Mod", 2);
-
-	EidosToken *operator_token = p_node->token_;
+	
 	EidosValue_SP first_child_value = FastEvaluateNode(p_node->children_[0]);
 	EidosValue_SP second_child_value = FastEvaluateNode(p_node->children_[1]);
+	EidosValue_SP result_SP = _Evaluate_Mod_Internal(p_node, std::move(first_child_value), std::move(second_child_value));
 	
-	EidosValueType first_child_type = first_child_value->Type();
-	EidosValueType second_child_type = second_child_value->Type();
+	EIDOS_EXIT_EXECUTION_LOG("Evaluate_Mod()");
+	return result_SP;
+}
+
+EidosValue_SP EidosInterpreter::_Evaluate_Mod_Internal(const EidosASTNode *p_node, EidosValue_SP p_first_child_value, EidosValue_SP p_second_child_value)
+{
+	EidosToken *operator_token = p_node->token_;
+	
+	EidosValueType first_child_type = p_first_child_value->Type();
+	EidosValueType second_child_type = p_second_child_value->Type();
 	
 	if ((first_child_type != EidosValueType::kValueInt) && (first_child_type != EidosValueType::kValueFloat))
 		EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Mod): operand type " << first_child_type << " is not supported by the '%' operator." << EidosTerminate(operator_token);
@@ -2787,15 +2824,15 @@ EidosValue_SP EidosInterpreter::Evaluate_Mod(const EidosASTNode *p_node)
 	if ((second_child_type != EidosValueType::kValueInt) && (second_child_type != EidosValueType::kValueFloat))
 		EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Mod): operand type " << second_child_type << " is not supported by the '%' operator." << EidosTerminate(operator_token);
 	
-	int first_child_count = first_child_value->Count();
-	int second_child_count = second_child_value->Count();
+	int first_child_count = p_first_child_value->Count();
+	int second_child_count = p_second_child_value->Count();
 	
 	// matrices/arrays must be conformable, and we need to decide here which operand's dimensionality will be used for the result
-	int first_child_dimcount = first_child_value->DimensionCount();
-	int second_child_dimcount = second_child_value->DimensionCount();
-	EidosValue_SP result_dim_source(EidosValue::BinaryOperationDimensionSource(first_child_value.get(), second_child_value.get()));
+	int first_child_dimcount = p_first_child_value->DimensionCount();
+	int second_child_dimcount = p_second_child_value->DimensionCount();
+	EidosValue_SP result_dim_source(EidosValue::BinaryOperationDimensionSource(p_first_child_value.get(), p_second_child_value.get()));
 	
-	if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(first_child_value.get(), second_child_value.get()))
+	if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(p_first_child_value.get(), p_second_child_value.get()))
 		EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Mod): non-conformable array operands to the '%' operator." << EidosTerminate(operator_token);
 	
 	EidosValue_SP result_SP;
@@ -2808,7 +2845,7 @@ EidosValue_SP EidosInterpreter::Evaluate_Mod(const EidosASTNode *p_node)
 	{
 		if (first_child_count == 1)
 		{
-			result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(fmod(first_child_value->FloatAtIndex(0, operator_token), second_child_value->FloatAtIndex(0, operator_token))));
+			result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(fmod(p_first_child_value->FloatAtIndex(0, operator_token), p_second_child_value->FloatAtIndex(0, operator_token))));
 		}
 		else
 		{
@@ -2817,32 +2854,32 @@ EidosValue_SP EidosInterpreter::Evaluate_Mod(const EidosASTNode *p_node)
 			
 			if ((first_child_type == EidosValueType::kValueFloat) && (second_child_type == EidosValueType::kValueFloat))
 			{
-				const double *first_child_data = first_child_value->FloatVector()->data();
-				const double *second_child_data = second_child_value->FloatVector()->data();
+				const double *first_child_data = p_first_child_value->FloatVector()->data();
+				const double *second_child_data = p_second_child_value->FloatVector()->data();
 				
 				for (int value_index = 0; value_index < first_child_count; ++value_index)
 					float_result->set_float_no_check(fmod(first_child_data[value_index], second_child_data[value_index]), value_index);
 			}
 			else if ((first_child_type == EidosValueType::kValueFloat) && (second_child_type == EidosValueType::kValueInt))
 			{
-				const double *first_child_data = first_child_value->FloatVector()->data();
-				const int64_t *second_child_data = second_child_value->IntVector()->data();
+				const double *first_child_data = p_first_child_value->FloatVector()->data();
+				const int64_t *second_child_data = p_second_child_value->IntVector()->data();
 				
 				for (int value_index = 0; value_index < first_child_count; ++value_index)
 					float_result->set_float_no_check(fmod(first_child_data[value_index], second_child_data[value_index]), value_index);
 			}
 			else if ((first_child_type == EidosValueType::kValueInt) && (second_child_type == EidosValueType::kValueFloat))
 			{
-				const int64_t *first_child_data = first_child_value->IntVector()->data();
-				const double *second_child_data = second_child_value->FloatVector()->data();
+				const int64_t *first_child_data = p_first_child_value->IntVector()->data();
+				const double *second_child_data = p_second_child_value->FloatVector()->data();
 				
 				for (int value_index = 0; value_index < first_child_count; ++value_index)
 					float_result->set_float_no_check(fmod(first_child_data[value_index], second_child_data[value_index]), value_index);
 			}
 			else // ((first_child_type == EidosValueType::kValueInt) && (second_child_type == EidosValueType::kValueInt))
 			{
-				const int64_t *first_child_data = first_child_value->IntVector()->data();
-				const int64_t *second_child_data = second_child_value->IntVector()->data();
+				const int64_t *first_child_data = p_first_child_value->IntVector()->data();
+				const int64_t *second_child_data = p_second_child_value->IntVector()->data();
 				
 				for (int value_index = 0; value_index < first_child_count; ++value_index)
 					float_result->set_float_no_check(fmod(first_child_data[value_index], second_child_data[value_index]), value_index);
@@ -2853,20 +2890,20 @@ EidosValue_SP EidosInterpreter::Evaluate_Mod(const EidosASTNode *p_node)
 	}
 	else if (first_child_count == 1)
 	{
-		double singleton_float = first_child_value->FloatAtIndex(0, operator_token);
+		double singleton_float = p_first_child_value->FloatAtIndex(0, operator_token);
 		EidosValue_Float_vector_SP float_result_SP = EidosValue_Float_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector());
 		EidosValue_Float_vector *float_result = float_result_SP->resize_no_initialize(second_child_count);
 		
 		if (second_child_type == EidosValueType::kValueInt)
 		{
-			const int64_t *second_child_data = second_child_value->IntVector()->data();
+			const int64_t *second_child_data = p_second_child_value->IntVector()->data();
 			
 			for (int value_index = 0; value_index < second_child_count; ++value_index)
 				float_result->set_float_no_check(fmod(singleton_float, second_child_data[value_index]), value_index);
 		}
 		else	// (second_child_type == EidosValueType::kValueFloat)
 		{
-			const double *second_child_data = second_child_value->FloatVector()->data();
+			const double *second_child_data = p_second_child_value->FloatVector()->data();
 			
 			for (int value_index = 0; value_index < second_child_count; ++value_index)
 				float_result->set_float_no_check(fmod(singleton_float, second_child_data[value_index]), value_index);
@@ -2876,20 +2913,20 @@ EidosValue_SP EidosInterpreter::Evaluate_Mod(const EidosASTNode *p_node)
 	}
 	else if (second_child_count == 1)
 	{
-		double singleton_float = second_child_value->FloatAtIndex(0, operator_token);
+		double singleton_float = p_second_child_value->FloatAtIndex(0, operator_token);
 		EidosValue_Float_vector_SP float_result_SP = EidosValue_Float_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector());
 		EidosValue_Float_vector *float_result = float_result_SP->resize_no_initialize(first_child_count);
 		
 		if (first_child_type == EidosValueType::kValueInt)
 		{
-			const int64_t *first_child_data = first_child_value->IntVector()->data();
+			const int64_t *first_child_data = p_first_child_value->IntVector()->data();
 			
 			for (int value_index = 0; value_index < first_child_count; ++value_index)
 				float_result->set_float_no_check(fmod(first_child_data[value_index], singleton_float), value_index);
 		}
 		else	// (first_child_type == EidosValueType::kValueFloat)
 		{
-			const double *first_child_data = first_child_value->FloatVector()->data();
+			const double *first_child_data = p_first_child_value->FloatVector()->data();
 			
 			for (int value_index = 0; value_index < first_child_count; ++value_index)
 				float_result->set_float_no_check(fmod(first_child_data[value_index], singleton_float), value_index);
@@ -2905,7 +2942,6 @@ EidosValue_SP EidosInterpreter::Evaluate_Mod(const EidosASTNode *p_node)
 	// Copy dimensions from whichever operand we chose at the beginning
 	result_SP->CopyDimensionsFromValue(result_dim_source.get());
 	
-	EIDOS_EXIT_EXECUTION_LOG("Evaluate_Mod()");
 	return result_SP;
 }
 
@@ -2913,13 +2949,21 @@ EidosValue_SP EidosInterpreter::Evaluate_Mult(const EidosASTNode *p_node)
 {
 	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_Mult()");
 	EIDOS_ASSERT_CHILD_COUNT("EidosInterpreter::Evaluate_Mult", 2);
-
-	EidosToken *operator_token = p_node->token_;
+	
 	EidosValue_SP first_child_value = FastEvaluateNode(p_node->children_[0]);
 	EidosValue_SP second_child_value = FastEvaluateNode(p_node->children_[1]);
+	EidosValue_SP result_SP = _Evaluate_Mult_Internal(p_node, std::move(first_child_value), std::move(second_child_value));
 	
-	EidosValueType first_child_type = first_child_value->Type();
-	EidosValueType second_child_type = second_child_value->Type();
+	EIDOS_EXIT_EXECUTION_LOG("Evaluate_Mult()");
+	return result_SP;
+}
+
+EidosValue_SP EidosInterpreter::_Evaluate_Mult_Internal(const EidosASTNode *p_node, EidosValue_SP p_first_child_value, EidosValue_SP p_second_child_value)
+{
+	EidosToken *operator_token = p_node->token_;
+	
+	EidosValueType first_child_type = p_first_child_value->Type();
+	EidosValueType second_child_type = p_second_child_value->Type();
 	
 	if ((first_child_type != EidosValueType::kValueInt) && (first_child_type != EidosValueType::kValueFloat))
 		EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Mult): operand type " << first_child_type << " is not supported by the '*' operator." << EidosTerminate(operator_token);
@@ -2927,15 +2971,15 @@ EidosValue_SP EidosInterpreter::Evaluate_Mult(const EidosASTNode *p_node)
 	if ((second_child_type != EidosValueType::kValueInt) && (second_child_type != EidosValueType::kValueFloat))
 		EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Mult): operand type " << second_child_type << " is not supported by the '*' operator." << EidosTerminate(operator_token);
 	
-	int first_child_count = first_child_value->Count();
-	int second_child_count = second_child_value->Count();
+	int first_child_count = p_first_child_value->Count();
+	int second_child_count = p_second_child_value->Count();
 	
 	// matrices/arrays must be conformable, and we need to decide here which operand's dimensionality will be used for the result
-	int first_child_dimcount = first_child_value->DimensionCount();
-	int second_child_dimcount = second_child_value->DimensionCount();
-	EidosValue_SP result_dim_source(EidosValue::BinaryOperationDimensionSource(first_child_value.get(), second_child_value.get()));
+	int first_child_dimcount = p_first_child_value->DimensionCount();
+	int second_child_dimcount = p_second_child_value->DimensionCount();
+	EidosValue_SP result_dim_source(EidosValue::BinaryOperationDimensionSource(p_first_child_value.get(), p_second_child_value.get()));
 	
-	if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(first_child_value.get(), second_child_value.get()))
+	if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(p_first_child_value.get(), p_second_child_value.get()))
 		EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Mult): non-conformable array operands to the '*' operator." << EidosTerminate(operator_token);
 	
 	EidosValue_SP result_SP;
@@ -2948,10 +2992,10 @@ EidosValue_SP EidosInterpreter::Evaluate_Mult(const EidosASTNode *p_node)
 			if (first_child_count == 1)
 			{
 				// This is an overflow-safe version of:
-				//result = new (gEidosValuePool->AllocateChunk()) EidosValue_Int_singleton(first_child_value->IntAtIndex(0, operator_token) * second_child_value->IntAtIndex(0, operator_token));
+				//result = new (gEidosValuePool->AllocateChunk()) EidosValue_Int_singleton(p_first_child_value->IntAtIndex(0, operator_token) * p_second_child_value->IntAtIndex(0, operator_token));
 				
-				int64_t first_operand = first_child_value->IntAtIndex(0, operator_token);
-				int64_t second_operand = second_child_value->IntAtIndex(0, operator_token);
+				int64_t first_operand = p_first_child_value->IntAtIndex(0, operator_token);
+				int64_t second_operand = p_second_child_value->IntAtIndex(0, operator_token);
 				int64_t multiply_result;
 				bool overflow = Eidos_mul_overflow(first_operand, second_operand, &multiply_result);
 				
@@ -2962,15 +3006,15 @@ EidosValue_SP EidosInterpreter::Evaluate_Mult(const EidosASTNode *p_node)
 			}
 			else
 			{
-				const int64_t *first_child_data = first_child_value->IntVector()->data();
-				const int64_t *second_child_data = second_child_value->IntVector()->data();
+				const int64_t *first_child_data = p_first_child_value->IntVector()->data();
+				const int64_t *second_child_data = p_second_child_value->IntVector()->data();
 				EidosValue_Int_vector_SP int_result_SP = EidosValue_Int_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int_vector());
 				EidosValue_Int_vector *int_result = int_result_SP->resize_no_initialize(first_child_count);
 				
 				for (int value_index = 0; value_index < first_child_count; ++value_index)
 				{
 					// This is an overflow-safe version of:
-					//int_result->set_int_no_check(first_child_value->IntAtIndex(value_index, operator_token) * second_child_value->IntAtIndex(value_index, operator_token));
+					//int_result->set_int_no_check(p_first_child_value->IntAtIndex(value_index, operator_token) * p_second_child_value->IntAtIndex(value_index, operator_token));
 					
 					int64_t first_operand = first_child_data[value_index];
 					int64_t second_operand = second_child_data[value_index];
@@ -2990,7 +3034,7 @@ EidosValue_SP EidosInterpreter::Evaluate_Mult(const EidosASTNode *p_node)
 		{
 			if (first_child_count == 1)
 			{
-				result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(first_child_value->FloatAtIndex(0, operator_token) * second_child_value->FloatAtIndex(0, operator_token)));
+				result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(p_first_child_value->FloatAtIndex(0, operator_token) * p_second_child_value->FloatAtIndex(0, operator_token)));
 			}
 			else
 			{
@@ -2999,24 +3043,24 @@ EidosValue_SP EidosInterpreter::Evaluate_Mult(const EidosASTNode *p_node)
 				
 				if ((first_child_type == EidosValueType::kValueFloat) && (second_child_type == EidosValueType::kValueFloat))
 				{
-					const double *first_child_data = first_child_value->FloatVector()->data();
-					const double *second_child_data = second_child_value->FloatVector()->data();
+					const double *first_child_data = p_first_child_value->FloatVector()->data();
+					const double *second_child_data = p_second_child_value->FloatVector()->data();
 					
 					for (int value_index = 0; value_index < first_child_count; ++value_index)
 						float_result->set_float_no_check(first_child_data[value_index] * second_child_data[value_index], value_index);
 				}
 				else if ((first_child_type == EidosValueType::kValueFloat) && (second_child_type == EidosValueType::kValueInt))
 				{
-					const double *first_child_data = first_child_value->FloatVector()->data();
-					const int64_t *second_child_data = second_child_value->IntVector()->data();
+					const double *first_child_data = p_first_child_value->FloatVector()->data();
+					const int64_t *second_child_data = p_second_child_value->IntVector()->data();
 					
 					for (int value_index = 0; value_index < first_child_count; ++value_index)
 						float_result->set_float_no_check(first_child_data[value_index] * second_child_data[value_index], value_index);
 				}
 				else	// ((first_child_type == EidosValueType::kValueInt) && (second_child_type == EidosValueType::kValueFloat))
 				{
-					const int64_t *first_child_data = first_child_value->IntVector()->data();
-					const double *second_child_data = second_child_value->FloatVector()->data();
+					const int64_t *first_child_data = p_first_child_value->IntVector()->data();
+					const double *second_child_data = p_second_child_value->FloatVector()->data();
 					
 					for (int value_index = 0; value_index < first_child_count; ++value_index)
 						float_result->set_float_no_check(first_child_data[value_index] * second_child_data[value_index], value_index);
@@ -3035,15 +3079,15 @@ EidosValue_SP EidosInterpreter::Evaluate_Mult(const EidosASTNode *p_node)
 		
 		if (first_child_count == 1)
 		{
-			one_count_child = std::move(first_child_value);
-			any_count_child = std::move(second_child_value);
+			one_count_child = std::move(p_first_child_value);
+			any_count_child = std::move(p_second_child_value);
 			any_count = second_child_count;
 			any_type = second_child_type;
 		}
 		else
 		{
-			one_count_child = std::move(second_child_value);
-			any_count_child = std::move(first_child_value);
+			one_count_child = std::move(p_second_child_value);
+			any_count_child = std::move(p_first_child_value);
 			any_count = first_child_count;
 			any_type = first_child_type;
 		}
@@ -3106,7 +3150,6 @@ EidosValue_SP EidosInterpreter::Evaluate_Mult(const EidosASTNode *p_node)
 	// Copy dimensions from whichever operand we chose at the beginning
 	result_SP->CopyDimensionsFromValue(result_dim_source.get());
 	
-	EIDOS_EXIT_EXECUTION_LOG("Evaluate_Mult()");
 	return result_SP;
 }
 
@@ -3114,13 +3157,21 @@ EidosValue_SP EidosInterpreter::Evaluate_Div(const EidosASTNode *p_node)
 {
 	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_Div()");
 	EIDOS_ASSERT_CHILD_COUNT("EidosInterpreter::Evaluate_Div", 2);
-
-	EidosToken *operator_token = p_node->token_;
+	
 	EidosValue_SP first_child_value = FastEvaluateNode(p_node->children_[0]);
 	EidosValue_SP second_child_value = FastEvaluateNode(p_node->children_[1]);
+	EidosValue_SP result_SP = _Evaluate_Div_Internal(p_node, std::move(first_child_value), std::move(second_child_value));
 	
-	EidosValueType first_child_type = first_child_value->Type();
-	EidosValueType second_child_type = second_child_value->Type();
+	EIDOS_EXIT_EXECUTION_LOG("Evaluate_Div()");
+	return result_SP;
+}
+
+EidosValue_SP EidosInterpreter::_Evaluate_Div_Internal(const EidosASTNode *p_node, EidosValue_SP p_first_child_value, EidosValue_SP p_second_child_value)
+{
+	EidosToken *operator_token = p_node->token_;
+	
+	EidosValueType first_child_type = p_first_child_value->Type();
+	EidosValueType second_child_type = p_second_child_value->Type();
 	
 	if ((first_child_type != EidosValueType::kValueInt) && (first_child_type != EidosValueType::kValueFloat))
 		EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Div): operand type " << first_child_type << " is not supported by the '/' operator." << EidosTerminate(operator_token);
@@ -3128,15 +3179,15 @@ EidosValue_SP EidosInterpreter::Evaluate_Div(const EidosASTNode *p_node)
 	if ((second_child_type != EidosValueType::kValueInt) && (second_child_type != EidosValueType::kValueFloat))
 		EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Div): operand type " << second_child_type << " is not supported by the '/' operator." << EidosTerminate(operator_token);
 	
-	int first_child_count = first_child_value->Count();
-	int second_child_count = second_child_value->Count();
+	int first_child_count = p_first_child_value->Count();
+	int second_child_count = p_second_child_value->Count();
 	
 	// matrices/arrays must be conformable, and we need to decide here which operand's dimensionality will be used for the result
-	int first_child_dimcount = first_child_value->DimensionCount();
-	int second_child_dimcount = second_child_value->DimensionCount();
-	EidosValue_SP result_dim_source(EidosValue::BinaryOperationDimensionSource(first_child_value.get(), second_child_value.get()));
+	int first_child_dimcount = p_first_child_value->DimensionCount();
+	int second_child_dimcount = p_second_child_value->DimensionCount();
+	EidosValue_SP result_dim_source(EidosValue::BinaryOperationDimensionSource(p_first_child_value.get(), p_second_child_value.get()));
 	
-	if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(first_child_value.get(), second_child_value.get()))
+	if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(p_first_child_value.get(), p_second_child_value.get()))
 		EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Div): non-conformable array operands to the '/' operator." << EidosTerminate(operator_token);
 	
 	EidosValue_SP result_SP;
@@ -3149,7 +3200,7 @@ EidosValue_SP EidosInterpreter::Evaluate_Div(const EidosASTNode *p_node)
 	{
 		if (first_child_count == 1)
 		{
-			result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(first_child_value->FloatAtIndex(0, operator_token) / second_child_value->FloatAtIndex(0, operator_token)));
+			result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(p_first_child_value->FloatAtIndex(0, operator_token) / p_second_child_value->FloatAtIndex(0, operator_token)));
 		}
 		else
 		{
@@ -3158,32 +3209,32 @@ EidosValue_SP EidosInterpreter::Evaluate_Div(const EidosASTNode *p_node)
 			
 			if ((first_child_type == EidosValueType::kValueFloat) && (second_child_type == EidosValueType::kValueFloat))
 			{
-				const double *first_child_data = first_child_value->FloatVector()->data();
-				const double *second_child_data = second_child_value->FloatVector()->data();
+				const double *first_child_data = p_first_child_value->FloatVector()->data();
+				const double *second_child_data = p_second_child_value->FloatVector()->data();
 				
 				for (int value_index = 0; value_index < first_child_count; ++value_index)
 					float_result->set_float_no_check(first_child_data[value_index] / second_child_data[value_index], value_index);
 			}
 			else if ((first_child_type == EidosValueType::kValueFloat) && (second_child_type == EidosValueType::kValueInt))
 			{
-				const double *first_child_data = first_child_value->FloatVector()->data();
-				const int64_t *second_child_data = second_child_value->IntVector()->data();
+				const double *first_child_data = p_first_child_value->FloatVector()->data();
+				const int64_t *second_child_data = p_second_child_value->IntVector()->data();
 				
 				for (int value_index = 0; value_index < first_child_count; ++value_index)
 					float_result->set_float_no_check(first_child_data[value_index] / second_child_data[value_index], value_index);
 			}
 			else if ((first_child_type == EidosValueType::kValueInt) && (second_child_type == EidosValueType::kValueFloat))
 			{
-				const int64_t *first_child_data = first_child_value->IntVector()->data();
-				const double *second_child_data = second_child_value->FloatVector()->data();
+				const int64_t *first_child_data = p_first_child_value->IntVector()->data();
+				const double *second_child_data = p_second_child_value->FloatVector()->data();
 				
 				for (int value_index = 0; value_index < first_child_count; ++value_index)
 					float_result->set_float_no_check(first_child_data[value_index] / second_child_data[value_index], value_index);
 			}
 			else // ((first_child_type == EidosValueType::kValueInt) && (second_child_type == EidosValueType::kValueInt))
 			{
-				const int64_t *first_child_data = first_child_value->IntVector()->data();
-				const int64_t *second_child_data = second_child_value->IntVector()->data();
+				const int64_t *first_child_data = p_first_child_value->IntVector()->data();
+				const int64_t *second_child_data = p_second_child_value->IntVector()->data();
 				
 				for (int value_index = 0; value_index < first_child_count; ++value_index)
 					float_result->set_float_no_check(first_child_data[value_index] / (double)second_child_data[value_index], value_index);
@@ -3194,20 +3245,20 @@ EidosValue_SP EidosInterpreter::Evaluate_Div(const EidosASTNode *p_node)
 	}
 	else if (first_child_count == 1)
 	{
-		double singleton_float = first_child_value->FloatAtIndex(0, operator_token);
+		double singleton_float = p_first_child_value->FloatAtIndex(0, operator_token);
 		EidosValue_Float_vector_SP float_result_SP = EidosValue_Float_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector());
 		EidosValue_Float_vector *float_result = float_result_SP->resize_no_initialize(second_child_count);
 		
 		if (second_child_type == EidosValueType::kValueInt)
 		{
-			const int64_t *second_child_data = second_child_value->IntVector()->data();
+			const int64_t *second_child_data = p_second_child_value->IntVector()->data();
 			
 			for (int value_index = 0; value_index < second_child_count; ++value_index)
 				float_result->set_float_no_check(singleton_float / second_child_data[value_index], value_index);
 		}
 		else	// (second_child_type == EidosValueType::kValueFloat)
 		{
-			const double *second_child_data = second_child_value->FloatVector()->data();
+			const double *second_child_data = p_second_child_value->FloatVector()->data();
 			
 			for (int value_index = 0; value_index < second_child_count; ++value_index)
 				float_result->set_float_no_check(singleton_float / second_child_data[value_index], value_index);
@@ -3217,20 +3268,20 @@ EidosValue_SP EidosInterpreter::Evaluate_Div(const EidosASTNode *p_node)
 	}
 	else if (second_child_count == 1)
 	{
-		double singleton_float = second_child_value->FloatAtIndex(0, operator_token);
+		double singleton_float = p_second_child_value->FloatAtIndex(0, operator_token);
 		EidosValue_Float_vector_SP float_result_SP = EidosValue_Float_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector());
 		EidosValue_Float_vector *float_result = float_result_SP->resize_no_initialize(first_child_count);
 		
 		if (first_child_type == EidosValueType::kValueInt)
 		{
-			const int64_t *first_child_data = first_child_value->IntVector()->data();
+			const int64_t *first_child_data = p_first_child_value->IntVector()->data();
 			
 			for (int value_index = 0; value_index < first_child_count; ++value_index)
 				float_result->set_float_no_check(first_child_data[value_index] / singleton_float, value_index);
 		}
 		else	// (first_child_type == EidosValueType::kValueFloat)
 		{
-			const double *first_child_data = first_child_value->FloatVector()->data();
+			const double *first_child_data = p_first_child_value->FloatVector()->data();
 			
 			for (int value_index = 0; value_index < first_child_count; ++value_index)
 				float_result->set_float_no_check(first_child_data[value_index] / singleton_float, value_index);
@@ -3246,7 +3297,6 @@ EidosValue_SP EidosInterpreter::Evaluate_Div(const EidosASTNode *p_node)
 	// Copy dimensions from whichever operand we chose at the beginning
 	result_SP->CopyDimensionsFromValue(result_dim_source.get());
 	
-	EIDOS_EXIT_EXECUTION_LOG("Evaluate_Div()");
 	return result_SP;
 }
 
@@ -3295,12 +3345,20 @@ EidosValue_SP EidosInterpreter::Evaluate_Exp(const EidosASTNode *p_node)
 	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_Exp()");
 	EIDOS_ASSERT_CHILD_COUNT("EidosInterpreter::Evaluate_Exp", 2);
 	
-	EidosToken *operator_token = p_node->token_;
 	EidosValue_SP first_child_value = FastEvaluateNode(p_node->children_[0]);
 	EidosValue_SP second_child_value = FastEvaluateNode(p_node->children_[1]);
+	EidosValue_SP result_SP = _Evaluate_Exp_Internal(p_node, std::move(first_child_value), std::move(second_child_value));
 	
-	EidosValueType first_child_type = first_child_value->Type();
-	EidosValueType second_child_type = second_child_value->Type();
+	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_Exp()");
+	return result_SP;
+}
+
+EidosValue_SP EidosInterpreter::_Evaluate_Exp_Internal(const EidosASTNode *p_node, EidosValue_SP p_first_child_value, EidosValue_SP p_second_child_value)
+{
+	EidosToken *operator_token = p_node->token_;
+	
+	EidosValueType first_child_type = p_first_child_value->Type();
+	EidosValueType second_child_type = p_second_child_value->Type();
 	
 	if ((first_child_type != EidosValueType::kValueInt) && (first_child_type != EidosValueType::kValueFloat))
 		EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Exp): operand type " << first_child_type << " is not supported by the '^' operator." << EidosTerminate(operator_token);
@@ -3308,15 +3366,15 @@ EidosValue_SP EidosInterpreter::Evaluate_Exp(const EidosASTNode *p_node)
 	if ((second_child_type != EidosValueType::kValueInt) && (second_child_type != EidosValueType::kValueFloat))
 		EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Exp): operand type " << second_child_type << " is not supported by the '^' operator." << EidosTerminate(operator_token);
 	
-	int first_child_count = first_child_value->Count();
-	int second_child_count = second_child_value->Count();
+	int first_child_count = p_first_child_value->Count();
+	int second_child_count = p_second_child_value->Count();
 	
 	// matrices/arrays must be conformable, and we need to decide here which operand's dimensionality will be used for the result
-	int first_child_dimcount = first_child_value->DimensionCount();
-	int second_child_dimcount = second_child_value->DimensionCount();
-	EidosValue_SP result_dim_source(EidosValue::BinaryOperationDimensionSource(first_child_value.get(), second_child_value.get()));
+	int first_child_dimcount = p_first_child_value->DimensionCount();
+	int second_child_dimcount = p_second_child_value->DimensionCount();
+	EidosValue_SP result_dim_source(EidosValue::BinaryOperationDimensionSource(p_first_child_value.get(), p_second_child_value.get()));
 	
-	if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(first_child_value.get(), second_child_value.get()))
+	if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(p_first_child_value.get(), p_second_child_value.get()))
 		EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Exp): non-conformable array operands to the '^' operator." << EidosTerminate(operator_token);
 	
 	// Exponentiation always produces a float result; the user can cast back to integer if they really want
@@ -3326,7 +3384,7 @@ EidosValue_SP EidosInterpreter::Evaluate_Exp(const EidosASTNode *p_node)
 	{
 		if (first_child_count == 1)
 		{
-			result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(pow(first_child_value->FloatAtIndex(0, operator_token), second_child_value->FloatAtIndex(0, operator_token))));
+			result_SP = EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(pow(p_first_child_value->FloatAtIndex(0, operator_token), p_second_child_value->FloatAtIndex(0, operator_token))));
 		}
 		else
 		{
@@ -3335,32 +3393,32 @@ EidosValue_SP EidosInterpreter::Evaluate_Exp(const EidosASTNode *p_node)
 			
 			if ((first_child_type == EidosValueType::kValueFloat) && (second_child_type == EidosValueType::kValueFloat))
 			{
-				const double *first_child_data = first_child_value->FloatVector()->data();
-				const double *second_child_data = second_child_value->FloatVector()->data();
+				const double *first_child_data = p_first_child_value->FloatVector()->data();
+				const double *second_child_data = p_second_child_value->FloatVector()->data();
 				
 				for (int value_index = 0; value_index < first_child_count; ++value_index)
 					float_result->set_float_no_check(pow(first_child_data[value_index], second_child_data[value_index]), value_index);
 			}
 			else if ((first_child_type == EidosValueType::kValueFloat) && (second_child_type == EidosValueType::kValueInt))
 			{
-				const double *first_child_data = first_child_value->FloatVector()->data();
-				const int64_t *second_child_data = second_child_value->IntVector()->data();
+				const double *first_child_data = p_first_child_value->FloatVector()->data();
+				const int64_t *second_child_data = p_second_child_value->IntVector()->data();
 				
 				for (int value_index = 0; value_index < first_child_count; ++value_index)
 					float_result->set_float_no_check(pow(first_child_data[value_index], second_child_data[value_index]), value_index);
 			}
 			else if ((first_child_type == EidosValueType::kValueInt) && (second_child_type == EidosValueType::kValueFloat))
 			{
-				const int64_t *first_child_data = first_child_value->IntVector()->data();
-				const double *second_child_data = second_child_value->FloatVector()->data();
+				const int64_t *first_child_data = p_first_child_value->IntVector()->data();
+				const double *second_child_data = p_second_child_value->FloatVector()->data();
 				
 				for (int value_index = 0; value_index < first_child_count; ++value_index)
 					float_result->set_float_no_check(pow(first_child_data[value_index], second_child_data[value_index]), value_index);
 			}
 			else // ((first_child_type == EidosValueType::kValueInt) && (second_child_type == EidosValueType::kValueInt))
 			{
-				const int64_t *first_child_data = first_child_value->IntVector()->data();
-				const int64_t *second_child_data = second_child_value->IntVector()->data();
+				const int64_t *first_child_data = p_first_child_value->IntVector()->data();
+				const int64_t *second_child_data = p_second_child_value->IntVector()->data();
 				
 				for (int value_index = 0; value_index < first_child_count; ++value_index)
 					float_result->set_float_no_check(pow(first_child_data[value_index], second_child_data[value_index]), value_index);
@@ -3371,20 +3429,20 @@ EidosValue_SP EidosInterpreter::Evaluate_Exp(const EidosASTNode *p_node)
 	}
 	else if (first_child_count == 1)
 	{
-		double singleton_float = first_child_value->FloatAtIndex(0, operator_token);
+		double singleton_float = p_first_child_value->FloatAtIndex(0, operator_token);
 		EidosValue_Float_vector_SP float_result_SP = EidosValue_Float_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector());
 		EidosValue_Float_vector *float_result = float_result_SP->resize_no_initialize(second_child_count);
 		
 		if (second_child_type == EidosValueType::kValueInt)
 		{
-			const int64_t *second_child_data = second_child_value->IntVector()->data();
+			const int64_t *second_child_data = p_second_child_value->IntVector()->data();
 			
 			for (int value_index = 0; value_index < second_child_count; ++value_index)
 				float_result->set_float_no_check(pow(singleton_float, second_child_data[value_index]), value_index);
 		}
 		else	// (second_child_type == EidosValueType::kValueFloat)
 		{
-			const double *second_child_data = second_child_value->FloatVector()->data();
+			const double *second_child_data = p_second_child_value->FloatVector()->data();
 			
 			for (int value_index = 0; value_index < second_child_count; ++value_index)
 				float_result->set_float_no_check(pow(singleton_float, second_child_data[value_index]), value_index);
@@ -3394,20 +3452,20 @@ EidosValue_SP EidosInterpreter::Evaluate_Exp(const EidosASTNode *p_node)
 	}
 	else if (second_child_count == 1)
 	{
-		double singleton_float = second_child_value->FloatAtIndex(0, operator_token);
+		double singleton_float = p_second_child_value->FloatAtIndex(0, operator_token);
 		EidosValue_Float_vector_SP float_result_SP = EidosValue_Float_vector_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_vector());
 		EidosValue_Float_vector *float_result = float_result_SP->resize_no_initialize(first_child_count);
 		
 		if (first_child_type == EidosValueType::kValueInt)
 		{
-			const int64_t *first_child_data = first_child_value->IntVector()->data();
+			const int64_t *first_child_data = p_first_child_value->IntVector()->data();
 			
 			for (int value_index = 0; value_index < first_child_count; ++value_index)
 				float_result->set_float_no_check(pow(first_child_data[value_index], singleton_float), value_index);
 		}
 		else	// (first_child_type == EidosValueType::kValueFloat)
 		{
-			const double *first_child_data = first_child_value->FloatVector()->data();
+			const double *first_child_data = p_first_child_value->FloatVector()->data();
 			
 			for (int value_index = 0; value_index < first_child_count; ++value_index)
 				float_result->set_float_no_check(pow(first_child_data[value_index], singleton_float), value_index);
@@ -3423,7 +3481,6 @@ EidosValue_SP EidosInterpreter::Evaluate_Exp(const EidosASTNode *p_node)
 	// Copy dimensions from whichever operand we chose at the beginning
 	result_SP->CopyDimensionsFromValue(result_dim_source.get());
 	
-	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_Exp()");
 	return result_SP;
 }
 
@@ -4208,15 +4265,22 @@ EidosValue_SP EidosInterpreter::Evaluate_Eq(const EidosASTNode *p_node)
 {
 	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_Eq()");
 	EIDOS_ASSERT_CHILD_COUNT("EidosInterpreter::Evaluate_Eq", 2);
-
-	EidosToken *operator_token = p_node->token_;
-	EidosValue_Logical_SP result_SP;
 	
 	EidosValue_SP first_child_value = FastEvaluateNode(p_node->children_[0]);
 	EidosValue_SP second_child_value = FastEvaluateNode(p_node->children_[1]);
+	EidosValue_SP result_SP = _Evaluate_Eq_Internal(p_node, std::move(first_child_value), std::move(second_child_value));
 	
-	EidosValueType first_child_type = first_child_value->Type();
-	EidosValueType second_child_type = second_child_value->Type();
+	EIDOS_EXIT_EXECUTION_LOG("Evaluate_Eq()");
+	return result_SP;
+}
+
+EidosValue_SP EidosInterpreter::_Evaluate_Eq_Internal(const EidosASTNode *p_node, EidosValue_SP p_first_child_value, EidosValue_SP p_second_child_value)
+{
+	EidosToken *operator_token = p_node->token_;
+	EidosValue_Logical_SP result_SP;
+	
+	EidosValueType first_child_type = p_first_child_value->Type();
+	EidosValueType second_child_type = p_second_child_value->Type();
 	
 	if ((first_child_type == EidosValueType::kValueVOID) || (second_child_type == EidosValueType::kValueVOID))
 		EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Eq): operand type void is not supported by the '==' operator." << EidosTerminate(operator_token);
@@ -4224,16 +4288,16 @@ EidosValue_SP EidosInterpreter::Evaluate_Eq(const EidosASTNode *p_node)
 	if ((first_child_type != EidosValueType::kValueNULL) && (second_child_type != EidosValueType::kValueNULL))
 	{
 		// both operands are non-NULL, so we're doing a real comparison
-		int first_child_count = first_child_value->Count();
-		int second_child_count = second_child_value->Count();
+		int first_child_count = p_first_child_value->Count();
+		int second_child_count = p_second_child_value->Count();
 		EidosCompareFunctionPtr compareFunc = Eidos_GetCompareFunctionForTypes(first_child_type, second_child_type, operator_token);
 		
 		// matrices/arrays must be conformable, and we need to decide here which operand's dimensionality will be used for the result
-		int first_child_dimcount = first_child_value->DimensionCount();
-		int second_child_dimcount = second_child_value->DimensionCount();
-		EidosValue_SP result_dim_source(EidosValue::BinaryOperationDimensionSource(first_child_value.get(), second_child_value.get()));
+		int first_child_dimcount = p_first_child_value->DimensionCount();
+		int second_child_dimcount = p_second_child_value->DimensionCount();
+		EidosValue_SP result_dim_source(EidosValue::BinaryOperationDimensionSource(p_first_child_value.get(), p_second_child_value.get()));
 		
-		if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(first_child_value.get(), second_child_value.get()))
+		if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(p_first_child_value.get(), p_second_child_value.get()))
 			EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Eq): non-conformable array operands to the '==' operator." << EidosTerminate(operator_token);
 		
 		if (first_child_count == second_child_count)
@@ -4241,7 +4305,7 @@ EidosValue_SP EidosInterpreter::Evaluate_Eq(const EidosASTNode *p_node)
 			if (first_child_count == 1)
 			{
 				// special-case the 1-to-1 comparison to return a statically allocated logical value, for speed
-				int compare_result = compareFunc(*first_child_value, 0, *second_child_value, 0, operator_token);
+				int compare_result = compareFunc(*p_first_child_value, 0, *p_second_child_value, 0, operator_token);
 				
 				if (!result_dim_source)
 					result_SP = (compare_result == 0) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF;
@@ -4256,8 +4320,8 @@ EidosValue_SP EidosInterpreter::Evaluate_Eq(const EidosASTNode *p_node)
 				if ((first_child_type == EidosValueType::kValueFloat) && (second_child_type == EidosValueType::kValueFloat))
 				{
 					// Direct float-to-float compare can be optimized through vector access
-					const double *float1_data = first_child_value->FloatVector()->data();
-					const double *float2_data = second_child_value->FloatVector()->data();
+					const double *float1_data = p_first_child_value->FloatVector()->data();
+					const double *float2_data = p_second_child_value->FloatVector()->data();
 					
 					for (int value_index = 0; value_index < first_child_count; ++value_index)
 						logical_result->set_logical_no_check(float1_data[value_index] == float2_data[value_index], value_index);
@@ -4265,8 +4329,8 @@ EidosValue_SP EidosInterpreter::Evaluate_Eq(const EidosASTNode *p_node)
 				else if ((first_child_type == EidosValueType::kValueInt) && (second_child_type == EidosValueType::kValueInt))
 				{
 					// Direct int-to-int compare can be optimized through vector access
-					const int64_t *int1_data = first_child_value->IntVector()->data();
-					const int64_t *int2_data = second_child_value->IntVector()->data();
+					const int64_t *int1_data = p_first_child_value->IntVector()->data();
+					const int64_t *int2_data = p_second_child_value->IntVector()->data();
 					
 					for (int value_index = 0; value_index < first_child_count; ++value_index)
 						logical_result->set_logical_no_check(int1_data[value_index] == int2_data[value_index], value_index);
@@ -4274,8 +4338,8 @@ EidosValue_SP EidosInterpreter::Evaluate_Eq(const EidosASTNode *p_node)
 				else if ((first_child_type == EidosValueType::kValueObject) && (second_child_type == EidosValueType::kValueObject))
 				{
 					// Direct object-to-object compare can be optimized through vector access
-					EidosObjectElement * const *obj1_vec = first_child_value->ObjectElementVector()->data();
-					EidosObjectElement * const *obj2_vec = second_child_value->ObjectElementVector()->data();
+					EidosObjectElement * const *obj1_vec = p_first_child_value->ObjectElementVector()->data();
+					EidosObjectElement * const *obj2_vec = p_second_child_value->ObjectElementVector()->data();
 					
 					for (int value_index = 0; value_index < first_child_count; ++value_index)
 						logical_result->set_logical_no_check(obj1_vec[value_index] == obj2_vec[value_index], value_index);
@@ -4284,7 +4348,7 @@ EidosValue_SP EidosInterpreter::Evaluate_Eq(const EidosASTNode *p_node)
 				{
 					// General case
 					for (int value_index = 0; value_index < first_child_count; ++value_index)
-						logical_result->set_logical_no_check(compareFunc(*first_child_value, value_index, *second_child_value, value_index, operator_token) == 0, value_index);
+						logical_result->set_logical_no_check(compareFunc(*p_first_child_value, value_index, *p_second_child_value, value_index, operator_token) == 0, value_index);
 				}
 				
 				result_SP = std::move(logical_result_SP);
@@ -4298,8 +4362,8 @@ EidosValue_SP EidosInterpreter::Evaluate_Eq(const EidosASTNode *p_node)
 			if ((compareFunc == &CompareEidosValues_Float) && (second_child_type == EidosValueType::kValueFloat))
 			{
 				// Direct float-to-float compare can be optimized through vector access; note the singleton might get promoted to float
-				double float1 = first_child_value->FloatAtIndex(0, operator_token);
-				const double *float_data = second_child_value->FloatVector()->data();
+				double float1 = p_first_child_value->FloatAtIndex(0, operator_token);
+				const double *float_data = p_second_child_value->FloatVector()->data();
 				
 				for (int value_index = 0; value_index < second_child_count; ++value_index)
 					logical_result->set_logical_no_check(float1 == float_data[value_index], value_index);
@@ -4307,8 +4371,8 @@ EidosValue_SP EidosInterpreter::Evaluate_Eq(const EidosASTNode *p_node)
 			else if ((compareFunc == &CompareEidosValues_Int) && (second_child_type == EidosValueType::kValueInt))
 			{
 				// Direct int-to-int compare can be optimized through vector access; note the singleton might get promoted to int
-				int64_t int1 = first_child_value->IntAtIndex(0, operator_token);
-				const int64_t *int_data = second_child_value->IntVector()->data();
+				int64_t int1 = p_first_child_value->IntAtIndex(0, operator_token);
+				const int64_t *int_data = p_second_child_value->IntVector()->data();
 				
 				for (int value_index = 0; value_index < second_child_count; ++value_index)
 					logical_result->set_logical_no_check(int1 == int_data[value_index], value_index);
@@ -4316,8 +4380,8 @@ EidosValue_SP EidosInterpreter::Evaluate_Eq(const EidosASTNode *p_node)
 			else if ((compareFunc == &CompareEidosValues_Object) && (second_child_type == EidosValueType::kValueObject))
 			{
 				// Direct object-to-object compare can be optimized through vector access
-				EidosObjectElement *obj1 = first_child_value->ObjectElementAtIndex(0, operator_token);
-				EidosObjectElement * const *obj_vec = second_child_value->ObjectElementVector()->data();
+				EidosObjectElement *obj1 = p_first_child_value->ObjectElementAtIndex(0, operator_token);
+				EidosObjectElement * const *obj_vec = p_second_child_value->ObjectElementVector()->data();
 				
 				for (int value_index = 0; value_index < second_child_count; ++value_index)
 					logical_result->set_logical_no_check(obj1 == obj_vec[value_index], value_index);
@@ -4326,7 +4390,7 @@ EidosValue_SP EidosInterpreter::Evaluate_Eq(const EidosASTNode *p_node)
 			{
 				// General case
 				for (int value_index = 0; value_index < second_child_count; ++value_index)
-					logical_result->set_logical_no_check(compareFunc(*first_child_value, 0, *second_child_value, value_index, operator_token) == 0, value_index);
+					logical_result->set_logical_no_check(compareFunc(*p_first_child_value, 0, *p_second_child_value, value_index, operator_token) == 0, value_index);
 			}
 			
 			result_SP = std::move(logical_result_SP);
@@ -4339,8 +4403,8 @@ EidosValue_SP EidosInterpreter::Evaluate_Eq(const EidosASTNode *p_node)
 			if ((compareFunc == &CompareEidosValues_Float) && (first_child_type == EidosValueType::kValueFloat))
 			{
 				// Direct float-to-float compare can be optimized through vector access; note the singleton might get promoted to float
-				double float2 = second_child_value->FloatAtIndex(0, operator_token);
-				const double *float_data = first_child_value->FloatVector()->data();
+				double float2 = p_second_child_value->FloatAtIndex(0, operator_token);
+				const double *float_data = p_first_child_value->FloatVector()->data();
 				
 				for (int value_index = 0; value_index < first_child_count; ++value_index)
 					logical_result->set_logical_no_check(float_data[value_index] == float2, value_index);
@@ -4348,8 +4412,8 @@ EidosValue_SP EidosInterpreter::Evaluate_Eq(const EidosASTNode *p_node)
 			else if ((compareFunc == &CompareEidosValues_Int) && (first_child_type == EidosValueType::kValueInt))
 			{
 				// Direct int-to-int compare can be optimized through vector access; note the singleton might get promoted to int
-				int64_t int2 = second_child_value->IntAtIndex(0, operator_token);
-				const int64_t *int_data = first_child_value->IntVector()->data();
+				int64_t int2 = p_second_child_value->IntAtIndex(0, operator_token);
+				const int64_t *int_data = p_first_child_value->IntVector()->data();
 				
 				for (int value_index = 0; value_index < first_child_count; ++value_index)
 					logical_result->set_logical_no_check(int_data[value_index] == int2, value_index);
@@ -4357,8 +4421,8 @@ EidosValue_SP EidosInterpreter::Evaluate_Eq(const EidosASTNode *p_node)
 			else if ((compareFunc == &CompareEidosValues_Object) && (first_child_type == EidosValueType::kValueObject))
 			{
 				// Direct object-to-object compare can be optimized through vector access
-				EidosObjectElement *obj2 = second_child_value->ObjectElementAtIndex(0, operator_token);
-				EidosObjectElement * const *obj_vec = first_child_value->ObjectElementVector()->data();
+				EidosObjectElement *obj2 = p_second_child_value->ObjectElementAtIndex(0, operator_token);
+				EidosObjectElement * const *obj_vec = p_first_child_value->ObjectElementVector()->data();
 				
 				for (int value_index = 0; value_index < first_child_count; ++value_index)
 					logical_result->set_logical_no_check(obj_vec[value_index] == obj2, value_index);
@@ -4367,7 +4431,7 @@ EidosValue_SP EidosInterpreter::Evaluate_Eq(const EidosASTNode *p_node)
 			{
 				// General case
 				for (int value_index = 0; value_index < first_child_count; ++value_index)
-					logical_result->set_logical_no_check(compareFunc(*first_child_value, value_index, *second_child_value, 0, operator_token) == 0, value_index);
+					logical_result->set_logical_no_check(compareFunc(*p_first_child_value, value_index, *p_second_child_value, 0, operator_token) == 0, value_index);
 			}
 			
 			result_SP = std::move(logical_result_SP);
@@ -4385,7 +4449,6 @@ EidosValue_SP EidosInterpreter::Evaluate_Eq(const EidosASTNode *p_node)
 		EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Eq): testing NULL with the '==' operator is an error; use isNULL()." << EidosTerminate(operator_token);
 	}
 	
-	EIDOS_EXIT_EXECUTION_LOG("Evaluate_Eq()");
 	return result_SP;
 }
 
@@ -4393,15 +4456,22 @@ EidosValue_SP EidosInterpreter::Evaluate_Lt(const EidosASTNode *p_node)
 {
 	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_Lt()");
 	EIDOS_ASSERT_CHILD_COUNT("EidosInterpreter::Evaluate_Lt", 2);
-
-	EidosToken *operator_token = p_node->token_;
-	EidosValue_Logical_SP result_SP;
 	
 	EidosValue_SP first_child_value = FastEvaluateNode(p_node->children_[0]);
 	EidosValue_SP second_child_value = FastEvaluateNode(p_node->children_[1]);
+	EidosValue_SP result_SP = _Evaluate_Lt_Internal(p_node, std::move(first_child_value), std::move(second_child_value));
 	
-	EidosValueType first_child_type = first_child_value->Type();
-	EidosValueType second_child_type = second_child_value->Type();
+	EIDOS_EXIT_EXECUTION_LOG("Evaluate_Lt()");
+	return result_SP;
+}
+
+EidosValue_SP EidosInterpreter::_Evaluate_Lt_Internal(const EidosASTNode *p_node, EidosValue_SP p_first_child_value, EidosValue_SP p_second_child_value)
+{
+	EidosToken *operator_token = p_node->token_;
+	EidosValue_Logical_SP result_SP;
+	
+	EidosValueType first_child_type = p_first_child_value->Type();
+	EidosValueType second_child_type = p_second_child_value->Type();
 	
 	if ((first_child_type == EidosValueType::kValueVOID) || (second_child_type == EidosValueType::kValueVOID))
 		EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Lt): operand type void is not supported by the '<' operator." << EidosTerminate(operator_token);
@@ -4411,16 +4481,16 @@ EidosValue_SP EidosInterpreter::Evaluate_Lt(const EidosASTNode *p_node)
 	if ((first_child_type != EidosValueType::kValueNULL) && (second_child_type != EidosValueType::kValueNULL))
 	{
 		// both operands are non-NULL, so we're doing a real comparison
-		int first_child_count = first_child_value->Count();
-		int second_child_count = second_child_value->Count();
+		int first_child_count = p_first_child_value->Count();
+		int second_child_count = p_second_child_value->Count();
 		EidosCompareFunctionPtr compareFunc = Eidos_GetCompareFunctionForTypes(first_child_type, second_child_type, operator_token);
 		
 		// matrices/arrays must be conformable, and we need to decide here which operand's dimensionality will be used for the result
-		int first_child_dimcount = first_child_value->DimensionCount();
-		int second_child_dimcount = second_child_value->DimensionCount();
-		EidosValue_SP result_dim_source(EidosValue::BinaryOperationDimensionSource(first_child_value.get(), second_child_value.get()));
+		int first_child_dimcount = p_first_child_value->DimensionCount();
+		int second_child_dimcount = p_second_child_value->DimensionCount();
+		EidosValue_SP result_dim_source(EidosValue::BinaryOperationDimensionSource(p_first_child_value.get(), p_second_child_value.get()));
 		
-		if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(first_child_value.get(), second_child_value.get()))
+		if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(p_first_child_value.get(), p_second_child_value.get()))
 			EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Lt): non-conformable array operands to the '<' operator." << EidosTerminate(operator_token);
 		
 		if (first_child_count == second_child_count)
@@ -4428,7 +4498,7 @@ EidosValue_SP EidosInterpreter::Evaluate_Lt(const EidosASTNode *p_node)
 			if (first_child_count == 1)
 			{
 				// special-case the 1-to-1 comparison to return a statically allocated logical value, for speed
-				int compare_result = compareFunc(*first_child_value, 0, *second_child_value, 0, operator_token);
+				int compare_result = compareFunc(*p_first_child_value, 0, *p_second_child_value, 0, operator_token);
 				
 				if (!result_dim_source)
 					result_SP = (compare_result == -1) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF;
@@ -4442,7 +4512,7 @@ EidosValue_SP EidosInterpreter::Evaluate_Lt(const EidosASTNode *p_node)
 				
 				for (int value_index = 0; value_index < first_child_count; ++value_index)
 				{
-					int compare_result = compareFunc(*first_child_value, value_index, *second_child_value, value_index, operator_token);
+					int compare_result = compareFunc(*p_first_child_value, value_index, *p_second_child_value, value_index, operator_token);
 					
 					logical_result->set_logical_no_check(compare_result == -1, value_index);
 				}
@@ -4457,7 +4527,7 @@ EidosValue_SP EidosInterpreter::Evaluate_Lt(const EidosASTNode *p_node)
 			
 			for (int value_index = 0; value_index < second_child_count; ++value_index)
 			{
-				int compare_result = compareFunc(*first_child_value, 0, *second_child_value, value_index, operator_token);
+				int compare_result = compareFunc(*p_first_child_value, 0, *p_second_child_value, value_index, operator_token);
 				
 				logical_result->set_logical_no_check(compare_result == -1, value_index);
 			}
@@ -4471,7 +4541,7 @@ EidosValue_SP EidosInterpreter::Evaluate_Lt(const EidosASTNode *p_node)
 			
 			for (int value_index = 0; value_index < first_child_count; ++value_index)
 			{
-				int compare_result = compareFunc(*first_child_value, value_index, *second_child_value, 0, operator_token);
+				int compare_result = compareFunc(*p_first_child_value, value_index, *p_second_child_value, 0, operator_token);
 				
 				logical_result->set_logical_no_check(compare_result == -1, value_index);
 			}
@@ -4492,7 +4562,6 @@ EidosValue_SP EidosInterpreter::Evaluate_Lt(const EidosASTNode *p_node)
 		EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Lt): testing NULL with the '<' operator is an error; use isNULL()." << EidosTerminate(operator_token);
 	}
 	
-	EIDOS_EXIT_EXECUTION_LOG("Evaluate_Lt()");
 	return result_SP;
 }
 
@@ -4500,15 +4569,22 @@ EidosValue_SP EidosInterpreter::Evaluate_LtEq(const EidosASTNode *p_node)
 {
 	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_LtEq()");
 	EIDOS_ASSERT_CHILD_COUNT("EidosInterpreter::Evaluate_LtEq", 2);
-
-	EidosToken *operator_token = p_node->token_;
-	EidosValue_Logical_SP result_SP;
 	
 	EidosValue_SP first_child_value = FastEvaluateNode(p_node->children_[0]);
 	EidosValue_SP second_child_value = FastEvaluateNode(p_node->children_[1]);
+	EidosValue_SP result_SP = _Evaluate_LtEq_Internal(p_node, std::move(first_child_value), std::move(second_child_value));
 	
-	EidosValueType first_child_type = first_child_value->Type();
-	EidosValueType second_child_type = second_child_value->Type();
+	EIDOS_EXIT_EXECUTION_LOG("Evaluate_LtEq()");
+	return result_SP;
+}
+
+EidosValue_SP EidosInterpreter::_Evaluate_LtEq_Internal(const EidosASTNode *p_node, EidosValue_SP p_first_child_value, EidosValue_SP p_second_child_value)
+{
+	EidosToken *operator_token = p_node->token_;
+	EidosValue_Logical_SP result_SP;
+	
+	EidosValueType first_child_type = p_first_child_value->Type();
+	EidosValueType second_child_type = p_second_child_value->Type();
 	
 	if ((first_child_type == EidosValueType::kValueVOID) || (second_child_type == EidosValueType::kValueVOID))
 		EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_LtEq): operand type void is not supported by the '<=' operator." << EidosTerminate(operator_token);
@@ -4518,16 +4594,16 @@ EidosValue_SP EidosInterpreter::Evaluate_LtEq(const EidosASTNode *p_node)
 	if ((first_child_type != EidosValueType::kValueNULL) && (second_child_type != EidosValueType::kValueNULL))
 	{
 		// both operands are non-NULL, so we're doing a real comparison
-		int first_child_count = first_child_value->Count();
-		int second_child_count = second_child_value->Count();
+		int first_child_count = p_first_child_value->Count();
+		int second_child_count = p_second_child_value->Count();
 		EidosCompareFunctionPtr compareFunc = Eidos_GetCompareFunctionForTypes(first_child_type, second_child_type, operator_token);
 		
 		// matrices/arrays must be conformable, and we need to decide here which operand's dimensionality will be used for the result
-		int first_child_dimcount = first_child_value->DimensionCount();
-		int second_child_dimcount = second_child_value->DimensionCount();
-		EidosValue_SP result_dim_source(EidosValue::BinaryOperationDimensionSource(first_child_value.get(), second_child_value.get()));
+		int first_child_dimcount = p_first_child_value->DimensionCount();
+		int second_child_dimcount = p_second_child_value->DimensionCount();
+		EidosValue_SP result_dim_source(EidosValue::BinaryOperationDimensionSource(p_first_child_value.get(), p_second_child_value.get()));
 		
-		if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(first_child_value.get(), second_child_value.get()))
+		if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(p_first_child_value.get(), p_second_child_value.get()))
 			EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_LtEq): non-conformable array operands to the '<=' operator." << EidosTerminate(operator_token);
 		
 		if (first_child_count == second_child_count)
@@ -4535,7 +4611,7 @@ EidosValue_SP EidosInterpreter::Evaluate_LtEq(const EidosASTNode *p_node)
 			if (first_child_count == 1)
 			{
 				// special-case the 1-to-1 comparison to return a statically allocated logical value, for speed
-				int compare_result = compareFunc(*first_child_value, 0, *second_child_value, 0, operator_token);
+				int compare_result = compareFunc(*p_first_child_value, 0, *p_second_child_value, 0, operator_token);
 				
 				if (!result_dim_source)
 					result_SP = (compare_result != 1) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF;
@@ -4549,7 +4625,7 @@ EidosValue_SP EidosInterpreter::Evaluate_LtEq(const EidosASTNode *p_node)
 				
 				for (int value_index = 0; value_index < first_child_count; ++value_index)
 				{
-					int compare_result = compareFunc(*first_child_value, value_index, *second_child_value, value_index, operator_token);
+					int compare_result = compareFunc(*p_first_child_value, value_index, *p_second_child_value, value_index, operator_token);
 					
 					logical_result->set_logical_no_check(compare_result != 1, value_index);
 				}
@@ -4564,7 +4640,7 @@ EidosValue_SP EidosInterpreter::Evaluate_LtEq(const EidosASTNode *p_node)
 			
 			for (int value_index = 0; value_index < second_child_count; ++value_index)
 			{
-				int compare_result = compareFunc(*first_child_value, 0, *second_child_value, value_index, operator_token);
+				int compare_result = compareFunc(*p_first_child_value, 0, *p_second_child_value, value_index, operator_token);
 				
 				logical_result->set_logical_no_check(compare_result != 1, value_index);
 			}
@@ -4578,7 +4654,7 @@ EidosValue_SP EidosInterpreter::Evaluate_LtEq(const EidosASTNode *p_node)
 			
 			for (int value_index = 0; value_index < first_child_count; ++value_index)
 			{
-				int compare_result = compareFunc(*first_child_value, value_index, *second_child_value, 0, operator_token);
+				int compare_result = compareFunc(*p_first_child_value, value_index, *p_second_child_value, 0, operator_token);
 				
 				logical_result->set_logical_no_check(compare_result != 1, value_index);
 			}
@@ -4599,7 +4675,6 @@ EidosValue_SP EidosInterpreter::Evaluate_LtEq(const EidosASTNode *p_node)
 		EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_LtEq): testing NULL with the '<=' operator is an error; use isNULL()." << EidosTerminate(operator_token);
 	}
 	
-	EIDOS_EXIT_EXECUTION_LOG("Evaluate_LtEq()");
 	return result_SP;
 }
 
@@ -4607,15 +4682,22 @@ EidosValue_SP EidosInterpreter::Evaluate_Gt(const EidosASTNode *p_node)
 {
 	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_Gt()");
 	EIDOS_ASSERT_CHILD_COUNT("EidosInterpreter::Evaluate_Gt", 2);
-
-	EidosToken *operator_token = p_node->token_;
-	EidosValue_Logical_SP result_SP;
 	
 	EidosValue_SP first_child_value = FastEvaluateNode(p_node->children_[0]);
 	EidosValue_SP second_child_value = FastEvaluateNode(p_node->children_[1]);
+	EidosValue_SP result_SP = _Evaluate_Gt_Internal(p_node, std::move(first_child_value), std::move(second_child_value));
 	
-	EidosValueType first_child_type = first_child_value->Type();
-	EidosValueType second_child_type = second_child_value->Type();
+	EIDOS_EXIT_EXECUTION_LOG("Evaluate_Gt()");
+	return result_SP;
+}
+
+EidosValue_SP EidosInterpreter::_Evaluate_Gt_Internal(const EidosASTNode *p_node, EidosValue_SP p_first_child_value, EidosValue_SP p_second_child_value)
+{
+	EidosToken *operator_token = p_node->token_;
+	EidosValue_Logical_SP result_SP;
+	
+	EidosValueType first_child_type = p_first_child_value->Type();
+	EidosValueType second_child_type = p_second_child_value->Type();
 	
 	if ((first_child_type == EidosValueType::kValueVOID) || (second_child_type == EidosValueType::kValueVOID))
 		EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Gt): operand type void is not supported by the '>' operator." << EidosTerminate(operator_token);
@@ -4625,16 +4707,16 @@ EidosValue_SP EidosInterpreter::Evaluate_Gt(const EidosASTNode *p_node)
 	if ((first_child_type != EidosValueType::kValueNULL) && (second_child_type != EidosValueType::kValueNULL))
 	{
 		// both operands are non-NULL, so we're doing a real comparison
-		int first_child_count = first_child_value->Count();
-		int second_child_count = second_child_value->Count();
+		int first_child_count = p_first_child_value->Count();
+		int second_child_count = p_second_child_value->Count();
 		EidosCompareFunctionPtr compareFunc = Eidos_GetCompareFunctionForTypes(first_child_type, second_child_type, operator_token);
 		
 		// matrices/arrays must be conformable, and we need to decide here which operand's dimensionality will be used for the result
-		int first_child_dimcount = first_child_value->DimensionCount();
-		int second_child_dimcount = second_child_value->DimensionCount();
-		EidosValue_SP result_dim_source(EidosValue::BinaryOperationDimensionSource(first_child_value.get(), second_child_value.get()));
+		int first_child_dimcount = p_first_child_value->DimensionCount();
+		int second_child_dimcount = p_second_child_value->DimensionCount();
+		EidosValue_SP result_dim_source(EidosValue::BinaryOperationDimensionSource(p_first_child_value.get(), p_second_child_value.get()));
 		
-		if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(first_child_value.get(), second_child_value.get()))
+		if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(p_first_child_value.get(), p_second_child_value.get()))
 			EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Gt): non-conformable array operands to the '>' operator." << EidosTerminate(operator_token);
 		
 		if (first_child_count == second_child_count)
@@ -4642,7 +4724,7 @@ EidosValue_SP EidosInterpreter::Evaluate_Gt(const EidosASTNode *p_node)
 			if (first_child_count == 1)
 			{
 				// special-case the 1-to-1 comparison to return a statically allocated logical value, for speed
-				int compare_result = compareFunc(*first_child_value, 0, *second_child_value, 0, operator_token);
+				int compare_result = compareFunc(*p_first_child_value, 0, *p_second_child_value, 0, operator_token);
 				
 				if (!result_dim_source)
 					result_SP = (compare_result == 1) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF;
@@ -4656,7 +4738,7 @@ EidosValue_SP EidosInterpreter::Evaluate_Gt(const EidosASTNode *p_node)
 				
 				for (int value_index = 0; value_index < first_child_count; ++value_index)
 				{
-					int compare_result = compareFunc(*first_child_value, value_index, *second_child_value, value_index, operator_token);
+					int compare_result = compareFunc(*p_first_child_value, value_index, *p_second_child_value, value_index, operator_token);
 					
 					logical_result->set_logical_no_check(compare_result == 1, value_index);
 				}
@@ -4671,7 +4753,7 @@ EidosValue_SP EidosInterpreter::Evaluate_Gt(const EidosASTNode *p_node)
 			
 			for (int value_index = 0; value_index < second_child_count; ++value_index)
 			{
-				int compare_result = compareFunc(*first_child_value, 0, *second_child_value, value_index, operator_token);
+				int compare_result = compareFunc(*p_first_child_value, 0, *p_second_child_value, value_index, operator_token);
 				
 				logical_result->set_logical_no_check(compare_result == 1, value_index);
 			}
@@ -4685,7 +4767,7 @@ EidosValue_SP EidosInterpreter::Evaluate_Gt(const EidosASTNode *p_node)
 			
 			for (int value_index = 0; value_index < first_child_count; ++value_index)
 			{
-				int compare_result = compareFunc(*first_child_value, value_index, *second_child_value, 0, operator_token);
+				int compare_result = compareFunc(*p_first_child_value, value_index, *p_second_child_value, 0, operator_token);
 				
 				logical_result->set_logical_no_check(compare_result == 1, value_index);
 			}
@@ -4706,7 +4788,6 @@ EidosValue_SP EidosInterpreter::Evaluate_Gt(const EidosASTNode *p_node)
 		EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_Gt): testing NULL with the '>' operator is an error; use isNULL()." << EidosTerminate(operator_token);
 	}
 	
-	EIDOS_EXIT_EXECUTION_LOG("Evaluate_Gt()");
 	return result_SP;
 }
 
@@ -4714,15 +4795,22 @@ EidosValue_SP EidosInterpreter::Evaluate_GtEq(const EidosASTNode *p_node)
 {
 	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_GtEq()");
 	EIDOS_ASSERT_CHILD_COUNT("EidosInterpreter::Evaluate_GtEq", 2);
-
-	EidosToken *operator_token = p_node->token_;
-	EidosValue_Logical_SP result_SP;
 	
 	EidosValue_SP first_child_value = FastEvaluateNode(p_node->children_[0]);
 	EidosValue_SP second_child_value = FastEvaluateNode(p_node->children_[1]);
+	EidosValue_SP result_SP = _Evaluate_GtEq_Internal(p_node, std::move(first_child_value), std::move(second_child_value));
 	
-	EidosValueType first_child_type = first_child_value->Type();
-	EidosValueType second_child_type = second_child_value->Type();
+	EIDOS_EXIT_EXECUTION_LOG("Evaluate_GtEq()");
+	return result_SP;
+}
+
+EidosValue_SP EidosInterpreter::_Evaluate_GtEq_Internal(const EidosASTNode *p_node, EidosValue_SP p_first_child_value, EidosValue_SP p_second_child_value)
+{
+	EidosToken *operator_token = p_node->token_;
+	EidosValue_Logical_SP result_SP;
+	
+	EidosValueType first_child_type = p_first_child_value->Type();
+	EidosValueType second_child_type = p_second_child_value->Type();
 	
 	if ((first_child_type == EidosValueType::kValueVOID) || (second_child_type == EidosValueType::kValueVOID))
 		EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_GtEq): operand type void is not supported by the '>=' operator." << EidosTerminate(operator_token);
@@ -4732,16 +4820,16 @@ EidosValue_SP EidosInterpreter::Evaluate_GtEq(const EidosASTNode *p_node)
 	if ((first_child_type != EidosValueType::kValueNULL) && (second_child_type != EidosValueType::kValueNULL))
 	{
 		// both operands are non-NULL, so we're doing a real comparison
-		int first_child_count = first_child_value->Count();
-		int second_child_count = second_child_value->Count();
+		int first_child_count = p_first_child_value->Count();
+		int second_child_count = p_second_child_value->Count();
 		EidosCompareFunctionPtr compareFunc = Eidos_GetCompareFunctionForTypes(first_child_type, second_child_type, operator_token);
 		
 		// matrices/arrays must be conformable, and we need to decide here which operand's dimensionality will be used for the result
-		int first_child_dimcount = first_child_value->DimensionCount();
-		int second_child_dimcount = second_child_value->DimensionCount();
-		EidosValue_SP result_dim_source(EidosValue::BinaryOperationDimensionSource(first_child_value.get(), second_child_value.get()));
+		int first_child_dimcount = p_first_child_value->DimensionCount();
+		int second_child_dimcount = p_second_child_value->DimensionCount();
+		EidosValue_SP result_dim_source(EidosValue::BinaryOperationDimensionSource(p_first_child_value.get(), p_second_child_value.get()));
 		
-		if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(first_child_value.get(), second_child_value.get()))
+		if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(p_first_child_value.get(), p_second_child_value.get()))
 			EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_GtEq): non-conformable array operands to the '>=' operator." << EidosTerminate(operator_token);
 		
 		if (first_child_count == second_child_count)
@@ -4749,7 +4837,7 @@ EidosValue_SP EidosInterpreter::Evaluate_GtEq(const EidosASTNode *p_node)
 			if (first_child_count == 1)
 			{
 				// special-case the 1-to-1 comparison to return a statically allocated logical value, for speed
-				int compare_result = compareFunc(*first_child_value, 0, *second_child_value, 0, operator_token);
+				int compare_result = compareFunc(*p_first_child_value, 0, *p_second_child_value, 0, operator_token);
 				
 				if (!result_dim_source)
 					result_SP = (compare_result != -1) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF;
@@ -4763,7 +4851,7 @@ EidosValue_SP EidosInterpreter::Evaluate_GtEq(const EidosASTNode *p_node)
 				
 				for (int value_index = 0; value_index < first_child_count; ++value_index)
 				{
-					int compare_result = compareFunc(*first_child_value, value_index, *second_child_value, value_index, operator_token);
+					int compare_result = compareFunc(*p_first_child_value, value_index, *p_second_child_value, value_index, operator_token);
 					
 					logical_result->set_logical_no_check(compare_result != -1, value_index);
 				}
@@ -4778,7 +4866,7 @@ EidosValue_SP EidosInterpreter::Evaluate_GtEq(const EidosASTNode *p_node)
 			
 			for (int value_index = 0; value_index < second_child_count; ++value_index)
 			{
-				int compare_result = compareFunc(*first_child_value, 0, *second_child_value, value_index, operator_token);
+				int compare_result = compareFunc(*p_first_child_value, 0, *p_second_child_value, value_index, operator_token);
 				
 				logical_result->set_logical_no_check(compare_result != -1, value_index);
 			}
@@ -4792,7 +4880,7 @@ EidosValue_SP EidosInterpreter::Evaluate_GtEq(const EidosASTNode *p_node)
 			
 			for (int value_index = 0; value_index < first_child_count; ++value_index)
 			{
-				int compare_result = compareFunc(*first_child_value, value_index, *second_child_value, 0, operator_token);
+				int compare_result = compareFunc(*p_first_child_value, value_index, *p_second_child_value, 0, operator_token);
 				
 				logical_result->set_logical_no_check(compare_result != -1, value_index);
 			}
@@ -4813,7 +4901,6 @@ EidosValue_SP EidosInterpreter::Evaluate_GtEq(const EidosASTNode *p_node)
 		EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_GtEq): testing NULL with the '>=' operator is an error; use isNULL()." << EidosTerminate(operator_token);
 	}
 	
-	EIDOS_EXIT_EXECUTION_LOG("Evaluate_GtEq()");
 	return result_SP;
 }
 
@@ -4821,15 +4908,22 @@ EidosValue_SP EidosInterpreter::Evaluate_NotEq(const EidosASTNode *p_node)
 {
 	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_NotEq()");
 	EIDOS_ASSERT_CHILD_COUNT("EidosInterpreter::Evaluate_NotEq", 2);
-
-	EidosToken *operator_token = p_node->token_;
-	EidosValue_Logical_SP result_SP;
 	
 	EidosValue_SP first_child_value = FastEvaluateNode(p_node->children_[0]);
 	EidosValue_SP second_child_value = FastEvaluateNode(p_node->children_[1]);
+	EidosValue_SP result_SP = _Evaluate_NotEq_Internal(p_node, std::move(first_child_value), std::move(second_child_value));
 	
-	EidosValueType first_child_type = first_child_value->Type();
-	EidosValueType second_child_type = second_child_value->Type();
+	EIDOS_EXIT_EXECUTION_LOG("Evaluate_NotEq()");
+	return result_SP;
+}
+
+EidosValue_SP EidosInterpreter::_Evaluate_NotEq_Internal(const EidosASTNode *p_node, EidosValue_SP p_first_child_value, EidosValue_SP p_second_child_value)
+{
+	EidosToken *operator_token = p_node->token_;
+	EidosValue_Logical_SP result_SP;
+	
+	EidosValueType first_child_type = p_first_child_value->Type();
+	EidosValueType second_child_type = p_second_child_value->Type();
 	
 	if ((first_child_type == EidosValueType::kValueVOID) || (second_child_type == EidosValueType::kValueVOID))
 		EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_NotEq): operand type void is not supported by the '!=' operator." << EidosTerminate(operator_token);
@@ -4837,16 +4931,16 @@ EidosValue_SP EidosInterpreter::Evaluate_NotEq(const EidosASTNode *p_node)
 	if ((first_child_type != EidosValueType::kValueNULL) && (second_child_type != EidosValueType::kValueNULL))
 	{
 		// both operands are non-NULL, so we're doing a real comparison
-		int first_child_count = first_child_value->Count();
-		int second_child_count = second_child_value->Count();
+		int first_child_count = p_first_child_value->Count();
+		int second_child_count = p_second_child_value->Count();
 		EidosCompareFunctionPtr compareFunc = Eidos_GetCompareFunctionForTypes(first_child_type, second_child_type, operator_token);
 		
 		// matrices/arrays must be conformable, and we need to decide here which operand's dimensionality will be used for the result
-		int first_child_dimcount = first_child_value->DimensionCount();
-		int second_child_dimcount = second_child_value->DimensionCount();
-		EidosValue_SP result_dim_source(EidosValue::BinaryOperationDimensionSource(first_child_value.get(), second_child_value.get()));
+		int first_child_dimcount = p_first_child_value->DimensionCount();
+		int second_child_dimcount = p_second_child_value->DimensionCount();
+		EidosValue_SP result_dim_source(EidosValue::BinaryOperationDimensionSource(p_first_child_value.get(), p_second_child_value.get()));
 		
-		if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(first_child_value.get(), second_child_value.get()))
+		if ((first_child_dimcount > 1) && (second_child_dimcount > 1) && !EidosValue::MatchingDimensions(p_first_child_value.get(), p_second_child_value.get()))
 			EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_NotEq): non-conformable array operands to the '!=' operator." << EidosTerminate(operator_token);
 		
 		if (first_child_count == second_child_count)
@@ -4854,7 +4948,7 @@ EidosValue_SP EidosInterpreter::Evaluate_NotEq(const EidosASTNode *p_node)
 			if (first_child_count == 1)
 			{
 				// special-case the 1-to-1 comparison to return a statically allocated logical value, for speed
-				int compare_result = compareFunc(*first_child_value, 0, *second_child_value, 0, operator_token);
+				int compare_result = compareFunc(*p_first_child_value, 0, *p_second_child_value, 0, operator_token);
 				
 				if (!result_dim_source)
 					result_SP = (compare_result != 0) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF;
@@ -4869,8 +4963,8 @@ EidosValue_SP EidosInterpreter::Evaluate_NotEq(const EidosASTNode *p_node)
 				if ((first_child_type == EidosValueType::kValueFloat) && (second_child_type == EidosValueType::kValueFloat))
 				{
 					// Direct float-to-float compare can be optimized through vector access
-					const double *float1_data = first_child_value->FloatVector()->data();
-					const double *float2_data = second_child_value->FloatVector()->data();
+					const double *float1_data = p_first_child_value->FloatVector()->data();
+					const double *float2_data = p_second_child_value->FloatVector()->data();
 					
 					for (int value_index = 0; value_index < first_child_count; ++value_index)
 						logical_result->set_logical_no_check(float1_data[value_index] != float2_data[value_index], value_index);
@@ -4878,8 +4972,8 @@ EidosValue_SP EidosInterpreter::Evaluate_NotEq(const EidosASTNode *p_node)
 				else if ((first_child_type == EidosValueType::kValueInt) && (second_child_type == EidosValueType::kValueInt))
 				{
 					// Direct int-to-int compare can be optimized through vector access
-					const int64_t *int1_data = first_child_value->IntVector()->data();
-					const int64_t *int2_data = second_child_value->IntVector()->data();
+					const int64_t *int1_data = p_first_child_value->IntVector()->data();
+					const int64_t *int2_data = p_second_child_value->IntVector()->data();
 					
 					for (int value_index = 0; value_index < first_child_count; ++value_index)
 						logical_result->set_logical_no_check(int1_data[value_index] != int2_data[value_index], value_index);
@@ -4887,8 +4981,8 @@ EidosValue_SP EidosInterpreter::Evaluate_NotEq(const EidosASTNode *p_node)
 				else if ((first_child_type == EidosValueType::kValueObject) && (second_child_type == EidosValueType::kValueObject))
 				{
 					// Direct object-to-object compare can be optimized through vector access
-					EidosObjectElement * const *obj1_vec = first_child_value->ObjectElementVector()->data();
-					EidosObjectElement * const *obj2_vec = second_child_value->ObjectElementVector()->data();
+					EidosObjectElement * const *obj1_vec = p_first_child_value->ObjectElementVector()->data();
+					EidosObjectElement * const *obj2_vec = p_second_child_value->ObjectElementVector()->data();
 					
 					for (int value_index = 0; value_index < first_child_count; ++value_index)
 						logical_result->set_logical_no_check(obj1_vec[value_index] != obj2_vec[value_index], value_index);
@@ -4897,7 +4991,7 @@ EidosValue_SP EidosInterpreter::Evaluate_NotEq(const EidosASTNode *p_node)
 				{
 					// General case
 					for (int value_index = 0; value_index < first_child_count; ++value_index)
-						logical_result->set_logical_no_check(compareFunc(*first_child_value, value_index, *second_child_value, value_index, operator_token) != 0, value_index);
+						logical_result->set_logical_no_check(compareFunc(*p_first_child_value, value_index, *p_second_child_value, value_index, operator_token) != 0, value_index);
 				}
 				
 				result_SP = std::move(logical_result_SP);
@@ -4911,8 +5005,8 @@ EidosValue_SP EidosInterpreter::Evaluate_NotEq(const EidosASTNode *p_node)
 			if ((compareFunc == &CompareEidosValues_Float) && (second_child_type == EidosValueType::kValueFloat))
 			{
 				// Direct float-to-float compare can be optimized through vector access; note the singleton might get promoted to float
-				double float1 = first_child_value->FloatAtIndex(0, operator_token);
-				const double *float_data = second_child_value->FloatVector()->data();
+				double float1 = p_first_child_value->FloatAtIndex(0, operator_token);
+				const double *float_data = p_second_child_value->FloatVector()->data();
 				
 				for (int value_index = 0; value_index < second_child_count; ++value_index)
 					logical_result->set_logical_no_check(float1 != float_data[value_index], value_index);
@@ -4920,8 +5014,8 @@ EidosValue_SP EidosInterpreter::Evaluate_NotEq(const EidosASTNode *p_node)
 			else if ((compareFunc == &CompareEidosValues_Int) && (second_child_type == EidosValueType::kValueInt))
 			{
 				// Direct int-to-int compare can be optimized through vector access; note the singleton might get promoted to int
-				int64_t int1 = first_child_value->IntAtIndex(0, operator_token);
-				const int64_t *int_data = second_child_value->IntVector()->data();
+				int64_t int1 = p_first_child_value->IntAtIndex(0, operator_token);
+				const int64_t *int_data = p_second_child_value->IntVector()->data();
 				
 				for (int value_index = 0; value_index < second_child_count; ++value_index)
 					logical_result->set_logical_no_check(int1 != int_data[value_index], value_index);
@@ -4929,8 +5023,8 @@ EidosValue_SP EidosInterpreter::Evaluate_NotEq(const EidosASTNode *p_node)
 			else if ((compareFunc == &CompareEidosValues_Object) && (second_child_type == EidosValueType::kValueObject))
 			{
 				// Direct object-to-object compare can be optimized through vector access
-				EidosObjectElement *obj1 = first_child_value->ObjectElementAtIndex(0, operator_token);
-				EidosObjectElement * const *obj_vec = second_child_value->ObjectElementVector()->data();
+				EidosObjectElement *obj1 = p_first_child_value->ObjectElementAtIndex(0, operator_token);
+				EidosObjectElement * const *obj_vec = p_second_child_value->ObjectElementVector()->data();
 				
 				for (int value_index = 0; value_index < second_child_count; ++value_index)
 					logical_result->set_logical_no_check(obj1 != obj_vec[value_index], value_index);
@@ -4939,7 +5033,7 @@ EidosValue_SP EidosInterpreter::Evaluate_NotEq(const EidosASTNode *p_node)
 			{
 				// General case
 				for (int value_index = 0; value_index < second_child_count; ++value_index)
-					logical_result->set_logical_no_check(compareFunc(*first_child_value, 0, *second_child_value, value_index, operator_token) != 0, value_index);
+					logical_result->set_logical_no_check(compareFunc(*p_first_child_value, 0, *p_second_child_value, value_index, operator_token) != 0, value_index);
 			}
 			
 			result_SP = std::move(logical_result_SP);
@@ -4952,8 +5046,8 @@ EidosValue_SP EidosInterpreter::Evaluate_NotEq(const EidosASTNode *p_node)
 			if ((compareFunc == &CompareEidosValues_Float) && (first_child_type == EidosValueType::kValueFloat))
 			{
 				// Direct float-to-float compare can be optimized through vector access; note the singleton might get promoted to float
-				double float2 = second_child_value->FloatAtIndex(0, operator_token);
-				const double *float_data = first_child_value->FloatVector()->data();
+				double float2 = p_second_child_value->FloatAtIndex(0, operator_token);
+				const double *float_data = p_first_child_value->FloatVector()->data();
 				
 				for (int value_index = 0; value_index < first_child_count; ++value_index)
 					logical_result->set_logical_no_check(float_data[value_index] != float2, value_index);
@@ -4961,8 +5055,8 @@ EidosValue_SP EidosInterpreter::Evaluate_NotEq(const EidosASTNode *p_node)
 			else if ((compareFunc == &CompareEidosValues_Int) && (first_child_type == EidosValueType::kValueInt))
 			{
 				// Direct int-to-int compare can be optimized through vector access; note the singleton might get promoted to int
-				int64_t int2 = second_child_value->IntAtIndex(0, operator_token);
-				const int64_t *int_data = first_child_value->IntVector()->data();
+				int64_t int2 = p_second_child_value->IntAtIndex(0, operator_token);
+				const int64_t *int_data = p_first_child_value->IntVector()->data();
 				
 				for (int value_index = 0; value_index < first_child_count; ++value_index)
 					logical_result->set_logical_no_check(int_data[value_index] != int2, value_index);
@@ -4970,8 +5064,8 @@ EidosValue_SP EidosInterpreter::Evaluate_NotEq(const EidosASTNode *p_node)
 			else if ((compareFunc == &CompareEidosValues_Object) && (first_child_type == EidosValueType::kValueObject))
 			{
 				// Direct object-to-object compare can be optimized through vector access
-				EidosObjectElement *obj2 = second_child_value->ObjectElementAtIndex(0, operator_token);
-				EidosObjectElement * const *obj_vec = first_child_value->ObjectElementVector()->data();
+				EidosObjectElement *obj2 = p_second_child_value->ObjectElementAtIndex(0, operator_token);
+				EidosObjectElement * const *obj_vec = p_first_child_value->ObjectElementVector()->data();
 				
 				for (int value_index = 0; value_index < first_child_count; ++value_index)
 					logical_result->set_logical_no_check(obj_vec[value_index] != obj2, value_index);
@@ -4980,7 +5074,7 @@ EidosValue_SP EidosInterpreter::Evaluate_NotEq(const EidosASTNode *p_node)
 			{
 				// General case
 				for (int value_index = 0; value_index < first_child_count; ++value_index)
-					logical_result->set_logical_no_check(compareFunc(*first_child_value, value_index, *second_child_value, 0, operator_token) != 0, value_index);
+					logical_result->set_logical_no_check(compareFunc(*p_first_child_value, value_index, *p_second_child_value, 0, operator_token) != 0, value_index);
 			}
 			
 			result_SP = std::move(logical_result_SP);
@@ -4999,7 +5093,6 @@ EidosValue_SP EidosInterpreter::Evaluate_NotEq(const EidosASTNode *p_node)
 		EIDOS_TERMINATION << "ERROR (EidosInterpreter::Evaluate_NotEq): testing NULL with the '!=' operator is an error; use isNULL()." << EidosTerminate(operator_token);
 	}
 	
-	EIDOS_EXIT_EXECUTION_LOG("Evaluate_NotEq()");
 	return result_SP;
 }
 
@@ -5107,6 +5200,164 @@ EidosValue_SP EidosInterpreter::NumericValueForString(const std::string &p_numbe
 	}
 }
 
+// Type-specialized evaluators for binary operators whose operand types have been inferred by EidosTypeInterpreter; these are
+// installed by EidosASTNode::OptimizeTypeSpecializations().  The inference is flow-insensitive and knows nothing of sizes or
+// dimensions, so it can be wrong; these evaluators therefore check that the operands are singletons of the expected types,
+// without dimensions, and otherwise hand the operands they have already evaluated to the generic evaluator's _Internal() method,
+// so that no operand is ever evaluated twice.
+static inline __attribute__((always_inline)) EidosEvaluationMethod _GenericEvaluatorForOperator(EidosTokenType p_operator)
+{
+	switch (p_operator)
+	{
+		case EidosTokenType::kTokenPlus:	return &EidosInterpreter::Evaluate_Plus;
+		case EidosTokenType::kTokenMinus:	return &EidosInterpreter::Evaluate_Minus;
+		case EidosTokenType::kTokenMult:	return &EidosInterpreter::Evaluate_Mult;
+		case EidosTokenType::kTokenDiv:		return &EidosInterpreter::Evaluate_Div;
+		case EidosTokenType::kTokenMod:		return &EidosInterpreter::Evaluate_Mod;
+		case EidosTokenType::kTokenExp:		return &EidosInterpreter::Evaluate_Exp;
+		case EidosTokenType::kTokenLt:		return &EidosInterpreter::Evaluate_Lt;
+		case EidosTokenType::kTokenLtEq:	return &EidosInterpreter::Evaluate_LtEq;
+		case EidosTokenType::kTokenGt:		return &EidosInterpreter::Evaluate_Gt;
+		case EidosTokenType::kTokenGtEq:	return &EidosInterpreter::Evaluate_GtEq;
+		case EidosTokenType::kTokenEq:		return &EidosInterpreter::Evaluate_Eq;
+		case EidosTokenType::kTokenNotEq:	return &EidosInterpreter::Evaluate_NotEq;
+		default:							return nullptr;
+	}
+}
+
+typedef EidosValue_SP (EidosInterpreter::*EidosOperandEvaluationMethod)(const EidosASTNode *p_node, EidosValue_SP p_first_child_value, EidosValue_SP p_second_child_value);
+
+static inline __attribute__((always_inline)) EidosOperandEvaluationMethod _GenericOperandEvaluatorForOperator(EidosTokenType p_operator)
+{
+	switch (p_operator)
+	{
+		case EidosTokenType::kTokenPlus:	return &EidosInterpreter::_Evaluate_Plus_Internal;
+		case EidosTokenType::kTokenMinus:	return &EidosInterpreter::_Evaluate_Minus_Internal;
+		case EidosTokenType::kTokenMult:	return &EidosInterpreter::_Evaluate_Mult_Internal;
+		case EidosTokenType::kTokenDiv:		return &EidosInterpreter::_Evaluate_Div_Internal;
+		case EidosTokenType::kTokenMod:		return &EidosInterpreter::_Evaluate_Mod_Internal;
+		case EidosTokenType::kTokenExp:		return &EidosInterpreter::_Evaluate_Exp_Internal;
+		case EidosTokenType::kTokenLt:		return &EidosInterpreter::_Evaluate_Lt_Internal;
+		case EidosTokenType::kTokenLtEq:	return &EidosInterpreter::_Evaluate_LtEq_Internal;
+		case EidosTokenType::kTokenGt:		return &EidosInterpreter::_Evaluate_Gt_Internal;
+		case EidosTokenType::kTokenGtEq:	return &EidosInterpreter::_Evaluate_GtEq_Internal;
+		case EidosTokenType::kTokenEq:		return &EidosInterpreter::_Evaluate_Eq_Internal;
+		case EidosTokenType::kTokenNotEq:	return &EidosInterpreter::_Evaluate_NotEq_Internal;
+		default:							return nullptr;
+	}
+}
+
+template <EidosTokenType OPERATOR, EidosValueType TYPE1, EidosValueType TYPE2>
+EidosValue_SP EidosInterpreter::Evaluate_TypeSpecialized(const EidosASTNode *p_node)
+{
+#if defined(DEBUG) || defined(EIDOS_GUI)
+	// When logging execution, use the generic evaluator so everything gets logged correctly
+	if (logging_execution_)
+		return (this->*_GenericEvaluatorForOperator(OPERATOR))(p_node);
+#endif
+	
+	EidosValue_SP first_child_value = FastEvaluateNode(p_node->children_[0]);
+	EidosValue_SP second_child_value = FastEvaluateNode(p_node->children_[1]);
+	const EidosValue *first_child = first_child_value.get();
+	const EidosValue *second_child = second_child_value.get();
+	
+	if ((first_child->Type() == TYPE1) && (second_child->Type() == TYPE2) && (first_child->Count() == 1) && (second_child->Count() == 1) && (first_child->DimensionCount() == 1) && (second_child->DimensionCount() == 1))
+	{
+		if ((TYPE1 == EidosValueType::kValueInt) && (TYPE2 == EidosValueType::kValueInt) && (OPERATOR != EidosTokenType::kTokenDiv) && (OPERATOR != EidosTokenType::kTokenMod) && (OPERATOR != EidosTokenType::kTokenExp))
+		{
+			int64_t first_operand = first_child->IntAtIndex(0, nullptr);
+			int64_t second_operand = second_child->IntAtIndex(0, nullptr);
+			int64_t int_result;
+			
+			switch (OPERATOR)
+			{
+				// on overflow, we drop through to the generic evaluator, which raises
+				case EidosTokenType::kTokenPlus:
+					if (Eidos_add_overflow(first_operand, second_operand, &int_result)) break;
+					return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int_singleton(int_result));
+				case EidosTokenType::kTokenMinus:
+					if (Eidos_sub_overflow(first_operand, second_operand, &int_result)) break;
+					return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int_singleton(int_result));
+				case EidosTokenType::kTokenMult:
+					if (Eidos_mul_overflow(first_operand, second_operand, &int_result)) break;
+					return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int_singleton(int_result));
+				case EidosTokenType::kTokenLt:		return (first_operand < second_operand) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF;
+				case EidosTokenType::kTokenLtEq:	return (first_operand <= second_operand) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF;
+				case EidosTokenType::kTokenGt:		return (first_operand > second_operand) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF;
+				case EidosTokenType::kTokenGtEq:	return (first_operand >= second_operand) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF;
+				case EidosTokenType::kTokenEq:		return (first_operand == second_operand) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF;
+				case EidosTokenType::kTokenNotEq:	return (first_operand != second_operand) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF;
+				default: break;
+			}
+		}
+		else
+		{
+			// float arithmetic, as in the generic evaluators; / % ^ always produce float.  Comparisons follow CompareEidosValues_Float(),
+			// which treats unordered operands (NAN) as equal, so we compute its -1/0/1 result rather than using the C++ operators.
+			double first_operand = first_child->FloatAtIndex(0, nullptr);
+			double second_operand = second_child->FloatAtIndex(0, nullptr);
+			int compare_result = (first_operand < second_operand) ? -1 : ((first_operand > second_operand) ? 1 : 0);
+			
+			switch (OPERATOR)
+			{
+				case EidosTokenType::kTokenPlus:	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(first_operand + second_operand));
+				case EidosTokenType::kTokenMinus:	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(first_operand - second_operand));
+				case EidosTokenType::kTokenMult:	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(first_operand * second_operand));
+				case EidosTokenType::kTokenDiv:		return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(first_operand / second_operand));
+				case EidosTokenType::kTokenMod:		return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(fmod(first_operand, second_operand)));
+				case EidosTokenType::kTokenExp:		return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float_singleton(pow(first_operand, second_operand)));
+				case EidosTokenType::kTokenLt:		return (compare_result == -1) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF;
+				case EidosTokenType::kTokenLtEq:	return (compare_result != 1) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF;
+				case EidosTokenType::kTokenGt:		return (compare_result == 1) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF;
+				case EidosTokenType::kTokenGtEq:	return (compare_result != -1) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF;
+				case EidosTokenType::kTokenEq:		return (compare_result == 0) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF;
+				case EidosTokenType::kTokenNotEq:	return (compare_result != 0) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF;
+				default: break;
+			}
+		}
+	}
+	
+	return (this->*_GenericOperandEvaluatorForOperator(OPERATOR))(p_node, std::move(first_child_value), std::move(second_child_value));
+}
+
+#define EIDOS_TYPE_SPECIALIZED_EVALUATOR(OPERATOR)	\
+	case OPERATOR:	\
+		if (first_is_int && second_is_int)	return &EidosInterpreter::Evaluate_TypeSpecialized<OPERATOR, EidosValueType::kValueInt, EidosValueType::kValueInt>;	\
+		if (first_is_int)					return &EidosInterpreter::Evaluate_TypeSpecialized<OPERATOR, EidosValueType::kValueInt, EidosValueType::kValueFloat>;	\
+		if (second_is_int)					return &EidosInterpreter::Evaluate_TypeSpecialized<OPERATOR, EidosValueType::kValueFloat, EidosValueType::kValueInt>;	\
+		return &EidosInterpreter::Evaluate_TypeSpecialized<OPERATOR, EidosValueType::kValueFloat, EidosValueType::kValueFloat>;
+
+EidosEvaluationMethod EidosInterpreter::TypeSpecializedEvaluator(EidosTokenType p_operator, EidosValueMask p_first_type, EidosValueMask p_second_type)
+{
+	// Returns a specialized evaluator for p_operator with operands of the given inferred types, or nullptr; only operands inferred
+	// to be exactly integer or exactly float are specialized
+	if (((p_first_type != kEidosValueMaskInt) && (p_first_type != kEidosValueMaskFloat)) || ((p_second_type != kEidosValueMaskInt) && (p_second_type != kEidosValueMaskFloat)))
+		return nullptr;
+	
+	bool first_is_int = (p_first_type == kEidosValueMaskInt);
+	bool second_is_int = (p_second_type == kEidosValueMaskInt);
+	
+	switch (p_operator)
+	{
+		EIDOS_TYPE_SPECIALIZED_EVALUATOR(EidosTokenType::kTokenPlus)
+		EIDOS_TYPE_SPECIALIZED_EVALUATOR(EidosTokenType::kTokenMinus)
+		EIDOS_TYPE_SPECIALIZED_EVALUATOR(EidosTokenType::kTokenMult)
+		EIDOS_TYPE_SPECIALIZED_EVALUATOR(EidosTokenType::kTokenDiv)
+		EIDOS_TYPE_SPECIALIZED_EVALUATOR(EidosTokenType::kTokenMod)
+		EIDOS_TYPE_SPECIALIZED_EVALUATOR(EidosTokenType::kTokenExp)
+		EIDOS_TYPE_SPECIALIZED_EVALUATOR(EidosTokenType::kTokenLt)
+		EIDOS_TYPE_SPECIALIZED_EVALUATOR(EidosTokenType::kTokenLtEq)
+		EIDOS_TYPE_SPECIALIZED_EVALUATOR(EidosTokenType::kTokenGt)
+		EIDOS_TYPE_SPECIALIZED_EVALUATOR(EidosTokenType::kTokenGtEq)
+		EIDOS_TYPE_SPECIALIZED_EVALUATOR(EidosTokenType::kTokenEq)
+		EIDOS_TYPE_SPECIALIZED_EVALUATOR(EidosTokenType::kTokenNotEq)
+		default:
+			return nullptr;
+	}
+}
+
+#undef EIDOS_TYPE_SPECIALIZED_EVALUATOR
+
 EidosValue_SP EidosInterpreter::Evaluate_Number(const EidosASTNode *p_node)
 {
 	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_Number()");
@@ -120,10 +120,25 @@ public:
 	// Evaluation methods; the caller owns the returned EidosValue object
 	EidosValue_SP EvaluateInternalBlock(EidosScript *p_script_for_block);		// the starting point for internally executed blocks, which require braces and suppress output
 	EidosValue_SP EvaluateInterpreterBlock(bool p_print_output, bool p_return_last_value);		// the starting point for executed blocks in Eidos, which do not require braces
+	EidosValue_SP ExecuteBytecode(EidosBytecode &p_bytecode);									// runs a compiled block; implemented in eidos_bytecode.cpp
 	
 	void _ProcessSubsetAssignment(EidosValue_SP *p_base_value_ptr, EidosGlobalStringID *p_property_string_id_ptr, std::vector<int> *p_indices_ptr, const EidosASTNode *p_parent_node);
 	void _AssignRValueToLValue(EidosValue_SP p_rvalue, const EidosASTNode *p_lvalue_node);
 	EidosValue_SP _Evaluate_RangeExpr_Internal(const EidosASTNode *p_node, const EidosValue &p_first_child_value, const EidosValue &p_second_child_value);
+	EidosValue_SP _Evaluate_Plus_Internal(const EidosASTNode *p_node, EidosValue_SP p_first_child_value, EidosValue_SP p_second_child_value);		// binary operators on evaluated operands
+	EidosValue_SP _Evaluate_Minus_Internal(const EidosASTNode *p_node, EidosValue_SP p_first_child_value, EidosValue_SP p_second_child_value);
+	EidosValue_SP _Evaluate_Mod_Internal(const EidosASTNode *p_node, EidosValue_SP p_first_child_value, EidosValue_SP p_second_child_value);
+	EidosValue_SP _Evaluate_Mult_Internal(const EidosASTNode *p_node, EidosValue_SP p_first_child_value, EidosValue_SP p_second_child_value);
+	EidosValue_SP _Evaluate_Div_Internal(const EidosASTNode *p_node, EidosValue_SP p_first_child_value, EidosValue_SP p_second_child_value);
+	EidosValue_SP _Evaluate_Exp_Internal(const EidosASTNode *p_node, EidosValue_SP p_first_child_value, EidosValue_SP p_second_child_value);
+	EidosValue_SP _Evaluate_Eq_Internal(const EidosASTNode *p_node, EidosValue_SP p_first_child_value, EidosValue_SP p_second_child_value);
+	EidosValue_SP _Evaluate_Lt_Internal(const EidosASTNode *p_node, EidosValue_SP p_first_child_value, EidosValue_SP p_second_child_value);
+	EidosValue_SP _Evaluate_LtEq_Internal(const EidosASTNode *p_node, EidosValue_SP p_first_child_value, EidosValue_SP p_second_child_value);
+	EidosValue_SP _Evaluate_Gt_Internal(const EidosASTNode *p_node, EidosValue_SP p_first_child_value, EidosValue_SP p_second_child_value);
+	EidosValue_SP _Evaluate_GtEq_Internal(const EidosASTNode *p_node, EidosValue_SP p_first_child_value, EidosValue_SP p_second_child_value);
+	EidosValue_SP _Evaluate_NotEq_Internal(const EidosASTNode *p_node, EidosValue_SP p_first_child_value, EidosValue_SP p_second_child_value);
+	bool _EvaluateFusedExpression(const EidosFusedExpression &p_fused, bool p_reduce, EidosValue_SP *p_result, double *p_sum, int *p_count);		// implemented in eidos_fused_expression.cpp
+	EidosValue_SP _FallBackFromFusedExpression(const EidosASTNode *p_node, EidosFusedExpression &p_fused, EidosEvaluationMethod p_fallback_evaluator);
 	int _ProcessArgumentList(const EidosASTNode *p_node, const EidosCallSignature *p_call_signature, EidosValue_SP *p_arg_buffer);
 	
 	EidosValue_SP DispatchUserDefinedFunction(const EidosFunctionSignature &p_function_signature, const EidosValue_SP *const p_arguments, int p_argument_count);
@@ -154,6 +169,10 @@ public:
 	EidosValue_SP Evaluate_GtEq(const EidosASTNode *p_node);
 	EidosValue_SP Evaluate_Not(const EidosASTNode *p_node);
 	EidosValue_SP Evaluate_NotEq(const EidosASTNode *p_node);
+	template <EidosTokenType OPERATOR, EidosValueType TYPE1, EidosValueType TYPE2> EidosValue_SP Evaluate_TypeSpecialized(const EidosASTNode *p_node);
+	static EidosEvaluationMethod TypeSpecializedEvaluator(EidosTokenType p_operator, EidosValueMask p_first_type, EidosValueMask p_second_type);
+	EidosValue_SP Evaluate_FusedExpression(const EidosASTNode *p_node);
+	EidosValue_SP Evaluate_FusedReduction(const EidosASTNode *p_node);
 	EidosValue_SP Evaluate_Number(const EidosASTNode *p_node);
 	EidosValue_SP Evaluate_String(const EidosASTNode *p_node);
 	EidosValue_SP Evaluate_Identifier(const EidosASTNode *p_node);
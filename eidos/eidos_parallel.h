@@ -0,0 +1,238 @@
+//
+//  eidos_parallel.h
+//  Eidos
+//
+//  Copyright (c) 2019 Philipp Messer.  All rights reserved.
+//	A product of the Messer Lab, http://messerlab.org/slim/
+//
+
+//	This file is part of Eidos.
+//
+//	Eidos is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+//
+//	Eidos is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with Eidos.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+
+ This file contains the sorting and hashing algorithms used by vectorized built-in functions such as sort(), order(), unique(),
+ and match().  For vectors of at least gEidosParallelVectorThreshold elements, when gEidosMaxThreads > 1, they split their work
+ into one piece per thread; otherwise they do the same work on a single thread.  Either way, the result is defined by the input
+ alone, not by the number of threads or how they happen to be scheduled:
+
+ - Eidos_ParallelStableSort() is a stable sort.  Each piece is sorted with std::stable_sort(), and the sorted pieces are then
+   combined by a tree of std::merge() calls, which keep equivalent elements from the left piece first; since a stable sort has
+   only one possible result, this is the same as std::stable_sort() on the whole vector.
+
+ - Eidos_FirstOccurrenceIndexes() returns the index of the first occurrence of each distinct value, in order.  Each piece finds
+   the first occurrences within itself, and those candidates are then screened in order of index against a single hash table.
+
+ - Eidos_MatchIndexes() returns, for each element of one vector, the index of its first occurrence in another, or -1.  The hash
+   table of first occurrences is built on one thread, and is then only read, by any number of threads.
+
+ Equality here is ==, as elsewhere in Eidos, so a NAN is never equal to anything, even another NAN, and -0.0 is equal to 0.0.
+ Sorting uses EidosSortLess and EidosSortGreater, which put NAN last in both directions, since < and > alone do not order NAN
+ consistently; -0.0 and 0.0 are tied, and so keep their original order.
+
+ */
+
+#ifndef __Eidos__eidos_parallel__
+#define __Eidos__eidos_parallel__
+
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <functional>
+#include <unordered_set>
+#include <unordered_map>
+#include <cmath>
+
+#include "eidos_globals.h"
+
+
+// The number of pieces to split an operation on p_count elements into; 1 means that the operation should run on one thread
+inline int Eidos_ParallelPieceCount(int64_t p_count)
+{
+#ifdef _OPENMP
+	if ((gEidosMaxThreads > 1) && (p_count >= gEidosParallelVectorThreshold))
+		return gEidosMaxThreads;
+#else
+#pragma unused(p_count)
+#endif
+	
+	return 1;
+}
+
+// Hashes and compares elements through pointers to them, so that hash tables of elements need not copy them
+template <typename T>
+struct EidosPointeeHash
+{
+	inline size_t operator()(const T *p_element) const { return std::hash<T>()(*p_element); }
+};
+
+template <typename T>
+struct EidosPointeeEqual
+{
+	inline bool operator()(const T *p_element1, const T *p_element2) const { return (*p_element1 == *p_element2); }
+};
+
+// Comparators for sorting in ascending and descending order; NAN is placed last in both
+template <typename T>
+struct EidosSortLess
+{
+	inline bool operator()(const T &p_element1, const T &p_element2) const { return (p_element1 < p_element2); }
+};
+
+template <>
+struct EidosSortLess<double>
+{
+	inline bool operator()(double p_element1, double p_element2) const { return (p_element1 < p_element2) || (!std::isnan(p_element1) && std::isnan(p_element2)); }
+};
+
+template <typename T>
+struct EidosSortGreater
+{
+	inline bool operator()(const T &p_element1, const T &p_element2) const { return (p_element1 > p_element2); }
+};
+
+template <>
+struct EidosSortGreater<double>
+{
+	inline bool operator()(double p_element1, double p_element2) const { return (p_element1 > p_element2) || (!std::isnan(p_element1) && std::isnan(p_element2)); }
+};
+
+// A stable sort of p_data, with the same result as std::stable_sort()
+template <typename T, typename Compare>
+void Eidos_ParallelStableSort(T *p_data, int64_t p_count, Compare p_compare)
+{
+	int piece_count = Eidos_ParallelPieceCount(p_count);
+	
+	if (piece_count == 1)
+	{
+		std::stable_sort(p_data, p_data + p_count, p_compare);
+		return;
+	}
+	
+	std::vector<int64_t> piece_bounds(piece_count + 1);
+	
+	for (int piece_index = 0; piece_index <= piece_count; ++piece_index)
+		piece_bounds[piece_index] = (p_count * piece_index) / piece_count;
+	
+#pragma omp parallel for num_threads(piece_count) schedule(static, 1) default(none) shared(piece_count, piece_bounds, p_data, p_compare)
+	for (int piece_index = 0; piece_index < piece_count; ++piece_index)
+		std::stable_sort(p_data + piece_bounds[piece_index], p_data + piece_bounds[piece_index + 1], p_compare);
+	
+	// merge adjacent sorted runs pairwise, moving elements back and forth between p_data and a scratch buffer
+	std::vector<T> scratch(p_count);
+	T *source = p_data, *destination = scratch.data();
+	
+	for (int run_width = 1; run_width < piece_count; run_width *= 2)
+	{
+		int merge_count = (piece_count + 2 * run_width - 1) / (2 * run_width);
+		
+#pragma omp parallel for num_threads(merge_count) schedule(static, 1) default(none) shared(merge_count, run_width, piece_count, piece_bounds, source, destination, p_compare)
+		for (int merge_index = 0; merge_index < merge_count; ++merge_index)
+		{
+			int64_t first = piece_bounds[merge_index * 2 * run_width];
+			int64_t middle = piece_bounds[std::min(merge_index * 2 * run_width + run_width, piece_count)];
+			int64_t last = piece_bounds[std::min(merge_index * 2 * run_width + 2 * run_width, piece_count)];
+			
+			std::merge(std::make_move_iterator(source + first), std::make_move_iterator(source + middle),
+					   std::make_move_iterator(source + middle), std::make_move_iterator(source + last),
+					   destination + first, p_compare);
+		}
+		
+		std::swap(source, destination);
+	}
+	
+	if (source != p_data)
+		std::move(source, source + p_count, p_data);
+}
+
+// The indexes that would put p_data in sorted order, with ties kept in their original order and NAN last
+template <typename T>
+std::vector<int64_t> Eidos_ParallelSortIndexes(const T *p_data, int64_t p_count, bool p_ascending)
+{
+	std::vector<int64_t> indexes(p_count);
+	
+	for (int64_t index = 0; index < p_count; ++index)
+		indexes[index] = index;
+	
+	if (p_ascending)
+		Eidos_ParallelStableSort(indexes.data(), p_count, [p_data](int64_t i1, int64_t i2) {return EidosSortLess<T>()(p_data[i1], p_data[i2]);});
+	else
+		Eidos_ParallelStableSort(indexes.data(), p_count, [p_data](int64_t i1, int64_t i2) {return EidosSortGreater<T>()(p_data[i1], p_data[i2]);});
+	
+	return indexes;
+}
+
+// The index of the first occurrence of each distinct value in p_data, in increasing order
+template <typename T>
+std::vector<int64_t> Eidos_FirstOccurrenceIndexes(const T *p_data, int64_t p_count)
+{
+	typedef std::unordered_set<const T *, EidosPointeeHash<T>, EidosPointeeEqual<T>> EidosPointeeSet;
+	
+	std::vector<int64_t> first_indexes;
+	EidosPointeeSet seen;
+	int piece_count = Eidos_ParallelPieceCount(p_count);
+	
+	if (piece_count == 1)
+	{
+		for (int64_t index = 0; index < p_count; ++index)
+			if (seen.insert(p_data + index).second)
+				first_indexes.push_back(index);
+		
+		return first_indexes;
+	}
+	
+	// a value's first occurrence overall is necessarily its first occurrence within its piece, so only those are candidates
+	std::vector<std::vector<int64_t>> piece_candidates(piece_count);
+	
+#pragma omp parallel for num_threads(piece_count) schedule(static, 1) default(none) shared(piece_count, piece_candidates, p_data, p_count)
+	for (int piece_index = 0; piece_index < piece_count; ++piece_index)
+	{
+		int64_t first = (p_count * piece_index) / piece_count;
+		int64_t last = (p_count * (piece_index + 1)) / piece_count;
+		std::vector<int64_t> &candidates = piece_candidates[piece_index];
+		EidosPointeeSet piece_seen;
+		
+		for (int64_t index = first; index < last; ++index)
+			if (piece_seen.insert(p_data + index).second)
+				candidates.push_back(index);
+	}
+	
+	for (std::vector<int64_t> &candidates : piece_candidates)
+		for (int64_t index : candidates)
+			if (seen.insert(p_data + index).second)
+				first_indexes.push_back(index);
+	
+	return first_indexes;
+}
+
+// For each element of p_x, the index of its first occurrence in p_table, or -1 if it does not occur there
+template <typename T>
+void Eidos_MatchIndexes(const T *p_x, int64_t p_x_count, const T *p_table, int64_t p_table_count, int64_t *p_result)
+{
+	std::unordered_map<const T *, int64_t, EidosPointeeHash<T>, EidosPointeeEqual<T>> table_indexes;
+	
+	table_indexes.reserve(p_table_count);
+	
+	for (int64_t table_index = 0; table_index < p_table_count; ++table_index)
+		table_indexes.emplace(p_table + table_index, table_index);		// keeps the existing entry for a value already seen
+	
+	int piece_count = Eidos_ParallelPieceCount(p_x_count);
+	
+#pragma omp parallel for num_threads(piece_count) schedule(static) default(none) shared(table_indexes, p_x, p_x_count, p_result) if(piece_count > 1)
+	for (int64_t x_index = 0; x_index < p_x_count; ++x_index)
+	{
+		auto found_iter = table_indexes.find(p_x + x_index);
+		
+		p_result[x_index] = ((found_iter == table_indexes.end()) ? -1 : found_iter->second);
+	}
+}
+
+
+#endif /* defined(__Eidos__eidos_parallel__) */
@@ -43,19 +43,24 @@ unsigned long int Eidos_GenerateSeedFromPIDAndTime(void)
 	return (unsigned long int)milliseconds;
 }
 
-void Eidos_InitializeRNG(void)
+void Eidos_InitializeRNGState(Eidos_RNG_State &p_rng)
 {
 	// Allocate the RNG if needed
-	if (!gEidos_RNG.gsl_rng_)
-		gEidos_RNG.gsl_rng_ = gsl_rng_alloc(gsl_rng_taus2);	// the assumption of taus2 is hard-coded in eidos_rng.h
+	if (!p_rng.gsl_rng_)
+		p_rng.gsl_rng_ = gsl_rng_alloc(gsl_rng_taus2);	// the assumption of taus2 is hard-coded in eidos_rng.h
 	
-	if (!gEidos_RNG.mt_)
+	if (!p_rng.mt_)
 	{
-		gEidos_RNG.mt_ = (uint64_t *)malloc(Eidos_MT64_NN * sizeof(uint64_t));
-		gEidos_RNG.mti_ = Eidos_MT64_NN + 1;				// mti==NN+1 means mt[NN] is not initialized
+		p_rng.mt_ = (uint64_t *)malloc(Eidos_MT64_NN * sizeof(uint64_t));
+		p_rng.mti_ = Eidos_MT64_NN + 1;				// mti==NN+1 means mt[NN] is not initialized
 	}
 }
 
+void Eidos_InitializeRNG(void)
+{
+	Eidos_InitializeRNGState(gEidos_RNG);
+}
+
 void Eidos_FreeRNG(Eidos_RNG_State &p_rng)
 {
 	if (p_rng.gsl_rng_)
@@ -75,29 +80,48 @@ void Eidos_FreeRNG(Eidos_RNG_State &p_rng)
 	p_rng.random_bool_bit_counter_ = 0;
 }
 
-void Eidos_SetRNGSeed(unsigned long int p_seed)
+void Eidos_SetRNGStateSeed(Eidos_RNG_State &p_rng, unsigned long int p_seed)
 {
 	// BCH 12 Sept. 2016: it turns out that gsl_rng_taus2 produces exactly the same sequence for seeds 0 and 1.  This is obviously
 	// undesirable; people will often do a set of runs with sequential seeds starting at 0 and counting up, and they will get
 	// identical runs for 0 and 1.  There is no way to re-map the seed space to get rid of the problem altogether; all we can do
 	// is shift it to a place where it is unlikely to cause a problem.  So that's what we do.
 	if ((p_seed > 0) && (p_seed < 10000000000000000000UL))
-		gsl_rng_set(gEidos_RNG.gsl_rng_, p_seed + 1);	// map 1 -> 2, 2-> 3, 3-> 4, etc.
+		gsl_rng_set(p_rng.gsl_rng_, p_seed + 1);	// map 1 -> 2, 2-> 3, 3-> 4, etc.
 	else
-		gsl_rng_set(gEidos_RNG.gsl_rng_, p_seed);		// 0 stays 0
+		gsl_rng_set(p_rng.gsl_rng_, p_seed);		// 0 stays 0
 	
 	// BCH 13 May 2018: set the seed on the MT64 generator as well; we keep them synchronized in their seeding
-	Eidos_MT64_init_genrand64(p_seed);
+	Eidos_MT64_init_genrand64(p_rng, p_seed);
 	
 	// remember the seed as part of the RNG state
 	
 	// BCH 12 Sept. 2016: we want to return the user the same seed they requested, if they call getSeed(), so we save the requested
 	// seed, not the seed shifted by one that is actually passed to the GSL above.
-	gEidos_RNG.rng_last_seed_ = p_seed;
+	p_rng.rng_last_seed_ = p_seed;
 	
 	// These need to be zeroed out, too; they are part of our RNG state
-	gEidos_RNG.random_bool_bit_counter_ = 0;
-	gEidos_RNG.random_bool_bit_buffer_ = 0;
+	p_rng.random_bool_bit_counter_ = 0;
+	p_rng.random_bool_bit_buffer_ = 0;
+}
+
+void Eidos_SetRNGSeed(unsigned long int p_seed)
+{
+	Eidos_SetRNGStateSeed(gEidos_RNG, p_seed);
+}
+
+unsigned long int Eidos_RNGStreamSeed(unsigned long int p_base_seed, uint64_t p_stream_index)
+{
+	// This is the SplitMix64 generator's output function (Steele, Lea & Flood 2014), applied to the base seed advanced by
+	// (p_stream_index + 1) steps of the golden-ratio increment; it is a bijection of its input, and it mixes well, so each
+	// (seed, stream) pair gets a distinct, unrelated seed.  We never return the base seed itself, for stream 0 or otherwise.
+	uint64_t z = (uint64_t)p_base_seed + (p_stream_index + 1) * 0x9E3779B97F4A7C15ULL;
+	
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	z = z ^ (z >> 31);
+	
+	return (unsigned long int)z;
 }
 
 #ifndef USE_GSL_POISSON
@@ -121,6 +145,121 @@ double Eidos_FastRandomPoisson_PRECALCULATE(double p_mu)
 #endif
 
 
+#pragma mark -
+#pragma mark Weighted discrete draws
+#pragma mark -
+
+EidosAliasTable::~EidosAliasTable(void)
+{
+	free(cutoff_);
+	free(alias_);
+	free(scaled_);
+	free(smalls_);
+	free(bigs_);
+}
+
+void EidosAliasTable::Rebuild(size_t p_count, const double *p_weights)
+{
+	// This follows gsl_ran_discrete_preproc() step for step, so that the resulting table is identical; see the GSL's discrete.c
+	// for its commentary.  The main difference is that it works in buffers that are retained across calls.
+	if (p_count < 1)
+		EIDOS_TERMINATION << "ERROR (EidosAliasTable::Rebuild): (internal error) the number of weights must be positive." << EidosTerminate(nullptr);
+	
+	if (p_count > capacity_)
+	{
+		cutoff_ = (double *)realloc(cutoff_, p_count * sizeof(double));
+		alias_ = (size_t *)realloc(alias_, p_count * sizeof(size_t));
+		scaled_ = (double *)realloc(scaled_, p_count * sizeof(double));
+		smalls_ = (size_t *)realloc(smalls_, p_count * sizeof(size_t));
+		bigs_ = (size_t *)realloc(bigs_, p_count * sizeof(size_t));
+		
+		if (!cutoff_ || !alias_ || !scaled_ || !smalls_ || !bigs_)
+			EIDOS_TERMINATION << "ERROR (EidosAliasTable::Rebuild): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
+		
+		capacity_ = p_count;
+	}
+	
+	double total = 0.0;
+	
+	for (size_t k = 0; k < p_count; ++k)
+	{
+		double weight = p_weights[k];
+		
+		if (weight < 0)
+			EIDOS_TERMINATION << "ERROR (EidosAliasTable::Rebuild): (internal error) weights must be non-negative." << EidosTerminate(nullptr);
+		
+		total += weight;
+	}
+	
+	// Normalize the weights and sort the indices into the smalls and the bigs, in one pass; each stack receives its indices in
+	// increasing order, as in the GSL, which classifies in one pass and then pushes in a second pass
+	double mean = 1.0 / p_count;
+	size_t small_count = 0, big_count = 0;
+	
+	for (size_t k = 0; k < p_count; ++k)
+	{
+		double scaled_weight = p_weights[k] / total;
+		
+		scaled_[k] = scaled_weight;
+		
+		if (scaled_weight < mean)
+			smalls_[small_count++] = k;
+		else
+			bigs_[big_count++] = k;
+	}
+	
+	// Pair each small with a big that makes up its deficit
+	while (small_count > 0)
+	{
+		size_t s = smalls_[--small_count];
+		
+		if (big_count == 0)
+		{
+			alias_[s] = s;
+			cutoff_[s] = 1.0;
+			continue;
+		}
+		
+		size_t b = bigs_[--big_count];
+		
+		alias_[s] = b;
+		cutoff_[s] = p_count * scaled_[s];
+		
+		double d = mean - scaled_[s];
+		
+		scaled_[s] += d;
+		scaled_[b] -= d;
+		
+		if (scaled_[b] < mean)
+			smalls_[small_count++] = b;
+		else if (scaled_[b] > mean)
+			bigs_[big_count++] = b;
+		else
+		{
+			alias_[b] = b;
+			cutoff_[b] = 1.0;
+		}
+	}
+	
+	while (big_count > 0)
+	{
+		size_t b = bigs_[--big_count];
+		
+		alias_[b] = b;
+		cutoff_[b] = 1.0;
+	}
+	
+	// Knuth's convention, F'[k] = (k + F[k]) / K, which lets Draw() use the uniform deviate directly
+	for (size_t k = 0; k < p_count; ++k)
+	{
+		cutoff_[k] += k;
+		cutoff_[k] /= p_count;
+	}
+	
+	count_ = p_count;
+}
+
+
 #pragma mark -
 #pragma mark 64-bit MT
 #pragma mark -
@@ -129,11 +268,11 @@ double Eidos_FastRandomPoisson_PRECALCULATE(double p_mu)
 // reproduced in eidos_rng.h.  See eidos_rng.h for further comments on this code; most of the code is there.
 
 /* initializes mt[NN] with a seed */
-void Eidos_MT64_init_genrand64(uint64_t seed)
+void Eidos_MT64_init_genrand64(Eidos_RNG_State &p_rng, uint64_t seed)
 {
-	gEidos_RNG.mt_[0] = seed;
-	for (gEidos_RNG.mti_ = 1; gEidos_RNG.mti_ < Eidos_MT64_NN; gEidos_RNG.mti_++) 
-		gEidos_RNG.mt_[gEidos_RNG.mti_] =  (6364136223846793005ULL * (gEidos_RNG.mt_[gEidos_RNG.mti_ - 1] ^ (gEidos_RNG.mt_[gEidos_RNG.mti_ - 1] >> 62)) + gEidos_RNG.mti_);
+	p_rng.mt_[0] = seed;
+	for (p_rng.mti_ = 1; p_rng.mti_ < Eidos_MT64_NN; p_rng.mti_++) 
+		p_rng.mt_[p_rng.mti_] =  (6364136223846793005ULL * (p_rng.mt_[p_rng.mti_ - 1] ^ (p_rng.mt_[p_rng.mti_ - 1] >> 62)) + p_rng.mti_);
 }
 
 /* initialize by an array with array-length */
@@ -164,7 +303,7 @@ void Eidos_MT64_init_by_array64(uint64_t init_key[],
 }
 
 /* BCH: fill the next Eidos_MT64_NN words; used internally by genrand64_int64() */
-void _Eidos_MT64_fill()
+void _Eidos_MT64_fill(Eidos_RNG_State &p_rng)
 {
 	/* generate NN words at one time */
 	/* if init_genrand64() has not been called, */
@@ -175,21 +314,21 @@ void _Eidos_MT64_fill()
 	
 	// In the original code, this would fall back to some default seed value, but we
 	// don't want to allow the RNG to be used without being seeded first.  BCH 5/13/2018
-	if (gEidos_RNG.mti_ == Eidos_MT64_NN+1) 
+	if (p_rng.mti_ == Eidos_MT64_NN+1) 
 		abort(); 
 	
 	for (i=0;i<Eidos_MT64_NN-Eidos_MT64_MM;i++) {
-		x = (gEidos_RNG.mt_[i]&Eidos_MT64_UM)|(gEidos_RNG.mt_[i+1]&Eidos_MT64_LM);
-		gEidos_RNG.mt_[i] = gEidos_RNG.mt_[i+Eidos_MT64_MM] ^ (x>>1) ^ mag01[(int)(x&1ULL)];
+		x = (p_rng.mt_[i]&Eidos_MT64_UM)|(p_rng.mt_[i+1]&Eidos_MT64_LM);
+		p_rng.mt_[i] = p_rng.mt_[i+Eidos_MT64_MM] ^ (x>>1) ^ mag01[(int)(x&1ULL)];
 	}
 	for (;i<Eidos_MT64_NN-1;i++) {
-		x = (gEidos_RNG.mt_[i]&Eidos_MT64_UM)|(gEidos_RNG.mt_[i+1]&Eidos_MT64_LM);
-		gEidos_RNG.mt_[i] = gEidos_RNG.mt_[i+(Eidos_MT64_MM-Eidos_MT64_NN)] ^ (x>>1) ^ mag01[(int)(x&1ULL)];
+		x = (p_rng.mt_[i]&Eidos_MT64_UM)|(p_rng.mt_[i+1]&Eidos_MT64_LM);
+		p_rng.mt_[i] = p_rng.mt_[i+(Eidos_MT64_MM-Eidos_MT64_NN)] ^ (x>>1) ^ mag01[(int)(x&1ULL)];
 	}
-	x = (gEidos_RNG.mt_[Eidos_MT64_NN-1]&Eidos_MT64_UM)|(gEidos_RNG.mt_[0]&Eidos_MT64_LM);
-	gEidos_RNG.mt_[Eidos_MT64_NN-1] = gEidos_RNG.mt_[Eidos_MT64_MM-1] ^ (x>>1) ^ mag01[(int)(x&1ULL)];
+	x = (p_rng.mt_[Eidos_MT64_NN-1]&Eidos_MT64_UM)|(p_rng.mt_[0]&Eidos_MT64_LM);
+	p_rng.mt_[Eidos_MT64_NN-1] = p_rng.mt_[Eidos_MT64_MM-1] ^ (x>>1) ^ mag01[(int)(x&1ULL)];
 	
-	gEidos_RNG.mti_ = 0;
+	p_rng.mti_ = 0;
 }
 
 
@@ -20,6 +20,7 @@
 /*
  
  Eidos uses a globally shared random number generator called gEidos_RNG.  This file defines that global and relevant helper functions.
+ Independent RNG streams, for use by worker threads, can also be set up; see Eidos_RNGStreamSeed() below.
  
  */
 
@@ -34,6 +35,7 @@
 
 #include <stdint.h>
 #include <cmath>
+#include <vector>
 #include "eidos_globals.h"
 
 
@@ -83,6 +85,20 @@ void Eidos_InitializeRNG(void);
 void Eidos_FreeRNG(Eidos_RNG_State &p_rng);
 void Eidos_SetRNGSeed(unsigned long int p_seed);
 
+// An Eidos_RNG_State is a complete, self-contained RNG, so apart from gEidos_RNG other states can be set up and handed to code
+// that needs to draw random numbers without touching gEidos_RNG; in particular, to worker threads, which must not share an RNG.
+// These functions are the equivalents of Eidos_InitializeRNG() and Eidos_SetRNGSeed() for an arbitrary RNG state.
+void Eidos_InitializeRNGState(Eidos_RNG_State &p_rng);
+void Eidos_SetRNGStateSeed(Eidos_RNG_State &p_rng, unsigned long int p_seed);
+
+// Independent RNG streams.  Code that hands RNG states to worker threads should seed stream i of its own with Eidos_RNGStreamSeed(seed, i),
+// where seed is the seed of gEidos_RNG; that function mixes the base seed and the stream index with SplitMix64, so a given seed always
+// produces the same set of streams, and nearby seeds or stream indices produce unrelated streams.  (The taus2 generator has no practical
+// jump-ahead, so we split the sequence by seeding, not by jumping.)  Nothing is drawn from gEidos_RNG to seed a stream, so the sequence
+// of draws from gEidos_RNG is the same whether or not streams are in use.  The owner of the streams is responsible for reseeding them
+// when gEidos_RNG is reseeded, and for freeing them with Eidos_FreeRNG().
+unsigned long int Eidos_RNGStreamSeed(unsigned long int p_base_seed, uint64_t p_stream_index);
+
 
 // This code is copied and modified from taus.c in the GSL library because we want to be able to inline taus_get().
 // Random number generation can be a major bottleneck in many SLiM models, so I think this is worth the grossness.
@@ -202,12 +218,12 @@ static inline __attribute__((always_inline)) unsigned int Eidos_FastRandomPoisso
 	return x;
 }
 
-// This version allows the caller to supply a precalculated exp(-mu) value
-static inline __attribute__((always_inline)) unsigned int Eidos_FastRandomPoisson(double p_mu, double p_exp_neg_mu)
+// This version allows the caller to supply a precalculated exp(-mu) value, and draws from a given RNG
+static inline __attribute__((always_inline)) unsigned int Eidos_FastRandomPoisson(gsl_rng *p_r, double p_mu, double p_exp_neg_mu)
 {
 	// Defer to the GSL for large values of mu; see comments above.
 	if (p_mu > 250)
-		return gsl_ran_poisson(EIDOS_GSL_RNG, p_mu);
+		return gsl_ran_poisson(p_r, p_mu);
 	
 	// Test consistency; normally this is commented out
 	//if (p_exp_neg_mu != exp(-p_mu))
@@ -216,7 +232,7 @@ static inline __attribute__((always_inline)) unsigned int Eidos_FastRandomPoisso
 	unsigned int x = 0;
 	double p = p_exp_neg_mu;
 	double s = p;
-	double u = Eidos_rng_uniform(EIDOS_GSL_RNG);
+	double u = Eidos_rng_uniform(p_r);
 	
 	while (u > s)
 	{
@@ -230,8 +246,13 @@ static inline __attribute__((always_inline)) unsigned int Eidos_FastRandomPoisso
 	return x;
 }
 
+static inline __attribute__((always_inline)) unsigned int Eidos_FastRandomPoisson(double p_mu, double p_exp_neg_mu)
+{
+	return Eidos_FastRandomPoisson(EIDOS_GSL_RNG, p_mu, p_exp_neg_mu);
+}
+
 // This version specifies that the count is guaranteed not to be zero; zero has been ruled out by a previous test
-static inline __attribute__((always_inline)) unsigned int Eidos_FastRandomPoisson_NONZERO(double p_mu, double p_exp_neg_mu)
+static inline __attribute__((always_inline)) unsigned int Eidos_FastRandomPoisson_NONZERO(gsl_rng *p_r, double p_mu, double p_exp_neg_mu)
 {
 	// Defer to the GSL for large values of mu; see comments above.
 	if (p_mu > 250)
@@ -240,7 +261,7 @@ static inline __attribute__((always_inline)) unsigned int Eidos_FastRandomPoisso
 		
 		do
 		{
-			result = gsl_ran_poisson(EIDOS_GSL_RNG, p_mu);
+			result = gsl_ran_poisson(p_r, p_mu);
 		}
 		while (result == 0);
 		
@@ -254,7 +275,7 @@ static inline __attribute__((always_inline)) unsigned int Eidos_FastRandomPoisso
 	unsigned int x = 0;
 	double p = p_exp_neg_mu;
 	double s = p;
-	double u = Eidos_rng_uniform_pos(EIDOS_GSL_RNG);	// exclude 0.0 so u != s after rescaling
+	double u = Eidos_rng_uniform_pos(p_r);	// exclude 0.0 so u != s after rescaling
 	
 	// rescale u so that (u > s) is true in the first round
 	u = u * (1.0 - s) + s;
@@ -276,6 +297,11 @@ static inline __attribute__((always_inline)) unsigned int Eidos_FastRandomPoisso
 	return x;
 }
 
+static inline __attribute__((always_inline)) unsigned int Eidos_FastRandomPoisson_NONZERO(double p_mu, double p_exp_neg_mu)
+{
+	return Eidos_FastRandomPoisson_NONZERO(EIDOS_GSL_RNG, p_mu, p_exp_neg_mu);
+}
+
 double Eidos_FastRandomPoisson_PRECALCULATE(double p_mu);	// exp(-mu); can underflow to zero, in which case the GSL will be used
 
 
@@ -353,23 +379,26 @@ double Eidos_FastRandomPoisson_PRECALCULATE(double p_mu);	// exp(-mu); can under
 #define Eidos_MT64_UM 0xFFFFFFFF80000000ULL /* Most significant 33 bits */
 #define Eidos_MT64_LM 0x7FFFFFFFULL /* Least significant 31 bits */
 
+// BCH: the functions below that take no Eidos_RNG_State use gEidos_RNG; the variants that take an Eidos_RNG_State use that state.
+
 /* initializes mt[NN] with a seed */
-void Eidos_MT64_init_genrand64(uint64_t seed);
+void Eidos_MT64_init_genrand64(Eidos_RNG_State &p_rng, uint64_t seed);
+inline void Eidos_MT64_init_genrand64(uint64_t seed) { Eidos_MT64_init_genrand64(gEidos_RNG, seed); }
 
 /* initialize by an array with array-length */
 void Eidos_MT64_init_by_array64(uint64_t init_key[], uint64_t key_length);
 
 /* BCH: fill the next Eidos_MT64_NN words; used internally by genrand64_int64() */
-void _Eidos_MT64_fill();
+void _Eidos_MT64_fill(Eidos_RNG_State &p_rng);
 
 /* generates a random number on [0, 2^64-1]-interval */
-inline __attribute__((always_inline)) uint64_t Eidos_MT64_genrand64_int64(void)
+inline __attribute__((always_inline)) uint64_t Eidos_MT64_genrand64_int64(Eidos_RNG_State &p_rng)
 {
 	/* generate NN words at one time */
-	if (gEidos_RNG.mti_ >= Eidos_MT64_NN)
-		_Eidos_MT64_fill();
+	if (p_rng.mti_ >= Eidos_MT64_NN)
+		_Eidos_MT64_fill(p_rng);
 	
-	uint64_t x = gEidos_RNG.mt_[gEidos_RNG.mti_++];
+	uint64_t x = p_rng.mt_[p_rng.mti_++];
 	
 	x ^= (x >> 29) & 0x5555555555555555ULL;
 	x ^= (x << 17) & 0x71D67FFFEDA60000ULL;
@@ -379,6 +408,11 @@ inline __attribute__((always_inline)) uint64_t Eidos_MT64_genrand64_int64(void)
 	return x;
 }
 
+inline __attribute__((always_inline)) uint64_t Eidos_MT64_genrand64_int64(void)
+{
+	return Eidos_MT64_genrand64_int64(gEidos_RNG);
+}
+
 /* generates a random number on [0, 2^63-1]-interval */
 inline __attribute__((always_inline)) int64_t Eidos_MT64_genrand64_int63(void)
 {
@@ -404,7 +438,7 @@ inline __attribute__((always_inline)) double Eidos_MT64_genrand64_real3(void)
 }
 
 /* BCH: generates a random integer in [0, p_n - 1]; parallel to Eidos_rng_uniform_int() above */
-inline __attribute__((always_inline)) uint64_t Eidos_rng_uniform_int_MT64(uint64_t p_n)
+inline __attribute__((always_inline)) uint64_t Eidos_rng_uniform_int_MT64(Eidos_RNG_State &p_rng, uint64_t p_n)
 {
 	// OK, so.  The GSL's uniform int method, whose logic we replicate in Eidos_rng_uniform_int(), makes sure
 	// that the probability of each integer is exactly equal by figuring out a scaling, and then looping on
@@ -415,7 +449,12 @@ inline __attribute__((always_inline)) uint64_t Eidos_rng_uniform_int_MT64(uint64
 	// in anywhere near the full range of the generator; we just need a couple of orders of magnitude more
 	// headroom than UINT32_MAX provides.  If we start to use this for a wider range of p_n (such as making it
 	// available in the Eidos APIs), this decision would need to be revisited.  BCH 12 May 2018
-	return Eidos_MT64_genrand64_int64() % p_n;
+	return Eidos_MT64_genrand64_int64(p_rng) % p_n;
+}
+
+inline __attribute__((always_inline)) uint64_t Eidos_rng_uniform_int_MT64(uint64_t p_n)
+{
+	return Eidos_rng_uniform_int_MT64(gEidos_RNG, p_n);
 }
 
 
@@ -428,27 +467,104 @@ inline __attribute__((always_inline)) uint64_t Eidos_rng_uniform_int_MT64(uint64
 
 // optimization of this is possible assuming each bit returned by the RNG is independent and usable as a random boolean.
 // the independence of all 64 bits seems to be a solid assumption for the MT64 generator, as far as I can tell.
-static inline __attribute__((always_inline)) bool Eidos_RandomBool()
+static inline __attribute__((always_inline)) bool Eidos_RandomBool(Eidos_RNG_State &p_rng)
 {
 	bool retval;
 	
-	if (gEidos_RNG.random_bool_bit_counter_ > 0)
+	if (p_rng.random_bool_bit_counter_ > 0)
 	{
-		gEidos_RNG.random_bool_bit_counter_--;
-		gEidos_RNG.random_bool_bit_buffer_ >>= 1;
-		retval = gEidos_RNG.random_bool_bit_buffer_ & 0x01;
+		p_rng.random_bool_bit_counter_--;
+		p_rng.random_bool_bit_buffer_ >>= 1;
+		retval = p_rng.random_bool_bit_buffer_ & 0x01;
 	}
 	else
 	{
-		gEidos_RNG.random_bool_bit_buffer_ = Eidos_MT64_genrand64_int64();	// MT64 provides 64 independent bits
-		gEidos_RNG.random_bool_bit_counter_ = 63;				// 64 good bits originally, and we're about to use one
+		p_rng.random_bool_bit_buffer_ = Eidos_MT64_genrand64_int64(p_rng);	// MT64 provides 64 independent bits
+		p_rng.random_bool_bit_counter_ = 63;				// 64 good bits originally, and we're about to use one
 		
-		retval = gEidos_RNG.random_bool_bit_buffer_ & 0x01;
+		retval = p_rng.random_bool_bit_buffer_ & 0x01;
 	}
 	
 	return retval;
 }
 
+static inline __attribute__((always_inline)) bool Eidos_RandomBool()
+{
+	return Eidos_RandomBool(gEidos_RNG);
+}
+
+
+#pragma mark -
+#pragma mark Weighted discrete draws
+#pragma mark -
+
+// EidosAliasTable draws indices in [0, K) with probabilities proportional to a vector of K non-negative weights, using Walker's
+// alias method.  It replaces gsl_ran_discrete_preproc() / gsl_ran_discrete(), and is deliberately an exact reimplementation of
+// them: the table is built with the same arithmetic and the same order of operations, and a draw consumes one uniform deviate
+// and maps it to an index in the same way, so a given RNG state produces exactly the same draws as the GSL.  The differences
+// are that the table's buffers are kept and reused by Rebuild(), rather than being allocated and freed each time the weights
+// change, and that there is a DrawMultiple() call for drawing many indices at once.  Only the taus2 generator is supported,
+// since draws use Eidos_rng_uniform(); that is what the GSL does for taus2, but without the indirection.
+class EidosAliasTable
+{
+private:
+	size_t count_ = 0;				// K, the number of indices; 0 means the table is not valid
+	size_t capacity_ = 0;			// the allocated length of the buffers below
+	double *cutoff_ = nullptr;		// OWNED POINTER: (k + F[k]) / K, where F[k] is the probability of keeping index k (Knuth's convention, as in the GSL)
+	size_t *alias_ = nullptr;		// OWNED POINTER: the index to return instead of k, when k is not kept
+	double *scaled_ = nullptr;		// OWNED POINTER: scratch space for normalized weights, used by Rebuild()
+	size_t *smalls_ = nullptr;		// OWNED POINTER: scratch stack of indices with less than the mean weight, used by Rebuild()
+	size_t *bigs_ = nullptr;		// OWNED POINTER: scratch stack of indices with at least the mean weight, used by Rebuild()
+	
+public:
+	EidosAliasTable(const EidosAliasTable&) = delete;					// no copying
+	EidosAliasTable& operator=(const EidosAliasTable&) = delete;		// no copying
+	EidosAliasTable(void) = default;
+	~EidosAliasTable(void);
+	
+	// (re)build the table for p_count weights, which must be non-negative and not all zero; this allocates only if p_count exceeds
+	// the largest count used so far
+	void Rebuild(size_t p_count, const double *p_weights);
+	
+	// discard the table, but keep the buffers for later reuse; IsValid() is false until the next Rebuild()
+	inline void Invalidate(void) { count_ = 0; }
+	inline bool IsValid(void) const { return (count_ > 0); }
+	inline size_t Count(void) const { return count_; }
+	
+	inline size_t MemoryUsage(void) const { return capacity_ * (2 * sizeof(double) + 3 * sizeof(size_t)); }
+	
+	inline __attribute__((always_inline)) size_t Draw(gsl_rng *p_r) const
+	{
+		double u = Eidos_rng_uniform(p_r);
+		size_t c = (size_t)(u * count_);
+		double f = cutoff_[c];
+		
+		if (f == 1.0)
+			return c;
+		if (u < f)
+			return c;
+		return alias_[c];
+	}
+	
+	// draw p_draw_count indices, each plus p_offset, into p_indices; the result is the same as p_draw_count successive calls to
+	// Draw().  There is no dependency between iterations apart from the RNG state, so the processor can overlap the table lookups
+	// (and their cache misses, for large tables) of successive draws.
+	template <typename T>
+	void DrawMultiple(gsl_rng *p_r, size_t p_draw_count, T *p_indices, T p_offset) const
+	{
+		const double count = (double)count_;
+		
+		for (size_t draw_index = 0; draw_index < p_draw_count; ++draw_index)
+		{
+			double u = Eidos_rng_uniform(p_r);
+			size_t c = (size_t)(u * count);
+			double f = cutoff_[c];
+			
+			p_indices[draw_index] = (T)(((f == 1.0) || (u < f)) ? c : alias_[c]) + p_offset;
+		}
+	}
+};
+
 
 #endif /* defined(__Eidos__eidos_rng__) */
 
@@ -25,6 +25,11 @@
 #include "eidos_globals.h"
 #include "eidos_rng.h"
 #include "eidos_test_element.h"
+#include "eidos_bytecode.h"
+#include "eidos_fused_expression.h"
+#include "eidos_vector_kernels.h"
+#include "eidos_type_table.h"
+#include "eidos_type_interpreter.h"
 
 #include <iostream>
 #include <string>
@@ -44,6 +49,9 @@
 // Helper functions for testing
 void EidosAssertScriptSuccess(const std::string &p_script_string, EidosValue_SP p_correct_result);
 void EidosAssertScriptRaise(const std::string &p_script_string, const int p_bad_position, const std::string &p_reason_snip);
+void EidosAssertCompiledBlockMatches(const std::string &p_script_string, bool p_expect_compiled);
+void EidosAssertSpecializedBlockMatches(const std::string &p_script_string, bool p_expect_specialized);
+void EidosAssertFusedBlockMatches(const std::string &p_script_string, bool p_expect_fused);
 
 // Keeping records of test success / failure
 static int gEidosTestSuccessCount = 0;
@@ -217,6 +225,170 @@ void EidosAssertScriptRaise(const std::string &p_script_string, const int p_bad_
 	gEidosExecutingRuntimeScript = false;
 }
 
+// Sets p_evaluators to the cached evaluators of the nodes of p_node, in a preorder traversal
+static void _EidosCollectCachedEvaluators(const EidosASTNode *p_node, std::vector<EidosEvaluationMethod> *p_evaluators)
+{
+	p_evaluators->emplace_back(p_node->cached_evaluator_);
+	
+	for (const EidosASTNode *child : p_node->children_)
+		_EidosCollectCachedEvaluators(child, p_evaluators);
+}
+
+// Returns true if EidosASTNode::OptimizeTree() installed any fused expressions in p_node; if p_unfuse is true, they are also reverted
+// to the evaluators they replaced
+static bool _EidosFindFusedExpressions(const EidosASTNode *p_node, bool p_unfuse)
+{
+	bool found = false;
+	
+	if (p_node->cached_evaluator_ == &EidosInterpreter::Evaluate_FusedReduction)
+	{
+		if (p_unfuse)
+			p_node->cached_evaluator_ = &EidosInterpreter::Evaluate_Call;
+		found = true;
+	}
+	if (p_node->cached_fused_expression_)
+	{
+		if (p_unfuse)
+			p_node->cached_evaluator_ = p_node->cached_fused_expression_->fallback_evaluator_;
+		found = true;
+	}
+	
+	for (const EidosASTNode *child : p_node->children_)
+		found = _EidosFindFusedExpressions(child, p_unfuse) || found;
+	
+	return found;
+}
+
+// Runs the compound statement in p_script_string as an internal block, optionally compiled to bytecode or with type-specialized
+// evaluators installed; p_optimized is set to whether that optimization changed the block.  Fused expressions are removed unless
+// p_fuse is true, in which case p_optimized is set to whether there were any.  Returns false if the block raised.
+static bool _EidosRunInternalBlock(const std::string &p_script_string, bool p_compile, bool p_specialize, bool p_fuse, bool *p_optimized, EidosValue_SP *p_result, std::string *p_raise_message, int *p_raise_position)
+{
+	EidosScript script(p_script_string);
+	EidosSymbolTable symbol_table(EidosSymbolTableType::kVariablesTable, gEidosConstantsSymbolTable);
+	EidosFunctionMap function_map(*EidosInterpreter::BuiltInFunctionMap());
+	bool success = true;
+	
+	gEidosCurrentScript = &script;
+	gEidosCharacterStartOfError = -1;
+	
+	try {
+		script.Tokenize();
+		script.ParseInterpreterBlockToAST(true);
+		
+		const EidosASTNode *block_node = script.AST()->children_[0];
+		bool fused = _EidosFindFusedExpressions(block_node, !p_fuse);
+		
+		if (p_compile)
+			block_node->cached_bytecode_ = EidosBytecode::CompileBlock(block_node);
+		*p_optimized = (block_node->cached_bytecode_ != nullptr);
+		
+		if (p_specialize)
+		{
+			EidosTypeTable type_table;
+			EidosCallTypeTable call_types;
+			EidosNodeTypeTable node_types;
+			EidosTypeInterpreter typeInterpreter(block_node, type_table, function_map, call_types);
+			std::vector<EidosEvaluationMethod> original_evaluators, specialized_evaluators;
+			
+			typeInterpreter.TypeEvaluateInterpreterBlock_RecordNodeTypes(&node_types);
+			
+			_EidosCollectCachedEvaluators(block_node, &original_evaluators);
+			block_node->OptimizeTypeSpecializations(node_types);
+			_EidosCollectCachedEvaluators(block_node, &specialized_evaluators);
+			*p_optimized = (original_evaluators != specialized_evaluators);
+		}
+		
+		if (p_fuse)
+			*p_optimized = fused;
+		
+		EidosInterpreter interpreter(block_node, symbol_table, function_map, nullptr);
+		
+		*p_result = interpreter.EvaluateInternalBlock(nullptr);
+	}
+	catch (...)
+	{
+		*p_raise_message = Eidos_GetTrimmedRaiseMessage();
+		*p_raise_position = gEidosCharacterStartOfError;
+		success = false;
+	}
+	
+	gEidosCurrentScript = nullptr;
+	gEidosExecutingRuntimeScript = false;
+	
+	return success;
+}
+
+// Runs the compound statement in p_script_string both optimized (compiled to bytecode, or with type-specialized evaluators) and with the
+// plain AST-walking interpreter, and prints an error if the results differ, or if one raises and the other does not, or if they raise
+// with different messages or error positions
+static void _EidosAssertOptimizedBlockMatches(const std::string &p_script_string, bool p_compile, bool p_specialize, bool p_fuse, bool p_expect_optimized)
+{
+	bool optimized = false, walker_optimized = false;
+	const char *optimization_name = (p_compile ? "bytecode" : (p_specialize ? "specialized evaluators" : "fused expressions"));
+	EidosValue_SP compiled_result, walker_result;
+	std::string compiled_message, walker_message;
+	int compiled_position = -1, walker_position = -1;
+	
+	bool compiled_success = _EidosRunInternalBlock(p_script_string, p_compile, p_specialize, p_fuse, &optimized, &compiled_result, &compiled_message, &compiled_position);
+	bool walker_success = _EidosRunInternalBlock(p_script_string, false, false, false, &walker_optimized, &walker_result, &walker_message, &walker_position);
+	
+	gEidosTestFailureCount++;	// assume failure; we will fix this at the end if we succeed
+	
+	if (optimized != p_expect_optimized)
+	{
+		std::cerr << p_script_string << " : " << EIDOS_OUTPUT_FAILURE_TAG << " : block was " << (optimized ? "" : "not ") << "optimized with " << optimization_name << std::endl;
+		return;
+	}
+	else if (compiled_success != walker_success)
+	{
+		std::cerr << p_script_string << " : " << EIDOS_OUTPUT_FAILURE_TAG << " : " << (compiled_success ? "no raise" : "raise") << " from " << optimization_name << ": " << (compiled_success ? walker_message : compiled_message) << std::endl;
+		return;
+	}
+	else if (!compiled_success)
+	{
+		if ((compiled_message != walker_message) || (compiled_position != walker_position))
+		{
+			std::cerr << p_script_string << " : " << EIDOS_OUTPUT_FAILURE_TAG << " : mismatched raise from " << optimization_name << " (" << compiled_message << " at " << compiled_position << "), expected (" << walker_message << " at " << walker_position << ")" << std::endl;
+			return;
+		}
+	}
+	else if ((compiled_result->Type() != walker_result->Type()) || (compiled_result->Count() != walker_result->Count()) || (compiled_result->DimensionCount() != walker_result->DimensionCount()))
+	{
+		std::cerr << p_script_string << " : " << EIDOS_OUTPUT_FAILURE_TAG << " : mismatched result from " << optimization_name << " (" << *compiled_result << "), expected (" << *walker_result << ")" << std::endl;
+		return;
+	}
+	else
+	{
+		for (int value_index = 0; value_index < compiled_result->Count(); ++value_index)
+		{
+			if (CompareEidosValues(*compiled_result, value_index, *walker_result, value_index, nullptr) != 0)
+			{
+				std::cerr << p_script_string << " : " << EIDOS_OUTPUT_FAILURE_TAG << " : mismatched result from " << optimization_name << " (" << *compiled_result << "), expected (" << *walker_result << ")" << std::endl;
+				return;
+			}
+		}
+	}
+	
+	gEidosTestFailureCount--;	// correct for our assumption of failure above
+	gEidosTestSuccessCount++;
+}
+
+
+void EidosAssertCompiledBlockMatches(const std::string &p_script_string, bool p_expect_compiled)
+{
+	_EidosAssertOptimizedBlockMatches(p_script_string, true, false, false, p_expect_compiled);
+}
+
+void EidosAssertSpecializedBlockMatches(const std::string &p_script_string, bool p_expect_specialized)
+{
+	_EidosAssertOptimizedBlockMatches(p_script_string, false, true, false, p_expect_specialized);
+}
+
+void EidosAssertFusedBlockMatches(const std::string &p_script_string, bool p_expect_fused)
+{
+	_EidosAssertOptimizedBlockMatches(p_script_string, false, false, true, p_expect_fused);
+}
 
 // Test subfunction prototypes
 static void _RunLiteralsIdentifiersAndTokenizationTests(void);
@@ -274,6 +446,13 @@ static void _RunMethodTests(void);
 static void _RunCodeExampleTests(void);
 static void _RunUserDefinedFunctionTests(void);
 static void _RunVoidEidosValueTests(void);
+static void _RunRNGStreamTests(void);
+static void _RunAliasTableTests(void);
+static void _RunBytecodeTests(void);
+static void _RunTypeSpecializationTests(void);
+static void _RunFusedExpressionTests(void);
+static void _RunVectorKernelTests(void);
+static void _RunParallelVectorTests(void);
 
 
 int RunEidosTests(void)
@@ -345,6 +524,13 @@ int RunEidosTests(void)
 	_RunCodeExampleTests();
 	_RunUserDefinedFunctionTests();
 	_RunVoidEidosValueTests();
+	_RunRNGStreamTests();
+	_RunAliasTableTests();
+	_RunBytecodeTests();
+	_RunTypeSpecializationTests();
+	_RunFusedExpressionTests();
+	_RunVectorKernelTests();
+	_RunParallelVectorTests();
 	
 	// ************************************************************************************
 	//
@@ -1936,7 +2122,7 @@ void _RunOperatorPlusTests2(void)
 	EidosAssertScriptRaise("identical(array(1:6,c(1,2,3)) + array(1:6,c(3,2,1)), array(2:7, c(1,2,3)));", 30, "non-conformable");
 }
 
-#pragma mark operator −
+#pragma mark operator -
 void _RunOperatorMinusTests(void)
 {
 	// operator -
@@ -7831,6 +8017,508 @@ void _RunVoidEidosValueTests(void)
 	EidosAssertScriptRaise("for (x in citation()) T;", 0, "does not allow void");
 }
 
+#pragma mark RNG streams
+static void _EidosAssertRNGStreamCondition(bool p_condition, const char *p_description)
+{
+	if (p_condition)
+	{
+		gEidosTestSuccessCount++;
+	}
+	else
+	{
+		gEidosTestFailureCount++;
+		
+		std::cerr << "RNG: " << p_description << " : " << EIDOS_OUTPUT_FAILURE_TAG << std::endl;
+	}
+}
+
+void _RunRNGStreamTests(void)
+{
+	// These tests exercise RNG streams built with Eidos_RNGStreamSeed() directly, since they are not visible from Eidos code
+	const unsigned long int test_seed = 42;
+	const int draw_count = 20;
+	std::vector<uint64_t> main_draws_without_streams, main_draws_with_streams;
+	std::vector<Eidos_RNG_State> streams(4);
+	
+	Eidos_InitializeRNG();
+	Eidos_SetRNGSeed(test_seed);
+	
+	for (int draw = 0; draw < draw_count; ++draw)
+	{
+		main_draws_without_streams.push_back(gsl_rng_get(EIDOS_GSL_RNG));
+		main_draws_without_streams.push_back(Eidos_MT64_genrand64_int64());
+	}
+	
+	// setting up streams must not perturb the main stream
+	Eidos_SetRNGSeed(test_seed);
+	
+	for (int stream_index = 0; stream_index < 4; ++stream_index)
+	{
+		Eidos_RNG_State &stream = streams[stream_index];
+		
+		stream.gsl_rng_ = NULL;
+		stream.mt_ = NULL;
+		Eidos_InitializeRNGState(stream);
+		Eidos_SetRNGStateSeed(stream, Eidos_RNGStreamSeed(test_seed, stream_index));
+	}
+	
+	for (int draw = 0; draw < draw_count; ++draw)
+	{
+		main_draws_with_streams.push_back(gsl_rng_get(EIDOS_GSL_RNG));
+		main_draws_with_streams.push_back(Eidos_MT64_genrand64_int64());
+	}
+	
+	_EidosAssertRNGStreamCondition(main_draws_without_streams == main_draws_with_streams, "main stream changed by the presence of streams");
+	
+	// each stream is deterministic given the base seed, and independent of draws made from the main stream or other streams
+	std::vector<std::vector<uint64_t>> stream_draws(4), stream_redraws(4);
+	
+	for (int stream_index = 0; stream_index < 4; ++stream_index)
+	{
+		Eidos_RNG_State &stream = streams[stream_index];
+		
+		for (int draw = 0; draw < draw_count; ++draw)
+		{
+			stream_draws[stream_index].push_back(gsl_rng_get(stream.gsl_rng_));
+			stream_draws[stream_index].push_back(Eidos_MT64_genrand64_int64(stream));
+		}
+	}
+	
+	for (int stream_index = 0; stream_index < 4; ++stream_index)
+		Eidos_SetRNGStateSeed(streams[stream_index], Eidos_RNGStreamSeed(test_seed, stream_index));
+	
+	gsl_rng_get(EIDOS_GSL_RNG);
+	
+	for (int stream_index = 3; stream_index >= 0; --stream_index)
+	{
+		Eidos_RNG_State &stream = streams[stream_index];
+		
+		for (int draw = 0; draw < draw_count; ++draw)
+		{
+			stream_redraws[stream_index].push_back(gsl_rng_get(stream.gsl_rng_));
+			stream_redraws[stream_index].push_back(Eidos_MT64_genrand64_int64(stream));
+		}
+	}
+	
+	_EidosAssertRNGStreamCondition(stream_draws == stream_redraws, "stream draws not reproducible");
+	
+	for (int stream_index = 0; stream_index < 4; ++stream_index)
+	{
+		_EidosAssertRNGStreamCondition(stream_draws[stream_index] != main_draws_with_streams, "stream duplicates the main stream");
+		
+		for (int other_index = stream_index + 1; other_index < 4; ++other_index)
+			_EidosAssertRNGStreamCondition(stream_draws[stream_index] != stream_draws[other_index], "two streams are identical");
+	}
+	
+	// stream seeds depend upon the base seed
+	_EidosAssertRNGStreamCondition(Eidos_RNGStreamSeed(test_seed, 0) != Eidos_RNGStreamSeed(test_seed + 1, 0), "stream seed independent of base seed");
+	_EidosAssertRNGStreamCondition(Eidos_RNGStreamSeed(test_seed, 0) != test_seed, "stream seed equal to base seed");
+	
+	for (Eidos_RNG_State &stream : streams)
+		Eidos_FreeRNG(stream);
+}
+
+#pragma mark alias tables
+void _RunAliasTableTests(void)
+{
+	// EidosAliasTable is meant to be a drop-in replacement for gsl_ran_discrete_preproc() / gsl_ran_discrete(), so check that it
+	// produces exactly the same draws from the same RNG state, for a variety of weight vectors, and across reuse of one table
+	const unsigned long int test_seed = 7;
+	const int draw_count = 1000;
+	EidosAliasTable table;
+	std::vector<std::vector<double>> weight_sets = {
+		{1.0},
+		{0.5, 0.5},
+		{1.0, 0.0, 3.0},
+		{0.0, 0.0, 2.0, 0.0},
+		{0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9, 1.0, 1.1, 1.2, 1.3},
+		{1e-10, 1.0, 1e10, 1.0, 1e-10}
+	};
+	
+	std::vector<double> long_weights;
+	
+	for (int weight_index = 0; weight_index < 500; ++weight_index)
+		long_weights.push_back(1.0 + 0.5 * std::sin(weight_index * 0.37) + ((weight_index % 17 == 0) ? 4.0 : 0.0));
+	
+	weight_sets.push_back(long_weights);
+	weight_sets.push_back({2.0, 1.0});		// shrinking after a large table, to exercise buffer reuse
+	
+	Eidos_InitializeRNG();
+	
+	for (std::vector<double> &weights : weight_sets)
+	{
+		std::vector<size_t> gsl_draws, table_draws, batch_draws(draw_count);
+		gsl_ran_discrete_t *gsl_table = gsl_ran_discrete_preproc(weights.size(), weights.data());
+		
+		Eidos_SetRNGSeed(test_seed);
+		for (int draw = 0; draw < draw_count; ++draw)
+			gsl_draws.push_back(gsl_ran_discrete(EIDOS_GSL_RNG, gsl_table));
+		
+		gsl_ran_discrete_free(gsl_table);
+		
+		table.Rebuild(weights.size(), weights.data());
+		_EidosAssertRNGStreamCondition(table.IsValid() && (table.Count() == weights.size()), "alias table not valid after Rebuild()");
+		
+		Eidos_SetRNGSeed(test_seed);
+		for (int draw = 0; draw < draw_count; ++draw)
+			table_draws.push_back(table.Draw(EIDOS_GSL_RNG));
+		
+		_EidosAssertRNGStreamCondition(table_draws == gsl_draws, "alias table draws differ from gsl_ran_discrete()");
+		
+		Eidos_SetRNGSeed(test_seed);
+		table.DrawMultiple(EIDOS_GSL_RNG, draw_count, batch_draws.data(), (size_t)0);
+		
+		_EidosAssertRNGStreamCondition(batch_draws == gsl_draws, "alias table batched draws differ from gsl_ran_discrete()");
+	}
+	
+	table.Invalidate();
+	_EidosAssertRNGStreamCondition(!table.IsValid(), "alias table valid after Invalidate()");
+}
+
+#pragma mark bytecode
+// Runs one compiled block repeatedly with different values of x; the expression bails out when x is a vector, and should then
+// be rewritten to go straight to the AST evaluators on later runs, while still giving correct results for any x
+static void _EidosAssertBailedExpressionRewritten(void)
+{
+	EidosScript script("{ return x * 2 + 1; }");
+	EidosSymbolTable symbol_table(EidosSymbolTableType::kVariablesTable, gEidosConstantsSymbolTable);
+	EidosFunctionMap function_map(*EidosInterpreter::BuiltInFunctionMap());
+	EidosGlobalStringID x_id = Eidos_GlobalStringIDForString("x");
+	std::vector<std::string> failures;
+	
+	gEidosCurrentScript = &script;
+	
+	try {
+		script.Tokenize();
+		script.ParseInterpreterBlockToAST(true);
+		
+		const EidosASTNode *block_node = script.AST()->children_[0];
+		
+		block_node->cached_bytecode_ = EidosBytecode::CompileBlock(block_node);
+		
+		if (!block_node->cached_bytecode_)
+			failures.emplace_back("block was not compiled");
+		else
+		{
+			std::vector<EidosValue_SP> x_values{EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int_singleton(3)),
+				EidosValue_SP((new (gEidosValuePool->AllocateChunk()) EidosValue_Int_vector{1, 2, 3})),
+				EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int_singleton(4))};
+			std::vector<std::string> expected_results{"7", "3 5 7", "9"};
+			std::vector<bool> expect_rewritten{false, true, true};
+			
+			for (size_t run_index = 0; run_index < x_values.size(); ++run_index)
+			{
+				symbol_table.SetValueForSymbol(x_id, x_values[run_index]);
+				
+				EidosInterpreter interpreter(block_node, symbol_table, function_map, nullptr);
+				EidosValue_SP result = interpreter.EvaluateInternalBlock(nullptr);
+				std::ostringstream result_stream, disassembly_stream;
+				
+				result_stream << *result;
+				block_node->cached_bytecode_->Print(disassembly_stream);
+				
+				if (result_stream.str() != expected_results[run_index])
+					failures.emplace_back("run " + std::to_string(run_index) + " returned " + result_stream.str() + ", expected " + expected_results[run_index]);
+				if ((disassembly_stream.str().find("EVALUATE_EXPRESSION") != std::string::npos) != expect_rewritten[run_index])
+					failures.emplace_back("run " + std::to_string(run_index) + (expect_rewritten[run_index] ? " did not rewrite" : " rewrote") + " the expression");
+			}
+		}
+	}
+	catch (...)
+	{
+		failures.emplace_back("raised " + Eidos_GetTrimmedRaiseMessage());
+	}
+	
+	gEidosCurrentScript = nullptr;
+	gEidosExecutingRuntimeScript = false;
+	
+	if (failures.size() == 0)
+		gEidosTestSuccessCount++;
+	else
+	{
+		gEidosTestFailureCount++;
+		
+		for (const std::string &failure : failures)
+			std::cerr << "bytecode bail rewrite: " << failure << " : " << EIDOS_OUTPUT_FAILURE_TAG << std::endl;
+	}
+}
+
+void _RunBytecodeTests(void)
+{
+	// compiled scalar arithmetic, comparison, and logical operators
+	EidosAssertCompiledBlockMatches("{ x = 3; y = 4.5; return x * 2 + y / 3 - x % 2; }", true);
+	EidosAssertCompiledBlockMatches("{ x = 7; return -x + 2 * x - +x; }", true);
+	EidosAssertCompiledBlockMatches("{ x = 2; y = 10; return x ^ y; }", true);
+	EidosAssertCompiledBlockMatches("{ x = 5; y = 5.0; return (x < y) | (x <= y) & !(x > y) & (x >= y) & (x == y) & !(x != y); }", true);
+	EidosAssertCompiledBlockMatches("{ x = T; y = 0; return !x | !y | (x == y) | (x < PI) | (E > NAN); }", true);
+	EidosAssertCompiledBlockMatches("{ x = 1; x = x * 3 + 1; y = x / 2; return y; }", true);
+	EidosAssertCompiledBlockMatches("{ x = 9223372036854775807; return x * 1.0 + x; }", true);
+	EidosAssertCompiledBlockMatches("{ x = _Test(7); return x._yolk * 2 + 1; }", true);
+	EidosAssertCompiledBlockMatches("{ x = c(_Test(7), _Test(8)); return x._yolk * 2 + 1; }", true);
+	EidosAssertCompiledBlockMatches("{ x = _Test(7); return x._foo * 2 + 1; }", true);
+	
+	// control flow
+	EidosAssertCompiledBlockMatches("{ x = 3; if (x > 2) return x + 1; else return x - 1; }", true);
+	EidosAssertCompiledBlockMatches("{ x = 1; if (x > 2) return x + 1; }", true);
+	EidosAssertCompiledBlockMatches("{ x = 1; if (x < 2) { y = x + 1; return y * 2; } else y = 0; return y; }", true);
+	EidosAssertCompiledBlockMatches("{ x = 1; if (x < 2) x = x + 1; for (i in 1:3) { x = x * i; if (x > 10) break; } return x + 0.5; }", true);
+	EidosAssertCompiledBlockMatches("{ x = 1; y = x + 1; return; }", true);
+	EidosAssertCompiledBlockMatches("{ return 1 + 2; }", true);
+	EidosAssertCompiledBlockMatches("{ x = c(1, 2); return x; }", false);
+	EidosAssertCompiledBlockMatches("{ x = 1; x = x + 1; return x; }", false);
+	
+	// operands the compiled code does not handle are handed back to the AST evaluators
+	EidosAssertCompiledBlockMatches("{ x = 1:5; return x * 2 + 1; }", true);
+	EidosAssertCompiledBlockMatches("{ x = matrix(1:4, nrow=2); return x + 1; }", true);
+	EidosAssertCompiledBlockMatches("{ x = 'a'; return x + 1; }", true);
+	EidosAssertCompiledBlockMatches("{ x = 3; return (x > 2) & 5; }", true);
+	EidosAssertCompiledBlockMatches("{ x = NAN; return !x + 0; }", true);
+	EidosAssertCompiledBlockMatches("{ x = 9223372036854775807; return x + 1; }", true);
+	EidosAssertCompiledBlockMatches("{ x = -9223372036854775807 - 1; return -x; }", true);
+	EidosAssertCompiledBlockMatches("{ x = T; return x + 1; }", true);
+	EidosAssertCompiledBlockMatches("{ x = 1; return x + y; }", true);
+	EidosAssertCompiledBlockMatches("{ x = 1:3; if (x > 1) return x + 1; }", true);
+	EidosAssertCompiledBlockMatches("{ x = 1; if (x + 1) return x + 1; }", true);
+	EidosAssertCompiledBlockMatches("{ x = 1; next; return x + 1; }", true);
+	EidosAssertCompiledBlockMatches("{ x = 1; return; y = x + 1; }", true);
+	
+	// an expression that has bailed out is rewritten to skip its compiled code on later runs
+	_EidosAssertBailedExpressionRewritten();
+}
+
+#pragma mark type specialization
+void _RunTypeSpecializationTests(void)
+{
+	// specialized integer and float arithmetic and comparisons
+	EidosAssertSpecializedBlockMatches("{ x = 3; y = 4.5; return x * 2 + y / 3 - x % 2 + y ^ x; }", true);
+	EidosAssertSpecializedBlockMatches("{ x = 7; y = 2; return c(x + y, x - y, x * y, x / y, x % y, x ^ y); }", true);
+	EidosAssertSpecializedBlockMatches("{ x = 5; y = 5.0; return c(x < y, x <= y, x > y, x >= y, x == y, x != y); }", true);
+	EidosAssertSpecializedBlockMatches("{ x = NAN; y = 1.0; return c(x < y, x <= y, x > y, x >= y, x == y, x != y); }", true);
+	EidosAssertSpecializedBlockMatches("{ x = _Test(7); return x._yolk * 2 + 1; }", true);
+	EidosAssertSpecializedBlockMatches("{ x = 'a'; y = T; return c(x + 1, y + 1); }", false);
+	
+	// operands that do not match their inferred types are handed back to the generic evaluators
+	EidosAssertSpecializedBlockMatches("{ x = 1; y = 2; for (i in 1:3) { z = x * y; x = 1:3; } return z; }", true);
+	EidosAssertSpecializedBlockMatches("{ x = 1; y = 2; for (i in 1:3) { z = x + y; x = matrix(1:4, nrow=2); } return z; }", true);
+	EidosAssertSpecializedBlockMatches("{ x = 9223372036854775807; y = 1; return x + y; }", true);
+	EidosAssertSpecializedBlockMatches("{ x = -9223372036854775807; y = 9; return x * y; }", true);
+	EidosAssertSpecializedBlockMatches("{ x = c(_Test(7), _Test(8)); return x._yolk * 2 + 1; }", true);
+	EidosAssertSpecializedBlockMatches("{ x = 1; return x + y; }", false);
+	
+	// operands are evaluated only once, even when they fall back and have side effects; the last draw shows how many were made
+	EidosAssertSpecializedBlockMatches("{ setSeed(5); x = 1:3; y = x * 2 + rdunif(1, 0, 9); return c(y, rdunif(1, 0, 9)); }", true);
+	EidosAssertSpecializedBlockMatches("{ setSeed(5); x = 1:3; y = ((x + rdunif(1)) * (rdunif(1) - x)) + rdunif(1) < x; return c(y, runif(1)); }", true);
+	EidosAssertSpecializedBlockMatches("{ setSeed(5); x = 1:3; y = 2 ^ (x - rdunif(1)) / (rdunif(1) + 1.0) % x; return c(y, runif(1)); }", true);
+}
+
+#pragma mark fused expressions
+void _RunFusedExpressionTests(void)
+{
+	// fused arithmetic, comparisons, and reductions over vectors, including integer operands that are converted to float
+	EidosAssertFusedBlockMatches("{ x = (1:500) / 7; y = x ^ 0.5; z = -x; return x * y + z - x / 3.5 + x % 2.5; }", true);
+	EidosAssertFusedBlockMatches("{ x = (1:300) / 7; y = 1:300; return c(y * x - 2, y / 3 + x, y % 7 * x, -x * 2); }", true);
+	EidosAssertFusedBlockMatches("{ x = c(1.5, NAN, -3.0, INF); y = c(NAN, NAN, 2.0, INF); return c(x + 1 < y, x + 1 <= y, x * 1 > y, x * 1 >= y); }", true);
+	EidosAssertFusedBlockMatches("{ x = c(1.5, NAN, -3.0, INF); y = c(NAN, NAN, 2.0, INF); return x + 1 == y - 1; }", false);
+	EidosAssertFusedBlockMatches("{ x = (1:1000) / 3; y = rev(x); return c(sum(x * y + 1), mean(x * y + 1), sum(x * 2 - y * 2), sum(-0.0 * 1.0 + 0.0)); }", true);
+	EidosAssertFusedBlockMatches("{ x = 2.5; y = 4.0; return c(x * y + 1, x * y + 1 > 5, sum(x * y - 1), mean(-x * 2)); }", true);
+	EidosAssertFusedBlockMatches("{ x = _Test(7); return x._yolk * 2.5 + 1; }", true);
+	EidosAssertFusedBlockMatches("{ x = (1:10) / 3; return x * 2; }", false);
+	EidosAssertFusedBlockMatches("{ x = (1:10) / 3; return sum(x) * 2 + 1; }", false);
+	
+	// operands the fused evaluator does not handle are handed back to the AST evaluators
+	EidosAssertFusedBlockMatches("{ x = 1:5; y = 6:10; return x * y + 1; }", true);
+	EidosAssertFusedBlockMatches("{ x = 1:5; return sum(-x * 2.0); }", true);
+	EidosAssertFusedBlockMatches("{ x = 1:5; y = 6:10; return x * 1.0 < y * 2; }", true);
+	EidosAssertFusedBlockMatches("{ x = 9223372036854775807; return x + 1 + 0.5; }", true);
+	EidosAssertFusedBlockMatches("{ x = matrix(1:4 / 2, nrow=2); return x * 2 + 1; }", true);
+	EidosAssertFusedBlockMatches("{ x = 1:3 / 2; y = 1:4 / 2; return x * 2 + y; }", true);
+	EidosAssertFusedBlockMatches("{ x = 1:3 / 2; y = 1:4 / 2; return x * y + z; }", true);
+	EidosAssertFusedBlockMatches("{ x = 1:3 / 2; y = 'a'; return x * y + z; }", true);
+	EidosAssertFusedBlockMatches("{ x = float(0); return sum(x * 2 + 1); }", true);
+	EidosAssertFusedBlockMatches("{ x = c(T, F); return x * 2.0 + 1; }", true);
+	EidosAssertFusedBlockMatches("{ x = 1:3 / 2; return x * 2 + y; }", true);
+	EidosAssertFusedBlockMatches("{ y = 1:2; for (i in 1:20) x = y * i + 2 * i; return x; }", true);
+}
+
+#pragma mark vector kernels
+static void _EidosAssertVectorKernelCondition(bool p_condition, const char *p_description, size_t p_count)
+{
+	if (p_condition)
+	{
+		gEidosTestSuccessCount++;
+	}
+	else
+	{
+		gEidosTestFailureCount++;
+		
+		std::cerr << "vector kernels: " << p_description << " (count " << p_count << ") : " << EIDOS_OUTPUT_FAILURE_TAG << std::endl;
+	}
+}
+
+void _RunVectorKernelTests(void)
+{
+	// pairwise sums are accurate where sequential sums drift, and are used by sum(), mean(), var(), and sd() alike
+	EidosAssertScriptSuccess("abs(sum(rep(0.1, 1000000)) - 100000) < 1e-8;", gStaticEidosValue_LogicalT);
+	EidosAssertScriptSuccess("x = (1:1000) / 7; sum(x) / 1000 == mean(x);", gStaticEidosValue_LogicalT);
+	EidosAssertScriptSuccess("x = 1:1000; c(var(x), sd(x)) == c(var(asFloat(x)), sd(asFloat(x)));", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Logical{true, true}));
+	EidosAssertScriptSuccess("x = (1:100) / 7; v = var(x); abs(v - sum((x - mean(x))^2) / 99) < 1e-12;", gStaticEidosValue_LogicalT);
+	
+	// the elementwise kernels agree with the singleton paths, element by element
+	EidosAssertScriptSuccess("x = (1:200) / 7 - 10; identical(sqrt(abs(x)), sapply(abs(x), 'sqrt(applyValue);'));", gStaticEidosValue_LogicalT);
+	EidosAssertScriptSuccess("x = (1:200) / 7 - 10; identical(exp(x), sapply(x, 'exp(applyValue);'));", gStaticEidosValue_LogicalT);
+	EidosAssertScriptSuccess("x = (1:200) / 7; identical(log(x), sapply(x, 'log(applyValue);'));", gStaticEidosValue_LogicalT);
+	EidosAssertScriptSuccess("x = (1:200) / 7 - 10; identical(dnorm(x, 1.5, 2.5), sapply(x, 'dnorm(applyValue, 1.5, 2.5);'));", gStaticEidosValue_LogicalT);
+	EidosAssertScriptSuccess("x = c(rep(NAN, 40), (1:40) / 7); y = c((1:40) / 7, rep(NAN, 40)); paste(pmax(x, y)) == paste(sapply(0:79, 'pmax(x[applyValue], y[applyValue]);'));", gStaticEidosValue_LogicalT);
+	EidosAssertScriptSuccess("x = c(rep(NAN, 40), (1:40) / 7); y = c((1:40) / 7, rep(NAN, 40)); paste(pmin(x, y)) == paste(sapply(0:79, 'pmin(x[applyValue], y[applyValue]);'));", gStaticEidosValue_LogicalT);
+	EidosAssertScriptSuccess("x = c(rep(NAN, 40), (1:40) / 7, -0.0); paste(c(pmax(x, 3.0), pmin(x, 3.0))) == paste(c(sapply(x, 'pmax(applyValue, 3.0);'), sapply(x, 'pmin(applyValue, 3.0);')));", gStaticEidosValue_LogicalT);
+	
+	// the portable and AVX2 kernels must give bit-identical results, and incremental pairwise sums must match whole-vector sums
+	bool saved_use_AVX2 = gEidosUseAVX2;
+	std::vector<double> data, other_data;
+	
+	for (int value_index = 0; value_index < 5000; ++value_index)
+	{
+		data.push_back(std::sin(value_index * 0.37) * std::pow(10.0, value_index % 13 - 6) + ((value_index % 97 == 0) ? 1e9 : 0.0));
+		other_data.push_back(std::cos(value_index * 0.11) * 3.0);
+	}
+	
+	data[100] = std::nan("");
+	data[101] = -0.0;
+	other_data[200] = std::nan("");
+	
+	for (size_t count : {0, 1, 5, 16, 17, 31, 32, 33, 127, 128, 129, 255, 256, 1000, 4097})
+	{
+		std::vector<double> results[2];
+		
+		for (int use_AVX2 = 0; use_AVX2 <= (EIDOS_HAS_AVX2_DISPATCH && saved_use_AVX2 ? 1 : 0); ++use_AVX2)
+		{
+			std::vector<double> &result = results[use_AVX2];
+			std::vector<double> buffer(count);
+			EidosPairwiseSum incremental_sum;
+			
+			gEidosUseAVX2 = use_AVX2;
+			
+			for (size_t block_start = 0; block_start < count; block_start += EIDOS_PAIRWISE_SUM_BLOCK)
+				incremental_sum.AddBlockSum(Eidos_BlockSum_Float(other_data.data() + block_start, (int)std::min<size_t>(EIDOS_PAIRWISE_SUM_BLOCK, count - block_start)));
+			
+			result.push_back(Eidos_PairwiseSum_Float(data.data(), count));
+			result.push_back(Eidos_PairwiseSum_Float(other_data.data(), count));
+			result.push_back(incremental_sum.Total());
+			result.push_back(Eidos_PairwiseSumOfSquaredDeviations_Float(other_data.data(), count, 0.25));
+			
+			Eidos_Sqrt_Float(other_data.data(), buffer.data(), count);
+			result.insert(result.end(), buffer.begin(), buffer.end());
+			Eidos_PMax_Float(data.data(), other_data.data(), buffer.data(), count);
+			result.insert(result.end(), buffer.begin(), buffer.end());
+			Eidos_PMin_Float(data.data(), other_data.data(), buffer.data(), count);
+			result.insert(result.end(), buffer.begin(), buffer.end());
+			Eidos_PMax_Float_Singleton(data.data(), 0.0, buffer.data(), count);
+			result.insert(result.end(), buffer.begin(), buffer.end());
+			Eidos_PMin_Float_Singleton(data.data(), 0.0, buffer.data(), count);
+			result.insert(result.end(), buffer.begin(), buffer.end());
+		}
+		
+		gEidosUseAVX2 = saved_use_AVX2;
+		
+		_EidosAssertVectorKernelCondition(memcmp(&results[0][1], &results[0][2], sizeof(double)) == 0, "incremental pairwise sum differs from the whole-vector sum", count);
+		
+		if (results[1].size())
+			_EidosAssertVectorKernelCondition(memcmp(results[0].data(), results[1].data(), results[0].size() * sizeof(double)) == 0, "AVX2 kernels differ from portable kernels", count);
+	}
+}
+
+#pragma mark parallel vector functions
+// Runs a script with gEidosMaxThreads set to 1, and returns the value of its last statement, or nullptr if it raised
+static EidosValue_SP _EidosSerialValueForScript(const std::string &p_script_string)
+{
+	int saved_max_threads = gEidosMaxThreads;
+	EidosScript script(p_script_string);
+	EidosSymbolTable symbol_table(EidosSymbolTableType::kVariablesTable, gEidosConstantsSymbolTable);
+	EidosValue_SP result;
+	
+	gEidosMaxThreads = 1;
+	gEidosCurrentScript = &script;
+	
+	try {
+		script.Tokenize();
+		script.ParseInterpreterBlockToAST(true);
+		
+		EidosFunctionMap function_map(*EidosInterpreter::BuiltInFunctionMap());
+		EidosInterpreter interpreter(script, symbol_table, function_map, nullptr);
+		
+		result = interpreter.EvaluateInterpreterBlock(false, true);
+	}
+	catch (...)
+	{
+		result.reset();
+	}
+	
+	gEidosCurrentScript = nullptr;
+	gEidosExecutingRuntimeScript = false;
+	gEidosMaxThreads = saved_max_threads;
+	
+	return result;
+}
+
+// Checks that a script gets the same result when vectorized functions split their work across threads as when they do not
+static void _EidosAssertParallelMatchesSerial(const std::string &p_script_string)
+{
+	EidosValue_SP serial_result = _EidosSerialValueForScript(p_script_string);
+	
+	if (!serial_result)
+	{
+		gEidosTestFailureCount++;
+		std::cerr << p_script_string << " : " << EIDOS_OUTPUT_FAILURE_TAG << " : raise when run serially" << std::endl;
+		return;
+	}
+	
+	int saved_max_threads = gEidosMaxThreads;
+	int64_t saved_threshold = gEidosParallelVectorThreshold;
+	
+	gEidosMaxThreads = 4;
+	gEidosParallelVectorThreshold = 16;
+	
+	EidosAssertScriptSuccess(p_script_string, serial_result);
+	
+	gEidosMaxThreads = saved_max_threads;
+	gEidosParallelVectorThreshold = saved_threshold;
+}
+
+void _RunParallelVectorTests(void)
+{
+	// order() is a stable sort, so ties keep their original order
+	EidosAssertScriptSuccess("order(c(3, 1, 3, 1, 2));", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int_vector{1, 3, 4, 0, 2}));
+	EidosAssertScriptSuccess("order(c(3, 1, 3, 1, 2), F);", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int_vector{0, 2, 4, 1, 3}));
+	EidosAssertScriptSuccess("order(c('b', 'a', 'b', 'a'));", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int_vector{1, 3, 0, 2}));
+	
+	// sort() and order() put NAN last in both directions, and keep -0.0 and 0.0 in their original order
+	EidosAssertScriptSuccess("paste(sort(c(2, NAN, 0.0, -1, -0.0, NAN, 1)));", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String_singleton("-1 0 -0 1 2 NAN NAN")));
+	EidosAssertScriptSuccess("paste(sort(c(2, NAN, 0.0, -1, -0.0, NAN, 1), F));", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String_singleton("2 1 0 -0 -1 NAN NAN")));
+	EidosAssertScriptSuccess("order(c(2, NAN, 0.0, -1, -0.0, NAN, 1));", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int_vector{3, 2, 4, 6, 0, 1, 5}));
+	EidosAssertScriptSuccess("order(c(2, NAN, 0.0, -1, -0.0, NAN, 1), F);", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int_vector{0, 6, 2, 4, 3, 1, 5}));
+	
+	// long vectors are uniqued and matched with hash tables, with the same results as for short vectors
+	EidosAssertScriptSuccess("x = c(5:1, 1:100, 100:1); identical(unique(x), c(5:1, 6:100));", gStaticEidosValue_LogicalT);
+	EidosAssertScriptSuccess("x = asString(c(5:1, 1:100, 100:1)); identical(unique(x), asString(c(5:1, 6:100)));", gStaticEidosValue_LogicalT);
+	EidosAssertScriptSuccess("x = c(NAN, (1:50) / 2, NAN, 0.0, -0.0, (50:1) / 2); paste(unique(x)) == paste(c(NAN, (1:50) / 2, NAN, 0.0));", gStaticEidosValue_LogicalT);
+	EidosAssertScriptSuccess("x = integerMod(0:199, 70); t = c(69:0, 0:69); identical(match(x, t), 69 - x);", gStaticEidosValue_LogicalT);
+	EidosAssertScriptSuccess("x = c(NAN, 0.0, -0.0, (1:100) / 2); t = c(-0.0, NAN, (100:1) / 2); identical(match(x, t), c(-1, 0, 0, 102 - (1:100)));", gStaticEidosValue_LogicalT);
+	EidosAssertScriptSuccess("x = asString(integerMod(0:199, 70)); t = asString(c(69:0, 0:69)); identical(match(x, t), 69 - integerMod(0:199, 70));", gStaticEidosValue_LogicalT);
+	
+	// splitting the work across threads does not change any result
+	_EidosAssertParallelMatchesSerial("x = integerMod(0:999 * 7919, 1000); c(sort(x), sort(x, F));");
+	_EidosAssertParallelMatchesSerial("x = integerMod(0:999 * 7919, 1000) / 8 - 40; c(sort(x), sort(x, F));");
+	_EidosAssertParallelMatchesSerial("x = asString(integerMod(0:999 * 7919, 1000)); c(sort(x), sort(x, F));");
+	_EidosAssertParallelMatchesSerial("x = integerMod(0:999 * 7919, 37); c(order(x), order(x, F), order(x / 3), order(asString(x)), order(x > 18));");
+	_EidosAssertParallelMatchesSerial("x = c(NAN, -0.0, integerMod(0:999 * 7919, 37) / 2 - 9, 0.0, NAN, -0.0); paste(c(sort(x), sort(x, F)));");
+	_EidosAssertParallelMatchesSerial("x = c(NAN, -0.0, integerMod(0:999 * 7919, 37) / 2 - 9, 0.0, NAN, -0.0); c(order(x), order(x, F));");
+	_EidosAssertParallelMatchesSerial("x = integerMod(0:999 * 7919, 37); c(unique(x), asInteger(unique(x / 2) * 2), asInteger(unique(asString(x))));");
+	_EidosAssertParallelMatchesSerial("x = c(NAN, integerMod(0:999 * 7919, 37) / 2, NAN, -0.0, 0.0); paste(unique(x));");
+	_EidosAssertParallelMatchesSerial("x = integerMod(0:999 * 7919, 150); t = integerMod(0:99 * 7, 120); c(match(x, t), match(x / 2, t / 2), match(asString(x), asString(t)));");
+	_EidosAssertParallelMatchesSerial("x = integerMod(0:999 * 7919, 7) == 3; c(which(x), which(rep(F, 500)), which(rep(T, 50)));");
+	_EidosAssertParallelMatchesSerial("x = integerMod(0:999 * 7919, 37); c(paste(x), paste(x / 3, sep=', '), paste0(x > 18), paste(asString(x), sep=''));");
+	_EidosAssertParallelMatchesSerial("x = (1:1000) / 7; c(exp(x - 50), log(x), dnorm(x, 3.0, 2.0));");
+}
 
 
 
@@ -78,7 +78,37 @@ EidosTypeSpecifier EidosTypeInterpreter::TypeEvaluateInterpreterBlock_AddArgumen
 	return ret;
 }
 
+// this is a front end for TypeEvaluateInterpreterBlock() that records the type mask inferred for each node it evaluates, for use
+// by EidosASTNode::OptimizeTypeSpecializations(); a node evaluated more than once gets the union of its masks, and a node whose
+// type could not be inferred gets kEidosValueMaskFlagStrip (all types), so only consistently inferred types are trusted at all;
+// operators with a fixed result type, such as the logical and comparison operators, still evaluate their operands so that the
+// types of the operand nodes get recorded too
+EidosTypeSpecifier EidosTypeInterpreter::TypeEvaluateInterpreterBlock_RecordNodeTypes(EidosNodeTypeTable *p_node_types)
+{
+	node_types_ = p_node_types;
+	
+	EidosTypeSpecifier ret = TypeEvaluateInterpreterBlock();
+	
+	node_types_ = nullptr;
+	
+	return ret;
+}
+
 EidosTypeSpecifier EidosTypeInterpreter::TypeEvaluateNode(const EidosASTNode *p_node)
+{
+	EidosTypeSpecifier result_type = _TypeEvaluateNode(p_node);
+	
+	if (node_types_ && p_node)
+	{
+		EidosValueMask type_mask = (result_type.type_mask & kEidosValueMaskFlagStrip);
+		
+		(*node_types_)[p_node] |= (type_mask ? type_mask : kEidosValueMaskFlagStrip);
+	}
+	
+	return result_type;
+}
+
+EidosTypeSpecifier EidosTypeInterpreter::_TypeEvaluateNode(const EidosASTNode *p_node)
 {
 	if (p_node)
 	{
@@ -780,25 +810,31 @@ EidosTypeSpecifier EidosTypeInterpreter::TypeEvaluate_Exp(const EidosASTNode *p_
 
 EidosTypeSpecifier EidosTypeInterpreter::TypeEvaluate_And(const EidosASTNode *p_node)
 {
-#pragma unused(p_node)
 	EidosTypeSpecifier result_type = EidosTypeSpecifier{kEidosValueMaskLogical, nullptr};
 	
+	for (EidosASTNode *child_node : p_node->children_)
+		TypeEvaluateNode(child_node);
+	
 	return result_type;
 }
 
 EidosTypeSpecifier EidosTypeInterpreter::TypeEvaluate_Or(const EidosASTNode *p_node)
 {
-#pragma unused(p_node)
 	EidosTypeSpecifier result_type = EidosTypeSpecifier{kEidosValueMaskLogical, nullptr};
 	
+	for (EidosASTNode *child_node : p_node->children_)
+		TypeEvaluateNode(child_node);
+	
 	return result_type;
 }
 
 EidosTypeSpecifier EidosTypeInterpreter::TypeEvaluate_Not(const EidosASTNode *p_node)
 {
-#pragma unused(p_node)
 	EidosTypeSpecifier result_type = EidosTypeSpecifier{kEidosValueMaskLogical, nullptr};
 	
+	for (EidosASTNode *child_node : p_node->children_)
+		TypeEvaluateNode(child_node);
+	
 	return result_type;
 }
 
@@ -826,49 +862,61 @@ EidosTypeSpecifier EidosTypeInterpreter::TypeEvaluate_Assign(const EidosASTNode
 
 EidosTypeSpecifier EidosTypeInterpreter::TypeEvaluate_Eq(const EidosASTNode *p_node)
 {
-#pragma unused(p_node)
 	EidosTypeSpecifier result_type = EidosTypeSpecifier{kEidosValueMaskLogical, nullptr};
 	
+	for (EidosASTNode *child_node : p_node->children_)
+		TypeEvaluateNode(child_node);
+	
 	return result_type;
 }
 
 EidosTypeSpecifier EidosTypeInterpreter::TypeEvaluate_Lt(const EidosASTNode *p_node)
 {
-#pragma unused(p_node)
 	EidosTypeSpecifier result_type = EidosTypeSpecifier{kEidosValueMaskLogical, nullptr};
 	
+	for (EidosASTNode *child_node : p_node->children_)
+		TypeEvaluateNode(child_node);
+	
 	return result_type;
 }
 
 EidosTypeSpecifier EidosTypeInterpreter::TypeEvaluate_LtEq(const EidosASTNode *p_node)
 {
-#pragma unused(p_node)
 	EidosTypeSpecifier result_type = EidosTypeSpecifier{kEidosValueMaskLogical, nullptr};
 	
+	for (EidosASTNode *child_node : p_node->children_)
+		TypeEvaluateNode(child_node);
+	
 	return result_type;
 }
 
 EidosTypeSpecifier EidosTypeInterpreter::TypeEvaluate_Gt(const EidosASTNode *p_node)
 {
-#pragma unused(p_node)
 	EidosTypeSpecifier result_type = EidosTypeSpecifier{kEidosValueMaskLogical, nullptr};
 	
+	for (EidosASTNode *child_node : p_node->children_)
+		TypeEvaluateNode(child_node);
+	
 	return result_type;
 }
 
 EidosTypeSpecifier EidosTypeInterpreter::TypeEvaluate_GtEq(const EidosASTNode *p_node)
 {
-#pragma unused(p_node)
 	EidosTypeSpecifier result_type = EidosTypeSpecifier{kEidosValueMaskLogical, nullptr};
 	
+	for (EidosASTNode *child_node : p_node->children_)
+		TypeEvaluateNode(child_node);
+	
 	return result_type;
 }
 
 EidosTypeSpecifier EidosTypeInterpreter::TypeEvaluate_NotEq(const EidosASTNode *p_node)
 {
-#pragma unused(p_node)
 	EidosTypeSpecifier result_type = EidosTypeSpecifier{kEidosValueMaskLogical, nullptr};
 	
+	for (EidosASTNode *child_node : p_node->children_)
+		TypeEvaluateNode(child_node);
+	
 	return result_type;
 }
 
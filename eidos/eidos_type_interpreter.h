@@ -59,6 +59,9 @@ protected:
 	std::vector<std::string> *argument_completions_ = nullptr;
 	size_t script_length_ = 0;
 	
+	// for recording the types of nodes, set up by TypeEvaluateInterpreterBlock_RecordNodeTypes()
+	EidosNodeTypeTable *node_types_ = nullptr;
+	
 public:
 	
 	EidosTypeInterpreter(const EidosTypeInterpreter&) = delete;					// no copying
@@ -77,8 +80,10 @@ public:
 	// Evaluation methods; the caller owns the returned EidosValue object
 	EidosTypeSpecifier TypeEvaluateInterpreterBlock();	// the starting point for executed blocks in Eidos, which do not require braces
 	EidosTypeSpecifier TypeEvaluateInterpreterBlock_AddArgumentCompletions(std::vector<std::string> *p_argument_completions, size_t p_script_length);	// for autocompletion of argument names
+	EidosTypeSpecifier TypeEvaluateInterpreterBlock_RecordNodeTypes(EidosNodeTypeTable *p_node_types);	// for EidosASTNode::OptimizeTypeSpecializations()
 	
 	EidosTypeSpecifier TypeEvaluateNode(const EidosASTNode *p_node);
+	EidosTypeSpecifier _TypeEvaluateNode(const EidosASTNode *p_node);
 	
 	EidosTypeSpecifier TypeEvaluate_NullStatement(const EidosASTNode *p_node);
 	EidosTypeSpecifier TypeEvaluate_CompoundStatement(const EidosASTNode *p_node);
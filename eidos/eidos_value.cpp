@@ -21,6 +21,7 @@
 #include "eidos_functions.h"
 #include "eidos_call_signature.h"
 #include "eidos_property_signature.h"
+#include "eidos_parallel.h"
 
 #include <algorithm>
 #include <utility>
@@ -1049,9 +1050,9 @@ void EidosValue_Logical::PushValueFromIndexOfEidosValue(int p_idx, const EidosVa
 void EidosValue_Logical::Sort(bool p_ascending)
 {
 	if (p_ascending)
-		std::sort(values_, values_ + count_);
+		Eidos_ParallelStableSort(values_, count_, EidosSortLess<eidos_logical_t>());
 	else
-		std::sort(values_, values_ + count_, std::greater<eidos_logical_t>());
+		Eidos_ParallelStableSort(values_, count_, EidosSortGreater<eidos_logical_t>());
 }
 
 EidosValue_Logical *EidosValue_Logical::reserve(size_t p_reserved_size)
@@ -1288,9 +1289,9 @@ void EidosValue_String_vector::PushValueFromIndexOfEidosValue(int p_idx, const E
 void EidosValue_String_vector::Sort(bool p_ascending)
 {
 	if (p_ascending)
-		std::sort(values_.begin(), values_.end());
+		Eidos_ParallelStableSort(values_.data(), values_.size(), EidosSortLess<std::string>());
 	else
-		std::sort(values_.begin(), values_.end(), std::greater<std::string>());
+		Eidos_ParallelStableSort(values_.data(), values_.size(), EidosSortGreater<std::string>());
 }
 
 
@@ -1535,9 +1536,9 @@ void EidosValue_Int_vector::PushValueFromIndexOfEidosValue(int p_idx, const Eido
 void EidosValue_Int_vector::Sort(bool p_ascending)
 {
 	if (p_ascending)
-		std::sort(values_, values_ + count_);
+		Eidos_ParallelStableSort(values_, count_, EidosSortLess<int64_t>());
 	else
-		std::sort(values_, values_ + count_, std::greater<int64_t>());
+		Eidos_ParallelStableSort(values_, count_, EidosSortGreater<int64_t>());
 }
 
 EidosValue_Int_vector *EidosValue_Int_vector::reserve(size_t p_reserved_size)
@@ -1815,9 +1816,9 @@ void EidosValue_Float_vector::PushValueFromIndexOfEidosValue(int p_idx, const Ei
 void EidosValue_Float_vector::Sort(bool p_ascending)
 {
 	if (p_ascending)
-		std::sort(values_, values_ + count_);
+		Eidos_ParallelStableSort(values_, count_, EidosSortLess<double>());
 	else
-		std::sort(values_, values_ + count_, std::greater<double>());
+		Eidos_ParallelStableSort(values_, count_, EidosSortGreater<double>());
 }
 
 EidosValue_Float_vector *EidosValue_Float_vector::reserve(size_t p_reserved_size)
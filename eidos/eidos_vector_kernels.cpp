@@ -0,0 +1,399 @@
+//
+//  eidos_vector_kernels.cpp
+//  Eidos
+//
+//  Copyright (c) 2019 Philipp Messer.  All rights reserved.
+//	A product of the Messer Lab, http://messerlab.org/slim/
+//
+
+//	This file is part of Eidos.
+//
+//	Eidos is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+//
+//	Eidos is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with Eidos.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "eidos_vector_kernels.h"
+#include "eidos_globals.h"
+#include "eidos_parallel.h"
+
+#include <cmath>
+#include <algorithm>
+
+#if EIDOS_HAS_AVX2_DISPATCH
+#include <immintrin.h>
+#endif
+
+
+// The AVX2 variants are used only for vectors at least this long; below that, the portable variants are as fast
+#define EIDOS_KERNEL_AVX2_MIN_COUNT		32
+
+
+#pragma mark -
+#pragma mark Pairwise summation
+#pragma mark -
+
+// A block is summed in sixteen lanes: element k of the block goes into lane k % 16, for each full group of sixteen elements.  The
+// lanes are then folded together, lane k + 8 into lane k and then lane k + 4 into lane k, which is exactly what adding the four
+// AVX2 accumulators together pairwise does; the last four lanes are added in a fixed order, followed by the leftover elements.
+static inline __attribute__((always_inline)) double _Eidos_FinishLanes(const double *p_lanes, const double *p_tail, int p_tail_count)
+{
+	double sum = (p_lanes[0] + p_lanes[2]) + (p_lanes[1] + p_lanes[3]);
+	
+	for (int index = 0; index < p_tail_count; ++index)
+		sum += p_tail[index];
+	
+	return sum;
+}
+
+static inline __attribute__((always_inline)) void _Eidos_FoldLanes(double *p_lanes)
+{
+	for (int lane = 0; lane < 8; ++lane)
+		p_lanes[lane] += p_lanes[lane + 8];
+	for (int lane = 0; lane < 4; ++lane)
+		p_lanes[lane] += p_lanes[lane + 4];
+}
+
+static inline __attribute__((always_inline)) double _Eidos_BlockSum_Scalar(const double *p_data, int p_count)
+{
+	double lanes[16] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+	int index = 0;
+	
+	for (; index + 16 <= p_count; index += 16)
+		for (int lane = 0; lane < 16; ++lane)
+			lanes[lane] += p_data[index + lane];
+	
+	_Eidos_FoldLanes(lanes);
+	return _Eidos_FinishLanes(lanes, p_data + index, p_count - index);
+}
+
+static inline __attribute__((always_inline)) double _Eidos_BlockSumOfSquaredDeviations_Scalar(const double *p_data, int p_count, double p_mean)
+{
+	double lanes[16] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+	double tail[16];
+	int index = 0;
+	
+	for (; index + 16 <= p_count; index += 16)
+		for (int lane = 0; lane < 16; ++lane)
+		{
+			double deviation = p_data[index + lane] - p_mean;
+			
+			lanes[lane] += deviation * deviation;
+		}
+	
+	int tail_count = p_count - index;
+	
+	for (int tail_index = 0; tail_index < tail_count; ++tail_index)
+	{
+		double deviation = p_data[index + tail_index] - p_mean;
+		
+		tail[tail_index] = deviation * deviation;
+	}
+	
+	_Eidos_FoldLanes(lanes);
+	return _Eidos_FinishLanes(lanes, tail, tail_count);
+}
+
+#if EIDOS_HAS_AVX2_DISPATCH
+__attribute__((target("avx2"))) static inline double _Eidos_BlockSum_AVX2(const double *p_data, int p_count)
+{
+	__m256d sum0 = _mm256_setzero_pd(), sum1 = _mm256_setzero_pd(), sum2 = _mm256_setzero_pd(), sum3 = _mm256_setzero_pd();
+	int index = 0;
+	
+	for (; index + 16 <= p_count; index += 16)
+	{
+		sum0 = _mm256_add_pd(sum0, _mm256_loadu_pd(p_data + index));
+		sum1 = _mm256_add_pd(sum1, _mm256_loadu_pd(p_data + index + 4));
+		sum2 = _mm256_add_pd(sum2, _mm256_loadu_pd(p_data + index + 8));
+		sum3 = _mm256_add_pd(sum3, _mm256_loadu_pd(p_data + index + 12));
+	}
+	
+	double lanes[4];
+	
+	_mm256_storeu_pd(lanes, _mm256_add_pd(_mm256_add_pd(sum0, sum2), _mm256_add_pd(sum1, sum3)));
+	return _Eidos_FinishLanes(lanes, p_data + index, p_count - index);
+}
+
+__attribute__((target("avx2"))) static inline double _Eidos_BlockSumOfSquaredDeviations_AVX2(const double *p_data, int p_count, double p_mean)
+{
+	__m256d sum0 = _mm256_setzero_pd(), sum1 = _mm256_setzero_pd(), sum2 = _mm256_setzero_pd(), sum3 = _mm256_setzero_pd();
+	__m256d mean = _mm256_set1_pd(p_mean);
+	double tail[16];
+	int index = 0;
+	
+	for (; index + 16 <= p_count; index += 16)
+	{
+		__m256d deviation0 = _mm256_sub_pd(_mm256_loadu_pd(p_data + index), mean);
+		__m256d deviation1 = _mm256_sub_pd(_mm256_loadu_pd(p_data + index + 4), mean);
+		__m256d deviation2 = _mm256_sub_pd(_mm256_loadu_pd(p_data + index + 8), mean);
+		__m256d deviation3 = _mm256_sub_pd(_mm256_loadu_pd(p_data + index + 12), mean);
+		
+		sum0 = _mm256_add_pd(sum0, _mm256_mul_pd(deviation0, deviation0));
+		sum1 = _mm256_add_pd(sum1, _mm256_mul_pd(deviation1, deviation1));
+		sum2 = _mm256_add_pd(sum2, _mm256_mul_pd(deviation2, deviation2));
+		sum3 = _mm256_add_pd(sum3, _mm256_mul_pd(deviation3, deviation3));
+	}
+	
+	int tail_count = p_count - index;
+	
+	for (int tail_index = 0; tail_index < tail_count; ++tail_index)
+	{
+		double deviation = p_data[index + tail_index] - p_mean;
+		
+		tail[tail_index] = deviation * deviation;
+	}
+	
+	double lanes[4];
+	
+	_mm256_storeu_pd(lanes, _mm256_add_pd(_mm256_add_pd(sum0, sum2), _mm256_add_pd(sum1, sum3)));
+	return _Eidos_FinishLanes(lanes, tail, tail_count);
+}
+
+__attribute__((target("avx2"))) static double _Eidos_PairwiseSum_Float_AVX2(const double *p_data, int64_t p_count)
+{
+	EidosPairwiseSum sum;
+	
+	for (int64_t block_start = 0; block_start < p_count; block_start += EIDOS_PAIRWISE_SUM_BLOCK)
+		sum.AddBlockSum(_Eidos_BlockSum_AVX2(p_data + block_start, (int)std::min<int64_t>(EIDOS_PAIRWISE_SUM_BLOCK, p_count - block_start)));
+	
+	return sum.Total();
+}
+
+__attribute__((target("avx2"))) static double _Eidos_PairwiseSumOfSquaredDeviations_Float_AVX2(const double *p_data, int64_t p_count, double p_mean)
+{
+	EidosPairwiseSum sum;
+	
+	for (int64_t block_start = 0; block_start < p_count; block_start += EIDOS_PAIRWISE_SUM_BLOCK)
+		sum.AddBlockSum(_Eidos_BlockSumOfSquaredDeviations_AVX2(p_data + block_start, (int)std::min<int64_t>(EIDOS_PAIRWISE_SUM_BLOCK, p_count - block_start), p_mean));
+	
+	return sum.Total();
+}
+#endif
+
+double Eidos_BlockSum_Float(const double *p_data, int p_count)
+{
+#if EIDOS_HAS_AVX2_DISPATCH
+	if (gEidosUseAVX2 && (p_count >= EIDOS_KERNEL_AVX2_MIN_COUNT))
+		return _Eidos_BlockSum_AVX2(p_data, p_count);
+#endif
+	
+	return _Eidos_BlockSum_Scalar(p_data, p_count);
+}
+
+double Eidos_PairwiseSum_Float(const double *p_data, int64_t p_count)
+{
+#if EIDOS_HAS_AVX2_DISPATCH
+	if (gEidosUseAVX2 && (p_count >= EIDOS_KERNEL_AVX2_MIN_COUNT))
+		return _Eidos_PairwiseSum_Float_AVX2(p_data, p_count);
+#endif
+	
+	EidosPairwiseSum sum;
+	
+	for (int64_t block_start = 0; block_start < p_count; block_start += EIDOS_PAIRWISE_SUM_BLOCK)
+		sum.AddBlockSum(_Eidos_BlockSum_Scalar(p_data + block_start, (int)std::min<int64_t>(EIDOS_PAIRWISE_SUM_BLOCK, p_count - block_start)));
+	
+	return sum.Total();
+}
+
+double Eidos_PairwiseSumOfSquaredDeviations_Float(const double *p_data, int64_t p_count, double p_mean)
+{
+#if EIDOS_HAS_AVX2_DISPATCH
+	if (gEidosUseAVX2 && (p_count >= EIDOS_KERNEL_AVX2_MIN_COUNT))
+		return _Eidos_PairwiseSumOfSquaredDeviations_Float_AVX2(p_data, p_count, p_mean);
+#endif
+	
+	EidosPairwiseSum sum;
+	
+	for (int64_t block_start = 0; block_start < p_count; block_start += EIDOS_PAIRWISE_SUM_BLOCK)
+		sum.AddBlockSum(_Eidos_BlockSumOfSquaredDeviations_Scalar(p_data + block_start, (int)std::min<int64_t>(EIDOS_PAIRWISE_SUM_BLOCK, p_count - block_start), p_mean));
+	
+	return sum.Total();
+}
+
+
+#pragma mark -
+#pragma mark Elementwise kernels
+#pragma mark -
+
+#if EIDOS_HAS_AVX2_DISPATCH
+__attribute__((target("avx2"))) static void _Eidos_Sqrt_Float_AVX2(const double *p_data, double *p_result, int64_t p_count)
+{
+	// vsqrtpd is correctly rounded, like sqrt(), so the results are identical
+	int64_t index = 0;
+	
+	for (; index + 4 <= p_count; index += 4)
+		_mm256_storeu_pd(p_result + index, _mm256_sqrt_pd(_mm256_loadu_pd(p_data + index)));
+	
+	for (; index < p_count; ++index)
+		p_result[index] = sqrt(p_data[index]);
+}
+
+// vmaxpd(a, b) is (a > b) ? a : b, so vmaxpd(y, x) is (x < y) ? y : x, which is std::max(x, y), including for NAN and signed zeros;
+// likewise vminpd(y, x) is (y < x) ? y : x, which is std::min(x, y)
+__attribute__((target("avx2"))) static void _Eidos_PMax_Float_AVX2(const double *p_data1, const double *p_data2, double *p_result, int64_t p_count)
+{
+	int64_t index = 0;
+	
+	for (; index + 4 <= p_count; index += 4)
+		_mm256_storeu_pd(p_result + index, _mm256_max_pd(_mm256_loadu_pd(p_data2 + index), _mm256_loadu_pd(p_data1 + index)));
+	
+	for (; index < p_count; ++index)
+		p_result[index] = std::max(p_data1[index], p_data2[index]);
+}
+
+__attribute__((target("avx2"))) static void _Eidos_PMin_Float_AVX2(const double *p_data1, const double *p_data2, double *p_result, int64_t p_count)
+{
+	int64_t index = 0;
+	
+	for (; index + 4 <= p_count; index += 4)
+		_mm256_storeu_pd(p_result + index, _mm256_min_pd(_mm256_loadu_pd(p_data2 + index), _mm256_loadu_pd(p_data1 + index)));
+	
+	for (; index < p_count; ++index)
+		p_result[index] = std::min(p_data1[index], p_data2[index]);
+}
+
+__attribute__((target("avx2"))) static void _Eidos_PMax_Float_Singleton_AVX2(const double *p_data, double p_singleton, double *p_result, int64_t p_count)
+{
+	__m256d singleton = _mm256_set1_pd(p_singleton);
+	int64_t index = 0;
+	
+	for (; index + 4 <= p_count; index += 4)
+		_mm256_storeu_pd(p_result + index, _mm256_max_pd(singleton, _mm256_loadu_pd(p_data + index)));
+	
+	for (; index < p_count; ++index)
+		p_result[index] = std::max(p_data[index], p_singleton);
+}
+
+__attribute__((target("avx2"))) static void _Eidos_PMin_Float_Singleton_AVX2(const double *p_data, double p_singleton, double *p_result, int64_t p_count)
+{
+	__m256d singleton = _mm256_set1_pd(p_singleton);
+	int64_t index = 0;
+	
+	for (; index + 4 <= p_count; index += 4)
+		_mm256_storeu_pd(p_result + index, _mm256_min_pd(singleton, _mm256_loadu_pd(p_data + index)));
+	
+	for (; index < p_count; ++index)
+		p_result[index] = std::min(p_data[index], p_singleton);
+}
+#endif
+
+void Eidos_Sqrt_Float(const double *p_data, double *p_result, int64_t p_count)
+{
+#if EIDOS_HAS_AVX2_DISPATCH
+	if (gEidosUseAVX2 && (p_count >= EIDOS_KERNEL_AVX2_MIN_COUNT))
+	{
+		_Eidos_Sqrt_Float_AVX2(p_data, p_result, p_count);
+		return;
+	}
+#endif
+	
+	for (int64_t index = 0; index < p_count; ++index)
+		p_result[index] = sqrt(p_data[index]);
+}
+
+void Eidos_Exp_Float(const double *p_data, double *p_result, int64_t p_count)
+{
+	// exp() and log() are costly enough to be worth spreading across threads for long vectors; each element is independent
+	int piece_count = Eidos_ParallelPieceCount(p_count);
+	
+#pragma omp parallel for num_threads(piece_count) schedule(static) default(none) shared(p_data, p_result, p_count) if(piece_count > 1)
+	for (int64_t index = 0; index < p_count; ++index)
+		p_result[index] = exp(p_data[index]);
+}
+
+void Eidos_Log_Float(const double *p_data, double *p_result, int64_t p_count)
+{
+	int piece_count = Eidos_ParallelPieceCount(p_count);
+	
+#pragma omp parallel for num_threads(piece_count) schedule(static) default(none) shared(p_data, p_result, p_count) if(piece_count > 1)
+	for (int64_t index = 0; index < p_count; ++index)
+		p_result[index] = log(p_data[index]);
+}
+
+void Eidos_CumSum_Float(const double *p_data, double *p_result, int64_t p_count)
+{
+	// a cumulative sum is inherently sequential; each partial sum is defined as the previous one plus the next element
+	double sum = 0.0;
+	
+	for (int64_t index = 0; index < p_count; ++index)
+	{
+		sum += p_data[index];
+		p_result[index] = sum;
+	}
+}
+
+void Eidos_PMax_Float(const double *p_data1, const double *p_data2, double *p_result, int64_t p_count)
+{
+#if EIDOS_HAS_AVX2_DISPATCH
+	if (gEidosUseAVX2 && (p_count >= EIDOS_KERNEL_AVX2_MIN_COUNT))
+	{
+		_Eidos_PMax_Float_AVX2(p_data1, p_data2, p_result, p_count);
+		return;
+	}
+#endif
+	
+	for (int64_t index = 0; index < p_count; ++index)
+		p_result[index] = std::max(p_data1[index], p_data2[index]);
+}
+
+void Eidos_PMin_Float(const double *p_data1, const double *p_data2, double *p_result, int64_t p_count)
+{
+#if EIDOS_HAS_AVX2_DISPATCH
+	if (gEidosUseAVX2 && (p_count >= EIDOS_KERNEL_AVX2_MIN_COUNT))
+	{
+		_Eidos_PMin_Float_AVX2(p_data1, p_data2, p_result, p_count);
+		return;
+	}
+#endif
+	
+	for (int64_t index = 0; index < p_count; ++index)
+		p_result[index] = std::min(p_data1[index], p_data2[index]);
+}
+
+void Eidos_PMax_Float_Singleton(const double *p_data, double p_singleton, double *p_result, int64_t p_count)
+{
+#if EIDOS_HAS_AVX2_DISPATCH
+	if (gEidosUseAVX2 && (p_count >= EIDOS_KERNEL_AVX2_MIN_COUNT))
+	{
+		_Eidos_PMax_Float_Singleton_AVX2(p_data, p_singleton, p_result, p_count);
+		return;
+	}
+#endif
+	
+	for (int64_t index = 0; index < p_count; ++index)
+		p_result[index] = std::max(p_data[index], p_singleton);
+}
+
+void Eidos_PMin_Float_Singleton(const double *p_data, double p_singleton, double *p_result, int64_t p_count)
+{
+#if EIDOS_HAS_AVX2_DISPATCH
+	if (gEidosUseAVX2 && (p_count >= EIDOS_KERNEL_AVX2_MIN_COUNT))
+	{
+		_Eidos_PMin_Float_Singleton_AVX2(p_data, p_singleton, p_result, p_count);
+		return;
+	}
+#endif
+	
+	for (int64_t index = 0; index < p_count; ++index)
+		p_result[index] = std::min(p_data[index], p_singleton);
+}
+
+void Eidos_DNorm_Float(const double *p_data, double p_mu, double p_sigma, double *p_result, int64_t p_count)
+{
+	// this is gsl_ran_gaussian_pdf(x - mu, sigma) with its loop-invariant parts hoisted, performing the same operations in the same order
+	double abs_sigma = fabs(p_sigma);
+	double normalization = 1 / (sqrt(2 * M_PI) * abs_sigma);
+	int piece_count = Eidos_ParallelPieceCount(p_count);
+	
+#pragma omp parallel for num_threads(piece_count) schedule(static) default(none) shared(p_data, p_mu, abs_sigma, normalization, p_result, p_count) if(piece_count > 1)
+	for (int64_t index = 0; index < p_count; ++index)
+	{
+		double u = (p_data[index] - p_mu) / abs_sigma;
+		
+		p_result[index] = normalization * exp(-u * u / 2);
+	}
+}
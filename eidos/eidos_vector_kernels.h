@@ -0,0 +1,104 @@
+//
+//  eidos_vector_kernels.h
+//  Eidos
+//
+//  Copyright (c) 2019 Philipp Messer.  All rights reserved.
+//	A product of the Messer Lab, http://messerlab.org/slim/
+//
+
+//	This file is part of Eidos.
+//
+//	Eidos is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+//
+//	Eidos is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with Eidos.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+
+ This file contains kernels for the hot loops of Eidos's math and statistics functions, over raw buffers of double.  Each kernel
+ has a portable variant, written so that the compiler can vectorize it, and, where it pays off, an AVX2 variant that is used for
+ long vectors when gEidosUseAVX2 is set (see eidos_globals.h).  As elsewhere, the two variants of a kernel produce bit-identical
+ results, so results never depend upon the CPU.
+
+ Sums are computed by pairwise summation, which has an error bound that grows with log(n) rather than n.  The order of the
+ additions is fixed by the length of the vector alone: elements are summed in blocks of EIDOS_PAIRWISE_SUM_BLOCK, each block in
+ sixteen interleaved lanes that are then combined in a fixed tree, and the block sums are combined in a binary tree by
+ EidosPairwiseSum.  Since the blocks are consumed in order, a sum can also be accumulated incrementally, a block at a time, without
+ materializing the whole vector; EidosInterpreter::Evaluate_FusedReduction() does this, and gets the same result as sum().
+
+ Elementwise kernels that call into the math library (exp(), log()) stay scalar, since a vectorized exp() or log() would not give
+ the same results as the math library; they still gain from working on raw buffers rather than through EidosValue accessors.
+
+ */
+
+#ifndef __Eidos__eidos_vector_kernels__
+#define __Eidos__eidos_vector_kernels__
+
+#include <stdint.h>
+
+
+// The number of elements in each block of a pairwise sum; the incremental form of a sum must be fed blocks of exactly this size
+#define EIDOS_PAIRWISE_SUM_BLOCK		128
+
+// Accumulates the sums of consecutive blocks into a pairwise sum.  Each block should be the sum of EIDOS_PAIRWISE_SUM_BLOCK elements,
+// except that the last block may be shorter; Eidos_BlockSum_Float() computes such block sums.  The sums of blocks 2k and 2k+1 are
+// added together as soon as both are available, and so on up the tree, so only O(log n) partial sums are kept.
+class EidosPairwiseSum
+{
+private:
+	double partial_sums_[64];
+	int partial_count_ = 0;
+	int64_t block_count_ = 0;
+	
+public:
+	inline __attribute__((always_inline)) void AddBlockSum(double p_block_sum)
+	{
+		partial_sums_[partial_count_++] = p_block_sum;
+		
+		// merge completed subtrees, as in incrementing a binary counter
+		for (int64_t block_index = block_count_++; block_index & 1; block_index >>= 1)
+		{
+			--partial_count_;
+			partial_sums_[partial_count_ - 1] += partial_sums_[partial_count_];
+		}
+	}
+	
+	inline double Total(void) const
+	{
+		if (partial_count_ == 0)
+			return 0.0;
+		
+		double total = partial_sums_[partial_count_ - 1];
+		
+		for (int partial_index = partial_count_ - 2; partial_index >= 0; --partial_index)
+			total = partial_sums_[partial_index] + total;
+		
+		return total;
+	}
+};
+
+// Sums one block of at most EIDOS_PAIRWISE_SUM_BLOCK elements, for EidosPairwiseSum
+double Eidos_BlockSum_Float(const double *p_data, int p_count);
+
+// Pairwise sums over whole vectors; the second sums the squared deviations from p_mean, for var() and sd()
+double Eidos_PairwiseSum_Float(const double *p_data, int64_t p_count);
+double Eidos_PairwiseSumOfSquaredDeviations_Float(const double *p_data, int64_t p_count, double p_mean);
+
+// Elementwise kernels; p_result may not overlap the operands
+void Eidos_Sqrt_Float(const double *p_data, double *p_result, int64_t p_count);
+void Eidos_Exp_Float(const double *p_data, double *p_result, int64_t p_count);
+void Eidos_Log_Float(const double *p_data, double *p_result, int64_t p_count);
+void Eidos_CumSum_Float(const double *p_data, double *p_result, int64_t p_count);
+void Eidos_PMax_Float(const double *p_data1, const double *p_data2, double *p_result, int64_t p_count);
+void Eidos_PMin_Float(const double *p_data1, const double *p_data2, double *p_result, int64_t p_count);
+void Eidos_PMax_Float_Singleton(const double *p_data, double p_singleton, double *p_result, int64_t p_count);
+void Eidos_PMin_Float_Singleton(const double *p_data, double p_singleton, double *p_result, int64_t p_count);
+
+// The normal density for each element of p_data, with a single mean and standard deviation; bit-identical to gsl_ran_gaussian_pdf()
+void Eidos_DNorm_Float(const double *p_data, double p_mu, double p_sigma, double *p_result, int64_t p_count);
+
+
+#endif /* defined(__Eidos__eidos_vector_kernels__) */
@@ -4,6 +4,12 @@
 #include <sys/stat.h>
 #endif
 
+#if defined(__unix__) || defined(__APPLE__)
+#define KAS_HAVE_MMAP 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -360,6 +366,38 @@ out:
     return ret;
 }
 
+#ifdef KAS_HAVE_MMAP
+static int KAS_WARN_UNUSED
+kastore_map_file(kastore_t *self)
+{
+    int ret = 0;
+    int fd = fileno(self->file);
+    struct stat file_stat;
+    void *mapping;
+
+    if (fstat(fd, &file_stat) != 0) {
+        ret = KAS_ERR_IO;
+        goto out;
+    }
+    /* Touching a mapped page beyond the end of the file would raise SIGBUS,
+     * so a file shorter than its header claims is rejected here; the fread
+     * path reports the same condition as a read error. */
+    if ((size_t) file_stat.st_size < self->file_size) {
+        ret = KAS_ERR_BAD_FILE_FORMAT;
+        goto out;
+    }
+    mapping = mmap(NULL, self->file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+        /* Fall back to reading the file into memory */
+        self->flags &= ~KAS_READ_MMAP;
+        goto out;
+    }
+    self->read_buffer = (char *) mapping;
+out:
+    return ret;
+}
+#endif
+
 static int KAS_WARN_UNUSED
 kastore_read_file(kastore_t *self)
 {
@@ -374,20 +412,32 @@ kastore_read_file(kastore_t *self)
         size = self->items[0].array_start;
     }
 
-    self->read_buffer = malloc(size);
-    if (self->read_buffer == NULL) {
-        ret = KAS_ERR_NO_MEMORY;
-        goto out;
-    }
-    err = fseek(self->file, 0, SEEK_SET);
-    if (err != 0) {
-        ret = KAS_ERR_IO;
-        goto out;
+#ifdef KAS_HAVE_MMAP
+    if (self->flags & KAS_READ_MMAP) {
+        ret = kastore_map_file(self);
+        if (ret != 0) {
+            goto out;
+        }
     }
-    count = fread(self->read_buffer, size, 1, self->file);
-    if (count == 0) {
-        ret = kastore_get_read_io_error(self);
-        goto out;
+#else
+    self->flags &= ~KAS_READ_MMAP;
+#endif
+    if (self->read_buffer == NULL) {
+        self->read_buffer = malloc(size);
+        if (self->read_buffer == NULL) {
+            ret = KAS_ERR_NO_MEMORY;
+            goto out;
+        }
+        err = fseek(self->file, 0, SEEK_SET);
+        if (err != 0) {
+            ret = KAS_ERR_IO;
+            goto out;
+        }
+        count = fread(self->read_buffer, size, 1, self->file);
+        if (count == 0) {
+            ret = kastore_get_read_io_error(self);
+            goto out;
+        }
     }
     /* Assign the pointers for the keys and arrays */
     for (j = 0; j < self->num_items; j++) {
@@ -532,6 +582,9 @@ kastore_open(kastore_t *self, const char *filename, const char *mode, int flags)
         goto out;
     }
     self->flags = flags;
+    if (flags & KAS_READ_MMAP) {
+        self->flags |= KAS_READ_ALL;
+    }
     self->filename = filename;
     if (appending) {
         ret = kastore_open(&tmp, self->filename, "r", KAS_READ_ALL);
@@ -583,10 +636,18 @@ kastore_close(kastore_t *self)
             /* We only alloc memory for the keys and arrays in write mode */
             for (j = 0; j < self->num_items; j++) {
                 kas_safe_free(self->items[j].key);
-                kas_safe_free(self->items[j].array);
+                if (! (self->items[j].flags & KAS_BORROWS_ARRAY)) {
+                    kas_safe_free(self->items[j].array);
+                }
             }
         }
     } else {
+#ifdef KAS_HAVE_MMAP
+        if ((self->flags & KAS_READ_MMAP) && self->read_buffer != NULL) {
+            munmap(self->read_buffer, self->file_size);
+            self->read_buffer = NULL;
+        }
+#endif
         kas_safe_free(self->read_buffer);
         if (! (self->flags & KAS_READ_ALL)) {
             /* The arrays have been individually malloced on demand. */
@@ -765,6 +826,11 @@ kastore_put(kastore_t *self, const char *key, size_t key_len,
         ret = KAS_ERR_BAD_TYPE;
         goto out;
     }
+    if (flags & KAS_BORROWS_ARRAY) {
+        /* The caller keeps ownership; the array is written out as-is at close */
+        ret = kastore_oput(self, key, key_len, (void *) array, array_len, type, flags);
+        goto out;
+    }
     array_size = type_size(type) * array_len;
     array_copy = malloc(array_size == 0? 1: array_size);
     if (array_copy == NULL) {
@@ -785,7 +851,7 @@ out:
 
 int KAS_WARN_UNUSED
 kastore_oput(kastore_t *self, const char *key, size_t key_len,
-       void *array, size_t array_len, int type, int KAS_UNUSED(flags))
+       void *array, size_t array_len, int type, int flags)
 {
     int ret = 0;
     kaitem_t *new_item;
@@ -819,6 +885,7 @@ kastore_oput(kastore_t *self, const char *key, size_t key_len,
     new_item->key_len = key_len;
     new_item->array_len = array_len;
     new_item->array = array;
+    new_item->flags = flags & KAS_BORROWS_ARRAY;
     new_item->key = malloc(key_len);
     if (new_item->key == NULL) {
         kas_safe_free(new_item->key);
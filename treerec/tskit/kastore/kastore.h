@@ -87,6 +87,14 @@ The requested type does not match the type of the stored values.
 
 /* Flags for open */
 #define KAS_READ_ALL            1
+/* Map the file read-only rather than reading it; implies KAS_READ_ALL. The
+ * file must not be modified or truncated while the store is open. */
+#define KAS_READ_MMAP           (1 << 1)
+
+/* Flags for put */
+/* The caller retains ownership of the array, which must remain valid and
+ * unmodified until kastore_close() is called; no copy is made. */
+#define KAS_BORROWS_ARRAY       (1 << 8)
 
 
 /**
@@ -161,6 +169,7 @@ typedef struct {
     void *array;
     size_t key_start;
     size_t array_start;
+    int flags;
 } kaitem_t;
 
 /**
@@ -216,6 +225,15 @@ KAS_READ_ALL
     open time. This will give slightly better performance as the file can
     be read sequentially in a single pass.
 
+KAS_READ_MMAP
+    If this option is specified, map the entire file into memory read-only
+    at open time, rather than reading it into a private buffer. Arrays are
+    then paged in from the file as they are accessed, and the pages are
+    shared with any other process that maps the same file. This implies
+    KAS_READ_ALL; where memory mapping is unavailable, or fails, the file
+    is read as for KAS_READ_ALL instead. Returned arrays must not be
+    modified.
+
 @endrst
 
 @param self A pointer to a kastore object.
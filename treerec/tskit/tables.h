@@ -604,6 +604,7 @@ typedef struct {
 
 /* Flags for load tables */
 #define TSK_BUILD_INDEXES               (1 << 0)
+#define TSK_LOAD_MMAP                   (1 << 1)
  
 
 /****************************************************************************/
@@ -1953,6 +1954,12 @@ flags:
 TSK_NO_INIT
     Do not initialise this :c:type:`tsk_table_collection_t` before loading.
 
+TSK_LOAD_MMAP
+    Map the file into memory read-only instead of reading it, so that the
+    columns are paged in from the file on access and shared with other
+    processes loading the same file. The file must not be modified while
+    the table collection is in use.
+
 **Examples**
 
 .. code-block:: c
@@ -2027,6 +2034,24 @@ TSK_NO_BUILD_INDEXES
 int tsk_table_collection_dump(tsk_table_collection_t *self, const char *filename, 
     tsk_flags_t options);
 
+/**
+@brief Write the tables into a kastore that is open for writing.
+
+@rst
+This is the body of :c:func:`tsk_table_collection_dump`, for callers that
+want to add their own keys to the same store before closing it.  The table
+columns are borrowed by the store, so the tables must not be modified or
+freed until the store has been closed.
+@endrst
+
+@param self A pointer to an initialised tsk_table_collection_t object.
+@param store A pointer to a kastore_t opened in write mode.
+@param options Write options, as for tsk_table_collection_dump.
+@return Return 0 on success or a negative value on failure.
+*/
+int tsk_table_collection_dump_store(tsk_table_collection_t *self, kastore_t *store,
+    tsk_flags_t options);
+
 /**
 @brief Record the number of rows in each table in the specified tsk_bookmark_t object.
 